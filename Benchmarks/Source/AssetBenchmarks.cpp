@@ -0,0 +1,157 @@
+#include "SyntheticWorld.hpp"
+
+#include <Assets/Private/MeshLoader.hpp>
+#include <Assets/Private/ModelLoader.hpp>
+#include <Level/Private/LevelSerializer.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+/// Bundled OBJ models under Editor/Resources, picked by benchmark argument.
+constexpr std::array<std::string_view, 4> BundledModels{
+    "box.obj",
+    "plane.obj",
+    "sphere.obj",
+    "wooden_watch_tower2.obj",
+};
+
+/// Populated World with every entity named, so the string table is exercised too.
+void build_named_world(World& world, std::size_t entityCount)
+{
+    build_synthetic_world(world, entityCount);
+    std::size_t index{};
+    for (auto [entity, name, mesh] : world.registry().view<NameComponent, MeshComponent>().each())
+    {
+        name.name = "Entity_" + std::to_string(index++);
+        mesh.asset = AssetRegistry::get().intern("Models/mesh_" + std::to_string(mesh.meshIndex) + ".noc_model");
+    }
+}
+
+void BM_LevelSerialize(benchmark::State& state)
+{
+    const auto entityCount = static_cast<std::size_t>(state.range(0));
+    World world{};
+    build_named_world(world, entityCount);
+
+    std::size_t bytes{};
+    for (auto _ : state)
+    {
+        auto buffer = LevelSerializer::serialize(world, "Benchmark");
+        if (!buffer)
+        {
+            state.SkipWithError(buffer.error().message.c_str());
+            return;
+        }
+        bytes = buffer->size();
+        benchmark::DoNotOptimize(buffer->data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entityCount));
+}
+
+void BM_LevelDeserialize(benchmark::State& state)
+{
+    const auto entityCount = static_cast<std::size_t>(state.range(0));
+    std::vector<std::uint8_t> buffer{};
+    {
+        World world{};
+        build_named_world(world, entityCount);
+        auto serialized = LevelSerializer::serialize(world, "Benchmark");
+        if (!serialized)
+        {
+            state.SkipWithError(serialized.error().message.c_str());
+            return;
+        }
+        buffer = std::move(*serialized);
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto world = std::make_unique<World>();
+        state.ResumeTiming();
+
+        if (auto result = LevelSerializer::deserialize(buffer, *world); !result)
+        {
+            state.SkipWithError(result.error().message.c_str());
+            return;
+        }
+
+        state.PauseTiming();
+        world.reset(); // tearing the registry down is not part of the load
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(buffer.size()));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entityCount));
+}
+
+/// Mapped .noc_mesh cache read, the path every non-first mesh load takes.
+void BM_MeshLoaderReadCache(benchmark::State& state)
+{
+    const std::string_view model = BundledModels[static_cast<std::size_t>(state.range(0))];
+    state.SetLabel(std::string{model});
+    auto mesh = MeshLoader::parse_obj(benchmark_resource_dir() / model);
+    if (!mesh)
+    {
+        state.SkipWithError(mesh.error().message.c_str());
+        return;
+    }
+
+    const std::filesystem::path cachePath =
+        benchmark_scratch_dir("MeshCache") / std::filesystem::path{model}.replace_extension(".noc_mesh");
+    if (auto result = MeshLoader::write_cache(**mesh, cachePath); !result)
+    {
+        state.SkipWithError(result.error().message.c_str());
+        return;
+    }
+    const auto cacheBytes = static_cast<std::int64_t>(std::filesystem::file_size(cachePath));
+
+    for (auto _ : state)
+    {
+        auto cached = MeshLoader::read_cache(cachePath);
+        if (!cached)
+        {
+            state.SkipWithError(cached.error().message.c_str());
+            return;
+        }
+        benchmark::DoNotOptimize(cached->get());
+    }
+    state.SetBytesProcessed(state.iterations() * cacheBytes);
+}
+
+/// OBJ + MTL import (split by material, tangents), the uncached model path.
+void BM_ModelLoaderParseObj(benchmark::State& state)
+{
+    const std::string_view model = BundledModels[static_cast<std::size_t>(state.range(0))];
+    state.SetLabel(std::string{model});
+    const std::filesystem::path path = benchmark_resource_dir() / model;
+    const auto sourceBytes = static_cast<std::int64_t>(std::filesystem::file_size(path));
+
+    for (auto _ : state)
+    {
+        auto parsed = ModelLoader::parse_obj(path);
+        if (!parsed)
+        {
+            state.SkipWithError(parsed.error().message.c_str());
+            return;
+        }
+        benchmark::DoNotOptimize(parsed->get());
+    }
+    state.SetBytesProcessed(state.iterations() * sourceBytes);
+}
+} // namespace
+
+BENCHMARK(BM_LevelSerialize)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LevelDeserialize)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MeshLoaderReadCache)->DenseRange(0, BundledModels.size() - 1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ModelLoaderParseObj)->DenseRange(0, BundledModels.size() - 1)->Unit(benchmark::kMillisecond);
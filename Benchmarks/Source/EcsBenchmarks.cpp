@@ -0,0 +1,89 @@
+#include "SyntheticWorld.hpp"
+
+#include <Core/Public/JobSystem.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+/// Every transform dirty: the cost after a level load or a mark_transforms_dirty().
+void BM_UpdateWorldMatrices_All(benchmark::State& state)
+{
+    const auto entityCount = static_cast<std::size_t>(state.range(0));
+    tf::Executor* executor = state.range(1) != 0 ? &JobSystem::get().executor() : nullptr;
+    World world{};
+    build_synthetic_world(world, entityCount);
+
+    for (auto _ : state)
+    {
+        world.mark_transforms_dirty();
+        world.update_world_matrices(executor);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entityCount));
+}
+
+/// One root in a hundred moved per frame: the steady-state gameplay case.
+void BM_UpdateWorldMatrices_Sparse(benchmark::State& state)
+{
+    const auto entityCount = static_cast<std::size_t>(state.range(0));
+    World world{};
+    build_synthetic_world(world, entityCount);
+    const auto& roots = world.get_root_entities();
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < roots.size(); i += 100)
+            world.mark_transform_dirty(roots[i]);
+        world.update_world_matrices();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entityCount));
+}
+
+/// Full re-extraction of every renderable (and its spatial index box).
+void BM_CollectRenderables_Full(benchmark::State& state)
+{
+    const auto entityCount = static_cast<std::size_t>(state.range(0));
+    World world{};
+    build_synthetic_world(world, entityCount);
+
+    for (auto _ : state)
+    {
+        world.mark_renderables_dirty();
+        benchmark::DoNotOptimize(world.collect_renderables().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entityCount));
+}
+
+/// Delta collection after one root in a hundred moved, as the Game frame does it.
+void BM_CollectRenderables_Delta(benchmark::State& state)
+{
+    const auto entityCount = static_cast<std::size_t>(state.range(0));
+    World world{};
+    build_synthetic_world(world, entityCount);
+    world.collect_renderables();
+    const auto& roots = world.get_root_entities();
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (std::size_t i = 0; i < roots.size(); i += 100)
+            world.mark_transform_dirty(roots[i]);
+        world.update_world_matrices();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(world.collect_renderable_changes().changed.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entityCount));
+}
+} // namespace
+
+BENCHMARK(BM_UpdateWorldMatrices_All)
+    ->ArgsProduct({{1'000, 10'000, 100'000}, {0, 1}})
+    ->ArgNames({"entities", "parallel"})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_UpdateWorldMatrices_Sparse)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CollectRenderables_Full)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CollectRenderables_Delta)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
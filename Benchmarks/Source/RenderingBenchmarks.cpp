@@ -0,0 +1,132 @@
+#include "SyntheticWorld.hpp"
+
+#include <Core/Public/JobSystem.hpp>
+#include <Rendering/Public/DrawKeys.hpp>
+#include <Rendering/Public/FrustumCuller.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+/// Draw keys and culling spheres built from a synthetic world the way Vulkan::write_renderable does.
+struct RenderInputs
+{
+    std::vector<std::uint64_t> keys{};
+    std::vector<XMFLOAT4> spheres{};
+    std::vector<std::uint8_t> staticFlags{};
+    FrustumPlanes frustum{};
+};
+
+RenderInputs make_render_inputs(std::size_t entityCount)
+{
+    World world{};
+    build_synthetic_world(world, entityCount);
+    const auto& renderables = world.collect_renderables();
+
+    RenderInputs inputs{};
+    const XMFLOAT4X4 viewMatrix = synthetic_view(entityCount);
+    const XMMATRIX view = XMLoadFloat4x4(&viewMatrix);
+    const MeshBounds bounds = synthetic_mesh_bounds(0);
+    for (const Renderable& renderable : renderables)
+    {
+        const XMMATRIX worldMatrix = XMLoadFloat3x4(&renderable.worldMatrix);
+        const XMVECTOR position = XMVectorSet(renderable.worldMatrix._14, renderable.worldMatrix._24,
+                                              renderable.worldMatrix._34, 1.0f);
+        const float viewDistance = XMVectorGetX(XMVector3Length(XMVector3TransformCoord(position, view)));
+        inputs.keys.push_back(DrawKey::make(DrawPass::Opaque, renderable.meshIndex, renderable.materialIndex,
+                                            DrawKey::depth_bucket(viewDistance)));
+
+        const XMVECTOR scales = XMVectorMax(XMVector3LengthSq(worldMatrix.r[0]),
+                                            XMVectorMax(XMVector3LengthSq(worldMatrix.r[1]),
+                                                        XMVector3LengthSq(worldMatrix.r[2])));
+        XMFLOAT4 sphere{};
+        XMStoreFloat4(&sphere, XMVector3TransformCoord(XMLoadFloat3(&bounds.center), worldMatrix));
+        sphere.w = bounds.radius * std::sqrt(XMVectorGetX(scales));
+        inputs.spheres.push_back(sphere);
+        inputs.staticFlags.push_back(renderable.isStatic ? 1 : 0);
+    }
+    inputs.frustum = FrustumPlanes::from_view_projection(synthetic_view_projection(entityCount));
+    return inputs;
+}
+
+/// Full radix sort of every draw key (set_renderables after a level load).
+void BM_DrawKeySort_Full(benchmark::State& state)
+{
+    const RenderInputs inputs = make_render_inputs(static_cast<std::size_t>(state.range(0)));
+    DrawKeySorter sorter{};
+
+    for (auto _ : state)
+    {
+        sorter.sort(inputs.keys, false);
+        benchmark::DoNotOptimize(sorter.get_order().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(inputs.keys.size()));
+}
+
+/// Incremental re-sort with one key in a hundred re-bucketed per frame (moving camera or bodies).
+void BM_DrawKeySort_Incremental(benchmark::State& state)
+{
+    RenderInputs inputs = make_render_inputs(static_cast<std::size_t>(state.range(0)));
+    DrawKeySorter sorter{};
+    sorter.sort(inputs.keys, false);
+
+    std::uint64_t frame{};
+    for (auto _ : state)
+    {
+        ++frame;
+        for (std::size_t i = frame % 100; i < inputs.keys.size(); i += 100)
+            inputs.keys[i] ^= (frame & 0xFF) << DrawKey::DepthShift;
+        sorter.sort(inputs.keys);
+        benchmark::DoNotOptimize(sorter.get_order().data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(inputs.keys.size()));
+}
+
+/// CPU frustum cull over the static tree and dynamic lanes, serial or across the JobSystem.
+void BM_FrustumCull(benchmark::State& state)
+{
+    const RenderInputs inputs = make_render_inputs(static_cast<std::size_t>(state.range(0)));
+    tf::Executor* executor = state.range(1) != 0 ? &JobSystem::get().executor() : nullptr;
+    FrustumCuller culler{};
+    culler.set_spheres(inputs.spheres, inputs.staticFlags);
+    std::vector<std::uint8_t> visible{};
+
+    std::uint32_t visibleCount{};
+    for (auto _ : state)
+    {
+        visibleCount = culler.cull(inputs.frustum, visible, executor);
+        benchmark::DoNotOptimize(visible.data());
+    }
+    state.counters["visible"] = static_cast<double>(visibleCount);
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(inputs.spheres.size()));
+}
+
+/// Static tree rebuild when the static set changes.
+void BM_FrustumCullerSetSpheres(benchmark::State& state)
+{
+    RenderInputs inputs = make_render_inputs(static_cast<std::size_t>(state.range(0)));
+    FrustumCuller culler{};
+
+    for (auto _ : state)
+    {
+        culler.clear();
+        culler.set_spheres(inputs.spheres, inputs.staticFlags);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(inputs.spheres.size()));
+}
+} // namespace
+
+BENCHMARK(BM_DrawKeySort_Full)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DrawKeySort_Incremental)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrustumCull)
+    ->ArgsProduct({{1'000, 10'000, 100'000}, {0, 1}})
+    ->ArgNames({"entities", "parallel"})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrustumCullerSetSpheres)->Arg(1'000)->Arg(10'000)->Arg(100'000)->Unit(benchmark::kMicrosecond);
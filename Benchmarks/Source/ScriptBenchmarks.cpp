@@ -0,0 +1,75 @@
+#include "SyntheticWorld.hpp"
+
+#include <Scripting/Public/ScriptEngine.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace
+{
+/// How the spinning entities are scripted.
+enum class ScriptMode : std::int64_t
+{
+    MainState = 0, // entity-local spin.lua with sharding off: per-entity on_update on the main state
+    Sharded = 1,   // entity-local spin.lua on one shard state per job worker, in parallel
+    Batch = 2,     // spin_batch.lua: one on_update_batch call
+};
+
+/// One ScriptEngine::update over N entities running the bundled spin scripts in `mode`.
+void BM_ScriptEngineUpdate(benchmark::State& state)
+{
+    const auto entityCount = static_cast<std::size_t>(state.range(0));
+    const auto mode = static_cast<ScriptMode>(state.range(1));
+    SyntheticWorldOptions options{};
+    options.scriptPath = mode == ScriptMode::Batch ? "scripts/spin_batch.lua" : "scripts/spin.lua";
+
+    World world{};
+    build_synthetic_world(world, entityCount, options);
+    ScriptEngine scripts{};
+    if (auto result = scripts.initialize(); !result)
+    {
+        state.SkipWithError(result.error().message.c_str());
+        return;
+    }
+    scripts.set_script_root(benchmark_resource_dir());
+    if (mode == ScriptMode::MainState)
+        scripts.set_script_shard_count(0);
+    switch (mode)
+    {
+    case ScriptMode::MainState:
+        state.SetLabel(options.scriptPath + " (main state)");
+        break;
+    case ScriptMode::Sharded:
+        state.SetLabel(options.scriptPath + " (" + std::to_string(scripts.get_script_shard_count()) + " shards)");
+        break;
+    case ScriptMode::Batch:
+        state.SetLabel(options.scriptPath + " (batch)");
+        break;
+    }
+
+    // Loading the environments and running on_start is not part of the per-frame cost.
+    constexpr float FixedStep{1.0f / 60.0f};
+    scripts.update(world, FixedStep);
+    if (scripts.get_environment_count() != entityCount)
+    {
+        state.SkipWithError("not every spin script loaded");
+        return;
+    }
+
+    for (auto _ : state)
+        scripts.update(world, FixedStep);
+
+    state.counters["lua_kib"] = static_cast<double>(scripts.get_lua_memory_bytes()) / 1024.0;
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(entityCount));
+    scripts.on_world_destroyed(world);
+    scripts.shutdown();
+}
+} // namespace
+
+BENCHMARK(BM_ScriptEngineUpdate)
+    ->ArgsProduct({{1'000, 10'000}, {0, 1, 2}})
+    ->ArgNames({"entities", "mode"})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,132 @@
+#include "SyntheticWorld.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+std::size_t grid_side(std::size_t rootCount) noexcept
+{
+    auto side = static_cast<std::size_t>(std::ceil(std::cbrt(static_cast<double>(rootCount))));
+    return side > 0 ? side : 1;
+}
+
+std::size_t root_count(std::size_t entityCount, const SyntheticWorldOptions& options) noexcept
+{
+    const std::size_t group = std::size_t{options.childrenPerRoot} + 1;
+    return (entityCount + group - 1) / group;
+}
+} // namespace
+
+void build_synthetic_world(World& world, std::size_t entityCount, const SyntheticWorldOptions& options)
+{
+    std::vector<entt::entity> entities(entityCount);
+    world.create_entities(entities);
+
+    auto& registry = world.registry();
+    std::mt19937 random{options.seed};
+    std::uniform_real_distribution<float> jitter{-0.25f, 0.25f};
+    std::uniform_real_distribution<float> angle{-XM_PI, XM_PI};
+    std::uniform_real_distribution<float> unit{0.0f, 1.0f};
+
+    const std::size_t side = grid_side(root_count(entityCount, options));
+    const float halfExtent = synthetic_world_half_extent(entityCount, options);
+    const std::size_t group = std::size_t{options.childrenPerRoot} + 1;
+
+    std::vector<MeshComponent> meshes(entityCount);
+    std::vector<PhysicsBodyComponent> bodies{};
+    std::vector<entt::entity> staticEntities{};
+    entt::entity root{entt::null};
+    for (std::size_t i = 0; i < entityCount; ++i)
+    {
+        const entt::entity entity = entities[i];
+        auto& transform = registry.get<TransformComponent>(entity);
+        if (i % group == 0)
+        {
+            root = entity;
+            const std::size_t cell = i / group;
+            transform.position = {
+                static_cast<float>(cell % side) * options.spacing - halfExtent + jitter(random),
+                static_cast<float>((cell / side) % side) * options.spacing - halfExtent + jitter(random),
+                static_cast<float>(cell / (side * side)) * options.spacing - halfExtent + jitter(random),
+            };
+        }
+        else
+        {
+            transform.position = {jitter(random) * 4.0f, 1.0f + jitter(random), jitter(random) * 4.0f};
+            transform.scale = {0.5f, 0.5f, 0.5f};
+            registry.get<HierarchyComponent>(entity).parent = root;
+            registry.get<HierarchyComponent>(root).children.push_back(entity);
+        }
+        transform.set_rotation_euler(0.0f, angle(random), 0.0f);
+
+        meshes[i].meshIndex = static_cast<std::int32_t>(random() % options.meshCount);
+        meshes[i].materialIndex = static_cast<std::int32_t>(random() % options.materialCount);
+        if (unit(random) < options.staticFraction)
+        {
+            PhysicsBodyComponent body{};
+            body.enabled = false;
+            bodies.push_back(body);
+            staticEntities.push_back(entity);
+        }
+    }
+
+    registry.insert<MeshComponent>(entities.begin(), entities.end(), meshes.begin());
+    registry.insert<PhysicsBodyComponent>(staticEntities.begin(), staticEntities.end(), bodies.begin());
+    if (!options.scriptPath.empty())
+        registry.insert<ScriptComponent>(entities.begin(), entities.end(), ScriptComponent{options.scriptPath});
+
+    world.set_mesh_bounds_provider(&synthetic_mesh_bounds);
+    world.update_world_matrices();
+}
+
+MeshBounds synthetic_mesh_bounds(std::uint32_t) noexcept
+{
+    MeshBounds bounds{};
+    bounds.min = {-0.5f, -0.5f, -0.5f};
+    bounds.max = {0.5f, 0.5f, 0.5f};
+    bounds.radius = std::sqrt(0.75f);
+    bounds.valid = true;
+    return bounds;
+}
+
+float synthetic_world_half_extent(std::size_t entityCount, const SyntheticWorldOptions& options) noexcept
+{
+    return static_cast<float>(grid_side(root_count(entityCount, options))) * options.spacing * 0.5f;
+}
+
+XMFLOAT4X4 synthetic_view(std::size_t entityCount, const SyntheticWorldOptions& options) noexcept
+{
+    const float halfExtent = synthetic_world_half_extent(entityCount, options);
+    const XMVECTOR eye = XMVectorSet(halfExtent * 1.5f, halfExtent * 0.75f, halfExtent * 1.5f, 1.0f);
+    XMFLOAT4X4 view{};
+    XMStoreFloat4x4(&view, XMMatrixLookAtRH(eye, XMVectorZero(), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)));
+    return view;
+}
+
+XMFLOAT4X4 synthetic_view_projection(std::size_t entityCount, const SyntheticWorldOptions& options) noexcept
+{
+    const XMFLOAT4X4 view = synthetic_view(entityCount, options);
+    const float halfExtent = synthetic_world_half_extent(entityCount, options);
+    const XMMATRIX projection = XMMatrixPerspectiveFovRH(XMConvertToRadians(45.0f), 16.0f / 9.0f, 0.1f, halfExtent * 8.0f);
+    XMFLOAT4X4 viewProjection{};
+    XMStoreFloat4x4(&viewProjection, XMMatrixMultiply(XMLoadFloat4x4(&view), projection));
+    return viewProjection;
+}
+
+std::filesystem::path benchmark_resource_dir()
+{
+    return std::filesystem::path{NOC_BENCHMARK_RESOURCE_DIR};
+}
+
+std::filesystem::path benchmark_scratch_dir(std::string_view name)
+{
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "NatureOfCraftBenchmarks" / name;
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    std::filesystem::create_directories(dir, ec);
+    return dir;
+}
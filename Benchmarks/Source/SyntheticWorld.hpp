@@ -0,0 +1,44 @@
+#pragma once
+#include <ECS/Public/World.hpp>
+#include <Rendering/Public/IRenderer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <DirectXMath.h>
+
+/// Shape of a generated benchmark world. The same options and seed always give the same world.
+struct SyntheticWorldOptions
+{
+    std::uint32_t meshCount{32};
+    std::uint32_t materialCount{16};
+    std::uint32_t childrenPerRoot{3}; // every root carries this many children, one level deep
+    float spacing{4.0f};              // distance between roots on the grid
+    float staticFraction{0.75f};      // share of entities flagged static through a disabled physics body
+    std::string scriptPath{};         // when set, every entity gets a ScriptComponent running it
+    std::uint32_t seed{0x4E4F43u};
+};
+
+/// Fills an empty World with `entityCount` renderable entities on a cube grid, in bulk
+/// (World::create_entities, hierarchy linked in place). Transforms are up to date on return.
+void build_synthetic_world(World& world, std::size_t entityCount, const SyntheticWorldOptions& options = {});
+
+/// Unit box bounds for every mesh index, standing in for IRenderer::get_mesh_bounds.
+MeshBounds synthetic_mesh_bounds(std::uint32_t meshIndex) noexcept;
+
+/// Half the edge of the grid cube holding `entityCount` entities.
+float synthetic_world_half_extent(std::size_t entityCount, const SyntheticWorldOptions& options = {}) noexcept;
+
+/// Right-handed view-projection looking at the grid center from outside one corner (as Camera builds it).
+DirectX::XMFLOAT4X4 synthetic_view(std::size_t entityCount, const SyntheticWorldOptions& options = {}) noexcept;
+DirectX::XMFLOAT4X4 synthetic_view_projection(std::size_t entityCount,
+                                              const SyntheticWorldOptions& options = {}) noexcept;
+
+/// Bundled engine content (Editor/Resources) in the source tree.
+std::filesystem::path benchmark_resource_dir();
+
+/// Fresh scratch directory under the system temp directory, removed and recreated on every call.
+std::filesystem::path benchmark_scratch_dir(std::string_view name);
@@ -0,0 +1,10 @@
+#version 450
+
+layout(location = 0) in vec4 fragColor;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // The scene target holds display-encoded color, so the overlay color is written as given.
+    outColor = fragColor;
+}
@@ -0,0 +1,51 @@
+#version 450
+
+// Debug overlay lines: one unit wireframe shape per draw, instanced per primitive. Every line segment
+// arrives as six quad corners that are pushed apart in screen space to the instance's line width.
+layout(location = 0) in vec4 inPosition; // segment end of this corner: unit shape position (xyz), capsule cap side (w)
+layout(location = 1) in vec4 inOther;    // the segment's other end
+layout(location = 2) in float inSide;    // -1 or 1: side of the segment the corner is pushed to
+
+layout(location = 3) in vec4 inModelRow0; // transposed affine world matrix (translation in .w)
+layout(location = 4) in vec4 inModelRow1;
+layout(location = 5) in vec4 inModelRow2;
+layout(location = 6) in vec4 inExtent; // shape scale (xyz), capsule half height (w)
+layout(location = 7) in uint inColor;  // RGBA8
+layout(location = 8) in float inWidth; // line width in output pixels
+
+layout(push_constant) uniform SceneParams {
+    mat4 viewProj;
+    vec4 viewport; // scene viewport size in pixels (xy), scene pixels per output pixel (z)
+} scene;
+
+layout(location = 0) out vec4 fragColor;
+
+vec4 to_clip(mat4x3 model, vec4 unitPosition) {
+    vec3 localPos = unitPosition.xyz * inExtent.xyz + vec3(0.0, unitPosition.w * inExtent.w, 0.0);
+    return scene.viewProj * vec4(model * vec4(localPos, 1.0), 1.0);
+}
+
+void main() {
+    mat4x3 model = transpose(mat3x4(inModelRow0, inModelRow1, inModelRow2));
+    vec4 clipPos = to_clip(model, inPosition);
+    vec4 clipOther = to_clip(model, inOther);
+
+    // Segments crossing the camera plane are cut just in front of it, so both ends project sensibly.
+    const float minW = 1e-4;
+    if (clipPos.w < minW && clipOther.w >= minW)
+        clipPos = mix(clipPos, clipOther, (minW - clipPos.w) / (clipOther.w - clipPos.w));
+    else if (clipOther.w < minW && clipPos.w >= minW)
+        clipOther = mix(clipOther, clipPos, (minW - clipOther.w) / (clipPos.w - clipOther.w));
+
+    vec2 viewportSize = max(scene.viewport.xy, vec2(1.0));
+    vec2 direction = (clipOther.xy / clipOther.w - clipPos.xy / clipPos.w) * viewportSize;
+    direction = dot(direction, direction) > 1e-12 ? normalize(direction) : vec2(1.0, 0.0);
+
+    // At least one scene pixel wide, so thin lines do not break up into dashes.
+    float halfWidth = 0.5 * max(inWidth * scene.viewport.z, 1.0);
+    vec2 offset = vec2(-direction.y, direction.x) * inSide * halfWidth * 2.0 / viewportSize;
+    clipPos.xy += offset * clipPos.w;
+
+    gl_Position = clipPos;
+    fragColor = unpackUnorm4x8(inColor);
+}
@@ -0,0 +1,32 @@
+#version 450
+
+// Depth-only prepass. Reads the position-only stream and must transform exactly like shader.vert,
+// whose color pass then depth-tests EQUAL against what this writes.
+layout(location = 0) in vec3 inPosition;
+layout(location = 4) in uint inInstanceSlot;
+
+struct InstanceData {
+    vec4 modelRows[3]; // transposed affine world matrix (translation in .w)
+    uint glow;
+    uint materialIndex;
+    uint padding0;
+    uint padding1;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer InstanceSlots {
+    InstanceData instances[];
+};
+
+layout(push_constant) uniform SceneParams {
+    mat4 viewProj;
+} scene;
+
+invariant gl_Position;
+
+void main() {
+    InstanceData instance = instances[inInstanceSlot];
+    mat4x3 model = transpose(mat3x4(instance.modelRows[0], instance.modelRows[1], instance.modelRows[2]));
+
+    vec3 worldPos = model * vec4(inPosition, 1.0);
+    gl_Position = scene.viewProj * vec4(worldPos, 1.0);
+}
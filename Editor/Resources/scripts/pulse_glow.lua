@@ -1,3 +1,4 @@
+--!entity_local
 -- pulse_glow.lua
 -- Enables emissive glow and pulses intensity over time.
 
@@ -1,3 +1,4 @@
+--!entity_local
 -- spin.lua
 -- Rotates an entity around the Y axis at a configurable speed.
 
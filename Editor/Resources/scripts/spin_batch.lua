@@ -0,0 +1,23 @@
+-- spin_batch.lua
+-- Same as spin.lua, but every spinning entity is driven by a single on_update_batch call per frame.
+-- Only one instance's on_update_batch runs, so per-entity state lives in its table, keyed by entity id.
+-- Rotations are written straight into the transform through Transforms.edit (LuaJIT FFI).
+
+local speed = 1.0
+local angles = {}
+
+function on_update_batch(entities, dt)
+    local step = dt * speed
+    for i = 1, #entities do
+        local entity = entities[i]
+        local id = entity:id()
+        local t = Transforms.edit(id)
+        if t then
+            -- Start from the entity's current yaw so we don't snap to 0
+            local angle = (angles[id] or entity:transform():get_rotation_euler().y) + step
+            angles[id] = angle
+            -- Pure yaw quaternion
+            t.rx, t.ry, t.rz, t.rw = 0, math.sin(angle * 0.5), 0, math.cos(angle * 0.5)
+        end
+    end
+end
@@ -1,18 +1,73 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
 layout(location = 0) in vec2 fragTexCoord;
 layout(location = 1) in vec3 fragWorldPos;
 layout(location = 2) in vec3 fragT;
 layout(location = 3) in vec3 fragB;
 layout(location = 4) in vec3 fragN;
-layout(location = 5) in vec4 fragGlow;
-
-// PBR texture bindings
-layout(set = 0, binding = 0) uniform sampler2D albedoMap;
-layout(set = 0, binding = 1) uniform sampler2D normalMap;
-layout(set = 0, binding = 2) uniform sampler2D roughnessMap;
-layout(set = 0, binding = 3) uniform sampler2D metallicMap;
-layout(set = 0, binding = 4) uniform sampler2D aoMap;
+layout(location = 5) in vec3 fragGlow;
+layout(location = 6) flat in uint fragMaterial;
+
+struct Material {
+    uint albedo;
+    uint normal;
+    uint roughness;
+    uint metallic;
+    uint ao;
+    uint packedOrm; // roughness, metallic and AO share one ORM texture (R = AO, G = rough, B = metal)
+    uint padding0;
+    uint padding1;
+};
+
+// Bindless PBR textures: every uploaded texture is one element, materials index into it.
+layout(set = 0, binding = 0) uniform sampler2D textures[];
+layout(std430, set = 0, binding = 1) readonly buffer Materials {
+    Material materials[];
+};
+
+// Clustered lights, binned each frame by cluster.comp. Grid constants must match cluster.comp.
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+#define CLUSTER_COUNT (CLUSTER_X * CLUSTER_Y * CLUSTER_Z)
+#define MAX_LIGHTS_PER_CLUSTER 128
+#define MAX_SHADOW_CASCADES 4 // must match Vulkan::MaxShadowCascades
+
+struct Light {
+    vec4 positionRange;      // world position (xyz), range (w)
+    vec4 colorSpotOuter;     // color * intensity (rgb), cos of the outer cone (w); < -1 for point lights
+    vec4 directionSpotInner; // unit direction the light travels (xyz), cos of the inner cone (w)
+};
+
+layout(std430, set = 2, binding = 0) readonly buffer Lights {
+    Light lights[];
+};
+
+layout(std430, set = 2, binding = 1) readonly buffer ClusterLights {
+    uint clusterLightCounts[CLUSTER_COUNT];
+    uint clusterLightIndices[]; // MAX_LIGHTS_PER_CLUSTER per cluster
+};
+
+layout(std140, set = 2, binding = 2) uniform LightingParams {
+    mat4 view;
+    mat4 inverseProj;
+    vec4 cameraPosition;
+    vec4 sunDirection; // towards the sun
+    vec4 sunColor;
+    vec4 clusterScale; // tile size in pixels (xy), log-depth slice scale (z) and bias (w)
+    vec4 viewport;     // render width, height, near plane, far plane
+    uint lightCount;
+    uint shadowCascadeCount;    // 0 when sun shadows are off
+    float shadowMapTexelSize;   // 1 / cascade resolution
+    uint shadowPadding;
+    vec4 shadowSplits;          // far view depth of each cascade
+    vec4 shadowTexelWorldSizes; // world-space size of one texel of each cascade
+    mat4 shadowViewProj[MAX_SHADOW_CASCADES];
+} lighting;
+
+// Sun shadow cascades, one layer each, rendered by the shadow pass with the light's view-projection.
+layout(set = 2, binding = 3) uniform sampler2DArrayShadow shadowCascades;
 
 layout(location = 0) out vec4 outColor;
 
@@ -50,22 +105,84 @@ vec3 fresnelSchlick(float cosTheta, vec3 F0) {
     return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
 }
 
+// Cook-Torrance specular + Lambert diffuse for one light arriving from direction L.
+vec3 evaluateLight(vec3 N, vec3 V, vec3 L, vec3 radiance, vec3 albedo, float roughness, float metallic, vec3 F0) {
+    float NdotL = max(dot(N, L), 0.0);
+    if (NdotL <= 0.0)
+        return vec3(0.0);
+
+    vec3 H = normalize(V + L);
+    float D = distributionGGX(N, H, roughness);
+    float G = geometrySmith(N, V, L, roughness);
+    vec3  F = fresnelSchlick(max(dot(H, V), 0.0), F0);
+
+    vec3 specular = (D * G * F) / (4.0 * max(dot(N, V), 0.0) * NdotL + 0.0001);
+
+    // Energy conservation: diffuse + specular must not exceed 1
+    vec3 kD = (vec3(1.0) - F) * (1.0 - metallic);
+
+    return (kD * albedo / PI + specular) * radiance * NdotL;
+}
+
+// Fraction of sun light reaching the fragment: 3x3 PCF in the first cascade whose split covers it,
+// faded out over the last tenth of the shadow distance.
+float sunShadow(vec3 worldPos, vec3 normal, float viewDepth) {
+    uint cascadeCount = lighting.shadowCascadeCount;
+    if (cascadeCount == 0u || viewDepth >= lighting.shadowSplits[cascadeCount - 1u])
+        return 1.0;
+
+    uint cascade = 0u;
+    while (cascade + 1u < cascadeCount && viewDepth >= lighting.shadowSplits[cascade])
+        ++cascade;
+
+    // Push the lookup out along the normal by about a texel to keep surfaces from shadowing themselves.
+    vec3 offsetPos = worldPos + normal * (lighting.shadowTexelWorldSizes[cascade] * 1.5);
+    vec4 lightClip = lighting.shadowViewProj[cascade] * vec4(offsetPos, 1.0);
+    vec3 lightNdc = lightClip.xyz / lightClip.w;
+    vec2 uv = lightNdc.xy * 0.5 + 0.5;
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))) || lightNdc.z > 1.0)
+        return 1.0;
+
+    float lit = 0.0;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            vec2 offset = vec2(x, y) * lighting.shadowMapTexelSize;
+            lit += texture(shadowCascades, vec4(uv + offset, float(cascade), lightNdc.z));
+        }
+    }
+    lit /= 9.0;
+
+    float shadowFar = lighting.shadowSplits[cascadeCount - 1u];
+    float fade = clamp((shadowFar - viewDepth) / (shadowFar * 0.1), 0.0, 1.0);
+    return mix(1.0, lit, fade);
+}
+
 //    Main                                                              
 
 void main() {
+    // The material varies per instance within a draw, so texture indices are non-uniform.
+    Material material = materials[fragMaterial];
+
     // Sample PBR textures
-    vec3  albedo    = pow(texture(albedoMap, fragTexCoord).rgb, vec3(2.2)); // sRGB → linear
-    float roughness = texture(roughnessMap, fragTexCoord).g; // often in green channel
-    float metallic  = texture(metallicMap, fragTexCoord).b;  // often in blue channel
-    float ao        = texture(aoMap, fragTexCoord).r;
+    vec3  albedo    = pow(texture(textures[nonuniformEXT(material.albedo)], fragTexCoord).rgb, vec3(2.2)); // sRGB → linear
+    vec3  orm       = texture(textures[nonuniformEXT(material.roughness)], fragTexCoord).rgb;
+    if (material.packedOrm == 0u) {
+        orm.r = texture(textures[nonuniformEXT(material.ao)], fragTexCoord).r;
+        orm.b = texture(textures[nonuniformEXT(material.metallic)], fragTexCoord).b;
+    }
+    float ao        = orm.r;
+    float roughness = orm.g; // often in green channel
+    float metallic  = orm.b; // often in blue channel
 
     // Sample and transform normal
-    vec3 sampledNormal = texture(normalMap, fragTexCoord).rgb * 2.0 - 1.0;
+    // Rebuild Z from XY so BC5 (two-channel) normal maps decode the same as RGBA8 ones
+    vec3 sampledNormal;
+    sampledNormal.xy = texture(textures[nonuniformEXT(material.normal)], fragTexCoord).rg * 2.0 - 1.0;
+    sampledNormal.z  = sqrt(max(1.0 - dot(sampledNormal.xy, sampledNormal.xy), 0.0));
     mat3 TBN = mat3(normalize(fragT), normalize(fragB), normalize(fragN));
     vec3 N = normalize(TBN * sampledNormal);
 
-    // Camera at origin for now — approximate view direction
-    vec3 V = normalize(-fragWorldPos);
+    vec3 V = normalize(lighting.cameraPosition.xyz - fragWorldPos);
 
     // Reflectance at normal incidence (F0)
     // Dielectrics ≈ 0.04, metals use albedo color
@@ -74,54 +191,44 @@ void main() {
     //    Lighting                                                      
     vec3 Lo = vec3(0.0);
 
-    // Directional light (sun)
-    vec3  lightDir   = normalize(vec3(0.5, 0.7, 1.0));
-    vec3  lightColor = vec3(3.0); // bright white sun
-    float NdotL      = max(dot(N, lightDir), 0.0);
-
-    if (NdotL > 0.0) {
-        vec3 H = normalize(V + lightDir);
-
-        // Cook-Torrance specular BRDF
-        float D = distributionGGX(N, H, roughness);
-        float G = geometrySmith(N, V, lightDir, roughness);
-        vec3  F = fresnelSchlick(max(dot(H, V), 0.0), F0);
+    float viewDepth = -(lighting.view * vec4(fragWorldPos, 1.0)).z;
 
-        vec3 numerator   = D * G * F;
-        float denominator = 4.0 * max(dot(N, V), 0.0) * NdotL + 0.0001;
-        vec3 specular    = numerator / denominator;
-
-        // Energy conservation: diffuse + specular must not exceed 1
-        vec3 kD = (vec3(1.0) - F) * (1.0 - metallic);
-
-        Lo += (kD * albedo / PI + specular) * lightColor * NdotL;
-    }
+    // Directional light (sun)
+    float sunVisibility = sunShadow(fragWorldPos, normalize(fragN), viewDepth);
+    Lo += evaluateLight(N, V, lighting.sunDirection.xyz, lighting.sunColor.rgb * sunVisibility, albedo, roughness, metallic, F0);
 
     // Fill / sky light (subtle upwards hemisphere)
-    {
-        vec3  fillDir   = normalize(vec3(-0.3, 0.5, -0.4));
-        vec3  fillColor = vec3(0.4, 0.5, 0.7); // cool blue fill
-        float fillNdotL = max(dot(N, fillDir), 0.0);
-
-        if (fillNdotL > 0.0) {
-            vec3 H = normalize(V + fillDir);
-
-            float D = distributionGGX(N, H, roughness);
-            float G = geometrySmith(N, V, fillDir, roughness);
-            vec3  F = fresnelSchlick(max(dot(H, V), 0.0), F0);
-
-            vec3  spec  = (D * G * F) / (4.0 * max(dot(N, V), 0.0) * fillNdotL + 0.0001);
-            vec3  kD    = (vec3(1.0) - F) * (1.0 - metallic);
-
-            Lo += (kD * albedo / PI + spec) * fillColor * fillNdotL;
-        }
+    Lo += evaluateLight(N, V, normalize(vec3(-0.3, 0.5, -0.4)), vec3(0.4, 0.5, 0.7), albedo, roughness, metallic, F0);
+
+    // Point and spot lights binned into this fragment's cluster
+    uvec3 cluster = uvec3(
+        min(uvec2(gl_FragCoord.xy / lighting.clusterScale.xy), uvec2(CLUSTER_X - 1, CLUSTER_Y - 1)),
+        uint(clamp(log(max(viewDepth, 1e-4)) * lighting.clusterScale.z + lighting.clusterScale.w, 0.0, float(CLUSTER_Z - 1))));
+    uint clusterIndex = (cluster.z * CLUSTER_Y + cluster.y) * CLUSTER_X + cluster.x;
+    uint clusterLightCount = clusterLightCounts[clusterIndex];
+    for (uint i = 0u; i < clusterLightCount; ++i) {
+        Light light = lights[clusterLightIndices[clusterIndex * MAX_LIGHTS_PER_CLUSTER + i]];
+        vec3  toLight  = light.positionRange.xyz - fragWorldPos;
+        float distSq   = dot(toLight, toLight);
+        vec3  L        = toLight * inversesqrt(max(distSq, 1e-8));
+
+        // Inverse-square falloff windowed to reach zero at the light's range
+        float rangeRatio = distSq / (light.positionRange.w * light.positionRange.w);
+        float window     = clamp(1.0 - rangeRatio * rangeRatio, 0.0, 1.0);
+        float attenuation = window * window / (distSq + 1.0);
+
+        // Spot cone (point lights pass with cos values below -1)
+        attenuation *= smoothstep(light.colorSpotOuter.w, light.directionSpotInner.w, dot(-L, light.directionSpotInner.xyz));
+
+        if (attenuation > 0.0)
+            Lo += evaluateLight(N, V, L, light.colorSpotOuter.rgb * attenuation, albedo, roughness, metallic, F0);
     }
 
     // Ambient / IBL approximation
     vec3 ambient = vec3(0.03) * albedo * ao;
 
     vec3 color = ambient + Lo;
-    color += fragGlow.rgb * max(fragGlow.a, 0.0);
+    color += fragGlow;
 
     // Tone mapping (Reinhard) + gamma correction
     color = color / (color + vec3(1.0));
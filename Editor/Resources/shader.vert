@@ -1,38 +1,71 @@
 #version 450
 
+// PackedVertex layout: octahedral normal / tangent (snorm16x2), half-float UVs.
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
+layout(location = 1) in vec2 inNormalOct;
 layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec4 inTangent;
-layout(location = 4) in vec4 inMvpRow0;
-layout(location = 5) in vec4 inMvpRow1;
-layout(location = 6) in vec4 inMvpRow2;
-layout(location = 7) in vec4 inMvpRow3;
-layout(location = 8) in vec4 inModelRow0;
-layout(location = 9) in vec4 inModelRow1;
-layout(location = 10) in vec4 inModelRow2;
-layout(location = 11) in vec4 inModelRow3;
-layout(location = 12) in vec4 inGlow;
+layout(location = 3) in vec2 inTangentOct; // y carries the bitangent sign, |y| = oct.y * 0.5 + 0.5
+layout(location = 4) in uint inInstanceSlot;
+
+struct InstanceData {
+    vec4 modelRows[3]; // transposed affine world matrix (translation in .w)
+    uint glow;         // RGB9E5 glow color * intensity
+    uint materialIndex;
+    uint padding0;
+    uint padding1;
+};
+
+// Persistent per-entity instance data, indexed by the slot streamed per instance.
+layout(std430, set = 1, binding = 0) readonly buffer InstanceSlots {
+    InstanceData instances[];
+};
+
+layout(push_constant) uniform SceneParams {
+    mat4 viewProj;
+} scene;
+
+// depth.vert repeats the position math below; invariance keeps both bit-identical for the
+// EQUAL depth test after the prepass.
+invariant gl_Position;
 
 layout(location = 0) out vec2 fragTexCoord;
 layout(location = 1) out vec3 fragWorldPos;
 layout(location = 2) out vec3 fragT;
 layout(location = 3) out vec3 fragB;
 layout(location = 4) out vec3 fragN;
-layout(location = 5) out vec4 fragGlow;
+layout(location = 5) out vec3 fragGlow;
+layout(location = 6) flat out uint fragMaterial;
+
+vec3 oct_decode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+vec3 unpack_rgb9e5(uint v) {
+    float scale = exp2(float(v >> 27) - 24.0); // exponent bias 15 + 9 mantissa bits
+    return vec3(v & 0x1FFu, (v >> 9) & 0x1FFu, (v >> 18) & 0x1FFu) * scale;
+}
 
 void main() {
-    mat4 mvp = mat4(inMvpRow0, inMvpRow1, inMvpRow2, inMvpRow3);
-    mat4 model = mat4(inModelRow0, inModelRow1, inModelRow2, inModelRow3);
+    vec3 inNormal = oct_decode(inNormalOct);
+    vec4 inTangent = vec4(oct_decode(vec2(inTangentOct.x, abs(inTangentOct.y) * 2.0 - 1.0)),
+                          inTangentOct.y < 0.0 ? -1.0 : 1.0);
+
+    InstanceData instance = instances[inInstanceSlot];
+    mat4x3 model = transpose(mat3x4(instance.modelRows[0], instance.modelRows[1], instance.modelRows[2]));
 
-    gl_Position = mvp * vec4(inPosition, 1.0);
+    vec3 worldPos = model * vec4(inPosition, 1.0);
+    gl_Position = scene.viewProj * vec4(worldPos, 1.0);
 
-    fragWorldPos = (model * vec4(inPosition, 1.0)).xyz;
+    fragWorldPos = worldPos;
     fragTexCoord = inTexCoord;
 
     // Build TBN basis vectors in world space
-    vec3 N = normalize((model * vec4(inNormal, 0.0)).xyz);
-    vec3 T = normalize((model * vec4(inTangent.xyz, 0.0)).xyz);
+    vec3 N = normalize(model * vec4(inNormal, 0.0));
+    vec3 T = normalize(model * vec4(inTangent.xyz, 0.0));
     // Re-orthogonalize T with respect to N (Gram-Schmidt)
     T = normalize(T - dot(T, N) * N);
     vec3 B = cross(N, T) * inTangent.w;
@@ -40,5 +73,6 @@ void main() {
     fragT = T;
     fragB = B;
     fragN = N;
-    fragGlow = inGlow;
+    fragGlow = unpack_rgb9e5(instance.glow);
+    fragMaterial = instance.materialIndex;
 }
@@ -5,13 +5,21 @@
 #include <Assets/Public/ModelData.hpp>
 #include <Assets/Generated/MaterialAsset_generated.h>
 #include <Camera/Public/Camera.hpp>
+#include <Core/Public/AllocationCounter.hpp>
+#include <Core/Public/FrameArena.hpp>
+#include <Core/Public/JobSystem.hpp>
+#include <Core/Public/Profiler.hpp>
 #include <Core/Public/RuntimePaths.hpp>
 #include <ECS/Public/Components.hpp>
 #include <Level/Public/Level.hpp>
 #include <Level/Public/Project.hpp>
 #include <Physics/Public/PhysicsWorld.hpp>
 #include <Rendering/BackEnds/Public/Vulkan.hpp>
+#include <Rendering/Public/DebugDraw.hpp>
+#include <Rendering/Public/FrustumCuller.hpp>
+#include <Runtime/Public/FramePacer.hpp>
 #include <Runtime/Public/ProjectPipeline.hpp>
+#include <Runtime/Public/StartupGraph.hpp>
 #include <Scripting/Public/ScriptEngine.hpp>
 #include <Window/Public/Window.hpp>
 #include <imgui.h>
@@ -36,12 +44,17 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+NOC_DEFINE_ALLOCATION_COUNTING_HOOKS()
+
 //  Constants 
 
 constexpr static std::uint32_t WIDTH{800};
@@ -236,23 +249,19 @@ static const char* physics_collider_shape_name(PhysicsColliderShapeType shapeTyp
     }
 }
 
-static bool project_world_to_screen(const DirectX::XMFLOAT3& worldPos, const DirectX::XMMATRIX& viewProj,
-                                    const ImVec2& viewportMin, const ImVec2& viewportSize, ImVec2& outScreen)
+/// The world-space ray through a viewport pixel.
+static void screen_to_world_ray(const ImVec2& screen, const DirectX::XMMATRIX& viewProj, const ImVec2& viewportMin,
+                                const ImVec2& viewportSize, DirectX::XMFLOAT3& outOrigin, DirectX::XMFLOAT3& outDirection)
 {
     using namespace DirectX;
-    const XMVECTOR world = XMVectorSet(worldPos.x, worldPos.y, worldPos.z, 1.0f);
-    const XMVECTOR clip = XMVector4Transform(world, viewProj);
-    const float w = XMVectorGetW(clip);
-    if (w <= 0.0001f)
-        return false;
-
-    const float invW = 1.0f / w;
-    const float ndcX = XMVectorGetX(clip) * invW;
-    const float ndcY = XMVectorGetY(clip) * invW;
-
-    outScreen.x = viewportMin.x + (ndcX * 0.5f + 0.5f) * viewportSize.x;
-    outScreen.y = viewportMin.y + (ndcY * 0.5f + 0.5f) * viewportSize.y;
-    return true;
+    const float ndcX = (screen.x - viewportMin.x) / std::max(viewportSize.x, 1.0f) * 2.0f - 1.0f;
+    const float ndcY = (screen.y - viewportMin.y) / std::max(viewportSize.y, 1.0f) * 2.0f - 1.0f;
+
+    const XMMATRIX inverseViewProj = XMMatrixInverse(nullptr, viewProj);
+    const XMVECTOR nearPoint = XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 0.0f, 1.0f), inverseViewProj);
+    const XMVECTOR farPoint = XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), inverseViewProj);
+    XMStoreFloat3(&outOrigin, nearPoint);
+    XMStoreFloat3(&outDirection, XMVector3Normalize(XMVectorSubtract(farPoint, nearPoint)));
 }
 
 static const char* physics_motion_type_name(PhysicsBodyMotionType motionType)
@@ -269,6 +278,34 @@ static const char* physics_motion_type_name(PhysicsBodyMotionType motionType)
     }
 }
 
+static const char* light_type_name(LightType type)
+{
+    switch (type)
+    {
+    case LightType::Directional:
+        return "Directional";
+    case LightType::Spot:
+        return "Spot";
+    case LightType::Point:
+    default:
+        return "Point";
+    }
+}
+
+static const char* physics_collision_group_name(PhysicsBodyCollisionGroup group)
+{
+    switch (group)
+    {
+    case PhysicsBodyCollisionGroup::Trigger:
+        return "Trigger";
+    case PhysicsBodyCollisionGroup::Debris:
+        return "Debris";
+    case PhysicsBodyCollisionGroup::Default:
+    default:
+        return "Default";
+    }
+}
+
 static KHR_Settings present_mode_to_setting(VkPresentModeKHR mode)
 {
     switch (mode)
@@ -836,7 +873,7 @@ prepare_texture_handles_for_paths(AssetManager& assetManager, const std::vector<
                     decodeErrors[pathIndex] = loadResult.error();
             });
         }
-        assetManager.get_executor().run(taskflow).wait();
+        JobSystem::get().run_and_wait(taskflow);
 
         for (size_t pathIndex : decodeIndices)
         {
@@ -851,7 +888,7 @@ prepare_texture_handles_for_paths(AssetManager& assetManager, const std::vector<
                 continue;
             }
 
-            auto handle = assetManager.load_texture(uniquePaths[pathIndex].string(), *decoded[pathIndex]);
+            auto handle = assetManager.load_texture(uniquePaths[pathIndex].string(), std::move(decoded[pathIndex]));
             if (handle)
                 textureHandles.emplace(uniquePaths[pathIndex], handle);
         }
@@ -1010,7 +1047,11 @@ static bool import_model(const std::filesystem::path& objPath, AssetManager& ass
     if (modelName.empty())
         modelName = objPath.stem().string();
 
-    entt::entity modelRoot = world.create_entity(modelName);
+    // Built as a one-node-per-mesh prefab so the whole hierarchy is created in one batch.
+    Prefab prefab{};
+    prefab.nodes.reserve(model.meshes.size() + 1);
+    prefab.nodes.push_back({.name = modelName});
+    const AssetId assetId = AssetRegistry::get().intern(cachedAssetPath);
 
     std::uint32_t meshesUploaded = 0;
     for (size_t i = 0; i < model.meshes.size(); ++i)
@@ -1023,13 +1064,13 @@ static bool import_model(const std::filesystem::path& objPath, AssetManager& ass
         }
         std::uint32_t meshIdx = uploadResult.value();
 
-        std::string nodeName = model.meshes[i].name.empty() ? fmt::format("SubMesh_{}", i) : model.meshes[i].name;
-        entt::entity meshEntity = world.create_entity(std::move(nodeName));
-        world.set_parent(meshEntity, modelRoot);
+        Prefab::Node& node = prefab.nodes.emplace_back();
+        node.name = model.meshes[i].name.empty() ? fmt::format("SubMesh_{}", i) : model.meshes[i].name;
+        node.parent = 0;
 
-        auto& mc = world.registry().emplace<MeshComponent>(meshEntity);
+        auto& mc = node.mesh.emplace();
         mc.meshIndex = static_cast<std::int32_t>(meshIdx);
-        mc.assetPath = cachedAssetPath;
+        mc.asset = assetId;
 
         std::int32_t matMapIdx = model.meshMaterialIndices[i];
         if (matMapIdx >= 0 && static_cast<size_t>(matMapIdx) < gpuMaterialIndices.size())
@@ -1038,6 +1079,10 @@ static bool import_model(const std::filesystem::path& objPath, AssetManager& ass
         ++meshesUploaded;
     }
 
+    std::vector<entt::entity> spawned;
+    const TransformComponent rootTransform{};
+    world.spawn_prefab(prefab, {&rootTransform, 1}, spawned);
+
     status = {
         fmt::format("Imported '{}': {} meshes, {} materials", modelName, meshesUploaded, gpuMaterialIndices.size()),
         false, 5.0f};
@@ -1061,34 +1106,38 @@ static void reload_level_assets(AssetManager& assetManager, IRenderer& renderer,
 {
     auto& reg = world.registry();
 
-    std::set<std::string> uniquePaths;
+    std::vector<AssetId> uniqueAssets;
     auto meshView = reg.view<MeshComponent>();
     for (auto entity : meshView)
     {
         const auto& mc = meshView.get<MeshComponent>(entity);
-        if (!mc.assetPath.empty())
-            uniquePaths.insert(mc.assetPath);
+        if (mc.asset.is_valid())
+            uniqueAssets.push_back(mc.asset);
     }
+    std::sort(uniqueAssets.begin(), uniqueAssets.end());
+    uniqueAssets.erase(std::unique(uniqueAssets.begin(), uniqueAssets.end()), uniqueAssets.end());
 
-    if (uniquePaths.empty())
+    if (uniqueAssets.empty())
         return;
 
-    std::unordered_map<std::string, std::unordered_map<std::string, MeshGpuInfo>> assetMeshMap;
+    // Keyed by asset.child(mesh name), so entities find their mesh without comparing strings.
+    std::unordered_map<AssetId, MeshGpuInfo> meshGpuInfos;
 
     std::uint32_t totalMeshes = 0;
     std::uint32_t totalMaterials = 0;
     struct LoadedModelEntry
     {
-        std::string assetPath;
+        AssetId asset;
         entt::resource<ModelData> modelHandle;
     };
     std::vector<LoadedModelEntry> loadedModels;
-    loadedModels.reserve(uniquePaths.size());
+    loadedModels.reserve(uniqueAssets.size());
     std::set<std::filesystem::path> uniqueTextureLoadPaths;
 
-    for (const auto& assetPath : uniquePaths)
+    const AssetRegistry& assetRegistry = AssetRegistry::get();
+    for (const AssetId asset : uniqueAssets)
     {
-        std::filesystem::path loadPath = resolve_texture_load_path(assetPath, project);
+        std::filesystem::path loadPath = resolve_texture_load_path(assetRegistry.path_of(asset), project);
 
         entt::resource<ModelData> modelHandle;
         try
@@ -1110,7 +1159,7 @@ static void reload_level_assets(AssetManager& assetManager, IRenderer& renderer,
         for (const auto& texturePath : collect_model_texture_load_paths(*modelHandle, project))
             uniqueTextureLoadPaths.insert(texturePath);
 
-        loadedModels.push_back({assetPath, modelHandle});
+        loadedModels.push_back({asset, modelHandle});
     }
 
     const std::vector<std::filesystem::path> allTextureLoadPaths(uniqueTextureLoadPaths.begin(),
@@ -1152,7 +1201,6 @@ static void reload_level_assets(AssetManager& assetManager, IRenderer& renderer,
         }
         totalMaterials += static_cast<std::uint32_t>(gpuMaterialIndices.size());
 
-        auto& nameMap = assetMeshMap[loadedModel.assetPath];
         for (size_t i = 0; i < model.meshes.size(); ++i)
         {
             auto uploadResult = renderer.upload_mesh(model.meshes[i]);
@@ -1171,21 +1219,24 @@ static void reload_level_assets(AssetManager& assetManager, IRenderer& renderer,
                 info.gpuMaterialIndex = static_cast<std::int32_t>(gpuMaterialIndices[matMapIdx]);
 
             std::string meshName = model.meshes[i].name.empty() ? fmt::format("SubMesh_{}", i) : model.meshes[i].name;
-            nameMap[meshName] = info;
+            meshGpuInfos[loadedModel.asset.child(meshName)] = info;
 
             ++totalMeshes;
         }
     }
 
+    std::unordered_set<AssetId> loadedAssets;
+    for (const auto& loadedModel : loadedModels)
+        loadedAssets.insert(loadedModel.asset);
+
     std::uint32_t updatedCount = 0;
     for (auto entity : meshView)
     {
         auto& mc = meshView.get<MeshComponent>(entity);
-        if (mc.assetPath.empty())
+        if (!mc.asset.is_valid())
             continue;
 
-        auto assetIt = assetMeshMap.find(mc.assetPath);
-        if (assetIt == assetMeshMap.end())
+        if (!loadedAssets.contains(mc.asset))
         {
             mc.meshIndex = -1;
             continue;
@@ -1198,8 +1249,8 @@ static void reload_level_assets(AssetManager& assetManager, IRenderer& renderer,
             continue;
         }
 
-        auto meshIt = assetIt->second.find(nameComp->name);
-        if (meshIt != assetIt->second.end())
+        auto meshIt = meshGpuInfos.find(mc.asset.child(nameComp->name));
+        if (meshIt != meshGpuInfos.end())
         {
             mc.meshIndex = meshIt->second.gpuMeshIndex;
             mc.materialIndex = meshIt->second.gpuMaterialIndex;
@@ -1207,8 +1258,8 @@ static void reload_level_assets(AssetManager& assetManager, IRenderer& renderer,
         }
         else
         {
-            fmt::print("Warning: entity '{}' has assetPath '{}' but no matching mesh name\n", nameComp->name,
-                       mc.assetPath);
+            fmt::print("Warning: entity '{}' has asset '{}' but no matching mesh name\n", nameComp->name,
+                       assetRegistry.path_of(mc.asset));
             mc.meshIndex = -1;
         }
     }
@@ -1239,10 +1290,53 @@ static void draw_status_message(StatusMessage& status, float deltaTime)
     ImGui::PopStyleColor();
 }
 
+//  Trace capture 
+
+/// `--trace <file>` on the command line, empty when absent.
+static std::filesystem::path find_trace_path(int argc, char** argv)
+{
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (std::string_view(argv[i]) == "--trace")
+            return argv[i + 1];
+    }
+    return {};
+}
+
+/// Captures profiler zones from construction to destruction, so every exit path of main writes the trace.
+class TraceCapture
+{
+  public:
+    explicit TraceCapture(std::filesystem::path path) : m_path(std::move(path))
+    {
+        if (m_path.empty())
+            return;
+        Profiler::set_thread_name("Main");
+        Profiler::start_capture();
+    }
+    ~TraceCapture()
+    {
+        if (m_path.empty())
+            return;
+        if (auto result = Profiler::stop_capture(m_path); !result)
+            fmt::print("Failed to write trace: {}\n", result.error().message);
+        else
+            fmt::print("Wrote trace to {}\n", m_path.string());
+    }
+
+    TraceCapture(const TraceCapture&) = delete;
+    TraceCapture& operator=(const TraceCapture&) = delete;
+
+  private:
+    std::filesystem::path m_path;
+};
+
 //  Main 
 
 int main(int argc, char** argv)
 {
+    const TraceCapture traceCapture{find_trace_path(argc, argv)};
+
     if (auto runtimePathsResult =
             RuntimePaths::initialize_current_process("NatureOfCraft", argc > 0 ? std::filesystem::path(argv[0]) : std::filesystem::path{});
         !runtimePathsResult)
@@ -1262,31 +1356,40 @@ int main(int argc, char** argv)
     window.set_framebuffer_size_callback(
         [&renderer](std::int32_t, std::int32_t) { renderer.on_framebuffer_resized(); });
 
-    if (auto code = get_error_code(renderer.initialize()); code != 0)
-        return code;
-
-    if (!Editor::UI::InitializeImGuiForVulkan(vulkan, window.get_glfw_window()))
-        return -1;
-
     //  Shared state 
     AssetManager assetManager;
+    vulkan.set_task_executor(&assetManager.get_executor());
     OrbitCameraController cameraController;
     ScriptEngine scriptEngine;
     PhysicsWorld physicsWorld;
 
-    if (auto initResult = scriptEngine.initialize(); !initResult)
-    {
-        fmt::print("Failed to initialize ScriptEngine: {}\n", initResult.error().message);
-        return -1;
-    }
+    // Vulkan stays on this thread (GLFW surface and framebuffer queries); LuaJIT and Jolt start up
+    // on workers meanwhile. Projects are opened later from the project browser.
+    StartupGraph startup;
+    startup.add("lua", [&]() -> Result<> {
+        if (auto initResult = scriptEngine.initialize(); !initResult)
+            return make_error(fmt::format("Failed to initialize ScriptEngine: {}", initResult.error().message),
+                              initResult.error().code);
+        return {};
+    });
+    startup.add("jolt", [&]() -> Result<> {
+        if (auto initResult = physicsWorld.initialize(); !initResult)
+            return make_error(fmt::format("Failed to initialize PhysicsWorld: {}", initResult.error().message),
+                              initResult.error().code);
+        return {};
+    });
+    if (auto code = get_error_code(startup.run("vulkan", [&]() { return renderer.initialize(); })); code != 0)
+        return code;
+    scriptEngine.set_physics_world(&physicsWorld);
 
-    if (auto initResult = physicsWorld.initialize(); !initResult)
-    {
-        fmt::print("Failed to initialize PhysicsWorld: {}\n", initResult.error().message);
+    if (!Editor::UI::InitializeImGuiForVulkan(vulkan, window.get_glfw_window()))
         return -1;
-    }
+
+    FramePacer framePacer{renderer};
+    window.set_frame_begin_callback([&framePacer]() { framePacer.begin_frame(); });
 
     bool physicsSimulationEnabled = false;
+    const World* renderablesSyncedWorld = nullptr; // world whose renderables the renderer currently mirrors
 
     EditorState editorState = EditorState::ProjectBrowser;
     std::unique_ptr<Project> project;
@@ -1336,6 +1439,22 @@ int main(int argc, char** argv)
         float minSampleShading{0.30f};
         bool nisEnabled{false};
         float nisSharpness{0.5f};
+        bool gpuCulling{false};
+        bool occlusionCulling{false};
+        bool depthPrepass{false};
+        float lodBias{1.0f};
+        bool shadows{true};
+        std::uint32_t shadowResolution{2048};
+        std::int32_t shadowCascades{4};
+        bool parallelRecording{true};
+        bool dynamicResolution{false};
+        float dynamicResolutionTargetMs{16.6f};
+        float dynamicResolutionMinScale{0.5f};
+        float dynamicResolutionMaxScale{1.0f};
+        float dynamicResolutionResponse{0.2f};
+        bool textureStreaming{true};
+        float textureStreamingBudget{0.8f};
+        float fpsCap{0.0f};
         bool initialized{false};
         bool dirty{false};
         bool autoApply{true};
@@ -1354,10 +1473,12 @@ int main(int argc, char** argv)
     ViewportAspectMode viewportAspectMode{ViewportAspectMode::Free};
     bool showSelectionOutline{true};
     bool showPhysicsColliders{true};
+    DebugDrawList debugDrawList; // refilled every frame, handed to the renderer before it draws
 
     //  State transition helpers 
 
     auto clear_runtime_scene_state = [&]() {
+        renderablesSyncedWorld = nullptr;
         if (auto clearResult = clear_runtime_scene(renderer, assetManager, scriptEngine, physicsWorld, level.get());
             !clearResult)
         {
@@ -1406,11 +1527,44 @@ int main(int argc, char** argv)
         graphicsDraft.minSampleShading = renderer.get_min_sample_shading();
         graphicsDraft.nisEnabled = renderer.get_nis_enabled();
         graphicsDraft.nisSharpness = renderer.get_nis_sharpness();
+        graphicsDraft.gpuCulling = renderer.get_gpu_culling_enabled();
+        graphicsDraft.occlusionCulling = renderer.get_occlusion_culling_enabled();
+        graphicsDraft.depthPrepass = renderer.get_depth_prepass_enabled();
+        graphicsDraft.lodBias = renderer.get_lod_bias();
+        graphicsDraft.shadows = renderer.get_shadows_enabled();
+        graphicsDraft.shadowResolution = renderer.get_shadow_map_resolution();
+        graphicsDraft.shadowCascades = static_cast<std::int32_t>(renderer.get_shadow_cascade_count());
+        graphicsDraft.parallelRecording = renderer.get_parallel_recording_enabled();
+        graphicsDraft.dynamicResolution = renderer.get_dynamic_resolution_enabled();
+        graphicsDraft.dynamicResolutionTargetMs = renderer.get_dynamic_resolution_target_ms();
+        graphicsDraft.dynamicResolutionMinScale = renderer.get_dynamic_resolution_min_scale();
+        graphicsDraft.dynamicResolutionMaxScale = renderer.get_dynamic_resolution_max_scale();
+        graphicsDraft.dynamicResolutionResponse = renderer.get_dynamic_resolution_response();
+        graphicsDraft.textureStreaming = renderer.get_texture_streaming_enabled();
+        graphicsDraft.textureStreamingBudget = renderer.get_texture_streaming_budget_fraction();
+        graphicsDraft.fpsCap = framePacer.get_fps_cap();
         graphicsDraft.initialized = true;
         graphicsDraft.dirty = false;
     };
 
+    // A background save still writes the current level's file, so it has to finish before that level
+    // is replaced or closed (and before the browser can open the same file again).
+    auto finish_level_save = [&]() {
+        if (!level)
+            return;
+        // A save that already finished but was not polled yet is reported as well.
+        std::optional<Result<>> saveResult =
+            level->is_saving() ? std::optional<Result<>>{level->wait_for_save()} : level->poll_save();
+        if (!saveResult)
+            return;
+        if (*saveResult)
+            statusMessage = {"Level saved.", false, 3.0f};
+        else
+            statusMessage = {fmt::format("Save failed: {}", saveResult->error().message), true, 5.0f};
+    };
+
     auto enter_level_editor = [&](std::unique_ptr<Level> newLevel) {
+        finish_level_save();
         clear_runtime_scene_state();
         level = std::move(newLevel);
         selectedEntity = entt::null;
@@ -1475,10 +1629,11 @@ int main(int argc, char** argv)
             auto meshView = world.registry().view<MeshComponent>();
             for (auto& em : editorMaterials)
             {
+                const AssetId materialId = AssetId::from_path(em.name);
                 for (auto entity : meshView)
                 {
                     const auto& mc = meshView.get<MeshComponent>(entity);
-                    if (mc.materialName == em.name && mc.materialIndex >= 0)
+                    if (mc.material == materialId && mc.materialIndex >= 0)
                     {
                         em.gpuIndex = mc.materialIndex;
                         break;
@@ -1497,6 +1652,7 @@ int main(int argc, char** argv)
     };
 
     auto enter_project_browser = [&]() {
+        finish_level_save();
         cameraController.detach();
         clear_runtime_scene_state();
         level.reset();
@@ -1612,6 +1768,11 @@ int main(int argc, char** argv)
     //  Main loop 
 
     if (auto code = get_error_code(window.loop([&]() {
+            NOC_PROFILE_FRAME_MARK();
+            NOC_PROFILE_ZONE("Frame");
+            AllocationCounter::end_frame();
+            FrameArena::begin_frame();
+
             // Frame timing
             auto now = std::chrono::steady_clock::now();
             deltaTime = std::chrono::duration<float>(now - lastFrameTime).count();
@@ -1639,14 +1800,27 @@ int main(int argc, char** argv)
                 scriptEngine.update(world, deltaTime);
                 physicsWorld.set_enabled(physicsSimulationEnabled);
                 physicsWorld.step(world, deltaTime);
-                world.update_world_matrices();
-                if (world.has_renderables_updates_pending())
+                world.update_world_matrices(&assetManager.get_executor());
+                if (renderablesSyncedWorld != &world)
+                {
+                    // Full resync after the renderer was emptied or the level changed; deltas from here on.
+                    world.set_mesh_bounds_provider(
+                        [&renderer](std::uint32_t meshIndex) { return renderer.get_mesh_bounds(meshIndex); });
                     renderer.set_renderables(world.collect_renderables());
+                    renderablesSyncedWorld = &world;
+                }
+                else if (world.has_renderables_updates_pending())
+                {
+                    renderer.update_renderables(world.collect_renderable_changes());
+                }
+                renderer.set_lights(world.collect_lights());
             }
             else
             {
                 // In project browser, render nothing
                 renderer.set_renderables({});
+                renderer.set_lights({});
+                renderablesSyncedWorld = nullptr;
             }
 
             // Apply graphics changes outside UI building to avoid descriptor/resource races.
@@ -1663,8 +1837,24 @@ int main(int argc, char** argv)
                     renderer.set_min_sample_shading(graphicsDraft.minSampleShading);
                     renderer.set_nis_enabled(graphicsDraft.nisEnabled);
                     renderer.set_nis_sharpness(graphicsDraft.nisSharpness);
+                    renderer.set_gpu_culling_enabled(graphicsDraft.gpuCulling);
+                    renderer.set_occlusion_culling_enabled(graphicsDraft.occlusionCulling);
+                    renderer.set_depth_prepass_enabled(graphicsDraft.depthPrepass);
+                    renderer.set_lod_bias(graphicsDraft.lodBias);
+                    renderer.set_shadows_enabled(graphicsDraft.shadows);
+                    renderer.set_shadow_map_resolution(graphicsDraft.shadowResolution);
+                    renderer.set_shadow_cascade_count(static_cast<std::uint32_t>(graphicsDraft.shadowCascades));
+                    renderer.set_parallel_recording_enabled(graphicsDraft.parallelRecording);
                     renderer.set_render_scale(graphicsDraft.renderScale);
+                    renderer.set_dynamic_resolution_target_ms(graphicsDraft.dynamicResolutionTargetMs);
+                    renderer.set_dynamic_resolution_scale_range(graphicsDraft.dynamicResolutionMinScale,
+                                                                graphicsDraft.dynamicResolutionMaxScale);
+                    renderer.set_dynamic_resolution_response(graphicsDraft.dynamicResolutionResponse);
+                    renderer.set_dynamic_resolution_enabled(graphicsDraft.dynamicResolution);
+                    renderer.set_texture_streaming_budget_fraction(graphicsDraft.textureStreamingBudget);
+                    renderer.set_texture_streaming_enabled(graphicsDraft.textureStreaming);
                     renderer.set_vsync(graphicsDraft.presentMode);
+                    framePacer.set_fps_cap(graphicsDraft.fpsCap);
                     refresh_viewport_texture();
                     sync_graphics_draft_from_runtime();
                     if (!graphicsDraft.autoApply)
@@ -2121,12 +2311,39 @@ int main(int argc, char** argv)
 
                         if (viewportDescriptorSet != nullptr)
                         {
+                            // Dynamic resolution may fill only part of the scene image.
+                            const DirectX::XMFLOAT2 uvExtent = vulkan.get_scene_color_uv_extent();
                             ImGui::Image(reinterpret_cast<ImTextureID>(viewportDescriptorSet), imageSize, ImVec2(0, 0),
-                                         ImVec2(1, 1));
+                                         ImVec2(uvExtent.x, uvExtent.y));
                             viewportHovered = ImGui::IsItemHovered();
                             viewportImageValid = true;
                             viewportImageMin = ImGui::GetItemRectMin();
                             viewportImageSize = ImGui::GetItemRectSize();
+
+                            // Click-to-select: the collider under the cursor, or the nearest mesh box
+                            // when that belongs to an entity without a body and lies in front of it.
+                            if (level && ImGui::IsItemClicked(ImGuiMouseButton_Left))
+                            {
+                                const std::uint32_t rw = renderer.get_render_width();
+                                const std::uint32_t rh = renderer.get_render_height();
+                                const float ar = (rh > 0) ? static_cast<float>(rw) / static_cast<float>(rh) : 1.0f;
+                                const DirectX::XMMATRIX pickViewProj = DirectX::XMMatrixMultiply(
+                                    cameraController.get_view_matrix(), cameraController.get_projection_matrix(ar));
+                                DirectX::XMFLOAT3 rayOrigin{};
+                                DirectX::XMFLOAT3 rayDirection{};
+                                screen_to_world_ray(ImGui::GetMousePos(), pickViewProj, viewportImageMin,
+                                                    viewportImageSize, rayOrigin, rayDirection);
+                                constexpr float pickDistance = 10000.0f;
+                                auto& pickWorld = level->world();
+                                const auto bodyHit = physicsWorld.raycast({rayOrigin, rayDirection, pickDistance});
+                                const auto boxHit = pickWorld.spatial_index().raycast(rayOrigin, rayDirection, pickDistance);
+                                const bool bodyHitValid = bodyHit && pickWorld.registry().valid(bodyHit->entity);
+                                if (boxHit && (!bodyHitValid || (boxHit->distance < bodyHit->distance &&
+                                                                 !pickWorld.registry().all_of<PhysicsBodyComponent>(boxHit->entity))))
+                                    selectedEntity = boxHit->entity;
+                                else
+                                    selectedEntity = bodyHitValid ? bodyHit->entity : entt::null;
+                            }
                         }
                         else
                         {
@@ -2162,24 +2379,93 @@ int main(int argc, char** argv)
                             ImGui::Text("FPS: %.1f", fpsSmoothed);
                             ImGui::Text("Frame Time: %.2f ms", deltaTime * 1000.0f);
                         }
+                        if (vulkan.is_gpu_timing_supported())
+                        {
+                            const GpuTimingStats& gpuFrame = vulkan.get_gpu_frame_timing();
+                            ImGui::Text("GPU Frame: %.2f ms (min %.2f / max %.2f)", gpuFrame.averageMs, gpuFrame.minMs,
+                                        gpuFrame.maxMs);
+                        }
+                        else
+                        {
+                            ImGui::TextDisabled("GPU timestamps unavailable on this GPU/driver.");
+                        }
+                        if (showDetailedMetrics && vulkan.is_gpu_timing_supported())
+                        {
+                            const ImGuiTableFlags gpuTimingFlags =
+                                ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable;
+                            if (ImGui::BeginTable("GpuTimingTable", 4, gpuTimingFlags))
+                            {
+                                ImGui::TableSetupColumn("GPU Pass");
+                                ImGui::TableSetupColumn("Avg (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                                ImGui::TableSetupColumn("Min (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                                ImGui::TableSetupColumn("Max (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                                ImGui::TableHeadersRow();
+                                for (std::size_t passIndex = 0; passIndex < GpuPassCount; ++passIndex)
+                                {
+                                    const GpuPass pass = static_cast<GpuPass>(passIndex);
+                                    const GpuTimingStats& timing = vulkan.get_gpu_pass_timing(pass);
+                                    if (timing.sampleCount == 0)
+                                        continue;
+                                    ImGui::TableNextRow();
+                                    ImGui::TableNextColumn();
+                                    ImGui::TextUnformatted(VulkanGpuProfiler::get_pass_name(pass));
+                                    ImGui::TableNextColumn();
+                                    ImGui::Text("%.3f", timing.averageMs);
+                                    ImGui::TableNextColumn();
+                                    ImGui::Text("%.3f", timing.minMs);
+                                    ImGui::TableNextColumn();
+                                    ImGui::Text("%.3f", timing.maxMs);
+                                }
+                                ImGui::EndTable();
+                            }
+
+                            const GpuPipelineStatistics& pipelineStats = vulkan.get_gpu_pipeline_statistics();
+                            if (vulkan.has_gpu_pipeline_statistics() && pipelineStats.valid)
+                            {
+                                ImGui::Text("Scene Vertex Invocations: %llu",
+                                            static_cast<unsigned long long>(pipelineStats.vertexShaderInvocations));
+                                ImGui::Text("Scene Clipped Primitives: %llu",
+                                            static_cast<unsigned long long>(pipelineStats.clippingPrimitives));
+                                ImGui::Text("Scene Fragment Invocations: %llu",
+                                            static_cast<unsigned long long>(pipelineStats.fragmentShaderInvocations));
+                            }
+                        }
                         ImGui::Checkbox("Detailed Metrics", &showDetailedMetrics);
                         ImGui::Separator();
                         ImGui::Text("GPU: %s", gpuName.c_str());
                         ImGui::Text("Resolution: %u x %u", rw, rh);
                         ImGui::Text("Present Mode: %s", present_mode_name(vulkan.get_present_mode()));
+                        const FramePacer::Stats pacing = framePacer.get_stats();
+                        ImGui::Text("Frame Pacing: %.2f ms GPU wait, %.2f ms limiter sleep", pacing.latency.waitMs,
+                                    pacing.sleepMs);
+                        ImGui::Text("Input to Present (est): %.1f ms (%s)", pacing.latency.inputToPresentMs,
+                                    pacing.latency.presentWait ? "present wait" : "frame fence");
                         ImGui::Text("Surface Format: %s", vk_format_name(vulkan.get_swapchain_format()));
                         ImGui::Text("MSAA: %s", msaa_sample_count_name(renderer.get_msaa_samples()));
-                        ImGui::Text("Render Scale: %.0f%%", renderer.get_render_scale() * 100.0f);
+                        if (renderer.get_dynamic_resolution_enabled())
+                            ImGui::Text("Render Scale: %.0f%% (dynamic)", renderer.get_dynamic_resolution_scale() * 100.0f);
+                        else
+                            ImGui::Text("Render Scale: %.0f%%", renderer.get_render_scale() * 100.0f);
                         ImGui::Text("Swapchain Images: %u", vulkan.get_swapchain_image_count());
                         ImGui::Separator();
                         ImGui::Text("Submitted Renderables: %u", vulkan.get_renderable_count());
                         ImGui::Text("Visible Renderables: %u", vulkan.get_last_visible_renderable_count());
                         ImGui::Text("Culled Renderables: %u", vulkan.get_last_culled_renderable_count());
+                        ImGui::Text("Occluded Renderables: %u", vulkan.get_last_occluded_renderable_count());
                         ImGui::Text("Instanced Batches: %u", vulkan.get_last_instanced_batch_count());
                         ImGui::Text("Draw Calls: %u", vulkan.get_last_draw_call_count());
+                        ImGui::Text("Scene Record Chunks: %u", vulkan.get_last_scene_record_chunk_count());
+                        ImGui::Text("Clustered Lights: %u", vulkan.get_light_count());
+                        ImGui::Text("Shadow Cascades Rendered: %u", vulkan.get_last_shadow_cascade_render_count());
+                        ImGui::Text("Shadow Draw Calls: %u", vulkan.get_last_shadow_draw_call_count());
+                        ImGui::Text("Debug Primitives: %u (%u draw calls)", vulkan.get_debug_draw_instance_count(),
+                                    vulkan.get_last_debug_draw_call_count());
                         ImGui::Text("Triangles: %u", vulkan.get_total_triangle_count());
                         ImGui::Text("Meshes Loaded: %u", vulkan.get_mesh_count());
                         ImGui::Text("Textures Loaded: %u", vulkan.get_texture_count());
+                        ImGui::Text("Streamed Textures: %u (%u swapping, %u mips missing)",
+                                    vulkan.get_streamed_texture_count(), vulkan.get_texture_streams_in_flight(),
+                                    vulkan.get_texture_streaming_missing_mips());
                         ImGui::Text("Materials Loaded: %u", vulkan.get_material_count());
                         if (showDetailedMetrics)
                         {
@@ -2189,12 +2475,32 @@ int main(int argc, char** argv)
                                         bytes_to_mib(vulkan.get_tracked_host_visible_memory_bytes()));
                             ImGui::Text("Tracked Total Alloc: %.2f MiB",
                                         bytes_to_mib(vulkan.get_total_tracked_memory_bytes()));
-                            ImGui::Text("Mesh VRAM (alloc): %.2f MiB", bytes_to_mib(vulkan.get_mesh_memory_bytes()));
-                            ImGui::Text("Texture VRAM (alloc): %.2f MiB", bytes_to_mib(vulkan.get_texture_memory_bytes()));
+                            ImGui::Text("Mesh VRAM (used/alloc): %.2f / %.2f MiB", bytes_to_mib(vulkan.get_mesh_memory_bytes()),
+                                        bytes_to_mib(vulkan.get_mesh_reserved_memory_bytes()));
+                            ImGui::Text("Geometry Arena Pages: %u", vulkan.get_geometry_page_count());
+                            ImGui::Text("Texture VRAM (used/alloc): %.2f / %.2f MiB",
+                                        bytes_to_mib(vulkan.get_texture_memory_bytes()),
+                                        bytes_to_mib(vulkan.get_texture_reserved_memory_bytes()));
+                            const VulkanAllocator& allocator = vulkan.get_device_allocator();
+                            const VulkanAllocatorStats bufferStats = allocator.get_stats(VulkanResourceKind::Buffer);
+                            const VulkanAllocatorStats imageStats = allocator.get_stats(VulkanResourceKind::Image);
+                            ImGui::Text("Allocator Blocks: %u (+%u dedicated), %u resources",
+                                        bufferStats.blockCount + imageStats.blockCount,
+                                        bufferStats.dedicatedCount + imageStats.dedicatedCount,
+                                        bufferStats.allocationCount + imageStats.allocationCount);
+                            ImGui::Text("Allocator Device Memory Objects: %u", allocator.get_device_memory_count());
                             ImGui::Text("Scene Targets (alloc): %.2f MiB", bytes_to_mib(vulkan.get_scene_target_memory_bytes()));
                             ImGui::Text("Instance Buffers (alloc): %.2f MiB", bytes_to_mib(vulkan.get_instance_memory_bytes()));
+                            ImGui::Text("Light Buffers (alloc): %.2f MiB", bytes_to_mib(vulkan.get_light_memory_bytes()));
+                            ImGui::Text("Shadow Maps (alloc): %.2f MiB", bytes_to_mib(vulkan.get_shadow_memory_bytes()));
+                            ImGui::Text("Debug Draw Buffers (alloc): %.2f MiB",
+                                        bytes_to_mib(vulkan.get_debug_draw_memory_bytes()));
+                            ImGui::Text("Instance Upload (last frame): %.2f KiB",
+                                        static_cast<double>(vulkan.get_last_instance_upload_bytes()) / 1024.0);
                             ImGui::Text("Upload Staging (alloc): %.2f MiB",
                                         bytes_to_mib(vulkan.get_upload_staging_memory_bytes()));
+                            ImGui::Text("Upload Batches In Flight: %u (%s queue)", vulkan.get_upload_batches_in_flight(),
+                                        vulkan.has_dedicated_transfer_queue() ? "transfer" : "graphics");
                             const DeviceLocalMemoryBudget vramBudget = vulkan.get_device_local_memory_budget();
                             if (vramBudget.supported)
                             {
@@ -2205,13 +2511,71 @@ int main(int argc, char** argv)
                             {
                                 ImGui::TextDisabled("Driver VRAM usage/budget unavailable on this GPU/driver.");
                             }
+                            if (vulkan.get_texture_streaming_limit_bytes() > 0)
+                                ImGui::Text("Texture Streaming Limit: %.2f MiB",
+                                            bytes_to_mib(vulkan.get_texture_streaming_limit_bytes()));
                         }
                         else
                         {
                             ImGui::Text("Mesh VRAM (est): %.2f MiB", bytes_to_mib(vulkan.get_mesh_memory_bytes()));
                             ImGui::Text("Texture VRAM (est): %.2f MiB", bytes_to_mib(vulkan.get_texture_memory_bytes()));
                         }
+                        ImGui::Text("CPU Asset Payloads: %.2f MiB", bytes_to_mib(assetManager.get_cpu_memory_bytes()));
+                        const FrameArena::Stats arenaStats = FrameArena::get_stats();
+                        ImGui::Text("Frame Arenas: %.2f MiB over %u threads (peak frame %.2f MiB)",
+                                    bytes_to_mib(arenaStats.reservedBytes), arenaStats.threadCount,
+                                    bytes_to_mib(arenaStats.peakFrameBytes));
+                        if constexpr (AllocationCounter::is_enabled())
+                        {
+                            const AllocationCounter::FrameAllocations heap = AllocationCounter::get_last_frame();
+                            ImGui::Text("Heap Allocations (last frame): %llu (%.1f KiB)",
+                                        static_cast<unsigned long long>(heap.count),
+                                        static_cast<double>(heap.bytes) / 1024.0);
+                        }
                         ImGui::Text("Script Environments: %zu", scriptEngine.get_environment_count());
+                        ImGui::Text("Lua Memory: %.2f MiB", bytes_to_mib(scriptEngine.get_lua_memory_bytes()));
+                        ImGui::Text("Lua GC (last frame): %.3f ms", scriptEngine.get_last_gc_milliseconds());
+                        float gcBudget = scriptEngine.get_gc_step_budget();
+                        if (ImGui::SliderFloat("Lua GC Budget (ms)", &gcBudget, 0.0f, 4.0f, "%.2f"))
+                            scriptEngine.set_gc_step_budget(gcBudget);
+
+                        const auto scriptProfile = scriptEngine.get_script_profile();
+                        if (showDetailedMetrics && !scriptProfile.empty())
+                        {
+                            ImGui::Separator();
+                            ImGui::TextUnformatted("Script Profiler");
+                            ImGui::SameLine();
+                            if (ImGui::SmallButton("Reset##ScriptProfile"))
+                                scriptEngine.reset_script_profile();
+
+                            const ImGuiTableFlags profileFlags =
+                                ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable;
+                            if (ImGui::BeginTable("ScriptProfileTable", 4, profileFlags))
+                            {
+                                ImGui::TableSetupColumn("Script");
+                                ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                                ImGui::TableSetupColumn("Avg (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                                ImGui::TableSetupColumn("Max (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                                ImGui::TableHeadersRow();
+
+                                for (const ScriptProfileEntry& entry : scriptProfile)
+                                {
+                                    const double average =
+                                        entry.callCount > 0 ? entry.totalMilliseconds / static_cast<double>(entry.callCount)
+                                                            : 0.0;
+                                    ImGui::TableNextRow();
+                                    ImGui::TableSetColumnIndex(0);
+                                    ImGui::TextUnformatted(entry.scriptPath.c_str());
+                                    ImGui::TableSetColumnIndex(1);
+                                    ImGui::Text("%llu", static_cast<unsigned long long>(entry.callCount));
+                                    ImGui::TableSetColumnIndex(2);
+                                    ImGui::Text("%.3f", average);
+                                    ImGui::TableSetColumnIndex(3);
+                                    ImGui::Text("%.3f", entry.maxMilliseconds);
+                                }
+                                ImGui::EndTable();
+                            }
+                        }
                     }
                     ImGui::End();
                 }
@@ -2291,14 +2655,44 @@ int main(int argc, char** argv)
                             ImGui::EndDisabled();
 
                         // Render scale
+                        if (graphicsDraft.dynamicResolution)
+                            ImGui::BeginDisabled();
                         bool renderScaleChanged =
                             ImGui::SliderFloat("Render Scale", &graphicsDraft.renderScale, 0.25f, 2.0f, "%.2f");
                         const bool renderScaleReleased = ImGui::IsItemDeactivatedAfterEdit();
                         if (renderScaleChanged)
                             graphicsDraft.dirty = true;
-                        if (graphicsDraft.renderScale > 1.0f)
+                        if (graphicsDraft.dynamicResolution)
+                            ImGui::EndDisabled();
+                        if (graphicsDraft.renderScale > 1.0f && !graphicsDraft.dynamicResolution)
                             ImGui::TextColored(ImVec4(1.0f, 0.85f, 0.3f, 1.0f), "SSAA active (Render Scale > 1.0). MSAA locked to Off.");
 
+                        // Dynamic resolution
+                        bool dynamicResolutionChanged =
+                            ImGui::Checkbox("Dynamic Resolution", &graphicsDraft.dynamicResolution);
+                        if (dynamicResolutionChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("Scales the render resolution every frame to hold the GPU frame time target.\nReplaces Render Scale while enabled.");
+                        if (!graphicsDraft.dynamicResolution)
+                            ImGui::BeginDisabled();
+                        bool dynamicTargetChanged = ImGui::SliderFloat(
+                            "Target GPU Time (ms)", &graphicsDraft.dynamicResolutionTargetMs, 4.0f, 50.0f, "%.1f");
+                        const bool dynamicTargetReleased = ImGui::IsItemDeactivatedAfterEdit();
+                        bool dynamicRangeChanged = ImGui::DragFloatRange2(
+                            "Scale Range", &graphicsDraft.dynamicResolutionMinScale,
+                            &graphicsDraft.dynamicResolutionMaxScale, 0.01f, 0.25f, 1.0f, "Min %.2f", "Max %.2f");
+                        const bool dynamicRangeReleased = ImGui::IsItemDeactivatedAfterEdit();
+                        bool dynamicResponseChanged = ImGui::SliderFloat(
+                            "Response Rate", &graphicsDraft.dynamicResolutionResponse, 0.01f, 1.0f, "%.2f");
+                        const bool dynamicResponseReleased = ImGui::IsItemDeactivatedAfterEdit();
+                        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+                            ImGui::SetTooltip("Share of the gap to the ideal scale closed each frame.\nLower values react slower but flicker less.");
+                        if (dynamicTargetChanged || dynamicRangeChanged || dynamicResponseChanged)
+                            graphicsDraft.dirty = true;
+                        if (!graphicsDraft.dynamicResolution)
+                            ImGui::EndDisabled();
+
                         // NIS (NVIDIA Image Scaling)
                         ImGui::Spacing();
                         ImGui::SeparatorText("NVIDIA Image Scaling (NIS)");
@@ -2320,6 +2714,94 @@ int main(int argc, char** argv)
                         if (!graphicsDraft.nisEnabled)
                             ImGui::EndDisabled();
 
+                        // Culling
+                        ImGui::Spacing();
+                        ImGui::SeparatorText("Culling");
+                        bool gpuCullingChanged = ImGui::Checkbox("GPU-Driven Culling", &graphicsDraft.gpuCulling);
+                        if (gpuCullingChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("Frustum-culls renderables in a compute pass and draws them indirectly.\nVisible/culled stats are read back from the GPU with a short delay.");
+                        bool occlusionCullingChanged =
+                            ImGui::Checkbox("Occlusion Culling", &graphicsDraft.occlusionCulling);
+                        if (occlusionCullingChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("Skips renderables hidden behind the previous frame's depth (Hi-Z pyramid).\nObjects revealed by fast camera motion may appear a frame late.");
+                        bool depthPrepassChanged = ImGui::Checkbox("Depth Prepass", &graphicsDraft.depthPrepass);
+                        if (depthPrepassChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("Lays down scene depth with a position-only pass first, so materials are shaded\nonce per pixel instead of once per overlapping surface.");
+
+                        // Level of detail
+                        bool lodBiasChanged = ImGui::SliderFloat("LOD Bias", &graphicsDraft.lodBias, 0.25f, 4.0f, "%.2f");
+                        const bool lodBiasReleased = ImGui::IsItemDeactivatedAfterEdit();
+                        if (lodBiasChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("On-screen error (in pixels) a mesh LOD may show before a finer level is used.\nHigher values switch to simplified meshes sooner. LODs are generated when cooking.");
+
+                        // Sun shadows
+                        bool shadowsChanged = ImGui::Checkbox("Sun Shadows", &graphicsDraft.shadows);
+                        if (shadowsChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("Cascaded shadow maps for the sun. Distant cascades are cached and hold static objects only;\nthey are re-rendered when the camera moves far enough or static geometry inside them changes.");
+                        bool shadowResolutionChanged = false;
+                        if (!graphicsDraft.shadows)
+                            ImGui::BeginDisabled();
+                        const std::string shadowResolutionLabel = std::to_string(graphicsDraft.shadowResolution);
+                        if (ImGui::BeginCombo("Shadow Resolution", shadowResolutionLabel.c_str()))
+                        {
+                            constexpr std::array<std::uint32_t, 3> shadowResolutionOptions = {1024, 2048, 4096};
+                            for (std::uint32_t opt : shadowResolutionOptions)
+                            {
+                                bool isSelected = (graphicsDraft.shadowResolution == opt);
+                                if (ImGui::Selectable(std::to_string(opt).c_str(), isSelected))
+                                {
+                                    graphicsDraft.shadowResolution = opt;
+                                    graphicsDraft.dirty = true;
+                                    shadowResolutionChanged = true;
+                                }
+                                if (isSelected)
+                                    ImGui::SetItemDefaultFocus();
+                            }
+                            ImGui::EndCombo();
+                        }
+                        bool shadowCascadesChanged = ImGui::SliderInt("Shadow Cascades", &graphicsDraft.shadowCascades, 1, 4);
+                        const bool shadowCascadesReleased = ImGui::IsItemDeactivatedAfterEdit();
+                        if (shadowCascadesChanged)
+                            graphicsDraft.dirty = true;
+                        if (!graphicsDraft.shadows)
+                            ImGui::EndDisabled();
+
+                        bool parallelRecordingChanged =
+                            ImGui::Checkbox("Parallel Recording", &graphicsDraft.parallelRecording);
+                        if (parallelRecordingChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("Records the scene pass's draws into secondary command buffers on worker threads\nonce a frame has enough instanced batches to split.");
+
+                        // Texture streaming
+                        bool textureStreamingChanged =
+                            ImGui::Checkbox("Texture Streaming", &graphicsDraft.textureStreaming);
+                        if (textureStreamingChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("Loads the finer mip levels of cooked textures only as large as they appear on screen.\nWhen disabled, every texture is brought to full resolution.");
+                        if (!graphicsDraft.textureStreaming)
+                            ImGui::BeginDisabled();
+                        bool streamingBudgetChanged = ImGui::SliderFloat(
+                            "Streaming Budget", &graphicsDraft.textureStreamingBudget, 0.25f, 0.95f, "%.2f");
+                        const bool streamingBudgetReleased = ImGui::IsItemDeactivatedAfterEdit();
+                        if (streamingBudgetChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+                            ImGui::SetTooltip("Share of the driver's VRAM budget that total usage is kept under; finer mips are\ndropped from textures off screen first when it is exceeded. Needs VK_EXT_memory_budget.");
+                        if (!graphicsDraft.textureStreaming)
+                            ImGui::EndDisabled();
+
                         // Present mode
                         bool presentModeChanged = false;
                         std::int32_t selected = static_cast<std::int32_t>(graphicsDraft.presentMode);
@@ -2345,6 +2827,14 @@ int main(int argc, char** argv)
                             graphicsDraft.dirty = true;
                             presentModeChanged = true;
                         }
+                        bool fpsCapChanged = ImGui::SliderFloat("FPS Cap", &graphicsDraft.fpsCap, 0.0f, 360.0f,
+                                                                graphicsDraft.fpsCap > 0.0f ? "%.0f" : "Off");
+                        const bool fpsCapReleased = ImGui::IsItemDeactivatedAfterEdit();
+                        if (fpsCapChanged)
+                            graphicsDraft.dirty = true;
+                        if (ImGui::IsItemHovered())
+                            ImGui::SetTooltip("Sleeps off the rest of each frame with a high-precision timer. Also holds
+Mailbox/Immediate and the project browser, which otherwise run as fast as they can.");
 
                         ImGui::Checkbox("Auto Apply", &graphicsDraft.autoApply);
                         if (graphicsDraft.autoApply && graphicsDraft.dirty)
@@ -2352,7 +2842,12 @@ int main(int argc, char** argv)
                             // Apply MSAA/present/A2C/sample-shading changes immediately, but only apply render scale
                             // and min sample shading when the slider interaction is committed (release/enter).
                             if (msaaChanged || presentModeChanged || a2cChanged || sampleShadingChanged
-                                || renderScaleReleased || minSampleReleased || nisChanged || nisSharpnessReleased)
+                                || renderScaleReleased || minSampleReleased || nisChanged || nisSharpnessReleased
+                                || gpuCullingChanged || occlusionCullingChanged || depthPrepassChanged
+                                || lodBiasReleased || shadowsChanged || shadowResolutionChanged || shadowCascadesReleased
+                                || parallelRecordingChanged || dynamicResolutionChanged || dynamicTargetReleased
+                                || dynamicRangeReleased || dynamicResponseReleased || textureStreamingChanged
+                                || streamingBudgetReleased || fpsCapReleased)
                                 graphicsApplyRequested = true;
                         }
 
@@ -2368,20 +2863,31 @@ int main(int argc, char** argv)
                         // Shader recompilation
                         ImGui::Spacing();
                         ImGui::SeparatorText("Shaders");
+                        // Compiled and built in the background; the old pipeline draws until the swap.
+                        const bool shaderReloadPending = renderer.is_shader_reload_pending();
+                        ImGui::BeginDisabled(shaderReloadPending);
                         if (ImGui::Button("Recompile Shaders"))
-                        {
-                            renderer.wait_idle();
-                            auto result = renderer.recompile_shaders();
-                            if (result)
-                                statusMessage = {"Shaders recompiled successfully.", false, 3.0f};
-                            else
-                                statusMessage =
-                                    {fmt::format("Shader compilation failed: {}", result.error().message), true, 5.0f};
-                        }
+                            renderer.request_shader_reload();
+                        ImGui::EndDisabled();
+                        ImGui::SameLine();
+                        bool shaderHotReload = renderer.get_shader_hot_reload();
+                        if (ImGui::Checkbox("Hot Reload", &shaderHotReload))
+                            renderer.set_shader_hot_reload(shaderHotReload);
+                        if (shaderReloadPending)
+                            ImGui::TextDisabled("Compiling shaders...");
                     }
                     ImGui::End();
                 }
 
+                if (auto reloadResult = renderer.poll_shader_reload())
+                {
+                    if (*reloadResult)
+                        statusMessage = {"Shaders recompiled successfully.", false, 3.0f};
+                    else
+                        statusMessage =
+                            {fmt::format("Shader compilation failed: {}", reloadResult->error().message), true, 5.0f};
+                }
+
                 // --- Level Panel ---
                 if (showLevelPanel)
                 {
@@ -2399,7 +2905,10 @@ int main(int argc, char** argv)
                     if (!level->file_path().empty())
                         ImGui::TextDisabled("File: %s", level->file_path().c_str());
 
-                    if (ImGui::Button("Save"))
+                    ImGui::BeginDisabled(level->is_saving());
+                    const bool saveClicked = ImGui::Button(level->is_saving() ? "Saving..." : "Save");
+                    ImGui::EndDisabled();
+                    if (saveClicked)
                     {
                         if (level->file_path().empty())
                         {
@@ -2442,14 +2951,23 @@ int main(int argc, char** argv)
                         }
                         else
                         {
-                            auto result = level->save();
+                            // Written on a background job; the result is picked up by poll_save() below.
+                            auto result = level->save_async();
                             if (result)
-                                statusMessage = {"Level saved.", false, 3.0f};
+                                statusMessage = {"Saving level...", false, 3.0f};
                             else
                                 statusMessage = {fmt::format("Save failed: {}", result.error().message), true, 5.0f};
                         }
                     }
 
+                    if (auto saveResult = level->poll_save())
+                    {
+                        if (*saveResult)
+                            statusMessage = {"Level saved.", false, 3.0f};
+                        else
+                            statusMessage = {fmt::format("Save failed: {}", saveResult->error().message), true, 5.0f};
+                    }
+
                     ImGui::SameLine();
                     if (ImGui::Button("Back to Projects"))
                         backToProjectsRequested = true;
@@ -2853,8 +3371,8 @@ int main(int argc, char** argv)
                             {
                                 if (mc->meshIndex >= 0)
                                     ImGui::Text("Mesh Index: %d", mc->meshIndex);
-                                if (!mc->assetPath.empty())
-                                    ImGui::TextDisabled("Asset: %s", mc->assetPath.c_str());
+                                if (const std::string_view assetPath = AssetRegistry::get().path_of(mc->asset); !assetPath.empty())
+                                    ImGui::TextDisabled("Asset: %.*s", static_cast<int>(assetPath.size()), assetPath.data());
 
                                 // Material assignment dropdown
                                 {
@@ -2878,7 +3396,7 @@ int main(int argc, char** argv)
                                             if (ImGui::Selectable(em.name.c_str(), isSel))
                                             {
                                                 mc->materialIndex = em.gpuIndex;
-                                                mc->materialName = em.name;
+                                                mc->material = AssetRegistry::get().intern(em.name);
                                                 world.mark_renderables_dirty();
                                                 if (level) level->mark_dirty();
                                             }
@@ -3004,6 +3522,24 @@ int main(int argc, char** argv)
                                 ImGui::EndCombo();
                             }
 
+                            if (ImGui::BeginCombo("Collision Group", physics_collision_group_name(pc->collisionGroup)))
+                            {
+                                for (std::int32_t i = 0; i < 3; ++i)
+                                {
+                                    const auto group = static_cast<PhysicsBodyCollisionGroup>(i);
+                                    const bool selected = (pc->collisionGroup == group);
+                                    if (ImGui::Selectable(physics_collision_group_name(group), selected))
+                                    {
+                                        pc->collisionGroup = group;
+                                        pc->runtimeDirty = true;
+                                        level->mark_dirty();
+                                    }
+                                    if (selected)
+                                        ImGui::SetItemDefaultFocus();
+                                }
+                                ImGui::EndCombo();
+                            }
+
                             if (ImGui::BeginCombo("Collider Shape", physics_collider_shape_name(pc->shapeType)))
                             {
                                 for (std::int32_t i = 0; i < 8; ++i)
@@ -3099,9 +3635,12 @@ int main(int argc, char** argv)
                                 level->mark_dirty();
                             }
 
+                            // Queues the body for PhysicsWorld's next sync.
+                            if (pc->runtimeDirty)
+                                world.registry().patch<PhysicsBodyComponent>(selectedEntity);
+
                             if (ImGui::Button("Remove Physics Body"))
                             {
-                                physicsWorld.on_entity_removed(selectedEntity);
                                 world.registry().remove<PhysicsBodyComponent>(selectedEntity);
                                 level->mark_dirty();
                             }
@@ -3113,13 +3652,63 @@ int main(int argc, char** argv)
                             level->mark_dirty();
                         }
 
+                        ImGui::Separator();
+                        if (auto* lc = world.registry().try_get<LightComponent>(selectedEntity))
+                        {
+                            ImGui::Text("Light");
+
+                            if (ImGui::BeginCombo("Light Type", light_type_name(lc->type)))
+                            {
+                                for (std::int32_t i = 0; i < 3; ++i)
+                                {
+                                    auto lightType = static_cast<LightType>(i);
+                                    bool selected = (lc->type == lightType);
+                                    if (ImGui::Selectable(light_type_name(lightType), selected))
+                                    {
+                                        lc->type = lightType;
+                                        level->mark_dirty();
+                                    }
+                                    if (selected)
+                                        ImGui::SetItemDefaultFocus();
+                                }
+                                ImGui::EndCombo();
+                            }
+
+                            bool lightChanged = false;
+                            lightChanged |= ImGui::ColorEdit3("Light Color", &lc->color.x);
+                            lightChanged |= ImGui::DragFloat("Intensity", &lc->intensity, 0.05f, 0.0f, 1000.0f);
+                            if (lc->type != LightType::Directional)
+                                lightChanged |= ImGui::DragFloat("Range", &lc->range, 0.1f, 0.01f, 1000.0f);
+                            if (lc->type == LightType::Spot)
+                            {
+                                lightChanged |= ImGui::SliderFloat("Inner Cone", &lc->innerConeAngle, 0.0f, 89.9f, "%.1f deg");
+                                lightChanged |= ImGui::SliderFloat("Outer Cone", &lc->outerConeAngle, 0.1f, 89.9f, "%.1f deg");
+                                lc->innerConeAngle = std::min(lc->innerConeAngle, lc->outerConeAngle);
+                            }
+                            if (lc->type != LightType::Point)
+                                ImGui::TextDisabled("Shines along the entity's local -Z axis");
+                            if (lightChanged)
+                                level->mark_dirty();
+
+                            if (ImGui::Button("Remove Light"))
+                            {
+                                world.registry().remove<LightComponent>(selectedEntity);
+                                level->mark_dirty();
+                            }
+                        }
+                        else if (ImGui::Button("Add Light"))
+                        {
+                            world.registry().emplace<LightComponent>(selectedEntity);
+                            level->mark_dirty();
+                        }
+
                         ImGui::Separator();
                         auto& tc = world.registry().get<TransformComponent>(selectedEntity);
                         if (draw_transform_inspector(tc))
                         {
                             if (auto* pc = world.registry().try_get<PhysicsBodyComponent>(selectedEntity))
                                 pc->runtimeDirty = true;
-                            world.mark_transforms_dirty();
+                            world.mark_transform_dirty(selectedEntity);
                             level->mark_dirty();
                         }
 
@@ -3139,7 +3728,6 @@ int main(int argc, char** argv)
                             else
                             {
                                 scriptEngine.on_entity_tree_destroyed(world, selectedEntity);
-                                physicsWorld.on_entity_tree_destroyed(world, selectedEntity);
                                 world.destroy_entity(selectedEntity);
                                 selectedEntity = entt::null;
                                 level->mark_dirty();
@@ -3169,164 +3757,39 @@ int main(int argc, char** argv)
                     XMMATRIX projMat = cameraController.get_projection_matrix(ar);
                     XMMATRIX viewProj = XMMatrixMultiply(viewMat, projMat);
 
+                    // Drawn by the renderer into the scene pass; line widths are always one pixel.
                     auto debugView = world.registry().view<PhysicsBodyComponent, WorldMatrixCache>();
-                    ImDrawList* drawList = ImGui::GetForegroundDrawList();
-                    const ImU32 lineColor = IM_COL32(120, 210, 255, 220);
-                    const ImU32 selectionColor = IM_COL32(255, 180, 60, 255);
-
-                    constexpr std::array<std::pair<int, int>, 12> edges = {
-                        std::pair<int, int>{0, 1}, {1, 2}, {2, 3}, {3, 0},
-                        {4, 5}, {5, 6}, {6, 7}, {7, 4},
-                        {0, 4}, {1, 5}, {2, 6}, {3, 7},
-                    };
-
-                    const auto project_point = [&](const XMMATRIX& worldMatrix, const XMFLOAT3& localPoint,
-                                                   ImVec2& out) -> bool {
-                        const XMVECTOR localPos = XMVectorSet(localPoint.x, localPoint.y, localPoint.z, 1.0f);
-                        const XMVECTOR worldPos = XMVector3TransformCoord(localPos, worldMatrix);
-                        XMFLOAT3 worldPoint{};
-                        XMStoreFloat3(&worldPoint, worldPos);
-                        return project_world_to_screen(worldPoint, viewProj, viewportImageMin, viewportImageSize, out);
-                    };
-
-                    const auto draw_box = [&](const XMMATRIX& worldMatrix, const XMFLOAT3& halfExtents, ImU32 color,
-                                              float thickness) {
-                        constexpr std::array<XMFLOAT3, 8> localCorners = {
-                            XMFLOAT3{-1, -1, -1}, XMFLOAT3{1, -1, -1}, XMFLOAT3{1, 1, -1}, XMFLOAT3{-1, 1, -1},
-                            XMFLOAT3{-1, -1, 1},  XMFLOAT3{1, -1, 1},  XMFLOAT3{1, 1, 1},  XMFLOAT3{-1, 1, 1},
-                        };
-
-                        std::array<ImVec2, 8> projected{};
-                        std::array<bool, 8> valid{};
-
-                        for (std::size_t i = 0; i < localCorners.size(); ++i)
-                        {
-                            const XMFLOAT3 scaled{
-                                localCorners[i].x * halfExtents.x,
-                                localCorners[i].y * halfExtents.y,
-                                localCorners[i].z * halfExtents.z,
-                            };
-                            valid[i] = project_point(worldMatrix, scaled, projected[i]);
-                        }
-
-                        for (const auto& [a, b] : edges)
-                        {
-                            if (valid[a] && valid[b])
-                                drawList->AddLine(projected[a], projected[b], color, thickness);
-                        }
-                    };
-
-                    const auto draw_circle = [&](const XMMATRIX& worldMatrix,
-                                                 const XMFLOAT3& center,
-                                                 float radius,
-                                                 int axis,
-                                                 ImU32 color,
-                                                 float thickness) {
-                        constexpr int segments = 24;
-                        ImVec2 prev{};
-                        bool prevValid = false;
-                        for (int i = 0; i <= segments; ++i)
-                        {
-                            const float t = (static_cast<float>(i) / static_cast<float>(segments)) * DirectX::XM_2PI;
-                            const float c = std::cos(t);
-                            const float s = std::sin(t);
-
-                            XMFLOAT3 p = center;
-                            if (axis == 0)
-                            {
-                                p.y += c * radius;
-                                p.z += s * radius;
-                            }
-                            else if (axis == 1)
-                            {
-                                p.x += c * radius;
-                                p.z += s * radius;
-                            }
-                            else
-                            {
-                                p.x += c * radius;
-                                p.y += s * radius;
-                            }
-
-                            ImVec2 curr{};
-                            const bool currValid = project_point(worldMatrix, p, curr);
-                            if (prevValid && currValid)
-                                drawList->AddLine(prev, curr, color, thickness);
-                            prev = curr;
-                            prevValid = currValid;
-                        }
-                    };
-
-                    const auto draw_sphere = [&](const XMMATRIX& worldMatrix, float radius, ImU32 color, float thickness) {
-                        draw_circle(worldMatrix, XMFLOAT3{0.0f, 0.0f, 0.0f}, radius, 0, color, thickness);
-                        draw_circle(worldMatrix, XMFLOAT3{0.0f, 0.0f, 0.0f}, radius, 1, color, thickness);
-                        draw_circle(worldMatrix, XMFLOAT3{0.0f, 0.0f, 0.0f}, radius, 2, color, thickness);
-                    };
-
-                    const auto draw_capsule_or_cylinder = [&](const XMMATRIX& worldMatrix,
-                                                               float radius,
-                                                               float halfHeight,
-                                                               bool drawCaps,
-                                                               ImU32 color,
-                                                               float thickness) {
-                        const XMFLOAT3 top{0.0f, halfHeight, 0.0f};
-                        const XMFLOAT3 bottom{0.0f, -halfHeight, 0.0f};
-                        draw_circle(worldMatrix, top, radius, 1, color, thickness);
-                        draw_circle(worldMatrix, bottom, radius, 1, color, thickness);
-
-                        constexpr std::array<XMFLOAT3, 4> linePoints = {
-                            XMFLOAT3{1.0f, 0.0f, 0.0f}, XMFLOAT3{-1.0f, 0.0f, 0.0f},
-                            XMFLOAT3{0.0f, 0.0f, 1.0f}, XMFLOAT3{0.0f, 0.0f, -1.0f},
-                        };
-
-                        for (const auto& p : linePoints)
-                        {
-                            ImVec2 a{}, b{};
-                            const bool validA = project_point(worldMatrix, XMFLOAT3{p.x * radius, halfHeight, p.z * radius}, a);
-                            const bool validB = project_point(worldMatrix, XMFLOAT3{p.x * radius, -halfHeight, p.z * radius}, b);
-                            if (validA && validB)
-                                drawList->AddLine(a, b, color, thickness);
-                        }
-
-                        if (drawCaps)
-                        {
-                            draw_circle(worldMatrix, top, radius, 0, color, thickness);
-                            draw_circle(worldMatrix, top, radius, 2, color, thickness);
-                            draw_circle(worldMatrix, bottom, radius, 0, color, thickness);
-                            draw_circle(worldMatrix, bottom, radius, 2, color, thickness);
-                        }
-                    };
-
-                    const auto draw_mesh_wireframe = [&](const XMMATRIX& worldMatrix,
-                                                         const MeshData& meshData,
-                                                         ImU32 color,
-                                                         float thickness) {
-                        if (meshData.vertices.empty() || meshData.indices.size() < 3)
+                    const std::uint32_t lineColor = DebugDrawList::pack_color(120, 210, 255, 220);
+                    const std::uint32_t selectionColor = DebugDrawList::pack_color(255, 180, 60, 255);
+                    constexpr float colliderLineWidth = 1.5f;
+                    constexpr float selectionLineWidth = 2.5f;
+
+                    const auto draw_mesh_wireframe = [&](const XMMATRIX& worldMatrix, const MeshData& meshData,
+                                                         std::uint32_t color) {
+                        const std::span<const std::uint32_t> indices = meshData.base_indices();
+                        if (meshData.vertices.empty() || indices.size() < 3)
                             return;
 
-                        for (size_t i = 0; i + 2 < meshData.indices.size(); i += 3)
+                        const auto world_point = [&](std::uint32_t index) {
+                            XMFLOAT3 point{};
+                            XMStoreFloat3(&point, XMVector3TransformCoord(XMLoadFloat3(&meshData.vertices[index].pos),
+                                                                          worldMatrix));
+                            return point;
+                        };
+                        for (size_t i = 0; i + 2 < indices.size(); i += 3)
                         {
-                            const std::uint32_t i0 = meshData.indices[i];
-                            const std::uint32_t i1 = meshData.indices[i + 1];
-                            const std::uint32_t i2 = meshData.indices[i + 2];
+                            const std::uint32_t i0 = indices[i];
+                            const std::uint32_t i1 = indices[i + 1];
+                            const std::uint32_t i2 = indices[i + 2];
                             if (i0 >= meshData.vertices.size() || i1 >= meshData.vertices.size() || i2 >= meshData.vertices.size())
                                 continue;
 
-                            const auto& p0 = meshData.vertices[i0].pos;
-                            const auto& p1 = meshData.vertices[i1].pos;
-                            const auto& p2 = meshData.vertices[i2].pos;
-
-                            ImVec2 a{}, b{}, c{};
-                            const bool va = project_point(worldMatrix, p0, a);
-                            const bool vb = project_point(worldMatrix, p1, b);
-                            const bool vc = project_point(worldMatrix, p2, c);
-
-                            if (va && vb)
-                                drawList->AddLine(a, b, color, thickness);
-                            if (vb && vc)
-                                drawList->AddLine(b, c, color, thickness);
-                            if (vc && va)
-                                drawList->AddLine(c, a, color, thickness);
+                            const XMFLOAT3 p0 = world_point(i0);
+                            const XMFLOAT3 p1 = world_point(i1);
+                            const XMFLOAT3 p2 = world_point(i2);
+                            debugDrawList.add_line(p0, p1, color);
+                            debugDrawList.add_line(p1, p2, color);
+                            debugDrawList.add_line(p2, p0, color);
                         }
                     };
 
@@ -3347,23 +3810,18 @@ int main(int argc, char** argv)
                             switch (body.shapeType)
                             {
                             case PhysicsColliderShapeType::Sphere:
-                                draw_sphere(colliderWorld, std::max(body.radius, 0.01f), lineColor, 1.5f);
+                                debugDrawList.add_sphere(colliderWorld, std::max(body.radius, 0.01f), lineColor, true,
+                                                         colliderLineWidth);
                                 break;
                             case PhysicsColliderShapeType::Capsule:
-                                draw_capsule_or_cylinder(colliderWorld,
-                                                         std::max(body.radius, 0.01f),
-                                                         std::max(body.halfHeight, 0.01f),
-                                                         true,
-                                                         lineColor,
-                                                         1.5f);
+                                debugDrawList.add_capsule(colliderWorld, std::max(body.radius, 0.01f),
+                                                          std::max(body.halfHeight, 0.01f), lineColor, true,
+                                                          colliderLineWidth);
                                 break;
                             case PhysicsColliderShapeType::Cylinder:
-                                draw_capsule_or_cylinder(colliderWorld,
-                                                         std::max(body.radius, 0.01f),
-                                                         std::max(body.halfHeight, 0.01f),
-                                                         false,
-                                                         lineColor,
-                                                         1.5f);
+                                debugDrawList.add_cylinder(colliderWorld, std::max(body.radius, 0.01f),
+                                                           std::max(body.halfHeight, 0.01f), lineColor, true,
+                                                           colliderLineWidth);
                                 break;
                             case PhysicsColliderShapeType::ConvexHull:
                             case PhysicsColliderShapeType::StaticCompound:
@@ -3387,7 +3845,7 @@ int main(int argc, char** argv)
 
                                         if (const auto* mc = world.registry().try_get<MeshComponent>(current))
                                         {
-                                            if (!mc->assetPath.empty())
+                                            if (mc->asset.is_valid())
                                             {
                                                 meshComp = mc;
                                                 nameComp = world.registry().try_get<NameComponent>(current);
@@ -3405,9 +3863,10 @@ int main(int argc, char** argv)
                                         }
                                     }
 
-                                    if (meshComp && !meshComp->assetPath.empty())
+                                    if (meshComp && meshComp->asset.is_valid())
                                     {
-                                        const std::filesystem::path loadPath = resolve_texture_load_path(meshComp->assetPath, project.get());
+                                        const std::filesystem::path loadPath = resolve_texture_load_path(
+                                            AssetRegistry::get().path_of(meshComp->asset), project.get());
                                         auto modelHandle = assetManager.load_model(loadPath.string());
                                         if (modelHandle)
                                         {
@@ -3428,7 +3887,7 @@ int main(int argc, char** argv)
 
                                             if (meshData)
                                             {
-                                                draw_mesh_wireframe(colliderWorld, *meshData, lineColor, 1.0f);
+                                                draw_mesh_wireframe(colliderWorld, *meshData, lineColor);
                                                 drewMesh = true;
                                             }
                                         }
@@ -3436,12 +3895,12 @@ int main(int argc, char** argv)
                                 }
 
                                 if (!drewMesh)
-                                    draw_box(colliderWorld, body.halfExtents, lineColor, 1.5f);
+                                    debugDrawList.add_box(colliderWorld, body.halfExtents, lineColor, true, colliderLineWidth);
                                 break;
                             }
                             case PhysicsColliderShapeType::Box:
                             default:
-                                draw_box(colliderWorld, body.halfExtents, lineColor, 1.5f);
+                                debugDrawList.add_box(colliderWorld, body.halfExtents, lineColor, true, colliderLineWidth);
                                 break;
                             }
                         }
@@ -3490,13 +3949,21 @@ int main(int argc, char** argv)
                             const XMMATRIX worldMat = XMLoadFloat4x4(&cache->worldMatrix);
                             const XMMATRIX selectionBoxWorld =
                                 XMMatrixMultiply(XMMatrixTranslation(center.x, center.y, center.z), worldMat);
-                            draw_box(selectionBoxWorld, extents, selectionColor, 2.5f);
+                            debugDrawList.add_box(selectionBoxWorld, extents, selectionColor, false, selectionLineWidth);
                         }
                     }
 
+                    // Only meshes whose world box reaches the viewport can draw an outline.
+                    XMFLOAT4X4 outlineViewProj{};
+                    XMStoreFloat4x4(&outlineViewProj, viewProj);
+                    std::vector<entt::entity> outlineCandidates{};
+                    world.spatial_index().query_frustum(FrustumPlanes::from_view_projection(outlineViewProj),
+                                                        outlineCandidates);
                     auto outlineView = world.registry().view<MeshComponent, WorldMatrixCache>();
-                    for (entt::entity e : outlineView)
+                    for (entt::entity e : outlineCandidates)
                     {
+                        if (!outlineView.contains(e))
+                            continue;
                         const auto& meshComp = outlineView.get<MeshComponent>(e);
                         if (!meshComp.outlineEnabled || meshComp.meshIndex < 0)
                             continue;
@@ -3525,12 +3992,13 @@ int main(int argc, char** argv)
                             XMMatrixMultiply(XMMatrixTranslation(center.x, center.y, center.z), worldMat);
 
                         const std::uint8_t alpha = meshComp.outlineThroughWalls ? 255 : 210;
-                        const ImU32 outlineColor = IM_COL32(
-                            static_cast<int>(std::clamp(meshComp.outlineColor.x, 0.0f, 1.0f) * 255.0f),
-                            static_cast<int>(std::clamp(meshComp.outlineColor.y, 0.0f, 1.0f) * 255.0f),
-                            static_cast<int>(std::clamp(meshComp.outlineColor.z, 0.0f, 1.0f) * 255.0f),
+                        const std::uint32_t outlineColor = DebugDrawList::pack_color(
+                            static_cast<std::uint8_t>(std::clamp(meshComp.outlineColor.x, 0.0f, 1.0f) * 255.0f),
+                            static_cast<std::uint8_t>(std::clamp(meshComp.outlineColor.y, 0.0f, 1.0f) * 255.0f),
+                            static_cast<std::uint8_t>(std::clamp(meshComp.outlineColor.z, 0.0f, 1.0f) * 255.0f),
                             alpha);
-                        draw_box(outlineWorld, extents, outlineColor, std::max(0.5f, meshComp.outlineThickness));
+                        debugDrawList.add_box(outlineWorld, extents, outlineColor, !meshComp.outlineThroughWalls,
+                                              std::max(0.5f, meshComp.outlineThickness));
                     }
                 }
 
@@ -3548,6 +4016,8 @@ int main(int argc, char** argv)
             std::chrono::steady_clock::time_point renderSubmitStart{};
             if (collectDetailedMetrics)
                 renderSubmitStart = std::chrono::steady_clock::now();
+            renderer.set_debug_draw(debugDrawList);
+            debugDrawList.clear();
             auto drawResult = renderer.draw_frame();
             if (collectDetailedMetrics)
             {
@@ -3569,7 +4039,11 @@ int main(int argc, char** argv)
 
     renderer.wait_idle();
     if (level)
+    {
+        if (auto saveResult = level->wait_for_save(); !saveResult)
+            fmt::print(stderr, "Level save failed: {}\n", saveResult.error().message);
         scriptEngine.on_world_destroyed(level->world());
+    }
     scriptEngine.shutdown();
     physicsWorld.shutdown();
     release_viewport_texture();
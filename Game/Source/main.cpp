@@ -1,27 +1,46 @@
 #define NOMINMAX
 #include <Assets/Public/AssetManager.hpp>
 #include <Camera/Public/Camera.hpp>
+#include <Core/Public/AllocationCounter.hpp>
+#include <Core/Public/FrameArena.hpp>
+#include <Core/Public/JobSystem.hpp>
+#include <Core/Public/PackArchive.hpp>
+#include <Core/Public/Profiler.hpp>
 #include <Core/Public/RuntimePaths.hpp>
+#include <Core/Public/VirtualFileSystem.hpp>
+#include <ECS/Public/Components.hpp>
 #include <Level/Public/Level.hpp>
 #include <Level/Public/Project.hpp>
 #include <Physics/Public/PhysicsWorld.hpp>
 #include <Rendering/BackEnds/Public/Vulkan.hpp>
+#include <Runtime/Public/Benchmark.hpp>
+#include <Runtime/Public/FramePacer.hpp>
+#include <Runtime/Public/FrameScheduler.hpp>
 #include <Runtime/Public/ProjectPipeline.hpp>
+#include <Runtime/Public/StartupGraph.hpp>
 #include <Scripting/Public/ScriptEngine.hpp>
 #include <Window/Public/Window.hpp>
 
 #include <fmt/core.h>
 
+#include <charconv>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <string_view>
 #include <utility>
 
+NOC_DEFINE_ALLOCATION_COUNTING_HOOKS()
+
 namespace
 {
 constexpr std::uint32_t kWindowWidth = 1280;
 constexpr std::uint32_t kWindowHeight = 720;
+/// Uploaded texture pixels beyond this stay on the GPU only (re-streamed from disk if needed).
+constexpr std::size_t kCpuAssetBudgetBytes = 256ull * 1024ull * 1024ull;
 
 struct LaunchOptions
 {
@@ -29,13 +48,50 @@ struct LaunchOptions
     std::filesystem::path levelFile;
     std::filesystem::path contentRoot;
     std::filesystem::path userDataRoot;
+    float physicsRate{0.0f}; // fixed steps per second, 0 keeps the PhysicsWorld default
+    std::uint32_t workerCount{0}; // job system workers, 0 = one per hardware thread
+    float fpsCap{0.0f};           // frame rate limit, 0 = uncapped
+    std::filesystem::path traceFile; // Chrome trace of the whole run, empty = no capture
+    std::filesystem::path benchmarkScenario; // BenchmarkScenario file, empty = interactive
+    std::filesystem::path benchmarkOutput;   // per-frame CSV; the JSON summary goes next to it
+    bool offscreen{false};                   // benchmark without a visible window or presentation
     bool validateStartup{false};
 };
 
+/// Captures profiler zones from construction to destruction, so every exit path of main writes the trace.
+class TraceCapture
+{
+  public:
+    explicit TraceCapture(std::filesystem::path path) : m_path(std::move(path))
+    {
+        if (m_path.empty())
+            return;
+        Profiler::set_thread_name("Main");
+        Profiler::start_capture();
+    }
+    ~TraceCapture()
+    {
+        if (m_path.empty())
+            return;
+        if (auto result = Profiler::stop_capture(m_path); !result)
+            fmt::print("Failed to write trace: {}\n", result.error().message);
+        else
+            fmt::print("Wrote trace to {}\n", m_path.string());
+    }
+
+    TraceCapture(const TraceCapture&) = delete;
+    TraceCapture& operator=(const TraceCapture&) = delete;
+
+  private:
+    std::filesystem::path m_path;
+};
+
 void print_usage()
 {
     fmt::print("Usage: Game [--project <path>] [--level <path>] [--content-root <path>] [--user-data-root <path>] "
-               "[--validate-startup]\n");
+               "[--physics-hz <rate>] [--workers <count>] [--fps-cap <rate>] [--trace <file>]\n"
+               "       [--validate-startup]\n"
+               "       [--benchmark <scenario> [--benchmark-output <file.csv>] [--offscreen]]\n");
 }
 
 Result<LaunchOptions> parse_launch_options(int argc, char** argv)
@@ -71,6 +127,52 @@ Result<LaunchOptions> parse_launch_options(int argc, char** argv)
             if (auto result = require_value(options.userDataRoot); !result)
                 return make_error(result.error());
         }
+        else if (arg == "--physics-hz")
+        {
+            if (i + 1 >= argc)
+                return make_error(fmt::format("Missing value for '{}'", arg), ErrorCode::AssetFileNotFound);
+            const std::string_view value = argv[++i];
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.physicsRate);
+            if (ec != std::errc{} || end != value.data() + value.size() || options.physicsRate <= 0.0f)
+                return make_error(fmt::format("Invalid physics rate '{}'", value), ErrorCode::AssetInvalidData);
+        }
+        else if (arg == "--workers")
+        {
+            if (i + 1 >= argc)
+                return make_error(fmt::format("Missing value for '{}'", arg), ErrorCode::AssetFileNotFound);
+            const std::string_view value = argv[++i];
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.workerCount);
+            if (ec != std::errc{} || end != value.data() + value.size())
+                return make_error(fmt::format("Invalid worker count '{}'", value), ErrorCode::AssetInvalidData);
+        }
+        else if (arg == "--fps-cap")
+        {
+            if (i + 1 >= argc)
+                return make_error(fmt::format("Missing value for '{}'", arg), ErrorCode::AssetFileNotFound);
+            const std::string_view value = argv[++i];
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.fpsCap);
+            if (ec != std::errc{} || end != value.data() + value.size() || options.fpsCap < 0.0f)
+                return make_error(fmt::format("Invalid frame rate cap '{}'", value), ErrorCode::AssetInvalidData);
+        }
+        else if (arg == "--trace")
+        {
+            if (auto result = require_value(options.traceFile); !result)
+                return make_error(result.error());
+        }
+        else if (arg == "--benchmark")
+        {
+            if (auto result = require_value(options.benchmarkScenario); !result)
+                return make_error(result.error());
+        }
+        else if (arg == "--benchmark-output")
+        {
+            if (auto result = require_value(options.benchmarkOutput); !result)
+                return make_error(result.error());
+        }
+        else if (arg == "--offscreen")
+        {
+            options.offscreen = true;
+        }
         else if (arg == "--validate-startup")
         {
             options.validateStartup = true;
@@ -86,6 +188,9 @@ Result<LaunchOptions> parse_launch_options(int argc, char** argv)
         }
     }
 
+    if (options.offscreen && options.benchmarkScenario.empty())
+        return make_error("'--offscreen' requires '--benchmark'", ErrorCode::AssetInvalidData);
+
     return options;
 }
 
@@ -133,6 +238,8 @@ int main(int argc, char** argv)
         return optionsResult.error().message == "help" ? 0 : -1;
     }
     LaunchOptions options = std::move(optionsResult.value());
+    JobSystem::configure(options.workerCount);
+    const TraceCapture traceCapture{options.traceFile};
 
     if (auto runtimePathsResult =
             RuntimePaths::initialize_current_process("NatureOfCraft", argc > 0 ? std::filesystem::path(argv[0]) : std::filesystem::path{},
@@ -144,6 +251,18 @@ int main(int argc, char** argv)
     }
 
     const RuntimePaths& runtimePaths = RuntimePaths::current();
+
+    // Packed bundles ship their content as one archive over the content root; loose content needs no mount.
+    const std::filesystem::path contentArchive = runtimePaths.content_root() / PackArchive::ContentArchiveName;
+    if (std::error_code ec; std::filesystem::exists(contentArchive, ec))
+    {
+        if (auto mountResult = VirtualFileSystem::get().mount(contentArchive, runtimePaths.content_root()); !mountResult)
+        {
+            fmt::print("Failed to mount '{}': {}\n", contentArchive.string(), mountResult.error().message);
+            return -1;
+        }
+    }
+
     auto projectFileResult = discover_project_file(options, runtimePaths);
     if (!projectFileResult)
     {
@@ -151,113 +270,195 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    std::optional<BenchmarkScenario> benchmark;
+    if (!options.benchmarkScenario.empty())
+    {
+        auto scenarioResult = BenchmarkScenario::load(options.benchmarkScenario);
+        if (!scenarioResult)
+        {
+            fmt::print("{}\n", scenarioResult.error().message);
+            return -1;
+        }
+        benchmark = std::move(scenarioResult.value());
+    }
+
     Window window{kWindowWidth, kWindowHeight, "NatureOfCraft"};
+    window.set_visible(!options.offscreen);
     if (auto code = get_error_code(window.init()); code != 0)
         return code;
 
     Vulkan renderer{window.get_glfw_window()};
     renderer.set_shader_load_mode(ShaderLoadMode::PrecompiledOnly);
     window.set_framebuffer_size_callback([&renderer](std::int32_t, std::int32_t) { renderer.on_framebuffer_resized(); });
-    if (auto code = get_error_code(renderer.initialize()); code != 0)
-        return code;
 
     AssetManager assetManager;
+    assetManager.set_cpu_memory_budget(kCpuAssetBudgetBytes);
+    renderer.set_task_executor(&assetManager.get_executor());
     ScriptEngine scriptEngine;
     PhysicsWorld physicsWorld;
-    if (auto initResult = scriptEngine.initialize(); !initResult)
-    {
-        fmt::print("Failed to initialize ScriptEngine: {}\n", initResult.error().message);
-        return -1;
-    }
-    if (auto initResult = physicsWorld.initialize(); !initResult)
-    {
-        fmt::print("Failed to initialize PhysicsWorld: {}\n", initResult.error().message);
-        return -1;
-    }
-
-    auto startupBegin = std::chrono::steady_clock::now();
-    auto projectResult = Project::load(projectFileResult.value().string());
-    if (!projectResult)
-    {
-        fmt::print("Failed to load project '{}': {}\n", projectFileResult.value().string(), projectResult.error().message);
-        return -1;
-    }
-    Project project = std::move(projectResult.value());
-
-    std::filesystem::path levelPath;
-    if (!options.levelFile.empty())
-        levelPath = resolve_cli_path(options.levelFile, project.root_path());
-    else if (!project.levels().empty())
-        levelPath = project.get_absolute_path(project.levels().front().filePath);
-    else
-    {
-        fmt::print("Project '{}' does not contain any levels.\n", project.name());
-        return -1;
-    }
-
-    auto levelLoadBegin = std::chrono::steady_clock::now();
-    auto levelResult = Level::load(levelPath.string());
-    if (!levelResult)
-    {
-        fmt::print("Failed to load level '{}': {}\n", levelPath.string(), levelResult.error().message);
-        return -1;
-    }
-    Level level = std::move(levelResult.value());
 
     RuntimeLoadOptions loadOptions;
     loadOptions.seedProjectDefaults = false;
     loadOptions.allowEmbeddedMaterialTextureExtraction = false;
     loadOptions.requireCookedModels = true;
     loadOptions.requireGlowShaders = false;
-    auto prepareResult = prepare_loaded_level(assetManager, renderer, scriptEngine, physicsWorld, level, &project, loadOptions);
-    if (!prepareResult)
-    {
-        fmt::print("Failed to prepare level runtime: {}\n", prepareResult.error().message);
-        return -1;
-    }
-    for (const auto& warning : prepareResult->warnings)
-        fmt::print("Warning: {}\n", warning);
+    loadOptions.releaseCpuGeometryAfterUpload = true; // physics loads its own copies
 
-    OrbitCameraController cameraController;
-    entt::entity activeCamera = level.world().get_active_camera();
-    if (activeCamera == entt::null)
-    {
-        fmt::print("The loaded level does not have an active camera.\n");
-        return -1;
-    }
-    cameraController.attach(level.world().registry(), activeCamera);
-    physicsWorld.set_enabled(true);
+    std::optional<Project> project; // before the streamer, whose reads use it until it is destroyed
+    std::filesystem::path levelPath;
+    // The level streams in while the frame loop keeps presenting frames (the loading screen). Its file
+    // parsing and texture decoding start during startup, as background jobs.
+    LevelStreamer levelStreamer{assetManager, renderer, scriptEngine, physicsWorld};
+    std::chrono::steady_clock::time_point levelLoadBegin{};
 
-    auto update_frame = [&](float deltaTime) -> Result<> {
-        if (entt::entity currentActiveCamera = level.world().get_active_camera();
-            currentActiveCamera != entt::null && currentActiveCamera != activeCamera)
+    // Vulkan stays on this thread (GLFW surface and framebuffer queries); the rest overlaps it on workers.
+    auto startupBegin = std::chrono::steady_clock::now();
+    StartupGraph startup;
+    startup.add("lua", [&]() -> Result<> {
+        if (auto initResult = scriptEngine.initialize(); !initResult)
+            return make_error(fmt::format("Failed to initialize ScriptEngine: {}", initResult.error().message),
+                              initResult.error().code);
+        return {};
+    });
+    startup.add("jolt", [&]() -> Result<> {
+        if (auto initResult = physicsWorld.initialize(); !initResult)
+            return make_error(fmt::format("Failed to initialize PhysicsWorld: {}", initResult.error().message),
+                              initResult.error().code);
+        if (options.physicsRate > 0.0f)
+            physicsWorld.set_fixed_step(1.0f / options.physicsRate);
+        return {};
+    });
+    tf::Task projectStep = startup.add("project", [&]() -> Result<> {
+        auto projectResult = Project::load(projectFileResult.value().string());
+        if (!projectResult)
+            return make_error(fmt::format("Failed to load project '{}': {}", projectFileResult.value().string(),
+                                          projectResult.error().message),
+                              projectResult.error().code);
+        project.emplace(std::move(projectResult.value()));
+
+        if (benchmark && !benchmark->levelFile.empty())
+            levelPath = resolve_cli_path(benchmark->levelFile, project->root_path());
+        else if (!options.levelFile.empty())
+            levelPath = resolve_cli_path(options.levelFile, project->root_path());
+        else if (!project->levels().empty())
+            levelPath = project->get_absolute_path(project->levels().front().filePath);
+        else
+            return make_error(fmt::format("Project '{}' does not contain any levels.", project->name()),
+                              ErrorCode::AssetInvalidData);
+        return {};
+    });
+    tf::Task levelStep = startup.add("level_read", [&]() -> Result<> {
+        levelLoadBegin = std::chrono::steady_clock::now();
+        if (auto beginResult = levelStreamer.begin(levelPath, &*project, loadOptions); !beginResult)
+            return make_error(fmt::format("Failed to start loading level '{}': {}", levelPath.string(),
+                                          beginResult.error().message),
+                              beginResult.error().code);
+        return {};
+    });
+    projectStep.precede(levelStep);
+
+    auto startupResult = startup.run("vulkan", [&]() -> Result<> {
+        if (auto initResult = renderer.initialize(); !initResult)
+            return initResult;
+        if (benchmark)
         {
-            activeCamera = currentActiveCamera;
-            cameraController.attach(level.world().registry(), activeCamera);
+            // Frame times must not be paced by the display.
+            renderer.set_vsync(KHR_Settings::Immediate);
+            renderer.set_presentation_enabled(!options.offscreen);
         }
+        return {};
+    });
+    if (auto code = get_error_code(startupResult); code != 0)
+        return code;
+    scriptEngine.set_physics_world(&physicsWorld);
+    if (options.validateStartup)
+        startup.print_timings("validation.startup");
+
+    // The GPU wait happens before events are polled; benchmarks keep it but never sleep.
+    FramePacer framePacer{renderer};
+    framePacer.set_fps_cap(benchmark ? 0.0f : options.fpsCap);
+
+    std::unique_ptr<Level> level;
+    OrbitCameraController cameraController;
+    // Simulation of frame N+1 runs on the job system while this thread renders frame N.
+    std::optional<FrameScheduler> frameScheduler;
+    std::uint32_t lastReportedPercent = 0;
 
-        const std::uint32_t renderWidth = renderer.get_render_width();
-        const std::uint32_t renderHeight = renderer.get_render_height();
-        const float aspectRatio = renderHeight > 0 ? static_cast<float>(renderWidth) / static_cast<float>(renderHeight) : 1.0f;
-        renderer.set_view_projection(cameraController.get_view_matrix(), cameraController.get_projection_matrix(aspectRatio));
+    // Advances the streamer by one frame. Returns true once a newly loaded level is live.
+    auto pump_level_stream = [&]() -> Result<bool> {
+        auto stateResult = levelStreamer.pump();
+        if (!stateResult)
+            return make_error(stateResult.error());
 
-        World& world = level.world();
-        scriptEngine.update(world, deltaTime);
-        physicsWorld.step(world, deltaTime);
-        world.update_world_matrices();
-        if (world.has_renderables_updates_pending())
-            renderer.set_renderables(world.collect_renderables());
+        if (stateResult.value() == LevelStreamState::Staged)
+        {
+            if (frameScheduler)
+                frameScheduler->wait();
+            if (auto swapResult = levelStreamer.swap_in(level.get()); !swapResult)
+                return make_error(swapResult.error());
+            level.reset();
+        }
+
+        if (levelStreamer.get_state() != LevelStreamState::Ready)
+        {
+            const auto percent = static_cast<std::uint32_t>(levelStreamer.get_progress().fraction() * 100.0f);
+            if (percent >= lastReportedPercent + 10)
+            {
+                lastReportedPercent = percent;
+                fmt::print("Loading level: {}%\n", percent);
+            }
+            return false;
+        }
 
-        return renderer.draw_frame();
+        for (const auto& warning : levelStreamer.get_report().warnings)
+            fmt::print("Warning: {}\n", warning);
+        level = levelStreamer.take_level();
+        lastReportedPercent = 0;
+
+        entt::entity activeCamera = level->world().get_active_camera();
+        if (activeCamera == entt::null)
+            return make_error("The loaded level does not have an active camera.", ErrorCode::AssetInvalidData);
+        cameraController.attach(level->world().registry(), activeCamera);
+        physicsWorld.set_enabled(true);
+        level->world().set_mesh_bounds_provider(
+            [&renderer](std::uint32_t meshIndex) { return renderer.get_mesh_bounds(meshIndex); });
+
+        if (frameScheduler)
+            frameScheduler->set_world(level->world());
+        else
+            frameScheduler.emplace(assetManager.get_executor(), level->world(), scriptEngine, physicsWorld,
+                                   cameraController, renderer);
+        return true;
     };
 
-    const double levelLoadMs =
-        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - levelLoadBegin).count();
-    const double coldStartMs =
-        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count();
+    // Loading frames present whatever is on screen (nothing during the first load).
+    auto update_frame = [&](float deltaTime) -> Result<> {
+        if (levelStreamer.is_busy())
+        {
+            auto pumpResult = pump_level_stream();
+            if (!pumpResult)
+                return make_error(pumpResult.error());
+        }
+        if (!level)
+            return renderer.draw_frame();
+        return frameScheduler->run_frame(deltaTime);
+    };
 
     if (options.validateStartup)
     {
+        while (!level)
+        {
+            if (auto drawResult = update_frame(1.0f / 60.0f); !drawResult)
+            {
+                fmt::print("Level load failed: {}\n", drawResult.error().message);
+                return -1;
+            }
+        }
+        const double levelLoadMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - levelLoadBegin).count();
+        const double coldStartMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count();
+
         auto firstFrameBegin = std::chrono::steady_clock::now();
         auto drawResult = update_frame(1.0f / 60.0f);
         if (!drawResult)
@@ -266,26 +467,129 @@ int main(int argc, char** argv)
             return -1;
         }
 
+        frameScheduler->wait();
         renderer.wait_idle();
         const double firstFrameMs =
             std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - firstFrameBegin).count();
+        const RuntimeLoadReport& loadReport = levelStreamer.get_report();
         fmt::print("validation.cold_start_ms={:.2f}\n", coldStartMs);
         fmt::print("validation.level_load_ms={:.2f}\n", levelLoadMs);
         fmt::print("validation.first_frame_ms={:.2f}\n", firstFrameMs);
-        fmt::print("validation.mesh_uploads={}\n", prepareResult->totalMeshes);
-        fmt::print("validation.material_uploads={}\n", prepareResult->totalMaterials);
-        fmt::print("validation.used_raw_source_assets={}\n", prepareResult->usedRawSourceAssets ? "true" : "false");
+        fmt::print("validation.mesh_uploads={}\n", loadReport.totalMeshes);
+        fmt::print("validation.material_uploads={}\n", loadReport.totalMaterials);
+        fmt::print("validation.used_raw_source_assets={}\n", loadReport.usedRawSourceAssets ? "true" : "false");
+        return 0;
+    }
+
+    if (benchmark)
+    {
+        const BenchmarkScenario& scenario = *benchmark;
+        while (!level)
+        {
+            if (auto drawResult = update_frame(scenario.timestep); !drawResult)
+            {
+                fmt::print("Level load failed: {}\n", drawResult.error().message);
+                return -1;
+            }
+        }
+
+        BenchmarkRecorder recorder;
+        recorder.reserve(scenario.frameCount);
+        const std::uint32_t totalFrames = scenario.warmupFrames + scenario.frameCount;
+        for (std::uint32_t frame = 0; frame < totalFrames; ++frame)
+        {
+            const bool recording = frame >= scenario.warmupFrames;
+            const std::uint32_t recordedFrame = recording ? frame - scenario.warmupFrames : 0;
+            const auto frameBegin = std::chrono::steady_clock::now();
+            framePacer.begin_frame();
+
+            // The in-flight simulation reads the camera, so it must finish before the path moves it.
+            // run_frame() would wait for it first thing anyway.
+            frameScheduler->wait();
+            if (entt::entity activeCamera = level->world().get_active_camera(); activeCamera != entt::null)
+            {
+                scenario.sample_camera(static_cast<float>(recordedFrame) * scenario.timestep,
+                                       level->world().registry().get<CameraComponent>(activeCamera));
+            }
+
+            NOC_PROFILE_FRAME_MARK();
+            FrameArena::begin_frame();
+            if (auto drawResult = update_frame(scenario.timestep); !drawResult)
+            {
+                fmt::print("Benchmark frame {} failed: {}\n", frame, drawResult.error().message);
+                return -1;
+            }
+            glfwPollEvents();
+            AllocationCounter::end_frame();
+
+            if (!recording)
+                continue;
+
+            BenchmarkFrameSample sample{};
+            sample.frame = recordedFrame;
+            sample.cpuFrameMs =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameBegin).count();
+            sample.gpuFrameMs = renderer.is_gpu_timing_supported() ? renderer.get_gpu_frame_timing().lastMs : 0.0f;
+            sample.drawCalls = renderer.get_last_draw_call_count();
+            sample.instancedBatches = renderer.get_last_instanced_batch_count();
+            sample.visibleRenderables = renderer.get_last_visible_renderable_count();
+            sample.culledRenderables = renderer.get_last_culled_renderable_count();
+            sample.occludedRenderables = renderer.get_last_occluded_renderable_count();
+            sample.trackedMemoryBytes = renderer.get_total_tracked_memory_bytes();
+            sample.deviceLocalUsageBytes = renderer.get_device_local_memory_budget().usageBytes;
+            sample.heapAllocations = AllocationCounter::get_last_frame().count;
+            sample.inputToPresentMs = framePacer.get_stats().latency.inputToPresentMs;
+            recorder.add(sample);
+        }
+
+        frameScheduler->wait();
+        renderer.wait_idle();
+
+        std::filesystem::path csvPath = options.benchmarkOutput;
+        if (csvPath.empty())
+            csvPath = fmt::format("{}_benchmark.csv", scenario.name);
+        std::filesystem::path summaryPath = csvPath;
+        summaryPath.replace_extension(".json");
+        if (auto writeResult = recorder.write_csv(csvPath); !writeResult)
+        {
+            fmt::print("{}\n", writeResult.error().message);
+            return -1;
+        }
+        if (auto writeResult = recorder.write_summary_json(summaryPath, scenario, renderer.get_gpu_name()); !writeResult)
+        {
+            fmt::print("{}\n", writeResult.error().message);
+            return -1;
+        }
+
+        const BenchmarkPercentiles cpu = recorder.get_cpu_frame_percentiles();
+        const BenchmarkPercentiles gpu = recorder.get_gpu_frame_percentiles();
+        fmt::print("benchmark.frames={}\n", recorder.get_samples().size());
+        fmt::print("benchmark.cpu_ms p50={:.3f} p95={:.3f} p99={:.3f} max={:.3f}\n", cpu.p50, cpu.p95, cpu.p99,
+                   cpu.maximum);
+        fmt::print("benchmark.gpu_ms p50={:.3f} p95={:.3f} p99={:.3f} max={:.3f}\n", gpu.p50, gpu.p95, gpu.p99,
+                   gpu.maximum);
+        const BenchmarkPercentiles latency = recorder.get_input_to_present_percentiles();
+        fmt::print("benchmark.input_to_present_ms p50={:.3f} p95={:.3f} p99={:.3f} max={:.3f}\n", latency.p50,
+                   latency.p95, latency.p99, latency.maximum);
+        fmt::print("benchmark.output={} {}\n", csvPath.string(), summaryPath.string());
         return 0;
     }
 
+    window.set_frame_begin_callback([&framePacer]() { framePacer.begin_frame(); });
     auto lastFrameTime = std::chrono::steady_clock::now();
     auto loopResult = window.loop([&]() -> Result<> {
         const auto now = std::chrono::steady_clock::now();
         const float deltaTime = std::chrono::duration<float>(now - lastFrameTime).count();
         lastFrameTime = now;
+        NOC_PROFILE_FRAME_MARK();
+        NOC_PROFILE_ZONE("Frame");
+        AllocationCounter::end_frame();
+        FrameArena::begin_frame();
         return update_frame(deltaTime);
     });
 
+    if (frameScheduler)
+        frameScheduler->wait();
     renderer.wait_idle();
     if (!loopResult)
     {
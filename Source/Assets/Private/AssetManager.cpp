@@ -3,40 +3,46 @@
 #include "ModelLoader.hpp"
 #include "TextureLoader.hpp"
 
-#include <entt/core/hashed_string.hpp>
+#include <vector>
 
 AssetManager::AssetManager()
     : m_meshCache(MeshLoader{}), m_textureCache(TextureLoader{}), m_modelCache(ModelLoader{})
 {}
 
-AssetManager::~AssetManager()
+AssetManager::~AssetManager() = default;
+
+entt::id_type AssetManager::cache_key(AssetId id)
 {
-    if (m_executor)
-        m_executor->wait_for_all();
+    // Dense keys cannot collide the way a 64-to-32-bit fold of the id could.
+    const auto [it, inserted] = m_cacheKeys.try_emplace(id, static_cast<entt::id_type>(m_cacheKeys.size()));
+    return it->second;
 }
 
-entt::id_type AssetManager::path_to_id(const std::filesystem::path& path)
+entt::id_type AssetManager::find_cache_key(AssetId id) const
 {
-    return entt::hashed_string{path.string().data(), path.string().size()};
+    const auto it = m_cacheKeys.find(id);
+    return it != m_cacheKeys.end() ? it->second : UnknownCacheKey;
 }
 
 // --- Mesh ---
 
 entt::resource<MeshData> AssetManager::load_mesh(const std::filesystem::path& path)
 {
-    auto id = path_to_id(path);
+    auto id = cache_key(AssetId::from_path(path));
     auto [it, inserted] = m_meshCache.load(id, path);
+    if (it->second)
+        touch(ResidencyKind::Mesh, id, path, true);
     return it->second;
 }
 
 bool AssetManager::contains_mesh(const std::filesystem::path& path) const
 {
-    return m_meshCache.contains(path_to_id(path));
+    return m_meshCache.contains(find_cache_key(AssetId::from_path(path)));
 }
 
 entt::resource<const MeshData> AssetManager::get_mesh(const std::filesystem::path& path) const
 {
-    return m_meshCache[path_to_id(path)];
+    return m_meshCache[find_cache_key(AssetId::from_path(path))];
 }
 
 size_t AssetManager::mesh_count() const noexcept
@@ -46,6 +52,9 @@ size_t AssetManager::mesh_count() const noexcept
 
 void AssetManager::clear_meshes() noexcept
 {
+    for (const auto& [id, entry] : m_residency[static_cast<std::size_t>(ResidencyKind::Mesh)])
+        m_cpuBytes -= entry.bytes;
+    m_residency[static_cast<std::size_t>(ResidencyKind::Mesh)].clear();
     m_meshCache.clear();
 }
 
@@ -53,14 +62,14 @@ void AssetManager::clear_meshes() noexcept
 
 entt::resource<MaterialData> AssetManager::load_material(std::string_view name, const MaterialData& data)
 {
-    auto id = path_to_id(name);
+    auto id = cache_key(AssetId::from_path(name));
     auto [it, inserted] = m_materialCache.load(id, data);
     return it->second;
 }
 
 bool AssetManager::contains_material(std::string_view name) const
 {
-    return m_materialCache.contains(path_to_id(name));
+    return m_materialCache.contains(find_cache_key(AssetId::from_path(name)));
 }
 
 size_t AssetManager::material_count() const noexcept
@@ -77,21 +86,41 @@ void AssetManager::clear_materials() noexcept
 
 entt::resource<TextureData> AssetManager::load_texture(const std::filesystem::path& path)
 {
-    auto id = path_to_id(path);
+    auto id = cache_key(AssetId::from_path(path));
     auto [it, inserted] = m_textureCache.load(id, path);
+    if (it->second)
+        touch(ResidencyKind::Texture, id, path, true);
     return it->second;
 }
 
 entt::resource<TextureData> AssetManager::load_texture(std::string_view name, const TextureData& data)
 {
-    auto id = path_to_id(name);
+    auto id = cache_key(AssetId::from_path(name));
     auto [it, inserted] = m_textureCache.load(id, data);
+    if (it->second)
+    {
+        // Textures decoded elsewhere are usually keyed by their file, which makes them re-streamable.
+        const std::filesystem::path path{name};
+        touch(ResidencyKind::Texture, id, path, TextureLoader::exists(path));
+    }
+    return it->second;
+}
+
+entt::resource<TextureData> AssetManager::load_texture(std::string_view name, std::shared_ptr<TextureData> data)
+{
+    auto id = cache_key(AssetId::from_path(name));
+    auto [it, inserted] = m_textureCache.load(id, std::move(data));
+    if (it->second)
+    {
+        const std::filesystem::path path{name};
+        touch(ResidencyKind::Texture, id, path, TextureLoader::exists(path));
+    }
     return it->second;
 }
 
 bool AssetManager::contains_texture(std::string_view name) const
 {
-    return m_textureCache.contains(path_to_id(name));
+    return m_textureCache.contains(find_cache_key(AssetId::from_path(name)));
 }
 
 size_t AssetManager::texture_count() const noexcept
@@ -101,6 +130,9 @@ size_t AssetManager::texture_count() const noexcept
 
 void AssetManager::clear_textures() noexcept
 {
+    for (const auto& [id, entry] : m_residency[static_cast<std::size_t>(ResidencyKind::Texture)])
+        m_cpuBytes -= entry.bytes;
+    m_residency[static_cast<std::size_t>(ResidencyKind::Texture)].clear();
     m_textureCache.clear();
 }
 
@@ -108,14 +140,25 @@ void AssetManager::clear_textures() noexcept
 
 entt::resource<ModelData> AssetManager::load_model(const std::filesystem::path& path)
 {
-    auto id = path_to_id(path);
+    auto id = cache_key(AssetId::from_path(path));
     auto [it, inserted] = m_modelCache.load(id, path);
+    if (it->second)
+        touch(ResidencyKind::Model, id, path, true);
+    return it->second;
+}
+
+entt::resource<ModelData> AssetManager::load_model(const std::filesystem::path& path, std::shared_ptr<ModelData> model)
+{
+    auto id = cache_key(AssetId::from_path(path));
+    auto [it, inserted] = m_modelCache.load(id, std::move(model));
+    if (it->second)
+        touch(ResidencyKind::Model, id, path, true);
     return it->second;
 }
 
 bool AssetManager::contains_model(const std::filesystem::path& path) const
 {
-    return m_modelCache.contains(path_to_id(path));
+    return m_modelCache.contains(find_cache_key(AssetId::from_path(path)));
 }
 
 size_t AssetManager::model_count() const noexcept
@@ -125,5 +168,210 @@ size_t AssetManager::model_count() const noexcept
 
 void AssetManager::clear_models() noexcept
 {
+    for (const auto& [id, entry] : m_residency[static_cast<std::size_t>(ResidencyKind::Model)])
+        m_cpuBytes -= entry.bytes;
+    m_residency[static_cast<std::size_t>(ResidencyKind::Model)].clear();
     m_modelCache.clear();
 }
+
+std::size_t AssetManager::release_cpu_geometry() noexcept
+{
+    std::size_t bytes = 0;
+    for (const ResidencyKind kind : {ResidencyKind::Mesh, ResidencyKind::Model})
+    {
+        for (auto& [id, entry] : m_residency[static_cast<std::size_t>(kind)])
+            bytes += evict(kind, id, entry);
+    }
+    return bytes;
+}
+
+// --- Residency ---
+
+void AssetManager::set_cpu_memory_budget(std::size_t bytes)
+{
+    m_cpuBudgetBytes = bytes;
+    enforce_cpu_budget();
+}
+
+std::size_t AssetManager::mark_gpu_resident()
+{
+    for (auto& map : m_residency)
+    {
+        for (auto& [id, entry] : map)
+            entry.uploaded = true;
+    }
+    return enforce_cpu_budget();
+}
+
+std::size_t AssetManager::enforce_cpu_budget()
+{
+    if (m_cpuBudgetBytes == 0 || m_cpuBytes <= m_cpuBudgetBytes)
+        return 0;
+
+    struct Candidate
+    {
+        std::uint64_t lastUse;
+        ResidencyKind kind;
+        entt::id_type id;
+    };
+    std::vector<Candidate> candidates{};
+    for (std::size_t kindIndex = 0; kindIndex < m_residency.size(); ++kindIndex)
+    {
+        for (const auto& [id, entry] : m_residency[kindIndex])
+        {
+            if (entry.uploaded && entry.restreamable && !entry.gpuOnly && entry.bytes > 0)
+                candidates.push_back({entry.lastUse, static_cast<ResidencyKind>(kindIndex), id});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.lastUse < b.lastUse; });
+
+    std::size_t freed = 0;
+    for (const Candidate& candidate : candidates)
+    {
+        if (m_cpuBytes <= m_cpuBudgetBytes)
+            break;
+        auto& entry = m_residency[static_cast<std::size_t>(candidate.kind)].at(candidate.id);
+        freed += evict(candidate.kind, candidate.id, entry);
+    }
+    return freed;
+}
+
+AssetResidency AssetManager::get_mesh_residency(const std::filesystem::path& path) const
+{
+    return get_residency(ResidencyKind::Mesh, find_cache_key(AssetId::from_path(path)));
+}
+
+AssetResidency AssetManager::get_model_residency(const std::filesystem::path& path) const
+{
+    return get_residency(ResidencyKind::Model, find_cache_key(AssetId::from_path(path)));
+}
+
+AssetResidency AssetManager::get_texture_residency(std::string_view name) const
+{
+    return get_residency(ResidencyKind::Texture, find_cache_key(AssetId::from_path(name)));
+}
+
+AssetResidency AssetManager::get_residency(ResidencyKind kind, entt::id_type id) const
+{
+    const auto& map = m_residency[static_cast<std::size_t>(kind)];
+    const auto it = map.find(id);
+    if (it == map.end())
+        return AssetResidency::NotLoaded;
+    return it->second.gpuOnly ? AssetResidency::GpuOnly : AssetResidency::Resident;
+}
+
+void AssetManager::touch(ResidencyKind kind, entt::id_type id, const std::filesystem::path& path, bool restreamable)
+{
+    auto& map = m_residency[static_cast<std::size_t>(kind)];
+    auto [it, inserted] = map.try_emplace(id);
+    ResidencyEntry& entry = it->second;
+    entry.lastUse = ++m_useClock;
+    if (inserted)
+    {
+        entry.path = path;
+        entry.restreamable = restreamable;
+        entry.bytes = payload_bytes(kind, id);
+        m_cpuBytes += entry.bytes;
+    }
+    else if (entry.gpuOnly)
+    {
+        restream(kind, id, entry);
+    }
+}
+
+void AssetManager::restream(ResidencyKind kind, entt::id_type id, ResidencyEntry& entry)
+{
+    // Loaded into a fresh object, then moved into the cached one so outstanding handles see the data.
+    bool restored = false;
+    switch (kind)
+    {
+    case ResidencyKind::Mesh:
+        if (auto fresh = MeshLoader{}(entry.path))
+        {
+            *m_meshCache[id] = std::move(*fresh);
+            restored = true;
+        }
+        break;
+    case ResidencyKind::Model:
+        if (auto fresh = ModelLoader{}(entry.path))
+        {
+            *m_modelCache[id] = std::move(*fresh);
+            restored = true;
+        }
+        break;
+    case ResidencyKind::Texture:
+        if (auto fresh = TextureLoader{}(entry.path))
+        {
+            *m_textureCache[id] = std::move(*fresh);
+            restored = true;
+        }
+        break;
+    case ResidencyKind::Count:
+        break;
+    }
+    if (!restored)
+        return;
+
+    entry.gpuOnly = false;
+    entry.uploaded = false; // a fresh copy is not known to match what the GPU holds
+    entry.bytes = payload_bytes(kind, id);
+    m_cpuBytes += entry.bytes;
+}
+
+std::size_t AssetManager::evict(ResidencyKind kind, entt::id_type id, ResidencyEntry& entry)
+{
+    if (entry.gpuOnly)
+        return 0;
+
+    std::size_t freed = 0;
+    switch (kind)
+    {
+    case ResidencyKind::Mesh:
+        if (auto handle = m_meshCache[id])
+            freed = handle->release_geometry();
+        break;
+    case ResidencyKind::Model:
+        if (auto handle = m_modelCache[id])
+            freed = handle->release_geometry();
+        break;
+    case ResidencyKind::Texture:
+        if (auto handle = m_textureCache[id])
+            freed = handle->release_pixels();
+        break;
+    case ResidencyKind::Count:
+        break;
+    }
+
+    entry.gpuOnly = true;
+    m_cpuBytes -= entry.bytes;
+    entry.bytes = 0;
+    return freed;
+}
+
+std::size_t AssetManager::payload_bytes(ResidencyKind kind, entt::id_type id) const
+{
+    switch (kind)
+    {
+    case ResidencyKind::Mesh:
+        if (auto handle = m_meshCache[id])
+            return handle->geometry_bytes();
+        break;
+    case ResidencyKind::Model:
+        if (auto handle = m_modelCache[id])
+        {
+            std::size_t bytes = 0;
+            for (const MeshData& mesh : handle->meshes)
+                bytes += mesh.geometry_bytes();
+            return bytes;
+        }
+        break;
+    case ResidencyKind::Texture:
+        if (auto handle = m_textureCache[id])
+            return handle->payload_bytes();
+        break;
+    case ResidencyKind::Count:
+        break;
+    }
+    return 0;
+}
@@ -1,8 +1,11 @@
 #include "MeshLoader.hpp"
 #include "../../Rendering/Public/Mesh.hpp"
+#include "../../Core/Public/Profiler.hpp"
+#include "../../Core/Public/VirtualFileSystem.hpp"
 #include "../Public/MeshData.hpp"
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
@@ -84,6 +87,7 @@ MeshLoader::result_type MeshLoader::operator()(const std::filesystem::path& path
 
 Result<std::shared_ptr<MeshData>> MeshLoader::parse_mesh(const std::filesystem::path& path)
 {
+    NOC_PROFILE_ZONE("MeshLoader::parse_mesh");
     if (path.extension() == ".fbx")
         return parse_fbx(path);
     return parse_obj(path);
@@ -486,28 +490,27 @@ Result<> MeshLoader::write_cache(const MeshData& mesh, const std::filesystem::pa
     return {};
 }
 
+// VertexData is stored exactly like Vertex, so cached vertex arrays are copied in bulk.
+static_assert(FLATBUFFERS_LITTLEENDIAN, "cached vertex data is read in place");
+static_assert(sizeof(NatureOfCraft::Assets::VertexData) == sizeof(Vertex));
+static_assert(offsetof(Vertex, normal) == 3 * sizeof(float) && offsetof(Vertex, texCoord) == 6 * sizeof(float) &&
+              offsetof(Vertex, tangent) == 8 * sizeof(float));
+
 Result<std::shared_ptr<MeshData>> MeshLoader::read_cache(const std::filesystem::path& cachePath)
 {
+    NOC_PROFILE_ZONE("MeshLoader::read_cache");
     namespace fb = NatureOfCraft::Assets;
 
-    std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
-    if (!file.is_open())
-        return make_error(fmt::format("Failed to open cache file: {}", cachePath.string()), ErrorCode::AssetCacheReadFailed);
-
-    auto fileSize = file.tellg();
-    if (fileSize <= 0)
-        return make_error(fmt::format("Cache file is empty: {}", cachePath.string()), ErrorCode::AssetCacheReadFailed);
+    auto mapped = VirtualFileSystem::get().open(cachePath);
+    if (!mapped)
+        return make_error(fmt::format("Failed to map cache file: {}", cachePath.string()), ErrorCode::AssetCacheReadFailed);
 
-    file.seekg(0, std::ios::beg);
-    std::vector<std::uint8_t> buffer(static_cast<size_t>(fileSize));
-    file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
-
-    flatbuffers::Verifier verifier(buffer.data(), buffer.size());
+    flatbuffers::Verifier verifier(mapped->data(), mapped->size());
     if (!fb::VerifyMeshAssetBuffer(verifier))
         return make_error(fmt::format("Cache file verification failed: {}", cachePath.string()),
                           ErrorCode::AssetCacheReadFailed);
 
-    const auto* meshAsset = fb::GetMeshAsset(buffer.data());
+    const auto* meshAsset = fb::GetMeshAsset(mapped->data());
     if (!meshAsset)
         return make_error(fmt::format("Failed to deserialize cache file: {}", cachePath.string()),
                           ErrorCode::AssetCacheReadFailed);
@@ -519,24 +522,16 @@ Result<std::shared_ptr<MeshData>> MeshLoader::read_cache(const std::filesystem::
     if (meshAsset->source_path())
         mesh->sourcePath = meshAsset->source_path()->str();
 
-    if (meshAsset->vertices())
+    if (const auto* vertices = meshAsset->vertices(); vertices && vertices->size() > 0)
     {
-        mesh->vertices.reserve(meshAsset->vertices()->size());
-        for (const auto* v : *meshAsset->vertices())
-        {
-            Vertex vertex{};
-            vertex.pos = {v->position().x(), v->position().y(), v->position().z()};
-            vertex.normal = {v->normal().x(), v->normal().y(), v->normal().z()};
-            vertex.texCoord = {v->tex_coord().x(), v->tex_coord().y()};
-            vertex.tangent = {v->tangent().x(), v->tangent().y(), v->tangent().z(), v->tangent().w()};
-            mesh->vertices.push_back(vertex);
-        }
+        mesh->vertices.resize(vertices->size());
+        std::memcpy(mesh->vertices.data(), vertices->Data(), vertices->size() * sizeof(Vertex));
     }
 
-    if (meshAsset->indices())
+    if (const auto* indices = meshAsset->indices(); indices && indices->size() > 0)
     {
-        const auto* idxVec = meshAsset->indices();
-        mesh->indices.assign(idxVec->begin(), idxVec->end());
+        mesh->indices.resize(indices->size());
+        std::memcpy(mesh->indices.data(), indices->Data(), indices->size() * sizeof(std::uint32_t));
     }
 
     if (meshAsset->bounds_min())
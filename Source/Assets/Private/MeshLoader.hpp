@@ -1,4 +1,5 @@
 #pragma once
+#include "../../Core/Public/Core.hpp"
 #include "../../Core/Public/Expected.hpp"
 #include "../Public/MeshData.hpp"
 
@@ -13,7 +14,7 @@
 /// Usage with entt::resource_cache:
 ///   entt::resource_cache<MeshData, MeshLoader> cache;
 ///   cache.load(id, "path/to/model.obj");
-struct MeshLoader
+struct NOC_EXPORT MeshLoader
 {
     using result_type = std::shared_ptr<MeshData>;
 
@@ -0,0 +1,488 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace
+{
+//    Vertex hashing
+
+constexpr std::uint64_t rotl64(std::uint64_t value, int shift) noexcept
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+constexpr std::uint64_t fmix64(std::uint64_t k) noexcept
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+//    Vertex cache scoring (Forsyth)
+
+constexpr float CacheDecayPower{1.5f};
+constexpr float LastTriangleScore{0.75f};
+constexpr float ValenceBoostScale{2.0f};
+constexpr float ValenceBoostPower{0.5f};
+constexpr std::size_t MaxValenceTable{32};
+
+struct ScoreTables
+{
+    std::array<float, MeshOptimizer::VertexCacheSize> cache{};
+    std::array<float, MaxValenceTable> valence{};
+
+    ScoreTables() noexcept
+    {
+        for (std::size_t position = 0; position < cache.size(); ++position)
+        {
+            if (position < 3)
+            {
+                cache[position] = LastTriangleScore;
+                continue;
+            }
+            const float scaler = 1.0f / static_cast<float>(cache.size() - 3);
+            cache[position] = std::pow(1.0f - static_cast<float>(position - 3) * scaler, CacheDecayPower);
+        }
+        for (std::size_t count = 1; count < valence.size(); ++count)
+            valence[count] = ValenceBoostScale * std::pow(static_cast<float>(count), -ValenceBoostPower);
+    }
+
+    float score(std::int32_t cachePosition, std::uint32_t remainingTriangles) const noexcept
+    {
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float result = cachePosition >= 0 ? cache[static_cast<std::size_t>(cachePosition)] : 0.0f;
+        result += remainingTriangles < valence.size()
+                      ? valence[remainingTriangles]
+                      : ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+        return result;
+    }
+};
+
+const ScoreTables& score_tables()
+{
+    static const ScoreTables tables{};
+    return tables;
+}
+
+//    Overdraw clustering
+
+/// FIFO cache used to find cluster boundaries; smaller than the scoring cache like real hardware.
+constexpr std::uint32_t OverdrawCacheSize{16};
+/// Soft boundaries are only placed after this many triangles, so clusters stay worth sorting.
+constexpr std::size_t MinClusterTriangles{32};
+
+struct Float3
+{
+    float x{};
+    float y{};
+    float z{};
+};
+
+Float3 sub(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) noexcept
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+Float3 cross(const Float3& a, const Float3& b) noexcept
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+/// Cache misses per triangle for a FIFO cache of OverdrawCacheSize entries.
+std::vector<std::uint8_t> simulate_fifo_misses(std::span<const std::uint32_t> indices, std::size_t vertexCount)
+{
+    std::vector<std::uint32_t> timestamps(vertexCount, 0);
+    std::vector<std::uint8_t> misses(indices.size() / 3, 0);
+    std::uint32_t time = OverdrawCacheSize + 1;
+
+    for (std::size_t triangle = 0; triangle < misses.size(); ++triangle)
+    {
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint32_t vertex = indices[triangle * 3 + corner];
+            if (time - timestamps[vertex] > OverdrawCacheSize)
+            {
+                timestamps[vertex] = time++;
+                ++misses[triangle];
+            }
+        }
+    }
+    return misses;
+}
+} // namespace
+
+//    VertexIndexer
+
+VertexIndexer::VertexIndexer(std::size_t expectedVertices)
+{
+    // Empty indexers allocate nothing until the first insert; importers keep many of them around.
+    if (expectedVertices == 0)
+        return;
+    vertices.reserve(expectedVertices);
+    m_hashes.reserve(expectedVertices);
+    m_slots.assign(std::bit_ceil(std::max<std::size_t>(expectedVertices * 2, MinSlots)), EmptySlot);
+}
+
+std::uint32_t VertexIndexer::insert(const Vertex& vertex)
+{
+    if ((vertices.size() + 1) * 2 > m_slots.size())
+        grow();
+
+    const std::uint64_t hash = MeshOptimizer::hash_vertex(vertex);
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::size_t slot = static_cast<std::size_t>(hash) & mask;; slot = (slot + 1) & mask)
+    {
+        const std::uint32_t existing = m_slots[slot];
+        if (existing == EmptySlot)
+        {
+            const auto index = static_cast<std::uint32_t>(vertices.size());
+            m_slots[slot] = index;
+            vertices.push_back(vertex);
+            m_hashes.push_back(hash);
+            return index;
+        }
+        if (m_hashes[existing] == hash && std::memcmp(&vertices[existing], &vertex, sizeof(Vertex)) == 0)
+            return existing;
+    }
+}
+
+void VertexIndexer::append(const VertexIndexer& other)
+{
+    // Weld each of the other build's vertices once, then translate its indices.
+    std::vector<std::uint32_t> remap(other.vertices.size());
+    for (std::size_t i = 0; i < other.vertices.size(); ++i)
+        remap[i] = insert(other.vertices[i]);
+
+    indices.reserve(indices.size() + other.indices.size());
+    for (std::uint32_t index : other.indices)
+    {
+        if (index < remap.size())
+            indices.push_back(remap[index]);
+    }
+}
+
+void VertexIndexer::grow()
+{
+    m_slots.assign(std::max<std::size_t>(m_slots.size() * 2, MinSlots), EmptySlot);
+    const std::size_t mask = m_slots.size() - 1;
+    for (std::uint32_t index = 0; index < vertices.size(); ++index)
+    {
+        std::size_t slot = static_cast<std::size_t>(m_hashes[index]) & mask;
+        while (m_slots[slot] != EmptySlot)
+            slot = (slot + 1) & mask;
+        m_slots[slot] = index;
+    }
+}
+
+//    MeshOptimizer
+
+std::uint64_t MeshOptimizer::hash_vertex(const Vertex& vertex) noexcept
+{
+    // MurmurHash3-style mixing over the vertex bytes, eight at a time.
+    static_assert(sizeof(Vertex) % sizeof(std::uint64_t) == 0);
+    std::array<std::uint64_t, sizeof(Vertex) / sizeof(std::uint64_t)> words{};
+    std::memcpy(words.data(), &vertex, sizeof(Vertex));
+
+    constexpr std::uint64_t c1 = 0x87c37b91114253d5ull;
+    constexpr std::uint64_t c2 = 0x4cf5ad432745937full;
+    std::uint64_t hash = 0x9e3779b97f4a7c15ull ^ sizeof(Vertex);
+    for (std::uint64_t word : words)
+    {
+        word *= c1;
+        word = rotl64(word, 31);
+        word *= c2;
+        hash ^= word;
+        hash = rotl64(hash, 27) * 5 + 0x52dce729;
+    }
+    return fmix64(hash);
+}
+
+void MeshOptimizer::optimize_vertex_cache(std::span<std::uint32_t> indices, std::size_t vertexCount)
+{
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2 || vertexCount == 0)
+        return;
+
+    const ScoreTables& tables = score_tables();
+
+    // Triangles adjacent to each vertex (CSR). The live prefix of each range shrinks as triangles are emitted.
+    std::vector<std::uint32_t> remaining(vertexCount, 0);
+    for (std::size_t i = 0; i < triangleCount * 3; ++i)
+        ++remaining[indices[i]];
+
+    std::vector<std::uint32_t> offsets(vertexCount + 1, 0);
+    for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+        offsets[vertex + 1] = offsets[vertex] + remaining[vertex];
+
+    std::vector<std::uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+        {
+            for (std::size_t corner = 0; corner < 3; ++corner)
+                adjacency[fill[indices[triangle * 3 + corner]]++] = static_cast<std::uint32_t>(triangle);
+        }
+    }
+
+    std::vector<std::int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+        vertexScore[vertex] = tables.score(-1, remaining[vertex]);
+
+    std::vector<float> triangleScore(triangleCount);
+    for (std::size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        triangleScore[triangle] = vertexScore[indices[triangle * 3 + 0]] + vertexScore[indices[triangle * 3 + 1]] +
+                                  vertexScore[indices[triangle * 3 + 2]];
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<std::uint32_t> output(triangleCount * 3);
+    std::vector<std::uint32_t> cache{};
+    std::vector<std::uint32_t> nextCache{};
+    cache.reserve(VertexCacheSize + 3);
+    nextCache.reserve(VertexCacheSize + 3);
+
+    auto best = static_cast<std::size_t>(
+        std::distance(triangleScore.begin(), std::max_element(triangleScore.begin(), triangleScore.end())));
+    std::size_t scanCursor = 0;
+
+    for (std::size_t outputTriangle = 0; outputTriangle < triangleCount; ++outputTriangle)
+    {
+        if (best == triangleCount)
+        {
+            // Dead end: nothing in the cache has triangles left, continue with the next unused one.
+            while (emitted[scanCursor])
+                ++scanCursor;
+            best = scanCursor;
+        }
+
+        emitted[best] = true;
+        const std::array<std::uint32_t, 3> corners{indices[best * 3 + 0], indices[best * 3 + 1], indices[best * 3 + 2]};
+        for (std::size_t corner = 0; corner < 3; ++corner)
+        {
+            const std::uint32_t vertex = corners[corner];
+            output[outputTriangle * 3 + corner] = vertex;
+
+            const std::uint32_t begin = offsets[vertex];
+            const std::uint32_t end = begin + remaining[vertex];
+            for (std::uint32_t i = begin; i < end; ++i)
+            {
+                if (adjacency[i] == best)
+                {
+                    std::swap(adjacency[i], adjacency[end - 1]);
+                    --remaining[vertex];
+                    break;
+                }
+            }
+        }
+
+        // New LRU order: this triangle's corners first, then the previous entries.
+        nextCache.assign(corners.begin(), corners.end());
+        for (std::uint32_t vertex : cache)
+        {
+            if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2])
+                nextCache.push_back(vertex);
+        }
+        std::swap(cache, nextCache);
+
+        for (std::size_t position = 0; position < cache.size(); ++position)
+        {
+            const std::uint32_t vertex = cache[position];
+            cachePosition[vertex] = position < VertexCacheSize ? static_cast<std::int32_t>(position) : -1;
+            vertexScore[vertex] = tables.score(cachePosition[vertex], remaining[vertex]);
+        }
+
+        best = triangleCount;
+        float bestScore = -1.0f;
+        for (std::uint32_t vertex : cache)
+        {
+            const std::uint32_t begin = offsets[vertex];
+            for (std::uint32_t i = begin; i < begin + remaining[vertex]; ++i)
+            {
+                const std::uint32_t triangle = adjacency[i];
+                const float score = vertexScore[indices[triangle * 3 + 0]] + vertexScore[indices[triangle * 3 + 1]] +
+                                    vertexScore[indices[triangle * 3 + 2]];
+                triangleScore[triangle] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = triangle;
+                }
+            }
+        }
+
+        if (cache.size() > VertexCacheSize)
+            cache.resize(VertexCacheSize);
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::optimize_overdraw(std::span<std::uint32_t> indices, std::span<const Vertex> vertices, float threshold)
+{
+    const std::size_t triangleCount = indices.size() / 3;
+    if (triangleCount < MinClusterTriangles * 2 || vertices.empty())
+        return;
+
+    const std::vector<std::uint8_t> misses = simulate_fifo_misses(indices, vertices.size());
+
+    // Hard boundaries where the cache starts over (three misses); soft ones where a cluster's running
+    // miss ratio has dropped close to its average, so splitting there costs few extra misses.
+    std::vector<std::size_t> clusterStarts{0};
+    std::size_t hardStart = 0;
+    while (hardStart < triangleCount)
+    {
+        std::size_t hardEnd = hardStart + 1;
+        while (hardEnd < triangleCount && misses[hardEnd] != 3)
+            ++hardEnd;
+
+        std::uint32_t hardMisses = 0;
+        for (std::size_t t = hardStart; t < hardEnd; ++t)
+            hardMisses += misses[t];
+        const float limit = threshold * static_cast<float>(hardMisses) / static_cast<float>(hardEnd - hardStart);
+
+        std::size_t softStart = hardStart;
+        std::uint32_t softMisses = 0;
+        for (std::size_t t = hardStart; t < hardEnd; ++t)
+        {
+            softMisses += misses[t];
+            const std::size_t softCount = t - softStart + 1;
+            if (softCount >= MinClusterTriangles && t + 1 < hardEnd &&
+                static_cast<float>(softMisses) / static_cast<float>(softCount) <= limit)
+            {
+                clusterStarts.push_back(t + 1);
+                softStart = t + 1;
+                softMisses = 0;
+            }
+        }
+
+        if (hardEnd < triangleCount)
+            clusterStarts.push_back(hardEnd);
+        hardStart = hardEnd;
+    }
+
+    if (clusterStarts.size() < 2)
+        return;
+
+    // Mesh centroid, then per cluster: area-weighted centroid and normal. Clusters facing away from
+    // the centre occlude the others from most directions, so they draw first.
+    Float3 meshCentroid{};
+    for (const Vertex& vertex : vertices)
+    {
+        meshCentroid.x += vertex.pos.x;
+        meshCentroid.y += vertex.pos.y;
+        meshCentroid.z += vertex.pos.z;
+    }
+    const float inverseCount = 1.0f / static_cast<float>(vertices.size());
+    meshCentroid = {meshCentroid.x * inverseCount, meshCentroid.y * inverseCount, meshCentroid.z * inverseCount};
+
+    const std::size_t clusterCount = clusterStarts.size();
+    std::vector<float> sortKey(clusterCount, 0.0f);
+    for (std::size_t cluster = 0; cluster < clusterCount; ++cluster)
+    {
+        const std::size_t begin = clusterStarts[cluster];
+        const std::size_t end = cluster + 1 < clusterCount ? clusterStarts[cluster + 1] : triangleCount;
+
+        Float3 centroid{};
+        Float3 normal{};
+        float area = 0.0f;
+        for (std::size_t t = begin; t < end; ++t)
+        {
+            const auto& p0 = vertices[indices[t * 3 + 0]].pos;
+            const auto& p1 = vertices[indices[t * 3 + 1]].pos;
+            const auto& p2 = vertices[indices[t * 3 + 2]].pos;
+            const Float3 n = cross(sub(p1, p0), sub(p2, p0));
+            const float triangleArea = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+
+            centroid.x += (p0.x + p1.x + p2.x) * triangleArea;
+            centroid.y += (p0.y + p1.y + p2.y) * triangleArea;
+            centroid.z += (p0.z + p1.z + p2.z) * triangleArea;
+            normal = {normal.x + n.x, normal.y + n.y, normal.z + n.z};
+            area += triangleArea;
+        }
+
+        if (area <= 0.0f)
+            continue;
+        const float inverseArea = 1.0f / (area * 3.0f);
+        const Float3 offset{centroid.x * inverseArea - meshCentroid.x, centroid.y * inverseArea - meshCentroid.y,
+                            centroid.z * inverseArea - meshCentroid.z};
+        const float normalLength = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        if (normalLength > 0.0f)
+            sortKey[cluster] = (offset.x * normal.x + offset.y * normal.y + offset.z * normal.z) / normalLength;
+    }
+
+    std::vector<std::size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<std::uint32_t> output{};
+    output.reserve(triangleCount * 3);
+    for (std::size_t cluster : order)
+    {
+        const std::size_t begin = clusterStarts[cluster];
+        const std::size_t end = cluster + 1 < clusterCount ? clusterStarts[cluster + 1] : triangleCount;
+        output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(begin * 3),
+                      indices.begin() + static_cast<std::ptrdiff_t>(end * 3));
+    }
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::optimize_vertex_fetch(std::vector<Vertex>& vertices, std::span<std::uint32_t> indices)
+{
+    constexpr std::uint32_t Unassigned{UINT32_MAX};
+    std::vector<std::uint32_t> remap(vertices.size(), Unassigned);
+    std::vector<Vertex> reordered{};
+    reordered.reserve(vertices.size());
+
+    for (std::uint32_t& index : indices)
+    {
+        if (remap[index] == Unassigned)
+        {
+            remap[index] = static_cast<std::uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    // Vertices no triangle uses are dropped.
+    vertices = std::move(reordered);
+}
+
+void MeshOptimizer::optimize(MeshData& mesh)
+{
+    if (mesh.indices.empty() || mesh.vertices.empty())
+        return;
+
+    std::span<std::uint32_t> indices{mesh.indices};
+    if (mesh.lods.empty())
+    {
+        optimize_vertex_cache(indices, mesh.vertices.size());
+        optimize_overdraw(indices, mesh.vertices);
+    }
+    else
+    {
+        for (std::size_t level = 0; level < mesh.lods.size(); ++level)
+        {
+            const MeshLod& lod = mesh.lods[level];
+            if (static_cast<std::size_t>(lod.firstIndex) + lod.indexCount > indices.size())
+                break;
+            const auto range = indices.subspan(lod.firstIndex, lod.indexCount);
+            optimize_vertex_cache(range, mesh.vertices.size());
+            if (level == 0)
+                optimize_overdraw(range, mesh.vertices);
+        }
+    }
+
+    optimize_vertex_fetch(mesh.vertices, indices);
+}
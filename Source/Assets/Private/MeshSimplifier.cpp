@@ -0,0 +1,491 @@
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace
+{
+/// Border edges are pinned by a plane through the edge, perpendicular to its face, weighted this much.
+constexpr double BorderWeight{10.0};
+/// Collapses that turn a face by more than ~75 degrees are rejected as fold-overs.
+constexpr double MinNormalCosine{0.25};
+/// Levels whose geometry matches LOD 0 exactly still differ in shading; keep their errors ordered.
+constexpr float MinLevelErrorStep{0.005f};
+
+struct Vec3d
+{
+    double x{};
+    double y{};
+    double z{};
+};
+
+Vec3d to_vec(const DirectX::XMFLOAT3& p) noexcept
+{
+    return {p.x, p.y, p.z};
+}
+
+Vec3d sub(const Vec3d& a, const Vec3d& b) noexcept
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+Vec3d cross(const Vec3d& a, const Vec3d& b) noexcept
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+double dot(const Vec3d& a, const Vec3d& b) noexcept
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+double length(const Vec3d& a) noexcept
+{
+    return std::sqrt(dot(a, a));
+}
+
+/// Symmetric 4x4 error quadric (upper triangle, row-major).
+struct Quadric
+{
+    std::array<double, 10> m{};
+
+    static Quadric from_plane(const Vec3d& normal, double d, double weight) noexcept
+    {
+        const double a = normal.x;
+        const double b = normal.y;
+        const double c = normal.z;
+        Quadric q{};
+        q.m = {a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d};
+        for (double& value : q.m)
+            value *= weight;
+        return q;
+    }
+
+    Quadric& operator+=(const Quadric& other) noexcept
+    {
+        for (std::size_t i = 0; i < m.size(); ++i)
+            m[i] += other.m[i];
+        return *this;
+    }
+
+    /// Sum of squared distances from `p` to the accumulated planes.
+    double evaluate(const Vec3d& p) const noexcept
+    {
+        const double x = p.x;
+        const double y = p.y;
+        const double z = p.z;
+        return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x + m[4] * y * y +
+               2.0 * m[5] * y * z + 2.0 * m[6] * y + m[7] * z * z + 2.0 * m[8] * z + m[9];
+    }
+};
+
+struct PositionKey
+{
+    std::array<std::uint32_t, 3> bits{};
+
+    bool operator==(const PositionKey&) const = default;
+};
+
+struct PositionKeyHash
+{
+    std::size_t operator()(const PositionKey& key) const noexcept
+    {
+        std::size_t hash = key.bits[0];
+        hash = hash * 0x9E3779B97F4A7C15ull ^ key.bits[1];
+        hash = hash * 0x9E3779B97F4A7C15ull ^ key.bits[2];
+        return hash;
+    }
+};
+
+/// Collapse of position group `from` onto group `to`.
+struct Collapse
+{
+    double cost{};
+    std::uint32_t from{};
+    std::uint32_t to{};
+    std::uint32_t fromVersion{};
+    std::uint32_t toVersion{};
+
+    bool operator>(const Collapse& other) const noexcept
+    {
+        return cost > other.cost;
+    }
+};
+
+struct EdgeRef
+{
+    std::uint32_t lo{};
+    std::uint32_t hi{};
+    std::uint32_t triangle{};
+};
+} // namespace
+
+std::vector<std::uint32_t> MeshSimplifier::simplify(std::span<const Vertex> vertices,
+                                                    std::span<const std::uint32_t> indices,
+                                                    std::size_t targetIndexCount, float maxError, float* outError)
+{
+    if (outError != nullptr)
+        *outError = 0.0f;
+
+    std::vector<std::uint32_t> result(indices.begin(), indices.begin() + (indices.size() / 3) * 3);
+    if (result.size() <= targetIndexCount || vertices.empty())
+        return result;
+
+    //    Weld wedges that share a position
+    const std::size_t vertexCount = vertices.size();
+    std::vector<std::uint32_t> groupOf(vertexCount);
+    std::vector<Vec3d> groupPos{};
+    {
+        std::unordered_map<PositionKey, std::uint32_t, PositionKeyHash> lookup{};
+        lookup.reserve(vertexCount);
+        for (std::size_t v = 0; v < vertexCount; ++v)
+        {
+            PositionKey key{};
+            std::memcpy(key.bits.data(), &vertices[v].pos, sizeof(key.bits));
+            const auto [it, inserted] = lookup.try_emplace(key, static_cast<std::uint32_t>(groupPos.size()));
+            if (inserted)
+                groupPos.push_back(to_vec(vertices[v].pos));
+            groupOf[v] = it->second;
+        }
+    }
+    const std::size_t groupCount = groupPos.size();
+
+    std::vector<std::uint32_t> memberStart(groupCount + 1, 0);
+    std::vector<std::uint32_t> members(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; ++v)
+        ++memberStart[groupOf[v] + 1];
+    for (std::size_t g = 0; g < groupCount; ++g)
+        memberStart[g + 1] += memberStart[g];
+    {
+        std::vector<std::uint32_t> cursor(memberStart.begin(), memberStart.end() - 1);
+        for (std::size_t v = 0; v < vertexCount; ++v)
+            members[cursor[groupOf[v]]++] = static_cast<std::uint32_t>(v);
+    }
+
+    //    Quadrics, adjacency and border constraints
+    const std::size_t triangleCount = result.size() / 3;
+    std::vector<std::uint8_t> triangleRemoved(triangleCount, 0);
+    std::vector<Quadric> quadrics(groupCount);
+    std::vector<std::vector<std::uint32_t>> groupTriangles(groupCount);
+    std::vector<EdgeRef> edges{};
+    edges.reserve(triangleCount * 3);
+    std::size_t liveTriangles{};
+
+    const auto triangle_group = [&](std::size_t triangle, std::uint32_t corner) {
+        return groupOf[result[triangle * 3 + corner]];
+    };
+
+    for (std::size_t t = 0; t < triangleCount; ++t)
+    {
+        const std::uint32_t i0 = result[t * 3 + 0];
+        const std::uint32_t i1 = result[t * 3 + 1];
+        const std::uint32_t i2 = result[t * 3 + 2];
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+        {
+            triangleRemoved[t] = 1;
+            continue;
+        }
+
+        const std::array<std::uint32_t, 3> groups{groupOf[i0], groupOf[i1], groupOf[i2]};
+        if (groups[0] == groups[1] || groups[1] == groups[2] || groups[0] == groups[2])
+        {
+            triangleRemoved[t] = 1; // zero-area: drops out without changing the surface
+            continue;
+        }
+
+        ++liveTriangles;
+        const Vec3d normal = cross(sub(groupPos[groups[1]], groupPos[groups[0]]), sub(groupPos[groups[2]], groupPos[groups[0]]));
+        const double normalLength = length(normal);
+        if (normalLength > 0.0)
+        {
+            const Vec3d unitNormal{normal.x / normalLength, normal.y / normalLength, normal.z / normalLength};
+            const Quadric plane = Quadric::from_plane(unitNormal, -dot(unitNormal, groupPos[groups[0]]), 1.0);
+            for (const std::uint32_t group : groups)
+                quadrics[group] += plane;
+        }
+
+        for (std::uint32_t corner = 0; corner < 3; ++corner)
+        {
+            groupTriangles[groups[corner]].push_back(static_cast<std::uint32_t>(t));
+            const std::uint32_t a = groups[corner];
+            const std::uint32_t b = groups[(corner + 1) % 3];
+            edges.push_back(EdgeRef{std::min(a, b), std::max(a, b), static_cast<std::uint32_t>(t)});
+        }
+    }
+
+    std::ranges::sort(edges, [](const EdgeRef& lhs, const EdgeRef& rhs) {
+        return lhs.lo < rhs.lo || (lhs.lo == rhs.lo && lhs.hi < rhs.hi);
+    });
+
+    std::vector<std::uint32_t> version(groupCount, 0);
+    std::vector<std::uint8_t> dead(groupCount, 0);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap{};
+    const auto push_collapse = [&](std::uint32_t from, std::uint32_t to) {
+        Quadric combined = quadrics[from];
+        combined += quadrics[to];
+        const double cost = std::max(0.0, combined.evaluate(groupPos[to]));
+        heap.push(Collapse{cost, from, to, version[from], version[to]});
+    };
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> uniqueEdges{};
+    uniqueEdges.reserve(edges.size() / 2 + 1);
+    for (std::size_t begin = 0; begin < edges.size();)
+    {
+        std::size_t end = begin + 1;
+        while (end < edges.size() && edges[end].lo == edges[begin].lo && edges[end].hi == edges[begin].hi)
+            ++end;
+
+        const EdgeRef& edge = edges[begin];
+        if (end - begin == 1)
+        {
+            const std::size_t t = edge.triangle;
+            const Vec3d normal = cross(sub(groupPos[triangle_group(t, 1)], groupPos[triangle_group(t, 0)]),
+                                       sub(groupPos[triangle_group(t, 2)], groupPos[triangle_group(t, 0)]));
+            const Vec3d direction = sub(groupPos[edge.hi], groupPos[edge.lo]);
+            const Vec3d borderNormal = cross(direction, normal);
+            const double borderLength = length(borderNormal);
+            if (borderLength > 0.0)
+            {
+                const Vec3d unit{borderNormal.x / borderLength, borderNormal.y / borderLength, borderNormal.z / borderLength};
+                const Quadric plane = Quadric::from_plane(unit, -dot(unit, groupPos[edge.lo]), BorderWeight);
+                quadrics[edge.lo] += plane;
+                quadrics[edge.hi] += plane;
+            }
+        }
+        uniqueEdges.emplace_back(edge.lo, edge.hi);
+        begin = end;
+    }
+    edges.clear();
+    edges.shrink_to_fit();
+
+    for (const auto& [lo, hi] : uniqueEdges)
+    {
+        push_collapse(lo, hi);
+        push_collapse(hi, lo);
+    }
+    uniqueEdges.clear();
+
+    //    Collapse cheapest edges first
+    std::vector<std::uint32_t> neighboursFrom{};
+    std::vector<std::uint32_t> neighboursTo{};
+    const auto gather_neighbours = [&](std::uint32_t group, std::vector<std::uint32_t>& out) {
+        out.clear();
+        for (const std::uint32_t t : groupTriangles[group])
+        {
+            if (triangleRemoved[t] != 0)
+                continue;
+            for (std::uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const std::uint32_t other = triangle_group(t, corner);
+                if (other != group)
+                    out.push_back(other);
+            }
+        }
+        std::ranges::sort(out);
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    };
+
+    const auto triangle_has_group = [&](std::uint32_t t, std::uint32_t group) {
+        return triangle_group(t, 0) == group || triangle_group(t, 1) == group || triangle_group(t, 2) == group;
+    };
+
+    const auto can_collapse = [&](std::uint32_t from, std::uint32_t to) {
+        std::size_t sharedTriangles{};
+        for (const std::uint32_t t : groupTriangles[from])
+        {
+            if (triangleRemoved[t] != 0)
+                continue;
+            if (triangle_has_group(t, to))
+            {
+                ++sharedTriangles;
+                continue;
+            }
+
+            std::array<Vec3d, 3> before{};
+            std::array<Vec3d, 3> after{};
+            for (std::uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const std::uint32_t group = triangle_group(t, corner);
+                before[corner] = groupPos[group];
+                after[corner] = group == from ? groupPos[to] : groupPos[group];
+            }
+            const Vec3d normalBefore = cross(sub(before[1], before[0]), sub(before[2], before[0]));
+            const Vec3d normalAfter = cross(sub(after[1], after[0]), sub(after[2], after[0]));
+            const double lengthBefore = length(normalBefore);
+            const double lengthAfter = length(normalAfter);
+            if (lengthAfter <= 0.0)
+                return false;
+            if (lengthBefore > 0.0 && dot(normalBefore, normalAfter) < MinNormalCosine * lengthBefore * lengthAfter)
+                return false;
+        }
+        if (sharedTriangles == 0)
+            return false;
+
+        // Link condition: more common neighbours than shared faces would pinch the surface.
+        gather_neighbours(from, neighboursFrom);
+        gather_neighbours(to, neighboursTo);
+        std::size_t commonNeighbours{};
+        auto fromIt = neighboursFrom.begin();
+        auto toIt = neighboursTo.begin();
+        while (fromIt != neighboursFrom.end() && toIt != neighboursTo.end())
+        {
+            if (*fromIt < *toIt)
+                ++fromIt;
+            else if (*toIt < *fromIt)
+                ++toIt;
+            else
+            {
+                ++commonNeighbours;
+                ++fromIt;
+                ++toIt;
+            }
+        }
+        return commonNeighbours <= sharedTriangles;
+    };
+
+    // Wedge of `to` whose attributes best match `vertex`, so seams and hard edges survive collapses.
+    const auto closest_wedge = [&](std::uint32_t vertex, std::uint32_t to) {
+        const Vertex& source = vertices[vertex];
+        std::uint32_t best = members[memberStart[to]];
+        float bestScore = std::numeric_limits<float>::max();
+        for (std::uint32_t m = memberStart[to]; m < memberStart[to + 1]; ++m)
+        {
+            const Vertex& candidate = vertices[members[m]];
+            const float normalDot = source.normal.x * candidate.normal.x + source.normal.y * candidate.normal.y +
+                                    source.normal.z * candidate.normal.z;
+            const float du = source.texCoord.x - candidate.texCoord.x;
+            const float dv = source.texCoord.y - candidate.texCoord.y;
+            const float score = (1.0f - normalDot) + du * du + dv * dv;
+            if (score < bestScore)
+            {
+                bestScore = score;
+                best = members[m];
+            }
+        }
+        return best;
+    };
+
+    const double maxCost = static_cast<double>(maxError) * static_cast<double>(maxError);
+    double worstCost{};
+    while (liveTriangles * 3 > targetIndexCount && !heap.empty())
+    {
+        const Collapse collapse = heap.top();
+        heap.pop();
+        if (dead[collapse.from] != 0 || dead[collapse.to] != 0 || version[collapse.from] != collapse.fromVersion ||
+            version[collapse.to] != collapse.toVersion)
+            continue;
+        if (collapse.cost > maxCost)
+            break;
+        if (!can_collapse(collapse.from, collapse.to))
+            continue;
+
+        const std::uint32_t from = collapse.from;
+        const std::uint32_t to = collapse.to;
+        for (const std::uint32_t t : groupTriangles[from])
+        {
+            if (triangleRemoved[t] != 0)
+                continue;
+            if (triangle_has_group(t, to))
+            {
+                triangleRemoved[t] = 1;
+                --liveTriangles;
+                continue;
+            }
+            for (std::uint32_t corner = 0; corner < 3; ++corner)
+            {
+                std::uint32_t& index = result[t * 3 + corner];
+                if (groupOf[index] == from)
+                    index = closest_wedge(index, to);
+            }
+            groupTriangles[to].push_back(t);
+        }
+        groupTriangles[from].clear();
+        groupTriangles[from].shrink_to_fit();
+        std::erase_if(groupTriangles[to], [&](std::uint32_t t) { return triangleRemoved[t] != 0; });
+
+        dead[from] = 1;
+        quadrics[to] += quadrics[from];
+        ++version[to];
+        worstCost = std::max(worstCost, collapse.cost);
+
+        gather_neighbours(to, neighboursTo);
+        for (const std::uint32_t neighbour : neighboursTo)
+        {
+            push_collapse(to, neighbour);
+            push_collapse(neighbour, to);
+        }
+    }
+
+    std::size_t writeIndex{};
+    for (std::size_t t = 0; t < triangleCount; ++t)
+    {
+        if (triangleRemoved[t] != 0)
+            continue;
+        result[writeIndex++] = result[t * 3 + 0];
+        result[writeIndex++] = result[t * 3 + 1];
+        result[writeIndex++] = result[t * 3 + 2];
+    }
+    result.resize(writeIndex);
+
+    if (outError != nullptr)
+        *outError = static_cast<float>(std::sqrt(worstCost));
+    return result;
+}
+
+std::uint32_t MeshSimplifier::generate_lods(MeshData& mesh)
+{
+    if (mesh.lods.size() > 1 || mesh.vertices.empty())
+        return 0;
+
+    std::vector<std::uint32_t> previous(mesh.base_indices().begin(), mesh.base_indices().end());
+    if (previous.size() / 3 < MinLodTriangles * 2)
+        return 0;
+
+    const float halfX = (mesh.boundsMax.x - mesh.boundsMin.x) * 0.5f;
+    const float halfY = (mesh.boundsMax.y - mesh.boundsMin.y) * 0.5f;
+    const float halfZ = (mesh.boundsMax.z - mesh.boundsMin.z) * 0.5f;
+    const float radius = std::sqrt(halfX * halfX + halfY * halfY + halfZ * halfZ);
+    if (!(radius > 0.0f))
+        return 0;
+
+    mesh.indices.resize(previous.size());
+    mesh.lods.clear();
+    mesh.lods.push_back(MeshLod{0, static_cast<std::uint32_t>(previous.size()), 0.0f});
+
+    // Each level is simplified from the one before it; errors accumulate as an upper bound.
+    float cumulativeError{};
+    for (std::uint32_t level = 1; level < MaxMeshLods; ++level)
+    {
+        const std::size_t targetIndexCount = (previous.size() / 6) * 3;
+        const float errorBudget = MaxLodError * radius - cumulativeError;
+        if (targetIndexCount / 3 < MinLodTriangles || !(errorBudget > 0.0f))
+            break;
+
+        float levelError{};
+        std::vector<std::uint32_t> simplified =
+            simplify(mesh.vertices, previous, targetIndexCount, errorBudget, &levelError);
+        // Below ~15% fewer triangles a level costs memory without saving vertex work.
+        if (simplified.empty() || simplified.size() * 20 > previous.size() * 17)
+            break;
+
+        cumulativeError += levelError;
+        const float relativeError = std::max(cumulativeError / radius, mesh.lods.back().error + MinLevelErrorStep);
+        mesh.lods.push_back(MeshLod{static_cast<std::uint32_t>(mesh.indices.size()),
+                                    static_cast<std::uint32_t>(simplified.size()), relativeError});
+        mesh.indices.insert(mesh.indices.end(), simplified.begin(), simplified.end());
+        previous = std::move(simplified);
+    }
+
+    if (mesh.lods.size() == 1)
+    {
+        mesh.lods.clear();
+        return 0;
+    }
+    return static_cast<std::uint32_t>(mesh.lods.size() - 1);
+}
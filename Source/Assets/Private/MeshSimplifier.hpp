@@ -0,0 +1,31 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "../Public/MeshData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/// Offline mesh simplification used by the cooker to build LOD chains.
+/// Quadric error metric edge collapse (Garland & Heckbert) over position-welded vertices:
+/// every collapse moves a vertex onto one of its neighbours, so simplified index lists keep
+/// indexing the original vertex array, and attribute seams pick the closest-matching wedge.
+struct NOC_EXPORT MeshSimplifier
+{
+    /// Stop building levels once a level would have fewer triangles than this.
+    static constexpr std::size_t MinLodTriangles{64};
+    /// Largest deviation a level may introduce, relative to the bounding-sphere radius.
+    static constexpr float MaxLodError{0.25f};
+
+    /// Collapses edges of the triangle list until at most `targetIndexCount` indices remain or the
+    /// next collapse would move the surface by more than `maxError` (object units).
+    /// `outError` receives the largest deviation that was introduced.
+    static std::vector<std::uint32_t> simplify(std::span<const Vertex> vertices, std::span<const std::uint32_t> indices,
+                                               std::size_t targetIndexCount, float maxError, float* outError = nullptr);
+
+    /// Builds up to MaxMeshLods levels, each targeting half the triangles of the previous one,
+    /// appends their indices after LOD 0 and fills `mesh.lods`. Meshes that already carry levels
+    /// are left alone. Returns the number of levels added beyond LOD 0.
+    static std::uint32_t generate_lods(MeshData& mesh);
+};
@@ -1,11 +1,16 @@
 #include "ModelLoader.hpp"
+#include "../../Core/Public/JobSystem.hpp"
+#include "../../Core/Public/Profiler.hpp"
+#include "../../Core/Public/VirtualFileSystem.hpp"
+#include "MeshOptimizer.hpp"
 #include "../../Rendering/Public/Mesh.hpp"
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <thread>
 #include <unordered_map>
 
 #include <ModelAsset_generated.h>
@@ -18,29 +23,14 @@
 #include <DirectXMath.h>
 using namespace DirectX;
 
-static tf::Executor& model_loader_executor()
+// Give an imported model its stable id from the source path, and each sub-mesh the child id of its name.
+static void assign_asset_ids(ModelData& model)
 {
-    const std::uint32_t workerCount = std::thread::hardware_concurrency();
-    static tf::Executor executor(workerCount > 0 ? workerCount : 1);
-    return executor;
+    model.id = AssetId::from_path(model.sourcePath);
+    for (MeshData& mesh : model.meshes)
+        mesh.id = model.id.child(mesh.name);
 }
 
-namespace std
-{
-template <> struct hash<Vertex>
-{
-    size_t operator()(Vertex const& vertex) const
-    {
-        size_t h1 =
-            hash<float>()(vertex.pos.x) ^ (hash<float>()(vertex.pos.y) << 1) ^ (hash<float>()(vertex.pos.z) << 2);
-        size_t h2 = hash<float>()(vertex.normal.x) ^ (hash<float>()(vertex.normal.y) << 1) ^
-                    (hash<float>()(vertex.normal.z) << 2);
-        size_t h3 = hash<float>()(vertex.texCoord.x) ^ (hash<float>()(vertex.texCoord.y) << 1);
-        return h1 ^ (h2 << 1) ^ (h3 << 1);
-    }
-};
-} // namespace std
-
 // Compute tangent vectors for a MeshData in-place.
 // Accumulates per-triangle tangent/bitangent, then Gram-Schmidt orthogonalizes against normal.
 static void compute_tangents(MeshData& mesh)
@@ -114,6 +104,38 @@ static void compute_tangents(MeshData& mesh)
     }
 }
 
+// Welds the per-shape/per-node builds into one build per material, one task per material.
+// Each material's merge is independent, and the output order matches a serial merge.
+template <typename LocalBuildFn>
+static std::vector<VertexIndexer> merge_material_builds(size_t sourceCount, size_t matCount, LocalBuildFn&& localBuild)
+{
+    std::vector<VertexIndexer> merged(matCount);
+    auto merge_material = [&](size_t matIdx) {
+        size_t vertexCount = 0;
+        for (size_t source = 0; source < sourceCount; ++source)
+        {
+            if (const VertexIndexer* build = localBuild(source, matIdx))
+                vertexCount += build->vertices.size();
+        }
+        if (vertexCount == 0)
+            return;
+
+        VertexIndexer& target = merged[matIdx];
+        target = VertexIndexer(vertexCount);
+        for (size_t source = 0; source < sourceCount; ++source)
+        {
+            if (const VertexIndexer* build = localBuild(source, matIdx))
+                target.append(*build);
+        }
+    };
+
+    tf::Taskflow taskflow;
+    for (size_t matIdx = 0; matIdx < matCount; ++matIdx)
+        taskflow.emplace([&, matIdx]() { merge_material(matIdx); });
+    JobSystem::get().run_and_wait(taskflow);
+    return merged;
+}
+
 ModelLoader::result_type ModelLoader::operator()(const std::filesystem::path& path) const
 {
     if (path.extension() == ".noc_model")
@@ -137,8 +159,14 @@ ModelLoader::result_type ModelLoader::operator()(const std::filesystem::path& pa
     return std::move(result.value());
 }
 
+ModelLoader::result_type ModelLoader::operator()(std::shared_ptr<ModelData> model) const
+{
+    return model;
+}
+
 Result<std::shared_ptr<ModelData>> ModelLoader::parse_model(const std::filesystem::path& path)
 {
+    NOC_PROFILE_ZONE("ModelLoader::parse_model");
     if (path.extension() == ".fbx")
         return parse_fbx(path);
     return parse_obj(path);
@@ -207,23 +235,8 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_obj(const std::filesystem:
         return vertex;
     };
 
-    struct MeshBuild
-    {
-        std::vector<Vertex> vertices;
-        std::vector<std::uint32_t> indices;
-        std::unordered_map<Vertex, std::uint32_t> uniqueVertices;
-
-        void addVertex(const Vertex& v)
-        {
-            auto [it, inserted] = uniqueVertices.emplace(v, static_cast<std::uint32_t>(vertices.size()));
-            if (inserted)
-                vertices.push_back(v);
-            indices.push_back(it->second);
-        }
-    };
-
     const size_t matCount = materials.size();
-    std::vector<MeshBuild> meshBuilds(matCount);
+    std::vector<VertexIndexer> meshBuilds(matCount);
 
     if (result.shapes.size() <= 1)
     {
@@ -264,9 +277,9 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_obj(const std::filesystem:
                     {
                         const Vertex v1 = makeVertex(shape.mesh.indices[indexOffset + v]);
                         const Vertex v2 = makeVertex(shape.mesh.indices[indexOffset + v + 1]);
-                        meshBuilds[static_cast<size_t>(matIdx)].addVertex(v0);
-                        meshBuilds[static_cast<size_t>(matIdx)].addVertex(v1);
-                        meshBuilds[static_cast<size_t>(matIdx)].addVertex(v2);
+                        meshBuilds[static_cast<size_t>(matIdx)].add(v0);
+                        meshBuilds[static_cast<size_t>(matIdx)].add(v1);
+                        meshBuilds[static_cast<size_t>(matIdx)].add(v2);
                     }
                 }
 
@@ -276,7 +289,7 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_obj(const std::filesystem:
     }
     else
     {
-        using MaterialMeshBuildMap = std::unordered_map<std::int32_t, MeshBuild>;
+        using MaterialMeshBuildMap = std::unordered_map<std::int32_t, VertexIndexer>;
         std::vector<MaterialMeshBuildMap> perShapeBuilds(result.shapes.size());
 
         auto build_shape_geometry = [&](size_t shapeIndex) {
@@ -318,9 +331,9 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_obj(const std::filesystem:
                     {
                         const Vertex v1 = makeVertex(shape.mesh.indices[indexOffset + v]);
                         const Vertex v2 = makeVertex(shape.mesh.indices[indexOffset + v + 1]);
-                        meshBuild.addVertex(v0);
-                        meshBuild.addVertex(v1);
-                        meshBuild.addVertex(v2);
+                        meshBuild.add(v0);
+                        meshBuild.add(v1);
+                        meshBuild.add(v2);
                     }
                 }
 
@@ -333,24 +346,14 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_obj(const std::filesystem:
         {
             taskflow.emplace([&, shapeIndex]() { build_shape_geometry(shapeIndex); });
         }
-        model_loader_executor().run(taskflow).wait();
-
-        for (auto& shapeBuilds : perShapeBuilds)
-        {
-            for (auto& [matIdx, localBuild] : shapeBuilds)
-            {
-                if (matIdx < 0 || static_cast<size_t>(matIdx) >= matCount)
-                    continue;
-
-                auto& mergedBuild = meshBuilds[static_cast<size_t>(matIdx)];
-                for (std::uint32_t localIndex : localBuild.indices)
-                {
-                    if (localIndex >= localBuild.vertices.size())
-                        continue;
-                    mergedBuild.addVertex(localBuild.vertices[localIndex]);
-                }
-            }
-        }
+        JobSystem::get().run_and_wait(taskflow);
+
+        meshBuilds = merge_material_builds(perShapeBuilds.size(), matCount,
+                                           [&](size_t shapeIndex, size_t matIdx) -> const VertexIndexer* {
+                                               const auto& shapeBuilds = perShapeBuilds[shapeIndex];
+                                               const auto it = shapeBuilds.find(static_cast<std::int32_t>(matIdx));
+                                               return it != shapeBuilds.end() ? &it->second : nullptr;
+                                           });
     }
 
     auto model = std::make_shared<ModelData>();
@@ -378,6 +381,7 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_obj(const std::filesystem:
         meshData.indices = std::move(meshBuilds[materialIndex].indices);
         meshData.compute_bounds();
         compute_tangents(meshData);
+        MeshOptimizer::optimize(meshData);
         builtMeshes[outputIndex] = std::move(meshData);
         builtMaterialIndices[outputIndex] = static_cast<std::int32_t>(materialIndex);
     };
@@ -389,7 +393,7 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_obj(const std::filesystem:
         {
             taskflow.emplace([&, outputIndex]() { build_submesh(outputIndex); });
         }
-        model_loader_executor().run(taskflow).wait();
+        JobSystem::get().run_and_wait(taskflow);
     }
     else if (!activeMaterialIndices.empty())
     {
@@ -398,6 +402,7 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_obj(const std::filesystem:
 
     model->meshes = std::move(builtMeshes);
     model->meshMaterialIndices = std::move(builtMaterialIndices);
+    assign_asset_ids(*model);
 
     if (model->meshes.empty())
         return make_error("Model has no valid geometry", ErrorCode::AssetInvalidData);
@@ -525,26 +530,10 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_fbx(const std::filesystem:
         materials.push_back(std::move(defaultMat));
     }
 
-    struct MeshBuild
-    {
-        std::vector<Vertex> vertices;
-        std::vector<std::uint32_t> indices;
-        std::unordered_map<Vertex, std::uint32_t> uniqueVertices;
-
-        void addVertex(const Vertex& v)
-        {
-            auto [it, inserted] = uniqueVertices.emplace(v, static_cast<std::uint32_t>(vertices.size()));
-            if (inserted)
-                vertices.push_back(v);
-            indices.push_back(it->second);
-        }
-    };
-
     const size_t matCount = materials.size();
-    std::vector<MeshBuild> meshBuilds(matCount);
 
     tf::Taskflow taskflow;
-    std::vector<std::vector<MeshBuild>> localBuilds(scene->nodes.count, std::vector<MeshBuild>(matCount));
+    std::vector<std::vector<VertexIndexer>> localBuilds(scene->nodes.count, std::vector<VertexIndexer>(matCount));
 
     for (size_t nodeIdx = 0; nodeIdx < scene->nodes.count; ++nodeIdx)
     {
@@ -615,23 +604,19 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_fbx(const std::filesystem:
                            v.texCoord = { (float)uv.x, 1.0f - (float)uv.y };
                       }
 
-                      build.addVertex(v);
+                      build.add(v);
                   }
              }
         });
     }
 
-    model_loader_executor().run(taskflow).wait();
+    JobSystem::get().run_and_wait(taskflow);
 
-    for (const auto& localNodeBuilds : localBuilds)
-    {
-         for (size_t m = 0; m < matCount; ++m)
-         {
-              for (uint32_t idx : localNodeBuilds[m].indices) {
-                  meshBuilds[m].addVertex(localNodeBuilds[m].vertices[idx]);
-              }
-         }
-    }
+    std::vector<VertexIndexer> meshBuilds =
+        merge_material_builds(localBuilds.size(), matCount, [&](size_t nodeIdx, size_t matIdx) -> const VertexIndexer* {
+            const VertexIndexer& build = localBuilds[nodeIdx][matIdx];
+            return build.indices.empty() ? nullptr : &build;
+        });
 
     ufbx_free_scene(scene);
 
@@ -660,6 +645,7 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_fbx(const std::filesystem:
         meshData.indices = std::move(meshBuilds[materialIndex].indices);
         meshData.compute_bounds();
         compute_tangents(meshData);
+        MeshOptimizer::optimize(meshData);
         builtMeshes[outputIndex] = std::move(meshData);
         builtMaterialIndices[outputIndex] = static_cast<std::int32_t>(materialIndex);
     };
@@ -671,7 +657,7 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_fbx(const std::filesystem:
         {
             taskflowMerge.emplace([&, outputIndex]() { build_submesh(outputIndex); });
         }
-        model_loader_executor().run(taskflowMerge).wait();
+        JobSystem::get().run_and_wait(taskflowMerge);
     }
     else if (!activeMaterialIndices.empty())
     {
@@ -680,6 +666,7 @@ Result<std::shared_ptr<ModelData>> ModelLoader::parse_fbx(const std::filesystem:
 
     model->meshes = std::move(builtMeshes);
     model->meshMaterialIndices = std::move(builtMaterialIndices);
+    assign_asset_ids(*model);
 
     if (model->meshes.empty())
         return make_error("Model has no valid geometry", ErrorCode::AssetInvalidData);
@@ -700,7 +687,7 @@ std::filesystem::path ModelLoader::get_cache_path(std::filesystem::path& sourceP
     return sourcePath;
 }
 
-Result<> ModelLoader::write_cache(const ModelData& model, const std::filesystem::path& cachePath)
+Result<> ModelLoader::write_cache(const ModelData& model, const std::filesystem::path& cachePath, bool compactVertices)
 {
     flatbuffers::FlatBufferBuilder fbb(4096);
 
@@ -710,18 +697,39 @@ Result<> ModelLoader::write_cache(const ModelData& model, const std::filesystem:
     for (const auto& mesh : model.meshes)
     {
         std::vector<fb::MVertexData> fbVerts;
-        fbVerts.reserve(mesh.vertices.size());
-        for (const auto& v : mesh.vertices)
+        std::vector<fb::MPackedVertexData> fbPackedVerts;
+        if (compactVertices)
         {
-            fbVerts.emplace_back(fb::MVec3(v.pos.x, v.pos.y, v.pos.z), fb::MVec3(v.normal.x, v.normal.y, v.normal.z),
-                                 fb::MVec2(v.texCoord.x, v.texCoord.y),
-                                 fb::MVec4(v.tangent.x, v.tangent.y, v.tangent.z, v.tangent.w));
+            fbPackedVerts.reserve(mesh.vertices.size());
+            for (const auto& v : mesh.vertices)
+            {
+                const PackedVertex p = PackedVertex::pack(v);
+                fbPackedVerts.emplace_back(fb::MVec3(p.pos.x, p.pos.y, p.pos.z), p.normal[0], p.normal[1], p.tangent[0],
+                                           p.tangent[1], p.texCoord[0], p.texCoord[1]);
+            }
+        }
+        else
+        {
+            fbVerts.reserve(mesh.vertices.size());
+            for (const auto& v : mesh.vertices)
+            {
+                fbVerts.emplace_back(fb::MVec3(v.pos.x, v.pos.y, v.pos.z), fb::MVec3(v.normal.x, v.normal.y, v.normal.z),
+                                     fb::MVec2(v.texCoord.x, v.texCoord.y),
+                                     fb::MVec4(v.tangent.x, v.tangent.y, v.tangent.z, v.tangent.w));
+            }
         }
 
         fb::MVec3 bMin(mesh.boundsMin.x, mesh.boundsMin.y, mesh.boundsMin.z);
         fb::MVec3 bMax(mesh.boundsMax.x, mesh.boundsMax.y, mesh.boundsMax.z);
 
-        meshOffsets.push_back(fb::CreateSubMeshAssetDirect(fbb, mesh.name.c_str(), &fbVerts, &mesh.indices, &bMin, &bMax));
+        std::vector<fb::MLodRange> fbLods;
+        fbLods.reserve(mesh.lods.size());
+        for (const auto& lod : mesh.lods)
+            fbLods.emplace_back(lod.firstIndex, lod.indexCount, lod.error);
+
+        meshOffsets.push_back(fb::CreateSubMeshAssetDirect(fbb, mesh.name.c_str(), compactVertices ? nullptr : &fbVerts,
+                                                           &mesh.indices, &bMin, &bMax, fbLods.empty() ? nullptr : &fbLods,
+                                                           compactVertices ? &fbPackedVerts : nullptr, mesh.id.value));
     }
 
     std::vector<flatbuffers::Offset<fb::MaterialEntry>> matOffsets;
@@ -749,7 +757,7 @@ Result<> ModelLoader::write_cache(const ModelData& model, const std::filesystem:
 
     const std::string modelSourcePath = model.sourcePath.generic_string();
     auto asset = fb::CreateModelAssetDirect(fbb, model.name.c_str(), modelSourcePath.c_str(), &meshOffsets,
-                                            &matOffsets, &model.meshMaterialIndices);
+                                            &matOffsets, &model.meshMaterialIndices, model.id.value);
 
     fb::FinishModelAssetBuffer(fbb, asset);
 
@@ -765,27 +773,26 @@ Result<> ModelLoader::write_cache(const ModelData& model, const std::filesystem:
     return {};
 }
 
+// MVertexData is stored exactly like Vertex, so full-float vertex arrays are copied in bulk.
+static_assert(FLATBUFFERS_LITTLEENDIAN, "cached vertex data is read in place");
+static_assert(sizeof(fb::MVertexData) == sizeof(Vertex));
+static_assert(offsetof(Vertex, normal) == 3 * sizeof(float) && offsetof(Vertex, texCoord) == 6 * sizeof(float) &&
+              offsetof(Vertex, tangent) == 8 * sizeof(float));
+
 Result<std::shared_ptr<ModelData>> ModelLoader::read_cache(const std::filesystem::path& cachePath)
 {
-    std::ifstream file(cachePath, std::ios::binary | std::ios::ate);
-    if (!file.is_open())
-        return make_error(fmt::format("Failed to open model cache: {}", cachePath.string()), ErrorCode::AssetCacheReadFailed);
-
-    auto fileSize = file.tellg();
-    if (fileSize <= 0)
-        return make_error(fmt::format("Model cache file is empty: {}", cachePath.string()),
-                          ErrorCode::AssetCacheReadFailed);
-
-    file.seekg(0, std::ios::beg);
-    std::vector<std::uint8_t> buffer(static_cast<size_t>(fileSize));
-    file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+    NOC_PROFILE_ZONE("ModelLoader::read_cache");
+    // Verified and read in place from the mapping; only the final arrays are allocated.
+    auto mapped = VirtualFileSystem::get().open(cachePath);
+    if (!mapped)
+        return make_error(fmt::format("Failed to map model cache: {}", cachePath.string()), ErrorCode::AssetCacheReadFailed);
 
-    flatbuffers::Verifier verifier(buffer.data(), buffer.size());
+    flatbuffers::Verifier verifier(mapped->data(), mapped->size());
     if (!fb::VerifyModelAssetBuffer(verifier))
         return make_error(fmt::format("Model cache verification failed: {}", cachePath.string()),
                           ErrorCode::AssetCacheReadFailed);
 
-    const auto* asset = fb::GetModelAsset(buffer.data());
+    const auto* asset = fb::GetModelAsset(mapped->data());
     if (!asset)
         return make_error(fmt::format("Failed to deserialize model cache: {}", cachePath.string()),
                           ErrorCode::AssetCacheReadFailed);
@@ -796,6 +803,10 @@ Result<std::shared_ptr<ModelData>> ModelLoader::read_cache(const std::filesystem
         model->name = asset->name()->str();
     if (asset->source_path())
         model->sourcePath = asset->source_path()->str();
+    // Caches written before ids existed get the id their import would have assigned.
+    model->id = AssetId{asset->asset_id()};
+    if (!model->id.is_valid())
+        model->id = AssetId::from_path(model->sourcePath.empty() ? cachePath : model->sourcePath);
 
     if (asset->materials())
     {
@@ -838,25 +849,48 @@ Result<std::shared_ptr<ModelData>> ModelLoader::read_cache(const std::filesystem
             MeshData meshData;
             if (subMesh->name())
                 meshData.name = subMesh->name()->str();
+            meshData.id = AssetId{subMesh->asset_id()};
+            if (!meshData.id.is_valid())
+                meshData.id = model->id.child(meshData.name);
 
-            if (subMesh->vertices())
+            if (subMesh->packed_vertices())
             {
-                meshData.vertices.reserve(subMesh->vertices()->size());
-                for (const auto* v : *subMesh->vertices())
+                meshData.vertices.reserve(subMesh->packed_vertices()->size());
+                for (const auto* v : *subMesh->packed_vertices())
                 {
-                    Vertex vert{};
-                    vert.pos = {v->position().x(), v->position().y(), v->position().z()};
-                    vert.normal = {v->normal().x(), v->normal().y(), v->normal().z()};
-                    vert.texCoord = {v->tex_coord().x(), v->tex_coord().y()};
-                    vert.tangent = {v->tangent().x(), v->tangent().y(), v->tangent().z(), v->tangent().w()};
-                    meshData.vertices.push_back(vert);
+                    PackedVertex packed{};
+                    packed.pos = {v->position().x(), v->position().y(), v->position().z()};
+                    packed.normal[0] = v->normal_x();
+                    packed.normal[1] = v->normal_y();
+                    packed.tangent[0] = v->tangent_x();
+                    packed.tangent[1] = v->tangent_y();
+                    packed.texCoord[0] = v->u();
+                    packed.texCoord[1] = v->v();
+                    meshData.vertices.push_back(packed.unpack());
                 }
             }
+            else if (const auto* vertices = subMesh->vertices(); vertices && vertices->size() > 0)
+            {
+                meshData.vertices.resize(vertices->size());
+                std::memcpy(meshData.vertices.data(), vertices->Data(), vertices->size() * sizeof(Vertex));
+            }
 
-            if (subMesh->indices())
+            if (const auto* indices = subMesh->indices(); indices && indices->size() > 0)
             {
-                const auto* idxVec = subMesh->indices();
-                meshData.indices.assign(idxVec->begin(), idxVec->end());
+                meshData.indices.resize(indices->size());
+                std::memcpy(meshData.indices.data(), indices->Data(), indices->size() * sizeof(std::uint32_t));
+            }
+
+            if (subMesh->lods())
+            {
+                meshData.lods.reserve(subMesh->lods()->size());
+                for (const auto* lod : *subMesh->lods())
+                {
+                    // Ranges outside the index data would read past the buffer on the GPU; keep the valid prefix.
+                    if (static_cast<std::uint64_t>(lod->first_index()) + lod->index_count() > meshData.indices.size())
+                        break;
+                    meshData.lods.push_back(MeshLod{lod->first_index(), lod->index_count(), lod->error()});
+                }
             }
 
             if (subMesh->bounds_min())
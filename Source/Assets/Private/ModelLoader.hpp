@@ -27,6 +27,9 @@ struct NOC_EXPORT ModelLoader
     /// Returns nullptr on failure (EnTT cache convention).
     result_type operator()(const std::filesystem::path& path) const;
 
+    /// Adopt a model parsed elsewhere (e.g. on a streaming worker) without copying it.
+    result_type operator()(std::shared_ptr<ModelData> model) const;
+
     /// Load with full error reporting (dispatches to parse_obj or parse_fbx).
     static Result<std::shared_ptr<ModelData>> parse_model(const std::filesystem::path& path);
 
@@ -38,9 +41,13 @@ struct NOC_EXPORT ModelLoader
 
     /// Serialize ModelData to a FlatBuffer binary cache file (.noc_model).
     /// Texture paths stored in materials should already be project-relative.
-    static Result<> write_cache(const ModelData& model, const std::filesystem::path& cachePath);
+    /// With `compactVertices`, vertices are stored in the 24-byte PackedVertex encoding
+    /// (the GPU layout) instead of full floats; read_cache() expands them back.
+    static Result<> write_cache(const ModelData& model, const std::filesystem::path& cachePath,
+                                bool compactVertices = false);
 
     /// Deserialize ModelData from a FlatBuffer binary cache file (.noc_model).
+    /// Accepts both the full-float and the packed vertex encoding.
     static Result<std::shared_ptr<ModelData>> read_cache(const std::filesystem::path& cachePath);
 
     /// Returns the cache file path for a given source path.
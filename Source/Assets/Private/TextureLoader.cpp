@@ -1,12 +1,73 @@
 #include "TextureLoader.hpp"
+#include "TextureProcessor.hpp"
+#include "../../Core/Public/Profiler.hpp"
+#include "../../Core/Public/VirtualFileSystem.hpp"
 
 #include <fmt/core.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <TextureAsset_generated.h>
+#include <flatbuffers/flatbuffers.h>
+
 #include <cstdint>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+
+namespace
+{
+namespace fb = NatureOfCraft::Assets;
+
+fb::TextureFormat to_fb_format(TexturePixelFormat format) noexcept
+{
+    switch (format)
+    {
+    case TexturePixelFormat::BC4:
+        return fb::TextureFormat_BC4;
+    case TexturePixelFormat::BC5:
+        return fb::TextureFormat_BC5;
+    case TexturePixelFormat::BC7:
+        return fb::TextureFormat_BC7;
+    case TexturePixelFormat::RGBA8:
+    default:
+        return fb::TextureFormat_RGBA8;
+    }
+}
+
+Result<TexturePixelFormat> from_fb_format(fb::TextureFormat format)
+{
+    switch (format)
+    {
+    case fb::TextureFormat_RGBA8:
+        return TexturePixelFormat::RGBA8;
+    case fb::TextureFormat_BC4:
+        return TexturePixelFormat::BC4;
+    case fb::TextureFormat_BC5:
+        return TexturePixelFormat::BC5;
+    case fb::TextureFormat_BC7:
+        return TexturePixelFormat::BC7;
+    default:
+        return make_error(fmt::format("Unsupported cached texture format: {}", fb::EnumNameTextureFormat(format)),
+                          ErrorCode::AssetCacheReadFailed);
+    }
+}
+} // namespace
+
+std::filesystem::path TextureLoader::get_cache_path(const std::filesystem::path& sourcePath)
+{
+    std::filesystem::path cachePath = sourcePath;
+    cachePath.replace_extension(".noc_texture");
+    return cachePath;
+}
+
+bool TextureLoader::exists(const std::filesystem::path& path)
+{
+    const VirtualFileSystem& vfs = VirtualFileSystem::get();
+    return vfs.exists(path) || vfs.exists(get_cache_path(path));
+}
 
 TextureLoader::result_type TextureLoader::operator()(const std::filesystem::path& path) const
 {
@@ -24,9 +85,48 @@ TextureLoader::result_type TextureLoader::operator()(const TextureData& data) co
     return std::make_shared<TextureData>(data);
 }
 
+TextureLoader::result_type TextureLoader::operator()(std::shared_ptr<TextureData> data) const
+{
+    return data;
+}
+
 Result<std::shared_ptr<TextureData>> TextureLoader::load_image(const std::filesystem::path& path)
 {
-    if (!std::filesystem::exists(path))
+    NOC_PROFILE_ZONE("TextureLoader::load_image");
+    // Cook-generated textures (e.g. packed ORM maps) have no source image; the sidecar is the asset.
+    if (path.extension() == ".noc_texture")
+    {
+        auto cached = read_cache(path);
+        if (cached)
+            cached.value()->sourcePath = path;
+        return cached;
+    }
+
+    const std::filesystem::path cachePath = get_cache_path(path);
+    std::error_code ec;
+    if (VirtualFileSystem::get().exists(cachePath))
+    {
+        const bool sourceExists = std::filesystem::exists(path, ec);
+        if (!sourceExists || std::filesystem::last_write_time(cachePath, ec) >= std::filesystem::last_write_time(path, ec))
+        {
+            auto cached = read_cache(cachePath);
+            if (cached)
+            {
+                cached.value()->sourcePath = path;
+                return cached;
+            }
+            fmt::print("Warning: Texture cache read failed, decoding source: {}\n", cached.error().message);
+        }
+    }
+
+    return decode_image(path);
+}
+
+Result<std::shared_ptr<TextureData>> TextureLoader::decode_image(const std::filesystem::path& path, TextureUsage usage)
+{
+    NOC_PROFILE_ZONE("TextureLoader::decode_image");
+    auto fileResult = VirtualFileSystem::get().open(path);
+    if (!fileResult)
     {
         return make_error(fmt::format("Texture file not found: {}", path.string()), ErrorCode::AssetFileNotFound);
     }
@@ -36,7 +136,8 @@ Result<std::shared_ptr<TextureData>> TextureLoader::load_image(const std::filesy
     std::int32_t channelsInFile = 0;
     constexpr std::int32_t desiredChannels = 4;
 
-    stbi_uc* pixels = stbi_load(path.string().c_str(), &width, &height, &channelsInFile, desiredChannels);
+    stbi_uc* pixels = stbi_load_from_memory(fileResult->data(), static_cast<int>(fileResult->size()), &width, &height,
+                                            &channelsInFile, desiredChannels);
     if (!pixels)
     {
         return make_error(fmt::format("stb_image failed to load '{}': {}", path.string(), stbi_failure_reason()),
@@ -55,5 +156,103 @@ Result<std::shared_ptr<TextureData>> TextureLoader::load_image(const std::filesy
 
     stbi_image_free(pixels);
 
+    if (auto mipResult = TextureProcessor::generate_mips(*texture, usage); !mipResult)
+        return make_error(mipResult.error());
+
+    return texture;
+}
+
+Result<> TextureLoader::write_cache(const TextureData& texture, const std::filesystem::path& cachePath)
+{
+    const std::span<const std::uint8_t> pixels = texture.pixel_bytes();
+    flatbuffers::FlatBufferBuilder builder(pixels.size() + 1024);
+
+    std::vector<fb::TextureMip> fbMips{};
+    if (texture.mips.empty())
+    {
+        fbMips.emplace_back(texture.width, texture.height, 0, static_cast<std::uint64_t>(pixels.size()));
+    }
+    else
+    {
+        fbMips.reserve(texture.mips.size());
+        for (const TextureMipLevel& mip : texture.mips)
+            fbMips.emplace_back(mip.width, mip.height, mip.offset, mip.size);
+    }
+
+    const std::string sourcePath = texture.sourcePath.generic_string();
+    const auto nameOffset = builder.CreateString(texture.name);
+    const auto sourcePathOffset = builder.CreateString(sourcePath);
+    const auto dataOffset = builder.CreateVector(pixels.data(), pixels.size());
+    const auto mipsOffset = builder.CreateVectorOfStructs(fbMips);
+    auto textureAsset = fb::CreateTextureAsset(builder, nameOffset, sourcePathOffset, texture.width, texture.height,
+                                               texture.channels, to_fb_format(texture.format), dataOffset, mipsOffset);
+
+    fb::FinishTextureAssetBuffer(builder, textureAsset);
+
+    std::ofstream file(cachePath, std::ios::binary);
+    if (!file.is_open())
+        return make_error(fmt::format("Failed to open cache file for writing: {}", cachePath.string()),
+                          ErrorCode::AssetCacheWriteFailed);
+
+    file.write(reinterpret_cast<const char*>(builder.GetBufferPointer()), builder.GetSize());
+    if (!file.good())
+        return make_error(fmt::format("Failed to write cache file: {}", cachePath.string()), ErrorCode::AssetCacheWriteFailed);
+
+    return {};
+}
+
+Result<std::shared_ptr<TextureData>> TextureLoader::read_cache(const std::filesystem::path& cachePath)
+{
+    NOC_PROFILE_ZONE("TextureLoader::read_cache");
+    // Verified in place; the texture keeps the mapping (loose file or archive) instead of a copy.
+    auto file = VirtualFileSystem::get().open(cachePath);
+    if (!file)
+        return make_error(fmt::format("Failed to open cache file: {}", cachePath.string()), ErrorCode::AssetCacheReadFailed);
+
+    flatbuffers::Verifier verifier(file->data(), file->size());
+    if (!fb::VerifyTextureAssetBuffer(verifier))
+        return make_error(fmt::format("Cache file verification failed: {}", cachePath.string()),
+                          ErrorCode::AssetCacheReadFailed);
+
+    const auto* textureAsset = fb::GetTextureAsset(file->data());
+    if (!textureAsset || !textureAsset->data())
+        return make_error(fmt::format("Failed to deserialize cache file: {}", cachePath.string()),
+                          ErrorCode::AssetCacheReadFailed);
+
+    auto format = from_fb_format(textureAsset->format());
+    if (!format)
+        return make_error(format.error());
+
+    auto texture = std::make_shared<TextureData>();
+    if (textureAsset->name())
+        texture->name = textureAsset->name()->str();
+    if (textureAsset->source_path())
+        texture->sourcePath = textureAsset->source_path()->str();
+    texture->width = textureAsset->width();
+    texture->height = textureAsset->height();
+    texture->channels = textureAsset->channels();
+    texture->format = format.value();
+
+    // The payload stays in the mapping until upload copies it into the staging buffer.
+    const auto* data = textureAsset->data();
+    texture->mappedPixels = std::span<const std::uint8_t>{data->data(), data->size()};
+    texture->mappedSource = std::make_shared<const FileView>(std::move(file.value()));
+
+    if (textureAsset->mips())
+    {
+        texture->mips.reserve(textureAsset->mips()->size());
+        for (const auto* mip : *textureAsset->mips())
+        {
+            if (mip->offset() + mip->size() > texture->mappedPixels.size())
+                return make_error(fmt::format("Cache file mip range out of bounds: {}", cachePath.string()),
+                                  ErrorCode::AssetCacheReadFailed);
+            texture->mips.push_back(TextureMipLevel{mip->width(), mip->height(), mip->offset(), mip->size()});
+        }
+    }
+
+    if (texture->mips.empty() && texture->format != TexturePixelFormat::RGBA8)
+        return make_error(fmt::format("Compressed cache file has no mip table: {}", cachePath.string()),
+                          ErrorCode::AssetCacheReadFailed);
+
     return texture;
 }
@@ -2,14 +2,18 @@
 #include "../../Core/Public/Expected.hpp"
 #include "../Public/TextureData.hpp"
 
+#include <filesystem>
 #include <memory>
 #include <string_view>
 
-/// Loads texture pixel data from image files (PNG, JPG, TGA, BMP, etc.) via stb_image.
+/// Loads texture pixel data from image files (PNG, JPG, TGA, BMP, etc.) via stb_image,
+/// preferring a cooked FlatBuffer sidecar (.noc_texture) when one is up to date.
 /// Conforms to the EnTT resource_cache loader concept:
 ///   operator()(args...) -> shared_ptr<TextureData>
 ///
-/// All images are forced to RGBA8 (4 channels) regardless of source format.
+/// Cooked sidecars carry a ready-to-upload mip chain, block-compressed (BC4/BC5/BC7) or RGBA8,
+/// so loading them decodes nothing. Raw images are forced to RGBA8 (4 channels) and get a
+/// box-filtered mip chain generated on load.
 ///
 /// Usage with entt::resource_cache:
 ///   entt::resource_cache<TextureData, TextureLoader> cache;
@@ -19,13 +23,37 @@ struct NOC_EXPORT TextureLoader
     using result_type = std::shared_ptr<TextureData>;
 
     /// Load a texture from the given file path.
-    /// Forces RGBA8 output (4 channels, 8 bits per channel).
     /// Returns nullptr on failure (EnTT cache convention — load silently fails).
     result_type operator()(const std::filesystem::path& path) const;
 
     /// Wrap pre-built TextureData into a shared_ptr (for programmatic textures).
     result_type operator()(const TextureData& data) const;
 
+    /// Adopt TextureData decoded elsewhere (e.g. on a streaming worker) without copying it.
+    result_type operator()(std::shared_ptr<TextureData> data) const;
+
     /// Load a texture with full error reporting.
+    /// Uses the .noc_texture sidecar when it is at least as new as the source image;
+    /// a path that already names a .noc_texture is read directly.
     static Result<std::shared_ptr<TextureData>> load_image(const std::filesystem::path& path);
+
+    /// Decode the source image to RGBA8 with a generated mip chain (ignores any sidecar).
+    /// `usage` selects the mip filter (normal maps are renormalized per level).
+    static Result<std::shared_ptr<TextureData>> decode_image(const std::filesystem::path& path,
+                                                             TextureUsage usage = TextureUsage::Color);
+
+    /// Serialize TextureData (every mip level) to a FlatBuffer binary cache file.
+    static Result<> write_cache(const TextureData& texture, const std::filesystem::path& cachePath);
+
+    /// Deserialize TextureData from a FlatBuffer binary cache file. The pixel payload is not copied:
+    /// the result views it through `mappedPixels` and keeps the file mapped until release_pixels().
+    static Result<std::shared_ptr<TextureData>> read_cache(const std::filesystem::path& cachePath);
+
+    /// True when load_image can load `path`: the image itself or its cooked sidecar exists.
+    /// Packed bundles ship only the sidecar of a cooked image.
+    static bool exists(const std::filesystem::path& path);
+
+    /// Returns the cache file path for a given source path.
+    /// e.g. "Assets/Textures/Rock.png" -> "Assets/Textures/Rock.noc_texture"
+    static std::filesystem::path get_cache_path(const std::filesystem::path& sourcePath);
 };
@@ -0,0 +1,545 @@
+#include "TextureProcessor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <fmt/core.h>
+
+namespace
+{
+using Texel = std::array<std::uint8_t, 4>;
+using Block = std::array<Texel, 16>;
+
+/// Little-endian bit packer for a single 128-bit BC block.
+struct BlockWriter
+{
+    std::uint64_t lo{};
+    std::uint64_t hi{};
+    std::uint32_t bit{};
+
+    void write(std::uint32_t value, std::uint32_t count) noexcept
+    {
+        for (std::uint32_t i = 0; i < count; ++i, ++bit)
+        {
+            const std::uint64_t b = (value >> i) & 1u;
+            if (bit < 64)
+                lo |= b << bit;
+            else
+                hi |= b << (bit - 64);
+        }
+    }
+
+    void store(std::uint8_t* out) const noexcept
+    {
+        for (std::uint32_t i = 0; i < 8; ++i)
+        {
+            out[i] = static_cast<std::uint8_t>(lo >> (i * 8));
+            out[i + 8] = static_cast<std::uint8_t>(hi >> (i * 8));
+        }
+    }
+};
+
+/// Gathers the 4x4 block at (bx, by), clamping reads at the level edge.
+Block gather_block(const std::uint8_t* level, std::uint32_t width, std::uint32_t height, std::uint32_t bx,
+                   std::uint32_t by) noexcept
+{
+    Block block{};
+    for (std::uint32_t y = 0; y < 4; ++y)
+    {
+        const std::uint32_t sy = std::min(by * 4 + y, height - 1);
+        for (std::uint32_t x = 0; x < 4; ++x)
+        {
+            const std::uint32_t sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block[y * 4 + x].data(), level + (static_cast<std::size_t>(sy) * width + sx) * 4, 4);
+        }
+    }
+    return block;
+}
+
+/// BC4: two 8-bit endpoints and 3-bit indices into the 8-value interpolated palette.
+void encode_bc4(const Block& block, std::uint32_t channel, std::uint8_t* out) noexcept
+{
+    std::uint8_t minValue = 255;
+    std::uint8_t maxValue = 0;
+    for (const Texel& texel : block)
+    {
+        minValue = std::min(minValue, texel[channel]);
+        maxValue = std::max(maxValue, texel[channel]);
+    }
+
+    out[0] = maxValue;
+    out[1] = minValue;
+    std::uint64_t indices = 0;
+
+    if (maxValue != minValue)
+    {
+        std::array<std::int32_t, 8> palette{};
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for (std::int32_t i = 2; i < 8; ++i)
+            palette[i] = ((8 - i) * maxValue + (i - 1) * minValue) / 7;
+
+        for (std::uint32_t t = 0; t < 16; ++t)
+        {
+            const std::int32_t value = block[t][channel];
+            std::uint64_t best = 0;
+            std::int32_t bestError = std::numeric_limits<std::int32_t>::max();
+            for (std::uint32_t i = 0; i < 8; ++i)
+            {
+                const std::int32_t error = std::abs(palette[i] - value);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = i;
+                }
+            }
+            indices |= best << (t * 3);
+        }
+    }
+
+    for (std::uint32_t i = 0; i < 6; ++i)
+        out[2 + i] = static_cast<std::uint8_t>(indices >> (i * 8));
+}
+
+constexpr std::array<std::int32_t, 16> Bc7Weights4{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/// Quantizes an endpoint to BC7 mode 6 precision (7 bits per channel plus a shared p-bit),
+/// picking the p-bit that reconstructs it best.
+void quantize_bc7_endpoint(const std::array<float, 4>& endpoint, std::array<std::int32_t, 4>& outQuantized,
+                           std::int32_t& outPBit) noexcept
+{
+    float bestError = std::numeric_limits<float>::max();
+    for (std::int32_t p = 0; p < 2; ++p)
+    {
+        std::array<std::int32_t, 4> quantized{};
+        float error = 0.0f;
+        for (std::uint32_t c = 0; c < 4; ++c)
+        {
+            const float v = std::clamp(endpoint[c], 0.0f, 255.0f);
+            quantized[c] = std::clamp(static_cast<std::int32_t>(std::lround((v - static_cast<float>(p)) * 0.5f)), 0, 127);
+            const float d = static_cast<float>((quantized[c] << 1) | p) - v;
+            error += d * d;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            outQuantized = quantized;
+            outPBit = p;
+        }
+    }
+}
+
+struct Bc7Candidate
+{
+    std::array<std::int32_t, 4> q0{};
+    std::array<std::int32_t, 4> q1{};
+    std::int32_t p0{};
+    std::int32_t p1{};
+    std::array<std::uint32_t, 16> indices{};
+    std::int64_t error{};
+};
+
+/// Quantizes both endpoints and picks the closest palette entry for every texel.
+Bc7Candidate fit_bc7_candidate(const Block& block, const std::array<float, 4>& endpoint0,
+                               const std::array<float, 4>& endpoint1) noexcept
+{
+    Bc7Candidate candidate{};
+    quantize_bc7_endpoint(endpoint0, candidate.q0, candidate.p0);
+    quantize_bc7_endpoint(endpoint1, candidate.q1, candidate.p1);
+
+    std::array<std::array<std::int32_t, 4>, 16> palette{};
+    for (std::uint32_t i = 0; i < 16; ++i)
+    {
+        for (std::uint32_t c = 0; c < 4; ++c)
+        {
+            const std::int32_t e0 = (candidate.q0[c] << 1) | candidate.p0;
+            const std::int32_t e1 = (candidate.q1[c] << 1) | candidate.p1;
+            palette[i][c] = ((64 - Bc7Weights4[i]) * e0 + Bc7Weights4[i] * e1 + 32) >> 6;
+        }
+    }
+
+    for (std::uint32_t t = 0; t < 16; ++t)
+    {
+        std::int32_t bestError = std::numeric_limits<std::int32_t>::max();
+        for (std::uint32_t i = 0; i < 16; ++i)
+        {
+            std::int32_t error = 0;
+            for (std::uint32_t c = 0; c < 4; ++c)
+            {
+                const std::int32_t d = palette[i][c] - block[t][c];
+                error += d * d;
+            }
+            if (error < bestError)
+            {
+                bestError = error;
+                candidate.indices[t] = i;
+            }
+        }
+        candidate.error += bestError;
+    }
+    return candidate;
+}
+
+/// BC7 mode 6: one subset, RGBA endpoints along the block's principal axis, 4-bit indices.
+void encode_bc7(const Block& block, std::uint8_t* out) noexcept
+{
+    std::array<float, 4> mean{};
+    for (const Texel& texel : block)
+        for (std::uint32_t c = 0; c < 4; ++c)
+            mean[c] += texel[c];
+    for (float& m : mean)
+        m /= 16.0f;
+
+    std::array<std::array<float, 4>, 4> covariance{};
+    for (const Texel& texel : block)
+    {
+        std::array<float, 4> d{};
+        for (std::uint32_t c = 0; c < 4; ++c)
+            d[c] = texel[c] - mean[c];
+        for (std::uint32_t i = 0; i < 4; ++i)
+            for (std::uint32_t j = 0; j < 4; ++j)
+                covariance[i][j] += d[i] * d[j];
+    }
+
+    // Power iteration for the dominant eigenvector.
+    std::array<float, 4> axis{1.0f, 1.0f, 1.0f, 1.0f};
+    for (std::uint32_t iteration = 0; iteration < 8; ++iteration)
+    {
+        std::array<float, 4> next{};
+        for (std::uint32_t i = 0; i < 4; ++i)
+            for (std::uint32_t j = 0; j < 4; ++j)
+                next[i] += covariance[i][j] * axis[j];
+        const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2] + next[3] * next[3]);
+        if (length < 1e-6f)
+            break;
+        for (std::uint32_t c = 0; c < 4; ++c)
+            axis[c] = next[c] / length;
+    }
+
+    float minT = std::numeric_limits<float>::max();
+    float maxT = std::numeric_limits<float>::lowest();
+    for (const Texel& texel : block)
+    {
+        float t = 0.0f;
+        for (std::uint32_t c = 0; c < 4; ++c)
+            t += (texel[c] - mean[c]) * axis[c];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    std::array<float, 4> endpoint0{};
+    std::array<float, 4> endpoint1{};
+    for (std::uint32_t c = 0; c < 4; ++c)
+    {
+        endpoint0[c] = mean[c] + axis[c] * minT;
+        endpoint1[c] = mean[c] + axis[c] * maxT;
+    }
+
+    Bc7Candidate best = fit_bc7_candidate(block, endpoint0, endpoint1);
+
+    // Least-squares refinement: re-solve the endpoints against the chosen weights.
+    for (std::uint32_t iteration = 0; iteration < 2; ++iteration)
+    {
+        float w00 = 0.0f;
+        float w01 = 0.0f;
+        float w11 = 0.0f;
+        std::array<float, 4> x0{};
+        std::array<float, 4> x1{};
+        for (std::uint32_t t = 0; t < 16; ++t)
+        {
+            const float w = Bc7Weights4[best.indices[t]] / 64.0f;
+            w00 += (1.0f - w) * (1.0f - w);
+            w01 += (1.0f - w) * w;
+            w11 += w * w;
+            for (std::uint32_t c = 0; c < 4; ++c)
+            {
+                x0[c] += (1.0f - w) * block[t][c];
+                x1[c] += w * block[t][c];
+            }
+        }
+
+        const float determinant = w00 * w11 - w01 * w01;
+        if (std::abs(determinant) < 1e-6f)
+            break;
+
+        for (std::uint32_t c = 0; c < 4; ++c)
+        {
+            endpoint0[c] = (w11 * x0[c] - w01 * x1[c]) / determinant;
+            endpoint1[c] = (w00 * x1[c] - w01 * x0[c]) / determinant;
+        }
+
+        const Bc7Candidate refined = fit_bc7_candidate(block, endpoint0, endpoint1);
+        if (refined.error >= best.error)
+            break;
+        best = refined;
+    }
+
+    std::array<std::int32_t, 4>& q0 = best.q0;
+    std::array<std::int32_t, 4>& q1 = best.q1;
+    std::int32_t& p0 = best.p0;
+    std::int32_t& p1 = best.p1;
+    std::array<std::uint32_t, 16>& indices = best.indices;
+
+    // The anchor texel's index is stored without its top bit; swap endpoints so it is clear.
+    // The weight table is symmetric, so mirroring the indices reproduces the same palette.
+    if (indices[0] >= 8)
+    {
+        std::swap(q0, q1);
+        std::swap(p0, p1);
+        for (std::uint32_t& index : indices)
+            index = 15u - index;
+    }
+
+    BlockWriter writer{};
+    writer.write(1u << 6, 7); // mode 6
+    for (std::uint32_t c = 0; c < 4; ++c)
+    {
+        writer.write(static_cast<std::uint32_t>(q0[c]), 7);
+        writer.write(static_cast<std::uint32_t>(q1[c]), 7);
+    }
+    writer.write(static_cast<std::uint32_t>(p0), 1);
+    writer.write(static_cast<std::uint32_t>(p1), 1);
+    writer.write(indices[0], 3);
+    for (std::uint32_t t = 1; t < 16; ++t)
+        writer.write(indices[t], 4);
+    writer.store(out);
+}
+
+std::uint32_t block_bytes(TexturePixelFormat format) noexcept
+{
+    switch (format)
+    {
+    case TexturePixelFormat::BC4:
+        return 8;
+    case TexturePixelFormat::BC5:
+    case TexturePixelFormat::BC7:
+        return 16;
+    case TexturePixelFormat::RGBA8:
+    default:
+        return 4;
+    }
+}
+} // namespace
+
+TexturePixelFormat TextureProcessor::compressed_format_for(TextureUsage usage) noexcept
+{
+    switch (usage)
+    {
+    case TextureUsage::Normal:
+        return TexturePixelFormat::BC5;
+    case TextureUsage::Mask:
+        return TexturePixelFormat::BC4;
+    case TextureUsage::Color:
+    default:
+        return TexturePixelFormat::BC7;
+    }
+}
+
+bool TextureProcessor::is_block_compressed(TexturePixelFormat format) noexcept
+{
+    return format != TexturePixelFormat::RGBA8;
+}
+
+std::uint64_t TextureProcessor::level_size(TexturePixelFormat format, std::uint32_t width, std::uint32_t height) noexcept
+{
+    if (!is_block_compressed(format))
+        return static_cast<std::uint64_t>(width) * height * 4;
+
+    const std::uint64_t blocksX = (width + 3) / 4;
+    const std::uint64_t blocksY = (height + 3) / 4;
+    return blocksX * blocksY * block_bytes(format);
+}
+
+Result<> TextureProcessor::generate_mips(TextureData& texture, TextureUsage usage)
+{
+    if (texture.format != TexturePixelFormat::RGBA8)
+        return make_error("Mip generation requires an uncompressed RGBA8 texture", ErrorCode::AssetInvalidData);
+    if (texture.mips.size() > 1)
+        return {};
+    if (texture.width == 0 || texture.height == 0)
+        return make_error(fmt::format("Texture '{}' has zero size", texture.name), ErrorCode::AssetInvalidData);
+
+    const std::uint64_t baseSize = level_size(TexturePixelFormat::RGBA8, texture.width, texture.height);
+    if (texture.pixels.size() < baseSize)
+        return make_error(fmt::format("Texture '{}' pixel buffer is smaller than its dimensions", texture.name),
+                          ErrorCode::AssetInvalidData);
+
+    std::vector<TextureMipLevel> mips{};
+    std::uint64_t totalSize = 0;
+    for (std::uint32_t w = texture.width, h = texture.height;; w = std::max(1u, w / 2), h = std::max(1u, h / 2))
+    {
+        const std::uint64_t size = level_size(TexturePixelFormat::RGBA8, w, h);
+        mips.push_back(TextureMipLevel{w, h, totalSize, size});
+        totalSize += size;
+        if (w == 1 && h == 1)
+            break;
+    }
+
+    texture.pixels.resize(totalSize);
+    std::uint8_t* data = texture.pixels.data();
+
+    for (std::size_t level = 1; level < mips.size(); ++level)
+    {
+        const TextureMipLevel& src = mips[level - 1];
+        const TextureMipLevel& dst = mips[level];
+        const std::uint8_t* srcPixels = data + src.offset;
+        std::uint8_t* dstPixels = data + dst.offset;
+
+        for (std::uint32_t y = 0; y < dst.height; ++y)
+        {
+            const std::uint32_t y0 = std::min(y * 2, src.height - 1);
+            const std::uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+            for (std::uint32_t x = 0; x < dst.width; ++x)
+            {
+                const std::uint32_t x0 = std::min(x * 2, src.width - 1);
+                const std::uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+                const std::uint8_t* taps[4] = {
+                    srcPixels + (static_cast<std::size_t>(y0) * src.width + x0) * 4,
+                    srcPixels + (static_cast<std::size_t>(y0) * src.width + x1) * 4,
+                    srcPixels + (static_cast<std::size_t>(y1) * src.width + x0) * 4,
+                    srcPixels + (static_cast<std::size_t>(y1) * src.width + x1) * 4,
+                };
+                std::uint8_t* out = dstPixels + (static_cast<std::size_t>(y) * dst.width + x) * 4;
+
+                for (std::uint32_t c = 0; c < 4; ++c)
+                    out[c] = static_cast<std::uint8_t>((taps[0][c] + taps[1][c] + taps[2][c] + taps[3][c] + 2) / 4);
+
+                if (usage == TextureUsage::Normal)
+                {
+                    float n[3]{};
+                    for (std::uint32_t c = 0; c < 3; ++c)
+                        n[c] = out[c] / 255.0f * 2.0f - 1.0f;
+                    const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+                    if (length > 1e-6f)
+                    {
+                        for (std::uint32_t c = 0; c < 3; ++c)
+                            out[c] = static_cast<std::uint8_t>(
+                                std::clamp(std::lround((n[c] / length * 0.5f + 0.5f) * 255.0f), 0l, 255l));
+                    }
+                }
+            }
+        }
+    }
+
+    texture.mips = std::move(mips);
+    return {};
+}
+
+Result<TextureData> TextureProcessor::pack_orm(const TextureData* ao, const TextureData* roughness,
+                                               const TextureData* metallic)
+{
+    const std::array<const TextureData*, 3> sources{ao, roughness, metallic};
+    constexpr std::array<std::uint8_t, 3> defaults{255, 255, 0};
+
+    TextureData orm{};
+    orm.channels = 4;
+    for (const TextureData* source : sources)
+    {
+        if (source == nullptr)
+            continue;
+        if (source->format != TexturePixelFormat::RGBA8 || source->width == 0 || source->height == 0 ||
+            source->pixels.size() < level_size(TexturePixelFormat::RGBA8, source->width, source->height))
+            return make_error(fmt::format("ORM source '{}' is not a valid RGBA8 texture", source->name),
+                              ErrorCode::AssetInvalidData);
+        orm.width = std::max(orm.width, source->width);
+        orm.height = std::max(orm.height, source->height);
+    }
+    if (orm.width == 0 || orm.height == 0)
+        orm.width = orm.height = 1;
+
+    orm.pixels.resize(level_size(TexturePixelFormat::RGBA8, orm.width, orm.height));
+    for (std::uint32_t y = 0; y < orm.height; ++y)
+    {
+        for (std::uint32_t x = 0; x < orm.width; ++x)
+        {
+            std::uint8_t* out = orm.pixels.data() + (static_cast<std::size_t>(y) * orm.width + x) * 4;
+            for (std::uint32_t c = 0; c < 3; ++c)
+            {
+                const TextureData* source = sources[c];
+                if (source == nullptr)
+                {
+                    out[c] = defaults[c];
+                    continue;
+                }
+                const std::uint32_t sx = static_cast<std::uint32_t>(static_cast<std::uint64_t>(x) * source->width / orm.width);
+                const std::uint32_t sy = static_cast<std::uint32_t>(static_cast<std::uint64_t>(y) * source->height / orm.height);
+                out[c] = source->pixels[(static_cast<std::size_t>(sy) * source->width + sx) * 4 + c];
+            }
+            out[3] = 255;
+        }
+    }
+
+    return orm;
+}
+
+Result<> TextureProcessor::compress(TextureData& texture, TexturePixelFormat format, std::uint32_t sourceChannel)
+{
+    if (format == TexturePixelFormat::RGBA8)
+        return {};
+    if (texture.format != TexturePixelFormat::RGBA8)
+        return make_error("Block compression requires an uncompressed RGBA8 texture", ErrorCode::AssetInvalidData);
+    if (sourceChannel > 3)
+        return make_error("BC4 source channel must be in [0, 3]", ErrorCode::AssetInvalidData);
+
+    std::vector<TextureMipLevel> sourceMips = texture.mips;
+    if (sourceMips.empty())
+        sourceMips.push_back(TextureMipLevel{texture.width, texture.height, 0,
+                                             level_size(TexturePixelFormat::RGBA8, texture.width, texture.height)});
+
+    std::vector<TextureMipLevel> mips{};
+    mips.reserve(sourceMips.size());
+    std::uint64_t totalSize = 0;
+    for (const TextureMipLevel& source : sourceMips)
+    {
+        if (source.offset + level_size(TexturePixelFormat::RGBA8, source.width, source.height) > texture.pixels.size())
+            return make_error(fmt::format("Texture '{}' mip range exceeds its pixel buffer", texture.name),
+                              ErrorCode::AssetInvalidData);
+
+        const std::uint64_t size = level_size(format, source.width, source.height);
+        mips.push_back(TextureMipLevel{source.width, source.height, totalSize, size});
+        totalSize += size;
+    }
+
+    std::vector<std::uint8_t> compressed(totalSize);
+    const std::uint32_t blockSize = block_bytes(format);
+
+    for (std::size_t level = 0; level < sourceMips.size(); ++level)
+    {
+        const TextureMipLevel& source = sourceMips[level];
+        const std::uint8_t* srcPixels = texture.pixels.data() + source.offset;
+        std::uint8_t* out = compressed.data() + mips[level].offset;
+
+        const std::uint32_t blocksX = (source.width + 3) / 4;
+        const std::uint32_t blocksY = (source.height + 3) / 4;
+        for (std::uint32_t by = 0; by < blocksY; ++by)
+        {
+            for (std::uint32_t bx = 0; bx < blocksX; ++bx, out += blockSize)
+            {
+                const Block block = gather_block(srcPixels, source.width, source.height, bx, by);
+                switch (format)
+                {
+                case TexturePixelFormat::BC4:
+                    encode_bc4(block, sourceChannel, out);
+                    break;
+                case TexturePixelFormat::BC5:
+                    encode_bc4(block, 0, out);
+                    encode_bc4(block, 1, out + 8);
+                    break;
+                case TexturePixelFormat::BC7:
+                default:
+                    encode_bc7(block, out);
+                    break;
+                }
+            }
+        }
+    }
+
+    texture.pixels = std::move(compressed);
+    texture.mips = std::move(mips);
+    texture.format = format;
+    texture.channels = format == TexturePixelFormat::BC4 ? 1u : (format == TexturePixelFormat::BC5 ? 2u : 4u);
+    return {};
+}
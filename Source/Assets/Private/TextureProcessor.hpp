@@ -0,0 +1,31 @@
+#pragma once
+#include "../../Core/Public/Expected.hpp"
+#include "../Public/TextureData.hpp"
+
+#include <cstdint>
+
+/// Offline texture processing used by the cooker and the texture loader:
+/// box-filtered mip chain generation and BC4 / BC5 / BC7 block compression.
+struct NOC_EXPORT TextureProcessor
+{
+    /// Builds the full mip chain (down to 1x1) for a single-level RGBA8 texture.
+    /// Normal maps are renormalized per texel after filtering. No-op when mips already exist.
+    static Result<> generate_mips(TextureData& texture, TextureUsage usage = TextureUsage::Color);
+
+    /// Block-compresses every level of an RGBA8 texture into `format`.
+    /// `sourceChannel` selects which RGBA channel feeds BC4; BC5 always encodes R and G.
+    static Result<> compress(TextureData& texture, TexturePixelFormat format, std::uint32_t sourceChannel = 0);
+
+    /// Packs AO (R of `ao`), roughness (G of `roughness`) and metallic (B of `metallic`) into one
+    /// single-level RGBA8 ORM texture sized to the largest input. Sources are RGBA8 and sampled
+    /// nearest from their base level; a null source fills its channel with AO 1, roughness 1, metallic 0.
+    static Result<TextureData> pack_orm(const TextureData* ao, const TextureData* roughness, const TextureData* metallic);
+
+    /// Preferred compressed format for a usage: BC7 colour, BC5 normals, BC4 masks.
+    static TexturePixelFormat compressed_format_for(TextureUsage usage) noexcept;
+
+    static bool is_block_compressed(TexturePixelFormat format) noexcept;
+
+    /// Byte size of one level of `format` at the given dimensions.
+    static std::uint64_t level_size(TexturePixelFormat format, std::uint32_t width, std::uint32_t height) noexcept;
+};
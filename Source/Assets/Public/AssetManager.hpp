@@ -1,5 +1,7 @@
 #pragma once
+#include "../../Core/Public/AssetId.hpp"
 #include "../../Core/Public/Core.hpp"
+#include "../../Core/Public/JobSystem.hpp"
 #include "../Private/MeshLoader.hpp"
 #include "../Private/ModelLoader.hpp"
 #include "../Private/TextureLoader.hpp"
@@ -9,33 +11,48 @@
 #include "TextureData.hpp"
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string_view>
-#include <thread>
 #include <filesystem>
+#include <unordered_map>
 
-#include <entt/core/hashed_string.hpp>
 #include <entt/resource/cache.hpp>
 #include <entt/resource/resource.hpp>
 #include <taskflow/taskflow.hpp>
 
 NOC_SUPPRESS_DLL_WARNINGS
 
+/// Whether a cached asset still holds its CPU payload (vertices/indices, pixels).
+enum class AssetResidency : std::uint8_t
+{
+    NotLoaded = 0,
+    Resident,
+    GpuOnly, // payload freed after upload; metadata (bounds, dimensions, LODs) kept
+};
+
 /// Manages CPU-side asset data with deduplication, caching, and async loading.
 ///
 /// Uses entt::resource_cache for handle-based lifecycle management:
-///   - Same path -> same handle (automatic deduplication via hashed path ID)
+///   - Same path -> same handle (deduplication by the path's AssetId, hashed in place)
 ///   - Shared ownership via entt::resource<T> (wraps shared_ptr)
 ///
 /// Uses Taskflow for background CPU-side loading (OBJ parsing, FlatBuffer deserialization).
 /// GPU upload is NOT handled here — the renderer owns GPU resources.
+///
+/// Residency: every load_* call stamps the asset for LRU order. Once the caller reports that the
+/// loaded assets are uploaded (mark_gpu_resident), payloads beyond the CPU memory budget are freed,
+/// least recently used first, leaving handles valid but GpuOnly. load_mesh/load_model/load_texture
+/// re-stream a GpuOnly payload from disk in place, so existing handles see the data again.
 class NOC_EXPORT AssetManager
 {
   public:
     /// Constructs an empty asset manager with lazy async executor initialization.
     AssetManager();
-    /// Waits for queued async work (if any) and releases all owned caches.
+    /// Releases all owned caches. Async work runs on the shared JobSystem and is not owned here.
     ~AssetManager();
 
     // Non-copyable, non-movable (owns executor + caches)
@@ -82,6 +99,10 @@ class NOC_EXPORT AssetManager
     /// Load a texture from pre-built data (e.g. programmatic textures).
     entt::resource<TextureData> load_texture(std::string_view name, const TextureData& data);
 
+    /// Adopt a texture decoded elsewhere under `name` (usually its file path). No pixel copy.
+    /// Returns the existing handle if the name is already cached.
+    entt::resource<TextureData> load_texture(std::string_view name, std::shared_ptr<TextureData> data);
+
     /// Returns true if a texture handle with this key is cached.
     bool contains_texture(std::string_view name) const;
     /// Returns the number of cached textures.
@@ -95,6 +116,10 @@ class NOC_EXPORT AssetManager
     /// extracts texture paths, computes tangents per sub-mesh.
     entt::resource<ModelData> load_model(const std::filesystem::path& path);
 
+    /// Adopt a model parsed elsewhere (e.g. on a streaming worker) under `path`.
+    /// Returns the existing handle if the path is already cached.
+    entt::resource<ModelData> load_model(const std::filesystem::path& path, std::shared_ptr<ModelData> model);
+
     /// Returns true if a model handle for this path is cached.
     bool contains_model(const std::filesystem::path& path) const;
     /// Returns the number of cached models.
@@ -102,29 +127,89 @@ class NOC_EXPORT AssetManager
     /// Clears all cached model handles.
     void clear_models() noexcept;
 
+    /// Frees the vertex/index arrays of every cached mesh and model after they were uploaded,
+    /// keeping the handles and their metadata. Returns the bytes released.
+    std::size_t release_cpu_geometry() noexcept;
+
+    // --- Residency ---
+
+    /// CPU bytes the cached payloads may occupy once uploaded; 0 (default) means unlimited.
+    void set_cpu_memory_budget(std::size_t bytes);
+    std::size_t get_cpu_memory_budget() const noexcept
+    {
+        return m_cpuBudgetBytes;
+    }
+
+    /// Bytes currently held by mesh, model and texture payloads.
+    std::size_t get_cpu_memory_bytes() const noexcept
+    {
+        return m_cpuBytes;
+    }
+
+    /// Reports that everything loaded so far has a GPU copy, so its payload may be evicted.
+    /// Enforces the budget. Returns the bytes freed.
+    std::size_t mark_gpu_resident();
+
+    /// Evicts uploaded payloads, least recently used first, until within budget. Returns the bytes freed.
+    std::size_t enforce_cpu_budget();
+
+    AssetResidency get_mesh_residency(const std::filesystem::path& path) const;
+    AssetResidency get_model_residency(const std::filesystem::path& path) const;
+    AssetResidency get_texture_residency(std::string_view name) const;
+
     // --- Async support ---
 
-    /// Returns a reference to the Taskflow executor for scheduling async work.
+    /// The engine JobSystem's executor, shared with every other subsystem.
     tf::Executor& get_executor() noexcept
     {
-        if (!m_executor)
-        {
-            const std::uint32_t workers = std::max(1u, std::thread::hardware_concurrency());
-            m_executor = std::make_unique<tf::Executor>(workers);
-        }
-        return *m_executor;
+        return JobSystem::get().executor();
     }
 
   private:
-    /// Compute a stable ID from a file path for use as entt::resource_cache key.
-    static entt::id_type path_to_id(const std::filesystem::path& path);
+    static constexpr entt::id_type UnknownCacheKey{std::numeric_limits<entt::id_type>::max()};
+
+    /// entt::resource_cache key of an asset, assigned densely on first use.
+    entt::id_type cache_key(AssetId id);
+    /// Key already assigned to `id`, or UnknownCacheKey, which no cache holds.
+    entt::id_type find_cache_key(AssetId id) const;
+
+    enum class ResidencyKind : std::uint8_t
+    {
+        Mesh = 0,
+        Model,
+        Texture,
+        Count
+    };
+
+    struct ResidencyEntry
+    {
+        std::filesystem::path path{}; // re-stream source
+        std::uint64_t lastUse{};
+        std::size_t bytes{};
+        bool restreamable{true}; // false for programmatic textures without a backing file
+        bool uploaded{false};
+        bool gpuOnly{false};
+    };
+
+    using ResidencyMap = std::unordered_map<entt::id_type, ResidencyEntry>;
+
+    /// Stamps (and on first sight registers) an entry; re-streams it when GpuOnly.
+    void touch(ResidencyKind kind, entt::id_type id, const std::filesystem::path& path, bool restreamable);
+    void restream(ResidencyKind kind, entt::id_type id, ResidencyEntry& entry);
+    std::size_t evict(ResidencyKind kind, entt::id_type id, ResidencyEntry& entry);
+    std::size_t payload_bytes(ResidencyKind kind, entt::id_type id) const;
+    AssetResidency get_residency(ResidencyKind kind, entt::id_type id) const;
 
     entt::resource_cache<MeshData, MeshLoader> m_meshCache;
     entt::resource_cache<MaterialData> m_materialCache;
     entt::resource_cache<TextureData, TextureLoader> m_textureCache;
     entt::resource_cache<ModelData, ModelLoader> m_modelCache;
 
-    std::unique_ptr<tf::Executor> m_executor;
+    std::unordered_map<AssetId, entt::id_type> m_cacheKeys{};
+    std::array<ResidencyMap, static_cast<std::size_t>(ResidencyKind::Count)> m_residency{};
+    std::uint64_t m_useClock{0};
+    std::size_t m_cpuBudgetBytes{0};
+    std::size_t m_cpuBytes{0};
 };
 
 NOC_RESTORE_DLL_WARNINGS
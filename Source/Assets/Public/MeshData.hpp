@@ -1,9 +1,12 @@
 #pragma once
+#include "../../Core/Public/AssetId.hpp"
 #include "../../Core/Public/Core.hpp"
 #include "../../Rendering/Public/Mesh.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -20,13 +23,42 @@ struct NOC_EXPORT MeshData
     std::string name{};
     /// Source asset path that produced this mesh.
     std::filesystem::path sourcePath{};
+    /// Stable id: the model's id .child(name). Invalid for meshes not loaded through a model.
+    AssetId id{};
 
     std::vector<Vertex> vertices{};
     std::vector<std::uint32_t> indices{};
+    /// Detail levels, finest first. Empty means one level spanning all of `indices`; otherwise
+    /// lods[0] starts at index 0 and the coarser levels' triangles follow it in `indices`.
+    std::vector<MeshLod> lods{};
 
     DirectX::XMFLOAT3 boundsMin{};
     DirectX::XMFLOAT3 boundsMax{};
 
+    /// Triangles of the full-detail level (what collision and picking should use).
+    std::span<const std::uint32_t> base_indices() const noexcept
+    {
+        if (lods.empty())
+            return indices;
+        return std::span<const std::uint32_t>{indices}.first(std::min<std::size_t>(lods[0].indexCount, indices.size()));
+    }
+
+    /// Bytes held by the vertex and index arrays.
+    std::size_t geometry_bytes() const noexcept
+    {
+        return vertices.capacity() * sizeof(Vertex) + indices.capacity() * sizeof(std::uint32_t);
+    }
+
+    /// Frees the vertex and index arrays once the GPU holds its own copy. Name, bounds and LODs stay.
+    /// Returns the bytes released.
+    std::size_t release_geometry() noexcept
+    {
+        const std::size_t bytes = geometry_bytes();
+        std::vector<Vertex>().swap(vertices);
+        std::vector<std::uint32_t>().swap(indices);
+        return bytes;
+    }
+
     /// Recompute the axis-aligned bounding box from the current vertex data.
     void compute_bounds() noexcept
     {
@@ -1,8 +1,10 @@
 #pragma once
+#include "../../Core/Public/AssetId.hpp"
 #include "../../Core/Public/Core.hpp"
 #include "MaterialData.hpp"
 #include "MeshData.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <string>
@@ -19,6 +21,8 @@ struct NOC_EXPORT ModelData
     std::string name{};
     /// Original model source path used to build this asset.
     std::filesystem::path sourcePath{};
+    /// Stable id assigned at import from sourcePath and kept by the cache file from then on.
+    AssetId id{};
 
     /// Sub-meshes generated from source geometry, typically grouped by material.
     std::vector<MeshData> meshes{};
@@ -26,6 +30,15 @@ struct NOC_EXPORT ModelData
     std::vector<MaterialData> materials{};
     /// Mapping where meshes[i] uses materials[meshMaterialIndices[i]].
     std::vector<std::int32_t> meshMaterialIndices{};
+
+    /// MeshData::release_geometry() on every sub-mesh. Returns the bytes released.
+    std::size_t release_geometry() noexcept
+    {
+        std::size_t bytes = 0;
+        for (MeshData& mesh : meshes)
+            bytes += mesh.release_geometry();
+        return bytes;
+    }
 };
 
 NOC_RESTORE_DLL_WARNINGS
@@ -1,15 +1,46 @@
 #pragma once
 #include "../../Core/Public/Core.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
+/// Pixel layout of TextureData::pixels. Block-compressed formats store 4x4 texel blocks.
+enum class TexturePixelFormat : std::uint8_t
+{
+    RGBA8 = 0,
+    BC4, // single channel (roughness / metallic / AO)
+    BC5, // two channels (tangent-space normal XY)
+    BC7, // RGBA colour
+};
+
+/// How a texture is sampled; selects the compressed format and mip filter at cook time.
+enum class TextureUsage : std::uint8_t
+{
+    Color = 0,
+    Normal,
+    Mask,
+};
+
+/// One level of a mip chain, as a byte range inside TextureData::pixels.
+struct TextureMipLevel
+{
+    std::uint32_t width{};
+    std::uint32_t height{};
+    std::uint64_t offset{};
+    std::uint64_t size{};
+};
+
 NOC_SUPPRESS_DLL_WARNINGS
 
 /// CPU-side texture pixel data.
-/// Data model is ready; GPU upload (VkImage, VkSampler) is deferred.
+/// The payload holds every mip level back to back, largest first. When `mips` is empty the
+/// texture is a single RGBA8 level of width x height. Decoded images own it in `pixels`;
+/// cooked textures read it in place from their file mapping (`mappedPixels`).
 struct NOC_EXPORT TextureData
 {
     /// Human-readable texture identifier.
@@ -21,7 +52,41 @@ struct NOC_EXPORT TextureData
     std::uint32_t height{};
     std::uint32_t channels{};
 
+    TexturePixelFormat format{TexturePixelFormat::RGBA8};
+    std::vector<TextureMipLevel> mips{};
+
     std::vector<uint8_t> pixels{};
+
+    /// Payload viewed in place when `pixels` is empty; `mappedSource` keeps the mapping alive.
+    std::span<const uint8_t> mappedPixels{};
+    std::shared_ptr<const void> mappedSource{};
+
+    inline std::uint32_t mip_count() const noexcept
+    {
+        return mips.empty() ? 1u : static_cast<std::uint32_t>(mips.size());
+    }
+
+    /// The bytes to upload, owned or mapped.
+    inline std::span<const uint8_t> pixel_bytes() const noexcept
+    {
+        return pixels.empty() ? mappedPixels : std::span<const uint8_t>{pixels};
+    }
+
+    inline std::size_t payload_bytes() const noexcept
+    {
+        return pixels.capacity() + mappedPixels.size();
+    }
+
+    /// Frees the pixel payload once the GPU holds its own copy; dimensions, format and mips stay.
+    /// Returns the bytes released.
+    std::size_t release_pixels() noexcept
+    {
+        const std::size_t bytes = payload_bytes();
+        std::vector<uint8_t>().swap(pixels);
+        mappedPixels = {};
+        mappedSource.reset();
+        return bytes;
+    }
 };
 
 NOC_RESTORE_DLL_WARNINGS
@@ -121,8 +121,11 @@ XMMATRIX OrbitCameraController::get_projection_matrix(float aspectRatio) const n
     if (!is_attached())
         return XMMatrixIdentity();
 
-    const auto& cam = get_component();
+    return make_projection_matrix(get_component(), aspectRatio);
+}
 
+XMMATRIX OrbitCameraController::make_projection_matrix(const CameraComponent& cam, float aspectRatio) noexcept
+{
     float fovRadians = XMConvertToRadians(cam.fov);
     XMMATRIX proj = XMMatrixPerspectiveFovRH(fovRadians, aspectRatio, cam.nearPlane, cam.farPlane);
 
@@ -46,6 +46,9 @@ class NOC_EXPORT OrbitCameraController
     /// Returns the projection matrix (right-handed perspective, Vulkan Y-flip applied).
     DirectX::XMMATRIX get_projection_matrix(float aspectRatio) const noexcept;
 
+    /// Projection for a detached copy of a camera's state (e.g. a render-side frame snapshot).
+    static DirectX::XMMATRIX make_projection_matrix(const CameraComponent& camera, float aspectRatio) noexcept;
+
     /// Returns the world-space eye position.
     DirectX::XMFLOAT3 get_eye_position() const noexcept;
 
@@ -0,0 +1,41 @@
+#include "../Public/AllocationCounter.hpp"
+
+#include <atomic>
+
+namespace
+{
+std::atomic<std::uint64_t> totalCount{0};
+std::atomic<std::uint64_t> totalBytes{0};
+
+// Written only by end_frame() on the main thread.
+std::atomic<std::uint64_t> frameStartCount{0};
+std::atomic<std::uint64_t> frameStartBytes{0};
+std::atomic<std::uint64_t> lastFrameCount{0};
+std::atomic<std::uint64_t> lastFrameBytes{0};
+} // namespace
+
+NOC_DEFINE_ALLOCATION_COUNTING_HOOKS()
+
+void AllocationCounter::record(std::size_t bytes) noexcept
+{
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocationCounter::end_frame() noexcept
+{
+    const std::uint64_t count = totalCount.load(std::memory_order_relaxed);
+    const std::uint64_t bytes = totalBytes.load(std::memory_order_relaxed);
+    lastFrameCount.store(count - frameStartCount.exchange(count, std::memory_order_relaxed), std::memory_order_relaxed);
+    lastFrameBytes.store(bytes - frameStartBytes.exchange(bytes, std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+AllocationCounter::FrameAllocations AllocationCounter::get_last_frame() noexcept
+{
+    return {lastFrameCount.load(std::memory_order_relaxed), lastFrameBytes.load(std::memory_order_relaxed)};
+}
+
+AllocationCounter::FrameAllocations AllocationCounter::get_total() noexcept
+{
+    return {totalCount.load(std::memory_order_relaxed), totalBytes.load(std::memory_order_relaxed)};
+}
@@ -0,0 +1,155 @@
+#include "../Public/AssetId.hpp"
+#include "../Public/ContentHash.hpp"
+
+#include <fmt/core.h>
+
+#include <mutex>
+#include <type_traits>
+
+namespace
+{
+/// 0 is reserved for the invalid id.
+AssetId make_id(std::uint64_t digest) noexcept
+{
+    return AssetId{digest != 0 ? digest : 1};
+}
+
+/// Hashes `path` as if every '\' were '/', without building the converted string.
+std::uint64_t hash_generic_path(std::string_view path) noexcept
+{
+    ContentHasher hasher{};
+    std::size_t segmentStart = 0;
+    for (std::size_t index = path.find('\\'); index != std::string_view::npos; index = path.find('\\', index + 1))
+    {
+        hasher.update(path.substr(segmentStart, index - segmentStart));
+        hasher.update(std::string_view{"/"});
+        segmentStart = index + 1;
+    }
+    hasher.update(path.substr(segmentStart));
+    return hasher.digest();
+}
+} // namespace
+
+AssetId AssetId::from_path(std::string_view path) noexcept
+{
+    if (path.empty())
+        return {};
+    return make_id(hash_generic_path(path));
+}
+
+AssetId AssetId::from_path(const std::filesystem::path& path) noexcept
+{
+    using NativeChar = std::filesystem::path::value_type;
+    const auto& native = path.native();
+    if (native.empty())
+        return {};
+
+    if constexpr (std::is_same_v<NativeChar, char>)
+    {
+        return make_id(hash_generic_path(native));
+    }
+    else
+    {
+        // Wide paths hash like their UTF-8 spelling; plain ASCII is narrowed a chunk at a time.
+        ContentHasher hasher{};
+        char chunk[256];
+        std::size_t chunkSize = 0;
+        for (const NativeChar character : native)
+        {
+            if (character >= 0x80)
+            {
+                try
+                {
+                    return from_path(std::string_view{path.generic_string()});
+                }
+                catch (...)
+                {
+                    return {};
+                }
+            }
+            chunk[chunkSize++] = character == L'\\' ? '/' : static_cast<char>(character);
+            if (chunkSize == sizeof(chunk))
+            {
+                hasher.update(std::string_view{chunk, chunkSize});
+                chunkSize = 0;
+            }
+        }
+        hasher.update(std::string_view{chunk, chunkSize});
+        return make_id(hasher.digest());
+    }
+}
+
+AssetId AssetId::child(std::string_view name) const noexcept
+{
+    ContentHasher hasher{value};
+    hasher.update(name);
+    return make_id(hasher.digest());
+}
+
+AssetRegistry& AssetRegistry::get()
+{
+    static AssetRegistry instance{};
+    return instance;
+}
+
+AssetId AssetRegistry::intern(std::string_view path)
+{
+    const AssetId id = AssetId::from_path(path);
+    if (id.is_valid())
+        register_path(id, path);
+    return id;
+}
+
+AssetId AssetRegistry::intern(const std::filesystem::path& path)
+{
+    const AssetId id = AssetId::from_path(path);
+    if (!id.is_valid())
+        return id;
+
+    {
+        std::shared_lock lock{m_mutex};
+        if (m_paths.contains(id))
+            return id;
+    }
+    register_path(id, path.generic_string());
+    return id;
+}
+
+void AssetRegistry::register_path(AssetId id, std::string_view path)
+{
+    if (!id.is_valid() || path.empty())
+        return;
+
+    {
+        std::shared_lock lock{m_mutex};
+        if (m_paths.contains(id))
+            return;
+    }
+
+    std::string genericPath{path};
+    for (char& character : genericPath)
+    {
+        if (character == '\\')
+            character = '/';
+    }
+    if (AssetId::from_path(std::string_view{genericPath}) != id)
+        fmt::print("Warning: asset id {:016x} does not match path '{}'\n", id.value, genericPath);
+
+    std::unique_lock lock{m_mutex};
+    m_paths.try_emplace(id, std::move(genericPath));
+}
+
+std::string_view AssetRegistry::path_of(AssetId id) const
+{
+    if (!id.is_valid())
+        return {};
+    std::shared_lock lock{m_mutex};
+    const auto it = m_paths.find(id);
+    return it != m_paths.end() ? std::string_view{it->second} : std::string_view{};
+}
+
+std::size_t AssetRegistry::size() const
+{
+    std::shared_lock lock{m_mutex};
+    return m_paths.size();
+}
@@ -0,0 +1,153 @@
+#include "../Public/ContentHash.hpp"
+#include "../Public/MappedFile.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace
+{
+constexpr std::uint64_t Prime1{0x9E3779B185EBCA87ull};
+constexpr std::uint64_t Prime2{0xC2B2AE3D27D4EB4Full};
+constexpr std::uint64_t Prime3{0x165667B19E3779F9ull};
+constexpr std::uint64_t Prime4{0x85EBCA77C2B2AE63ull};
+constexpr std::uint64_t Prime5{0x27D4EB2F165667C5ull};
+
+std::uint64_t read_u64(const std::uint8_t* data) noexcept
+{
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big)
+        value = std::byteswap(value);
+    return value;
+}
+
+std::uint32_t read_u32(const std::uint8_t* data) noexcept
+{
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big)
+        value = std::byteswap(value);
+    return value;
+}
+
+std::uint64_t xxh_round(std::uint64_t lane, std::uint64_t input) noexcept
+{
+    lane += input * Prime2;
+    lane = std::rotl(lane, 31);
+    return lane * Prime1;
+}
+
+std::uint64_t merge_round(std::uint64_t hash, std::uint64_t lane) noexcept
+{
+    hash ^= xxh_round(0, lane);
+    return hash * Prime1 + Prime4;
+}
+} // namespace
+
+ContentHasher::ContentHasher(std::uint64_t seed) noexcept
+    : m_seed(seed), m_lanes{seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1}
+{
+}
+
+void ContentHasher::update(std::span<const std::uint8_t> bytes) noexcept
+{
+    const std::uint8_t* data = bytes.data();
+    std::size_t size = bytes.size();
+    m_totalSize += size;
+
+    if (m_bufferSize > 0)
+    {
+        const std::size_t fill = std::min(size, StripeBytes - m_bufferSize);
+        std::memcpy(m_buffer.data() + m_bufferSize, data, fill);
+        m_bufferSize += fill;
+        data += fill;
+        size -= fill;
+        if (m_bufferSize < StripeBytes)
+            return;
+
+        for (std::size_t lane = 0; lane < 4; ++lane)
+            m_lanes[lane] = xxh_round(m_lanes[lane], read_u64(m_buffer.data() + lane * 8));
+        m_bufferSize = 0;
+    }
+
+    for (; size >= StripeBytes; data += StripeBytes, size -= StripeBytes)
+    {
+        for (std::size_t lane = 0; lane < 4; ++lane)
+            m_lanes[lane] = xxh_round(m_lanes[lane], read_u64(data + lane * 8));
+    }
+
+    if (size > 0)
+    {
+        std::memcpy(m_buffer.data(), data, size);
+        m_bufferSize = size;
+    }
+}
+
+std::uint64_t ContentHasher::digest() const noexcept
+{
+    std::uint64_t hash{};
+    if (m_totalSize >= StripeBytes)
+    {
+        hash = std::rotl(m_lanes[0], 1) + std::rotl(m_lanes[1], 7) + std::rotl(m_lanes[2], 12) + std::rotl(m_lanes[3], 18);
+        for (std::uint64_t lane : m_lanes)
+            hash = merge_round(hash, lane);
+    }
+    else
+    {
+        hash = m_seed + Prime5;
+    }
+    hash += m_totalSize;
+
+    const std::uint8_t* tail = m_buffer.data();
+    std::size_t remaining = m_bufferSize;
+    for (; remaining >= 8; tail += 8, remaining -= 8)
+    {
+        hash ^= xxh_round(0, read_u64(tail));
+        hash = std::rotl(hash, 27) * Prime1 + Prime4;
+    }
+    if (remaining >= 4)
+    {
+        hash ^= static_cast<std::uint64_t>(read_u32(tail)) * Prime1;
+        hash = std::rotl(hash, 23) * Prime2 + Prime3;
+        tail += 4;
+        remaining -= 4;
+    }
+    for (; remaining > 0; ++tail, --remaining)
+    {
+        hash ^= static_cast<std::uint64_t>(*tail) * Prime5;
+        hash = std::rotl(hash, 11) * Prime1;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::uint64_t ContentHasher::hash(std::span<const std::uint8_t> bytes, std::uint64_t seed) noexcept
+{
+    ContentHasher hasher{seed};
+    hasher.update(bytes);
+    return hasher.digest();
+}
+
+Result<std::uint64_t> ContentHasher::hash_file(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(path, ec);
+    if (ec)
+        return make_error(fmt::format("Failed to stat '{}': {}", path.string(), ec.message()), ErrorCode::FileReadFailed);
+    if (fileSize == 0)
+        return hash({});
+
+    auto mappedResult = MappedFile::open(path);
+    if (!mappedResult)
+        return make_error(mappedResult.error());
+    return hash(mappedResult->bytes());
+}
@@ -0,0 +1,169 @@
+#include "../Public/FrameArena.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+std::atomic<std::uint64_t> currentFrame{0};
+
+/// One frame's worth of bump allocation out of blocks taken from the global heap and kept across frames.
+/// Only the owning thread allocates; the byte counters are atomic so get_stats() may read them anywhere.
+class ArenaSlot final : public std::pmr::memory_resource
+{
+  public:
+    /// Rewinds to empty. A slot that overflowed into several blocks is rebuilt as one block that fits
+    /// everything it held, so the next frame of the same size takes nothing from the heap.
+    void rewind()
+    {
+        if (m_blocks.size() > 1)
+        {
+            const std::size_t combined = reserved_bytes();
+            m_blocks.clear();
+            m_reservedBytes.store(0, std::memory_order_relaxed);
+            add_block(combined);
+        }
+        m_offset = 0;
+        m_usedBytes.store(0, std::memory_order_relaxed);
+    }
+
+    std::size_t reserved_bytes() const noexcept
+    {
+        return m_reservedBytes.load(std::memory_order_relaxed);
+    }
+
+    std::size_t used_bytes() const noexcept
+    {
+        return m_usedBytes.load(std::memory_order_relaxed);
+    }
+
+  private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t size{};
+    };
+
+    void add_block(std::size_t size)
+    {
+        m_blocks.push_back(Block{std::make_unique_for_overwrite<std::byte[]>(size), size});
+        m_reservedBytes.fetch_add(size, std::memory_order_relaxed);
+        m_offset = 0;
+    }
+
+    /// Nullptr when the newest block has no room left.
+    void* bump(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (m_blocks.empty())
+            return nullptr;
+        const Block& block = m_blocks.back();
+        const auto base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+        const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(std::uintptr_t{alignment} - 1);
+        const std::size_t end = static_cast<std::size_t>(aligned - base) + bytes;
+        if (end > block.size)
+            return nullptr;
+        m_offset = end;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        void* memory = bump(bytes, alignment);
+        if (memory == nullptr)
+        {
+            const std::size_t previous = m_blocks.empty() ? 0 : m_blocks.back().size;
+            add_block(std::max({FrameArena::MinBlockSize, previous * 2, bytes + alignment}));
+            memory = bump(bytes, alignment);
+        }
+        m_usedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        return memory;
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override
+    {
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::vector<Block> m_blocks{};
+    std::size_t m_offset{};
+    std::atomic<std::size_t> m_reservedBytes{0};
+    std::atomic<std::size_t> m_usedBytes{0};
+};
+
+struct ThreadArena;
+
+std::mutex registryMutex;
+std::vector<ThreadArena*> threadArenas;
+
+/// Listed for get_stats() while its thread runs; the blocks go away with the thread.
+struct ThreadArena
+{
+    ThreadArena()
+    {
+        std::lock_guard lock{registryMutex};
+        threadArenas.push_back(this);
+    }
+    ~ThreadArena()
+    {
+        std::lock_guard lock{registryMutex};
+        std::erase(threadArenas, this);
+    }
+
+    ArenaSlot& slot_for(std::uint64_t frame)
+    {
+        ArenaSlot& slot = slots[frame % FrameArena::FramesInFlight];
+        if (frame != lastFrame)
+        {
+            // Slots are only rewound by their own thread, on its first allocation of a later frame.
+            lastFrame = frame;
+            peakFrameBytes.store(std::max(peakFrameBytes.load(std::memory_order_relaxed), slot.used_bytes()),
+                                 std::memory_order_relaxed);
+            slot.rewind();
+        }
+        return slot;
+    }
+
+    std::array<ArenaSlot, FrameArena::FramesInFlight> slots{};
+    std::uint64_t lastFrame{UINT64_MAX};
+    std::atomic<std::size_t> peakFrameBytes{0};
+};
+
+thread_local ThreadArena threadArena{};
+} // namespace
+
+void FrameArena::begin_frame() noexcept
+{
+    currentFrame.fetch_add(1, std::memory_order_acq_rel);
+}
+
+std::uint64_t FrameArena::frame_index() noexcept
+{
+    return currentFrame.load(std::memory_order_acquire);
+}
+
+std::pmr::memory_resource* FrameArena::current() noexcept
+{
+    return &threadArena.slot_for(frame_index());
+}
+
+FrameArena::Stats FrameArena::get_stats()
+{
+    Stats stats{};
+    std::lock_guard lock{registryMutex};
+    for (const ThreadArena* arena : threadArenas)
+    {
+        for (const ArenaSlot& slot : arena->slots)
+            stats.reservedBytes += slot.reserved_bytes();
+        stats.peakFrameBytes = std::max(stats.peakFrameBytes, arena->peakFrameBytes.load(std::memory_order_relaxed));
+        ++stats.threadCount;
+    }
+    return stats;
+}
@@ -0,0 +1,125 @@
+#include "../Public/JobSystem.hpp"
+#include "../Public/Profiler.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace
+{
+std::atomic<std::uint32_t> configuredWorkerCount{0};
+
+/// Labels each worker thread in profiler traces.
+class WorkerNaming final : public tf::WorkerInterface
+{
+  public:
+    void scheduler_prologue(tf::Worker& worker) override
+    {
+        Profiler::set_thread_name(fmt::format("Worker {}", worker.id()));
+    }
+    void scheduler_epilogue(tf::Worker& /*worker*/, std::exception_ptr /*exception*/) override
+    {
+    }
+};
+} // namespace
+
+void JobSystem::configure(std::uint32_t workerCount) noexcept
+{
+    configuredWorkerCount.store(workerCount, std::memory_order_relaxed);
+}
+
+JobSystem& JobSystem::get()
+{
+    static JobSystem instance{configuredWorkerCount.load(std::memory_order_relaxed)};
+    return instance;
+}
+
+JobSystem::JobSystem(std::uint32_t workerCount)
+{
+    m_workerCount = workerCount > 0 ? workerCount : std::max(1u, std::thread::hardware_concurrency());
+    m_backgroundLimit = m_workerCount - 1;
+    m_executor = std::make_unique<tf::Executor>(m_workerCount, std::make_shared<WorkerNaming>());
+
+    // A lone worker is kept for frame work; background jobs get a thread of their own instead.
+    if (m_backgroundLimit == 0)
+        m_backgroundThread = std::jthread{[this](std::stop_token stop) { run_background_thread(stop); }};
+}
+
+void JobSystem::submit(JobPriority priority, std::function<void()> job)
+{
+    if (priority == JobPriority::Frame)
+    {
+        m_executor->silent_async(std::move(job));
+        return;
+    }
+
+    {
+        std::lock_guard lock{m_backgroundMutex};
+        m_backgroundQueue.push_back(std::move(job));
+        if (m_backgroundLimit == 0)
+        {
+            m_backgroundWake.notify_one();
+            return;
+        }
+        if (m_backgroundDrainers >= m_backgroundLimit)
+            return;
+        ++m_backgroundDrainers;
+    }
+    m_executor->silent_async([this]() { drain_background(); });
+}
+
+void JobSystem::drain_background()
+{
+    std::unique_lock lock{m_backgroundMutex};
+    while (!m_backgroundQueue.empty())
+    {
+        std::function<void()> job = std::move(m_backgroundQueue.front());
+        m_backgroundQueue.pop_front();
+        ++m_backgroundRunning;
+        lock.unlock();
+        job();
+        lock.lock();
+        --m_backgroundRunning;
+    }
+    --m_backgroundDrainers;
+    if (m_backgroundDrainers == 0)
+        m_backgroundIdle.notify_all();
+}
+
+void JobSystem::run_background_thread(std::stop_token stop)
+{
+    Profiler::set_thread_name("Background");
+    std::unique_lock lock{m_backgroundMutex};
+    while (m_backgroundWake.wait(lock, stop, [this]() { return !m_backgroundQueue.empty(); }))
+    {
+        ++m_backgroundDrainers;
+        lock.unlock();
+        drain_background();
+        lock.lock();
+    }
+}
+
+void JobSystem::run_and_wait(tf::Taskflow& taskflow)
+{
+    if (m_executor->this_worker_id() >= 0)
+        m_executor->corun(taskflow);
+    else
+        m_executor->run(taskflow).wait();
+}
+
+std::size_t JobSystem::background_pending() const
+{
+    std::lock_guard lock{m_backgroundMutex};
+    return m_backgroundQueue.size() + m_backgroundRunning;
+}
+
+void JobSystem::wait_for_background()
+{
+    std::unique_lock lock{m_backgroundMutex};
+    m_backgroundIdle.wait(lock, [this]() { return m_backgroundDrainers == 0 && m_backgroundQueue.empty(); });
+}
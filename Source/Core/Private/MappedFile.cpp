@@ -0,0 +1,120 @@
+#include "../Public/MappedFile.hpp"
+
+#include <fmt/core.h>
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+#ifdef _WIN32
+      ,
+      m_mapping(std::exchange(other.m_mapping, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+Result<MappedFile> MappedFile::open(const std::filesystem::path& path)
+{
+    MappedFile mapped;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return make_error(fmt::format("Failed to open file for mapping: {}", path.string()), ErrorCode::FileReadFailed);
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        CloseHandle(file);
+        return make_error(fmt::format("File is empty: {}", path.string()), ErrorCode::FileReadFailed);
+    }
+
+    // The mapping keeps the file referenced; the file handle itself is no longer needed.
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return make_error(fmt::format("Failed to map file: {}", path.string()), ErrorCode::FileReadFailed);
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return make_error(fmt::format("Failed to map file view: {}", path.string()), ErrorCode::FileReadFailed);
+    }
+
+    mapped.m_mapping = mapping;
+    mapped.m_data = static_cast<const std::uint8_t*>(view);
+    mapped.m_size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return make_error(fmt::format("Failed to open file for mapping: {}", path.string()), ErrorCode::FileReadFailed);
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        ::close(fd);
+        return make_error(fmt::format("File is empty: {}", path.string()), ErrorCode::FileReadFailed);
+    }
+
+    const auto size = static_cast<std::size_t>(info.st_size);
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping stays valid after the descriptor is closed
+    if (view == MAP_FAILED)
+        return make_error(fmt::format("Failed to map file: {}", path.string()), ErrorCode::FileReadFailed);
+
+    ::madvise(view, size, MADV_SEQUENTIAL);
+    mapped.m_data = static_cast<const std::uint8_t*>(view);
+    mapped.m_size = size;
+#endif
+
+    return mapped;
+}
+
+void MappedFile::close() noexcept
+{
+    if (!m_data)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+    m_mapping = nullptr;
+#else
+    ::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
@@ -0,0 +1,197 @@
+#include "../Public/PackArchive.hpp"
+#include "../Public/ContentHash.hpp"
+
+#include <PackIndexAsset_generated.h>
+#include <flatbuffers/flatbuffers.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+namespace fb = NatureOfCraft::Assets;
+
+constexpr std::array<char, 4> PackMagic{'N', 'P', 'A', 'K'};
+
+/// First bytes of the archive; the rest of the first page is padding.
+struct PackHeader
+{
+    std::array<char, 4> magic{PackMagic};
+    std::uint32_t version{PackArchive::Version};
+    std::uint64_t indexOffset{};
+    std::uint64_t indexSize{};
+};
+static_assert(sizeof(PackHeader) == 24);
+
+std::uint64_t align_up(std::uint64_t value) noexcept
+{
+    return (value + PackArchive::EntryAlignment - 1) & ~(PackArchive::EntryAlignment - 1);
+}
+
+Result<> pad_to(std::ofstream& file, std::uint64_t offset)
+{
+    static constexpr std::array<char, PackArchive::EntryAlignment> Zeros{};
+    const std::uint64_t position = static_cast<std::uint64_t>(file.tellp());
+    if (offset > position)
+        file.write(Zeros.data(), static_cast<std::streamsize>(offset - position));
+    if (!file.good())
+        return make_error("Failed to pad archive", ErrorCode::AssetCacheWriteFailed);
+    return {};
+}
+
+const fb::PackIndexAsset* get_index(const std::uint8_t* index) noexcept
+{
+    return fb::GetPackIndexAsset(index);
+}
+} // namespace
+
+std::uint64_t PackArchive::hash_path(std::string_view relativePath) noexcept
+{
+    return ContentHasher::hash({reinterpret_cast<const std::uint8_t*>(relativePath.data()), relativePath.size()});
+}
+
+Result<PackArchive> PackArchive::open(const std::filesystem::path& path)
+{
+    auto mappedResult = MappedFile::open(path);
+    if (!mappedResult)
+        return make_error(mappedResult.error());
+
+    auto file = std::make_shared<const MappedFile>(std::move(mappedResult.value()));
+    PackHeader header{};
+    if (file->size() < sizeof(header))
+        return make_error(fmt::format("Archive is truncated: {}", path.string()), ErrorCode::AssetCacheReadFailed);
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    if (header.magic != PackMagic || header.version != Version)
+        return make_error(fmt::format("'{}' is not a version {} archive", path.string(), Version), ErrorCode::AssetCacheReadFailed);
+    if (header.indexOffset > file->size() || header.indexSize > file->size() - header.indexOffset)
+        return make_error(fmt::format("Archive index is out of range: {}", path.string()), ErrorCode::AssetCacheReadFailed);
+
+    const std::uint8_t* index = file->data() + header.indexOffset;
+    flatbuffers::Verifier verifier(index, static_cast<std::size_t>(header.indexSize));
+    if (!fb::VerifyPackIndexAssetBuffer(verifier))
+        return make_error(fmt::format("Archive index verification failed: {}", path.string()), ErrorCode::AssetCacheReadFailed);
+
+    if (const auto* entries = get_index(index)->entries())
+    {
+        for (const auto* entry : *entries)
+        {
+            if (entry->compression() != fb::PackCompression::None)
+                return make_error(fmt::format("Archive '{}' uses an unsupported compression", path.string()),
+                                  ErrorCode::AssetCacheReadFailed);
+            if (entry->offset() > header.indexOffset || entry->size() > header.indexOffset - entry->offset())
+                return make_error(fmt::format("Archive entry is out of range: {}", path.string()),
+                                  ErrorCode::AssetCacheReadFailed);
+        }
+    }
+
+    PackArchive archive{};
+    archive.m_file = std::move(file);
+    archive.m_index = index;
+    return archive;
+}
+
+std::optional<std::span<const std::uint8_t>> PackArchive::find(std::string_view relativePath) const
+{
+    const auto* entries = get_index(m_index)->entries();
+    if (!entries)
+        return std::nullopt;
+
+    const auto* entry = entries->LookupByKey(hash_path(relativePath));
+    if (!entry || !entry->path() || entry->path()->string_view() != relativePath)
+        return std::nullopt;
+    return std::span<const std::uint8_t>{m_file->data() + entry->offset(), static_cast<std::size_t>(entry->size())};
+}
+
+std::vector<std::string_view> PackArchive::entry_paths() const
+{
+    std::vector<std::string_view> paths{};
+    const auto* entries = get_index(m_index)->entries();
+    if (!entries)
+        return paths;
+
+    paths.reserve(entries->size());
+    for (const auto* entry : *entries)
+    {
+        if (entry->path())
+            paths.push_back(entry->path()->string_view());
+    }
+    return paths;
+}
+
+Result<PackArchiveStats> PackArchive::build(const std::filesystem::path& sourceRoot,
+                                            const std::vector<std::filesystem::path>& files,
+                                            const std::filesystem::path& archivePath)
+{
+    std::filesystem::path tempPath = archivePath;
+    tempPath += ".tmp";
+
+    std::ofstream archive(tempPath, std::ios::binary | std::ios::trunc);
+    if (!archive.is_open())
+        return make_error(fmt::format("Failed to open archive for writing: {}", tempPath.string()),
+                          ErrorCode::AssetCacheWriteFailed);
+
+    if (auto padResult = pad_to(archive, EntryAlignment); !padResult)
+        return make_error(padResult.error());
+
+    flatbuffers::FlatBufferBuilder builder(64 * 1024);
+    std::vector<flatbuffers::Offset<fb::PackEntry>> entryOffsets{};
+    entryOffsets.reserve(files.size());
+    std::vector<std::uint64_t> hashes{};
+    hashes.reserve(files.size());
+
+    for (const std::filesystem::path& file : files)
+    {
+        std::error_code ec;
+        const std::string relativePath = std::filesystem::relative(file, sourceRoot, ec).generic_string();
+        if (ec || relativePath.empty() || relativePath.starts_with(".."))
+            return make_error(fmt::format("'{}' is not under the archive root '{}'", file.string(), sourceRoot.string()),
+                              ErrorCode::AssetInvalidData);
+
+        const std::uint64_t offset = static_cast<std::uint64_t>(archive.tellp());
+        std::uint64_t size{};
+        if (std::filesystem::file_size(file, ec) > 0)
+        {
+            auto mappedResult = MappedFile::open(file);
+            if (!mappedResult)
+                return make_error(mappedResult.error());
+            size = mappedResult->size();
+            archive.write(reinterpret_cast<const char*>(mappedResult->data()), static_cast<std::streamsize>(size));
+        }
+        if (auto padResult = pad_to(archive, align_up(offset + size)); !padResult)
+            return make_error(fmt::format("Failed to write '{}' into archive '{}'", file.string(), tempPath.string()),
+                              ErrorCode::AssetCacheWriteFailed);
+
+        const std::uint64_t hash = hash_path(relativePath);
+        hashes.push_back(hash);
+        entryOffsets.push_back(fb::CreatePackEntryDirect(builder, hash, relativePath.c_str(), offset, size, size));
+    }
+
+    std::ranges::sort(hashes);
+    if (const auto duplicate = std::ranges::adjacent_find(hashes); duplicate != hashes.end())
+        return make_error(fmt::format("Two archive paths hash to {:016x}", *duplicate), ErrorCode::AssetInvalidData);
+
+    fb::FinishPackIndexAssetBuffer(builder,
+                                   fb::CreatePackIndexAsset(builder, builder.CreateVectorOfSortedTables(&entryOffsets)));
+
+    PackHeader header{};
+    header.indexOffset = static_cast<std::uint64_t>(archive.tellp());
+    header.indexSize = builder.GetSize();
+    archive.write(reinterpret_cast<const char*>(builder.GetBufferPointer()), static_cast<std::streamsize>(header.indexSize));
+    archive.seekp(0);
+    archive.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    archive.close();
+    if (!archive.good())
+        return make_error(fmt::format("Failed to write archive: {}", tempPath.string()), ErrorCode::AssetCacheWriteFailed);
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, archivePath, ec);
+    if (ec)
+        return make_error(fmt::format("Failed to move archive into place '{}': {}", archivePath.string(), ec.message()),
+                          ErrorCode::AssetCacheWriteFailed);
+
+    return PackArchiveStats{static_cast<std::uint32_t>(files.size()), header.indexOffset + header.indexSize};
+}
@@ -0,0 +1,211 @@
+#include "../Public/Profiler.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct ZoneEvent
+{
+    const char* name{};
+    std::uint64_t beginNs{};
+    std::uint64_t endNs{};
+};
+
+/// Written only by its thread; read by stop_capture() once recording is off and `writing` is clear.
+struct ThreadBuffer
+{
+    std::array<ZoneEvent, Profiler::ThreadEventCapacity> events{};
+    std::atomic<std::uint64_t> head{0}; // total zones written; the slot is head % capacity
+    std::atomic<std::uint64_t> captureId{0};
+    std::atomic<bool> writing{false}; // set while record_zone() fills a slot
+    std::uint32_t threadId{};
+    std::string name{};
+};
+
+std::atomic<bool> capturing{false};
+std::atomic<std::uint64_t> currentCaptureId{0};
+std::uint64_t captureStartNs{};
+
+// Buffers outlive their threads so zones recorded by finished threads still get exported.
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+
+thread_local ThreadBuffer* threadBuffer = nullptr;
+thread_local std::string threadName{};
+
+/// Allocated on the thread's first recorded zone, so threads that never record cost nothing.
+ThreadBuffer& this_thread_buffer()
+{
+    if (threadBuffer == nullptr)
+    {
+        auto created = std::make_unique<ThreadBuffer>();
+        created->name = threadName;
+        std::lock_guard lock{registryMutex};
+        created->threadId = static_cast<std::uint32_t>(threadBuffers.size() + 1);
+        threadBuffer = created.get();
+        threadBuffers.push_back(std::move(created));
+    }
+    return *threadBuffer;
+}
+
+void append_json_string(std::string& out, std::string_view text)
+{
+    out += '"';
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                out += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+            else
+                out += c;
+        }
+    }
+    out += '"';
+}
+} // namespace
+
+void Profiler::start_capture() noexcept
+{
+    capturing.store(false, std::memory_order_release);
+    captureStartNs = now_ns();
+    // Buffers reset lazily on their next write, when they see the new capture id.
+    currentCaptureId.fetch_add(1, std::memory_order_acq_rel);
+    capturing.store(true, std::memory_order_release);
+}
+
+bool Profiler::is_capturing() noexcept
+{
+    return capturing.load(std::memory_order_relaxed);
+}
+
+void Profiler::set_thread_name(std::string_view name)
+{
+    threadName = name;
+    if (threadBuffer == nullptr)
+        return;
+    std::lock_guard lock{registryMutex};
+    threadBuffer->name = name;
+}
+
+std::uint64_t Profiler::now_ns() noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::record_zone(const char* name, std::uint64_t beginNs, std::uint64_t endNs) noexcept
+{
+    if (!capturing.load(std::memory_order_acquire))
+        return;
+
+    // Raise `writing` before re-checking `capturing` (both seq_cst): either stop_capture() sees the
+    // flag and waits for this write, or this thread sees the capture has stopped and backs out.
+    ThreadBuffer& buffer = this_thread_buffer();
+    buffer.writing.store(true);
+    if (!capturing.load())
+    {
+        buffer.writing.store(false, std::memory_order_release);
+        return;
+    }
+
+    const std::uint64_t captureId = currentCaptureId.load(std::memory_order_acquire);
+    std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    if (buffer.captureId.load(std::memory_order_relaxed) != captureId)
+    {
+        head = 0;
+        buffer.captureId.store(captureId, std::memory_order_relaxed);
+    }
+
+    buffer.events[head % ThreadEventCapacity] = ZoneEvent{name, beginNs, endNs};
+    buffer.head.store(head + 1, std::memory_order_release);
+    buffer.writing.store(false, std::memory_order_release);
+}
+
+Result<> Profiler::stop_capture(const std::filesystem::path& path)
+{
+    capturing.store(false);
+    const std::uint64_t captureId = currentCaptureId.load(std::memory_order_acquire);
+
+    std::string json{};
+    json.reserve(1024 * 1024);
+    json += "{\"traceEvents\":[\n";
+    bool first{true};
+    const auto separator = [&]() {
+        if (!first)
+            json += ",\n";
+        first = false;
+    };
+
+    std::lock_guard lock{registryMutex};
+    // Zones that passed the capturing check before it was cleared finish their slot first.
+    for (const std::unique_ptr<ThreadBuffer>& buffer : threadBuffers)
+    {
+        while (buffer->writing.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+    for (const std::unique_ptr<ThreadBuffer>& buffer : threadBuffers)
+    {
+        separator();
+        json += fmt::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":",
+                            buffer->threadId);
+        append_json_string(json, buffer->name.empty() ? fmt::format("Thread {}", buffer->threadId) : buffer->name);
+        json += "}}";
+
+        if (buffer->captureId.load(std::memory_order_relaxed) != captureId)
+            continue;
+
+        const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const std::uint64_t firstEvent = head > ThreadEventCapacity ? head - ThreadEventCapacity : 0;
+        for (std::uint64_t index = firstEvent; index < head; ++index)
+        {
+            const ZoneEvent& event = buffer->events[index % ThreadEventCapacity];
+            if (event.beginNs < captureStartNs)
+                continue;
+
+            separator();
+            json += "{\"name\":";
+            append_json_string(json, event.name != nullptr ? event.name : "?");
+            // trace_event times are microseconds; keep sub-microsecond precision as decimals.
+            json += fmt::format(",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", buffer->threadId,
+                                static_cast<double>(event.beginNs - captureStartNs) / 1000.0,
+                                static_cast<double>(event.endNs - event.beginNs) / 1000.0);
+        }
+    }
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return make_error(fmt::format("Failed to open trace file for writing: {}", path.string()),
+                          ErrorCode::FileWriteFailed);
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    if (!file.good())
+        return make_error(fmt::format("Failed to write trace file: {}", path.string()), ErrorCode::FileWriteFailed);
+    return {};
+}
@@ -1,4 +1,5 @@
 #include "../Public/RuntimePaths.hpp"
+#include "../Public/VirtualFileSystem.hpp"
 
 #include <cstdlib>
 #include <optional>
@@ -116,7 +117,7 @@ std::filesystem::path RuntimePaths::resolve_engine_resource(const std::filesyste
 {
     const std::filesystem::path modernPath = m_engineResourcesDir / relativePath;
     std::error_code ec;
-    if (std::filesystem::exists(modernPath, ec))
+    if (VirtualFileSystem::get().exists(modernPath))
         return modernPath;
 
     const std::filesystem::path legacyPath = m_legacyResourcesDir / relativePath;
@@ -0,0 +1,130 @@
+#include "../Public/VirtualFileSystem.hpp"
+
+#include <fmt/core.h>
+
+#include <mutex>
+#include <set>
+
+namespace
+{
+std::filesystem::path normalized_path(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    const std::filesystem::path absolutePath = std::filesystem::absolute(path, ec);
+    return (ec ? path : absolutePath).lexically_normal();
+}
+
+/// `path` relative to `root` with generic separators, or empty when it is not under `root`.
+std::string relative_key(const std::filesystem::path& path, const std::filesystem::path& root)
+{
+    const std::filesystem::path relativePath = path.lexically_relative(root);
+    if (relativePath.empty() || *relativePath.begin() == "..")
+        return {};
+    return relativePath.generic_string();
+}
+} // namespace
+
+FileView::FileView(MappedFile file) noexcept : m_file(std::move(file)), m_bytes(m_file.bytes())
+{
+}
+
+FileView::FileView(std::shared_ptr<const MappedFile> archive, std::span<const std::uint8_t> bytes) noexcept
+    : m_archive(std::move(archive)), m_bytes(bytes)
+{
+}
+
+VirtualFileSystem& VirtualFileSystem::get()
+{
+    static VirtualFileSystem instance{};
+    return instance;
+}
+
+Result<> VirtualFileSystem::mount(const std::filesystem::path& archivePath, const std::filesystem::path& mountRoot)
+{
+    auto archiveResult = PackArchive::open(archivePath);
+    if (!archiveResult)
+        return make_error(archiveResult.error());
+
+    std::unique_lock lock{m_mutex};
+    m_mounts.push_back(Mount{normalized_path(mountRoot), std::move(archiveResult.value())});
+    return {};
+}
+
+void VirtualFileSystem::unmount_all()
+{
+    std::unique_lock lock{m_mutex};
+    m_mounts.clear();
+}
+
+std::optional<FileView> VirtualFileSystem::find_archived(const std::filesystem::path& path) const
+{
+    std::shared_lock lock{m_mutex};
+    if (m_mounts.empty())
+        return std::nullopt;
+
+    const std::filesystem::path fullPath = normalized_path(path);
+    for (auto it = m_mounts.rbegin(); it != m_mounts.rend(); ++it)
+    {
+        const std::string key = relative_key(fullPath, it->root);
+        if (key.empty())
+            continue;
+        if (auto bytes = it->archive.find(key))
+            return FileView{it->archive.mapping(), *bytes};
+    }
+    return std::nullopt;
+}
+
+bool VirtualFileSystem::exists(const std::filesystem::path& path) const
+{
+    if (is_archived(path))
+        return true;
+    std::error_code ec;
+    return std::filesystem::exists(path, ec);
+}
+
+bool VirtualFileSystem::is_archived(const std::filesystem::path& path) const
+{
+    return find_archived(path).has_value();
+}
+
+Result<FileView> VirtualFileSystem::open(const std::filesystem::path& path) const
+{
+    if (auto archived = find_archived(path))
+        return std::move(*archived);
+
+    auto mappedResult = MappedFile::open(path);
+    if (!mappedResult)
+        return make_error(mappedResult.error());
+    return FileView{std::move(mappedResult.value())};
+}
+
+std::vector<std::filesystem::path> VirtualFileSystem::list_files(const std::filesystem::path& directory,
+                                                                 std::string_view extension) const
+{
+    std::set<std::filesystem::path> files{};
+    const std::filesystem::path fullDirectory = normalized_path(directory);
+    {
+        std::shared_lock lock{m_mutex};
+        for (const Mount& mount : m_mounts)
+        {
+            for (std::string_view entryPath : mount.archive.entry_paths())
+            {
+                const std::filesystem::path entryFullPath = mount.root / std::filesystem::path(entryPath);
+                if (entryFullPath.extension() == extension && !relative_key(entryFullPath, fullDirectory).empty())
+                    files.insert(entryFullPath);
+            }
+        }
+    }
+
+    std::error_code ec;
+    if (std::filesystem::exists(directory, ec))
+    {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(
+                 directory, std::filesystem::directory_options::skip_permission_denied, ec))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == extension)
+                files.insert(normalized_path(entry.path()));
+        }
+    }
+    return {files.begin(), files.end()};
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include "Core.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Heap allocations per frame, for driving steady-state frames to zero mallocs. Counting happens in
+/// replacement global operator new, compiled in only with NOC_COUNT_ALLOCATIONS (the CMake option
+/// NOC_ENABLE_ALLOCATION_COUNTING). Without it every count reads 0.
+///
+/// Each module links its own operator new on Windows, so besides the engine library, every executable
+/// expands NOC_DEFINE_ALLOCATION_COUNTING_HOOKS() once at namespace scope.
+class NOC_EXPORT AllocationCounter
+{
+  public:
+    struct FrameAllocations
+    {
+        std::uint64_t count{};
+        std::uint64_t bytes{};
+    };
+
+    static constexpr bool is_enabled() noexcept
+    {
+#if NOC_COUNT_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// Called by the operator new replacements.
+    static void record(std::size_t bytes) noexcept;
+
+    /// Closes the current frame; what was allocated since the previous call becomes get_last_frame().
+    static void end_frame() noexcept;
+
+    static FrameAllocations get_last_frame() noexcept;
+    static FrameAllocations get_total() noexcept;
+};
+
+NOC_RESTORE_DLL_WARNINGS
+
+#if NOC_COUNT_ALLOCATIONS
+#ifdef _MSC_VER
+#define NOC_ALLOCATION_HOOK_ALIGNED_ALLOC(size, alignment) _aligned_malloc(size, alignment)
+#define NOC_ALLOCATION_HOOK_ALIGNED_FREE(pointer) _aligned_free(pointer)
+#else
+#define NOC_ALLOCATION_HOOK_ALIGNED_ALLOC(size, alignment)                                                            \
+    std::aligned_alloc(alignment, ((size) + (alignment) - 1) / (alignment) * (alignment))
+#define NOC_ALLOCATION_HOOK_ALIGNED_FREE(pointer) std::free(pointer)
+#endif
+
+// The nothrow forms are left to the standard library, which forwards them to these.
+#define NOC_DEFINE_ALLOCATION_COUNTING_HOOKS()                                                                         \
+    void* operator new(std::size_t size)                                                                               \
+    {                                                                                                                  \
+        AllocationCounter::record(size);                                                                               \
+        if (void* pointer = std::malloc(size != 0 ? size : 1))                                                         \
+            return pointer;                                                                                            \
+        throw std::bad_alloc{};                                                                                        \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size)                                                                             \
+    {                                                                                                                  \
+        return ::operator new(size);                                                                                   \
+    }                                                                                                                  \
+    void* operator new(std::size_t size, std::align_val_t alignment)                                                   \
+    {                                                                                                                  \
+        AllocationCounter::record(size);                                                                               \
+        const auto align = static_cast<std::size_t>(alignment);                                                        \
+        if (void* pointer = NOC_ALLOCATION_HOOK_ALIGNED_ALLOC(size != 0 ? size : 1, align))                            \
+            return pointer;                                                                                            \
+        throw std::bad_alloc{};                                                                                        \
+    }                                                                                                                  \
+    void* operator new[](std::size_t size, std::align_val_t alignment)                                                 \
+    {                                                                                                                  \
+        return ::operator new(size, alignment);                                                                        \
+    }                                                                                                                  \
+    void operator delete(void* pointer) noexcept                                                                       \
+    {                                                                                                                  \
+        std::free(pointer);                                                                                            \
+    }                                                                                                                  \
+    void operator delete[](void* pointer) noexcept                                                                     \
+    {                                                                                                                  \
+        std::free(pointer);                                                                                            \
+    }                                                                                                                  \
+    void operator delete(void* pointer, std::size_t) noexcept                                                          \
+    {                                                                                                                  \
+        std::free(pointer);                                                                                            \
+    }                                                                                                                  \
+    void operator delete[](void* pointer, std::size_t) noexcept                                                        \
+    {                                                                                                                  \
+        std::free(pointer);                                                                                            \
+    }                                                                                                                  \
+    void operator delete(void* pointer, std::align_val_t) noexcept                                                     \
+    {                                                                                                                  \
+        NOC_ALLOCATION_HOOK_ALIGNED_FREE(pointer);                                                                     \
+    }                                                                                                                  \
+    void operator delete[](void* pointer, std::align_val_t) noexcept                                                   \
+    {                                                                                                                  \
+        NOC_ALLOCATION_HOOK_ALIGNED_FREE(pointer);                                                                     \
+    }                                                                                                                  \
+    void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept                                        \
+    {                                                                                                                  \
+        NOC_ALLOCATION_HOOK_ALIGNED_FREE(pointer);                                                                     \
+    }                                                                                                                  \
+    void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept                                      \
+    {                                                                                                                  \
+        NOC_ALLOCATION_HOOK_ALIGNED_FREE(pointer);                                                                     \
+    }
+#else
+#define NOC_DEFINE_ALLOCATION_COUNTING_HOOKS()
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+#include "Core.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Stable 64-bit identity of an asset: the XXH64 of its path with generic ('/') separators. The same
+/// path gives the same id in every run and on every machine, so ids are written into level and model
+/// files and compared instead of strings. Names that are not files (editor materials, sub-meshes) get
+/// ids the same way. 0 is the invalid id.
+struct NOC_EXPORT AssetId
+{
+    std::uint64_t value{};
+
+    static AssetId from_path(std::string_view path) noexcept;
+    /// Hashes the native path in place; only non-narrow paths with non-ASCII characters are converted.
+    static AssetId from_path(const std::filesystem::path& path) noexcept;
+    // Strings would convert to both of the above.
+    static AssetId from_path(const std::string& path) noexcept
+    {
+        return from_path(std::string_view{path});
+    }
+    static AssetId from_path(const char* path) noexcept
+    {
+        return from_path(std::string_view{path});
+    }
+
+    /// Id of a named part of this asset, e.g. one sub-mesh of a model.
+    AssetId child(std::string_view name) const noexcept;
+
+    constexpr bool is_valid() const noexcept
+    {
+        return value != 0;
+    }
+
+    constexpr auto operator<=>(const AssetId&) const noexcept = default;
+};
+
+template <>
+struct std::hash<AssetId>
+{
+    std::size_t operator()(const AssetId& id) const noexcept
+    {
+        // Already a well-mixed hash.
+        return static_cast<std::size_t>(id.value);
+    }
+};
+
+/// Process-wide table of the paths behind AssetIds, for display and serialization. Ids are computed
+/// without it; intern() additionally records the path so it can be looked up again. Entries are never
+/// removed, so the views path_of() returns stay valid. Thread-safe.
+class NOC_EXPORT AssetRegistry
+{
+  public:
+    static AssetRegistry& get();
+
+    /// Id of `path`, recorded under that path. Empty paths give the invalid id and are not recorded.
+    AssetId intern(std::string_view path);
+    AssetId intern(const std::filesystem::path& path);
+    AssetId intern(const std::string& path)
+    {
+        return intern(std::string_view{path});
+    }
+    AssetId intern(const char* path)
+    {
+        return intern(std::string_view{path});
+    }
+
+    /// Records `path` under an id read from a file. Ids that disagree with their path keep the stored
+    /// id, so files stay consistent with themselves, and are reported once.
+    void register_path(AssetId id, std::string_view path);
+
+    /// Path recorded for `id`; empty when the id is invalid or was never interned.
+    std::string_view path_of(AssetId id) const;
+
+    std::size_t size() const;
+
+  private:
+    AssetRegistry() = default;
+
+    mutable std::shared_mutex m_mutex{};
+    std::unordered_map<AssetId, std::string> m_paths{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,54 @@
+#pragma once
+#include "Core.hpp"
+#include "Expected.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Streaming XXH64. Bit-compatible with the reference implementation, so hashes are stable
+/// across runs and machines and can be persisted (cook manifests, cache keys).
+class NOC_EXPORT ContentHasher
+{
+  public:
+    explicit ContentHasher(std::uint64_t seed = 0) noexcept;
+
+    void update(std::span<const std::uint8_t> bytes) noexcept;
+
+    void update(std::string_view text) noexcept
+    {
+        update({reinterpret_cast<const std::uint8_t*>(text.data()), text.size()});
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void update_value(const T& value) noexcept
+    {
+        update({reinterpret_cast<const std::uint8_t*>(&value), sizeof(T)});
+    }
+
+    /// Hash of everything fed so far. Does not reset the state.
+    std::uint64_t digest() const noexcept;
+
+    static std::uint64_t hash(std::span<const std::uint8_t> bytes, std::uint64_t seed = 0) noexcept;
+
+    /// Hashes a whole file through a memory mapping. Empty files hash like empty input.
+    static Result<std::uint64_t> hash_file(const std::filesystem::path& path);
+
+  private:
+    static constexpr std::size_t StripeBytes{32};
+
+    std::uint64_t m_seed{};
+    std::array<std::uint64_t, 4> m_lanes{};
+    std::array<std::uint8_t, StripeBytes> m_buffer{};
+    std::size_t m_bufferSize{};
+    std::uint64_t m_totalSize{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
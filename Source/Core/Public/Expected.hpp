@@ -17,6 +17,7 @@ enum class ErrorCode
 
     // Utils Errors
     FileReadFailed = 100,
+    FileWriteFailed,
 
     // Vulkan Errors
     VulkanGLFWWindowIsNull = 200,
@@ -49,6 +50,9 @@ enum class ErrorCode
     VulkanCopyBufferToImageFailed,
     VulkanSamplerCreationFailed,
     VulkanTextureUploadFailed,
+    VulkanFeatureNotSupported,
+    VulkanUploadSubmitFailed,
+    VulkanQueryPoolCreationFailed,
 
     // Asset Errors
     AssetFileNotFound = 300,
@@ -0,0 +1,43 @@
+#pragma once
+#include "Core.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Bump allocator for per-frame scratch data. Every thread gets its own arena with one slot per
+/// frame in flight; current() hands out the slot of the current frame, which is rewound the first
+/// time the thread allocates FramesInFlight frames later. Memory from it therefore stays valid until
+/// the end of the next frame, on any thread, and must never be kept longer. Deallocation is a no-op.
+///
+/// A slot that needed several blocks in a frame is coalesced into one block of their combined size
+/// when it is rewound, so after warm-up a steady workload allocates nothing from the heap.
+///
+/// Use through std::pmr containers: `std::pmr::vector<T> scratch{FrameArena::current()};`.
+class NOC_EXPORT FrameArena
+{
+  public:
+    static constexpr std::uint32_t FramesInFlight{2};
+    static constexpr std::size_t MinBlockSize{64 * 1024};
+
+    struct Stats
+    {
+        std::size_t reservedBytes{};  // block memory held by every thread's arena
+        std::size_t peakFrameBytes{}; // most bytes any one thread allocated in a single frame
+        std::uint32_t threadCount{};
+    };
+
+    /// Starts a new frame. Call once per frame from the main loop, before any frame work is scheduled.
+    static void begin_frame() noexcept;
+
+    static std::uint64_t frame_index() noexcept;
+
+    /// The calling thread's resource for the current frame.
+    static std::pmr::memory_resource* current() noexcept;
+
+    static Stats get_stats();
+};
+
+NOC_RESTORE_DLL_WARNINGS
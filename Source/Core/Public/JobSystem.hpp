@@ -0,0 +1,86 @@
+#pragma once
+#include "Core.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#include <taskflow/taskflow.hpp>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+enum class JobPriority : std::uint8_t
+{
+    Frame = 0,  // frame-critical: simulation, culling, physics jobs, blocking loads
+    Background, // streaming and other work nobody waits on this frame
+};
+
+/// The engine-wide worker pool. Every subsystem (frame graph, asset loading, model import,
+/// Jolt physics jobs) schedules on this one Taskflow executor, so cores are never oversubscribed.
+///
+/// Frame jobs go straight to the executor. Background jobs are queued and drained by at most
+/// `background_worker_limit()` workers at a time, so one worker always stays free for frame work.
+/// With a single worker the limit is 0 and background jobs run on a dedicated thread instead.
+class NOC_EXPORT JobSystem
+{
+  public:
+    /// Sets the worker count used when the job system is first created. 0 picks the hardware
+    /// thread count. Has no effect once `get()` has been called.
+    static void configure(std::uint32_t workerCount) noexcept;
+
+    static JobSystem& get();
+
+    tf::Executor& executor() noexcept
+    {
+        return *m_executor;
+    }
+
+    std::uint32_t worker_count() const noexcept
+    {
+        return m_workerCount;
+    }
+
+    std::uint32_t background_worker_limit() const noexcept
+    {
+        return m_backgroundLimit;
+    }
+
+    /// Runs `job` on a worker at the given priority. Fire and forget.
+    void submit(JobPriority priority, std::function<void()> job);
+
+    /// Runs `taskflow` to completion. Called from a worker, it helps out instead of blocking,
+    /// so nested fork-joins (a model import inside a level load) never stall the pool.
+    void run_and_wait(tf::Taskflow& taskflow);
+
+    /// Background jobs queued or running.
+    std::size_t background_pending() const;
+
+    /// Blocks until every background job submitted so far has finished. Not for use on a worker.
+    void wait_for_background();
+
+  private:
+    explicit JobSystem(std::uint32_t workerCount);
+
+    void drain_background();
+    void run_background_thread(std::stop_token stop);
+
+    std::unique_ptr<tf::Executor> m_executor;
+    std::uint32_t m_workerCount{1};
+    std::uint32_t m_backgroundLimit{1};
+
+    mutable std::mutex m_backgroundMutex;
+    std::condition_variable m_backgroundIdle;
+    std::condition_variable_any m_backgroundWake;
+    std::deque<std::function<void()>> m_backgroundQueue;
+    std::uint32_t m_backgroundDrainers{0};
+    std::size_t m_backgroundRunning{0};
+    std::jthread m_backgroundThread; // last, so it stops before the queue it drains is destroyed
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,54 @@
+#pragma once
+#include "Core.hpp"
+#include "Expected.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Read-only memory mapping of a whole file (mmap / MapViewOfFile).
+/// Cache readers verify and read FlatBuffers straight out of the mapping instead of copying
+/// the file into a heap buffer first. Move-only; the view is unmapped on destruction.
+class NOC_EXPORT MappedFile
+{
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// Maps `path` for reading. Empty files are an error.
+    static Result<MappedFile> open(const std::filesystem::path& path);
+
+    const std::uint8_t* data() const noexcept
+    {
+        return m_data;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    std::span<const std::uint8_t> bytes() const noexcept
+    {
+        return {m_data, m_size};
+    }
+
+    void close() noexcept;
+
+  private:
+    const std::uint8_t* m_data{nullptr};
+    std::size_t m_size{0};
+#ifdef _WIN32
+    void* m_mapping{nullptr}; // HANDLE of the file mapping object
+#endif
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,61 @@
+#pragma once
+#include "Core.hpp"
+#include "Expected.hpp"
+#include "MappedFile.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+struct PackArchiveStats
+{
+    std::uint32_t fileCount{};
+    std::uint64_t byteCount{}; // archive size on disk
+};
+
+/// A .noc_pak archive: many files in one memory mapping, so a shipping build opens one file
+/// instead of thousands. Layout: a header page, the entries (each starting on an
+/// `EntryAlignment` boundary) and a FlatBuffers index (PackIndexAsset) sorted by path hash.
+class NOC_EXPORT PackArchive
+{
+  public:
+    static constexpr std::uint32_t Version{1};
+    static constexpr std::uint64_t EntryAlignment{4096};
+    /// File name of a bundle's content archive, at the content root it mounts over.
+    static constexpr std::string_view ContentArchiveName{"Content.noc_pak"};
+
+    /// Maps the archive and verifies its header and index.
+    static Result<PackArchive> open(const std::filesystem::path& path);
+
+    /// Writes `files` (absolute, all under `sourceRoot`) into a new archive at `archivePath`,
+    /// keyed by their path relative to `sourceRoot`.
+    static Result<PackArchiveStats> build(const std::filesystem::path& sourceRoot,
+                                          const std::vector<std::filesystem::path>& files,
+                                          const std::filesystem::path& archivePath);
+
+    static std::uint64_t hash_path(std::string_view relativePath) noexcept;
+
+    /// Bytes of the entry at `relativePath` (generic separators) inside the mapping.
+    std::optional<std::span<const std::uint8_t>> find(std::string_view relativePath) const;
+
+    /// Relative paths of all entries, in index order.
+    std::vector<std::string_view> entry_paths() const;
+
+    /// The mapping entry bytes point into; hold it to keep them alive.
+    const std::shared_ptr<const MappedFile>& mapping() const noexcept
+    {
+        return m_file;
+    }
+
+  private:
+    std::shared_ptr<const MappedFile> m_file{};
+    const std::uint8_t* m_index{nullptr};
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,90 @@
+#pragma once
+#include "Core.hpp"
+#include "Expected.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#if NOC_PROFILING_TRACY
+#include <tracy/Tracy.hpp>
+#endif
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// CPU zone profiler. Zones are recorded into a ring buffer per thread (single writer, no locks
+/// on the hot path) while a capture runs, and written out as Chrome trace_event JSON, viewable in
+/// chrome://tracing or Perfetto. Any thread may record: the main thread, JobSystem/Taskflow
+/// workers and the Jolt jobs running on them. When the ring of a thread fills up its oldest
+/// zones are overwritten, so a capture keeps the most recent ThreadEventCapacity zones per thread.
+class NOC_EXPORT Profiler
+{
+  public:
+    static constexpr std::uint32_t ThreadEventCapacity{1u << 16};
+
+    /// Starts recording zones. Previous capture data is discarded.
+    static void start_capture() noexcept;
+
+    /// Stops recording and writes the capture to `path`. Zones still open are not included.
+    static Result<> stop_capture(const std::filesystem::path& path);
+
+    static bool is_capturing() noexcept;
+
+    /// Labels the calling thread in exported traces. Unnamed threads show up as "Thread <n>".
+    static void set_thread_name(std::string_view name);
+
+    /// Nanoseconds on the steady clock the zones are timed with.
+    static std::uint64_t now_ns() noexcept;
+
+    /// Records a finished zone on the calling thread. `name` must outlive the capture (a literal).
+    static void record_zone(const char* name, std::uint64_t beginNs, std::uint64_t endNs) noexcept;
+};
+
+/// Times its own lifetime as a zone; use through NOC_PROFILE_ZONE.
+class ProfileZone
+{
+  public:
+    explicit ProfileZone(const char* name) noexcept
+        : m_name(name), m_beginNs(Profiler::is_capturing() ? Profiler::now_ns() : 0)
+    {
+    }
+    ~ProfileZone()
+    {
+        if (m_beginNs != 0)
+            Profiler::record_zone(m_name, m_beginNs, Profiler::now_ns());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+  private:
+    const char* m_name;
+    std::uint64_t m_beginNs;
+};
+
+NOC_RESTORE_DLL_WARNINGS
+
+#define NOC_PROFILE_CONCAT_DETAIL(a, b) a##b
+#define NOC_PROFILE_CONCAT(a, b) NOC_PROFILE_CONCAT_DETAIL(a, b)
+
+// NOC_PROFILE_ZONE("Name") times the enclosing scope. Compiled out unless NOC_PROFILING is set;
+// with NOC_PROFILING_TRACY the zone is also sent to a connected Tracy profiler.
+#if NOC_PROFILING_TRACY
+#define NOC_PROFILE_ZONE(name)                                                                                         \
+    ZoneScopedN(name);                                                                                                 \
+    const ::ProfileZone NOC_PROFILE_CONCAT(nocProfileZone, __COUNTER__)                                                 \
+    {                                                                                                                  \
+        name                                                                                                           \
+    }
+#define NOC_PROFILE_FRAME_MARK() FrameMark
+#elif NOC_PROFILING
+#define NOC_PROFILE_ZONE(name)                                                                                         \
+    const ::ProfileZone NOC_PROFILE_CONCAT(nocProfileZone, __COUNTER__)                                                 \
+    {                                                                                                                  \
+        name                                                                                                           \
+    }
+#define NOC_PROFILE_FRAME_MARK() ((void)0)
+#else
+#define NOC_PROFILE_ZONE(name) ((void)0)
+#define NOC_PROFILE_FRAME_MARK() ((void)0)
+#endif
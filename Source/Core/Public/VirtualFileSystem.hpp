@@ -0,0 +1,97 @@
+#pragma once
+#include "Core.hpp"
+#include "Expected.hpp"
+#include "MappedFile.hpp"
+#include "PackArchive.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Read-only bytes of one file: a mapping of its own, or a slice of a mounted archive's mapping.
+/// Move-only like MappedFile; an archive slice keeps the archive mapped while it lives.
+class NOC_EXPORT FileView
+{
+  public:
+    FileView() = default;
+    explicit FileView(MappedFile file) noexcept;
+    FileView(std::shared_ptr<const MappedFile> archive, std::span<const std::uint8_t> bytes) noexcept;
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+    FileView(FileView&&) noexcept = default;
+    FileView& operator=(FileView&&) noexcept = default;
+
+    const std::uint8_t* data() const noexcept
+    {
+        return m_bytes.data();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_bytes.size();
+    }
+
+    std::span<const std::uint8_t> bytes() const noexcept
+    {
+        return m_bytes;
+    }
+
+    std::string_view text() const noexcept
+    {
+        return {reinterpret_cast<const char*>(m_bytes.data()), m_bytes.size()};
+    }
+
+  private:
+    MappedFile m_file{};
+    std::shared_ptr<const MappedFile> m_archive{};
+    std::span<const std::uint8_t> m_bytes{};
+};
+
+/// Serves engine and game file reads from mounted .noc_pak archives first and the loose file
+/// system second. Shipping bundles mount their content archive over the content root at startup;
+/// in development nothing is mounted and every read goes to the loose files.
+class NOC_EXPORT VirtualFileSystem
+{
+  public:
+    static VirtualFileSystem& get();
+
+    /// Makes the entries of `archivePath` appear under `mountRoot`. Later mounts win over earlier ones.
+    Result<> mount(const std::filesystem::path& archivePath, const std::filesystem::path& mountRoot);
+    void unmount_all();
+
+    /// True when `path` is in a mounted archive or on disk.
+    bool exists(const std::filesystem::path& path) const;
+    /// True when `path` is served from a mounted archive.
+    bool is_archived(const std::filesystem::path& path) const;
+
+    /// Maps `path`, preferring a mounted archive. Empty loose files are an error (MappedFile::open).
+    Result<FileView> open(const std::filesystem::path& path) const;
+
+    /// Files under `directory` (recursively) with the given extension, archived and loose.
+    std::vector<std::filesystem::path> list_files(const std::filesystem::path& directory, std::string_view extension) const;
+
+  private:
+    struct Mount
+    {
+        std::filesystem::path root{};
+        PackArchive archive{};
+    };
+
+    /// The archived bytes of `path` and the mapping holding them; empty when no mount has it.
+    std::optional<FileView> find_archived(const std::filesystem::path& path) const;
+
+    mutable std::shared_mutex m_mutex{};
+    std::vector<Mount> m_mounts{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,141 @@
+#include "../Public/EntityPool.hpp"
+#include "../../Core/Public/Profiler.hpp"
+#include "../Public/World.hpp"
+
+#include <algorithm>
+#include <utility>
+
+EntityPool::EntityPool(Prefab prefab) : m_prefab(std::move(prefab))
+{
+    m_nodeCount = m_prefab.is_valid() ? m_prefab.nodes.size() : 0;
+}
+
+void EntityPool::acquire(World& world, std::span<const TransformComponent> transforms, std::span<entt::entity> outRoots)
+{
+    const std::size_t count = std::min(transforms.size(), outRoots.size());
+    if (m_nodeCount == 0)
+    {
+        std::fill_n(outRoots.begin(), count, entt::null);
+        return;
+    }
+    NOC_PROFILE_ZONE("EntityPool::acquire");
+
+    std::size_t placed = 0;
+    while (placed < count && !m_freeSlots.empty())
+    {
+        const std::uint32_t slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        if (!is_alive(world, slot))
+            continue; // destroyed with its level; the slot is abandoned
+        show(world, slot, transforms[placed]);
+        outRoots[placed++] = m_entities[slot * m_nodeCount];
+    }
+
+    const std::size_t spawnCount = count - placed;
+    if (spawnCount > 0)
+    {
+        world.spawn_prefab(m_prefab, transforms.subspan(placed, spawnCount), m_spawnScratch);
+        const auto firstSlot = static_cast<std::uint32_t>(m_live.size());
+        m_entities.resize(m_entities.size() + spawnCount * m_nodeCount);
+        m_live.resize(m_live.size() + spawnCount, 1);
+        for (std::size_t instance = 0; instance < spawnCount; ++instance)
+        {
+            // spawn_prefab() hands entities out node-major; the pool keeps each instance together.
+            const std::uint32_t slot = firstSlot + static_cast<std::uint32_t>(instance);
+            for (std::size_t node = 0; node < m_nodeCount; ++node)
+                m_entities[slot * m_nodeCount + node] = m_spawnScratch[node * spawnCount + instance];
+
+            const entt::entity root = m_spawnScratch[instance];
+            const auto entityIndex = static_cast<std::size_t>(entt::to_entity(root));
+            if (entityIndex >= m_slotByEntity.size())
+                m_slotByEntity.resize(entityIndex + 1, InvalidSlot);
+            m_slotByEntity[entityIndex] = slot;
+            outRoots[placed + instance] = root;
+        }
+    }
+    m_liveCount += count;
+}
+
+bool EntityPool::release(World& world, entt::entity root)
+{
+    const std::uint32_t slot = slot_of(root);
+    if (slot == InvalidSlot || m_live[slot] == 0)
+        return false;
+
+    m_live[slot] = 0;
+    --m_liveCount;
+    if (!is_alive(world, slot))
+        return false;
+
+    hide(world, slot);
+    m_freeSlots.push_back(slot);
+    return true;
+}
+
+bool EntityPool::owns(entt::entity root) const noexcept
+{
+    const std::uint32_t slot = slot_of(root);
+    return slot != InvalidSlot && m_live[slot] != 0;
+}
+
+std::uint32_t EntityPool::slot_of(entt::entity root) const noexcept
+{
+    if (root == entt::null || m_nodeCount == 0)
+        return InvalidSlot;
+    const auto entityIndex = static_cast<std::size_t>(entt::to_entity(root));
+    if (entityIndex >= m_slotByEntity.size())
+        return InvalidSlot;
+    // Entity indices are recycled by the registry, so the version has to match too.
+    const std::uint32_t slot = m_slotByEntity[entityIndex];
+    return slot != InvalidSlot && m_entities[slot * m_nodeCount] == root ? slot : InvalidSlot;
+}
+
+bool EntityPool::is_alive(const World& world, std::uint32_t slot) const
+{
+    const auto& reg = world.registry();
+    for (std::size_t node = 0; node < m_nodeCount; ++node)
+    {
+        if (!reg.valid(m_entities[slot * m_nodeCount + node]))
+            return false;
+    }
+    return true;
+}
+
+void EntityPool::show(World& world, std::uint32_t slot, const TransformComponent& transform)
+{
+    auto& reg = world.registry();
+    for (std::size_t node = 0; node < m_nodeCount; ++node)
+    {
+        const entt::entity entity = m_entities[slot * m_nodeCount + node];
+        const Prefab::Node& values = m_prefab.nodes[node];
+        reg.get<TransformComponent>(entity) = node == 0 ? transform : values.transform;
+        if (values.mesh)
+        {
+            reg.emplace_or_replace<MeshComponent>(entity, *values.mesh);
+            world.mark_renderable_dirty(entity);
+        }
+        if (values.physicsBody)
+            reg.emplace_or_replace<PhysicsBodyComponent>(entity, *values.physicsBody);
+        if (values.light)
+            reg.emplace_or_replace<LightComponent>(entity, *values.light);
+    }
+    world.mark_transform_dirty(m_entities[slot * m_nodeCount]);
+    m_live[slot] = 1;
+}
+
+void EntityPool::hide(World& world, std::uint32_t slot)
+{
+    auto& reg = world.registry();
+    for (std::size_t node = 0; node < m_nodeCount; ++node)
+    {
+        const entt::entity entity = m_entities[slot * m_nodeCount + node];
+        if (auto* mesh = reg.try_get<MeshComponent>(entity))
+        {
+            mesh->meshIndex = -1;
+            world.mark_renderable_dirty(entity);
+        }
+        if (const auto* body = reg.try_get<PhysicsBodyComponent>(entity); body && body->enabled)
+            reg.patch<PhysicsBodyComponent>(entity, [](PhysicsBodyComponent& b) { b.enabled = false; });
+        reg.remove<LightComponent>(entity);
+    }
+}
@@ -0,0 +1,59 @@
+#include "../Public/Prefab.hpp"
+#include "../Public/World.hpp"
+
+#include <utility>
+
+Prefab Prefab::from_subtree(const World& world, entt::entity root)
+{
+    Prefab prefab{};
+    const auto& reg = world.registry();
+    if (!reg.valid(root))
+        return prefab;
+
+    std::vector<std::pair<entt::entity, std::int32_t>> stack{{root, -1}};
+    while (!stack.empty())
+    {
+        const auto [entity, parent] = stack.back();
+        stack.pop_back();
+        if (!reg.valid(entity))
+            continue;
+
+        const auto nodeIndex = static_cast<std::int32_t>(prefab.nodes.size());
+        Node& node = prefab.nodes.emplace_back();
+        node.parent = parent;
+        if (const auto* name = reg.try_get<NameComponent>(entity))
+            node.name = name->name;
+        if (const auto* transform = reg.try_get<TransformComponent>(entity))
+            node.transform = *transform;
+        if (const auto* mesh = reg.try_get<MeshComponent>(entity))
+            node.mesh = *mesh;
+        if (const auto* body = reg.try_get<PhysicsBodyComponent>(entity))
+        {
+            node.physicsBody = *body;
+            node.physicsBody->runtimeDirty = true;
+            node.physicsBody->runtimeInitialized = false;
+        }
+        if (const auto* light = reg.try_get<LightComponent>(entity))
+            node.light = *light;
+
+        // Reversed, so children come out of the stack in their original order.
+        if (const auto* hierarchy = reg.try_get<HierarchyComponent>(entity))
+        {
+            for (auto it = hierarchy->children.rbegin(); it != hierarchy->children.rend(); ++it)
+                stack.emplace_back(*it, nodeIndex);
+        }
+    }
+    return prefab;
+}
+
+bool Prefab::is_valid() const noexcept
+{
+    if (nodes.empty() || nodes[0].parent != -1)
+        return false;
+    for (std::size_t i = 1; i < nodes.size(); ++i)
+    {
+        if (nodes[i].parent < 0 || static_cast<std::size_t>(nodes[i].parent) >= i)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,399 @@
+#include "../Public/SpatialIndex.hpp"
+#include "../../Rendering/Public/FrustumCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace DirectX;
+
+namespace
+{
+/// Cell coordinates are clamped so each axis fits the 21 bits it gets in a cell key.
+constexpr std::int32_t MaxCellCoord{(1 << 20) - 1};
+
+bool boxes_overlap(const XMFLOAT3& aMin, const XMFLOAT3& aMax, const XMFLOAT3& bMin, const XMFLOAT3& bMax) noexcept
+{
+    return aMin.x <= bMax.x && aMax.x >= bMin.x && aMin.y <= bMax.y && aMax.y >= bMin.y && aMin.z <= bMax.z &&
+           aMax.z >= bMin.z;
+}
+
+bool box_touches_sphere(const XMFLOAT3& boxMin, const XMFLOAT3& boxMax, const XMFLOAT3& center, float radius) noexcept
+{
+    const float dx = center.x - std::clamp(center.x, boxMin.x, boxMax.x);
+    const float dy = center.y - std::clamp(center.y, boxMin.y, boxMax.y);
+    const float dz = center.z - std::clamp(center.z, boxMin.z, boxMax.z);
+    return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+/// A box is outside when its most positive corner lies behind any plane.
+bool box_touches_frustum(const XMFLOAT3& boxMin, const XMFLOAT3& boxMax, const FrustumPlanes& frustum) noexcept
+{
+    for (const XMFLOAT4& plane : frustum.planes)
+    {
+        const float x = plane.x >= 0.0f ? boxMax.x : boxMin.x;
+        const float y = plane.y >= 0.0f ? boxMax.y : boxMin.y;
+        const float z = plane.z >= 0.0f ? boxMax.z : boxMin.z;
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+/// Slab test. Returns the entry distance in [0, maxDistance], or a negative value on a miss.
+float ray_box_distance(const XMFLOAT3& origin, const XMFLOAT3& inverseDirection, const XMFLOAT3& boxMin,
+                       const XMFLOAT3& boxMax, float maxDistance) noexcept
+{
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+    const float origins[3]{origin.x, origin.y, origin.z};
+    const float inverse[3]{inverseDirection.x, inverseDirection.y, inverseDirection.z};
+    const float mins[3]{boxMin.x, boxMin.y, boxMin.z};
+    const float maxs[3]{boxMax.x, boxMax.y, boxMax.z};
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (std::isinf(inverse[axis]))
+        {
+            // Parallel to the slab: hit only when the origin lies between its planes.
+            if (origins[axis] < mins[axis] || origins[axis] > maxs[axis])
+                return -1.0f;
+            continue;
+        }
+        float t0 = (mins[axis] - origins[axis]) * inverse[axis];
+        float t1 = (maxs[axis] - origins[axis]) * inverse[axis];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax)
+            return -1.0f;
+    }
+    return tMin;
+}
+} // namespace
+
+SpatialIndex::SpatialIndex(float cellSize)
+    : m_cellSize{cellSize > 0.0f ? cellSize : DefaultCellSize}, m_inverseCellSize{1.0f / m_cellSize}
+{}
+
+std::int32_t SpatialIndex::cell_coord(float value) const noexcept
+{
+    const float cell = std::floor(value * m_inverseCellSize);
+    if (!(cell > -static_cast<float>(MaxCellCoord)))
+        return -MaxCellCoord; // also catches NaN
+    if (cell > static_cast<float>(MaxCellCoord))
+        return MaxCellCoord;
+    return static_cast<std::int32_t>(cell);
+}
+
+SpatialIndex::CellRange SpatialIndex::cell_range(const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) const noexcept
+{
+    return {cell_coord(boundsMin.x), cell_coord(boundsMin.y), cell_coord(boundsMin.z),
+            cell_coord(boundsMax.x), cell_coord(boundsMax.y), cell_coord(boundsMax.z)};
+}
+
+std::uint64_t SpatialIndex::cell_key(std::int32_t x, std::int32_t y, std::int32_t z) noexcept
+{
+    constexpr std::uint64_t Mask{(1u << 21) - 1u};
+    return (static_cast<std::uint64_t>(x + MaxCellCoord) & Mask) |
+           (static_cast<std::uint64_t>(y + MaxCellCoord) & Mask) << 21 |
+           (static_cast<std::uint64_t>(z + MaxCellCoord) & Mask) << 42;
+}
+
+std::size_t SpatialIndex::cell_count(const CellRange& range) noexcept
+{
+    return static_cast<std::size_t>(range[3] - range[0] + 1) * static_cast<std::size_t>(range[4] - range[1] + 1) *
+           static_cast<std::size_t>(range[5] - range[2] + 1);
+}
+
+std::uint32_t SpatialIndex::slot_of(entt::entity entity) const noexcept
+{
+    if (entity == entt::null)
+        return InvalidSlot;
+    const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+    if (entityIndex >= m_slotByEntity.size())
+        return InvalidSlot;
+    const std::uint32_t slot = m_slotByEntity[entityIndex];
+    return slot != InvalidSlot && m_items[slot].entity == entity ? slot : InvalidSlot;
+}
+
+void SpatialIndex::link(std::uint32_t slot)
+{
+    Item& item = m_items[slot];
+    item.unbounded = cell_count(item.cells) > MaxCellsPerItem;
+    if (item.unbounded)
+    {
+        m_unbounded.push_back(slot);
+        return;
+    }
+    for (std::int32_t z = item.cells[2]; z <= item.cells[5]; ++z)
+        for (std::int32_t y = item.cells[1]; y <= item.cells[4]; ++y)
+            for (std::int32_t x = item.cells[0]; x <= item.cells[3]; ++x)
+                m_cells[cell_key(x, y, z)].push_back(slot);
+}
+
+void SpatialIndex::unlink(std::uint32_t slot)
+{
+    const Item& item = m_items[slot];
+    const auto erase_slot = [slot](std::vector<std::uint32_t>& slots) {
+        const auto it = std::find(slots.begin(), slots.end(), slot);
+        if (it != slots.end())
+        {
+            *it = slots.back();
+            slots.pop_back();
+        }
+    };
+
+    if (item.unbounded)
+    {
+        erase_slot(m_unbounded);
+        return;
+    }
+    for (std::int32_t z = item.cells[2]; z <= item.cells[5]; ++z)
+        for (std::int32_t y = item.cells[1]; y <= item.cells[4]; ++y)
+            for (std::int32_t x = item.cells[0]; x <= item.cells[3]; ++x)
+            {
+                const auto it = m_cells.find(cell_key(x, y, z));
+                if (it == m_cells.end())
+                    continue;
+                erase_slot(it->second);
+                if (it->second.empty())
+                    m_cells.erase(it);
+            }
+}
+
+void SpatialIndex::update(entt::entity entity, const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax)
+{
+    if (entity == entt::null)
+        return;
+
+    const CellRange cells = cell_range(boundsMin, boundsMax);
+    std::uint32_t slot = slot_of(entity);
+    if (slot != InvalidSlot)
+    {
+        Item& item = m_items[slot];
+        item.boundsMin = boundsMin;
+        item.boundsMax = boundsMax;
+        if (item.cells == cells)
+            return; // moved within the same cells: nothing to relink
+        unlink(slot);
+        m_items[slot].cells = cells;
+        link(slot);
+        return;
+    }
+
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<std::uint32_t>(m_items.size());
+        m_items.emplace_back();
+    }
+    m_items[slot] = Item{boundsMin, boundsMax, cells, entity, false};
+
+    const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+    if (entityIndex >= m_slotByEntity.size())
+        m_slotByEntity.resize(entityIndex + 1, InvalidSlot);
+    m_slotByEntity[entityIndex] = slot;
+    link(slot);
+}
+
+void SpatialIndex::remove(entt::entity entity)
+{
+    const std::uint32_t slot = slot_of(entity);
+    if (slot == InvalidSlot)
+        return;
+    unlink(slot);
+    m_items[slot].entity = entt::null;
+    m_slotByEntity[static_cast<std::size_t>(entt::to_entity(entity))] = InvalidSlot;
+    m_freeSlots.push_back(slot);
+}
+
+void SpatialIndex::clear() noexcept
+{
+    m_items.clear();
+    m_freeSlots.clear();
+    m_slotByEntity.clear();
+    m_cells.clear();
+    m_unbounded.clear();
+}
+
+void SpatialIndex::gather(const CellRange& range, std::vector<std::uint32_t>& outSlots) const
+{
+    const std::size_t begin = outSlots.size();
+    outSlots.insert(outSlots.end(), m_unbounded.begin(), m_unbounded.end());
+
+    if (cell_count(range) <= m_cells.size())
+    {
+        for (std::int32_t z = range[2]; z <= range[5]; ++z)
+            for (std::int32_t y = range[1]; y <= range[4]; ++y)
+                for (std::int32_t x = range[0]; x <= range[3]; ++x)
+                {
+                    const auto it = m_cells.find(cell_key(x, y, z));
+                    if (it != m_cells.end())
+                        outSlots.insert(outSlots.end(), it->second.begin(), it->second.end());
+                }
+    }
+    else
+    {
+        // The query spans more cells than are occupied: walk the occupied ones instead.
+        const CellRange keyRange{range[0] + MaxCellCoord, range[1] + MaxCellCoord, range[2] + MaxCellCoord,
+                                 range[3] + MaxCellCoord, range[4] + MaxCellCoord, range[5] + MaxCellCoord};
+        for (const auto& [key, slots] : m_cells)
+        {
+            constexpr std::uint64_t Mask{(1u << 21) - 1u};
+            const auto x = static_cast<std::int32_t>(key & Mask);
+            const auto y = static_cast<std::int32_t>((key >> 21) & Mask);
+            const auto z = static_cast<std::int32_t>((key >> 42) & Mask);
+            if (x >= keyRange[0] && x <= keyRange[3] && y >= keyRange[1] && y <= keyRange[4] && z >= keyRange[2] &&
+                z <= keyRange[5])
+                outSlots.insert(outSlots.end(), slots.begin(), slots.end());
+        }
+    }
+
+    // A box spanning several cells was gathered once per cell.
+    std::sort(outSlots.begin() + static_cast<std::ptrdiff_t>(begin), outSlots.end());
+    outSlots.erase(std::unique(outSlots.begin() + static_cast<std::ptrdiff_t>(begin), outSlots.end()), outSlots.end());
+}
+
+void SpatialIndex::query_aabb(const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax, std::vector<entt::entity>& out) const
+{
+    std::vector<std::uint32_t> slots{};
+    gather(cell_range(boundsMin, boundsMax), slots);
+    for (std::uint32_t slot : slots)
+    {
+        const Item& item = m_items[slot];
+        if (boxes_overlap(item.boundsMin, item.boundsMax, boundsMin, boundsMax))
+            out.push_back(item.entity);
+    }
+}
+
+void SpatialIndex::query_sphere(const XMFLOAT3& center, float radius, std::vector<entt::entity>& out) const
+{
+    if (!(radius >= 0.0f))
+        return;
+
+    std::vector<std::uint32_t> slots{};
+    gather(cell_range({center.x - radius, center.y - radius, center.z - radius},
+                      {center.x + radius, center.y + radius, center.z + radius}),
+           slots);
+    for (std::uint32_t slot : slots)
+    {
+        const Item& item = m_items[slot];
+        if (box_touches_sphere(item.boundsMin, item.boundsMax, center, radius))
+            out.push_back(item.entity);
+    }
+}
+
+void SpatialIndex::query_frustum(const FrustumPlanes& frustum, std::vector<entt::entity>& out) const
+{
+    std::vector<std::uint32_t> slots{m_unbounded};
+    for (const auto& [key, cellSlots] : m_cells)
+    {
+        constexpr std::uint64_t Mask{(1u << 21) - 1u};
+        const float x = static_cast<float>(static_cast<std::int32_t>(key & Mask) - MaxCellCoord) * m_cellSize;
+        const float y = static_cast<float>(static_cast<std::int32_t>((key >> 21) & Mask) - MaxCellCoord) * m_cellSize;
+        const float z = static_cast<float>(static_cast<std::int32_t>((key >> 42) & Mask) - MaxCellCoord) * m_cellSize;
+        if (box_touches_frustum({x, y, z}, {x + m_cellSize, y + m_cellSize, z + m_cellSize}, frustum))
+            slots.insert(slots.end(), cellSlots.begin(), cellSlots.end());
+    }
+    std::sort(slots.begin(), slots.end());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+
+    for (std::uint32_t slot : slots)
+    {
+        const Item& item = m_items[slot];
+        if (box_touches_frustum(item.boundsMin, item.boundsMax, frustum))
+            out.push_back(item.entity);
+    }
+}
+
+std::optional<SpatialIndex::RayHit> SpatialIndex::raycast(const XMFLOAT3& origin, const XMFLOAT3& direction,
+                                                          float maxDistance, entt::entity ignore) const
+{
+    const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+    if (!(length > 0.0f) || !(maxDistance >= 0.0f))
+        return std::nullopt;
+
+    const XMFLOAT3 dir{direction.x / length, direction.y / length, direction.z / length};
+    const XMFLOAT3 inverseDir{1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z};
+
+    RayHit best{entt::null, maxDistance};
+    const auto test_slot = [&](std::uint32_t slot) {
+        const Item& item = m_items[slot];
+        if (item.entity == ignore)
+            return;
+        const float t = ray_box_distance(origin, inverseDir, item.boundsMin, item.boundsMax, best.distance);
+        if (t >= 0.0f && (best.entity == entt::null || t < best.distance))
+            best = RayHit{item.entity, t};
+    };
+
+    for (std::uint32_t slot : m_unbounded)
+        test_slot(slot);
+
+    // Amanatides-Woo grid walk. Boxes are linked into every cell they overlap, so the walk can
+    // stop once the next cell starts beyond the nearest hit so far.
+    std::int32_t cell[3]{cell_coord(origin.x), cell_coord(origin.y), cell_coord(origin.z)};
+    const float originAxis[3]{origin.x, origin.y, origin.z};
+    const float dirAxis[3]{dir.x, dir.y, dir.z};
+    std::int32_t step[3]{};
+    float tNext[3]{};
+    float tDelta[3]{};
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (dirAxis[axis] > 0.0f)
+        {
+            step[axis] = 1;
+            tNext[axis] = (static_cast<float>(cell[axis] + 1) * m_cellSize - originAxis[axis]) / dirAxis[axis];
+            tDelta[axis] = m_cellSize / dirAxis[axis];
+        }
+        else if (dirAxis[axis] < 0.0f)
+        {
+            step[axis] = -1;
+            tNext[axis] = (static_cast<float>(cell[axis]) * m_cellSize - originAxis[axis]) / dirAxis[axis];
+            tDelta[axis] = -m_cellSize / dirAxis[axis];
+        }
+        else
+        {
+            tNext[axis] = std::numeric_limits<float>::infinity();
+            tDelta[axis] = std::numeric_limits<float>::infinity();
+        }
+    }
+
+    float tCell = 0.0f;
+    for (std::uint32_t steps = 0; steps < MaxRaySteps && !m_cells.empty(); ++steps)
+    {
+        if (tCell > maxDistance || (best.entity != entt::null && tCell > best.distance))
+            break;
+
+        if (const auto it = m_cells.find(cell_key(cell[0], cell[1], cell[2])); it != m_cells.end())
+        {
+            for (std::uint32_t slot : it->second)
+                test_slot(slot);
+        }
+
+        const int axis = tNext[0] < tNext[1] ? (tNext[0] < tNext[2] ? 0 : 2) : (tNext[1] < tNext[2] ? 1 : 2);
+        tCell = tNext[axis];
+        tNext[axis] += tDelta[axis];
+        cell[axis] += step[axis];
+        if (cell[axis] < -MaxCellCoord || cell[axis] > MaxCellCoord)
+            break;
+    }
+
+    if (best.entity == entt::null)
+        return std::nullopt;
+    return best;
+}
+
+bool SpatialIndex::get_bounds(entt::entity entity, XMFLOAT3& outMin, XMFLOAT3& outMax) const noexcept
+{
+    const std::uint32_t slot = slot_of(entity);
+    if (slot == InvalidSlot)
+        return false;
+    outMin = m_items[slot].boundsMin;
+    outMax = m_items[slot].boundsMax;
+    return true;
+}
@@ -1,9 +1,182 @@
 #include "../Public/World.hpp"
+#include "../../Core/Public/FrameArena.hpp"
+#include "../../Core/Public/Profiler.hpp"
+#include "../../Rendering/Public/IRenderer.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <memory_resource>
+
+#include <taskflow/algorithm/for_each.hpp>
+#include <taskflow/taskflow.hpp>
 
 using namespace DirectX;
 
+namespace
+{
+constexpr std::uint32_t InvalidRenderableIndex{UINT32_MAX};
+
+/// Stable renderable list plus the bookkeeping for extracting it incrementally.
+/// Stored in the registry context so the construct/destroy listeners need no World pointer.
+struct RenderableTracker
+{
+    std::vector<Renderable> renderables;          // swap-removed, so indices are dense but not stable
+    std::vector<std::uint32_t> indexByEntity;     // by entt::to_entity(), InvalidRenderableIndex when absent
+    std::vector<entt::entity> queuedByEntity;     // by entt::to_entity(), the full id sitting in refreshQueue
+    std::vector<entt::entity> refreshQueue;       // entities to re-extract on the next collect
+    std::vector<std::uint8_t> changed;            // parallel to renderables, index sits in changedIndices
+    std::vector<std::uint32_t> changedIndices;    // renderables to report in the next delta
+    std::vector<std::uint32_t> removedEntityIds;  // entities to report as removed in the next delta
+    bool allDirty{true};
+
+    void queue(entt::entity entity)
+    {
+        const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+        if (entityIndex >= queuedByEntity.size())
+            queuedByEntity.resize(entityIndex + 1, entt::null);
+        // Compare the version too: a destroyed entity still queued must not hide a new one reusing its index.
+        if (queuedByEntity[entityIndex] == entity)
+            return;
+        queuedByEntity[entityIndex] = entity;
+        refreshQueue.push_back(entity);
+    }
+
+    std::uint32_t index_of(entt::entity entity) const noexcept
+    {
+        const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+        return entityIndex < indexByEntity.size() ? indexByEntity[entityIndex] : InvalidRenderableIndex;
+    }
+
+    void mark_changed(std::uint32_t index)
+    {
+        if (changed[index] != 0)
+            return;
+        changed[index] = 1;
+        changedIndices.push_back(index);
+    }
+
+    void upsert(entt::entity entity, const Renderable& renderable)
+    {
+        std::uint32_t index = index_of(entity);
+        if (index == InvalidRenderableIndex)
+        {
+            index = static_cast<std::uint32_t>(renderables.size());
+            renderables.push_back(renderable);
+            changed.push_back(0);
+            const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+            if (entityIndex >= indexByEntity.size())
+                indexByEntity.resize(entityIndex + 1, InvalidRenderableIndex);
+            indexByEntity[entityIndex] = index;
+        }
+        else
+        {
+            renderables[index] = renderable;
+        }
+        mark_changed(index);
+    }
+
+    void remove(entt::entity entity)
+    {
+        const std::uint32_t index = index_of(entity);
+        if (index == InvalidRenderableIndex)
+            return;
+        removedEntityIds.push_back(static_cast<std::uint32_t>(entity));
+        indexByEntity[static_cast<std::size_t>(entt::to_entity(entity))] = InvalidRenderableIndex;
+
+        // Swap-remove. The renderer matches by entityId, so a move alone is not a change,
+        // but a pending change of the moved entry has to follow it.
+        const auto last = static_cast<std::uint32_t>(renderables.size() - 1);
+        if (index != last)
+        {
+            renderables[index] = renderables[last];
+            indexByEntity[static_cast<std::size_t>(entt::to_entity(static_cast<entt::entity>(renderables[index].entityId)))] =
+                index;
+            if (changed[last] != 0)
+                mark_changed(index);
+        }
+        renderables.pop_back();
+        changed.pop_back();
+    }
+};
+
+/// Grows a component pool once ahead of a bulk insert.
+template <typename Component> void reserve_storage(entt::registry& registry, std::size_t extra)
+{
+    if (extra == 0)
+        return;
+    auto& storage = registry.storage<Component>();
+    storage.reserve(storage.size() + extra);
+}
+
+RenderableTracker& renderable_tracker(entt::registry& registry)
+{
+    return registry.ctx().get<RenderableTracker>();
+}
+
+void on_mesh_construct(entt::registry& registry, entt::entity entity)
+{
+    renderable_tracker(registry).queue(entity);
+}
+
+void on_mesh_destroy(entt::registry& registry, entt::entity entity)
+{
+    renderable_tracker(registry).remove(entity);
+    registry.ctx().get<SpatialIndex>().remove(entity);
+}
+
+/// World-space box of a local box under an affine matrix (Arvo: extents through |M|).
+void transform_bounds(const MeshBounds& bounds, const XMFLOAT4X4& world, XMFLOAT3& outMin, XMFLOAT3& outMax) noexcept
+{
+    const XMFLOAT3 center{(bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f,
+                          (bounds.min.z + bounds.max.z) * 0.5f};
+    const XMFLOAT3 extents{(bounds.max.x - bounds.min.x) * 0.5f, (bounds.max.y - bounds.min.y) * 0.5f,
+                           (bounds.max.z - bounds.min.z) * 0.5f};
+
+    const XMFLOAT3 worldCenter{
+        center.x * world._11 + center.y * world._21 + center.z * world._31 + world._41,
+        center.x * world._12 + center.y * world._22 + center.z * world._32 + world._42,
+        center.x * world._13 + center.y * world._23 + center.z * world._33 + world._43,
+    };
+    const XMFLOAT3 worldExtents{
+        extents.x * std::fabs(world._11) + extents.y * std::fabs(world._21) + extents.z * std::fabs(world._31),
+        extents.x * std::fabs(world._12) + extents.y * std::fabs(world._22) + extents.z * std::fabs(world._32),
+        extents.x * std::fabs(world._13) + extents.y * std::fabs(world._23) + extents.z * std::fabs(world._33),
+    };
+    outMin = {worldCenter.x - worldExtents.x, worldCenter.y - worldExtents.y, worldCenter.z - worldExtents.z};
+    outMax = {worldCenter.x + worldExtents.x, worldCenter.y + worldExtents.y, worldCenter.z + worldExtents.z};
+}
+
+Renderable make_renderable(const entt::registry& registry, entt::entity entity, const MeshComponent& mesh,
+                           const WorldMatrixCache& cache)
+{
+    Renderable r{};
+    XMStoreFloat3x4(&r.worldMatrix, XMLoadFloat4x4(&cache.worldMatrix));
+    r.meshIndex = static_cast<uint32_t>(mesh.meshIndex);
+    r.materialIndex = static_cast<uint32_t>(mesh.materialIndex);
+    r.entityId = static_cast<uint32_t>(entity);
+    if (mesh.glowEnabled)
+    {
+        const float intensity = std::max(0.0f, mesh.glowIntensity);
+        r.glow = pack_rgb9e5({mesh.glowColor.x * intensity, mesh.glowColor.y * intensity, mesh.glowColor.z * intensity});
+    }
+    if (!registry.all_of<ScriptComponent>(entity))
+    {
+        const auto* body = registry.try_get<PhysicsBodyComponent>(entity);
+        r.isStatic = body == nullptr || !body->enabled || body->motionType == PhysicsBodyMotionType::Static;
+    }
+    return r;
+}
+} // namespace
+
+World::World()
+{
+    m_registry.ctx().emplace<RenderableTracker>();
+    m_registry.ctx().emplace<SpatialIndex>();
+    m_registry.on_construct<MeshComponent>().connect<&on_mesh_construct>();
+    m_registry.on_destroy<MeshComponent>().connect<&on_mesh_destroy>();
+}
+
 entt::entity World::create_entity(std::string name)
 {
     entt::entity entity = m_registry.create();
@@ -13,28 +186,138 @@ entt::entity World::create_entity(std::string name)
     m_registry.emplace<HierarchyComponent>(entity);
     m_registry.emplace<WorldMatrixCache>(entity);
     m_rootEntitiesDirty = true;
-    mark_transforms_dirty();
+    m_transformOrderDirty = true;
+    mark_transform_dirty(entity);
 
     return entity;
 }
 
+void World::create_entities(std::span<entt::entity> entities)
+{
+    if (entities.empty())
+        return;
+
+    m_registry.create(entities.begin(), entities.end());
+    m_registry.insert<NameComponent>(entities.begin(), entities.end());
+    m_registry.insert<TransformComponent>(entities.begin(), entities.end());
+    m_registry.insert<HierarchyComponent>(entities.begin(), entities.end());
+    m_registry.insert<WorldMatrixCache>(entities.begin(), entities.end());
+    m_rootEntitiesDirty = true;
+    m_transformOrderDirty = true;
+    mark_transforms_dirty();
+}
+
+void World::spawn_prefab(const Prefab& prefab, std::span<const TransformComponent> transforms,
+                         std::vector<entt::entity>& outEntities, entt::entity parent)
+{
+    outEntities.clear();
+    const std::size_t count = transforms.size();
+    if (count == 0 || !prefab.is_valid())
+        return;
+    NOC_PROFILE_ZONE("World::spawn_prefab");
+
+    const std::size_t nodeCount = prefab.nodes.size();
+    const std::size_t total = count * nodeCount;
+    const bool attach = parent != entt::null && m_registry.valid(parent);
+
+    std::size_t meshNodes = 0;
+    std::size_t bodyNodes = 0;
+    std::size_t lightNodes = 0;
+    for (const Prefab::Node& node : prefab.nodes)
+    {
+        meshNodes += node.mesh.has_value();
+        bodyNodes += node.physicsBody.has_value();
+        lightNodes += node.light.has_value();
+    }
+    reserve_storage<NameComponent>(m_registry, total);
+    reserve_storage<TransformComponent>(m_registry, total);
+    reserve_storage<HierarchyComponent>(m_registry, total);
+    reserve_storage<WorldMatrixCache>(m_registry, total);
+    reserve_storage<MeshComponent>(m_registry, meshNodes * count);
+    reserve_storage<PhysicsBodyComponent>(m_registry, bodyNodes * count);
+    reserve_storage<LightComponent>(m_registry, lightNodes * count);
+
+    outEntities.resize(total);
+    m_registry.create(outEntities.begin(), outEntities.end());
+
+    // Hierarchy links, built in full before one insert.
+    std::vector<std::uint32_t> childCounts(nodeCount, 0);
+    for (std::size_t node = 1; node < nodeCount; ++node)
+        ++childCounts[static_cast<std::size_t>(prefab.nodes[node].parent)];
+
+    std::vector<HierarchyComponent> hierarchies(total);
+    for (std::size_t node = 0; node < nodeCount; ++node)
+    {
+        const std::int32_t parentNode = prefab.nodes[node].parent;
+        for (std::size_t instance = 0; instance < count; ++instance)
+        {
+            HierarchyComponent& hierarchy = hierarchies[node * count + instance];
+            hierarchy.children.reserve(childCounts[node]);
+            if (parentNode < 0)
+            {
+                hierarchy.parent = attach ? parent : entt::null;
+                continue;
+            }
+            const std::size_t parentSlot = static_cast<std::size_t>(parentNode) * count + instance;
+            hierarchy.parent = outEntities[parentSlot];
+            hierarchies[parentSlot].children.push_back(outEntities[node * count + instance]);
+        }
+    }
+
+    const auto first = outEntities.begin();
+    m_registry.insert<HierarchyComponent>(first, outEntities.end(), std::make_move_iterator(hierarchies.begin()));
+    m_registry.insert<WorldMatrixCache>(first, outEntities.end());
+    m_registry.insert<TransformComponent>(first, first + static_cast<std::ptrdiff_t>(count), transforms.begin());
+    for (std::size_t node = 0; node < nodeCount; ++node)
+    {
+        const Prefab::Node& values = prefab.nodes[node];
+        const auto nodeFirst = first + static_cast<std::ptrdiff_t>(node * count);
+        const auto nodeLast = nodeFirst + static_cast<std::ptrdiff_t>(count);
+        m_registry.insert<NameComponent>(nodeFirst, nodeLast, NameComponent{values.name});
+        if (node != 0)
+            m_registry.insert<TransformComponent>(nodeFirst, nodeLast, values.transform);
+        if (values.mesh)
+            m_registry.insert<MeshComponent>(nodeFirst, nodeLast, *values.mesh);
+        if (values.physicsBody)
+            m_registry.insert<PhysicsBodyComponent>(nodeFirst, nodeLast, *values.physicsBody);
+        if (values.light)
+            m_registry.insert<LightComponent>(nodeFirst, nodeLast, *values.light);
+    }
+
+    if (attach)
+    {
+        auto& parentChildren = m_registry.get<HierarchyComponent>(parent).children;
+        parentChildren.insert(parentChildren.end(), first, first + static_cast<std::ptrdiff_t>(count));
+    }
+
+    m_rootEntitiesDirty = true;
+    m_transformOrderDirty = true;
+    for (std::size_t instance = 0; instance < count; ++instance)
+        mark_transform_dirty(outEntities[instance]);
+}
+
 void World::destroy_entity(entt::entity entity)
 {
     if (!m_registry.valid(entity))
         return;
     m_rootEntitiesDirty = true;
-    mark_transforms_dirty();
+    m_transformOrderDirty = true;
 
     // Recursively destroy all children first.
-    if (auto* hierarchy = m_registry.try_get<HierarchyComponent>(entity))
+    if (const auto* hierarchy = m_registry.try_get<HierarchyComponent>(entity))
     {
         // Copy children vector since we mutate it during recursion.
-        auto children = hierarchy->children;
+        const std::pmr::vector<entt::entity> children{hierarchy->children.begin(), hierarchy->children.end(),
+                                                      FrameArena::current()};
         for (entt::entity child : children)
         {
             destroy_entity(child);
         }
+    }
 
+    // Looked up again: destroying the children moves hierarchy components around in their storage.
+    if (const auto* hierarchy = m_registry.try_get<HierarchyComponent>(entity))
+    {
         // Remove ourselves from our parent's children list.
         if (hierarchy->parent != entt::null && m_registry.valid(hierarchy->parent))
         {
@@ -54,7 +337,8 @@ void World::set_parent(entt::entity child, entt::entity parent)
     if (!m_registry.valid(child) || !m_registry.valid(parent) || child == parent)
         return;
     m_rootEntitiesDirty = true;
-    mark_transforms_dirty();
+    m_transformOrderDirty = true;
+    mark_transform_dirty(child);
 
     auto& childHierarchy = m_registry.get<HierarchyComponent>(child);
 
@@ -77,7 +361,8 @@ void World::remove_parent(entt::entity child)
     if (!m_registry.valid(child))
         return;
     m_rootEntitiesDirty = true;
-    mark_transforms_dirty();
+    m_transformOrderDirty = true;
+    mark_transform_dirty(child);
 
     auto& childHierarchy = m_registry.get<HierarchyComponent>(child);
 
@@ -116,84 +401,286 @@ const std::vector<entt::entity>& World::get_root_entities()
     return m_rootEntitiesCache;
 }
 
-void World::update_world_matrices()
+void World::rebuild_transform_order()
 {
-    if (!m_worldMatricesDirty)
-        return;
+    m_transformEntities.clear();
+    m_transformParents.clear();
+    m_transformLevelOffsets.clear();
 
-    // Start from all root entities and propagate downward.
     const auto& roots = get_root_entities();
-    XMMATRIX identity = XMMatrixIdentity();
-    for (entt::entity root : roots)
+    m_transformEntities.assign(roots.begin(), roots.end());
+    m_transformParents.assign(roots.size(), InvalidTransformIndex);
+
+    // Breadth-first: each pass appends the children of the previous depth level.
+    m_transformLevelOffsets.push_back(0);
+    std::size_t levelBegin = 0;
+    while (levelBegin < m_transformEntities.size())
     {
-        update_world_matrices_recursive(root, identity);
+        const std::size_t levelEnd = m_transformEntities.size();
+        m_transformLevelOffsets.push_back(static_cast<std::uint32_t>(levelEnd));
+        for (std::size_t i = levelBegin; i < levelEnd; ++i)
+        {
+            const auto& hierarchy = m_registry.get<HierarchyComponent>(m_transformEntities[i]);
+            for (entt::entity child : hierarchy.children)
+            {
+                m_transformEntities.push_back(child);
+                m_transformParents.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        levelBegin = levelEnd;
     }
-    m_worldMatricesDirty = false;
-    m_renderablesDirty = true;
+
+    // Carry the last computed matrices over so clean parents can still feed dirty children.
+    const std::size_t count = m_transformEntities.size();
+    m_transformWorlds.resize(count);
+    m_transformDirty.assign(count, 0);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto& cache = m_registry.get<WorldMatrixCache>(m_transformEntities[i]);
+        cache.transformIndex = static_cast<std::uint32_t>(i);
+        m_transformWorlds[i] = cache.worldMatrix;
+    }
+    m_transformOrderDirty = false;
+
+    for (entt::entity entity : m_pendingTransformDirty)
+        mark_transform_dirty(entity);
+    m_pendingTransformDirty.clear();
 }
 
-void World::update_world_matrices_recursive(entt::entity entity, const XMMATRIX& parentWorld)
+void World::update_world_matrices(tf::Executor* executor)
 {
-    const auto& transform = m_registry.get<TransformComponent>(entity);
-    XMMATRIX localMatrix = transform.get_local_matrix();
-    XMMATRIX worldMatrix = XMMatrixMultiply(localMatrix, parentWorld);
+    NOC_PROFILE_ZONE("World::update_world_matrices");
+    if (m_transformOrderDirty)
+        rebuild_transform_order();
+    if (!m_anyTransformDirty)
+        return;
+    if (m_allTransformsDirty)
+        std::fill(m_transformDirty.begin(), m_transformDirty.end(), std::uint8_t{1});
+
+    // Resolve storages up front so worker threads never touch the registry's pool map.
+    auto& transforms = m_registry.storage<TransformComponent>();
+    auto& caches = m_registry.storage<WorldMatrixCache>();
+    auto updateRange = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            // Parents sit in an earlier level, so their flag is final by now.
+            const std::uint32_t parent = m_transformParents[i];
+            if (parent != InvalidTransformIndex && m_transformDirty[parent] != 0)
+                m_transformDirty[i] = 1;
+            if (m_transformDirty[i] == 0)
+                continue;
+
+            const entt::entity entity = m_transformEntities[i];
+            XMMATRIX worldMatrix = transforms.get(entity).get_local_matrix();
+            if (parent != InvalidTransformIndex)
+                worldMatrix = XMMatrixMultiply(worldMatrix, XMLoadFloat4x4(&m_transformWorlds[parent]));
+            XMStoreFloat4x4(&m_transformWorlds[i], worldMatrix);
+            caches.get(entity).worldMatrix = m_transformWorlds[i];
+        }
+    };
+
+    for (std::size_t level = 0; level + 1 < m_transformLevelOffsets.size(); ++level)
+    {
+        const std::size_t begin = m_transformLevelOffsets[level];
+        const std::size_t end = m_transformLevelOffsets[level + 1];
+        const std::size_t chunkCount = (end - begin + ParallelTransformChunk - 1) / ParallelTransformChunk;
+        if (executor == nullptr || chunkCount <= 1)
+        {
+            updateRange(begin, end);
+            continue;
+        }
 
-    auto& cache = m_registry.get<WorldMatrixCache>(entity);
-    XMStoreFloat4x4(&cache.worldMatrix, worldMatrix);
+        tf::Taskflow taskflow{};
+        taskflow.for_each_index(std::size_t{0}, chunkCount, std::size_t{1}, [&](std::size_t chunk) {
+            const std::size_t chunkBegin = begin + chunk * ParallelTransformChunk;
+            updateRange(chunkBegin, std::min(end, chunkBegin + ParallelTransformChunk));
+        });
+        // A frame job graph may call this from a worker, which must help out instead of blocking.
+        if (executor->this_worker_id() >= 0)
+            executor->corun(taskflow);
+        else
+            executor->run(taskflow).wait();
+    }
 
-    const auto& hierarchy = m_registry.get<HierarchyComponent>(entity);
-    for (entt::entity child : hierarchy.children)
+    // Moved entities that render get re-extracted on the next collect.
+    auto& tracker = renderable_tracker(m_registry);
+    auto& meshes = m_registry.storage<MeshComponent>();
+    for (std::size_t i = 0; i < m_transformDirty.size(); ++i)
     {
-        update_world_matrices_recursive(child, worldMatrix);
+        if (m_transformDirty[i] != 0 && meshes.contains(m_transformEntities[i]))
+            tracker.queue(m_transformEntities[i]);
     }
+
+    std::fill(m_transformDirty.begin(), m_transformDirty.end(), std::uint8_t{0});
+    m_markedTransforms.clear();
+    m_anyTransformDirty = false;
+    m_allTransformsDirty = false;
 }
 
-const std::vector<Renderable>& World::collect_renderables()
+void World::apply_renderable_changes()
 {
-    if (!m_renderablesDirty)
-        return m_renderablesCache;
+    auto& tracker = renderable_tracker(m_registry);
+    auto& spatialIndex = m_registry.ctx().get<SpatialIndex>();
+    if (tracker.allDirty)
+    {
+        for (entt::entity entity : m_registry.view<MeshComponent>())
+            tracker.queue(entity);
+        tracker.allDirty = false;
+    }
 
-    m_renderablesCache.clear();
-    auto view = m_registry.view<MeshComponent, WorldMatrixCache>();
-    m_renderablesCache.reserve(static_cast<size_t>(view.size_hint()));
-    for (auto entity : view)
+    for (entt::entity entity : tracker.refreshQueue)
     {
-        const auto& mesh = view.get<MeshComponent>(entity);
-        if (mesh.meshIndex < 0)
-            continue; // no valid mesh assigned
+        tracker.queuedByEntity[static_cast<std::size_t>(entt::to_entity(entity))] = entt::null;
+        if (!m_registry.valid(entity))
+            continue; // destroyed: the MeshComponent destroy listener already removed it
 
-        const auto& cache = view.get<WorldMatrixCache>(entity);
+        const auto* mesh = m_registry.try_get<MeshComponent>(entity);
+        const auto* cache = m_registry.try_get<WorldMatrixCache>(entity);
+        if (mesh == nullptr || cache == nullptr || mesh->meshIndex < 0)
+        {
+            tracker.remove(entity); // no valid mesh assigned
+            spatialIndex.remove(entity);
+            continue;
+        }
 
-        Renderable r{};
-        r.worldMatrix = cache.worldMatrix;
-        r.meshIndex = static_cast<uint32_t>(mesh.meshIndex);
-        r.materialIndex = static_cast<uint32_t>(mesh.materialIndex);
-        r.entityId = static_cast<uint32_t>(entity);
-        if (mesh.glowEnabled)
+        tracker.upsert(entity, make_renderable(m_registry, entity, *mesh, *cache));
+        const MeshBounds bounds =
+            m_meshBoundsProvider ? m_meshBoundsProvider(static_cast<std::uint32_t>(mesh->meshIndex)) : MeshBounds{};
+        if (!bounds.valid)
         {
-            r.glowColor = mesh.glowColor;
-            r.glowIntensity = std::max(0.0f, mesh.glowIntensity);
+            spatialIndex.remove(entity);
+            continue;
         }
-        m_renderablesCache.push_back(r);
+        XMFLOAT3 boundsMin{};
+        XMFLOAT3 boundsMax{};
+        transform_bounds(bounds, cache->worldMatrix, boundsMin, boundsMax);
+        spatialIndex.update(entity, boundsMin, boundsMax);
     }
-    m_renderablesDirty = false;
-    return m_renderablesCache;
+    tracker.refreshQueue.clear();
+}
+
+const std::vector<Renderable>& World::collect_renderables()
+{
+    NOC_PROFILE_ZONE("World::collect_renderables");
+    apply_renderable_changes();
+
+    auto& tracker = renderable_tracker(m_registry);
+    for (std::uint32_t index : tracker.changedIndices)
+    {
+        if (index < tracker.changed.size())
+            tracker.changed[index] = 0;
+    }
+    tracker.changedIndices.clear();
+    tracker.removedEntityIds.clear();
+    return tracker.renderables;
+}
+
+RenderableDelta World::collect_renderable_changes()
+{
+    apply_renderable_changes();
+
+    auto& tracker = renderable_tracker(m_registry);
+    m_renderableDeltaScratch.clear();
+    m_renderableDeltaScratch.reserve(tracker.changedIndices.size());
+    for (std::uint32_t index : tracker.changedIndices)
+    {
+        // Stale entries point past a swap-removed tail or were already reported via a move.
+        if (index >= tracker.changed.size() || tracker.changed[index] == 0)
+            continue;
+        tracker.changed[index] = 0;
+        m_renderableDeltaScratch.push_back(tracker.renderables[index]);
+    }
+    tracker.changedIndices.clear();
+
+    // Handed out as a span; cleared at the start of the next collect via the swap below.
+    m_removedEntityIdsScratch.swap(tracker.removedEntityIds);
+    tracker.removedEntityIds.clear();
+    return RenderableDelta{m_renderableDeltaScratch, m_removedEntityIdsScratch};
+}
+
+const std::vector<Light>& World::collect_lights()
+{
+    NOC_PROFILE_ZONE("World::collect_lights");
+    m_lightScratch.clear();
+    auto view = m_registry.view<LightComponent, WorldMatrixCache>();
+    for (auto [entity, light, cache] : view.each())
+    {
+        const XMFLOAT4X4& world = cache.worldMatrix;
+        Light& out = m_lightScratch.emplace_back();
+        out.type = light.type;
+        out.position = XMFLOAT3{world._41, world._42, world._43};
+        out.range = std::max(light.range, 0.01f);
+
+        // Row 2 is the local +Z axis in world space; lights shine down local -Z.
+        const XMVECTOR forward = XMVectorNegate(XMVectorSet(world._31, world._32, world._33, 0.0f));
+        const XMVECTOR length = XMVector3Length(forward);
+        XMStoreFloat3(&out.direction, XMVectorGetX(length) > 1e-6f ? XMVectorDivide(forward, length)
+                                                                   : XMVectorSet(0.0f, 0.0f, -1.0f, 0.0f));
+
+        const float intensity = std::max(light.intensity, 0.0f);
+        out.color = XMFLOAT3{light.color.x * intensity, light.color.y * intensity, light.color.z * intensity};
+
+        const float outer = std::clamp(light.outerConeAngle, 0.1f, 89.9f);
+        const float inner = std::clamp(light.innerConeAngle, 0.0f, outer);
+        out.innerConeCos = std::cos(XMConvertToRadians(inner));
+        out.outerConeCos = std::cos(XMConvertToRadians(outer));
+    }
+    return m_lightScratch;
+}
+
+void World::mark_transform_dirty(entt::entity entity)
+{
+    m_anyTransformDirty = true;
+    m_markedTransforms.push_back(entity);
+    if (m_transformOrderDirty)
+    {
+        // Flat indices are about to change; apply once the order has been rebuilt.
+        m_pendingTransformDirty.push_back(entity);
+        return;
+    }
+
+    const auto* cache = m_registry.try_get<WorldMatrixCache>(entity);
+    if (cache == nullptr || cache->transformIndex >= m_transformEntities.size() ||
+        m_transformEntities[cache->transformIndex] != entity)
+        return;
+    m_transformDirty[cache->transformIndex] = 1;
 }
 
 void World::mark_transforms_dirty() noexcept
 {
-    m_worldMatricesDirty = true;
-    m_renderablesDirty = true;
+    m_anyTransformDirty = true;
+    m_allTransformsDirty = true;
+}
+
+void World::mark_renderable_dirty(entt::entity entity)
+{
+    if (m_registry.valid(entity))
+        renderable_tracker(m_registry).queue(entity);
 }
 
 void World::mark_renderables_dirty() noexcept
 {
-    m_renderablesDirty = true;
+    renderable_tracker(m_registry).allDirty = true;
+}
+
+void World::set_mesh_bounds_provider(MeshBoundsProvider provider)
+{
+    m_meshBoundsProvider = std::move(provider);
+    m_registry.ctx().get<SpatialIndex>().clear();
+    mark_renderables_dirty();
+}
+
+const SpatialIndex& World::spatial_index()
+{
+    apply_renderable_changes();
+    return m_registry.ctx().get<SpatialIndex>();
 }
 
 bool World::has_renderables_updates_pending() const noexcept
 {
-    return m_renderablesDirty;
+    const auto& tracker = m_registry.ctx().get<RenderableTracker>();
+    return tracker.allDirty || !tracker.refreshQueue.empty() || !tracker.changedIndices.empty() ||
+           !tracker.removedEntityIds.empty();
 }
 
 entt::entity World::get_active_camera()
@@ -1,5 +1,7 @@
 #pragma once
+#include "../../Core/Public/AssetId.hpp"
 #include "../../Core/Public/Core.hpp"
+#include "../../Rendering/Public/Light.hpp"
 
 #include <DirectXMath.h>
 #include <cmath>
@@ -86,8 +88,8 @@ struct MeshComponent
 {
     int32_t meshIndex{-1};
     int32_t materialIndex{0};
-    std::string assetPath; // original asset path, used for serialization
-    std::string materialName; // name of the assigned editor material
+    AssetId asset{}; // source model; AssetRegistry holds its path for display and serialization
+    AssetId material{}; // assigned editor material, interned by name
     bool glowEnabled{false};
     DirectX::XMFLOAT3 glowColor{1.0f, 0.7f, 0.25f};
     float glowIntensity{1.5f};
@@ -113,10 +115,23 @@ struct CameraComponent
     float pitch{0.0f}; // radians
 };
 
-/// Cached world matrix, recomputed each frame by World::update_world_matrices().
+/// Light source. Point and spot lights sit at the entity's world position; spot and directional
+/// lights shine along the entity's local -Z axis.
+struct LightComponent
+{
+    LightType type{LightType::Point};
+    DirectX::XMFLOAT3 color{1.0f, 1.0f, 1.0f}; // linear RGB
+    float intensity{1.0f};
+    float range{10.0f};          // point/spot: distance at which the light has faded out
+    float innerConeAngle{25.0f}; // spot: degrees from the axis at full intensity
+    float outerConeAngle{35.0f}; // spot: degrees from the axis where the light ends
+};
+
+/// Cached world matrix, recomputed by World::update_world_matrices() when the entity or an ancestor moved.
 struct WorldMatrixCache
 {
     DirectX::XMFLOAT4X4 worldMatrix{};
+    std::uint32_t transformIndex{UINT32_MAX}; // slot in World's flattened hierarchy, owned by World
 };
 
 /// Lua script attached to an entity.
@@ -147,6 +162,14 @@ enum class PhysicsColliderShapeType : std::uint8_t
     MutableCompound = 7,
 };
 
+/// Which broadphase layer a body lives in, on top of its motion type.
+enum class PhysicsBodyCollisionGroup : std::uint8_t
+{
+    Default = 0,
+    Trigger = 1, // sensor: reports contacts with moving bodies, never pushes back
+    Debris = 2,  // collides with static geometry only
+};
+
 struct PhysicsBodyComponent
 {
     bool enabled{true};
@@ -161,7 +184,8 @@ struct PhysicsBodyComponent
     bool useGravity{true};
     float linearDamping{0.05f};
     float angularDamping{0.05f};
+    PhysicsBodyCollisionGroup collisionGroup{PhysicsBodyCollisionGroup::Default};
 
-    bool runtimeDirty{true};
+    bool runtimeDirty{true}; // set after editing in place, then patch() the component so PhysicsWorld re-syncs it
     bool runtimeInitialized{false};
 };
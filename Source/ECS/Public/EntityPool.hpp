@@ -0,0 +1,66 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "Components.hpp"
+#include "Prefab.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <entt/entity/entity.hpp>
+
+class World;
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Recycles instances of one prefab in one World. release() hides an instance (meshes unassigned,
+/// physics bodies disabled, lights removed) but keeps its entities; acquire() re-arms released
+/// instances before spawning new ones, so steady spawn/despawn churn neither creates nor destroys
+/// entities. Instances destroyed behind the pool's back are skipped. Main-thread only, like World.
+class NOC_EXPORT EntityPool
+{
+  public:
+    explicit EntityPool(Prefab prefab);
+
+    /// Places transforms.size() instances; their roots are written to outRoots, which must be as long.
+    void acquire(World& world, std::span<const TransformComponent> transforms, std::span<entt::entity> outRoots);
+
+    /// Hides the instance rooted at `root`. Returns false when `root` is not a live instance of this pool.
+    bool release(World& world, entt::entity root);
+
+    /// True when `root` is the root of an instance this pool handed out and has not taken back.
+    bool owns(entt::entity root) const noexcept;
+
+    inline std::size_t get_live_count() const noexcept
+    {
+        return m_liveCount;
+    }
+    inline std::size_t get_free_count() const noexcept
+    {
+        return m_freeSlots.size();
+    }
+    inline const Prefab& get_prefab() const noexcept
+    {
+        return m_prefab;
+    }
+
+  private:
+    static constexpr std::uint32_t InvalidSlot{UINT32_MAX};
+
+    std::uint32_t slot_of(entt::entity root) const noexcept;
+    bool is_alive(const World& world, std::uint32_t slot) const;
+    void show(World& world, std::uint32_t slot, const TransformComponent& transform);
+    void hide(World& world, std::uint32_t slot);
+
+    Prefab m_prefab;
+    std::size_t m_nodeCount{};
+    std::vector<entt::entity> m_entities{};     // slot-major: m_nodeCount entities per instance, in node order
+    std::vector<std::uint8_t> m_live{};         // per slot
+    std::vector<std::uint32_t> m_freeSlots{};
+    std::vector<std::uint32_t> m_slotByEntity{}; // by entt::to_entity() of an instance root
+    std::vector<entt::entity> m_spawnScratch{};
+    std::size_t m_liveCount{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,40 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "Components.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <entt/entity/entity.hpp>
+
+class World;
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Template hierarchy stamped out by World::spawn_prefab() and EntityPool. nodes[0] is the root;
+/// every other node names an earlier node as its parent, so parents always precede their children.
+struct NOC_EXPORT Prefab
+{
+    struct Node
+    {
+        std::string name{};
+        std::int32_t parent{-1};        // index of an earlier node; -1 only for the root
+        TransformComponent transform{}; // local; the root's is replaced by each instance's transform
+        std::optional<MeshComponent> mesh{};
+        std::optional<PhysicsBodyComponent> physicsBody{};
+        std::optional<LightComponent> light{};
+    };
+
+    std::vector<Node> nodes{};
+
+    /// Captures an entity and its descendants (names, transforms, meshes, physics bodies, lights)
+    /// in depth-first order. Scripts and cameras are not copied.
+    static Prefab from_subtree(const World& world, entt::entity root);
+
+    /// True when there is exactly one root, at index 0, and every parent precedes its child.
+    bool is_valid() const noexcept;
+};
+
+NOC_RESTORE_DLL_WARNINGS
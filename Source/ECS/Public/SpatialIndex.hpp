@@ -0,0 +1,105 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <entt/entity/entity.hpp>
+
+struct FrustumPlanes;
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// World-space bounding boxes of entities in a sparse uniform grid.
+/// Every box is linked into each cell it overlaps, so updates only touch the cells a box
+/// enters or leaves; boxes spanning more than MaxCellsPerItem cells sit in an unbounded list
+/// that every query checks. Queries are read-only and may run concurrently with each other.
+class NOC_EXPORT SpatialIndex
+{
+  public:
+    static constexpr float DefaultCellSize{16.0f};
+    static constexpr std::size_t MaxCellsPerItem{64};
+    /// Upper bound of cells one raycast walks before giving up.
+    static constexpr std::uint32_t MaxRaySteps{4096};
+
+    struct RayHit
+    {
+        entt::entity entity{entt::null};
+        float distance{0.0f};
+    };
+
+    explicit SpatialIndex(float cellSize = DefaultCellSize);
+
+    /// Inserts the entity or moves it to new bounds.
+    void update(entt::entity entity, const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax);
+    void remove(entt::entity entity);
+    void clear() noexcept;
+
+    /// Appends every entity whose box overlaps the query box. `out` is not cleared.
+    void query_aabb(const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax,
+                    std::vector<entt::entity>& out) const;
+    /// Appends every entity whose box intersects the sphere. `out` is not cleared.
+    void query_sphere(const DirectX::XMFLOAT3& center, float radius, std::vector<entt::entity>& out) const;
+    /// Appends every entity whose box touches the frustum. `out` is not cleared.
+    void query_frustum(const FrustumPlanes& frustum, std::vector<entt::entity>& out) const;
+    /// Nearest box hit along the ray within `maxDistance`; `direction` need not be normalized.
+    std::optional<RayHit> raycast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& direction, float maxDistance,
+                                  entt::entity ignore = entt::null) const;
+
+    /// Reads the indexed box of an entity. Returns false when the entity is not indexed.
+    bool get_bounds(entt::entity entity, DirectX::XMFLOAT3& outMin, DirectX::XMFLOAT3& outMax) const noexcept;
+
+    inline std::size_t size() const noexcept
+    {
+        return m_items.size() - m_freeSlots.size();
+    }
+    inline std::size_t get_cell_count() const noexcept
+    {
+        return m_cells.size();
+    }
+    inline float get_cell_size() const noexcept
+    {
+        return m_cellSize;
+    }
+
+  private:
+    static constexpr std::uint32_t InvalidSlot{UINT32_MAX};
+
+    using CellRange = std::array<std::int32_t, 6>; // min xyz, max xyz (inclusive)
+
+    struct Item
+    {
+        DirectX::XMFLOAT3 boundsMin{};
+        DirectX::XMFLOAT3 boundsMax{};
+        CellRange cells{};
+        entt::entity entity{entt::null}; // null for free slots
+        bool unbounded{false};           // lives in m_unbounded instead of the grid
+    };
+
+    CellRange cell_range(const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax) const noexcept;
+    std::int32_t cell_coord(float value) const noexcept;
+    static std::uint64_t cell_key(std::int32_t x, std::int32_t y, std::int32_t z) noexcept;
+    static std::size_t cell_count(const CellRange& range) noexcept;
+
+    void link(std::uint32_t slot);
+    void unlink(std::uint32_t slot);
+    std::uint32_t slot_of(entt::entity entity) const noexcept;
+
+    /// Appends, without duplicates, the slots linked into cells overlapping `range` plus the unbounded ones.
+    void gather(const CellRange& range, std::vector<std::uint32_t>& outSlots) const;
+
+    std::vector<Item> m_items{};
+    std::vector<std::uint32_t> m_freeSlots{};
+    std::vector<std::uint32_t> m_slotByEntity{}; // by entt::to_entity(), InvalidSlot when absent
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> m_cells{};
+    std::vector<std::uint32_t> m_unbounded{};
+    float m_cellSize{DefaultCellSize};
+    float m_inverseCellSize{1.0f / DefaultCellSize};
+};
+
+NOC_RESTORE_DLL_WARNINGS
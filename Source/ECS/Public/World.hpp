@@ -2,26 +2,64 @@
 #include "../../Core/Public/Core.hpp"
 #include "../../Rendering/Public/Renderable.hpp"
 #include "Components.hpp"
+#include "Prefab.hpp"
+#include "SpatialIndex.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <string>
 #include <vector>
 
+#include <DirectXMath.h>
 #include <entt/entity/registry.hpp>
 
+namespace tf
+{
+class Executor;
+}
+
+struct MeshBounds; // Forward declare — full definition in Rendering/Public/IRenderer.hpp
+
+/// Local-space bounds of an uploaded mesh, typically bound to IRenderer::get_mesh_bounds.
+using MeshBoundsProvider = std::function<MeshBounds(std::uint32_t meshIndex)>;
+
 NOC_SUPPRESS_DLL_WARNINGS
 
 /// ECS world: wraps an entt::registry and provides entity lifecycle management,
 /// parent-child hierarchy, world matrix propagation, and renderable collection.
+///
+/// Renderables are change-tracked: MeshComponent construct/destroy signals and per-entity
+/// marks queue entities, and only queued entities are re-extracted into a stable list.
+/// The tracking state lives in the registry context, so the World stays movable.
+///
+/// Re-extracted renderables also refresh a SpatialIndex of world-space mesh boxes
+/// (local bounds from the MeshBoundsProvider, transformed by WorldMatrixCache).
 class NOC_EXPORT World
 {
   public:
-    World() = default;
+    World();
 
     //    Entity lifecycle                                               
 
     /// Creates a new entity with Name, Transform, Hierarchy, and WorldMatrixCache.
     entt::entity create_entity(std::string name = "");
 
+    /// Creates entities.size() entities in one go (registry.create(first, last)) with the same
+    /// components as create_entity(): unnamed, identity transforms, all roots, all transforms dirty.
+    /// Bulk loaders fill the components in place and may link HierarchyComponent directly,
+    /// keeping parent and children consistent.
+    void create_entities(std::span<entt::entity> entities);
+
+    /// Spawns transforms.size() instances of `prefab`, instance i rooted at transforms[i], under `parent`
+    /// or as roots. All entities come from one registry.create(), each prefab node's components are
+    /// inserted for every instance at once from the node's values, and the hierarchy is linked in one
+    /// pass. Only the new roots are marked dirty. `outEntities` is overwritten node-major: node n of
+    /// instance i is outEntities[n * transforms.size() + i], so the roots come first.
+    void spawn_prefab(const Prefab& prefab, std::span<const TransformComponent> transforms,
+                      std::vector<entt::entity>& outEntities, entt::entity parent = entt::null);
+
     /// Recursively destroys an entity and all its descendants.
     /// Removes itself from its parent's children list before destruction.
     void destroy_entity(entt::entity entity);
@@ -40,22 +78,61 @@ class NOC_EXPORT World
 
     //    Systems (per-frame)                                            
 
-    /// Recomputes WorldMatrixCache for every entity from root to leaf.
-    void update_world_matrices();
+    /// Recomputes WorldMatrixCache for dirty entities and their descendants.
+    /// Walks the flattened hierarchy one depth level at a time; levels with at least
+    /// ParallelTransformChunk entities are split across `executor` when one is given.
+    void update_world_matrices(tf::Executor* executor = nullptr);
 
-    /// Builds a flat list of Renderables from all entities with MeshComponent + WorldMatrixCache.
+    /// Applies queued changes and returns every renderable (entities with MeshComponent,
+    /// WorldMatrixCache and a valid mesh). Discards the pending delta: use this for a full resync.
     const std::vector<Renderable>& collect_renderables();
 
-    /// Marks transform/hierarchy-dependent data dirty.
-    /// Call this after mutating transforms outside World APIs.
+    /// Applies queued changes and returns what changed since the previous collect call.
+    /// The spans stay valid until the next call into World.
+    RenderableDelta collect_renderable_changes();
+
+    /// Returns every light (entities with LightComponent and WorldMatrixCache) in world space.
+    /// The vector stays valid until the next call.
+    const std::vector<Light>& collect_lights();
+
+    /// Marks one entity's transform changed; it and its subtree are recomputed on the next update.
+    /// Call this after mutating a TransformComponent outside World APIs.
+    void mark_transform_dirty(entt::entity entity);
+
+    /// Marks every transform dirty (full recompute on the next update).
     void mark_transforms_dirty() noexcept;
 
-    /// Marks renderable cache dirty (mesh/material assignment changed).
+    /// Entities passed to mark_transform_dirty() since the last update_world_matrices(), in call
+    /// order and possibly repeated. Lets systems that mirror transforms skip untouched entities.
+    std::span<const entt::entity> get_marked_transforms() const noexcept
+    {
+        return m_markedTransforms;
+    }
+
+    /// True when mark_transforms_dirty() was called since the last update; get_marked_transforms()
+    /// is then incomplete and every transform has to be treated as changed.
+    bool are_all_transforms_dirty() const noexcept
+    {
+        return m_allTransformsDirty;
+    }
+
+    /// Marks one entity's renderable data (mesh, material, glow) changed.
+    void mark_renderable_dirty(entt::entity entity);
+
+    /// Re-extracts every renderable (mesh/material assignment changed across the level).
     void mark_renderables_dirty() noexcept;
 
     /// Returns true when renderables must be rebuilt before pushing to the renderer.
     bool has_renderables_updates_pending() const noexcept;
 
+    /// Sets where mesh bounds for the spatial index come from and re-indexes every mesh.
+    /// The provider is called from whichever thread collects renderables.
+    void set_mesh_bounds_provider(MeshBoundsProvider provider);
+
+    /// Applies queued renderable changes and returns the index of world-space mesh boxes.
+    /// Empty until a MeshBoundsProvider is set. The reference stays valid for the World's lifetime.
+    const SpatialIndex& spatial_index();
+
     /// Returns the first entity whose CameraComponent has isActive == true, or entt::null.
     entt::entity get_active_camera();
 
@@ -70,16 +147,36 @@ class NOC_EXPORT World
         return m_registry;
     }
 
+    /// Entities per parallel task within one depth level.
+    static constexpr std::size_t ParallelTransformChunk{1024};
+
   private:
+    static constexpr std::uint32_t InvalidTransformIndex{UINT32_MAX};
+
     void rebuild_root_entities_cache();
-    void update_world_matrices_recursive(entt::entity entity, const DirectX::XMMATRIX& parentWorld);
+    void rebuild_transform_order();
+    void apply_renderable_changes();
 
     entt::registry m_registry;
     std::vector<entt::entity> m_rootEntitiesCache;
     bool m_rootEntitiesDirty{true};
-    bool m_worldMatricesDirty{true};
-    bool m_renderablesDirty{true};
-    std::vector<Renderable> m_renderablesCache;
+
+    // Flattened hierarchy (SoA): breadth-first, so every depth level is contiguous and parents
+    // precede their children. Rebuilt when the hierarchy changes, otherwise only dirty flags move.
+    std::vector<entt::entity> m_transformEntities;
+    std::vector<std::uint32_t> m_transformParents; // flat index of the parent, InvalidTransformIndex for roots
+    std::vector<DirectX::XMFLOAT4X4> m_transformWorlds;
+    std::vector<std::uint8_t> m_transformDirty;
+    std::vector<std::uint32_t> m_transformLevelOffsets; // level d spans [offsets[d], offsets[d + 1])
+    std::vector<entt::entity> m_pendingTransformDirty;  // marked while the order was stale
+    std::vector<entt::entity> m_markedTransforms;       // every mark since the last update, for other systems
+    bool m_transformOrderDirty{true};
+    bool m_anyTransformDirty{true};
+    bool m_allTransformsDirty{true};
+    MeshBoundsProvider m_meshBoundsProvider{};
+    std::vector<Renderable> m_renderableDeltaScratch;   // RenderableDelta::changed of the last collect
+    std::vector<std::uint32_t> m_removedEntityIdsScratch; // RenderableDelta::removedEntityIds of the last collect
+    std::vector<Light> m_lightScratch;                    // result of the last collect_lights()
 };
 
 NOC_RESTORE_DLL_WARNINGS
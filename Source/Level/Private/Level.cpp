@@ -1,8 +1,24 @@
 #include "../Public/Level.hpp"
 #include "LevelSerializer.hpp"
+#include "../../Core/Public/JobSystem.hpp"
 
 #include <fmt/core.h>
 
+#include <condition_variable>
+#include <mutex>
+
+/// A save running on a background job. The job only touches this state, never the Level.
+struct Level::PendingSave
+{
+    std::string filePath;
+    std::uint64_t editGeneration{};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done{false};
+    Result<> result{};
+};
+
 // ── Factories ────────────────────────────────────────────────────────
 
 Level Level::create_new(std::string name)
@@ -56,6 +72,7 @@ Result<Level> Level::load(const std::string& filePath)
 
 Result<> Level::save()
 {
+    (void)wait_for_save();
     if (m_filePath.empty())
         return make_error("Cannot save: no file path set. Use save_as() first.", ErrorCode::AssetCacheWriteFailed);
 
@@ -69,6 +86,7 @@ Result<> Level::save()
 
 Result<> Level::save_as(const std::string& filePath)
 {
+    (void)wait_for_save();
     auto result = LevelSerializer::save_to_file(m_world, m_name, filePath);
     if (!result)
         return make_error(result.error());
@@ -77,3 +95,79 @@ Result<> Level::save_as(const std::string& filePath)
     m_dirty = false;
     return {};
 }
+
+Result<> Level::save_async()
+{
+    if (m_filePath.empty())
+        return make_error("Cannot save: no file path set. Use save_as() first.", ErrorCode::AssetCacheWriteFailed);
+    return start_async_save(m_filePath);
+}
+
+Result<> Level::save_as_async(const std::string& filePath)
+{
+    return start_async_save(filePath);
+}
+
+Result<> Level::start_async_save(const std::string& filePath)
+{
+    if (m_pendingSave)
+        return make_error("A save of this level is already in progress", ErrorCode::AssetCacheWriteFailed);
+
+    auto pending = std::make_shared<PendingSave>();
+    pending->filePath = filePath;
+    pending->editGeneration = m_editGeneration;
+    m_pendingSave = pending;
+
+    JobSystem::get().submit(JobPriority::Background,
+                            [pending, snapshot = LevelSerializer::snapshot(m_world, m_name)]() {
+                                Result<> result = LevelSerializer::save_to_file(snapshot, pending->filePath);
+                                std::lock_guard lock{pending->mutex};
+                                pending->result = std::move(result);
+                                pending->done = true;
+                                pending->finished.notify_all();
+                            });
+    return {};
+}
+
+bool Level::is_saving() const noexcept
+{
+    if (!m_pendingSave)
+        return false;
+    std::lock_guard lock{m_pendingSave->mutex};
+    return !m_pendingSave->done;
+}
+
+std::optional<Result<>> Level::poll_save()
+{
+    if (!m_pendingSave)
+        return std::nullopt;
+    {
+        std::lock_guard lock{m_pendingSave->mutex};
+        if (!m_pendingSave->done)
+            return std::nullopt;
+    }
+    return finish_save();
+}
+
+Result<> Level::wait_for_save()
+{
+    if (!m_pendingSave)
+        return {};
+    {
+        std::unique_lock lock{m_pendingSave->mutex};
+        m_pendingSave->finished.wait(lock, [&]() { return m_pendingSave->done; });
+    }
+    return finish_save();
+}
+
+Result<> Level::finish_save()
+{
+    const std::shared_ptr<PendingSave> pending = std::move(m_pendingSave);
+    if (!pending->result)
+        return make_error(pending->result.error());
+
+    m_filePath = pending->filePath;
+    if (m_editGeneration == pending->editGeneration)
+        m_dirty = false;
+    return {};
+}
@@ -1,4 +1,6 @@
 #include "LevelSerializer.hpp"
+#include "../../Core/Public/Profiler.hpp"
+#include "../../Core/Public/VirtualFileSystem.hpp"
 
 #include <LevelAsset_generated.h>
 
@@ -9,108 +11,147 @@
 #include <filesystem>
 #include <fstream>
 #include <set>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 
 namespace fb = flatbuffers;
 namespace fbl = NatureOfCraft::Level;
 
 //    Serialize helpers                                                 
 
-/// Recursively serializes an entity and its children into the FlatBufferBuilder.
-static fb::Offset<fbl::EntityData> serialize_entity(fb::FlatBufferBuilder& fbb, const World& world, entt::entity entity)
+namespace
 {
-    auto& reg = const_cast<World&>(world).registry(); // we only read
+/// Deduplicates the strings of a level into LevelSnapshot::strings; index 0 is the empty string.
+class LevelStringTable
+{
+  public:
+    explicit LevelStringTable(std::vector<std::string>& strings) : m_strings(strings)
+    {
+        m_strings.assign(1, std::string{});
+        m_indices.emplace(std::string_view{}, 0u);
+    }
+
+    /// The view must outlive the table (component strings of the world being snapshotted).
+    std::uint32_t intern(std::string_view value)
+    {
+        const auto [it, inserted] = m_indices.try_emplace(value, static_cast<std::uint32_t>(m_strings.size()));
+        if (inserted)
+            m_strings.emplace_back(value);
+        return it->second;
+    }
 
-    // Name
-    const auto* nameComp = reg.try_get<NameComponent>(entity);
-    fb::Offset<fb::String> nameOffset = nameComp ? fbb.CreateString(nameComp->name) : 0;
+  private:
+    std::vector<std::string>& m_strings;
+    std::unordered_map<std::string_view, std::uint32_t> m_indices;
+};
+} // namespace
 
-    // Transform
-    fb::Offset<fbl::TransformData> transformOffset = 0;
-    if (const auto* tc = reg.try_get<TransformComponent>(entity))
+/// Every entity in depth-first pre-order with the flat index of its parent (-1 for roots).
+static void flatten_hierarchy(World& world, std::vector<entt::entity>& order, std::vector<std::int32_t>& parents)
+{
+    const auto& reg = world.registry();
+    const auto& roots = world.get_root_entities();
+
+    std::vector<std::pair<entt::entity, std::int32_t>> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+        stack.emplace_back(*it, -1);
+
+    while (!stack.empty())
     {
-        fbl::Vec3 pos(tc->position.x, tc->position.y, tc->position.z);
-        fbl::Vec4 rot(tc->rotation.x, tc->rotation.y, tc->rotation.z, tc->rotation.w);
-        fbl::Vec3 scl(tc->scale.x, tc->scale.y, tc->scale.z);
-        transformOffset = fbl::CreateTransformData(fbb, &pos, &rot, &scl);
+        const auto [entity, parent] = stack.back();
+        stack.pop_back();
+
+        const auto index = static_cast<std::int32_t>(order.size());
+        order.push_back(entity);
+        parents.push_back(parent);
+        if (const auto* hc = reg.try_get<HierarchyComponent>(entity))
+        {
+            for (auto it = hc->children.rbegin(); it != hc->children.rend(); ++it)
+                stack.emplace_back(*it, index);
+        }
     }
+}
 
-    // Mesh component (optional)
-    fb::Offset<fbl::MeshComponentData> meshOffset = 0;
-    if (const auto* mc = reg.try_get<MeshComponent>(entity))
+static fb::Offset<fbl::LevelEntityTable> serialize_entity_table(fb::FlatBufferBuilder& fbb, const LevelSnapshot& snapshot)
+{
+    std::vector<fbl::EntityTransformRecord> transforms;
+    transforms.reserve(snapshot.transforms.size());
+    for (const TransformComponent& tc : snapshot.transforms)
     {
-        fbl::Vec3 glowColor(mc->glowColor.x, mc->glowColor.y, mc->glowColor.z);
-        meshOffset = fbl::CreateMeshComponentData(fbb, mc->meshIndex, mc->materialIndex,
-                                                   mc->assetPath.empty() ? 0 : fbb.CreateString(mc->assetPath),
-                                                   mc->materialName.empty() ? 0 : fbb.CreateString(mc->materialName),
-                                                   mc->glowEnabled, &glowColor, mc->glowIntensity);
+        transforms.emplace_back(fbl::Vec3(tc.position.x, tc.position.y, tc.position.z),
+                                fbl::Vec4(tc.rotation.x, tc.rotation.y, tc.rotation.z, tc.rotation.w),
+                                fbl::Vec3(tc.scale.x, tc.scale.y, tc.scale.z));
     }
 
-    // Camera component (optional)
-    fb::Offset<fbl::CameraComponentData> cameraOffset = 0;
-    if (const auto* cc = reg.try_get<CameraComponent>(entity))
+    std::vector<fbl::MeshComponentRecord> meshes;
+    std::vector<std::uint64_t> meshAssetIds;
+    std::vector<std::uint64_t> meshMaterialIds;
+    meshes.reserve(snapshot.meshes.size());
+    meshAssetIds.reserve(snapshot.meshes.size());
+    meshMaterialIds.reserve(snapshot.meshes.size());
+    for (const LevelSnapshot::Mesh& mesh : snapshot.meshes)
     {
-        fbl::Vec3 target(cc->target.x, cc->target.y, cc->target.z);
-        cameraOffset = fbl::CreateCameraComponentData(fbb, cc->fov, cc->nearPlane, cc->farPlane, cc->isActive, &target,
-                                                      cc->distance, cc->yaw, cc->pitch);
+        meshes.emplace_back(mesh.meshIndex, mesh.materialIndex, mesh.assetPath, mesh.materialName,
+                            fbl::Vec3(mesh.glowColor.x, mesh.glowColor.y, mesh.glowColor.z), mesh.glowIntensity,
+                            mesh.glowEnabled);
+        meshAssetIds.push_back(mesh.asset.value);
+        meshMaterialIds.push_back(mesh.material.value);
     }
 
-    // Script component (optional)
-    fb::Offset<fbl::ScriptComponentData> scriptOffset = 0;
-    if (const auto* sc = reg.try_get<ScriptComponent>(entity))
+    std::vector<fbl::CameraComponentRecord> cameras;
+    cameras.reserve(snapshot.cameras.size());
+    for (const CameraComponent& cc : snapshot.cameras)
     {
-        if (!sc->scriptPath.empty())
-            scriptOffset = fbl::CreateScriptComponentDataDirect(fbb, sc->scriptPath.c_str());
+        cameras.emplace_back(cc.fov, cc.nearPlane, cc.farPlane, fbl::Vec3(cc.target.x, cc.target.y, cc.target.z),
+                             cc.distance, cc.yaw, cc.pitch, cc.isActive);
     }
 
-    // Physics component (optional)
-    fb::Offset<fbl::PhysicsBodyComponentData> physicsOffset = 0;
-    if (const auto* pc = reg.try_get<PhysicsBodyComponent>(entity))
+    std::vector<fbl::PhysicsBodyComponentRecord> physics;
+    physics.reserve(snapshot.physics.size());
+    for (const PhysicsBodyComponent& pc : snapshot.physics)
     {
-        fbl::Vec3 halfExtents(pc->halfExtents.x, pc->halfExtents.y, pc->halfExtents.z);
-        fbl::Vec3 colliderOffset(pc->colliderOffset.x, pc->colliderOffset.y, pc->colliderOffset.z);
-        physicsOffset =
-            fbl::CreatePhysicsBodyComponentData(fbb, pc->enabled, static_cast<std::uint8_t>(pc->motionType),
-                                                static_cast<std::uint8_t>(pc->shapeType), &halfExtents, pc->radius,
-                                                pc->halfHeight, &colliderOffset, pc->friction, pc->restitution,
-                                                pc->useGravity, pc->linearDamping, pc->angularDamping);
+        physics.emplace_back(fbl::Vec3(pc.halfExtents.x, pc.halfExtents.y, pc.halfExtents.z),
+                             fbl::Vec3(pc.colliderOffset.x, pc.colliderOffset.y, pc.colliderOffset.z), pc.radius,
+                             pc.halfHeight, pc.friction, pc.restitution, pc.linearDamping, pc.angularDamping, pc.enabled,
+                             static_cast<std::uint8_t>(pc.motionType), static_cast<std::uint8_t>(pc.shapeType),
+                             pc.useGravity, static_cast<std::uint8_t>(pc.collisionGroup));
     }
 
-    // Children (recursive)
-    fb::Offset<fb::Vector<fb::Offset<fbl::EntityData>>> childrenOffset = 0;
-    if (const auto* hc = reg.try_get<HierarchyComponent>(entity))
+    std::vector<fbl::LightComponentRecord> lights;
+    lights.reserve(snapshot.lights.size());
+    for (const LightComponent& lc : snapshot.lights)
     {
-        if (!hc->children.empty())
-        {
-            std::vector<fb::Offset<fbl::EntityData>> childOffsets;
-            childOffsets.reserve(hc->children.size());
-            for (entt::entity child : hc->children)
-            {
-                childOffsets.push_back(serialize_entity(fbb, world, child));
-            }
-            childrenOffset = fbb.CreateVector(childOffsets);
-        }
+        lights.emplace_back(fbl::Vec3(lc.color.x, lc.color.y, lc.color.z), lc.intensity, lc.range, lc.innerConeAngle,
+                            lc.outerConeAngle, static_cast<std::uint8_t>(lc.type));
     }
 
-    return fbl::CreateEntityData(fbb, nameOffset, transformOffset, meshOffset, cameraOffset, scriptOffset,
-                                 physicsOffset, childrenOffset);
+    const auto stringsOffset = fbb.CreateVectorOfStrings(snapshot.strings);
+    return fbl::CreateLevelEntityTable(fbb, fbb.CreateVector(snapshot.parents), fbb.CreateVector(snapshot.names),
+                                       fbb.CreateVectorOfStructs(transforms), fbb.CreateVector(snapshot.meshEntities),
+                                       fbb.CreateVectorOfStructs(meshes), fbb.CreateVector(snapshot.cameraEntities),
+                                       fbb.CreateVectorOfStructs(cameras), fbb.CreateVector(snapshot.scriptEntities),
+                                       fbb.CreateVector(snapshot.scripts), fbb.CreateVector(snapshot.physicsEntities),
+                                       fbb.CreateVectorOfStructs(physics), stringsOffset,
+                                       fbb.CreateVector(snapshot.lightEntities), fbb.CreateVectorOfStructs(lights),
+                                       fbb.CreateVector(meshAssetIds), fbb.CreateVector(meshMaterialIds));
 }
 
 /// Collects all unique asset paths from MeshComponents and ScriptComponents for the referenced_assets list.
-static std::vector<std::string> collect_referenced_assets(const World& world)
+static std::vector<std::string_view> collect_referenced_assets(const LevelSnapshot& snapshot)
 {
-    auto& reg = const_cast<World&>(world).registry();
-    std::set<std::string> assetPaths;
+    std::set<std::string_view> assetPaths;
 
-    for (auto [entity, mc] : reg.view<MeshComponent>().each())
+    for (const LevelSnapshot::Mesh& mesh : snapshot.meshes)
     {
-        if (!mc.assetPath.empty())
-            assetPaths.insert(mc.assetPath);
+        if (mesh.assetPath != 0)
+            assetPaths.insert(snapshot.strings[mesh.assetPath]);
     }
 
-    for (auto [entity, sc] : reg.view<ScriptComponent>().each())
+    for (std::uint32_t scriptPath : snapshot.scripts)
     {
-        if (!sc.scriptPath.empty())
-            assetPaths.insert(sc.scriptPath);
+        if (scriptPath != 0)
+            assetPaths.insert(snapshot.strings[scriptPath]);
     }
 
     return {assetPaths.begin(), assetPaths.end()};
@@ -118,7 +159,7 @@ static std::vector<std::string> collect_referenced_assets(const World& world)
 
 //    Deserialize helpers                                               
 
-/// Recursively deserializes an entity from FlatBuffers into the World.
+/// Recursively deserializes a version 1 entity from FlatBuffers into the World.
 /// Returns the created entity. If parentEntity != entt::null, sets the parent.
 static entt::entity deserialize_entity(World& world, const fbl::EntityData* data, entt::entity parentEntity)
 {
@@ -143,8 +184,10 @@ static entt::entity deserialize_entity(World& world, const fbl::EntityData* data
         auto& mc = world.registry().emplace<MeshComponent>(entity);
         mc.meshIndex = md->mesh_index();
         mc.materialIndex = md->material_index();
-        mc.assetPath = md->asset_path() ? md->asset_path()->str() : "";
-        mc.materialName = md->material_name() ? md->material_name()->str() : "";
+        if (const auto* assetPath = md->asset_path())
+            mc.asset = AssetRegistry::get().intern(std::string_view{assetPath->data(), assetPath->size()});
+        if (const auto* materialName = md->material_name())
+            mc.material = AssetRegistry::get().intern(std::string_view{materialName->data(), materialName->size()});
         mc.glowEnabled = md->glow_enabled();
         if (md->glow_color())
             mc.glowColor = {md->glow_color()->x(), md->glow_color()->y(), md->glow_color()->z()};
@@ -195,6 +238,9 @@ static entt::entity deserialize_entity(World& world, const fbl::EntityData* data
         pc.useGravity = pd->use_gravity();
         pc.linearDamping = pd->linear_damping();
         pc.angularDamping = pd->angular_damping();
+        const auto collisionGroupRaw = static_cast<PhysicsBodyCollisionGroup>(pd->collision_group());
+        pc.collisionGroup =
+            collisionGroupRaw <= PhysicsBodyCollisionGroup::Debris ? collisionGroupRaw : PhysicsBodyCollisionGroup::Default;
         pc.runtimeDirty = true;
         pc.runtimeInitialized = false;
     }
@@ -215,37 +261,375 @@ static entt::entity deserialize_entity(World& world, const fbl::EntityData* data
     return entity;
 }
 
+/// Version 1: recursive EntityData trees.
+static void deserialize_entity_tree(World& world, const fbl::LevelAsset* level)
+{
+    if (const auto* rootEntities = level->root_entities())
+    {
+        for (const auto* entityData : *rootEntities)
+        {
+            deserialize_entity(world, entityData, entt::null);
+        }
+    }
+}
+
+template <typename T>
+static std::size_t column_size(const fb::Vector<T>* column) noexcept
+{
+    return column ? column->size() : 0;
+}
+
+/// Entity indices of one component column: in range, unique, one per record.
+static Result<> validate_column(const fb::Vector<std::uint32_t>* entities, std::size_t recordCount, std::size_t entityCount,
+                         std::vector<std::uint8_t>& seen, std::string_view column)
+{
+    if (column_size(entities) != recordCount)
+        return make_error(fmt::format("Level {} column has {} entities for {} records", column, column_size(entities),
+                                      recordCount),
+                          ErrorCode::AssetParsingFailed);
+    if (!entities)
+        return {};
+
+    seen.assign(entityCount, 0);
+    for (std::uint32_t index : *entities)
+    {
+        if (index >= entityCount || seen[index])
+            return make_error(fmt::format("Level {} column has an invalid entity index {}", column, index),
+                              ErrorCode::AssetParsingFailed);
+        seen[index] = 1;
+    }
+    return {};
+}
+
+static Result<> validate_entity_table(const fbl::LevelEntityTable& table)
+{
+    const std::size_t entityCount = column_size(table.parents());
+    const std::size_t stringCount = column_size(table.strings());
+    if (stringCount == 0 && entityCount > 0)
+        return make_error("Level string table is empty", ErrorCode::AssetParsingFailed);
+    if (column_size(table.names()) != entityCount || column_size(table.transforms()) != entityCount)
+        return make_error("Level entity table columns differ in length", ErrorCode::AssetParsingFailed);
+
+    const auto check_string = [stringCount](std::uint32_t index) { return index < stringCount; };
+
+    if (table.parents())
+    {
+        for (std::size_t i = 0; i < entityCount; ++i)
+        {
+            const std::int32_t parent = table.parents()->Get(static_cast<fb::uoffset_t>(i));
+            if (parent < -1 || parent >= static_cast<std::int32_t>(i))
+                return make_error(fmt::format("Level entity {} has an invalid parent {}", i, parent),
+                                  ErrorCode::AssetParsingFailed);
+            if (!check_string(table.names()->Get(static_cast<fb::uoffset_t>(i))))
+                return make_error(fmt::format("Level entity {} has an invalid name index", i), ErrorCode::AssetParsingFailed);
+        }
+    }
+
+    std::vector<std::uint8_t> seen;
+    if (auto result = validate_column(table.mesh_entities(), column_size(table.meshes()), entityCount, seen, "mesh"); !result)
+        return result;
+    if (auto result = validate_column(table.camera_entities(), column_size(table.cameras()), entityCount, seen, "camera");
+        !result)
+        return result;
+    if (auto result = validate_column(table.script_entities(), column_size(table.scripts()), entityCount, seen, "script");
+        !result)
+        return result;
+    if (auto result =
+            validate_column(table.physics_entities(), column_size(table.physics()), entityCount, seen, "physics");
+        !result)
+        return result;
+    if (auto result = validate_column(table.light_entities(), column_size(table.lights()), entityCount, seen, "light");
+        !result)
+        return result;
+
+    if (table.meshes())
+    {
+        for (const auto* mesh : *table.meshes())
+        {
+            if (!check_string(mesh->asset_path()) || !check_string(mesh->material_name()))
+                return make_error("Level mesh column has an invalid string index", ErrorCode::AssetParsingFailed);
+        }
+    }
+    if (table.scripts())
+    {
+        for (std::uint32_t script : *table.scripts())
+        {
+            if (!check_string(script))
+                return make_error("Level script column has an invalid string index", ErrorCode::AssetParsingFailed);
+        }
+    }
+    return {};
+}
+
+/// The entities named by a validated component column.
+static std::vector<entt::entity> column_entities(const fb::Vector<std::uint32_t>* indices, std::span<const entt::entity> entities)
+{
+    std::vector<entt::entity> result;
+    if (!indices)
+        return result;
+    result.reserve(indices->size());
+    for (std::uint32_t index : *indices)
+        result.push_back(entities[index]);
+    return result;
+}
+
+/// Version 2: bulk-creates every entity, then fills each component column in one insert.
+static Result<> deserialize_entity_table(World& world, const fbl::LevelEntityTable& table)
+{
+    if (auto validation = validate_entity_table(table); !validation)
+        return validation;
+
+    const std::size_t entityCount = column_size(table.parents());
+    if (entityCount == 0)
+        return {};
+
+    const auto& strings = *table.strings();
+    const auto string_at = [&strings](std::uint32_t index) -> std::string_view {
+        const auto* value = strings.Get(index);
+        return {value->data(), value->size()};
+    };
+
+    std::vector<entt::entity> entities(entityCount);
+    world.create_entities(entities);
+    auto& reg = world.registry();
+
+    auto& names = reg.storage<NameComponent>();
+    auto& transforms = reg.storage<TransformComponent>();
+    auto& hierarchies = reg.storage<HierarchyComponent>();
+
+    // Children were written right after their parents; count first so each vector allocates once.
+    std::vector<std::uint32_t> childCounts(entityCount, 0);
+    for (std::size_t i = 0; i < entityCount; ++i)
+    {
+        if (const std::int32_t parent = table.parents()->Get(static_cast<fb::uoffset_t>(i)); parent >= 0)
+            ++childCounts[static_cast<std::size_t>(parent)];
+    }
+
+    for (std::size_t i = 0; i < entityCount; ++i)
+    {
+        const entt::entity entity = entities[i];
+        const auto flatIndex = static_cast<fb::uoffset_t>(i);
+        names.get(entity).name = string_at(table.names()->Get(flatIndex));
+
+        const auto* td = table.transforms()->Get(flatIndex);
+        auto& tc = transforms.get(entity);
+        tc.position = {td->position().x(), td->position().y(), td->position().z()};
+        tc.rotation = {td->rotation().x(), td->rotation().y(), td->rotation().z(), td->rotation().w()};
+        tc.scale = {td->scale().x(), td->scale().y(), td->scale().z()};
+
+        auto& hc = hierarchies.get(entity);
+        hc.children.reserve(childCounts[i]);
+        if (const std::int32_t parent = table.parents()->Get(flatIndex); parent >= 0)
+        {
+            hc.parent = entities[static_cast<std::size_t>(parent)];
+            hierarchies.get(hc.parent).children.push_back(entity);
+        }
+    }
+
+    if (table.meshes())
+    {
+        // Files with id columns keep the ids they were written with; older files get them from the strings.
+        AssetRegistry& assetRegistry = AssetRegistry::get();
+        const auto asset_id_at = [&](const fb::Vector<std::uint64_t>* ids, fb::uoffset_t index, std::uint32_t stringIndex) {
+            const std::string_view path = string_at(stringIndex);
+            const AssetId stored{ids && index < ids->size() ? ids->Get(index) : 0};
+            if (!stored.is_valid())
+                return assetRegistry.intern(path);
+            assetRegistry.register_path(stored, path);
+            return stored;
+        };
+
+        std::vector<MeshComponent> meshes;
+        meshes.reserve(table.meshes()->size());
+        for (fb::uoffset_t meshIndex = 0; meshIndex < table.meshes()->size(); ++meshIndex)
+        {
+            const auto* md = table.meshes()->Get(meshIndex);
+            MeshComponent& mc = meshes.emplace_back();
+            mc.meshIndex = md->mesh_index();
+            mc.materialIndex = md->material_index();
+            mc.asset = asset_id_at(table.mesh_asset_ids(), meshIndex, md->asset_path());
+            mc.material = asset_id_at(table.mesh_material_ids(), meshIndex, md->material_name());
+            mc.glowEnabled = md->glow_enabled();
+            mc.glowColor = {md->glow_color().x(), md->glow_color().y(), md->glow_color().z()};
+            mc.glowIntensity = md->glow_intensity();
+        }
+        const auto targets = column_entities(table.mesh_entities(), entities);
+        reg.insert<MeshComponent>(targets.begin(), targets.end(), meshes.begin());
+    }
+
+    if (table.cameras())
+    {
+        std::vector<CameraComponent> cameras;
+        cameras.reserve(table.cameras()->size());
+        for (const auto* cd : *table.cameras())
+        {
+            CameraComponent& cc = cameras.emplace_back();
+            cc.fov = cd->fov();
+            cc.nearPlane = cd->near_plane();
+            cc.farPlane = cd->far_plane();
+            cc.isActive = cd->is_active();
+            cc.target = {cd->target().x(), cd->target().y(), cd->target().z()};
+            cc.distance = cd->distance();
+            cc.yaw = cd->yaw();
+            cc.pitch = cd->pitch();
+        }
+        const auto targets = column_entities(table.camera_entities(), entities);
+        reg.insert<CameraComponent>(targets.begin(), targets.end(), cameras.begin());
+    }
+
+    if (table.scripts())
+    {
+        std::vector<ScriptComponent> scripts;
+        scripts.reserve(table.scripts()->size());
+        for (std::uint32_t scriptPath : *table.scripts())
+            scripts.emplace_back().scriptPath = string_at(scriptPath);
+        const auto targets = column_entities(table.script_entities(), entities);
+        reg.insert<ScriptComponent>(targets.begin(), targets.end(), scripts.begin());
+    }
+
+    if (table.physics())
+    {
+        std::vector<PhysicsBodyComponent> bodies;
+        bodies.reserve(table.physics()->size());
+        for (const auto* pd : *table.physics())
+        {
+            PhysicsBodyComponent& pc = bodies.emplace_back();
+            pc.enabled = pd->enabled();
+            pc.motionType = static_cast<PhysicsBodyMotionType>(pd->motion_type());
+            const auto shapeTypeRaw = static_cast<PhysicsColliderShapeType>(pd->shape_type());
+            pc.shapeType = shapeTypeRaw <= PhysicsColliderShapeType::MutableCompound ? shapeTypeRaw
+                                                                                      : PhysicsColliderShapeType::Box;
+            pc.halfExtents = {pd->half_extents().x(), pd->half_extents().y(), pd->half_extents().z()};
+            pc.radius = pd->radius();
+            pc.halfHeight = pd->half_height();
+            pc.colliderOffset = {pd->collider_offset().x(), pd->collider_offset().y(), pd->collider_offset().z()};
+            pc.friction = pd->friction();
+            pc.restitution = pd->restitution();
+            pc.useGravity = pd->use_gravity();
+            pc.linearDamping = pd->linear_damping();
+            pc.angularDamping = pd->angular_damping();
+            const auto collisionGroupRaw = static_cast<PhysicsBodyCollisionGroup>(pd->collision_group());
+            pc.collisionGroup = collisionGroupRaw <= PhysicsBodyCollisionGroup::Debris ? collisionGroupRaw
+                                                                                      : PhysicsBodyCollisionGroup::Default;
+            pc.runtimeDirty = true;
+            pc.runtimeInitialized = false;
+        }
+        const auto targets = column_entities(table.physics_entities(), entities);
+        reg.insert<PhysicsBodyComponent>(targets.begin(), targets.end(), bodies.begin());
+    }
+
+    if (table.lights())
+    {
+        std::vector<LightComponent> lights;
+        lights.reserve(table.lights()->size());
+        for (const auto* ld : *table.lights())
+        {
+            LightComponent& lc = lights.emplace_back();
+            const auto typeRaw = static_cast<LightType>(ld->type());
+            lc.type = typeRaw <= LightType::Spot ? typeRaw : LightType::Point;
+            lc.color = {ld->color().x(), ld->color().y(), ld->color().z()};
+            lc.intensity = ld->intensity();
+            lc.range = ld->range();
+            lc.innerConeAngle = ld->inner_cone_angle();
+            lc.outerConeAngle = ld->outer_cone_angle();
+        }
+        const auto targets = column_entities(table.light_entities(), entities);
+        reg.insert<LightComponent>(targets.begin(), targets.end(), lights.begin());
+    }
+
+    return {};
+}
+
 //    Public API                                                        
 
-Result<std::vector<uint8_t>> LevelSerializer::serialize(const World& world, const std::string& levelName)
+LevelSnapshot LevelSerializer::snapshot(const World& world, const std::string& levelName)
 {
-    fb::FlatBufferBuilder fbb(4096);
+    auto& mutableWorld = const_cast<World&>(world); // we only read
+    const auto& reg = world.registry();
+
+    LevelSnapshot snapshot;
+    snapshot.levelName = levelName;
 
-    // Serialize root entities
-    auto& mutableWorld = const_cast<World&>(world);
-    const auto& roots = mutableWorld.get_root_entities();
+    std::vector<entt::entity> order;
+    flatten_hierarchy(mutableWorld, order, snapshot.parents);
 
-    std::vector<fb::Offset<fbl::EntityData>> rootOffsets;
-    rootOffsets.reserve(roots.size());
-    for (entt::entity root : roots)
+    LevelStringTable strings{snapshot.strings};
+    snapshot.names.reserve(order.size());
+    snapshot.transforms.reserve(order.size());
+
+    for (std::size_t i = 0; i < order.size(); ++i)
     {
-        rootOffsets.push_back(serialize_entity(fbb, world, root));
+        const entt::entity entity = order[i];
+        const auto index = static_cast<std::uint32_t>(i);
+
+        const auto* nameComp = reg.try_get<NameComponent>(entity);
+        snapshot.names.push_back(nameComp ? strings.intern(nameComp->name) : 0u);
+
+        const auto* tc = reg.try_get<TransformComponent>(entity);
+        snapshot.transforms.push_back(tc ? *tc : TransformComponent{});
+
+        if (const auto* mc = reg.try_get<MeshComponent>(entity))
+        {
+            snapshot.meshEntities.push_back(index);
+            const AssetRegistry& assetRegistry = AssetRegistry::get();
+            snapshot.meshes.push_back(LevelSnapshot::Mesh{
+                mc->meshIndex, mc->materialIndex, strings.intern(assetRegistry.path_of(mc->asset)),
+                strings.intern(assetRegistry.path_of(mc->material)), mc->asset, mc->material, mc->glowEnabled,
+                mc->glowColor, mc->glowIntensity});
+        }
+
+        if (const auto* cc = reg.try_get<CameraComponent>(entity))
+        {
+            snapshot.cameraEntities.push_back(index);
+            snapshot.cameras.push_back(*cc);
+        }
+
+        if (const auto* sc = reg.try_get<ScriptComponent>(entity); sc && !sc->scriptPath.empty())
+        {
+            snapshot.scriptEntities.push_back(index);
+            snapshot.scripts.push_back(strings.intern(sc->scriptPath));
+        }
+
+        if (const auto* pc = reg.try_get<PhysicsBodyComponent>(entity))
+        {
+            snapshot.physicsEntities.push_back(index);
+            snapshot.physics.push_back(*pc);
+        }
+
+        if (const auto* lc = reg.try_get<LightComponent>(entity))
+        {
+            snapshot.lightEntities.push_back(index);
+            snapshot.lights.push_back(*lc);
+        }
     }
 
+    return snapshot;
+}
+
+Result<std::vector<uint8_t>> LevelSerializer::serialize(const World& world, const std::string& levelName)
+{
+    return serialize(snapshot(world, levelName));
+}
+
+Result<std::vector<uint8_t>> LevelSerializer::serialize(const LevelSnapshot& snapshot)
+{
+    fb::FlatBufferBuilder fbb(4096);
+
+    auto entitiesOffset = serialize_entity_table(fbb, snapshot);
+
     // Collect referenced assets
-    auto assetPaths = collect_referenced_assets(world);
+    auto assetPaths = collect_referenced_assets(snapshot);
     std::vector<fb::Offset<fb::String>> assetOffsets;
     assetOffsets.reserve(assetPaths.size());
-    for (const auto& path : assetPaths)
+    for (std::string_view path : assetPaths)
     {
-        assetOffsets.push_back(fbb.CreateString(path));
+        assetOffsets.push_back(fbb.CreateString(path.data(), path.size()));
     }
 
-    auto nameOffset = fbb.CreateString(levelName);
-    auto rootEntitiesOffset = fbb.CreateVector(rootOffsets);
+    auto nameOffset = fbb.CreateString(snapshot.levelName);
     auto referencedAssetsOffset = fbb.CreateVector(assetOffsets);
 
-    auto level = fbl::CreateLevelAsset(fbb, nameOffset, 1, rootEntitiesOffset, referencedAssetsOffset);
+    auto level = fbl::CreateLevelAsset(fbb, nameOffset, Version, 0, referencedAssetsOffset, entitiesOffset);
     fbl::FinishLevelAssetBuffer(fbb, level);
 
     const uint8_t* buf = fbb.GetBufferPointer();
@@ -253,8 +637,9 @@ Result<std::vector<uint8_t>> LevelSerializer::serialize(const World& world, cons
     return std::vector<uint8_t>(buf, buf + size);
 }
 
-Result<> LevelSerializer::deserialize(const std::vector<uint8_t>& buffer, World& world)
+Result<> LevelSerializer::deserialize(std::span<const uint8_t> buffer, World& world)
 {
+    NOC_PROFILE_ZONE("LevelSerializer::deserialize");
     // Verify buffer
     fb::Verifier verifier(buffer.data(), buffer.size());
     if (!fbl::VerifyLevelAssetBuffer(verifier))
@@ -268,21 +653,25 @@ Result<> LevelSerializer::deserialize(const std::vector<uint8_t>& buffer, World&
         return make_error("Failed to parse level asset", ErrorCode::AssetParsingFailed);
     }
 
-    // Deserialize root entities
-    if (const auto* rootEntities = level->root_entities())
-    {
-        for (const auto* entityData : *rootEntities)
-        {
-            deserialize_entity(world, entityData, entt::null);
-        }
-    }
+    if (level->version() > Version)
+        return make_error(fmt::format("Level format version {} is newer than supported ({})", level->version(), Version),
+                          ErrorCode::AssetParsingFailed);
+
+    if (const auto* table = level->entities())
+        return deserialize_entity_table(world, *table);
 
+    deserialize_entity_tree(world, level);
     return {};
 }
 
 Result<> LevelSerializer::save_to_file(const World& world, const std::string& levelName, const std::string& filePath)
 {
-    auto bufferResult = serialize(world, levelName);
+    return save_to_file(snapshot(world, levelName), filePath);
+}
+
+Result<> LevelSerializer::save_to_file(const LevelSnapshot& snapshot, const std::string& filePath)
+{
+    auto bufferResult = serialize(snapshot);
     if (!bufferResult)
         return make_error(bufferResult.error());
 
@@ -299,34 +688,40 @@ Result<> LevelSerializer::save_to_file(const World& world, const std::string& le
         }
     }
 
-    std::ofstream file(filePath, std::ios::binary);
-    if (!file)
-        return make_error(fmt::format("Failed to open file for writing: {}", filePath),
-                          ErrorCode::AssetCacheWriteFailed);
+    // Written next to the level and renamed over it, so a failed or interrupted save keeps the old file.
+    std::filesystem::path tempPath = outputPath;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return make_error(fmt::format("Failed to open file for writing: {}", tempPath.string()),
+                              ErrorCode::AssetCacheWriteFailed);
 
-    const auto& buffer = bufferResult.value();
-    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
-    if (!file)
-        return make_error(fmt::format("Failed to write level to file: {}", filePath), ErrorCode::AssetCacheWriteFailed);
+        const auto& buffer = bufferResult.value();
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        file.close();
+        if (!file)
+            return make_error(fmt::format("Failed to write level to file: {}", tempPath.string()),
+                              ErrorCode::AssetCacheWriteFailed);
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, outputPath, ec);
+    if (ec)
+        return make_error(fmt::format("Failed to move level file into place '{}': {}", filePath, ec.message()),
+                          ErrorCode::AssetCacheWriteFailed);
 
     return {};
 }
 
 Result<> LevelSerializer::load_from_file(const std::string& filePath, World& world)
 {
-    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    NOC_PROFILE_ZONE("LevelSerializer::load_from_file");
+    auto file = VirtualFileSystem::get().open(filePath);
     if (!file)
         return make_error(fmt::format("Failed to open level file: {}", filePath), ErrorCode::AssetFileNotFound);
-
-    auto size = file.tellg();
-    if (size <= 0)
+    if (file->size() == 0)
         return make_error(fmt::format("Level file is empty: {}", filePath), ErrorCode::AssetParsingFailed);
 
-    std::vector<uint8_t> buffer(static_cast<size_t>(size));
-    file.seekg(0);
-    file.read(reinterpret_cast<char*>(buffer.data()), size);
-    if (!file)
-        return make_error(fmt::format("Failed to read level file: {}", filePath), ErrorCode::AssetCacheReadFailed);
-
-    return deserialize(buffer, world);
+    return deserialize(file->bytes(), world);
 }
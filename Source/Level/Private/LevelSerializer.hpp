@@ -1,30 +1,82 @@
 #pragma once
+#include "../../Core/Public/AssetId.hpp"
 #include "../../Core/Public/Core.hpp"
 #include "../../Core/Public/Expected.hpp"
 #include "../../ECS/Public/World.hpp"
 
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
 NOC_SUPPRESS_DLL_WARNINGS
 
+/// Plain copy of everything a level file stores, in file order (entities depth-first, parents first).
+/// Taking one only copies component data, so building and writing the file can run on another
+/// thread while the World keeps changing.
+struct LevelSnapshot
+{
+    struct Mesh
+    {
+        std::int32_t meshIndex{-1};
+        std::int32_t materialIndex{0};
+        std::uint32_t assetPath{}; // index into strings
+        std::uint32_t materialName{};
+        AssetId asset{};
+        AssetId material{};
+        bool glowEnabled{false};
+        DirectX::XMFLOAT3 glowColor{};
+        float glowIntensity{};
+    };
+
+    std::string levelName;
+    std::vector<std::string> strings; // deduplicated names and paths; index 0 is ""
+    std::vector<std::int32_t> parents; // flat index of the parent, -1 for roots
+    std::vector<std::uint32_t> names;
+    std::vector<TransformComponent> transforms;
+    std::vector<std::uint32_t> meshEntities;
+    std::vector<Mesh> meshes;
+    std::vector<std::uint32_t> cameraEntities;
+    std::vector<CameraComponent> cameras;
+    std::vector<std::uint32_t> scriptEntities;
+    std::vector<std::uint32_t> scripts; // script path string indices
+    std::vector<std::uint32_t> physicsEntities;
+    std::vector<PhysicsBodyComponent> physics;
+    std::vector<std::uint32_t> lightEntities;
+    std::vector<LightComponent> lights;
+};
+
 /// Serializes/deserializes a World (ECS registry) to/from a FlatBuffers binary (.noc_level).
+/// Levels are written as a flat entity table (parent indices, per-component columns and a
+/// deduplicated string table); version 1 files with recursive entity trees still load.
 class NOC_EXPORT LevelSerializer
 {
   public:
+    /// Format version written by serialize().
+    static constexpr std::uint32_t Version{2};
+
+    /// Copies the serializable state of the World. Must run on the thread that owns the World.
+    static LevelSnapshot snapshot(const World& world, const std::string& levelName);
+
     /// Serializes the given World into a FlatBuffers binary buffer.
     /// Returns the raw bytes suitable for writing to a file.
     static Result<std::vector<uint8_t>> serialize(const World& world, const std::string& levelName);
 
+    /// Serializes a snapshot; safe to call from any thread.
+    static Result<std::vector<uint8_t>> serialize(const LevelSnapshot& snapshot);
+
     /// Deserializes a FlatBuffers binary buffer into a World.
     /// The caller provides a reference to an empty World that will be populated.
-    static Result<> deserialize(const std::vector<uint8_t>& buffer, World& world);
+    static Result<> deserialize(std::span<const uint8_t> buffer, World& world);
 
-    /// Convenience: serialize directly to a file.
+    /// Convenience: serialize directly to a file. The file is written beside the target and renamed
+    /// over it, so a failed save leaves the previous file intact.
     static Result<> save_to_file(const World& world, const std::string& levelName, const std::string& filePath);
 
-    /// Convenience: load directly from a file into a World.
+    /// Writes a snapshot to a file the same way; safe to call from any thread.
+    static Result<> save_to_file(const LevelSnapshot& snapshot, const std::string& filePath);
+
+    /// Convenience: load directly from a file into a World. Reads through the VirtualFileSystem.
     static Result<> load_from_file(const std::string& filePath, World& world);
 };
 
@@ -3,6 +3,9 @@
 #include "../../Core/Public/Expected.hpp"
 #include "../../ECS/Public/World.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 
 NOC_SUPPRESS_DLL_WARNINGS
@@ -30,6 +33,24 @@ class NOC_EXPORT Level
     /// Saves the level to the given file path and updates the stored path.
     Result<> save_as(const std::string& filePath);
 
+    /// Snapshots the World on the calling thread, then builds and writes the file on a background
+    /// job. The level stays dirty until poll_save() sees the write succeed, and stays dirty after
+    /// that when it was edited in the meantime. Fails if no path is set or a save is in flight.
+    Result<> save_async();
+
+    /// Like save_async(); the stored path changes to `filePath` once the write succeeds.
+    Result<> save_as_async(const std::string& filePath);
+
+    /// True while a background save is building or writing the file.
+    bool is_saving() const noexcept;
+
+    /// Applies a finished background save and returns its result, once. Empty while the save is
+    /// still running or when there is none.
+    std::optional<Result<>> poll_save();
+
+    /// Blocks until the background save (if any) finishes, then applies it like poll_save().
+    Result<> wait_for_save();
+
     //    Accessors                                                       
 
     World& world() noexcept
@@ -62,13 +83,21 @@ class NOC_EXPORT Level
     void mark_dirty() noexcept
     {
         m_dirty = true;
+        ++m_editGeneration;
     }
 
   private:
+    struct PendingSave;
+
+    Result<> start_async_save(const std::string& filePath);
+    Result<> finish_save();
+
     World m_world;
     std::string m_name;
     std::string m_filePath;
     bool m_dirty{false};
+    std::uint64_t m_editGeneration{0};
+    std::shared_ptr<PendingSave> m_pendingSave;
 };
 
 NOC_RESTORE_DLL_WARNINGS
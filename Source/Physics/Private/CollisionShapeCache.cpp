@@ -0,0 +1,183 @@
+#include "CollisionShapeCache.hpp"
+#include "../../Core/Public/VirtualFileSystem.hpp"
+
+#include <CollisionShapeAsset_generated.h>
+#include <flatbuffers/flatbuffers.h>
+
+#include <Jolt/Core/StreamWrapper.h>
+#include <Jolt/Physics/Collision/Shape/ScaledShape.h>
+
+#include <fmt/core.h>
+
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+namespace fb = NatureOfCraft::Assets;
+
+void hash_combine(std::size_t& seed, std::size_t value) noexcept
+{
+    seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+} // namespace
+
+std::size_t CollisionShapeCache::KeyHash::operator()(const Key& key) const noexcept
+{
+    std::size_t seed = std::hash<std::string>{}(key.modelPath);
+    hash_combine(seed, std::hash<std::string>{}(key.meshName));
+    hash_combine(seed, static_cast<std::size_t>(key.shapeType));
+    for (float value : key.localToBody)
+        hash_combine(seed, std::bit_cast<std::uint32_t>(value));
+    return seed;
+}
+
+JPH::ShapeRefC CollisionShapeCache::find(const Key& key)
+{
+    if (m_cookedShapesEnabled && !m_probedModels.contains(key.modelPath))
+        load_cooked_shapes(key.modelPath);
+
+    const auto it = m_shapes.find(key);
+    return it != m_shapes.end() ? it->second : JPH::ShapeRefC{};
+}
+
+void CollisionShapeCache::insert(const Key& key, JPH::ShapeRefC shape)
+{
+    if (shape)
+        m_shapes.insert_or_assign(key, std::move(shape));
+}
+
+void CollisionShapeCache::clear() noexcept
+{
+    m_shapes.clear();
+    m_probedModels.clear();
+}
+
+JPH::ShapeRefC CollisionShapeCache::apply_scale(const JPH::ShapeRefC& shape, const DirectX::XMFLOAT3& scale)
+{
+    constexpr float eps = 0.0001f;
+    if (!shape || (std::abs(scale.x - 1.0f) <= eps && std::abs(scale.y - 1.0f) <= eps && std::abs(scale.z - 1.0f) <= eps))
+        return shape;
+
+    const JPH::Vec3 validScale = shape->MakeScaleValid(JPH::Vec3(scale.x, scale.y, scale.z));
+    return new JPH::ScaledShape(shape, validScale);
+}
+
+std::array<float, 16> CollisionShapeCache::to_key_matrix(const DirectX::XMMATRIX& matrix) noexcept
+{
+    DirectX::XMFLOAT4X4 stored{};
+    DirectX::XMStoreFloat4x4(&stored, matrix);
+    std::array<float, 16> key{};
+    for (std::size_t row = 0; row < 4; ++row)
+        for (std::size_t column = 0; column < 4; ++column)
+            key[row * 4 + column] = stored.m[row][column];
+    return key;
+}
+
+std::filesystem::path CollisionShapeCache::get_cooked_path(const std::filesystem::path& modelPath)
+{
+    std::filesystem::path cookedPath = modelPath;
+    cookedPath.replace_extension(".noc_shapes");
+    return cookedPath;
+}
+
+void CollisionShapeCache::load_cooked_shapes(const std::string& modelPath)
+{
+    m_probedModels.insert(modelPath);
+
+    const std::filesystem::path cookedPath = get_cooked_path(modelPath);
+    auto file = VirtualFileSystem::get().open(cookedPath);
+    if (!file || file->size() == 0)
+        return; // not cooked: shapes get built on demand
+
+    flatbuffers::Verifier verifier(file->data(), file->size());
+    if (!fb::VerifyCollisionShapeAssetBuffer(verifier))
+    {
+        fmt::print("[Physics] Ignoring unreadable collision shapes: {}\n", cookedPath.string());
+        return;
+    }
+
+    const auto* asset = fb::GetCollisionShapeAsset(file->data());
+    if (!asset->entries())
+        return;
+
+    for (const auto* entry : *asset->entries())
+    {
+        if (!entry->shape_data() || !entry->local_to_body() || entry->local_to_body()->size() != 16)
+            continue;
+
+        Key key{};
+        key.modelPath = modelPath;
+        key.meshName = entry->mesh_name() ? entry->mesh_name()->str() : std::string{};
+        key.shapeType = static_cast<PhysicsColliderShapeType>(entry->shape_type());
+        for (std::size_t i = 0; i < 16; ++i)
+            key.localToBody[i] = entry->local_to_body()->Get(static_cast<flatbuffers::uoffset_t>(i));
+
+        std::istringstream stream(std::string(reinterpret_cast<const char*>(entry->shape_data()->data()),
+                                              entry->shape_data()->size()),
+                                  std::ios::binary);
+        JPH::StreamInWrapper streamIn(stream);
+        JPH::Shape::IDToShapeMap shapeMap{};
+        JPH::Shape::IDToMaterialMap materialMap{};
+        JPH::Shape::ShapeResult result = JPH::Shape::sRestoreWithChildren(streamIn, shapeMap, materialMap);
+        if (result.IsValid())
+            m_shapes.insert_or_assign(std::move(key), result.Get());
+    }
+}
+
+std::vector<std::string> CollisionShapeCache::get_model_paths() const
+{
+    std::unordered_set<std::string> unique{};
+    for (const auto& [key, shape] : m_shapes)
+        unique.insert(key.modelPath);
+    return {unique.begin(), unique.end()};
+}
+
+Result<std::uint32_t> CollisionShapeCache::write_cooked_shapes(const std::filesystem::path& modelPath) const
+{
+    const std::string modelKey = modelPath.generic_string();
+    flatbuffers::FlatBufferBuilder builder(64 * 1024);
+    std::vector<flatbuffers::Offset<fb::CollisionShapeEntry>> entries{};
+
+    for (const auto& [key, shape] : m_shapes)
+    {
+        if (key.modelPath != modelKey || !shape)
+            continue;
+
+        std::ostringstream stream(std::ios::binary);
+        JPH::StreamOutWrapper streamOut(stream);
+        JPH::Shape::ShapeToIDMap shapeMap{};
+        JPH::Shape::MaterialToIDMap materialMap{};
+        shape->SaveWithChildren(streamOut, shapeMap, materialMap);
+        if (streamOut.IsFailed())
+            return make_error(fmt::format("Failed to serialize collision shape for '{}'", modelPath.string()),
+                              ErrorCode::AssetCacheWriteFailed);
+
+        const std::string bytes = stream.str();
+        const std::vector<float> localToBody(key.localToBody.begin(), key.localToBody.end());
+        const std::vector<std::uint8_t> shapeData(bytes.begin(), bytes.end());
+        entries.push_back(fb::CreateCollisionShapeEntryDirect(builder, key.meshName.c_str(),
+                                                              static_cast<std::uint8_t>(key.shapeType), &localToBody,
+                                                              &shapeData));
+    }
+
+    if (entries.empty())
+        return 0u;
+
+    fb::FinishCollisionShapeAssetBuffer(builder, fb::CreateCollisionShapeAssetDirect(builder, &entries));
+
+    const std::filesystem::path cookedPath = get_cooked_path(modelPath);
+    std::ofstream file(cookedPath, std::ios::binary);
+    if (!file.is_open())
+        return make_error(fmt::format("Failed to open collision shape file for writing: {}", cookedPath.string()),
+                          ErrorCode::AssetCacheWriteFailed);
+
+    file.write(reinterpret_cast<const char*>(builder.GetBufferPointer()), builder.GetSize());
+    if (!file.good())
+        return make_error(fmt::format("Failed to write collision shape file: {}", cookedPath.string()),
+                          ErrorCode::AssetCacheWriteFailed);
+
+    return static_cast<std::uint32_t>(entries.size());
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "../../Core/Public/Expected.hpp"
+#include "../../ECS/Public/Components.hpp"
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <DirectXMath.h>
+
+/// Model-derived collision shapes shared between bodies and sessions.
+/// The BVH or hull is built once per key; each body wraps the shared shape in a ScaledShape
+/// for its own scale. Cooked builds ship the shapes next to the model (.noc_shapes), so a
+/// cache miss there restores a serialized shape instead of building one.
+class CollisionShapeCache
+{
+  public:
+    struct Key
+    {
+        std::string modelPath{};
+        std::string meshName{};
+        PhysicsColliderShapeType shapeType{PhysicsColliderShapeType::Mesh};
+        std::array<float, 16> localToBody{}; // mesh-to-body transform baked into the vertices
+
+        bool operator==(const Key&) const = default;
+    };
+
+    /// Returns the shared shape for `key`, restoring the model's cooked shapes on first use.
+    JPH::ShapeRefC find(const Key& key);
+    void insert(const Key& key, JPH::ShapeRefC shape);
+
+    /// Skips .noc_shapes files; the cooker uses this so stale output never feeds a new cook.
+    inline void set_cooked_shapes_enabled(bool enabled) noexcept
+    {
+        m_cookedShapesEnabled = enabled;
+    }
+
+    void clear() noexcept;
+
+    inline std::size_t size() const noexcept
+    {
+        return m_shapes.size();
+    }
+
+    /// Wraps `shape` in a ScaledShape unless `scale` is (close to) one.
+    static JPH::ShapeRefC apply_scale(const JPH::ShapeRefC& shape, const DirectX::XMFLOAT3& scale);
+
+    static std::array<float, 16> to_key_matrix(const DirectX::XMMATRIX& matrix) noexcept;
+
+    /// tower.noc_model -> tower.noc_shapes
+    static std::filesystem::path get_cooked_path(const std::filesystem::path& modelPath);
+
+    /// Distinct model paths of the cached shapes.
+    std::vector<std::string> get_model_paths() const;
+
+    /// Writes every cached shape of one model to its .noc_shapes file. Returns the entry count.
+    Result<std::uint32_t> write_cooked_shapes(const std::filesystem::path& modelPath) const;
+
+  private:
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const noexcept;
+    };
+
+    void load_cooked_shapes(const std::string& modelPath);
+
+    std::unordered_map<Key, JPH::ShapeRefC, KeyHash> m_shapes{};
+    std::unordered_set<std::string> m_probedModels{}; // model paths whose .noc_shapes was looked for
+    bool m_cookedShapesEnabled{true};
+};
@@ -1,22 +1,36 @@
 #include "../Public/PhysicsWorld.hpp"
+#include "CollisionShapeCache.hpp"
+#include "TaskflowJobSystem.hpp"
+#include "../../Core/Public/FrameArena.hpp"
+#include "../../Core/Public/Profiler.hpp"
 
 #include <ECS/Public/Components.hpp>
 #include <ECS/Public/World.hpp>
 #include <Assets/Public/AssetManager.hpp>
+#include <Core/Public/VirtualFileSystem.hpp>
 
 #include <Jolt/Jolt.h>
+#include <Jolt/Core/Color.h>
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/IssueReporting.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Core/TempAllocator.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Body/BodyID.h>
+#include <Jolt/Physics/Body/BodyType.h>
+#include <Jolt/Physics/Body/BodyFilter.h>
 #include <Jolt/Physics/Body/BodyInterface.h>
+#include <Jolt/Physics/Body/BodyLock.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayer.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseLayerInterfaceTable.h>
 #include <Jolt/Physics/Collision/BroadPhase/ObjectVsBroadPhaseLayerFilterTable.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
 #include <Jolt/Physics/Collision/ObjectLayer.h>
 #include <Jolt/Physics/Collision/ObjectLayerPairFilterTable.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
 #include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
@@ -34,8 +48,11 @@
 #include <cstdio>
 #include <cstdarg>
 #include <filesystem>
-#include <thread>
-#include <unordered_map>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include <fmt/core.h>
@@ -44,16 +61,21 @@ namespace
 {
 namespace Layers
 {
-static constexpr JPH::ObjectLayer NON_MOVING = 0;
-static constexpr JPH::ObjectLayer MOVING = 1;
-static constexpr std::uint32_t NUM_LAYERS = 2;
+static constexpr JPH::ObjectLayer STATIC = 0;
+static constexpr JPH::ObjectLayer KINEMATIC = 1;
+static constexpr JPH::ObjectLayer DYNAMIC = 2;
+static constexpr JPH::ObjectLayer DEBRIS = 3;  // dynamic, collides with static geometry only
+static constexpr JPH::ObjectLayer TRIGGER = 4; // sensors of any motion type
+static constexpr std::uint32_t NUM_LAYERS = 5;
 } // namespace Layers
 
 namespace BroadPhaseLayers
 {
 static constexpr JPH::BroadPhaseLayer NON_MOVING(0);
 static constexpr JPH::BroadPhaseLayer MOVING(1);
-static constexpr std::uint32_t NUM_LAYERS = 2;
+static constexpr JPH::BroadPhaseLayer DEBRIS(2);
+static constexpr JPH::BroadPhaseLayer TRIGGER(3);
+static constexpr std::uint32_t NUM_LAYERS = 4;
 } // namespace BroadPhaseLayers
 
 static std::uint32_t entity_key(entt::entity entity) noexcept
@@ -61,6 +83,50 @@ static std::uint32_t entity_key(entt::entity entity) noexcept
     return static_cast<std::uint32_t>(entity);
 }
 
+static entt::entity entity_from_user_data(JPH::uint64 userData) noexcept
+{
+    return static_cast<entt::entity>(static_cast<std::uint32_t>(userData));
+}
+
+/// Scene queries see everything but trigger volumes.
+class QueryBroadPhaseFilter final : public JPH::BroadPhaseLayerFilter
+{
+  public:
+    bool ShouldCollide(JPH::BroadPhaseLayer layer) const override
+    {
+        return layer != BroadPhaseLayers::TRIGGER;
+    }
+};
+
+class QueryObjectLayerFilter final : public JPH::ObjectLayerFilter
+{
+  public:
+    bool ShouldCollide(JPH::ObjectLayer layer) const override
+    {
+        return layer != Layers::TRIGGER;
+    }
+};
+
+class IgnoreEntityBodyFilter final : public JPH::BodyFilter
+{
+  public:
+    explicit IgnoreEntityBodyFilter(entt::entity ignore) noexcept : m_ignore{ignore}
+    {}
+
+    bool ShouldCollideLocked(const JPH::Body& body) const override
+    {
+        return m_ignore == entt::null || entity_from_user_data(body.GetUserData()) != m_ignore;
+    }
+
+  private:
+    entt::entity m_ignore{entt::null};
+};
+
+static DirectX::XMFLOAT3 to_float3(JPH::RVec3Arg v) noexcept
+{
+    return {static_cast<float>(v.GetX()), static_cast<float>(v.GetY()), static_cast<float>(v.GetZ())};
+}
+
 static JPH::EMotionType to_motion_type(PhysicsBodyMotionType motionType) noexcept
 {
     switch (motionType)
@@ -75,9 +141,20 @@ static JPH::EMotionType to_motion_type(PhysicsBodyMotionType motionType) noexcep
     }
 }
 
-static JPH::ObjectLayer to_object_layer(PhysicsBodyMotionType motionType) noexcept
+static JPH::ObjectLayer to_object_layer(PhysicsBodyCollisionGroup group, JPH::EMotionType motionType) noexcept
 {
-    return motionType == PhysicsBodyMotionType::Static ? Layers::NON_MOVING : Layers::MOVING;
+    if (group == PhysicsBodyCollisionGroup::Trigger)
+        return Layers::TRIGGER;
+    switch (motionType)
+    {
+    case JPH::EMotionType::Static:
+        return Layers::STATIC;
+    case JPH::EMotionType::Kinematic:
+        return Layers::KINEMATIC;
+    case JPH::EMotionType::Dynamic:
+    default:
+        return group == PhysicsBodyCollisionGroup::Debris ? Layers::DEBRIS : Layers::DYNAMIC;
+    }
 }
 
 static std::array<float, 3> to_scale_key(const DirectX::XMFLOAT3& scale) noexcept
@@ -104,6 +181,7 @@ struct PhysicsStateKey
     bool useGravity{true};
     float linearDamping{0.05f};
     float angularDamping{0.05f};
+    PhysicsBodyCollisionGroup collisionGroup{PhysicsBodyCollisionGroup::Default};
 };
 
 static PhysicsStateKey make_state_key(const PhysicsBodyComponent& bodyComp) noexcept
@@ -120,6 +198,7 @@ static PhysicsStateKey make_state_key(const PhysicsBodyComponent& bodyComp) noex
     key.useGravity = bodyComp.useGravity;
     key.linearDamping = bodyComp.linearDamping;
     key.angularDamping = bodyComp.angularDamping;
+    key.collisionGroup = bodyComp.collisionGroup;
     return key;
 }
 
@@ -135,7 +214,75 @@ static bool state_key_changed(const PhysicsStateKey& a, const PhysicsStateKey& b
            std::abs(a.colliderOffset.z - b.colliderOffset.z) > eps ||
            std::abs(a.friction - b.friction) > eps || std::abs(a.restitution - b.restitution) > eps ||
            a.useGravity != b.useGravity || std::abs(a.linearDamping - b.linearDamping) > eps ||
-           std::abs(a.angularDamping - b.angularDamping) > eps;
+           std::abs(a.angularDamping - b.angularDamping) > eps || a.collisionGroup != b.collisionGroup;
+}
+
+/// Runtime half of a PhysicsBodyComponent, kept densely in the world's registry.
+/// Owned by PhysicsWorld; nothing outside this file reads it.
+struct PhysicsBodyRuntime
+{
+    JPH::BodyID bodyId{}; // invalid until created, and again once queued for destruction
+    std::uint32_t generation{};
+    std::array<float, 3> shapeScale{};
+    PhysicsStateKey state{};
+    JPH::EMotionType motionType{JPH::EMotionType::Static};
+
+    // Dynamic bodies only: body poses before and after the last substep, blended by step().
+    JPH::RVec3 previousPosition{};
+    JPH::Quat previousRotation{JPH::Quat::sIdentity()};
+    JPH::RVec3 currentPosition{};
+    JPH::Quat currentRotation{JPH::Quat::sIdentity()};
+    std::uint32_t previousSerial{}; // step that captured previousPosition/Rotation
+    std::uint32_t poseSerial{};     // step that captured currentPosition/Rotation
+};
+
+/// Per-registry sync bookkeeping, fed by PhysicsBodyComponent signals.
+/// Lives in the registry context so the listeners need no PhysicsWorld pointer.
+struct PhysicsSyncState
+{
+    std::vector<entt::entity> queue;            // bodies to re-check on the next step
+    std::vector<entt::entity> queuedByEntity;   // by entt::to_entity(), the handle sitting in queue
+    std::vector<JPH::BodyID> pendingDestroy;    // bodies whose component or entity went away
+    std::vector<entt::entity> interpolated;     // dynamic bodies blended towards their last step pose
+    std::uint32_t generation{};                 // PhysicsWorld generation the runtime data belongs to
+    bool resyncAll{true};
+
+    void enqueue(entt::entity entity)
+    {
+        const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+        if (entityIndex >= queuedByEntity.size())
+            queuedByEntity.resize(entityIndex + 1, entt::null);
+        if (queuedByEntity[entityIndex] == entity)
+            return;
+        queuedByEntity[entityIndex] = entity;
+        queue.push_back(entity);
+    }
+
+    void release(PhysicsBodyRuntime& runtime)
+    {
+        if (!runtime.bodyId.IsInvalid() && runtime.generation == generation)
+            pendingDestroy.push_back(runtime.bodyId);
+        runtime.bodyId = JPH::BodyID{};
+    }
+};
+
+void on_body_changed(entt::registry& registry, entt::entity entity)
+{
+    registry.ctx().get<PhysicsSyncState>().enqueue(entity);
+}
+
+void on_body_destroyed(entt::registry& registry, entt::entity entity)
+{
+    auto& sync = registry.ctx().get<PhysicsSyncState>();
+    if (auto* runtime = registry.try_get<PhysicsBodyRuntime>(entity))
+        sync.release(*runtime);
+    sync.enqueue(entity);
+}
+
+// Entity destruction may drop the runtime component before the body component.
+void on_runtime_destroyed(entt::registry& registry, entt::entity entity)
+{
+    registry.ctx().get<PhysicsSyncState>().release(registry.get<PhysicsBodyRuntime>(entity));
 }
 
 static JPH::Quat to_jolt_quat(const DirectX::XMFLOAT4& rotation) noexcept
@@ -235,38 +382,43 @@ static bool jolt_assert_failed_impl(const char* inExpression, const char* inMess
     return true;
 }
 #endif
+
+// Initialized PhysicsWorlds sharing Jolt's global factory and type registry (e.g. a cooker next to a game world).
+std::uint32_t joltUserCount{0};
 } // namespace
 
 struct PhysicsWorld::Impl
 {
-    static constexpr std::uint32_t MaxBodies = 65536;
     static constexpr std::uint32_t NumBodyMutexes = 0;
-    static constexpr std::uint32_t MaxBodyPairs = 65536;
-    static constexpr std::uint32_t MaxContactConstraints = 65536;
-    static constexpr std::uint32_t TempAllocatorBytes = 64 * 1024 * 1024;
+    /// Batches at least this large re-optimize the broadphase after insertion.
+    static constexpr std::size_t BulkOptimizeThreshold = 256;
 
+    PhysicsWorldConfig config{};
     bool initialized{false};
     bool enabled{false};
     bool wasEnabledLastStep{false};
     float accumulator{0.0f};
-    float fixedStep{1.0f / 60.0f};
-    std::uint32_t maxSubSteps{4};
+    std::uint32_t stepSerial{}; // bumped by every step() that runs at least one substep
 
     std::unique_ptr<JPH::BroadPhaseLayerInterfaceTable> broadPhaseLayerInterface;
     std::unique_ptr<JPH::ObjectLayerPairFilterTable> objectLayerPairFilter;
     std::unique_ptr<JPH::ObjectVsBroadPhaseLayerFilterTable> objectVsBroadPhaseFilter;
 
     std::unique_ptr<JPH::TempAllocatorImpl> tempAllocator;
-    std::unique_ptr<JPH::JobSystemThreadPool> jobSystem;
+    std::unique_ptr<TaskflowJobSystem> jobSystem;
     JPH::PhysicsSystem physicsSystem;
 
-    std::unordered_map<std::uint32_t, JPH::BodyID> bodies;
-    std::unordered_map<std::uint32_t, std::array<float, 3>> bodyShapeScale;
-    std::unordered_map<std::uint32_t, PhysicsStateKey> bodyState;
+    std::uint32_t generation{1}; // bumped by clear(); runtime data from older generations is stale
+    JPH::BodyIDVector activeBodies;
+    // Bodies created while batching, added in one go by flush_body_batch().
+    bool batchBodyAdds{false};
+    JPH::BodyIDVector batchActivate;
+    JPH::BodyIDVector batchDontActivate;
+    CollisionShapeCache shapeCache;
     AssetManager assetManager;
     std::filesystem::path assetRoot;
 
-    std::filesystem::path resolve_asset_load_path(const std::string& assetPath) const
+    std::filesystem::path resolve_asset_load_path(std::string_view assetPath) const
     {
         std::filesystem::path path(assetPath);
         if (path.empty())
@@ -277,8 +429,7 @@ struct PhysicsWorld::Impl
         if (!assetRoot.empty())
         {
             const std::filesystem::path projectPath = assetRoot / path;
-            std::error_code ec;
-            if (std::filesystem::exists(projectPath, ec))
+            if (VirtualFileSystem::get().exists(projectPath))
                 return projectPath;
         }
 
@@ -302,7 +453,8 @@ struct PhysicsWorld::Impl
 
     JPH::ShapeRefC create_mesh_shape_from_mesh_data(const MeshData& meshData, const DirectX::XMMATRIX& localToBody)
     {
-        if (meshData.vertices.empty() || meshData.indices.size() < 3)
+        const std::span<const std::uint32_t> indices = meshData.base_indices();
+        if (meshData.vertices.empty() || indices.size() < 3)
             return {};
 
         using namespace DirectX;
@@ -317,9 +469,9 @@ struct PhysicsWorld::Impl
         }
 
         JPH::IndexedTriangleList triangles;
-        triangles.reserve(meshData.indices.size() / 3);
-        for (size_t i = 0; i + 2 < meshData.indices.size(); i += 3)
-            triangles.emplace_back(meshData.indices[i], meshData.indices[i + 1], meshData.indices[i + 2]);
+        triangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            triangles.emplace_back(indices[i], indices[i + 1], indices[i + 2]);
 
         JPH::MeshShapeSettings settings(std::move(vertices), std::move(triangles));
         return create_shape_from_result(settings.Create());
@@ -368,7 +520,8 @@ struct PhysicsWorld::Impl
     {
         using namespace DirectX;
         auto& reg = world.registry();
-        std::vector<std::pair<entt::entity, XMMATRIX>> stack{{root, XMMatrixIdentity()}};
+        std::pmr::vector<std::pair<entt::entity, XMMATRIX>> stack{FrameArena::current()};
+        stack.emplace_back(root, XMMatrixIdentity());
 
         while (!stack.empty())
         {
@@ -381,7 +534,7 @@ struct PhysicsWorld::Impl
 
             if (const auto* meshComp = reg.try_get<MeshComponent>(current))
             {
-                if (!meshComp->assetPath.empty())
+                if (meshComp->asset.is_valid())
                 {
                     outMeshComp = meshComp;
                     if (const auto* nameComp = reg.try_get<NameComponent>(current))
@@ -411,12 +564,56 @@ struct PhysicsWorld::Impl
         return false;
     }
 
+    /// Builds the unscaled shape for a cache miss; the only place mesh data gets loaded.
+    JPH::ShapeRefC build_model_shape(const CollisionShapeCache::Key& key, const DirectX::XMMATRIX& meshLocalToRoot)
+    {
+        using namespace DirectX;
+        auto modelHandle = assetManager.load_model(key.modelPath);
+        if (!modelHandle)
+            return {};
+
+        if (key.shapeType == PhysicsColliderShapeType::Mesh)
+        {
+            const MeshData* meshData = find_matching_mesh(*modelHandle, key.meshName);
+            return meshData ? create_mesh_shape_from_mesh_data(*meshData, meshLocalToRoot) : JPH::ShapeRefC{};
+        }
+        if (key.shapeType == PhysicsColliderShapeType::ConvexHull)
+        {
+            const MeshData* meshData = find_matching_mesh(*modelHandle, key.meshName);
+            return meshData ? create_convex_hull_shape_from_mesh_data(*meshData, meshLocalToRoot) : JPH::ShapeRefC{};
+        }
+        if (modelHandle->meshes.empty())
+            return {};
+
+        if (key.shapeType == PhysicsColliderShapeType::StaticCompound)
+        {
+            JPH::StaticCompoundShapeSettings settings;
+            for (const auto& mesh : modelHandle->meshes)
+            {
+                auto childShape = create_convex_hull_shape_from_mesh_data(mesh, XMMatrixIdentity());
+                if (childShape)
+                    settings.AddShape(JPH::Vec3::sZero(), JPH::Quat::sIdentity(), childShape.GetPtr());
+            }
+            return settings.mSubShapes.empty() ? JPH::ShapeRefC{} : create_shape_from_result(settings.Create());
+        }
+
+        JPH::MutableCompoundShapeSettings settings;
+        for (const auto& mesh : modelHandle->meshes)
+        {
+            auto childShape = create_convex_hull_shape_from_mesh_data(mesh, XMMatrixIdentity());
+            if (childShape)
+                settings.AddShape(JPH::Vec3::sZero(), JPH::Quat::sIdentity(), childShape.GetPtr());
+        }
+        return settings.mSubShapes.empty() ? JPH::ShapeRefC{} : create_shape_from_result(settings.Create());
+    }
+
+    /// Shared model shape for the body, scaled by the entity's own scale. Null when the entity
+    /// has no usable mesh source; the caller then falls back to a primitive.
     JPH::ShapeRefC create_model_shape(World& world,
                                       entt::entity entity,
                                       const PhysicsBodyComponent& bodyComp,
                                       const TransformComponent& transform)
     {
-        auto& reg = world.registry();
         using namespace DirectX;
         const MeshComponent* meshComp = nullptr;
         std::string meshName;
@@ -424,59 +621,28 @@ struct PhysicsWorld::Impl
         if (!find_mesh_source_in_subtree(world, entity, meshComp, meshName, meshLocalToRoot))
             return {};
 
-        const std::filesystem::path modelPath = resolve_asset_load_path(meshComp->assetPath);
+        const std::filesystem::path modelPath = resolve_asset_load_path(AssetRegistry::get().path_of(meshComp->asset));
         if (modelPath.empty())
             return {};
 
-        auto modelHandle = assetManager.load_model(modelPath);
-        if (!modelHandle)
-            return {};
+        // Compounds use every mesh untransformed, so only the path and type tell them apart.
+        const bool compound = bodyComp.shapeType == PhysicsColliderShapeType::StaticCompound ||
+                              bodyComp.shapeType == PhysicsColliderShapeType::MutableCompound;
+        CollisionShapeCache::Key key{};
+        key.modelPath = modelPath.generic_string();
+        key.meshName = compound ? std::string{} : meshName;
+        key.shapeType = bodyComp.shapeType;
+        key.localToBody = CollisionShapeCache::to_key_matrix(compound ? XMMatrixIdentity() : meshLocalToRoot);
 
-        if (bodyComp.shapeType == PhysicsColliderShapeType::Mesh)
-        {
-            const MeshData* meshData = find_matching_mesh(*modelHandle, meshName);
-            if (auto shape = meshData ? create_mesh_shape_from_mesh_data(*meshData, meshLocalToRoot) : JPH::ShapeRefC{}; shape)
-                return shape;
-        }
-        else if (bodyComp.shapeType == PhysicsColliderShapeType::ConvexHull)
-        {
-            const MeshData* meshData = find_matching_mesh(*modelHandle, meshName);
-            if (auto shape = meshData ? create_convex_hull_shape_from_mesh_data(*meshData, meshLocalToRoot) : JPH::ShapeRefC{}; shape)
-                return shape;
-        }
-        else if (bodyComp.shapeType == PhysicsColliderShapeType::StaticCompound ||
-                 bodyComp.shapeType == PhysicsColliderShapeType::MutableCompound)
+        JPH::ShapeRefC shape = shapeCache.find(key);
+        if (!shape)
         {
-            if (modelHandle->meshes.empty())
+            shape = build_model_shape(key, meshLocalToRoot);
+            if (!shape)
                 return {};
-
-            if (bodyComp.shapeType == PhysicsColliderShapeType::StaticCompound)
-            {
-                JPH::StaticCompoundShapeSettings settings;
-                for (const auto& mesh : modelHandle->meshes)
-                {
-                    auto childShape = create_convex_hull_shape_from_mesh_data(mesh, XMMatrixIdentity());
-                    if (childShape)
-                        settings.AddShape(JPH::Vec3::sZero(), JPH::Quat::sIdentity(), childShape.GetPtr());
-                }
-                if (!settings.mSubShapes.empty())
-                    return create_shape_from_result(settings.Create());
-            }
-            else
-            {
-                JPH::MutableCompoundShapeSettings settings;
-                for (const auto& mesh : modelHandle->meshes)
-                {
-                    auto childShape = create_convex_hull_shape_from_mesh_data(mesh, XMMatrixIdentity());
-                    if (childShape)
-                        settings.AddShape(JPH::Vec3::sZero(), JPH::Quat::sIdentity(), childShape.GetPtr());
-                }
-                if (!settings.mSubShapes.empty())
-                    return create_shape_from_result(settings.Create());
-            }
+            shapeCache.insert(key, shape);
         }
-
-        return create_primitive_shape(bodyComp, transform);
+        return CollisionShapeCache::apply_scale(shape, transform.scale);
     }
 
     JPH::ShapeRefC create_collision_shape(World& world,
@@ -510,11 +676,18 @@ struct PhysicsWorld::Impl
             std::make_unique<JPH::BroadPhaseLayerInterfaceTable>(Layers::NUM_LAYERS, BroadPhaseLayers::NUM_LAYERS);
         objectLayerPairFilter = std::make_unique<JPH::ObjectLayerPairFilterTable>(Layers::NUM_LAYERS);
 
-        broadPhaseLayerInterface->MapObjectToBroadPhaseLayer(Layers::NON_MOVING, BroadPhaseLayers::NON_MOVING);
-        broadPhaseLayerInterface->MapObjectToBroadPhaseLayer(Layers::MOVING, BroadPhaseLayers::MOVING);
+        broadPhaseLayerInterface->MapObjectToBroadPhaseLayer(Layers::STATIC, BroadPhaseLayers::NON_MOVING);
+        broadPhaseLayerInterface->MapObjectToBroadPhaseLayer(Layers::KINEMATIC, BroadPhaseLayers::MOVING);
+        broadPhaseLayerInterface->MapObjectToBroadPhaseLayer(Layers::DYNAMIC, BroadPhaseLayers::MOVING);
+        broadPhaseLayerInterface->MapObjectToBroadPhaseLayer(Layers::DEBRIS, BroadPhaseLayers::DEBRIS);
+        broadPhaseLayerInterface->MapObjectToBroadPhaseLayer(Layers::TRIGGER, BroadPhaseLayers::TRIGGER);
 
-        objectLayerPairFilter->EnableCollision(Layers::MOVING, Layers::MOVING);
-        objectLayerPairFilter->EnableCollision(Layers::MOVING, Layers::NON_MOVING);
+        objectLayerPairFilter->EnableCollision(Layers::DYNAMIC, Layers::STATIC);
+        objectLayerPairFilter->EnableCollision(Layers::DYNAMIC, Layers::KINEMATIC);
+        objectLayerPairFilter->EnableCollision(Layers::DYNAMIC, Layers::DYNAMIC);
+        objectLayerPairFilter->EnableCollision(Layers::DEBRIS, Layers::STATIC);
+        objectLayerPairFilter->EnableCollision(Layers::TRIGGER, Layers::DYNAMIC);
+        objectLayerPairFilter->EnableCollision(Layers::TRIGGER, Layers::KINEMATIC);
 
         objectVsBroadPhaseFilter = std::make_unique<JPH::ObjectVsBroadPhaseLayerFilterTable>(
             *broadPhaseLayerInterface,
@@ -523,6 +696,31 @@ struct PhysicsWorld::Impl
             Layers::NUM_LAYERS);
     }
 
+    /// Adds the batched bodies with one broadphase insertion per activation mode. Large batches,
+    /// like a level load, rebuild the broadphase trees once afterwards instead of degrading them.
+    void flush_body_batch(bool forceOptimize)
+    {
+        batchBodyAdds = false;
+        const std::size_t added = batchActivate.size() + batchDontActivate.size();
+        if (added == 0)
+            return;
+
+        JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
+        for (auto [ids, activation] : {std::pair{&batchDontActivate, JPH::EActivation::DontActivate},
+                                       std::pair{&batchActivate, JPH::EActivation::Activate}})
+        {
+            if (ids->empty())
+                continue;
+            const int count = static_cast<int>(ids->size());
+            JPH::BodyInterface::AddState state = bodyInterface.AddBodiesPrepare(ids->data(), count);
+            bodyInterface.AddBodiesFinalize(ids->data(), count, state, activation);
+            ids->clear();
+        }
+
+        if (forceOptimize || added >= BulkOptimizeThreshold)
+            physicsSystem.OptimizeBroadPhase();
+    }
+
     void destroy_body(JPH::BodyID id)
     {
         JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
@@ -531,14 +729,22 @@ struct PhysicsWorld::Impl
         bodyInterface.DestroyBody(id);
     }
 
-    void recreate_body(World& world, PhysicsBodyComponent& bodyComp, const TransformComponent& transform, entt::entity entity)
+    void destroy_runtime(entt::registry& reg, PhysicsSyncState& sync, entt::entity entity)
     {
-        const auto key = entity_key(entity);
-        if (auto bodyIt = bodies.find(key); bodyIt != bodies.end())
-        {
-            destroy_body(bodyIt->second);
-            bodies.erase(bodyIt);
-        }
+        auto* runtime = reg.try_get<PhysicsBodyRuntime>(entity);
+        if (!runtime)
+            return;
+        if (!runtime->bodyId.IsInvalid() && runtime->generation == sync.generation)
+            destroy_body(runtime->bodyId);
+        runtime->bodyId = JPH::BodyID{}; // keeps the destroy listener from queueing it again
+        reg.remove<PhysicsBodyRuntime>(entity);
+    }
+
+    void recreate_body(World& world, PhysicsSyncState& sync, PhysicsBodyComponent& bodyComp,
+                       const TransformComponent& transform, entt::entity entity)
+    {
+        auto& reg = world.registry();
+        destroy_runtime(reg, sync, entity);
 
         JPH::ShapeRefC shape = create_collision_shape(world, entity, bodyComp, transform);
         if (!shape)
@@ -550,7 +756,7 @@ struct PhysicsWorld::Impl
             to_body_position(transform, bodyComp),
             to_jolt_quat(transform.rotation),
             motionType,
-            motionType == JPH::EMotionType::Static ? Layers::NON_MOVING : Layers::MOVING);
+            to_object_layer(bodyComp.collisionGroup, motionType));
 
         if (bodyComp.shapeType == PhysicsColliderShapeType::Mesh && motionType != JPH::EMotionType::Static)
         {
@@ -566,6 +772,8 @@ struct PhysicsWorld::Impl
         settings.mLinearDamping = std::max(bodyComp.linearDamping, 0.0f);
         settings.mAngularDamping = std::max(bodyComp.angularDamping, 0.0f);
         settings.mGravityFactor = bodyComp.useGravity ? 1.0f : 0.0f;
+        settings.mUserData = entity_key(entity); // maps active bodies back to entities in step()
+        settings.mIsSensor = bodyComp.collisionGroup == PhysicsBodyCollisionGroup::Trigger;
 
         JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
         JPH::Body* body = bodyInterface.CreateBody(settings);
@@ -575,93 +783,325 @@ struct PhysicsWorld::Impl
         const JPH::BodyID bodyId = body->GetID();
         const JPH::EActivation activation = (motionType == JPH::EMotionType::Static) ? JPH::EActivation::DontActivate
                                                                                        : JPH::EActivation::Activate;
-        bodyInterface.AddBody(bodyId, activation);
+        if (batchBodyAdds)
+            (activation == JPH::EActivation::Activate ? batchActivate : batchDontActivate).push_back(bodyId);
+        else
+            bodyInterface.AddBody(bodyId, activation);
 
-        bodies[key] = bodyId;
-        bodyShapeScale[key] = to_scale_key(transform.scale);
-        bodyState[key] = make_state_key(bodyComp);
+        reg.emplace<PhysicsBodyRuntime>(entity, PhysicsBodyRuntime{bodyId, sync.generation, to_scale_key(transform.scale),
+                                                                   make_state_key(bodyComp), motionType});
         bodyComp.runtimeDirty = false;
         bodyComp.runtimeInitialized = true;
     }
 
+    /// Pushes the authored pose to bodies the simulation does not own: static and kinematic ones,
+    /// and dynamic ones while simulation is disabled. Recreates the body when its scale changed.
+    void sync_pose(World& world, PhysicsSyncState& sync, entt::entity entity)
+    {
+        auto& reg = world.registry();
+        auto* runtime = reg.try_get<PhysicsBodyRuntime>(entity);
+        auto* bodyComp = reg.try_get<PhysicsBodyComponent>(entity);
+        const auto* transform = reg.try_get<TransformComponent>(entity);
+        if (!runtime || runtime->bodyId.IsInvalid() || !bodyComp || !transform)
+            return;
+
+        if (bodyComp->runtimeDirty || scale_changed(runtime->shapeScale, to_scale_key(transform->scale)))
+        {
+            recreate_body(world, sync, *bodyComp, *transform, entity);
+            return;
+        }
+
+        JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
+        if (runtime->motionType == JPH::EMotionType::Static || runtime->motionType == JPH::EMotionType::Kinematic)
+        {
+            bodyInterface.SetPositionAndRotationWhenChanged(runtime->bodyId, to_body_position(*transform, *bodyComp),
+                                                            to_jolt_quat(transform->rotation),
+                                                            JPH::EActivation::DontActivate);
+        }
+        else if (!enabled)
+        {
+            // Keep dynamic bodies in editor-authored pose while simulation is disabled.
+            bodyInterface.SetPositionAndRotationWhenChanged(runtime->bodyId, to_body_position(*transform, *bodyComp),
+                                                            to_jolt_quat(transform->rotation),
+                                                            JPH::EActivation::DontActivate);
+            bodyInterface.SetLinearAndAngularVelocity(runtime->bodyId, JPH::Vec3::sZero(), JPH::Vec3::sZero());
+        }
+    }
+
+    /// Re-checks one queued entity: creates, recreates or destroys its body as needed.
+    void refresh_body(World& world, PhysicsSyncState& sync, entt::entity entity)
+    {
+        auto& reg = world.registry();
+        if (!reg.valid(entity))
+            return; // destroyed: its body is already in pendingDestroy
+
+        auto* bodyComp = reg.try_get<PhysicsBodyComponent>(entity);
+        const auto* transform = reg.try_get<TransformComponent>(entity);
+        if (!bodyComp || !transform || !bodyComp->enabled)
+        {
+            destroy_runtime(reg, sync, entity);
+            return;
+        }
+
+        const auto* runtime = reg.try_get<PhysicsBodyRuntime>(entity);
+        if (!runtime || runtime->bodyId.IsInvalid() || bodyComp->runtimeDirty ||
+            scale_changed(runtime->shapeScale, to_scale_key(transform->scale)) ||
+            state_key_changed(runtime->state, make_state_key(*bodyComp)))
+        {
+            recreate_body(world, sync, *bodyComp, *transform, entity);
+            return;
+        }
+        sync_pose(world, sync, entity);
+    }
+
+    /// Returns the world's sync state, connecting the signals the first time this world is seen
+    /// and discarding runtime data that predates the last clear().
+    PhysicsSyncState& sync_state(entt::registry& reg)
+    {
+        if (!reg.ctx().contains<PhysicsSyncState>())
+        {
+            reg.ctx().emplace<PhysicsSyncState>();
+            reg.on_construct<PhysicsBodyComponent>().connect<&on_body_changed>();
+            reg.on_update<PhysicsBodyComponent>().connect<&on_body_changed>();
+            reg.on_destroy<PhysicsBodyComponent>().connect<&on_body_destroyed>();
+            reg.on_destroy<PhysicsBodyRuntime>().connect<&on_runtime_destroyed>();
+        }
+
+        auto& sync = reg.ctx().get<PhysicsSyncState>();
+        if (sync.generation != generation)
+        {
+            // Bodies were destroyed wholesale; the stale ids must not reach destroy_body().
+            sync.generation = generation;
+            sync.pendingDestroy.clear();
+            sync.interpolated.clear();
+            reg.clear<PhysicsBodyRuntime>();
+            sync.resyncAll = true;
+        }
+        return sync;
+    }
+
     void sync_entities(World& world)
     {
         auto& reg = world.registry();
+        PhysicsSyncState& sync = sync_state(reg);
+
+        for (const JPH::BodyID& bodyId : sync.pendingDestroy)
+            destroy_body(bodyId);
+        sync.pendingDestroy.clear();
+
+        const bool resyncAll = sync.resyncAll;
+        if (resyncAll)
+        {
+            for (entt::entity entity : reg.view<PhysicsBodyComponent>())
+                sync.enqueue(entity);
+            sync.resyncAll = false;
+        }
+
+        // Component changes first; recreated bodies already carry the current pose.
+        std::vector<entt::entity> queue{};
+        queue.swap(sync.queue);
+        batchBodyAdds = true;
+        for (entt::entity entity : queue)
+        {
+            const auto entityIndex = static_cast<std::size_t>(entt::to_entity(entity));
+            if (sync.queuedByEntity[entityIndex] == entity)
+                sync.queuedByEntity[entityIndex] = entt::null;
+            refresh_body(world, sync, entity);
+        }
+        flush_body_batch(resyncAll);
 
-        for (auto it = bodies.begin(); it != bodies.end();)
+        // Then transforms moved through World APIs since the last world-matrix update.
+        if (world.are_all_transforms_dirty())
+        {
+            // Copied: a scale change recreates the body, which reinserts the runtime component.
+            auto runtimeView = reg.view<PhysicsBodyRuntime>();
+            std::vector<entt::entity> withBodies(runtimeView.begin(), runtimeView.end());
+            for (entt::entity entity : withBodies)
+                sync_pose(world, sync, entity);
+        }
+        else
         {
-            const entt::entity entity = static_cast<entt::entity>(it->first);
-            if (!reg.valid(entity) || !reg.all_of<PhysicsBodyComponent, TransformComponent>(entity))
+            const auto& runtimes = reg.storage<PhysicsBodyRuntime>();
+            for (entt::entity entity : world.get_marked_transforms())
             {
-                destroy_body(it->second);
-                bodyShapeScale.erase(it->first);
-                bodyState.erase(it->first);
-                it = bodies.erase(it);
-                continue;
+                if (reg.valid(entity) && runtimes.contains(entity))
+                    sync_pose(world, sync, entity);
             }
+        }
+    }
 
-            const auto& bodyComp = reg.get<PhysicsBodyComponent>(entity);
-            if (!bodyComp.enabled)
-            {
-                destroy_body(it->second);
-                bodyShapeScale.erase(it->first);
-                bodyState.erase(it->first);
-                it = bodies.erase(it);
+    float get_interpolation_alpha() const noexcept
+    {
+        return std::clamp(accumulator / config.fixedStep, 0.0f, 1.0f);
+    }
+
+    /// Runtime of a simulated dynamic body, or null when the entity no longer has one.
+    static PhysicsBodyRuntime* find_dynamic_runtime(entt::registry& reg, entt::entity entity)
+    {
+        if (!reg.valid(entity) || !reg.all_of<PhysicsBodyComponent, TransformComponent>(entity))
+            return nullptr;
+        auto* runtime = reg.try_get<PhysicsBodyRuntime>(entity);
+        if (!runtime || runtime->bodyId.IsInvalid() || runtime->motionType != JPH::EMotionType::Dynamic)
+            return nullptr;
+        return runtime;
+    }
+
+    /// Records the pose each active dynamic body has before the last substep of this step().
+    void capture_previous_poses(entt::registry& reg)
+    {
+        JPH::BodyIDVector ids{};
+        physicsSystem.GetActiveBodies(JPH::EBodyType::RigidBody, ids);
+        const JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
+        for (const JPH::BodyID& bodyId : ids)
+        {
+            const auto entity = static_cast<entt::entity>(static_cast<std::uint32_t>(bodyInterface.GetUserData(bodyId)));
+            auto* runtime = find_dynamic_runtime(reg, entity);
+            if (!runtime || runtime->bodyId != bodyId)
                 continue;
-            }
+            bodyInterface.GetPositionAndRotation(bodyId, runtime->previousPosition, runtime->previousRotation);
+            runtime->previousSerial = stepSerial;
+        }
+    }
 
-            ++it;
+    /// Writes the body pose blended `alpha` of the way from the previous to the current substep.
+    static void write_pose(World& world, entt::entity entity, const PhysicsBodyRuntime& runtime, float alpha)
+    {
+        auto& reg = world.registry();
+        JPH::RVec3 position = runtime.currentPosition;
+        JPH::Quat rotation = runtime.currentRotation;
+        if (alpha < 1.0f)
+        {
+            position = runtime.previousPosition + (runtime.currentPosition - runtime.previousPosition) * JPH::Real(alpha);
+            rotation = runtime.previousRotation.SLERP(runtime.currentRotation, alpha).Normalized();
         }
 
-        auto view = reg.view<PhysicsBodyComponent, TransformComponent>();
-        for (entt::entity entity : view)
+        auto& transform = reg.get<TransformComponent>(entity);
+        transform.rotation = {rotation.GetX(), rotation.GetY(), rotation.GetZ(), rotation.GetW()};
+        transform.position =
+            to_entity_position(position, transform.rotation, reg.get<PhysicsBodyComponent>(entity).colliderOffset);
+        world.mark_transform_dirty(entity);
+    }
+
+    /// Snaps every interpolated body of the world to its last simulated pose.
+    void finish_interpolation(World& world)
+    {
+        auto& reg = world.registry();
+        if (!reg.ctx().contains<PhysicsSyncState>())
+            return;
+        auto& sync = reg.ctx().get<PhysicsSyncState>();
+        for (entt::entity entity : sync.interpolated)
         {
-            auto& bodyComp = view.get<PhysicsBodyComponent>(entity);
-            const auto& transform = view.get<TransformComponent>(entity);
+            if (auto* runtime = find_dynamic_runtime(reg, entity))
+                write_pose(world, entity, *runtime, 1.0f);
+        }
+        sync.interpolated.clear();
+    }
 
-            if (!bodyComp.enabled)
-                continue;
+    /// Longest ray or cast a query runs; keeps "infinite" rays numerically sane.
+    static constexpr float MaxQueryDistance = 100000.0f;
 
-            const auto scaleKey = to_scale_key(transform.scale);
-            const auto scaleIt = bodyShapeScale.find(entity_key(entity));
-            if (scaleIt == bodyShapeScale.end() || scale_changed(scaleIt->second, scaleKey))
-                bodyComp.runtimeDirty = true;
+    /// Normalized query direction and clamped length; false for degenerate rays.
+    static bool prepare_query_ray(const PhysicsRay& ray, JPH::Vec3& outDirection, float& outDistance) noexcept
+    {
+        const JPH::Vec3 direction(ray.direction.x, ray.direction.y, ray.direction.z);
+        const float length = direction.Length();
+        if (length < 1e-6f || !(ray.maxDistance > 0.0f))
+            return false;
+        outDirection = direction / length;
+        outDistance = std::min(ray.maxDistance, MaxQueryDistance);
+        return true;
+    }
 
-            const auto stateIt = bodyState.find(entity_key(entity));
-            const auto newState = make_state_key(bodyComp);
-            if (stateIt == bodyState.end() || state_key_changed(stateIt->second, newState))
-                bodyComp.runtimeDirty = true;
+    std::optional<PhysicsHit> cast_ray(const PhysicsRay& ray, entt::entity ignore) const
+    {
+        JPH::Vec3 direction{};
+        float distance = 0.0f;
+        if (!prepare_query_ray(ray, direction, distance))
+            return std::nullopt;
+
+        const JPH::RRayCast joltRay{JPH::RVec3(ray.origin.x, ray.origin.y, ray.origin.z), direction * distance};
+        JPH::RayCastResult result{};
+        const QueryBroadPhaseFilter broadPhaseFilter{};
+        const QueryObjectLayerFilter layerFilter{};
+        const IgnoreEntityBodyFilter bodyFilter{ignore};
+        if (!physicsSystem.GetNarrowPhaseQuery().CastRay(joltRay, result, broadPhaseFilter, layerFilter, bodyFilter))
+            return std::nullopt;
+
+        const JPH::RVec3 point = joltRay.GetPointOnRay(result.mFraction);
+        JPH::BodyLockRead lock(physicsSystem.GetBodyLockInterface(), result.mBodyID);
+        if (!lock.Succeeded())
+            return std::nullopt;
+
+        const JPH::Body& body = lock.GetBody();
+        PhysicsHit hit{};
+        hit.entity = entity_from_user_data(body.GetUserData());
+        hit.distance = result.mFraction * distance;
+        hit.position = to_float3(point);
+        hit.normal = to_float3(body.GetWorldSpaceSurfaceNormal(result.mSubShapeID2, point));
+        return hit;
+    }
 
-            auto bodyIt = bodies.find(entity_key(entity));
-            if (bodyIt == bodies.end() || bodyComp.runtimeDirty)
-                recreate_body(world, bodyComp, transform, entity);
+    std::optional<PhysicsHit> cast_shape(const JPH::Shape& shape, const JPH::Quat& rotation, const PhysicsRay& ray,
+                                         entt::entity ignore) const
+    {
+        JPH::Vec3 direction{};
+        float distance = 0.0f;
+        if (!prepare_query_ray(ray, direction, distance))
+            return std::nullopt;
+
+        const JPH::RShapeCast cast(&shape, JPH::Vec3::sReplicate(1.0f),
+                                   JPH::RMat44::sRotationTranslation(rotation, JPH::RVec3(ray.origin.x, ray.origin.y, ray.origin.z)),
+                                   direction * distance);
+        JPH::ShapeCastSettings settings{};
+        JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector{};
+        const QueryBroadPhaseFilter broadPhaseFilter{};
+        const QueryObjectLayerFilter layerFilter{};
+        const IgnoreEntityBodyFilter bodyFilter{ignore};
+        physicsSystem.GetNarrowPhaseQuery().CastShape(cast, settings, JPH::RVec3::sZero(), collector, broadPhaseFilter,
+                                                      layerFilter, bodyFilter);
+        if (!collector.HadHit())
+            return std::nullopt;
+
+        const JPH::ShapeCastResult& result = collector.mHit;
+        PhysicsHit hit{};
+        hit.entity = entity_from_user_data(physicsSystem.GetBodyInterface().GetUserData(result.mBodyID2));
+        hit.distance = result.mFraction * distance;
+        hit.position = to_float3(JPH::RVec3(result.mContactPointOn2));
+        hit.normal = to_float3(JPH::RVec3(-result.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero())));
+        return hit;
+    }
 
-            bodyIt = bodies.find(entity_key(entity));
-            if (bodyIt == bodies.end())
-                continue;
+    void collide_shape(const JPH::Shape& shape, const JPH::Quat& rotation, const DirectX::XMFLOAT3& center,
+                       std::vector<entt::entity>& out) const
+    {
+        JPH::CollideShapeSettings settings{};
+        JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector{};
+        const QueryBroadPhaseFilter broadPhaseFilter{};
+        const QueryObjectLayerFilter layerFilter{};
+        physicsSystem.GetNarrowPhaseQuery().CollideShape(
+            &shape, JPH::Vec3::sReplicate(1.0f),
+            JPH::RMat44::sRotationTranslation(rotation, JPH::RVec3(center.x, center.y, center.z)), settings,
+            JPH::RVec3::sZero(), collector, broadPhaseFilter, layerFilter);
+
+        // One entry per body, however many sub-shapes touched.
+        JPH::BodyIDVector bodyIds{};
+        bodyIds.reserve(collector.mHits.size());
+        for (const JPH::CollideShapeResult& result : collector.mHits)
+            bodyIds.push_back(result.mBodyID2);
+        std::sort(bodyIds.begin(), bodyIds.end());
+        bodyIds.erase(std::unique(bodyIds.begin(), bodyIds.end()), bodyIds.end());
+
+        const JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
+        for (const JPH::BodyID& bodyId : bodyIds)
+            out.push_back(entity_from_user_data(bodyInterface.GetUserData(bodyId)));
+    }
 
-            const JPH::EMotionType motionType = effective_motion_type(bodyComp);
-            if (motionType == JPH::EMotionType::Static || motionType == JPH::EMotionType::Kinematic)
-            {
-                JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
-                bodyInterface.SetPositionAndRotationWhenChanged(
-                    bodyIt->second,
-                    to_body_position(transform, bodyComp),
-                    to_jolt_quat(transform.rotation),
-                    JPH::EActivation::DontActivate);
-            }
-            else if (!enabled)
-            {
-                // Keep dynamic bodies in editor-authored pose while simulation is disabled.
-                JPH::BodyInterface& bodyInterface = physicsSystem.GetBodyInterface();
-                bodyInterface.SetPositionAndRotationWhenChanged(
-                    bodyIt->second,
-                    to_body_position(transform, bodyComp),
-                    to_jolt_quat(transform.rotation),
-                    JPH::EActivation::DontActivate);
-                bodyInterface.SetLinearAndAngularVelocity(bodyIt->second, JPH::Vec3::sZero(), JPH::Vec3::sZero());
-            }
-        }
+    /// Appends the currently active rigid bodies to activeBodies.
+    void gather_active_bodies()
+    {
+        JPH::BodyIDVector ids{};
+        physicsSystem.GetActiveBodies(JPH::EBodyType::RigidBody, ids);
+        activeBodies.insert(activeBodies.end(), ids.begin(), ids.end());
     }
 };
 
@@ -676,7 +1116,7 @@ PhysicsWorld::~PhysicsWorld()
 PhysicsWorld::PhysicsWorld(PhysicsWorld&&) noexcept = default;
 PhysicsWorld& PhysicsWorld::operator=(PhysicsWorld&&) noexcept = default;
 
-::Result<> PhysicsWorld::initialize()
+::Result<> PhysicsWorld::initialize(const PhysicsWorldConfig& config)
 {
     if (!m_impl)
         m_impl = std::make_unique<Impl>();
@@ -689,26 +1129,30 @@ PhysicsWorld& PhysicsWorld::operator=(PhysicsWorld&&) noexcept = default;
     JPH::AssertFailed = jolt_assert_failed_impl;
 #endif
 
-    JPH::RegisterDefaultAllocator();
-    JPH::Factory::sInstance = new JPH::Factory();
-    JPH::RegisterTypes();
+    if (joltUserCount++ == 0)
+    {
+        JPH::RegisterDefaultAllocator();
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+    }
 
+    m_impl->config = config;
+    m_impl->config.fixedStep = config.fixedStep > 0.0f ? config.fixedStep : 1.0f / 60.0f;
+    m_impl->config.maxSubSteps = std::max(config.maxSubSteps, 1u);
+    m_impl->accumulator = 0.0f;
     m_impl->configure_layers();
 
-    m_impl->tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(Impl::TempAllocatorBytes);
+    m_impl->tempAllocator = std::make_unique<JPH::TempAllocatorImpl>(config.tempAllocatorBytes);
 
-    const std::uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
-    const std::uint32_t workerThreads = (hardwareThreads > 1) ? (hardwareThreads - 1) : 1;
-    m_impl->jobSystem = std::make_unique<JPH::JobSystemThreadPool>(
-        JPH::cMaxPhysicsJobs,
-        JPH::cMaxPhysicsBarriers,
-        static_cast<int>(workerThreads));
+    m_impl->jobSystem = std::make_unique<TaskflowJobSystem>(JobSystem::get(), JPH::cMaxPhysicsJobs,
+                                                            JPH::cMaxPhysicsBarriers, config.workerThreadCount);
+    m_impl->config.workerThreadCount = static_cast<std::uint32_t>(m_impl->jobSystem->GetMaxConcurrency());
 
     m_impl->physicsSystem.Init(
-        Impl::MaxBodies,
+        config.maxBodies,
         Impl::NumBodyMutexes,
-        Impl::MaxBodyPairs,
-        Impl::MaxContactConstraints,
+        config.maxBodyPairs,
+        config.maxContactConstraints,
         *m_impl->broadPhaseLayerInterface,
         *m_impl->objectVsBroadPhaseFilter,
         *m_impl->objectLayerPairFilter);
@@ -727,9 +1171,12 @@ void PhysicsWorld::shutdown()
     m_impl->jobSystem.reset();
     m_impl->tempAllocator.reset();
 
-    JPH::UnregisterTypes();
-    delete JPH::Factory::sInstance;
-    JPH::Factory::sInstance = nullptr;
+    if (--joltUserCount == 0)
+    {
+        JPH::UnregisterTypes();
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
+    }
 
     m_impl->initialized = false;
 }
@@ -746,6 +1193,31 @@ bool PhysicsWorld::is_enabled() const noexcept
     return m_impl && m_impl->enabled;
 }
 
+void PhysicsWorld::set_fixed_step(float stepSeconds) noexcept
+{
+    if (!m_impl || stepSeconds <= 0.0f)
+        return;
+    m_impl->config.fixedStep = stepSeconds;
+}
+
+void PhysicsWorld::set_interpolation_enabled(bool enabled) noexcept
+{
+    if (!m_impl)
+        return;
+    m_impl->config.interpolate = enabled;
+}
+
+float PhysicsWorld::get_interpolation_alpha() const noexcept
+{
+    return m_impl && m_impl->config.interpolate ? m_impl->get_interpolation_alpha() : 1.0f;
+}
+
+const PhysicsWorldConfig& PhysicsWorld::get_config() const noexcept
+{
+    static const PhysicsWorldConfig defaultConfig{};
+    return m_impl ? m_impl->config : defaultConfig;
+}
+
 void PhysicsWorld::set_asset_root(const std::string& rootPath)
 {
     if (!m_impl)
@@ -756,9 +1228,14 @@ void PhysicsWorld::set_asset_root(const std::string& rootPath)
 
 void PhysicsWorld::step(World& world, float deltaTime)
 {
+    NOC_PROFILE_ZONE("PhysicsWorld::step");
     if (!m_impl || !m_impl->initialized)
         return;
 
+    // Leave dynamic bodies at their simulated pose, not a blend, before the editor pose takes over.
+    if (!m_impl->enabled && m_impl->wasEnabledLastStep)
+        m_impl->finish_interpolation(world);
+
     const bool enableTransition = m_impl->enabled && !m_impl->wasEnabledLastStep;
     if (enableTransition)
     {
@@ -768,6 +1245,7 @@ void PhysicsWorld::step(World& world, float deltaTime)
         auto view = world.registry().view<PhysicsBodyComponent>();
         for (entt::entity entity : view)
             view.get<PhysicsBodyComponent>(entity).runtimeDirty = true;
+        m_impl->sync_state(world.registry()).resyncAll = true;
     }
 
     m_impl->sync_entities(world);
@@ -780,41 +1258,77 @@ void PhysicsWorld::step(World& world, float deltaTime)
 
     m_impl->accumulator += std::max(0.0f, deltaTime);
 
-    std::uint32_t steps = 0;
-    while (m_impl->accumulator >= m_impl->fixedStep && steps < m_impl->maxSubSteps)
+    const float fixedStep = m_impl->config.fixedStep;
+    const bool interpolate = m_impl->config.interpolate;
+    const auto stepCount =
+        std::min(static_cast<std::uint32_t>(m_impl->accumulator / fixedStep), m_impl->config.maxSubSteps);
+
+    auto& reg = world.registry();
+    PhysicsSyncState& sync = m_impl->sync_state(reg);
+    if (stepCount == 0)
     {
-        m_impl->physicsSystem.Update(m_impl->fixedStep, 1, m_impl->tempAllocator.get(), m_impl->jobSystem.get());
-        m_impl->accumulator -= m_impl->fixedStep;
-        ++steps;
+        // No new simulation state: only move interpolated bodies further towards the last step.
+        if (interpolate)
+        {
+            const float alpha = m_impl->get_interpolation_alpha();
+            for (entt::entity entity : sync.interpolated)
+            {
+                if (auto* runtime = m_impl->find_dynamic_runtime(reg, entity))
+                    m_impl->write_pose(world, entity, *runtime, alpha);
+            }
+        }
+        m_impl->wasEnabledLastStep = true;
+        return;
     }
 
-    auto& reg = world.registry();
-    auto view = reg.view<PhysicsBodyComponent, TransformComponent>();
+    // Bodies that fall asleep during the update still moved in it, so gather before and after.
+    ++m_impl->stepSerial;
+    m_impl->activeBodies.clear();
+    m_impl->gather_active_bodies();
+    for (std::uint32_t i = 0; i < stepCount; ++i)
+    {
+        if (interpolate && i + 1 == stepCount)
+            m_impl->capture_previous_poses(reg);
+        m_impl->physicsSystem.Update(fixedStep, 1, m_impl->tempAllocator.get(), m_impl->jobSystem.get());
+        m_impl->accumulator -= fixedStep;
+    }
+    m_impl->gather_active_bodies();
+    auto& activeBodies = m_impl->activeBodies;
+    std::sort(activeBodies.begin(), activeBodies.end());
+    activeBodies.erase(std::unique(activeBodies.begin(), activeBodies.end()), activeBodies.end());
 
-    bool anyTransformUpdated = false;
-    JPH::BodyInterface& bodyInterface = m_impl->physicsSystem.GetBodyInterface();
+    const float alpha = interpolate ? m_impl->get_interpolation_alpha() : 1.0f;
+    const JPH::BodyInterface& bodyInterface = m_impl->physicsSystem.GetBodyInterface();
+    std::vector<entt::entity> previouslyInterpolated{};
+    previouslyInterpolated.swap(sync.interpolated);
 
-    for (entt::entity entity : view)
+    for (const JPH::BodyID& bodyId : activeBodies)
     {
-        auto& bodyComp = view.get<PhysicsBodyComponent>(entity);
-        if (!bodyComp.enabled || m_impl->effective_motion_type(bodyComp) != JPH::EMotionType::Dynamic)
-            continue;
-
-        auto bodyIt = m_impl->bodies.find(entity_key(entity));
-        if (bodyIt == m_impl->bodies.end())
+        const auto entity = static_cast<entt::entity>(static_cast<std::uint32_t>(bodyInterface.GetUserData(bodyId)));
+        auto* runtime = m_impl->find_dynamic_runtime(reg, entity);
+        if (!runtime || runtime->bodyId != bodyId)
             continue;
 
-        auto& transform = view.get<TransformComponent>(entity);
-        const JPH::RVec3 position = bodyInterface.GetPosition(bodyIt->second);
-        const JPH::Quat rotation = bodyInterface.GetRotation(bodyIt->second);
-
-        transform.rotation = {rotation.GetX(), rotation.GetY(), rotation.GetZ(), rotation.GetW()};
-        transform.position = to_entity_position(position, transform.rotation, bodyComp.colliderOffset);
-        anyTransformUpdated = true;
+        bodyInterface.GetPositionAndRotation(bodyId, runtime->currentPosition, runtime->currentRotation);
+        runtime->poseSerial = m_impl->stepSerial;
+        if (runtime->previousSerial != m_impl->stepSerial)
+        {
+            // Asleep before the last substep: nothing to blend from.
+            runtime->previousPosition = runtime->currentPosition;
+            runtime->previousRotation = runtime->currentRotation;
+        }
+        m_impl->write_pose(world, entity, *runtime, alpha);
+        if (interpolate)
+            sync.interpolated.push_back(entity);
     }
 
-    if (anyTransformUpdated)
-        world.mark_transforms_dirty();
+    // Bodies that went to sleep since the previous step settle on their final pose.
+    for (entt::entity entity : previouslyInterpolated)
+    {
+        auto* runtime = m_impl->find_dynamic_runtime(reg, entity);
+        if (runtime && runtime->poseSerial != m_impl->stepSerial)
+            m_impl->write_pose(world, entity, *runtime, 1.0f);
+    }
 
     m_impl->wasEnabledLastStep = true;
 }
@@ -824,61 +1338,138 @@ void PhysicsWorld::clear()
     if (!m_impl || !m_impl->initialized)
         return;
 
-    for (const auto& [entity, bodyId] : m_impl->bodies)
-    {
-        (void)entity;
+    // Bodies of every world go at once; each world drops its now-stale runtime data on its next step.
+    JPH::BodyIDVector bodyIds{};
+    m_impl->physicsSystem.GetBodies(bodyIds);
+    for (const JPH::BodyID& bodyId : bodyIds)
         m_impl->destroy_body(bodyId);
-    }
 
-    m_impl->bodies.clear();
-    m_impl->bodyShapeScale.clear();
-    m_impl->bodyState.clear();
+    ++m_impl->generation;
     m_impl->accumulator = 0.0f;
 }
 
-void PhysicsWorld::on_entity_tree_destroyed(World& world, entt::entity entity)
+Result<std::uint32_t> PhysicsWorld::cook_collision_shapes(World& world)
 {
     if (!m_impl || !m_impl->initialized)
-        return;
+        return make_error("Physics world is not initialized");
+
+    CollisionShapeCache& cache = m_impl->shapeCache;
+    cache.clear();
+    cache.set_cooked_shapes_enabled(false);
 
     auto& reg = world.registry();
-    if (!reg.valid(entity))
+    auto view = reg.view<PhysicsBodyComponent, TransformComponent>();
+    for (entt::entity entity : view)
+    {
+        const auto& bodyComp = view.get<PhysicsBodyComponent>(entity);
+        if (!bodyComp.enabled || (bodyComp.shapeType != PhysicsColliderShapeType::Mesh &&
+                                  bodyComp.shapeType != PhysicsColliderShapeType::ConvexHull &&
+                                  bodyComp.shapeType != PhysicsColliderShapeType::StaticCompound &&
+                                  bodyComp.shapeType != PhysicsColliderShapeType::MutableCompound))
+            continue;
+        m_impl->create_model_shape(world, entity, bodyComp, view.get<TransformComponent>(entity));
+    }
+
+    std::uint32_t written = 0;
+    Result<std::uint32_t> result = written;
+    for (const std::string& modelPath : cache.get_model_paths())
+    {
+        result = cache.write_cooked_shapes(modelPath);
+        if (!result)
+            break;
+        written += *result;
+    }
+
+    cache.clear();
+    cache.set_cooked_shapes_enabled(true);
+    if (!result)
+        return make_error(result.error());
+    return written;
+}
+
+std::optional<PhysicsHit> PhysicsWorld::raycast(const PhysicsRay& ray, entt::entity ignore) const
+{
+    if (!m_impl || !m_impl->initialized)
+        return std::nullopt;
+    return m_impl->cast_ray(ray, ignore);
+}
+
+void PhysicsWorld::raycast_batch(std::span<const PhysicsRay> rays, std::span<std::optional<PhysicsHit>> outHits,
+                                 entt::entity ignore) const
+{
+    const std::size_t count = std::min(rays.size(), outHits.size());
+    if (!m_impl || !m_impl->initialized)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            outHits[i].reset();
         return;
+    }
 
-    std::vector<entt::entity> stack{entity};
+    constexpr std::size_t RaysPerJob = 64;
+    const Impl& impl = *m_impl;
+    if (count <= RaysPerJob)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            outHits[i] = impl.cast_ray(rays[i], ignore);
+        return;
+    }
 
-    while (!stack.empty())
+    JPH::JobSystem& jobSystem = *m_impl->jobSystem;
+    JPH::JobSystem::Barrier* barrier = jobSystem.CreateBarrier();
+    for (std::size_t begin = 0; begin < count; begin += RaysPerJob)
     {
-        const entt::entity current = stack.back();
-        stack.pop_back();
+        const std::size_t end = std::min(begin + RaysPerJob, count);
+        JPH::JobHandle job =
+            jobSystem.CreateJob("RaycastBatch", JPH::Color::sGreen, [&impl, rays, outHits, ignore, begin, end]() {
+                for (std::size_t i = begin; i < end; ++i)
+                    outHits[i] = impl.cast_ray(rays[i], ignore);
+            });
+        barrier->AddJob(job);
+    }
+    jobSystem.WaitForJobs(barrier);
+    jobSystem.DestroyBarrier(barrier);
+}
 
-        if (!reg.valid(current))
-            continue;
+std::optional<PhysicsHit> PhysicsWorld::sphere_cast(const PhysicsRay& ray, float radius, entt::entity ignore) const
+{
+    if (!m_impl || !m_impl->initialized || !(radius > 0.0f))
+        return std::nullopt;
 
-        if (const auto* hierarchy = reg.try_get<HierarchyComponent>(current))
-        {
-            for (entt::entity child : hierarchy->children)
-            {
-                if (reg.valid(child))
-                    stack.push_back(child);
-            }
-        }
+    JPH::SphereShape sphere(radius);
+    sphere.SetEmbedded();
+    return m_impl->cast_shape(sphere, JPH::Quat::sIdentity(), ray, ignore);
+}
 
-        on_entity_removed(current);
-    }
+std::optional<PhysicsHit> PhysicsWorld::box_cast(const PhysicsRay& ray, const DirectX::XMFLOAT3& halfExtents,
+                                                 const DirectX::XMFLOAT4& rotation, entt::entity ignore) const
+{
+    if (!m_impl || !m_impl->initialized || !(halfExtents.x > 0.0f && halfExtents.y > 0.0f && halfExtents.z > 0.0f))
+        return std::nullopt;
+
+    const JPH::Vec3 extents(halfExtents.x, halfExtents.y, halfExtents.z);
+    JPH::BoxShape box(extents, std::min(JPH::cDefaultConvexRadius, extents.ReduceMin()));
+    box.SetEmbedded();
+    return m_impl->cast_shape(box, to_jolt_quat(rotation).Normalized(), ray, ignore);
 }
 
-void PhysicsWorld::on_entity_removed(entt::entity entity)
+void PhysicsWorld::overlap_sphere(const DirectX::XMFLOAT3& center, float radius, std::vector<entt::entity>& out) const
 {
-    if (!m_impl || !m_impl->initialized)
+    if (!m_impl || !m_impl->initialized || !(radius > 0.0f))
         return;
 
-    auto bodyIt = m_impl->bodies.find(entity_key(entity));
-    if (bodyIt == m_impl->bodies.end())
+    JPH::SphereShape sphere(radius);
+    sphere.SetEmbedded();
+    m_impl->collide_shape(sphere, JPH::Quat::sIdentity(), center, out);
+}
+
+void PhysicsWorld::overlap_box(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& halfExtents,
+                               const DirectX::XMFLOAT4& rotation, std::vector<entt::entity>& out) const
+{
+    if (!m_impl || !m_impl->initialized || !(halfExtents.x > 0.0f && halfExtents.y > 0.0f && halfExtents.z > 0.0f))
         return;
 
-    m_impl->destroy_body(bodyIt->second);
-    m_impl->bodyShapeScale.erase(bodyIt->first);
-    m_impl->bodyState.erase(bodyIt->first);
-    m_impl->bodies.erase(bodyIt);
+    const JPH::Vec3 extents(halfExtents.x, halfExtents.y, halfExtents.z);
+    JPH::BoxShape box(extents, std::min(JPH::cDefaultConvexRadius, extents.ReduceMin()));
+    box.SetEmbedded();
+    m_impl->collide_shape(box, to_jolt_quat(rotation).Normalized(), center, out);
 }
@@ -0,0 +1,56 @@
+#include "TaskflowJobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+TaskflowJobSystem::TaskflowJobSystem(JobSystem& jobs, std::uint32_t maxJobs, std::uint32_t maxBarriers,
+                                     std::uint32_t maxConcurrency)
+    : JPH::JobSystemWithBarrier(maxBarriers), m_jobs{jobs}
+{
+    const std::uint32_t workers = jobs.worker_count();
+    m_maxConcurrency = static_cast<int>(maxConcurrency > 0 ? std::min(maxConcurrency, workers) : workers);
+    m_jobPool.Init(maxJobs, maxJobs);
+}
+
+JPH::JobHandle TaskflowJobSystem::CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction,
+                                            JPH::uint32 inNumDependencies)
+{
+    // Same policy as JobSystemThreadPool: the pool is sized for a full step, so exhaustion is brief.
+    JPH::uint32 index = 0;
+    for (;;)
+    {
+        index = m_jobPool.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+        if (index != JPH::FixedSizeFreeList<Job>::cInvalidObjectIndex)
+            break;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    Job* job = &m_jobPool.Get(index);
+    JobHandle handle(job);
+    if (inNumDependencies == 0)
+        QueueJob(job);
+    return handle;
+}
+
+void TaskflowJobSystem::QueueJob(Job* inJob)
+{
+    // The reference keeps the job alive until the worker is done; Execute() is a no-op when a
+    // barrier wait already ran it.
+    inJob->AddRef();
+    m_jobs.submit(JobPriority::Frame, [inJob]() {
+        inJob->Execute();
+        inJob->Release();
+    });
+}
+
+void TaskflowJobSystem::QueueJobs(Job** inJobs, JPH::uint inNumJobs)
+{
+    for (JPH::uint i = 0; i < inNumJobs; ++i)
+        QueueJob(inJobs[i]);
+}
+
+void TaskflowJobSystem::FreeJob(Job* inJob)
+{
+    m_jobPool.DestructObject(inJob);
+}
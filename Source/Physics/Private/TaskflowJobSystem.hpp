@@ -0,0 +1,37 @@
+#pragma once
+#include "../../Core/Public/JobSystem.hpp"
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+#include <cstdint>
+
+/// Jolt job system that runs physics jobs on the engine JobSystem instead of Jolt's own thread pool.
+/// Barriers come from JobSystemWithBarrier, whose wait executes ready jobs on the waiting thread,
+/// so a physics step called from a frame-graph worker keeps making progress.
+class TaskflowJobSystem final : public JPH::JobSystemWithBarrier
+{
+  public:
+    /// `maxConcurrency` caps the parallelism Jolt plans for; 0 uses every job system worker.
+    TaskflowJobSystem(JobSystem& jobs, std::uint32_t maxJobs, std::uint32_t maxBarriers, std::uint32_t maxConcurrency);
+    ~TaskflowJobSystem() override = default;
+
+    int GetMaxConcurrency() const override
+    {
+        return m_maxConcurrency;
+    }
+
+    JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction,
+                        JPH::uint32 inNumDependencies = 0) override;
+
+  protected:
+    void QueueJob(Job* inJob) override;
+    void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+    void FreeJob(Job* inJob) override;
+
+  private:
+    JobSystem& m_jobs;
+    int m_maxConcurrency{1};
+    JPH::FixedSizeFreeList<Job> m_jobPool;
+};
@@ -6,12 +6,47 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
+
+#include <DirectXMath.h>
 
 class World;
 
 NOC_SUPPRESS_DLL_WARNINGS
 
+struct NOC_EXPORT PhysicsWorldConfig
+{
+    /// Parallelism Jolt plans its jobs for. The jobs run on the engine JobSystem; 0 uses all of its workers.
+    std::uint32_t workerThreadCount{0};
+    std::uint32_t tempAllocatorBytes{64 * 1024 * 1024};
+    std::uint32_t maxBodies{65536};
+    std::uint32_t maxBodyPairs{65536};
+    std::uint32_t maxContactConstraints{65536};
+    float fixedStep{1.0f / 60.0f};
+    std::uint32_t maxSubSteps{4};
+    /// Blend dynamic body transforms between the last two fixed steps by the leftover frame time,
+    /// so a low simulation rate still moves smoothly at any frame rate.
+    bool interpolate{true};
+};
+
+struct NOC_EXPORT PhysicsRay
+{
+    DirectX::XMFLOAT3 origin{0.0f, 0.0f, 0.0f};
+    DirectX::XMFLOAT3 direction{0.0f, 0.0f, 1.0f}; // need not be normalized
+    float maxDistance{1000.0f};
+};
+
+struct NOC_EXPORT PhysicsHit
+{
+    entt::entity entity{entt::null}; // entity owning the body that was hit
+    float distance{0.0f};            // along the ray or cast
+    DirectX::XMFLOAT3 position{0.0f, 0.0f, 0.0f};
+    DirectX::XMFLOAT3 normal{0.0f, 1.0f, 0.0f};
+};
+
 class NOC_EXPORT PhysicsWorld
 {
   public:
@@ -23,19 +58,57 @@ class NOC_EXPORT PhysicsWorld
     PhysicsWorld(PhysicsWorld&&) noexcept;
     PhysicsWorld& operator=(PhysicsWorld&&) noexcept;
 
-    ::Result<> initialize();
+    ::Result<> initialize(const PhysicsWorldConfig& config = {});
     void shutdown();
 
     void set_enabled(bool enabled) noexcept;
     bool is_enabled() const noexcept;
 
+    /// Simulation rate, changeable at any time; values <= 0 are ignored.
+    void set_fixed_step(float stepSeconds) noexcept;
+    void set_interpolation_enabled(bool enabled) noexcept;
+    /// How far rendered dynamic bodies are between the previous and the latest fixed step (1 without interpolation).
+    float get_interpolation_alpha() const noexcept;
+
+    /// Settings of the last initialize(); defaults before that.
+    const PhysicsWorldConfig& get_config() const noexcept;
+
     void set_asset_root(const std::string& rootPath);
 
+    /// Applies queued body changes, advances the simulation and writes active dynamic bodies back,
+    /// interpolated between fixed steps when enabled. Interpolated TransformComponents hold the
+    /// rendered pose; the simulated one stays inside the physics world.
+    /// Bodies follow PhysicsBodyComponent construct/update/destroy signals: after editing a component
+    /// in place, set runtimeDirty and patch() it (or mark the entity's transform dirty).
     void step(World& world, float deltaTime);
     void clear();
 
-    void on_entity_tree_destroyed(World& world, entt::entity entity);
-    void on_entity_removed(entt::entity entity);
+    // --- Scene queries ---
+    // Run against the bodies as of the last step() and skip trigger bodies. Safe to call from
+    // several threads at once, but not while step() runs.
+
+    /// Nearest body hit by the ray.
+    std::optional<PhysicsHit> raycast(const PhysicsRay& ray, entt::entity ignore = entt::null) const;
+    /// Casts every ray, spread over the physics job threads for large batches.
+    /// `outHits[i]` receives the result of `rays[i]`; extra entries on either side are ignored.
+    void raycast_batch(std::span<const PhysicsRay> rays, std::span<std::optional<PhysicsHit>> outHits,
+                       entt::entity ignore = entt::null) const;
+    /// First body a sphere sweeping along the ray touches.
+    std::optional<PhysicsHit> sphere_cast(const PhysicsRay& ray, float radius, entt::entity ignore = entt::null) const;
+    /// First body an oriented box sweeping along the ray touches.
+    std::optional<PhysicsHit> box_cast(const PhysicsRay& ray, const DirectX::XMFLOAT3& halfExtents,
+                                       const DirectX::XMFLOAT4& rotation = {0.0f, 0.0f, 0.0f, 1.0f},
+                                       entt::entity ignore = entt::null) const;
+    /// Appends every entity whose body overlaps the sphere. `out` is not cleared.
+    void overlap_sphere(const DirectX::XMFLOAT3& center, float radius, std::vector<entt::entity>& out) const;
+    /// Appends every entity whose body overlaps the oriented box. `out` is not cleared.
+    void overlap_box(const DirectX::XMFLOAT3& center, const DirectX::XMFLOAT3& halfExtents,
+                     const DirectX::XMFLOAT4& rotation, std::vector<entt::entity>& out) const;
+
+    /// Builds the model collision shapes of every enabled body in `world` and writes them next
+    /// to their models (.noc_shapes), so runtime bodies restore them instead of building BVHs.
+    /// Existing .noc_shapes files are ignored. Returns the number of shapes written.
+    ::Result<std::uint32_t> cook_collision_shapes(World& world);
 
   private:
     struct Impl;
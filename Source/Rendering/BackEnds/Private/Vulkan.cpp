@@ -5,18 +5,29 @@
 #include "../Public/Vulkan.hpp"
 #include "../../../Assets/Public/MeshData.hpp"
 #include "../../../Assets/Public/TextureData.hpp"
+#include "../../../Core/Public/FrameArena.hpp"
+#include "../../../Core/Public/JobSystem.hpp"
+#include "../../../Core/Public/Profiler.hpp"
 #include "../../../Core/Public/RuntimePaths.hpp"
 #include "../../Public/Mesh.hpp"
 #include "../../Public/ShaderCompiler.hpp"
 
 #include <algorithm>
+#include <condition_variable>
 #include <array>
+#include <bit>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <span>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <GLFW/glfw3.h>
@@ -24,11 +35,104 @@
 #include <imgui_impl_vulkan.h>
 
 #include <DirectXMath.h>
-#include <DirectXCollision.h>
 #include <fmt/core.h>
 #include "../../../ThirdParty/NIS/NIS_Config.h"
 using namespace DirectX;
 
+namespace
+{
+/// On-screen deviation, in pixels, a LOD may show at a bias of 1.0.
+constexpr float LodErrorPixels{1.0f};
+
+/// Image index passed to record_command_buffer() for offscreen frames (presentation disabled).
+constexpr std::uint32_t NoSwapchainImage{std::numeric_limits<std::uint32_t>::max()};
+
+/// Coarsest level of `mesh` whose error stays within budget for a world-space sphere.
+std::uint32_t select_mesh_lod(const Mesh& mesh, const XMFLOAT4& worldSphere, FXMVECTOR cameraPosition,
+                              float lodDistanceScale) noexcept
+{
+    if (mesh.lodCount <= 1)
+        return 0;
+
+    const float distance =
+        XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat4(&worldSphere), cameraPosition)));
+    if (distance <= worldSphere.w)
+        return 0;
+
+    const float projectedRadius = worldSphere.w * lodDistanceScale / distance;
+    std::uint32_t lod = 0;
+    while (lod + 1 < mesh.lodCount && mesh.lods[lod + 1].error * projectedRadius <= 1.0f)
+        ++lod;
+    return lod;
+}
+
+/// Size of Hi-Z level `level` along an axis whose level 0 is `base`; every level halves, rounding up.
+std::uint32_t hiz_level_size(std::uint32_t base, std::uint32_t level) noexcept
+{
+    for (std::uint32_t i = 0; i < level; ++i)
+        base = (base + 1) / 2;
+    return std::max(1u, base);
+}
+
+/// Fewest scene batches worth a secondary command buffer of their own, and the most chunks a frame
+/// is split into.
+constexpr std::size_t MinBatchesPerRecordChunk{64};
+constexpr std::size_t MaxSceneRecordChunks{16};
+
+/// Longest run of adjacent indirect commands merged into one multi-draw; the smallest
+/// maxDrawIndirectCount a device with multiDrawIndirect may report.
+constexpr std::uint32_t MaxMultiDrawRun{65535};
+
+/// Camera travel after which the GPU culling path re-sorts its batches by view distance.
+constexpr float GpuCullReorderDistance{1.0f};
+
+/// Dynamic resolution scale bounds, and the relative frame time error it leaves alone so the
+/// scale does not chase timing noise.
+constexpr float MinDynamicResolutionScale{0.25f};
+constexpr float MinNisDynamicResolutionScale{0.5f};
+constexpr float MaxDynamicResolutionScale{1.0f};
+constexpr float DynamicResolutionDeadband{0.05f};
+/// Frames dynamic resolution waits for a GPU frame timing before warning that it is stuck.
+constexpr std::uint32_t DynamicResolutionStarvedFrameLimit{120};
+
+/// Cooked textures keep their levels up to this size, per side, resident; finer levels are streamed.
+constexpr std::uint32_t TextureStreamingBaseSize{128};
+/// Staging bytes and image swaps texture streaming may have started per frame and in flight.
+constexpr VkDeviceSize MaxTextureStreamBytesPerFrame{32ull * 1024 * 1024};
+constexpr std::uint32_t MaxTextureStreamsInFlight{16};
+constexpr float MinTextureStreamingBudgetFraction{0.25f};
+constexpr float MaxTextureStreamingBudgetFraction{0.95f};
+/// On-screen diameter, in pixels, reported for instances the camera is inside of.
+constexpr std::uint32_t MaxScreenPixels{65535};
+
+/// Largest Hi-Z level, per side, copied back for the CPU occlusion test.
+constexpr std::uint32_t HiZReadbackMaxSize{128};
+
+/// View depth the sun shadow cascades end at (or the far plane, when nearer).
+constexpr float ShadowDistance{150.0f};
+/// Blend between uniform (0) and logarithmic (1) cascade splits.
+constexpr float ShadowSplitLambda{0.75f};
+/// Extra radius cached cascades are fitted with, as a fraction of the slice's own radius; the camera
+/// can move this far before they are refitted.
+constexpr float ShadowCacheMargin{0.25f};
+/// How far towards the sun casters outside a cascade's slice are still drawn into it.
+constexpr float ShadowCasterReach{100.0f};
+/// Depth bias of the caster pass, in the rasterizer's depth units.
+constexpr float ShadowDepthBiasConstant{1.25f};
+constexpr float ShadowDepthBiasSlope{1.75f};
+
+/// Whether a world-space sphere touches the volume bounded by `frustum`.
+bool sphere_touches_frustum(const FrustumPlanes& frustum, const XMFLOAT4& sphere) noexcept
+{
+    for (const XMFLOAT4& plane : frustum.planes)
+    {
+        if (plane.x * sphere.x + plane.y * sphere.y + plane.z * sphere.z + plane.w < -sphere.w)
+            return false;
+    }
+    return true;
+}
+} // namespace
+
 Vulkan::Vulkan(GLFWwindow* window) : m_vulkanDevice(window), m_swapchain(m_vulkanDevice), m_pipeline(m_vulkanDevice)
 {
     if (const RuntimePaths* runtimePaths = RuntimePaths::try_current())
@@ -36,58 +140,112 @@ Vulkan::Vulkan(GLFWwindow* window) : m_vulkanDevice(window), m_swapchain(m_vulka
         m_nisShaderPath = runtimePaths->resolve_engine_resource(std::filesystem::path("NIS") / "NIS_Main.glsl");
         m_vertShaderPath = runtimePaths->resolve_engine_resource("shader.vert");
         m_fragShaderPath = runtimePaths->resolve_engine_resource("shader.frag");
+        m_cullShaderPath = runtimePaths->resolve_engine_resource("cull.comp");
+        m_clusterShaderPath = runtimePaths->resolve_engine_resource("cluster.comp");
+        m_hiZShaderPath = runtimePaths->resolve_engine_resource("hiz.comp");
+        m_hiZMultisampleShaderPath = runtimePaths->resolve_engine_resource("hiz_ms.comp");
+        m_depthVertShaderPath = runtimePaths->resolve_engine_resource("depth.vert");
+        m_debugVertShaderPath = runtimePaths->resolve_engine_resource("debug.vert");
+        m_debugFragShaderPath = runtimePaths->resolve_engine_resource("debug.frag");
     }
     else
     {
         m_nisShaderPath = std::filesystem::path("Resources") / "NIS" / "NIS_Main.glsl";
         m_vertShaderPath = std::filesystem::path("Resources") / "shader.vert";
         m_fragShaderPath = std::filesystem::path("Resources") / "shader.frag";
+        m_cullShaderPath = std::filesystem::path("Resources") / "cull.comp";
+        m_clusterShaderPath = std::filesystem::path("Resources") / "cluster.comp";
+        m_hiZShaderPath = std::filesystem::path("Resources") / "hiz.comp";
+        m_hiZMultisampleShaderPath = std::filesystem::path("Resources") / "hiz_ms.comp";
+        m_depthVertShaderPath = std::filesystem::path("Resources") / "depth.vert";
+        m_debugVertShaderPath = std::filesystem::path("Resources") / "debug.vert";
+        m_debugFragShaderPath = std::filesystem::path("Resources") / "debug.frag";
     }
 }
 
+/// A shader set compiling on a worker against its own compatible render pass.
+struct Vulkan::PendingShaderBuild
+{
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done{false};
+    Result<PipelineShaderSet> result{};
+    std::vector<std::uint32_t> vertSpirv;
+    std::vector<std::uint32_t> fragSpirv;
+};
+
 /// Initialization
 
 Result<> Vulkan::initialize() noexcept
 {
-    if (auto result = m_vulkanDevice.initialize(); !result)
-        return result;
-    if (auto result = m_swapchain.initialize(); !result)
-        return result;
+    NOC_PROFILE_ZONE("Vulkan::initialize");
+
+    // Shaders are loaded according to the selected runtime/shipping policy. The reads (or compiles)
+    // overlap instance, device and swapchain creation on the job system.
+    Result<std::vector<std::uint32_t>> vertResult{};
+    Result<std::vector<std::uint32_t>> fragResult{};
+    tf::Taskflow shaderLoads;
+    shaderLoads.emplace([this, &vertResult]() {
+        vertResult = ShaderCompiler::load_or_compile(m_vertShaderPath, m_shaderLoadMode);
+    });
+    shaderLoads.emplace([this, &fragResult]() {
+        fragResult = ShaderCompiler::load_or_compile(m_fragShaderPath, m_shaderLoadMode);
+    });
+    tf::Future<void> shadersLoaded = JobSystem::get().executor().run(shaderLoads);
 
-    // Compute scene render size and create offscreen resources
-    compute_scene_render_size();
-    if (auto result = create_scene_render_pass(); !result)
-        return result;
-    if (auto result = create_scene_render_target(); !result)
-        return result;
+    const Result<> coreResult = [this]() -> Result<> {
+        if (auto result = m_vulkanDevice.initialize(); !result)
+            return result;
+        if (auto result = m_uploadQueue.initialize(m_vulkanDevice); !result)
+            return result;
+        m_geometryArena.initialize(m_vulkanDevice);
+        if (auto result = m_gpuProfiler.initialize(m_vulkanDevice, MAX_FRAMES_IN_FLIGHT); !result)
+            return result;
+        if (auto result = m_swapchain.initialize(); !result)
+            return result;
 
-    // Load shaders according to the selected runtime/shipping policy.
-    {
-        auto vertResult = ShaderCompiler::load_or_compile(m_vertShaderPath, m_shaderLoadMode);
-        if (!vertResult)
-            return make_error(vertResult.error());
-        m_vertSpirv = std::move(vertResult.value());
+        // Compute scene render size and create offscreen resources
+        compute_scene_render_size();
+        if (auto result = create_scene_render_pass(); !result)
+            return result;
+        return create_scene_render_target();
+    }();
+    shadersLoaded.wait();
+    if (!coreResult)
+        return coreResult;
 
-        auto fragResult = ShaderCompiler::load_or_compile(m_fragShaderPath, m_shaderLoadMode);
-        if (!fragResult)
-            return make_error(fragResult.error());
-        m_fragSpirv = std::move(fragResult.value());
-    }
+    if (!vertResult)
+        return make_error(vertResult.error());
+    m_vertSpirv = std::move(vertResult.value());
+    if (!fragResult)
+        return make_error(fragResult.error());
+    m_fragSpirv = std::move(fragResult.value());
 
     {
-        MultisampleConfig msConfig{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
+        if (const RuntimePaths* runtimePaths = RuntimePaths::try_current())
+            m_pipeline.set_cache_directory(runtimePaths->resolve_user_data("PipelineCache"));
+
+        const MultisampleConfig msConfig = scene_pipeline_config();
         if (auto result = m_pipeline.initialize(m_sceneRenderPass, msConfig, m_vertSpirv, m_fragSpirv); !result)
             return result;
+        prewarm_pipeline_variants();
+        m_shaderReloader.set_sources(m_vertShaderPath, m_fragShaderPath);
     }
 
     if (auto result = create_sampler(); !result)
         return result;
-    if (auto result = create_default_textures(); !result)
+    if (auto result = create_material_descriptors(); !result)
         return result;
-    if (auto result = create_descriptor_pool(); !result)
+    if (auto result = create_default_textures(); !result)
         return result;
     if (auto result = create_default_material(); !result)
         return result;
+    if (auto result = create_instance_descriptor_sets(); !result)
+        return result;
+    if (auto result = create_shadow_resources(); !result)
+        return result;
+    if (auto result = create_light_cluster_resources(); !result)
+        return result;
     if (auto result = create_command_buffers(); !result)
         return result;
     if (auto result = create_sync_objects(); !result)
@@ -100,18 +258,208 @@ Result<> Vulkan::initialize() noexcept
 
 void Vulkan::set_renderables(const std::vector<Renderable>& renderables) noexcept
 {
-    m_renderables = renderables;
-    std::sort(m_renderables.begin(), m_renderables.end(), [](const Renderable& lhs, const Renderable& rhs) {
-        return std::tie(lhs.materialIndex, lhs.meshIndex) < std::tie(rhs.materialIndex, rhs.meshIndex);
+    // Full replacement: every entity missing from `renderables` gives its slot back.
+    ++m_instanceSlotGeneration;
+    const XMMATRIX view = XMLoadFloat4x4(&m_viewMatrix);
+    for (const Renderable& renderable : renderables)
+        write_renderable(renderable, view);
+
+    std::erase_if(m_entityInstanceSlots, [this](const auto& entry) {
+        if (m_instanceSlotGenerations[entry.second] == m_instanceSlotGeneration)
+            return false;
+        retire_renderable_slot(entry.second);
+        return true;
     });
 
-    std::uint32_t totalTriangles = 0;
-    for (const auto& renderable : m_renderables)
+    rebuild_draw_items();
+}
+
+void Vulkan::update_renderables(const RenderableDelta& delta) noexcept
+{
+    if (delta.empty())
+        return;
+
+    for (const std::uint32_t entityId : delta.removedEntityIds)
+    {
+        if (auto it = m_entityInstanceSlots.find(entityId); it != m_entityInstanceSlots.end())
+        {
+            retire_renderable_slot(it->second);
+            m_entityInstanceSlots.erase(it);
+        }
+    }
+
+    const XMMATRIX view = XMLoadFloat4x4(&m_viewMatrix);
+    for (const Renderable& renderable : delta.changed)
+        write_renderable(renderable, view);
+
+    rebuild_draw_items();
+}
+
+void Vulkan::set_lights(std::span<const Light> lights) noexcept
+{
+    // The first directional light is the sun; the rest are binned into clusters. Lights keep their
+    // index while the list order is stable, so only the ones that changed are re-uploaded.
+    bool sunFound = false;
+    m_sunDirection = DefaultSunDirection;
+    m_sunColor = DefaultSunColor;
+    std::size_t lightCount = 0;
+    for (const Light& light : lights)
+    {
+        if (light.type == LightType::Directional)
+        {
+            if (!sunFound)
+            {
+                m_sunDirection = XMFLOAT3{-light.direction.x, -light.direction.y, -light.direction.z};
+                m_sunColor = light.color;
+                sunFound = true;
+            }
+            continue;
+        }
+
+        GpuLight gpuLight{};
+        gpuLight.positionRange = XMFLOAT4{light.position.x, light.position.y, light.position.z, light.range};
+        gpuLight.colorSpotOuter = XMFLOAT4{light.color.x, light.color.y, light.color.z, -2.0f};
+        gpuLight.directionSpotInner = XMFLOAT4{light.direction.x, light.direction.y, light.direction.z, -1.0f};
+        if (light.type == LightType::Spot)
+        {
+            // Keep the falloff band non-empty; smoothstep is undefined for equal edges.
+            gpuLight.colorSpotOuter.w = std::clamp(light.outerConeCos, 0.0f, 0.9999f);
+            gpuLight.directionSpotInner.w = std::clamp(light.innerConeCos, gpuLight.colorSpotOuter.w + 1e-4f, 1.0f);
+        }
+
+        if (lightCount == m_lights.size())
+        {
+            m_lights.push_back(gpuLight);
+            m_lightDirtyFrames.push_back(0);
+            mark_light_dirty(static_cast<std::uint32_t>(lightCount));
+        }
+        else if (std::memcmp(&m_lights[lightCount], &gpuLight, sizeof(GpuLight)) != 0)
+        {
+            m_lights[lightCount] = gpuLight;
+            mark_light_dirty(static_cast<std::uint32_t>(lightCount));
+        }
+        ++lightCount;
+    }
+
+    // Dirty-list entries past the end are skipped on upload.
+    m_lights.resize(lightCount);
+    m_lightDirtyFrames.resize(lightCount);
+}
+
+void Vulkan::mark_light_dirty(std::uint32_t index) noexcept
+{
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        const std::uint8_t frameBit = static_cast<std::uint8_t>(1u << i);
+        if ((m_lightDirtyFrames[index] & frameBit) != 0)
+            continue;
+
+        m_lightDirtyFrames[index] |= frameBit;
+        m_lightFrames[i].dirtyLights.push_back(index);
+    }
+}
+
+void Vulkan::write_renderable(const Renderable& renderable, const XMMATRIX& view)
+{
+    // Persistent slots per entity; only slots whose contents actually changed are marked for upload.
+    auto [it, inserted] = m_entityInstanceSlots.try_emplace(renderable.entityId, 0u);
+    if (inserted)
+        it->second = acquire_instance_slot();
+    const std::uint32_t slot = it->second;
+    const bool wasStatic = m_slotDrawKeys[slot] != DeadSlotDrawKey && m_slotStaticFlags[slot] != 0;
+    const std::uint32_t previousMeshIndex = m_slotMeshIndices[slot];
+    const XMFLOAT4 previousSphere = m_slotSpheres[slot];
+
+    InstanceData data{};
+    data.model = renderable.worldMatrix;
+    data.glow = renderable.glow;
+    data.materialIndex = renderable.materialIndex < m_materials.size() ? renderable.materialIndex
+                                                                        : m_defaultMaterialIndex;
+    const bool instanceChanged = inserted || std::memcmp(&m_instanceSlots[slot], &data, sizeof(InstanceData)) != 0;
+    if (instanceChanged)
+    {
+        m_instanceSlots[slot] = data;
+        mark_instance_slot_dirty(slot);
+    }
+    m_instanceSlotGenerations[slot] = m_instanceSlotGeneration;
+
+    const Mesh* mesh = renderable.meshIndex < m_meshes.size() ? &m_meshes[renderable.meshIndex] : nullptr;
+    if (m_slotDrawKeys[slot] != DeadSlotDrawKey && m_slotMeshIndices[slot] < m_meshes.size())
+        m_totalTriangleCountCached -= m_meshes[m_slotMeshIndices[slot]].indexCount / 3;
+    if (mesh != nullptr)
+        m_totalTriangleCountCached += mesh->indexCount / 3;
+
+    const XMVECTOR position = XMVectorSet(renderable.worldMatrix._14, renderable.worldMatrix._24,
+                                          renderable.worldMatrix._34, 1.0f);
+    const float viewDistance = XMVectorGetX(XMVector3Length(XMVector3TransformCoord(position, view)));
+    m_slotDrawKeys[slot] = DrawKey::make(DrawPass::Opaque, renderable.meshIndex, data.materialIndex,
+                                         DrawKey::depth_bucket(viewDistance));
+    m_slotMeshIndices[slot] = renderable.meshIndex;
+    m_slotStaticFlags[slot] = renderable.isStatic ? 1 : 0;
+
+    // World-space bounding sphere for the CPU culling path.
+    XMFLOAT4& sphere = m_slotSpheres[slot];
+    sphere = {};
+    if (mesh != nullptr)
+    {
+        const XMMATRIX world = XMLoadFloat3x4(&renderable.worldMatrix);
+        const XMVECTOR center = XMVector3TransformCoord(
+            XMVectorSet(mesh->boundsCenter.x, mesh->boundsCenter.y, mesh->boundsCenter.z, 1.0f), world);
+        const XMVECTOR scales = XMVectorMax(
+            XMVector3LengthSq(world.r[0]), XMVectorMax(XMVector3LengthSq(world.r[1]), XMVector3LengthSq(world.r[2])));
+        XMStoreFloat4(&sphere, center);
+        sphere.w = mesh->boundsRadius * std::sqrt(XMVectorGetX(scales));
+    }
+
+    // Cached shadow cascades only see static casters, so only those invalidate them: where one was and where it is.
+    if ((wasStatic || renderable.isStatic) &&
+        (wasStatic != renderable.isStatic || instanceChanged || previousMeshIndex != renderable.meshIndex))
+    {
+        if (wasStatic)
+            note_static_shadow_change(previousSphere);
+        if (renderable.isStatic)
+            note_static_shadow_change(sphere);
+    }
+}
+
+void Vulkan::retire_renderable_slot(std::uint32_t slot) noexcept
+{
+    // The stale instance contents are never referenced again once the key is dead.
+    if (m_slotDrawKeys[slot] != DeadSlotDrawKey && m_slotMeshIndices[slot] < m_meshes.size())
+        m_totalTriangleCountCached -= m_meshes[m_slotMeshIndices[slot]].indexCount / 3;
+    if (m_slotDrawKeys[slot] != DeadSlotDrawKey && m_slotStaticFlags[slot] != 0)
+        note_static_shadow_change(m_slotSpheres[slot]);
+    m_slotDrawKeys[slot] = DeadSlotDrawKey;
+    m_slotSpheres[slot] = {};
+    m_freeInstanceSlots.push_back(slot);
+}
+
+void Vulkan::rebuild_draw_items()
+{
+    // Keys are per slot, so unchanged slots keep their keys and the sorter stays incremental.
+    m_drawKeySorter.sort(m_slotDrawKeys);
+    m_drawItemsScratch.clear();
+    m_cullSpheresScratch.clear();
+    m_cullStaticFlagsScratch.clear();
+    for (const std::uint32_t slot : m_drawKeySorter.get_order())
     {
-        if (renderable.meshIndex < m_meshes.size())
-            totalTriangles += m_meshes[renderable.meshIndex].indexCount / 3;
+        if (m_slotDrawKeys[slot] == DeadSlotDrawKey)
+            break; // free slots sort last
+        m_drawItemsScratch.push_back(DrawItem{m_slotMeshIndices[slot], slot});
+        m_cullSpheresScratch.push_back(m_slotSpheres[slot]);
+        m_cullStaticFlagsScratch.push_back(m_slotStaticFlags[slot]);
     }
-    m_totalTriangleCountCached = totalTriangles;
+    m_frustumCuller.set_spheres(m_cullSpheresScratch, m_cullStaticFlagsScratch);
+
+    // The GPU cull inputs only depend on which slot draws with which mesh, in which order.
+    const bool layoutChanged =
+        m_drawItemsScratch.size() != m_drawItems.size() ||
+        (!m_drawItems.empty() &&
+         std::memcmp(m_drawItemsScratch.data(), m_drawItems.data(), sizeof(DrawItem) * m_drawItems.size()) != 0);
+    std::swap(m_drawItems, m_drawItemsScratch);
+    if (layoutChanged)
+        m_gpuCullInputsDirty = true;
+    m_gpuCullOrderDirty = true; // spheres may have moved even when the layout did not
 }
 
 MeshBounds Vulkan::get_mesh_bounds(std::uint32_t meshIndex) const noexcept
@@ -131,10 +479,13 @@ MeshBounds Vulkan::get_mesh_bounds(std::uint32_t meshIndex) const noexcept
 
 Result<> Vulkan::draw_frame() noexcept
 {
+    NOC_PROFILE_ZONE("Vulkan::draw_frame");
     VkDevice device = m_vulkanDevice.get_device();
 
     vkWaitForFences(device, 1, &m_inFlightFences[m_currentFrame], true, UINT64_MAX);
 
+    update_shader_reload();
+
     if (m_framebufferResized)
     {
         m_framebufferResized = false;
@@ -154,23 +505,30 @@ Result<> Vulkan::draw_frame() noexcept
         return {};
     }
 
-    std::uint32_t imageIndex{};
-    VkResult result = vkAcquireNextImageKHR(
-        device,
-        m_swapchain.get_swapchain(),
-        std::numeric_limits<uint64_t>::max(),
-        m_imageAvailableSemaphores[m_currentFrame],
-        nullptr,
-        &imageIndex
-    );
+    // Frames whose caller did not go through wait_for_next_frame() carry no latency sample.
+    const std::chrono::steady_clock::time_point inputTime = std::exchange(m_nextFrameInputTime, {});
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    std::uint32_t imageIndex{NoSwapchainImage};
+    VkResult result = VK_SUCCESS;
+    if (m_presentationEnabled)
     {
-        return recreate_swap_chain();
-    }
-    else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
-    {
-        return make_error("Failed to acquire swap chain image", ErrorCode::VulkanDrawFrameFailed);
+        result = vkAcquireNextImageKHR(
+            device,
+            m_swapchain.get_swapchain(),
+            std::numeric_limits<uint64_t>::max(),
+            m_imageAvailableSemaphores[m_currentFrame],
+            nullptr,
+            &imageIndex
+        );
+
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            return recreate_swap_chain();
+        }
+        else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+        {
+            return make_error("Failed to acquire swap chain image", ErrorCode::VulkanDrawFrameFailed);
+        }
     }
 
     if (vkResetFences(device, 1, &m_inFlightFences[m_currentFrame]) != VK_SUCCESS)
@@ -183,6 +541,24 @@ Result<> Vulkan::draw_frame() noexcept
         return make_error("Failed to reset command buffer", ErrorCode::VulkanDrawFrameFailed);
     }
 
+    // Uploads queued since the last frame must be submitted ahead of the frame that may sample them.
+    // Same-queue batches are ordered by their own barriers; a dedicated transfer queue needs a CPU wait.
+    // Batches submitted earlier (texture streams) are not waited on again; their images go live on their own.
+    if (m_uploadQueue.has_pending_work())
+    {
+        const UploadTicket submittedBefore = m_uploadQueue.get_last_submitted_ticket();
+        auto flushResult = m_uploadQueue.flush();
+        if (!flushResult)
+            return make_error(flushResult.error());
+        if (m_vulkanDevice.has_dedicated_transfer_queue() && flushResult.value() != submittedBefore)
+        {
+            if (auto waitResult = m_uploadQueue.wait(flushResult.value()); !waitResult)
+                return waitResult;
+        }
+    }
+
+    update_texture_streaming();
+
     auto recordResult = record_command_buffer(m_commandBuffers[m_currentFrame], imageIndex);
     if (!recordResult)
         return make_error(recordResult.error());
@@ -190,17 +566,19 @@ Result<> Vulkan::draw_frame() noexcept
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
+    // Offscreen frames have no swapchain image to wait for or hand over to presentation.
+    const bool presenting = imageIndex != NoSwapchainImage;
     VkSemaphore waitSemaphores[]{m_imageAvailableSemaphores[m_currentFrame]};
     VkPipelineStageFlags waitStages[]{VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.waitSemaphoreCount = presenting ? 1u : 0u;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
 
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &m_commandBuffers[m_currentFrame];
 
-    VkSemaphore signalSemaphores[]{m_renderFinishedSemaphores[imageIndex]};
-    submitInfo.signalSemaphoreCount = 1;
+    VkSemaphore signalSemaphores[]{presenting ? m_renderFinishedSemaphores[imageIndex] : VK_NULL_HANDLE};
+    submitInfo.signalSemaphoreCount = presenting ? 1u : 0u;
     submitInfo.pSignalSemaphores = signalSemaphores;
 
     const VkResult submitResult = vkQueueSubmit(
@@ -220,6 +598,15 @@ Result<> Vulkan::draw_frame() noexcept
         return make_error("Failed to submit draw command buffer", ErrorCode::VulkanDrawFrameFailed);
     }
 
+    m_frameInputTimes[m_currentFrame] = inputTime;
+    m_framePresentIds[m_currentFrame] = 0;
+    if (!presenting)
+    {
+        m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        ++m_frameNumber;
+        return {};
+    }
+
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
@@ -231,6 +618,19 @@ Result<> Vulkan::draw_frame() noexcept
     presentInfo.pSwapchains = swapChains;
     presentInfo.pImageIndices = &imageIndex;
 
+    // Tagged so wait_for_next_frame() can wait for this frame to reach the display.
+    VkPresentIdKHR presentIdInfo{};
+    const std::uint64_t presentId = m_lastPresentId + 1;
+    if (m_vulkanDevice.get_wait_for_present() != nullptr)
+    {
+        presentIdInfo.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentIdInfo.swapchainCount = 1;
+        presentIdInfo.pPresentIds = &presentId;
+        presentInfo.pNext = &presentIdInfo;
+        m_lastPresentId = presentId;
+        m_framePresentIds[m_currentFrame] = presentId;
+    }
+
     result = vkQueuePresentKHR(m_vulkanDevice.get_present_queue(), &presentInfo);
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_framebufferResized)
@@ -244,6 +644,7 @@ Result<> Vulkan::draw_frame() noexcept
     }
 
     m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    ++m_frameNumber;
 
     return {};
 }
@@ -251,29 +652,97 @@ Result<> Vulkan::draw_frame() noexcept
 void Vulkan::wait_idle() noexcept
 {
     VkDevice device = m_vulkanDevice.get_device();
-    if (device)
-        vkDeviceWaitIdle(device);
+    if (!device)
+        return;
+
+    if (auto result = m_uploadQueue.wait_idle(); !result)
+        fmt::print("Warning: Failed to drain upload queue: {}\n", result.error().message);
+    vkDeviceWaitIdle(device);
+}
+
+void Vulkan::wait_for_next_frame() noexcept
+{
+    NOC_PROFILE_ZONE("Vulkan::wait_for_next_frame");
+    VkDevice device = m_vulkanDevice.get_device();
+    if (!device || m_inFlightFences.empty())
+        return;
+    const auto waitBegin = std::chrono::steady_clock::now();
+
+    // Once the frame that last used this slot is on screen, at most the one after it is still queued,
+    // however many images the swapchain has; FIFO would otherwise let presents pile up behind vblank.
+    bool presented = false;
+    const std::uint64_t presentId = m_framePresentIds[m_currentFrame];
+    if (const PFN_vkWaitForPresentKHR waitForPresent = m_vulkanDevice.get_wait_for_present();
+        waitForPresent != nullptr && presentId != 0)
+    {
+        presented = waitForPresent(device, m_swapchain.get_swapchain(), presentId, PresentWaitTimeoutNs) == VK_SUCCESS;
+    }
+    vkWaitForFences(device, 1, &m_inFlightFences[m_currentFrame], true, UINT64_MAX);
+
+    const auto waitEnd = std::chrono::steady_clock::now();
+    m_frameLatencyStats.waitMs = std::chrono::duration<float, std::milli>(waitEnd - waitBegin).count();
+    if (const auto inputTime = std::exchange(m_frameInputTimes[m_currentFrame], {}); inputTime != std::chrono::steady_clock::time_point{})
+    {
+        // The frame may have finished before this wait started, so the sample is an upper bound.
+        const float sampleMs = std::chrono::duration<float, std::milli>(waitEnd - inputTime).count();
+        float& smoothed = m_frameLatencyStats.inputToPresentMs;
+        smoothed = smoothed > 0.0f ? smoothed + (sampleMs - smoothed) * 0.1f : sampleMs;
+        m_frameLatencyStats.presentWait = presented;
+    }
+    m_nextFrameInputTime = waitEnd;
+}
+
+Result<UploadTicket> Vulkan::flush_uploads()
+{
+    return m_uploadQueue.flush();
+}
+
+Result<> Vulkan::wait_for_uploads(UploadTicket ticket)
+{
+    return m_uploadQueue.wait(ticket);
+}
+
+bool Vulkan::is_upload_complete(UploadTicket ticket) noexcept
+{
+    return m_uploadQueue.is_complete(ticket);
 }
 
 Result<> Vulkan::clear_scene_content() noexcept
 {
     wait_idle();
 
-    m_renderables.clear();
+    m_drawItems.clear();
+    m_drawKeySorter.clear();
+    m_frustumCuller.clear();
     m_totalTriangleCountCached = 0;
     m_lastVisibleRenderableCount = 0;
     m_lastCulledRenderableCount = 0;
+    m_lastOccludedRenderableCount = 0;
     m_lastDrawCallCount = 0;
     m_lastInstancedBatchCount = 0;
-
+    m_gpuCullInputsDirty = true;
+    for (auto& frame : m_gpuCullFrames)
+        frame.statsPending = false;
+
+    // The old scene's depth must not hide the first frame of the new one, nor its casters shade it.
+    m_hiZValid = false;
+    m_occlusionCuller.clear();
+    for (auto& readback : m_hiZReadbacks)
+        readback.pending = false;
+    invalidate_shadow_cascades();
+    m_shadowStaticChanges.clear();
+    reset_instance_slots();
+
+    // The bindless sets and material buffer stay; their elements are simply rewritten as assets upload again.
     destroy_meshes();
     destroy_textures();
-    destroy_material_pool();
+    m_materials.clear();
+    m_materialLookup.clear();
+    m_materialScreenPixels.clear();
+    m_defaultMaterialIndex = 0;
 
     if (auto result = create_default_textures(); !result)
         return result;
-    if (auto result = create_descriptor_pool(); !result)
-        return result;
     if (auto result = create_default_material(); !result)
         return result;
 
@@ -286,20 +755,10 @@ void Vulkan::destroy_meshes() noexcept
     if (!device)
         return;
 
-    for (auto& mesh : m_meshes)
-    {
-        if (mesh.indexBuffer != nullptr)
-            vkDestroyBuffer(device, mesh.indexBuffer, nullptr);
-        if (mesh.indexBufferMemory != nullptr)
-            vkFreeMemory(device, mesh.indexBufferMemory, nullptr);
-        if (mesh.vertexBuffer != nullptr)
-            vkDestroyBuffer(device, mesh.vertexBuffer, nullptr);
-        if (mesh.vertexBufferMemory != nullptr)
-            vkFreeMemory(device, mesh.vertexBufferMemory, nullptr);
-    }
+    // Every range goes back at once; the first arena page stays for the next scene.
+    m_geometryArena.reset();
     m_meshes.clear();
     m_meshLookup.clear();
-    m_meshMemoryBytes = 0;
 }
 
 void Vulkan::destroy_textures() noexcept
@@ -308,24 +767,26 @@ void Vulkan::destroy_textures() noexcept
     if (!device)
         return;
 
-    for (auto& tex : m_textures)
+    for (StreamedTexture& streamed : m_streamedTextures)
     {
-        if (tex.imageView != nullptr)
-            vkDestroyImageView(device, tex.imageView, nullptr);
-        if (tex.image != nullptr)
-            vkDestroyImage(device, tex.image, nullptr);
-        if (tex.memory != nullptr)
-            vkFreeMemory(device, tex.memory, nullptr);
+        destroy_texture_image(streamed.incoming);
+        destroy_texture_image(streamed.outgoing);
     }
+    for (GpuTexture& texture : m_textures)
+        destroy_texture_image(texture);
 
     m_textures.clear();
     m_textureLookup.clear();
+    m_streamedTextures.clear();
+    m_textureStreamsInFlight = 0;
+    m_textureStreamingMissingMips = 0;
     m_textureMemoryBytes = 0;
     m_defaultAlbedoTextureIndex = 0;
     m_defaultNormalTextureIndex = 0;
+    m_defaultOrmTextureIndex = 0;
 }
 
-void Vulkan::destroy_material_pool() noexcept
+void Vulkan::destroy_material_descriptors() noexcept
 {
     VkDevice device = m_vulkanDevice.get_device();
     if (!device)
@@ -335,6 +796,22 @@ void Vulkan::destroy_material_pool() noexcept
     {
         vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
         m_descriptorPool = nullptr;
+        m_materialDescriptorSets.fill(nullptr); // freed with pool
+    }
+    if (m_materialMapped != nullptr && m_materialMemory != nullptr)
+    {
+        vkUnmapMemory(device, m_materialMemory);
+        m_materialMapped = nullptr;
+    }
+    if (m_materialBuffer != nullptr)
+    {
+        vkDestroyBuffer(device, m_materialBuffer, nullptr);
+        m_materialBuffer = nullptr;
+    }
+    if (m_materialMemory != nullptr)
+    {
+        vkFreeMemory(device, m_materialMemory, nullptr);
+        m_materialMemory = nullptr;
     }
     m_materials.clear();
     m_materialLookup.clear();
@@ -349,8 +826,9 @@ void Vulkan::cleanup() noexcept
         vkDeviceWaitIdle(device);
 
     destroy_meshes();
+    m_geometryArena.cleanup();
     destroy_textures();
-    destroy_material_pool();
+    destroy_material_descriptors();
 
     // Destroy sampler
     if (m_sampler != nullptr)
@@ -361,27 +839,19 @@ void Vulkan::cleanup() noexcept
 
     for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
     {
-        if (m_instanceBufferMappings[i] != nullptr && m_instanceBufferMemories[i] != nullptr)
-        {
-            vkUnmapMemory(device, m_instanceBufferMemories[i]);
-            m_instanceBufferMappings[i] = nullptr;
-        }
-        if (m_instanceBuffers[i] != nullptr)
-        {
-            vkDestroyBuffer(device, m_instanceBuffers[i], nullptr);
-            m_instanceBuffers[i] = nullptr;
-        }
-        if (m_instanceBufferMemories[i] != nullptr)
-        {
-            vkFreeMemory(device, m_instanceBufferMemories[i], nullptr);
-            m_instanceBufferMemories[i] = nullptr;
-        }
-        m_instanceBufferAllocatedBytes[i] = 0;
+        cleanup_instance_frame(i);
+        m_instanceFrames[i].descriptorSet = nullptr; // freed with pool
+    }
+    if (m_instanceDescriptorPool != nullptr)
+    {
+        vkDestroyDescriptorPool(device, m_instanceDescriptorPool, nullptr);
+        m_instanceDescriptorPool = nullptr;
     }
-    m_instanceBufferCapacity = 0;
     m_instanceBufferMemoryBytes = 0;
+    reset_instance_slots();
 
-    cleanup_upload_staging_buffer();
+    m_uploadQueue.cleanup();
+    m_gpuProfiler.cleanup();
 
     // Destroy sync objects
     for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
@@ -408,13 +878,28 @@ void Vulkan::cleanup() noexcept
                              m_commandBuffers.data());
         m_commandBuffers.clear();
     }
+    cleanup_scene_record_chunks();
 
     // Destroy offscreen resources
+    cleanup_light_cluster_resources();
+    cleanup_shadow_resources();
+    cleanup_gpu_cull_resources();
+    cleanup_hiz_resources();
     cleanup_nis_resources();
     cleanup_scene_render_target();
     cleanup_scene_render_pass();
 
+    // Background reload jobs reference the pipeline; finish them before it goes.
+    m_shaderReloader.wait();
+    wait_for_shader_build();
+    if (m_pendingShaderBuild && m_pendingShaderBuild->result)
+        m_pipeline.destroy_shader_set(m_pendingShaderBuild->result.value());
+    m_pendingShaderBuild.reset();
+    destroy_retired_shader_sets(true);
+
     // Sub-components clean up
+    cleanup_depth_prepass_pipeline();
+    cleanup_debug_draw_resources(true);
     m_pipeline.cleanup();
     m_pipeline.release_cache();
     m_swapchain.cleanup();
@@ -442,171 +927,323 @@ Result<> Vulkan::create_command_buffers()
     return {};
 }
 
-Result<> Vulkan::ensure_upload_staging_capacity(VkDeviceSize requiredSize)
+std::uint32_t Vulkan::scene_record_chunk_count(std::size_t batchCount) const noexcept
 {
-    if (requiredSize <= m_uploadStagingCapacity && m_uploadStagingBuffer != nullptr && m_uploadStagingMapped)
-        return {};
+    if (!m_parallelRecordingEnabled || m_taskExecutor == nullptr)
+        return 1;
+    const std::size_t workers = std::max<std::size_t>(m_taskExecutor->num_workers(), 1);
+    const std::size_t chunks = std::min({workers, batchCount / MinBatchesPerRecordChunk, MaxSceneRecordChunks});
+    return static_cast<std::uint32_t>(std::max<std::size_t>(chunks, 1));
+}
 
+Result<> Vulkan::ensure_scene_record_chunks(std::size_t frameIndex, std::size_t chunkCount)
+{
     VkDevice device = m_vulkanDevice.get_device();
-
-    // Grow geometrically to avoid frequent reallocations.
-    VkDeviceSize newCapacity = std::max<VkDeviceSize>(requiredSize, 1024 * 1024);
-    if (m_uploadStagingCapacity > 0)
+    std::vector<SceneRecordChunk>& chunks = m_sceneRecordChunks[frameIndex];
+    while (chunks.size() < chunkCount)
     {
-        while (newCapacity < requiredSize)
-            newCapacity *= 2;
+        SceneRecordChunk chunk{};
+
+        // Transient: the pool is reset as a whole every time its frame slot comes around.
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = m_vulkanDevice.get_graphics_queue_family_index();
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &chunk.commandPool) != VK_SUCCESS)
+            return make_error("Failed to create scene recording command pool", ErrorCode::VulkanCommandPoolCreationFailed);
+
+        std::array<VkCommandBuffer, 2> commandBuffers{};
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = chunk.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = static_cast<std::uint32_t>(commandBuffers.size());
+        if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS)
+        {
+            vkDestroyCommandPool(device, chunk.commandPool, nullptr);
+            return make_error("Failed to allocate scene secondary command buffers",
+                              ErrorCode::VulkanCommandBufferAllocationFailed);
+        }
+        chunk.prepassCommandBuffer = commandBuffers[0];
+        chunk.colorCommandBuffer = commandBuffers[1];
+        chunks.push_back(chunk);
+    }
+    return {};
+}
 
-        newCapacity = std::max(newCapacity, m_uploadStagingCapacity * 2);
+void Vulkan::cleanup_scene_record_chunks() noexcept
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    for (std::vector<SceneRecordChunk>& chunks : m_sceneRecordChunks)
+    {
+        // Destroying a pool frees its command buffers.
+        for (SceneRecordChunk& chunk : chunks)
+        {
+            if (device && chunk.commandPool != nullptr)
+                vkDestroyCommandPool(device, chunk.commandPool, nullptr);
+        }
+        chunks.clear();
     }
+}
+
+Result<> Vulkan::create_instance_descriptor_sets()
+{
+    VkDevice device = m_vulkanDevice.get_device();
 
-    cleanup_upload_staging_buffer();
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_FRAMES_IN_FLIGHT};
 
-    VkDeviceSize allocatedBytes{};
-    auto createResult = m_vulkanDevice.create_buffer(
-        newCapacity,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        m_uploadStagingBuffer,
-        m_uploadStagingBufferMemory,
-        &allocatedBytes
-    );
-    if (!createResult)
-        return make_error(createResult.error());
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_instanceDescriptorPool) != VK_SUCCESS)
+        return make_error("Failed to create instance descriptor pool", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    // Set layouts are only required to be compatible, so these sets survive pipeline rebuilds.
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> setLayouts{};
+    setLayouts.fill(m_pipeline.get_instance_descriptor_set_layout());
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> sets{};
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_instanceDescriptorPool;
+    allocInfo.descriptorSetCount = static_cast<std::uint32_t>(setLayouts.size());
+    allocInfo.pSetLayouts = setLayouts.data();
+    if (vkAllocateDescriptorSets(device, &allocInfo, sets.data()) != VK_SUCCESS)
+        return make_error("Failed to allocate instance descriptor sets", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+        m_instanceFrames[i].descriptorSet = sets[i];
 
-    if (vkMapMemory(device, m_uploadStagingBufferMemory, 0, newCapacity, 0, &m_uploadStagingMapped) != VK_SUCCESS)
+    // Allocate a minimal slot buffer up front so set 1 is always valid, even for an empty scene.
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
     {
-        cleanup_upload_staging_buffer();
-        return make_error("Failed to map upload staging buffer memory", ErrorCode::VulkanMemoryAllocationFailed);
+        if (auto result = ensure_instance_frame_capacity(i, 1, 1); !result)
+            return result;
     }
 
-    m_uploadStagingCapacity = newCapacity;
-    m_uploadStagingMemoryBytes = static_cast<std::uint64_t>(allocatedBytes);
     return {};
 }
 
-void Vulkan::cleanup_upload_staging_buffer() noexcept
+void Vulkan::cleanup_instance_frame(std::size_t frameIndex) noexcept
 {
     VkDevice device = m_vulkanDevice.get_device();
-    if (!device)
-    {
-        m_uploadStagingBuffer = nullptr;
-        m_uploadStagingBufferMemory = nullptr;
-        m_uploadStagingMapped = nullptr;
-        m_uploadStagingCapacity = 0;
-        m_uploadStagingMemoryBytes = 0;
-        return;
-    }
-
-    if (m_uploadStagingMapped != nullptr && m_uploadStagingBufferMemory != nullptr)
-    {
-        vkUnmapMemory(device, m_uploadStagingBufferMemory);
-        m_uploadStagingMapped = nullptr;
-    }
-    if (m_uploadStagingBuffer != nullptr)
-    {
-        vkDestroyBuffer(device, m_uploadStagingBuffer, nullptr);
-        m_uploadStagingBuffer = nullptr;
-    }
-    if (m_uploadStagingBufferMemory != nullptr)
+    InstanceFrame& frame = m_instanceFrames[frameIndex];
+    if (device)
     {
-        vkFreeMemory(device, m_uploadStagingBufferMemory, nullptr);
-        m_uploadStagingBufferMemory = nullptr;
+        auto destroy = [device](VkBuffer& buffer, VkDeviceMemory& memory, void*& mapped) {
+            if (mapped != nullptr && memory != nullptr)
+            { vkUnmapMemory(device, memory); mapped = nullptr; }
+            if (buffer != nullptr)
+            { vkDestroyBuffer(device, buffer, nullptr); buffer = nullptr; }
+            if (memory != nullptr)
+            { vkFreeMemory(device, memory, nullptr); memory = nullptr; }
+        };
+        destroy(frame.slotBuffer, frame.slotMemory, frame.slotMapped);
+        destroy(frame.visibleBuffer, frame.visibleMemory, frame.visibleMapped);
     }
 
-    m_uploadStagingCapacity = 0;
-    m_uploadStagingMemoryBytes = 0;
+    const std::uint64_t frameBytes = frame.slotAllocatedBytes + frame.visibleAllocatedBytes;
+    m_instanceBufferMemoryBytes -= std::min<std::uint64_t>(m_instanceBufferMemoryBytes, frameBytes);
+    frame.slotAllocatedBytes = 0;
+    frame.visibleAllocatedBytes = 0;
+    frame.slotCapacity = 0;
+    frame.visibleCapacity = 0;
 }
 
-Result<> Vulkan::ensure_instance_buffer_capacity(std::size_t requiredInstances)
+Result<> Vulkan::ensure_instance_frame_capacity(std::size_t frameIndex, std::size_t slotCount, std::size_t visibleCount)
 {
-    if (requiredInstances <= m_instanceBufferCapacity)
-        return {};
-
-    std::size_t newCapacity = std::max<std::size_t>(requiredInstances, 256);
-    if (m_instanceBufferCapacity > 0)
-        newCapacity = std::max(newCapacity, m_instanceBufferCapacity * 2);
-
-    VkDeviceSize bufferSize = static_cast<VkDeviceSize>(sizeof(InstanceData) * newCapacity);
-    std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> newBuffers{};
-    std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> newMemories{};
-    std::array<void*, MAX_FRAMES_IN_FLIGHT> newMappings{};
-    std::array<VkDeviceSize, MAX_FRAMES_IN_FLIGHT> newAllocatedBytes{};
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
-    {
-        auto result = m_vulkanDevice.create_buffer(
-            bufferSize,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            newBuffers[i],
-            newMemories[i],
-            &newAllocatedBytes[i]
-        );
-        if (!result)
-        {
-            VkDevice device = m_vulkanDevice.get_device();
-            for (size_t j = 0; j <= i; ++j)
-            {
-                if (newMappings[j] != nullptr && newMemories[j] != nullptr)
-                    vkUnmapMemory(device, newMemories[j]);
-                if (newBuffers[j] != nullptr)
-                    vkDestroyBuffer(device, newBuffers[j], nullptr);
-                if (newMemories[j] != nullptr)
-                    vkFreeMemory(device, newMemories[j], nullptr);
-            }
+    InstanceFrame& frame = m_instanceFrames[frameIndex];
+    VkDevice device = m_vulkanDevice.get_device();
+    constexpr VkMemoryPropertyFlags hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    // Creates a mapped host-visible buffer, releasing the previous one only once the new one exists.
+    auto grow = [&](std::size_t& capacity, std::size_t required, std::size_t minimum, VkDeviceSize elementSize,
+                    VkBufferUsageFlags usage, VkBuffer& buffer, VkDeviceMemory& memory, void*& mapped,
+                    VkDeviceSize& allocatedBytes) -> Result<bool> {
+        if (required <= capacity && buffer != nullptr)
+            return false;
+
+        // Grow geometrically to avoid frequent reallocations.
+        std::size_t newCapacity = std::max(required, minimum);
+        if (capacity > 0)
+            newCapacity = std::max(newCapacity, capacity * 2);
+
+        const VkDeviceSize bufferSize = elementSize * newCapacity;
+        VkBuffer newBuffer{};
+        VkDeviceMemory newMemory{};
+        VkDeviceSize newAllocatedBytes{};
+        if (auto result = m_vulkanDevice.create_buffer(bufferSize, usage, hostVisible, newBuffer, newMemory, &newAllocatedBytes);
+            !result)
             return make_error(result.error());
-        }
 
-        if (vkMapMemory(m_vulkanDevice.get_device(), newMemories[i], 0, bufferSize, 0, &newMappings[i]) != VK_SUCCESS)
+        void* newMapped{};
+        if (vkMapMemory(device, newMemory, 0, bufferSize, 0, &newMapped) != VK_SUCCESS)
         {
-            VkDevice device = m_vulkanDevice.get_device();
-            for (std::size_t j = 0; j <= i; ++j)
-            {
-                if (newMappings[j] != nullptr && newMemories[j] != nullptr)
-                    vkUnmapMemory(device, newMemories[j]);
-                if (newBuffers[j] != nullptr)
-                    vkDestroyBuffer(device, newBuffers[j], nullptr);
-                if (newMemories[j] != nullptr)
-                    vkFreeMemory(device, newMemories[j], nullptr);
-            }
+            vkDestroyBuffer(device, newBuffer, nullptr);
+            vkFreeMemory(device, newMemory, nullptr);
             return make_error("Failed to map instance buffer memory", ErrorCode::VulkanMemoryAllocationFailed);
         }
-    }
 
-    VkDevice device = m_vulkanDevice.get_device();
-    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+        if (mapped != nullptr && memory != nullptr)
+            vkUnmapMemory(device, memory);
+        if (buffer != nullptr)
+            vkDestroyBuffer(device, buffer, nullptr);
+        if (memory != nullptr)
+            vkFreeMemory(device, memory, nullptr);
+
+        m_instanceBufferMemoryBytes -= std::min<std::uint64_t>(m_instanceBufferMemoryBytes, allocatedBytes);
+        m_instanceBufferMemoryBytes += newAllocatedBytes;
+
+        buffer = newBuffer;
+        memory = newMemory;
+        mapped = newMapped;
+        allocatedBytes = newAllocatedBytes;
+        capacity = newCapacity;
+        return true;
+    };
+
+    auto slotGrowResult = grow(frame.slotCapacity, slotCount, 256, sizeof(InstanceData),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, frame.slotBuffer, frame.slotMemory, frame.slotMapped,
+                               frame.slotAllocatedBytes);
+    if (!slotGrowResult)
+        return make_error(slotGrowResult.error());
+
+    if (slotGrowResult.value())
     {
-        if (m_instanceBufferMappings[i] != nullptr && m_instanceBufferMemories[i] != nullptr)
-            vkUnmapMemory(device, m_instanceBufferMemories[i]);
-        if (m_instanceBuffers[i] != nullptr)
-            vkDestroyBuffer(device, m_instanceBuffers[i], nullptr);
-        if (m_instanceBufferMemories[i] != nullptr)
-            vkFreeMemory(device, m_instanceBufferMemories[i], nullptr);
-        m_instanceBuffers[i] = newBuffers[i];
-        m_instanceBufferMemories[i] = newMemories[i];
-        m_instanceBufferMappings[i] = newMappings[i];
-        m_instanceBufferAllocatedBytes[i] = newAllocatedBytes[i];
+        // A fresh slot buffer has no history: upload every live slot and drop this frame's dirty list.
+        if (!m_instanceSlots.empty())
+            std::memcpy(frame.slotMapped, m_instanceSlots.data(), sizeof(InstanceData) * m_instanceSlots.size());
+        const std::uint8_t frameBit = static_cast<std::uint8_t>(1u << frameIndex);
+        for (std::uint32_t slot : frame.dirtySlots)
+            m_instanceSlotDirtyFrames[slot] &= static_cast<std::uint8_t>(~frameBit);
+        frame.dirtySlots.clear();
+        m_lastInstanceUploadBytes += sizeof(InstanceData) * m_instanceSlots.size();
+
+        VkDescriptorBufferInfo bufferInfo{frame.slotBuffer, 0, VK_WHOLE_SIZE};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = frame.descriptorSet;
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfo;
+        vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
     }
 
-    m_instanceBufferCapacity = newCapacity;
-    m_instanceBufferMemoryBytes = 0;
-    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
-        m_instanceBufferMemoryBytes += static_cast<std::uint64_t>(m_instanceBufferAllocatedBytes[i]);
+    auto visibleGrowResult = grow(frame.visibleCapacity, visibleCount, 256, sizeof(std::uint32_t),
+                                  VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, frame.visibleBuffer, frame.visibleMemory,
+                                  frame.visibleMapped, frame.visibleAllocatedBytes);
+    if (!visibleGrowResult)
+        return make_error(visibleGrowResult.error());
+
     return {};
 }
 
-Result<> Vulkan::record_command_buffer(VkCommandBuffer commandBuffer, std::uint32_t imageIndex) noexcept
+Result<> Vulkan::upload_dirty_instance_slots(std::size_t frameIndex)
 {
-    VkDevice device = m_vulkanDevice.get_device();
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    InstanceFrame& frame = m_instanceFrames[frameIndex];
+    m_lastInstanceUploadBytes = 0;
 
-    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    if (auto result = ensure_instance_frame_capacity(frameIndex, m_instanceSlots.size(), m_drawItems.size()); !result)
+        return result;
+    if (frame.dirtySlots.empty())
+        return {};
+
+    if (frame.slotMapped == nullptr)
+        return make_error("Instance buffer is not mapped", ErrorCode::VulkanMemoryAllocationFailed);
+
+    // Coalesce adjacent dirty slots so a moving group of entities becomes a few contiguous copies.
+    std::sort(frame.dirtySlots.begin(), frame.dirtySlots.end());
+    auto* mapped = static_cast<InstanceData*>(frame.slotMapped);
+    const std::uint8_t frameBit = static_cast<std::uint8_t>(1u << frameIndex);
+    for (std::size_t begin = 0; begin < frame.dirtySlots.size();)
     {
-        return make_error("Failed to begin recording command buffer", ErrorCode::VulkanCommandBufferRecordingFailed);
+        std::size_t end = begin + 1;
+        while (end < frame.dirtySlots.size() && frame.dirtySlots[end] == frame.dirtySlots[end - 1] + 1)
+            ++end;
+
+        const std::uint32_t firstSlot = frame.dirtySlots[begin];
+        const std::size_t slotCount = end - begin;
+        std::memcpy(mapped + firstSlot, m_instanceSlots.data() + firstSlot, sizeof(InstanceData) * slotCount);
+        m_lastInstanceUploadBytes += sizeof(InstanceData) * slotCount;
+        begin = end;
     }
 
-    // Scene render pass (offscreen)
+    for (std::uint32_t slot : frame.dirtySlots)
+        m_instanceSlotDirtyFrames[slot] &= static_cast<std::uint8_t>(~frameBit);
+    frame.dirtySlots.clear();
+    return {};
+}
+
+std::uint32_t Vulkan::acquire_instance_slot()
+{
+    if (!m_freeInstanceSlots.empty())
+    {
+        const std::uint32_t slot = m_freeInstanceSlots.back();
+        m_freeInstanceSlots.pop_back();
+        return slot;
+    }
+
+    const auto slot = static_cast<std::uint32_t>(m_instanceSlots.size());
+    m_instanceSlots.emplace_back();
+    m_instanceSlotGenerations.push_back(0);
+    m_instanceSlotDirtyFrames.push_back(0);
+    m_slotDrawKeys.push_back(DeadSlotDrawKey);
+    m_slotMeshIndices.push_back(0);
+    m_slotSpheres.emplace_back();
+    m_slotStaticFlags.push_back(0);
+    return slot;
+}
+
+void Vulkan::mark_instance_slot_dirty(std::uint32_t slot) noexcept
+{
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        const std::uint8_t frameBit = static_cast<std::uint8_t>(1u << i);
+        if ((m_instanceSlotDirtyFrames[slot] & frameBit) != 0)
+            continue;
+
+        m_instanceSlotDirtyFrames[slot] |= frameBit;
+        m_instanceFrames[i].dirtySlots.push_back(slot);
+    }
+}
+
+void Vulkan::reset_instance_slots() noexcept
+{
+    m_instanceSlots.clear();
+    m_instanceSlotGenerations.clear();
+    m_instanceSlotDirtyFrames.clear();
+    m_freeInstanceSlots.clear();
+    m_entityInstanceSlots.clear();
+    m_slotDrawKeys.clear();
+    m_slotMeshIndices.clear();
+    m_slotSpheres.clear();
+    m_slotStaticFlags.clear();
+    for (auto& frame : m_instanceFrames)
+        frame.dirtySlots.clear();
+    m_lastInstanceUploadBytes = 0;
+}
+
+Result<> Vulkan::record_command_buffer(VkCommandBuffer commandBuffer, std::uint32_t imageIndex) noexcept
+{
+    NOC_PROFILE_ZONE("Vulkan::record_command_buffer");
+    VkDevice device = m_vulkanDevice.get_device();
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        return make_error("Failed to begin recording command buffer", ErrorCode::VulkanCommandBufferRecordingFailed);
+    }
+
+    // This slot's fence has signalled, so its previous timings can be read without waiting.
+    m_gpuProfiler.begin_frame(commandBuffer, m_currentFrame);
+    update_dynamic_resolution();
+
+    // Scene render pass (offscreen)
     {
         VkRenderPassBeginInfo renderPassInfo{};
         renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -639,112 +1276,213 @@ Result<> Vulkan::record_command_buffer(VkCommandBuffer commandBuffer, std::uint3
         XMMATRIX view = XMLoadFloat4x4(&m_viewMatrix);
         XMMATRIX proj = XMLoadFloat4x4(&m_projMatrix);
         XMMATRIX viewProj = XMMatrixMultiply(view, proj);
+        XMFLOAT4X4 viewProjMatrix{};
+        XMStoreFloat4x4(&viewProjMatrix, viewProj);
 
-        // Build visible instances and instancing batches.
-        m_instanceDataScratch.clear();
-        m_instanceBatchesScratch.clear();
-        m_instanceDataScratch.reserve(m_renderables.size());
-        m_instanceBatchesScratch.reserve(m_renderables.size());
-
-        // The renderer stores a Vulkan-flipped projection matrix (Y *= -1).
-        // DirectXCollision frustum extraction expects a regular projection matrix.
-        // Remove the flip for culling to avoid rejecting everything.
-        const XMMATRIX vulkanFlip = XMMatrixScaling(1.0f, -1.0f, 1.0f);
-        const XMMATRIX cullProj = XMMatrixMultiply(proj, vulkanFlip);
-
-        BoundingFrustum viewFrustum{};
-        BoundingFrustum::CreateFromMatrix(viewFrustum, cullProj, true);
+        // Only slots whose transform or glow changed since this frame's buffers were last used are rewritten.
+        if (auto result = upload_dirty_instance_slots(m_currentFrame); !result)
+            return result;
+        if (auto result = upload_debug_draw_frame(m_currentFrame); !result)
+            return result;
+        const InstanceFrame& instanceFrame = m_instanceFrames[m_currentFrame];
 
-        std::uint32_t culledRenderables{};
-        for (const auto& renderable : m_renderables)
+        // GPU-driven path: cull.comp culls and compacts instances, draws are issued indirectly.
+        const bool useGpuCulling = m_gpuCullingEnabled && m_cullComputePipeline != nullptr;
+        if (useGpuCulling)
         {
-            if (renderable.meshIndex >= m_meshes.size())
-                continue;
-
-            const auto& mesh = m_meshes[renderable.meshIndex];
-            if (mesh.vertexBuffer == nullptr || mesh.indexBuffer == nullptr)
-                continue;
-
-            XMMATRIX world = XMLoadFloat4x4(&renderable.worldMatrix);
-            XMVECTOR center = XMVectorSet(mesh.boundsCenter.x, mesh.boundsCenter.y, mesh.boundsCenter.z, 1.0f);
-            XMVECTOR centerWorld = XMVector3TransformCoord(center, world);
-            XMVECTOR centerView = XMVector3TransformCoord(centerWorld, view);
-
-            const float scaleX = XMVectorGetX(XMVector3Length(world.r[0]));
-            const float scaleY = XMVectorGetX(XMVector3Length(world.r[1]));
-            const float scaleZ = XMVectorGetX(XMVector3Length(world.r[2]));
-            const float maxScale = std::max(scaleX, std::max(scaleY, scaleZ));
-
-            BoundingSphere sphere{};
-            XMStoreFloat3(&sphere.Center, centerView);
-            sphere.Radius = mesh.boundsRadius * maxScale;
-
-            if (viewFrustum.Contains(sphere) == DISJOINT)
+            m_gpuProfiler.begin_pass(commandBuffer, GpuPass::Cull);
+            if (auto result = dispatch_gpu_cull_pass(commandBuffer, viewProjMatrix); !result)
+                return result;
+            m_gpuProfiler.end_pass(commandBuffer, GpuPass::Cull);
+            update_gpu_cull_batch_order(XMMatrixInverse(nullptr, view).r[3]);
+            m_lastDrawCallCount = 0;
+        }
+        else
+        {
+            // Build the visible slot list and instancing batches.
+            m_visibleSlotsScratch.clear();
+            m_instanceBatchesScratch.clear();
+            m_batchNearestScratch.clear();
+            m_visibleSlotsScratch.reserve(m_drawItems.size());
+            m_instanceBatchesScratch.reserve(m_drawItems.size());
+            m_batchNearestScratch.reserve(m_drawItems.size());
+
+            // World-space spheres were prepared by rebuild_draw_items(); static ones are culled through the tree.
+            const FrustumPlanes frustum = FrustumPlanes::from_view_projection(viewProjMatrix);
+            m_frustumCuller.cull(frustum, m_cullVisibleScratch, m_taskExecutor);
+
+            // Survivors are tested against the Hi-Z level this frame slot read back when it last ran,
+            // so the CPU path occludes with depth MAX_FRAMES_IN_FLIGHT frames old.
+            if (m_occlusionCullingEnabled)
             {
-                ++culledRenderables;
-                continue;
+                HiZReadback& readback = m_hiZReadbacks[m_currentFrame];
+                if (readback.pending && readback.mapped != nullptr)
+                {
+                    const std::uint32_t width = hiz_level_size(m_hiZWidth, m_hiZReadbackLevel);
+                    const std::uint32_t height = hiz_level_size(m_hiZHeight, m_hiZReadbackLevel);
+                    m_occlusionCuller.set_depth(
+                        std::span<const float>(static_cast<const float*>(readback.mapped),
+                                               static_cast<std::size_t>(width) * height),
+                        width, height, m_hiZReadbackLevel + 1, readback.viewportWidth, readback.viewportHeight,
+                        readback.viewProj);
+                    readback.pending = false;
+                }
+                m_occlusionCuller.cull(m_cullSpheresScratch, m_cullVisibleScratch, m_taskExecutor);
             }
 
-            std::uint32_t materialIndex = renderable.materialIndex;
-            if (materialIndex >= m_materials.size())
-                materialIndex = m_defaultMaterialIndex;
-
-            XMMATRIX mvp = XMMatrixMultiply(world, viewProj);
-            InstanceData instanceData{};
-            XMStoreFloat4x4(&instanceData.mvp, mvp);
-            instanceData.model = renderable.worldMatrix;
-            instanceData.glow = {
-                renderable.glowColor.x,
-                renderable.glowColor.y,
-                renderable.glowColor.z,
-                std::max(0.0f, renderable.glowIntensity),
-            };
-
-            const std::uint32_t firstInstance = static_cast<std::uint32_t>(m_instanceDataScratch.size());
-            m_instanceDataScratch.push_back(instanceData);
-
-            if (!m_instanceBatchesScratch.empty())
+            const XMVECTOR cameraPosition = XMMatrixInverse(nullptr, view).r[3];
+            const float lodDistanceScale = lod_distance_scale();
+            const float pixelScale = screen_pixel_scale();
+            // On-screen diameter of each material's largest visible instance, for texture streaming.
+            m_materialScreenPixels.assign(m_materials.size(), 0u);
+
+            // m_drawItems is in draw-key order, so each mesh is one contiguous run; survivors of a run
+            // are bucketed by LOD to give one batch per (mesh, LOD).
+            std::uint32_t culledRenderables{};
+            std::uint32_t occludedRenderables{};
+            for (std::size_t runBegin = 0; runBegin < m_drawItems.size();)
             {
-                auto& lastBatch = m_instanceBatchesScratch.back();
-                if (lastBatch.meshIndex == renderable.meshIndex && lastBatch.materialIndex == materialIndex)
+                const std::uint32_t meshIndex = m_drawItems[runBegin].meshIndex;
+                std::size_t runEnd = runBegin + 1;
+                while (runEnd < m_drawItems.size() && m_drawItems[runEnd].meshIndex == meshIndex)
+                    ++runEnd;
+
+                const Mesh* mesh = meshIndex < m_meshes.size() ? &m_meshes[meshIndex] : nullptr;
+                if (mesh == nullptr || !mesh->geometry.is_valid())
                 {
-                    ++lastBatch.instanceCount;
+                    runBegin = runEnd;
                     continue;
                 }
+
+                for (auto& lodSlots : m_lodSlotsScratch)
+                    lodSlots.clear();
+                std::array<float, MaxMeshLods> lodNearest{};
+                lodNearest.fill(std::numeric_limits<float>::max());
+                for (std::size_t drawIndex = runBegin; drawIndex < runEnd; ++drawIndex)
+                {
+                    const std::uint8_t visibility = m_cullVisibleScratch[drawIndex];
+                    if (visibility != 1)
+                    {
+                        if (visibility == OcclusionCuller::Occluded)
+                            ++occludedRenderables;
+                        else
+                            ++culledRenderables;
+                        continue;
+                    }
+                    const XMFLOAT4& sphere = m_cullSpheresScratch[drawIndex];
+                    const std::uint32_t lod = select_mesh_lod(*mesh, sphere, cameraPosition, lodDistanceScale);
+                    const std::uint32_t slot = m_drawItems[drawIndex].slot;
+                    m_lodSlotsScratch[lod].push_back(slot);
+                    const float distance =
+                        XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat4(&sphere), cameraPosition)));
+                    lodNearest[lod] = std::min(lodNearest[lod], distance - sphere.w);
+
+                    const std::uint32_t materialIndex = m_instanceSlots[slot].materialIndex;
+                    if (materialIndex < m_materialScreenPixels.size())
+                    {
+                        const std::uint32_t pixels =
+                            distance > sphere.w
+                                ? static_cast<std::uint32_t>(
+                                      std::min(std::ceil(2.0f * sphere.w * pixelScale / distance),
+                                               static_cast<float>(MaxScreenPixels)))
+                                : MaxScreenPixels;
+                        m_materialScreenPixels[materialIndex] = std::max(m_materialScreenPixels[materialIndex], pixels);
+                    }
+                }
+
+                for (std::uint32_t lod = 0; lod < mesh->lodCount; ++lod)
+                {
+                    const auto& lodSlots = m_lodSlotsScratch[lod];
+                    if (lodSlots.empty())
+                        continue;
+                    m_instanceBatchesScratch.push_back(
+                        InstanceBatch{
+                            meshIndex,
+                            lod,
+                            static_cast<std::uint32_t>(m_visibleSlotsScratch.size()),
+                            static_cast<std::uint32_t>(lodSlots.size())
+                        }
+                    );
+                    m_visibleSlotsScratch.insert(m_visibleSlotsScratch.end(), lodSlots.begin(), lodSlots.end());
+                    m_batchNearestScratch.push_back(lodNearest[lod]);
+                }
+                runBegin = runEnd;
             }
 
-            m_instanceBatchesScratch.push_back(
-                InstanceBatch{
-                    renderable.meshIndex,
-                    materialIndex,
-                    firstInstance,
-                    1
+            // Batches are drawn front to back by their nearest instance so early depth rejects more of
+            // what lies behind; ties keep draw-key order.
+            m_batchOrderScratch.resize(m_instanceBatchesScratch.size());
+            std::iota(m_batchOrderScratch.begin(), m_batchOrderScratch.end(), 0u);
+            std::stable_sort(m_batchOrderScratch.begin(), m_batchOrderScratch.end(),
+                             [&](std::uint32_t a, std::uint32_t b) {
+                                 return m_batchNearestScratch[a] < m_batchNearestScratch[b];
+                             });
+
+            m_lastVisibleRenderableCount = static_cast<std::uint32_t>(m_visibleSlotsScratch.size());
+            m_lastCulledRenderableCount = culledRenderables;
+            m_lastOccludedRenderableCount = occludedRenderables;
+            m_lastInstancedBatchCount = static_cast<std::uint32_t>(m_instanceBatchesScratch.size());
+            m_lastDrawCallCount = 0;
+
+            if (!m_visibleSlotsScratch.empty())
+            {
+                // Sized for every renderable by upload_dirty_instance_slots().
+                void* mapped = instanceFrame.visibleMapped;
+                if (mapped == nullptr)
+                {
+                    return make_error("Instance buffer is not mapped", ErrorCode::VulkanMemoryAllocationFailed);
                 }
-            );
+                const std::size_t dataSize = sizeof(std::uint32_t) * m_visibleSlotsScratch.size();
+                std::memcpy(mapped, m_visibleSlotsScratch.data(), dataSize);
+                m_lastInstanceUploadBytes += dataSize;
+            }
         }
 
-        m_lastVisibleRenderableCount = static_cast<std::uint32_t>(m_instanceDataScratch.size());
-        m_lastCulledRenderableCount = culledRenderables;
-        m_lastInstancedBatchCount = static_cast<std::uint32_t>(m_instanceBatchesScratch.size());
-        m_lastDrawCallCount = 0;
-
-        if (!m_instanceDataScratch.empty())
+        // Sun shadow cascades. Casters are culled on the CPU per cascade on both culling paths.
+        m_lastShadowCascadeRenderCount = 0;
+        m_lastShadowDrawCallCount = 0;
+        if (m_shadowsEnabled && m_shadowPipeline != nullptr)
         {
-            if (auto result = ensure_instance_buffer_capacity(m_instanceDataScratch.size()); !result)
+            update_shadow_cascades();
+            m_gpuProfiler.begin_pass(commandBuffer, GpuPass::Shadow);
+            if (auto result = record_shadow_pass(commandBuffer, instanceFrame.descriptorSet); !result)
                 return result;
+            m_gpuProfiler.end_pass(commandBuffer, GpuPass::Shadow);
+        }
+        else
+        {
+            m_shadowStaticChanges.clear();
+        }
 
-            VkDeviceSize dataSize = static_cast<VkDeviceSize>(sizeof(InstanceData) * m_instanceDataScratch.size());
-            void* mapped = m_instanceBufferMappings[m_currentFrame];
-            if (mapped == nullptr)
-            {
-                return make_error("Instance buffer is not mapped", ErrorCode::VulkanMemoryAllocationFailed);
-            }
-            std::memcpy(mapped, m_instanceDataScratch.data(), static_cast<size_t>(dataSize));
+        // Bin point and spot lights into view-space clusters for the scene pass's fragment shader.
+        m_gpuProfiler.begin_pass(commandBuffer, GpuPass::LightCluster);
+        if (auto result = dispatch_light_cluster_pass(commandBuffer); !result)
+            return result;
+        m_gpuProfiler.end_pass(commandBuffer, GpuPass::LightCluster);
+
+        // With enough batches, the draws are recorded into secondary command buffers on the task executor,
+        // one chunk of the batch order per task; smaller frames are recorded inline.
+        const std::vector<std::uint32_t>& batchOrder = useGpuCulling ? m_gpuCullBatchOrder : m_batchOrderScratch;
+        const std::uint32_t recordChunkCount = scene_record_chunk_count(batchOrder.size());
+        const bool recordInSecondaries = recordChunkCount > 1;
+        if (recordInSecondaries)
+        {
+            if (auto result = ensure_scene_record_chunks(m_currentFrame, recordChunkCount); !result)
+                return result;
         }
+        m_lastSceneRecordChunkCount = recordChunkCount;
 
-        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        // The statistics query may only stay active across secondary command buffers with inheritedQueries.
+        const bool collectStatistics = !recordInSecondaries || m_vulkanDevice.supports_inherited_queries();
 
-        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline.get_pipeline());
+        m_gpuProfiler.begin_pass(commandBuffer, GpuPass::Scene);
+        if (collectStatistics)
+            m_gpuProfiler.begin_statistics(commandBuffer);
+        vkCmdBeginRenderPass(
+            commandBuffer,
+            &renderPassInfo,
+            recordInSecondaries ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE
+        );
 
         VkViewport viewport{};
         viewport.x = 0.0f;
@@ -753,81 +1491,271 @@ Result<> Vulkan::record_command_buffer(VkCommandBuffer commandBuffer, std::uint3
         viewport.height = static_cast<float>(m_sceneRenderHeight);
         viewport.minDepth = 0.0f;
         viewport.maxDepth = 1.0f;
-        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
         VkRect2D scissor{};
         scissor.offset = {0, 0};
         scissor.extent = {m_sceneRenderWidth, m_sceneRenderHeight};
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
         VkPipelineLayout pipelineLayout = m_pipeline.get_pipeline_layout();
 
-        for (const auto& batch : m_instanceBatchesScratch)
-        {
+        // Per-frame state shared by every batch: bindless materials (set 0), instance slots (set 1),
+        // clustered lights (set 2) and view-projection. Secondary command buffers inherit none of it.
+        std::array<VkDescriptorSet, 3> frameSets{m_materialDescriptorSets[m_currentFrame], instanceFrame.descriptorSet,
+                                                 m_lightFrames[m_currentFrame].descriptorSet};
+        auto bind_frame_state = [&](VkCommandBuffer cmd) {
+            vkCmdSetViewport(cmd, 0, 1, &viewport);
+            vkCmdSetScissor(cmd, 0, 1, &scissor);
+            vkCmdBindDescriptorSets(
+                cmd,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                pipelineLayout,
+                0,
+                static_cast<std::uint32_t>(frameSets.size()),
+                frameSets.data(),
+                0,
+                nullptr
+            );
+            vkCmdPushConstants(
+                cmd,
+                pipelineLayout,
+                VK_SHADER_STAGE_VERTEX_BIT,
+                0,
+                sizeof(XMFLOAT4X4),
+                &viewProjMatrix
+            );
+        };
+
+        // Binds the vertex (geometry page + visible slot) and index buffers of a batch's mesh, unless the
+        // previous batch on `cmd` used the same geometry arena page. The depth prepass reads the page's
+        // packed position stream instead of the full vertices.
+        auto bind_batch = [&](VkCommandBuffer cmd, const InstanceBatch& batch, VkBuffer instanceBuffer,
+                              bool positionsOnly, std::uint32_t& boundPage) -> const Mesh* {
             if (batch.meshIndex >= m_meshes.size())
-                continue;
+                return nullptr;
 
             const auto& mesh = m_meshes[batch.meshIndex];
-            if (mesh.vertexBuffer == nullptr || mesh.indexBuffer == nullptr)
-                continue;
-
-            // Bind material descriptor set
-            std::uint32_t matIdx = batch.materialIndex;
-            if (matIdx < m_materials.size())
-            {
-                vkCmdBindDescriptorSets(
-                    commandBuffer,
-                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    pipelineLayout,
-                    0,
-                    1,
-                    &m_materials[matIdx].descriptorSet,
-                    0,
-                    nullptr
-                );
-            }
-            else if (!m_materials.empty())
-            {
-                // Fallback to default material (index 0)
-                vkCmdBindDescriptorSets(
-                    commandBuffer,
-                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    pipelineLayout,
-                    0,
-                    1,
-                    &m_materials[m_defaultMaterialIndex].descriptorSet,
-                    0,
-                    nullptr
-                );
-            }
-
-            if (m_instanceBuffers[m_currentFrame] == nullptr)
-                continue;
-
-            std::array<VkBuffer, 2> vertexBuffers{mesh.vertexBuffer, m_instanceBuffers[m_currentFrame]};
+            if (!mesh.geometry.is_valid() || instanceBuffer == nullptr)
+                return nullptr;
+            if (mesh.geometry.page == boundPage)
+                return &mesh;
+
+            VkBuffer pageBuffer = positionsOnly ? m_geometryArena.get_position_buffer(mesh.geometry.page)
+                                                : m_geometryArena.get_vertex_buffer(mesh.geometry.page);
+            VkBuffer indexBuffer = m_geometryArena.get_index_buffer(mesh.geometry.page);
+            if (pageBuffer == nullptr || indexBuffer == nullptr)
+                return nullptr;
+
+            std::array<VkBuffer, 2> vertexBuffers{pageBuffer, instanceBuffer};
             std::array<VkDeviceSize, 2> offsets{0, 0};
             vkCmdBindVertexBuffers(
-                commandBuffer,
+                cmd,
                 0,
                 static_cast<std::uint32_t>(vertexBuffers.size()),
                 vertexBuffers.data(),
                 offsets.data()
             );
 
-            vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdBindIndexBuffer(cmd, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+            boundPage = mesh.geometry.page;
+            return &mesh;
+        };
+
+        // Issues batchOrder[first, last) front to back with whichever pipeline is bound. Returns the draw
+        // calls recorded. Only reads renderer state, so chunks can be recorded concurrently.
+        auto draw_batches = [&](VkCommandBuffer cmd, bool positionsOnly, std::size_t first,
+                                std::size_t last) -> std::uint32_t {
+            std::uint32_t drawCalls = 0;
+            std::uint32_t boundPage = std::numeric_limits<std::uint32_t>::max();
+            if (useGpuCulling)
+            {
+                const GpuCullFrame& cullFrame = m_gpuCullFrames[m_currentFrame];
+                const auto drawIndexedIndirectCount = m_vulkanDevice.get_cmd_draw_indexed_indirect_count();
+                const bool multiDraw = m_vulkanDevice.supports_multi_draw_indirect();
+                constexpr std::uint32_t drawStride = sizeof(VkDrawIndexedIndirectCommand);
+
+                for (std::size_t orderIndex = first; orderIndex < last;)
+                {
+                    const std::uint32_t batchIndex = batchOrder[orderIndex];
+                    const Mesh* mesh =
+                        bind_batch(cmd, m_gpuCullBatches[batchIndex], cullFrame.outputBuffer, positionsOnly, boundPage);
+                    if (mesh == nullptr)
+                    {
+                        ++orderIndex;
+                        continue;
+                    }
+
+                    // Batches whose commands sit next to each other and share the bound page go out as one
+                    // multi-draw; commands the GPU left at instanceCount 0 draw nothing.
+                    std::uint32_t runLength = 1;
+                    while (multiDraw && orderIndex + runLength < last && runLength < MaxMultiDrawRun &&
+                           batchOrder[orderIndex + runLength] == batchIndex + runLength)
+                    {
+                        const std::uint32_t nextMesh = m_gpuCullBatches[batchIndex + runLength].meshIndex;
+                        if (nextMesh >= m_meshes.size() || !m_meshes[nextMesh].geometry.is_valid() ||
+                            m_meshes[nextMesh].geometry.page != boundPage)
+                            break;
+                        ++runLength;
+                    }
+
+                    const VkDeviceSize drawOffset = static_cast<VkDeviceSize>(batchIndex) * drawStride;
+                    if (runLength > 1)
+                    {
+                        vkCmdDrawIndexedIndirect(cmd, cullFrame.drawBuffer, drawOffset, runLength, drawStride);
+                    }
+                    else if (drawIndexedIndirectCount != nullptr)
+                    {
+                        // With VK_KHR_draw_indirect_count, a batch the GPU culled entirely is skipped via drawCount = 0.
+                        const VkDeviceSize countOffset = static_cast<VkDeviceSize>(3 + batchIndex) * sizeof(std::uint32_t);
+                        drawIndexedIndirectCount(
+                            cmd, cullFrame.drawBuffer, drawOffset, cullFrame.countBuffer, countOffset, 1, drawStride
+                        );
+                    }
+                    else
+                    {
+                        vkCmdDrawIndexedIndirect(cmd, cullFrame.drawBuffer, drawOffset, 1, drawStride);
+                    }
+                    ++drawCalls;
+                    orderIndex += runLength;
+                }
+            }
+            else
+            {
+                for (std::size_t orderIndex = first; orderIndex < last; ++orderIndex)
+                {
+                    const InstanceBatch& batch = m_instanceBatchesScratch[batchOrder[orderIndex]];
+                    const Mesh* mesh = bind_batch(cmd, batch, instanceFrame.visibleBuffer, positionsOnly, boundPage);
+                    if (mesh == nullptr)
+                        continue;
+
+                    const MeshLod& lod = mesh->lods[batch.lodLevel];
+                    vkCmdDrawIndexed(cmd, lod.indexCount, batch.instanceCount, mesh->geometry.firstIndex + lod.firstIndex,
+                                     static_cast<std::int32_t>(mesh->geometry.firstVertex), batch.firstInstance);
+                    ++drawCalls;
+                }
+            }
+            return drawCalls;
+        };
+
+        // Depth-only pass first: the color pass then shades each sample once (depth test EQUAL).
+        // Pipeline layout, descriptor sets and push constants are shared, so only the pipeline changes.
+        const bool depthPrepass = m_depthPrepassEnabled && m_depthPrepassPipeline != nullptr;
+        if (!recordInSecondaries)
+        {
+            bind_frame_state(commandBuffer);
+            if (depthPrepass)
+            {
+                m_gpuProfiler.begin_pass(commandBuffer, GpuPass::DepthPrepass);
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_depthPrepassPipeline);
+                m_lastDrawCallCount += draw_batches(commandBuffer, true, 0, batchOrder.size());
+                m_gpuProfiler.end_pass(commandBuffer, GpuPass::DepthPrepass);
+            }
+
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline.get_pipeline());
+            m_lastDrawCallCount += draw_batches(commandBuffer, false, 0, batchOrder.size());
+
+            // Debug lines last, tested against the finished scene depth.
+            m_lastDebugDrawCallCount = record_debug_draws(commandBuffer);
+        }
+        else
+        {
+            NOC_PROFILE_ZONE("Vulkan::record_scene_secondaries");
+            std::vector<SceneRecordChunk>& chunks = m_sceneRecordChunks[m_currentFrame];
+
+            VkCommandBufferInheritanceInfo inheritanceInfo{};
+            inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+            inheritanceInfo.renderPass = m_sceneRenderPass;
+            inheritanceInfo.subpass = 0;
+            inheritanceInfo.framebuffer = m_sceneFramebuffer;
+            inheritanceInfo.pipelineStatistics = collectStatistics ? m_gpuProfiler.get_statistics_flags() : 0;
+
+            VkCommandBufferBeginInfo secondaryBeginInfo{};
+            secondaryBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            secondaryBeginInfo.flags =
+                VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            secondaryBeginInfo.pInheritanceInfo = &inheritanceInfo;
+
+            // Each task owns one chunk and its pool. The depth prepass timestamps are written by the first
+            // and last chunk, which execute first and last; the last color chunk also draws the debug lines.
+            std::uint32_t debugDrawCalls = 0;
+            auto record_chunk = [&](std::uint32_t chunkIndex) {
+                SceneRecordChunk& chunk = chunks[chunkIndex];
+                chunk.drawCalls = 0;
+                chunk.failed = vkResetCommandPool(device, chunk.commandPool, 0) != VK_SUCCESS;
+                const std::size_t first = batchOrder.size() * chunkIndex / recordChunkCount;
+                const std::size_t last = batchOrder.size() * (chunkIndex + 1) / recordChunkCount;
+
+                auto record = [&](VkCommandBuffer cmd, bool positionsOnly) {
+                    if (chunk.failed || vkBeginCommandBuffer(cmd, &secondaryBeginInfo) != VK_SUCCESS)
+                    {
+                        chunk.failed = true;
+                        return;
+                    }
+                    bind_frame_state(cmd);
+                    if (positionsOnly && chunkIndex == 0)
+                        m_gpuProfiler.begin_pass(cmd, GpuPass::DepthPrepass);
+                    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                      positionsOnly ? m_depthPrepassPipeline : m_pipeline.get_pipeline());
+                    chunk.drawCalls += draw_batches(cmd, positionsOnly, first, last);
+                    if (positionsOnly && chunkIndex + 1 == recordChunkCount)
+                        m_gpuProfiler.end_pass(cmd, GpuPass::DepthPrepass);
+                    if (!positionsOnly && chunkIndex + 1 == recordChunkCount)
+                        debugDrawCalls = record_debug_draws(cmd);
+                    chunk.failed = vkEndCommandBuffer(cmd) != VK_SUCCESS;
+                };
+                if (depthPrepass)
+                    record(chunk.prepassCommandBuffer, true);
+                record(chunk.colorCommandBuffer, false);
+            };
 
-            vkCmdDrawIndexed(commandBuffer, mesh.indexCount, batch.instanceCount, 0, 0, batch.firstInstance);
-            ++m_lastDrawCallCount;
+            tf::Taskflow taskflow{};
+            for (std::uint32_t chunkIndex = 0; chunkIndex < recordChunkCount; ++chunkIndex)
+                taskflow.emplace([&, chunkIndex]() { record_chunk(chunkIndex); });
+            // draw_frame() may run inside a frame job graph, where waiting must help out instead of blocking.
+            if (m_taskExecutor->this_worker_id() >= 0)
+                m_taskExecutor->corun(taskflow);
+            else
+                m_taskExecutor->run(taskflow).wait();
+
+            // Every prepass chunk before any color chunk, each group in batch order.
+            std::pmr::vector<VkCommandBuffer> secondaries{FrameArena::current()};
+            secondaries.reserve(static_cast<std::size_t>(recordChunkCount) * 2);
+            for (std::uint32_t chunkIndex = 0; chunkIndex < recordChunkCount && depthPrepass; ++chunkIndex)
+                secondaries.push_back(chunks[chunkIndex].prepassCommandBuffer);
+            for (std::uint32_t chunkIndex = 0; chunkIndex < recordChunkCount; ++chunkIndex)
+            {
+                if (chunks[chunkIndex].failed)
+                {
+                    return make_error("Failed to record scene secondary command buffer",
+                                      ErrorCode::VulkanCommandBufferRecordingFailed);
+                }
+                secondaries.push_back(chunks[chunkIndex].colorCommandBuffer);
+                m_lastDrawCallCount += chunks[chunkIndex].drawCalls;
+            }
+            vkCmdExecuteCommands(commandBuffer, static_cast<std::uint32_t>(secondaries.size()), secondaries.data());
+            m_lastDebugDrawCallCount = debugDrawCalls;
         }
 
         vkCmdEndRenderPass(commandBuffer);
+        if (collectStatistics)
+            m_gpuProfiler.end_statistics(commandBuffer);
+        m_gpuProfiler.end_pass(commandBuffer, GpuPass::Scene);
+
+        // The pyramid is built from this frame's depth and tested by the next frame's culling.
+        if (m_occlusionCullingEnabled && m_hiZPipeline != nullptr)
+        {
+            m_gpuProfiler.begin_pass(commandBuffer, GpuPass::HiZ);
+            dispatch_hiz_pass(commandBuffer, viewProjMatrix, !useGpuCulling);
+            m_gpuProfiler.end_pass(commandBuffer, GpuPass::HiZ);
+        }
     }
 
     // Scene color image is sampled in the ImGui viewport pass.
     // When NIS is enabled, run compute pass; otherwise add a visibility barrier.
     if (m_nisEnabled && m_nisComputePipeline != nullptr)
     {
+        m_gpuProfiler.begin_pass(commandBuffer, GpuPass::Nis);
         dispatch_nis_pass(commandBuffer);
+        m_gpuProfiler.end_pass(commandBuffer, GpuPass::Nis);
     }
     else
     {
@@ -861,8 +1789,10 @@ Result<> Vulkan::record_command_buffer(VkCommandBuffer commandBuffer, std::uint3
         );
     }
 
-    // UI render pass (swapchain) for editor, or direct blit for standalone Game.
-    if (get_ui_render_callback())
+    // UI render pass (swapchain) for editor, or direct blit for standalone Game. Offscreen frames
+    // leave the result in the scene (or NIS) target.
+    const bool presenting = imageIndex != NoSwapchainImage;
+    if (presenting && get_ui_render_callback())
     {
         VkExtent2D swapExtent = m_swapchain.get_extent();
 
@@ -877,6 +1807,7 @@ Result<> Vulkan::record_command_buffer(VkCommandBuffer commandBuffer, std::uint3
         renderPassInfo.clearValueCount = 1;
         renderPassInfo.pClearValues = &uiClearColor;
 
+        m_gpuProfiler.begin_pass(commandBuffer, GpuPass::Ui);
         vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
         VkViewport viewport{};
@@ -895,9 +1826,11 @@ Result<> Vulkan::record_command_buffer(VkCommandBuffer commandBuffer, std::uint3
 
         get_ui_render_callback()(commandBuffer);
         vkCmdEndRenderPass(commandBuffer);
+        m_gpuProfiler.end_pass(commandBuffer, GpuPass::Ui);
     }
-    else
+    else if (presenting)
     {
+        m_gpuProfiler.begin_pass(commandBuffer, GpuPass::Blit);
         const bool useNisOutput = m_nisEnabled && m_nisOutputImage != nullptr;
         VkImage sourceImage = useNisOutput ? m_nisOutputImage : m_sceneColorImage;
         const std::uint32_t sourceWidth = useNisOutput ? m_swapchain.get_extent().width : m_sceneRenderWidth;
@@ -989,6 +1922,7 @@ Result<> Vulkan::record_command_buffer(VkCommandBuffer commandBuffer, std::uint3
                              nullptr,
                              static_cast<std::uint32_t>(postBlitBarriers.size()),
                              postBlitBarriers.data());
+        m_gpuProfiler.end_pass(commandBuffer, GpuPass::Blit);
     }
 
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
@@ -1087,14 +2021,22 @@ Result<> Vulkan::recreate_swap_chain()
 
     vkDeviceWaitIdle(device);
 
+    // Present ids are per swapchain; the old ones cannot be waited on anymore.
+    m_framePresentIds = {};
     if (auto result = m_swapchain.recreate(); !result)
         return result;
 
     // Recreate offscreen scene render target
+    cleanup_hiz_resources();
     cleanup_scene_render_target();
     compute_scene_render_size();
     if (auto result = create_scene_render_target(); !result)
         return result;
+    if (m_occlusionCullingEnabled)
+    {
+        if (auto hiZResult = create_hiz_resources(); !hiZResult)
+            fmt::print("Warning: failed to recreate Hi-Z resources: {}\n", hiZResult.error().message);
+    }
 
     // Recreate per-image sync objects for the new swapchain.
     // Build the new set first, then atomically swap and destroy old ones.
@@ -1150,110 +2092,101 @@ Result<uint32_t> Vulkan::upload_mesh(const MeshData& meshData)
     if (meshData.vertices.empty())
         return make_error("MeshData has no vertices", ErrorCode::AssetInvalidData);
 
-    std::string meshKey{};
-    if (!meshData.sourcePath.empty())
+    // Meshes loaded through a model carry their id; others are keyed by source path and name.
+    const AssetId meshKey = meshData.id.is_valid() ? meshData.id
+                            : meshData.sourcePath.empty()
+                                ? AssetId{}
+                                : AssetId::from_path(meshData.sourcePath).child(meshData.name);
+    if (meshKey.is_valid())
     {
-        meshKey = meshData.sourcePath.generic_string();
-        meshKey.push_back('|');
-        meshKey += meshData.name;
         if (const auto it = m_meshLookup.find(meshKey); it != m_meshLookup.end())
             return it->second;
     }
 
-    VkDevice device = m_vulkanDevice.get_device();
     Mesh mesh{};
-    mesh.indexCount = static_cast<std::uint32_t>(meshData.indices.size());
-    auto cleanup_mesh_gpu_buffers = [&]() {
-        if (mesh.indexBuffer != nullptr)
-        {
-            vkDestroyBuffer(device, mesh.indexBuffer, nullptr);
-            mesh.indexBuffer = nullptr;
-        }
-        if (mesh.indexBufferMemory != nullptr)
-        {
-            vkFreeMemory(device, mesh.indexBufferMemory, nullptr);
-            mesh.indexBufferMemory = nullptr;
-        }
-        if (mesh.vertexBuffer != nullptr)
-        {
-            vkDestroyBuffer(device, mesh.vertexBuffer, nullptr);
-            mesh.vertexBuffer = nullptr;
-        }
-        if (mesh.vertexBufferMemory != nullptr)
-        {
-            vkFreeMemory(device, mesh.vertexBufferMemory, nullptr);
-            mesh.vertexBufferMemory = nullptr;
-        }
-    };
-
-    // --- Vertex/index buffers ---
-    const VkDeviceSize vertexBufferSize = sizeof(meshData.vertices[0]) * meshData.vertices.size();
-    const VkDeviceSize indexBufferSize = sizeof(meshData.indices[0]) * meshData.indices.size();
-    const VkDeviceSize indexSrcOffset = (vertexBufferSize + 3) & ~static_cast<VkDeviceSize>(3);
-    const VkDeviceSize totalStagingSize = indexSrcOffset + indexBufferSize;
-    mesh.vertexBufferBytes = vertexBufferSize;
-    mesh.indexBufferBytes = indexBufferSize;
-    VkDeviceSize vertexAllocationBytes{};
-    VkDeviceSize indexAllocationBytes{};
-
-    if (auto res = ensure_upload_staging_capacity(totalStagingSize); !res)
-        return make_error(res.error());
-    std::memcpy(m_uploadStagingMapped, meshData.vertices.data(), static_cast<std::size_t>(vertexBufferSize));
-    std::memcpy(
-        static_cast<std::byte*>(m_uploadStagingMapped) + indexSrcOffset,
-        meshData.indices.data(),
-        static_cast<std::size_t>(indexBufferSize)
-    );
-
-    if (auto res = m_vulkanDevice.create_buffer(
-            vertexBufferSize,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            mesh.vertexBuffer,
-            mesh.vertexBufferMemory,
-            &vertexAllocationBytes
-    ); !res)
-    {
-        return make_error(res.error());
-    }
-
-    if (auto res = m_vulkanDevice.create_buffer(
-        indexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        mesh.indexBuffer,
-        mesh.indexBufferMemory,
-        &indexAllocationBytes
-    ); !res)
+    mesh.indexCount = static_cast<std::uint32_t>(meshData.base_indices().size());
+    mesh.lods[0] = MeshLod{0, mesh.indexCount, 0.0f};
+    mesh.lodCount = 1;
+    // All levels share the mesh's one index range; levels beyond what the renderer tracks are dropped.
+    for (std::size_t lod = 1; lod < meshData.lods.size() && lod < MaxMeshLods; ++lod)
+        mesh.lods[mesh.lodCount++] = meshData.lods[lod];
+
+    // --- Geometry arena ranges ---
+    // Meshes live on the GPU as PackedVertex (half the size of Vertex); packing happens into staging.
+    // The depth prepass reads the page's position-only stream so it fetches 12 bytes per vertex.
+    auto rangeResult = m_geometryArena.allocate(static_cast<std::uint32_t>(meshData.vertices.size()),
+                                                static_cast<std::uint32_t>(meshData.indices.size()));
+    if (!rangeResult)
+        return make_error(rangeResult.error());
+    mesh.geometry = rangeResult.value();
+
+    const VkDeviceSize vertexBytes = sizeof(PackedVertex) * meshData.vertices.size();
+    const VkDeviceSize positionBytes = sizeof(XMFLOAT3) * meshData.vertices.size();
+    const VkDeviceSize indexBytes = sizeof(meshData.indices[0]) * meshData.indices.size();
+    const VkDeviceSize positionSrcOffset = (vertexBytes + 3) & ~static_cast<VkDeviceSize>(3);
+    const VkDeviceSize indexSrcOffset = (positionSrcOffset + positionBytes + 3) & ~static_cast<VkDeviceSize>(3);
+    const VkDeviceSize totalStagingSize = indexSrcOffset + indexBytes;
+
+    // Queue the copies; the batch is submitted by flush_uploads() or the next draw_frame().
+    auto stagingResult = m_uploadQueue.reserve(totalStagingSize);
+    if (!stagingResult)
     {
-        cleanup_mesh_gpu_buffers();
-        return make_error(res.error());
+        m_geometryArena.free(mesh.geometry);
+        return make_error(stagingResult.error());
     }
-
-    auto commandBufferResult = m_vulkanDevice.begin_single_time_commands();
-    if (!commandBufferResult)
+    const UploadStagingSpan staging = stagingResult.value();
+    auto* packedVertices = static_cast<PackedVertex*>(staging.mapped);
+    auto* positions = reinterpret_cast<XMFLOAT3*>(static_cast<std::byte*>(staging.mapped) + positionSrcOffset);
+    for (std::size_t i = 0; i < meshData.vertices.size(); ++i)
     {
-        cleanup_mesh_gpu_buffers();
-        return make_error("Failed to begin upload command buffer", ErrorCode::VulkanCopyBufferFailed);
+        packedVertices[i] = PackedVertex::pack(meshData.vertices[i]);
+        positions[i] = meshData.vertices[i].pos;
     }
-    VkCommandBuffer commandBuffer = commandBufferResult.value();
+    std::memcpy(
+        static_cast<std::byte*>(staging.mapped) + indexSrcOffset,
+        meshData.indices.data(),
+        static_cast<std::size_t>(indexBytes)
+    );
 
+    const std::uint32_t page = mesh.geometry.page;
     VkBufferCopy vertexCopy{};
-    vertexCopy.srcOffset = 0;
-    vertexCopy.dstOffset = 0;
-    vertexCopy.size = vertexBufferSize;
-    vkCmdCopyBuffer(commandBuffer, m_uploadStagingBuffer, mesh.vertexBuffer, 1, &vertexCopy);
+    vertexCopy.srcOffset = staging.offset;
+    vertexCopy.dstOffset = sizeof(PackedVertex) * static_cast<VkDeviceSize>(mesh.geometry.firstVertex);
+    vertexCopy.size = vertexBytes;
+    vkCmdCopyBuffer(staging.commandBuffer, staging.buffer, m_geometryArena.get_vertex_buffer(page), 1, &vertexCopy);
 
-    VkBufferCopy indexCopy{};
-    indexCopy.srcOffset = indexSrcOffset;
-    indexCopy.dstOffset = 0;
-    indexCopy.size = indexBufferSize;
-    vkCmdCopyBuffer(commandBuffer, m_uploadStagingBuffer, mesh.indexBuffer, 1, &indexCopy);
+    VkBufferCopy positionCopy{};
+    positionCopy.srcOffset = staging.offset + positionSrcOffset;
+    positionCopy.dstOffset = sizeof(XMFLOAT3) * static_cast<VkDeviceSize>(mesh.geometry.firstVertex);
+    positionCopy.size = positionBytes;
+    vkCmdCopyBuffer(staging.commandBuffer, staging.buffer, m_geometryArena.get_position_buffer(page), 1, &positionCopy);
 
-    if (auto endResult = m_vulkanDevice.end_single_time_commands(commandBuffer); !endResult)
+    VkBufferCopy indexCopy{};
+    indexCopy.srcOffset = staging.offset + indexSrcOffset;
+    indexCopy.dstOffset = sizeof(std::uint32_t) * static_cast<VkDeviceSize>(mesh.geometry.firstIndex);
+    indexCopy.size = indexBytes;
+    vkCmdCopyBuffer(staging.commandBuffer, staging.buffer, m_geometryArena.get_index_buffer(page), 1, &indexCopy);
+
+    // On the graphics queue a barrier orders the copies before later vertex fetches. A dedicated
+    // transfer queue cannot name vertex stages; draw_frame() waits for those batches instead.
+    if (!m_vulkanDevice.has_dedicated_transfer_queue())
     {
-        cleanup_mesh_gpu_buffers();
-        return make_error("Failed to submit mesh upload command buffer", ErrorCode::VulkanCopyBufferFailed);
+        VkMemoryBarrier copyBarrier{};
+        copyBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        copyBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        copyBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+        vkCmdPipelineBarrier(
+            staging.commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            0,
+            1,
+            &copyBarrier,
+            0,
+            nullptr,
+            0,
+            nullptr
+        );
     }
 
     mesh.boundsCenter = {
@@ -1267,14 +2200,11 @@ Result<uint32_t> Vulkan::upload_mesh(const MeshData& meshData)
     const float halfY = (meshData.boundsMax.y - meshData.boundsMin.y) * 0.5f;
     const float halfZ = (meshData.boundsMax.z - meshData.boundsMin.z) * 0.5f;
     mesh.boundsRadius = std::sqrt(halfX * halfX + halfY * halfY + halfZ * halfZ);
-    mesh.vertexBufferAllocationBytes = vertexAllocationBytes;
-    mesh.indexBufferAllocationBytes = indexAllocationBytes;
 
     std::uint32_t meshIndex = static_cast<std::uint32_t>(m_meshes.size());
     m_meshes.push_back(mesh);
-    m_meshMemoryBytes += static_cast<std::uint64_t>(mesh.vertexBufferAllocationBytes + mesh.indexBufferAllocationBytes);
-    if (!meshKey.empty())
-        m_meshLookup.emplace(std::move(meshKey), meshIndex);
+    if (meshKey.is_valid())
+        m_meshLookup.emplace(meshKey, meshIndex);
     return meshIndex;
 }
 
@@ -1296,7 +2226,7 @@ Result<> Vulkan::create_sampler()
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
     if (vkCreateSampler(m_vulkanDevice.get_device(), &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS)
     {
@@ -1334,96 +2264,177 @@ Result<> Vulkan::create_default_textures()
         return make_error(normalResult.error());
     m_defaultNormalTextureIndex = normalResult.value();
 
-    // Default roughness: 1x1 white pixel (roughness = 1.0)
-    TextureData whiteRoughness{};
-    whiteRoughness.name = "default_roughness";
-    whiteRoughness.width = 1;
-    whiteRoughness.height = 1;
-    whiteRoughness.channels = 4;
-    whiteRoughness.pixels = {255, 255, 255, 255};
-
-    auto roughnessResult = upload_texture(whiteRoughness);
-    if (!roughnessResult)
-        return make_error(roughnessResult.error());
-    m_defaultRoughnessTextureIndex = roughnessResult.value();
-
-    // Default metallic: 1x1 black pixel (metallic = 0.0)
-    TextureData blackMetallic{};
-    blackMetallic.name = "default_metallic";
-    blackMetallic.width = 1;
-    blackMetallic.height = 1;
-    blackMetallic.channels = 4;
-    blackMetallic.pixels = {0, 0, 0, 255};
-
-    auto metallicResult = upload_texture(blackMetallic);
-    if (!metallicResult)
-        return make_error(metallicResult.error());
-    m_defaultMetallicTextureIndex = metallicResult.value();
-
-    // Default AO: 1x1 white pixel (fully lit, no occlusion)
-    TextureData whiteAO{};
-    whiteAO.name = "default_ao";
-    whiteAO.width = 1;
-    whiteAO.height = 1;
-    whiteAO.channels = 4;
-    whiteAO.pixels = {255, 255, 255, 255};
-
-    auto aoResult = upload_texture(whiteAO);
-    if (!aoResult)
-        return make_error(aoResult.error());
-    m_defaultAOTextureIndex = aoResult.value();
+    // Default ORM: AO = 1 (no occlusion), roughness = 1, metallic = 0. One texture for all three
+    // slots keeps the default material on the packed single-fetch path.
+    TextureData defaultOrm{};
+    defaultOrm.name = "default_orm";
+    defaultOrm.width = 1;
+    defaultOrm.height = 1;
+    defaultOrm.channels = 4;
+    defaultOrm.pixels = {255, 255, 0, 255};
+
+    auto ormResult = upload_texture(defaultOrm);
+    if (!ormResult)
+        return make_error(ormResult.error());
+    m_defaultOrmTextureIndex = ormResult.value();
 
     return {};
 }
 
 Result<std::uint32_t> Vulkan::upload_texture(const TextureData& textureData)
 {
-    if (textureData.pixels.empty() || textureData.width == 0 || textureData.height == 0)
+    const std::span<const std::uint8_t> pixels = textureData.pixel_bytes();
+    if (pixels.empty() || textureData.width == 0 || textureData.height == 0)
         return make_error("TextureData has no pixel data", ErrorCode::AssetInvalidData);
 
-    if (!textureData.sourcePath.empty())
+    const AssetId textureKey = AssetId::from_path(textureData.sourcePath);
+    if (textureKey.is_valid())
     {
-        const std::string textureKey = textureData.sourcePath.generic_string();
         if (const auto it = m_textureLookup.find(textureKey); it != m_textureLookup.end())
             return it->second;
     }
 
-    VkDevice device = m_vulkanDevice.get_device();
-    VkDeviceSize imageSize = static_cast<VkDeviceSize>(textureData.width) * textureData.height * 4;
+    if (m_textures.size() >= m_vulkanDevice.get_max_bindless_textures())
+        return make_error(fmt::format("Texture '{}' exceeds the bindless texture capacity ({})", textureData.name,
+                                      m_vulkanDevice.get_max_bindless_textures()),
+                          ErrorCode::VulkanTextureUploadFailed);
 
-    if (auto res = ensure_upload_staging_capacity(imageSize); !res)
-        return make_error(res.error());
+    VkFormat format{VK_FORMAT_R8G8B8A8_UNORM};
+    VkComponentMapping components{};
+    switch (textureData.format)
+    {
+    case TexturePixelFormat::BC4:
+        // Single-channel masks are read from .r, .g or .b depending on the slot; broadcast R.
+        format = VK_FORMAT_BC4_UNORM_BLOCK;
+        components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE};
+        break;
+    case TexturePixelFormat::BC5:
+        format = VK_FORMAT_BC5_UNORM_BLOCK;
+        break;
+    case TexturePixelFormat::BC7:
+        format = VK_FORMAT_BC7_UNORM_BLOCK;
+        break;
+    case TexturePixelFormat::RGBA8:
+    default:
+        break;
+    }
+
+    if (textureData.format != TexturePixelFormat::RGBA8 && !m_vulkanDevice.supports_texture_compression_bc())
+        return make_error(fmt::format("Texture '{}' is block-compressed but the device lacks textureCompressionBC",
+                                      textureData.name),
+                          ErrorCode::VulkanFormatNotSupported);
+
+    std::vector<TextureLevel> levels{};
+    levels.reserve(textureData.mips.size());
+    for (const TextureMipLevel& mip : textureData.mips)
+        levels.push_back(TextureLevel{{mip.width, mip.height}, mip.offset, mip.size});
+    if (levels.empty())
+    {
+        if (textureData.format != TexturePixelFormat::RGBA8)
+            return make_error("Block-compressed TextureData has no mip table", ErrorCode::AssetInvalidData);
+        levels.push_back(TextureLevel{{textureData.width, textureData.height}, 0,
+                                      static_cast<std::uint64_t>(textureData.width) * textureData.height * 4});
+    }
+
+    VkDeviceSize imageSize{};
+    for (const TextureLevel& level : levels)
+        imageSize = std::max<VkDeviceSize>(imageSize, level.offset + level.size);
+    if (imageSize > pixels.size())
+        return make_error("TextureData mip table exceeds its pixel data", ErrorCode::AssetInvalidData);
+
+    // Cooked chains stay mapped, so their finer levels can be read again later; only those are streamed.
+    // Streaming starts them at the first level no larger than TextureStreamingBaseSize.
+    std::uint32_t baseLevel{};
+    while (baseLevel + 1 < levels.size() &&
+           std::max(levels[baseLevel].extent.width, levels[baseLevel].extent.height) > TextureStreamingBaseSize)
+        ++baseLevel;
+    const bool streamed = baseLevel > 0 && textureData.pixels.empty() && textureData.mappedSource != nullptr;
+    const std::uint32_t firstLevel = streamed && m_textureStreamingEnabled ? baseLevel : 0u;
+
+    auto textureResult = create_texture_image(textureData.name, format, components, levels, firstLevel, pixels);
+    if (!textureResult)
+        return make_error(textureResult.error());
+
+    const auto textureIndex = static_cast<std::uint32_t>(m_textures.size());
+    m_textures.push_back(textureResult.value());
+
+    // The element is unused by every frame still in flight, so every frame's set can be written right away.
+    for (std::size_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; ++frameIndex)
+        write_texture_descriptor(frameIndex, textureIndex);
+
+    if (streamed)
+    {
+        StreamedTexture& entry = m_streamedTextures.emplace_back();
+        entry.textureIndex = textureIndex;
+        entry.name = textureData.name;
+        entry.format = format;
+        entry.components = components;
+        entry.levels = std::move(levels);
+        entry.pixels = pixels;
+        entry.mappedSource = textureData.mappedSource;
+        entry.baseLevel = baseLevel;
+        entry.residentLevel = firstLevel;
+        entry.desiredLevel = firstLevel;
+    }
 
-    std::memcpy(m_uploadStagingMapped, textureData.pixels.data(), static_cast<size_t>(imageSize));
+    if (textureKey.is_valid())
+        m_textureLookup.emplace(textureKey, textureIndex);
+    return textureIndex;
+}
 
+Result<GpuTexture> Vulkan::create_texture_image(const std::string& name, VkFormat format,
+                                                const VkComponentMapping& components,
+                                                std::span<const TextureLevel> levels, std::uint32_t firstLevel,
+                                                std::span<const std::uint8_t> pixels)
+{
+    if (firstLevel >= levels.size())
+        return make_error(fmt::format("Texture '{}' has no mip level {}", name, firstLevel),
+                          ErrorCode::AssetInvalidData);
+
+    const std::span<const TextureLevel> uploaded = levels.subspan(firstLevel);
+    const std::uint32_t mipLevels = static_cast<std::uint32_t>(uploaded.size());
+    // Levels are stored largest first, back to back, so the uploaded ones are one contiguous range.
+    const VkDeviceSize sourceOffset = uploaded.front().offset;
+    const VkDeviceSize uploadSize = uploaded.back().offset + uploaded.back().size - sourceOffset;
     GpuTexture texture{};
-    VkFormat format{VK_FORMAT_R8G8B8A8_UNORM};
-    VkDeviceSize textureAllocationBytes{};
 
     if (auto res = m_vulkanDevice.create_image(
-        textureData.width,
-        textureData.height,
+        uploaded.front().extent.width,
+        uploaded.front().extent.height,
         format,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         texture.image,
-        texture.memory,
+        texture.allocation,
         VK_SAMPLE_COUNT_1_BIT,
-        &textureAllocationBytes
+        mipLevels
     ); !res)
     {
         return make_error(res.error());
     }
 
-    auto commandBufferResult = m_vulkanDevice.begin_single_time_commands();
-    if (!commandBufferResult)
+    auto viewResult =
+        m_vulkanDevice.create_image_view(texture.image, format, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, components);
+    if (!viewResult)
     {
-        vkDestroyImage(device, texture.image, nullptr);
-        vkFreeMemory(device, texture.memory, nullptr);
-        return make_error("Failed to begin texture upload command buffer", ErrorCode::VulkanTextureUploadFailed);
+        m_vulkanDevice.destroy_image(texture.image, texture.allocation);
+        return make_error(viewResult.error());
     }
-    VkCommandBuffer commandBuffer = commandBufferResult.value();
+    texture.imageView = viewResult.value();
+
+    // Queue the copy; the batch is submitted by flush_uploads() or the next draw_frame().
+    auto stagingResult = m_uploadQueue.reserve(uploadSize);
+    if (!stagingResult)
+    {
+        vkDestroyImageView(m_vulkanDevice.get_device(), texture.imageView, nullptr);
+        m_vulkanDevice.destroy_image(texture.image, texture.allocation);
+        return make_error(stagingResult.error());
+    }
+    const UploadStagingSpan staging = stagingResult.value();
+    VkCommandBuffer commandBuffer = staging.commandBuffer;
+    // Cooked textures are copied straight from their file mapping; this is the only CPU copy.
+    std::memcpy(staging.mapped, pixels.data() + sourceOffset, static_cast<size_t>(uploadSize));
 
     VkImageMemoryBarrier toTransferBarrier{};
     toTransferBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -1434,7 +2445,7 @@ Result<std::uint32_t> Vulkan::upload_texture(const TextureData& textureData)
     toTransferBarrier.image = texture.image;
     toTransferBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     toTransferBarrier.subresourceRange.baseMipLevel = 0;
-    toTransferBarrier.subresourceRange.levelCount = 1;
+    toTransferBarrier.subresourceRange.levelCount = mipLevels;
     toTransferBarrier.subresourceRange.baseArrayLayer = 0;
     toTransferBarrier.subresourceRange.layerCount = 1;
     toTransferBarrier.srcAccessMask = 0;
@@ -1453,23 +2464,28 @@ Result<std::uint32_t> Vulkan::upload_texture(const TextureData& textureData)
         &toTransferBarrier
     );
 
-    VkBufferImageCopy copyRegion{};
-    copyRegion.bufferOffset = 0;
-    copyRegion.bufferRowLength = 0;
-    copyRegion.bufferImageHeight = 0;
-    copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    copyRegion.imageSubresource.mipLevel = 0;
-    copyRegion.imageSubresource.baseArrayLayer = 0;
-    copyRegion.imageSubresource.layerCount = 1;
-    copyRegion.imageOffset = {0, 0, 0};
-    copyRegion.imageExtent = {textureData.width, textureData.height, 1};
+    // Every level lives in the same staging span; level offsets are multiples of the block size.
+    std::vector<VkBufferImageCopy> copyRegions(uploaded.size());
+    for (std::size_t level = 0; level < uploaded.size(); ++level)
+    {
+        VkBufferImageCopy& copyRegion = copyRegions[level];
+        copyRegion.bufferOffset = staging.offset + (uploaded[level].offset - sourceOffset);
+        copyRegion.bufferRowLength = 0;
+        copyRegion.bufferImageHeight = 0;
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.mipLevel = static_cast<std::uint32_t>(level);
+        copyRegion.imageSubresource.baseArrayLayer = 0;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageOffset = {0, 0, 0};
+        copyRegion.imageExtent = {uploaded[level].extent.width, uploaded[level].extent.height, 1};
+    }
     vkCmdCopyBufferToImage(
         commandBuffer,
-        m_uploadStagingBuffer,
+        staging.buffer,
         texture.image,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &copyRegion
+        static_cast<std::uint32_t>(copyRegions.size()),
+        copyRegions.data()
     );
 
     VkImageMemoryBarrier toShaderReadBarrier = toTransferBarrier;
@@ -1478,10 +2494,18 @@ Result<std::uint32_t> Vulkan::upload_texture(const TextureData& textureData)
     toShaderReadBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     toShaderReadBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
+    // A dedicated transfer queue cannot name the fragment stage; draw_frame() waits for its batches.
+    VkPipelineStageFlags shaderReadStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    if (m_vulkanDevice.has_dedicated_transfer_queue())
+    {
+        toShaderReadBarrier.dstAccessMask = 0;
+        shaderReadStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    }
+
     vkCmdPipelineBarrier(
         commandBuffer,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        shaderReadStage,
         0,
         0,
         nullptr,
@@ -1490,57 +2514,107 @@ Result<std::uint32_t> Vulkan::upload_texture(const TextureData& textureData)
         1,
         &toShaderReadBarrier
     );
+    texture.width = uploaded.front().extent.width;
+    texture.height = uploaded.front().extent.height;
+    texture.allocationBytes = texture.allocation.size;
+    m_textureMemoryBytes += static_cast<std::uint64_t>(texture.allocationBytes);
+    return texture;
+}
 
-    if (auto endResult = m_vulkanDevice.end_single_time_commands(commandBuffer); !endResult)
-    {
-        vkDestroyImage(device, texture.image, nullptr);
-        vkFreeMemory(device, texture.memory, nullptr);
-        return make_error("Failed to submit texture upload command buffer", ErrorCode::VulkanTextureUploadFailed);
-    }
-
-    auto viewResult = m_vulkanDevice.create_image_view(texture.image, format, VK_IMAGE_ASPECT_COLOR_BIT);
-    if (!viewResult)
-    {
-        vkDestroyImage(device, texture.image, nullptr);
-        vkFreeMemory(device, texture.memory, nullptr);
-        return make_error(viewResult.error());
-    }
-    texture.imageView = viewResult.value();
-    texture.width = textureData.width;
-    texture.height = textureData.height;
-    texture.allocationBytes = textureAllocationBytes;
+void Vulkan::destroy_texture_image(GpuTexture& texture) noexcept
+{
+    if (texture.image == nullptr)
+        return;
+    if (texture.imageView != nullptr)
+        vkDestroyImageView(m_vulkanDevice.get_device(), texture.imageView, nullptr);
+    m_vulkanDevice.destroy_image(texture.image, texture.allocation);
+    m_textureMemoryBytes -= std::min<std::uint64_t>(m_textureMemoryBytes, texture.allocationBytes);
+    texture = {};
+}
 
-    std::uint32_t textureIndex = static_cast<std::uint32_t>(m_textures.size());
-    m_textures.push_back(texture);
-    m_textureMemoryBytes += static_cast<std::uint64_t>(texture.allocationBytes);
-    if (!textureData.sourcePath.empty())
-        m_textureLookup.emplace(textureData.sourcePath.generic_string(), textureIndex);
-    return textureIndex;
+void Vulkan::write_texture_descriptor(std::size_t frameIndex, std::uint32_t textureIndex) noexcept
+{
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = m_textures[textureIndex].imageView;
+    imageInfo.sampler = m_sampler;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = m_materialDescriptorSets[frameIndex];
+    write.dstBinding = 0;
+    write.dstArrayElement = textureIndex;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.descriptorCount = 1;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(m_vulkanDevice.get_device(), 1, &write, 0, nullptr);
 }
 
 
-Result<> Vulkan::create_descriptor_pool()
+Result<> Vulkan::create_material_descriptors()
 {
     VkDevice device = m_vulkanDevice.get_device();
+    const std::uint32_t maxTextures = m_vulkanDevice.get_max_bindless_textures();
 
-    // Pool sized for up to 256 materials, each needing 5 combined image samplers
-    constexpr std::uint32_t maxMaterials{256};
-
-    VkDescriptorPoolSize poolSize{};
-    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSize.descriptorCount = maxMaterials * 5;
+    // One set per frame in flight: every texture is an element of binding 0, every material a record in binding 1.
+    // The sets only differ while a streamed texture's new image is being swapped in frame by frame.
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = maxTextures * MAX_FRAMES_IN_FLIGHT;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[1].descriptorCount = MAX_FRAMES_IN_FLIGHT;
 
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = 1;
-    poolInfo.pPoolSizes = &poolSize;
-    poolInfo.maxSets = maxMaterials;
+    poolInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
 
     if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
     {
         return make_error("Failed to create descriptor pool", ErrorCode::VulkanTextureUploadFailed);
     }
 
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts{};
+    layouts.fill(m_pipeline.get_descriptor_set_layout());
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = static_cast<std::uint32_t>(layouts.size());
+    allocInfo.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, m_materialDescriptorSets.data()) != VK_SUCCESS)
+    {
+        return make_error("Failed to allocate bindless material descriptor sets", ErrorCode::VulkanTextureUploadFailed);
+    }
+
+    constexpr VkDeviceSize materialBufferSize = sizeof(GpuMaterial) * MaxMaterials;
+    if (auto result = m_vulkanDevice.create_buffer(
+            materialBufferSize,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_materialBuffer,
+            m_materialMemory
+        );
+        !result)
+        return make_error(result.error());
+
+    if (vkMapMemory(device, m_materialMemory, 0, materialBufferSize, 0, &m_materialMapped) != VK_SUCCESS)
+        return make_error("Failed to map material buffer memory", ErrorCode::VulkanMemoryAllocationFailed);
+
+    VkDescriptorBufferInfo bufferInfo{m_materialBuffer, 0, VK_WHOLE_SIZE};
+    std::array<VkWriteDescriptorSet, MAX_FRAMES_IN_FLIGHT> writes{};
+    for (std::size_t i = 0; i < writes.size(); ++i)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = m_materialDescriptorSets[i];
+        writes[i].dstBinding = 1;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfo;
+    }
+    vkUpdateDescriptorSets(device, static_cast<std::uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
     return {};
 }
 
@@ -1549,9 +2623,9 @@ Result<> Vulkan::create_default_material()
     auto result = upload_material(
         m_defaultAlbedoTextureIndex,
         m_defaultNormalTextureIndex,
-        m_defaultRoughnessTextureIndex,
-        m_defaultMetallicTextureIndex,
-        m_defaultAOTextureIndex
+        m_defaultOrmTextureIndex,
+        m_defaultOrmTextureIndex,
+        m_defaultOrmTextureIndex
     );
     if (!result)
         return make_error(result.error());
@@ -1584,48 +2658,19 @@ Result<std::uint32_t> Vulkan::upload_material(
     if (const auto it = m_materialLookup.find(key64); it != m_materialLookup.end())
         return it->second;
 
-    VkDevice device = m_vulkanDevice.get_device();
-
-    VkDescriptorSetLayout layout = m_pipeline.get_descriptor_set_layout();
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = m_descriptorPool;
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &layout;
+    if (m_materials.size() >= MaxMaterials)
+        return make_error(fmt::format("Material capacity ({}) exceeded", MaxMaterials), ErrorCode::VulkanTextureUploadFailed);
 
     GpuMaterial material{};
-    if (vkAllocateDescriptorSets(device, &allocInfo, &material.descriptorSet) != VK_SUCCESS)
-    {
-        return make_error("Failed to allocate descriptor set for material", ErrorCode::VulkanTextureUploadFailed);
-    }
+    material.albedoTexture = albedoTextureIndex;
+    material.normalTexture = normalTextureIndex;
+    material.roughnessTexture = roughnessTextureIndex;
+    material.metallicTexture = metallicTextureIndex;
+    material.aoTexture = aoTextureIndex;
+    material.packedOrm = roughnessTextureIndex == metallicTextureIndex && metallicTextureIndex == aoTextureIndex ? 1u : 0u;
 
-    // Write descriptor set: binding 0=albedo, 1=normal, 2=roughness, 3=metallic, 4=AO
-    const std::uint32_t texIndices[5] {
-        albedoTextureIndex,
-        normalTextureIndex,
-        roughnessTextureIndex,
-        metallicTextureIndex,
-        aoTextureIndex 
-    };
-    std::array<VkDescriptorImageInfo, 5> imageInfos{};
-    std::array<VkWriteDescriptorSet, 5> descriptorWrites{};
-
-    for (std::uint32_t i = 0; i < 5; ++i)
-    {
-        imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfos[i].imageView = m_textures[texIndices[i]].imageView;
-        imageInfos[i].sampler = m_sampler;
-
-        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[i].dstSet = material.descriptorSet;
-        descriptorWrites[i].dstBinding = i;
-        descriptorWrites[i].dstArrayElement = 0;
-        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrites[i].descriptorCount = 1;
-        descriptorWrites[i].pImageInfo = &imageInfos[i];
-    }
-
-    vkUpdateDescriptorSets(device, static_cast<std::uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+    // Records past the current count are never read by in-flight frames, so the coherent mapping is written directly.
+    std::memcpy(static_cast<GpuMaterial*>(m_materialMapped) + m_materials.size(), &material, sizeof(GpuMaterial));
 
     std::uint32_t materialIndex = static_cast<std::uint32_t>(m_materials.size());
     m_materials.push_back(material);
@@ -1636,8 +2681,20 @@ Result<std::uint32_t> Vulkan::upload_material(
 void Vulkan::compute_scene_render_size()
 {
     VkExtent2D swapExtent = m_swapchain.get_extent();
-    m_sceneRenderWidth = std::max(1u, static_cast<std::uint32_t>(swapExtent.width * m_renderScale));
-    m_sceneRenderHeight = std::max(1u, static_cast<std::uint32_t>(swapExtent.height * m_renderScale));
+    // Dynamic resolution allocates for its largest scale once and only moves the viewport inside that.
+    const float targetScale = m_dynamicResolutionEnabled ? dynamic_resolution_range().second : m_renderScale;
+    m_sceneTargetWidth = std::max(1u, static_cast<std::uint32_t>(swapExtent.width * targetScale));
+    m_sceneTargetHeight = std::max(1u, static_cast<std::uint32_t>(swapExtent.height * targetScale));
+    apply_scene_render_scale(m_dynamicResolutionEnabled ? m_dynamicResolutionScale : targetScale);
+}
+
+void Vulkan::apply_scene_render_scale(float scale) noexcept
+{
+    VkExtent2D swapExtent = m_swapchain.get_extent();
+    m_sceneRenderWidth =
+        std::clamp(static_cast<std::uint32_t>(swapExtent.width * scale), 1u, m_sceneTargetWidth);
+    m_sceneRenderHeight =
+        std::clamp(static_cast<std::uint32_t>(swapExtent.height * scale), 1u, m_sceneTargetHeight);
 }
 
 Result<VkFormat> Vulkan::find_depth_format()
@@ -1701,8 +2758,18 @@ VkSampleCountFlagBits Vulkan::get_max_usable_sample_count() const noexcept
 }
 
 Result<> Vulkan::create_scene_render_pass()
+{
+    auto renderPassResult = create_compatible_scene_render_pass(m_msaaSamples);
+    if (!renderPassResult)
+        return make_error(renderPassResult.error());
+    m_sceneRenderPass = renderPassResult.value();
+    return {};
+}
+
+Result<VkRenderPass> Vulkan::create_compatible_scene_render_pass(VkSampleCountFlagBits samples)
 {
     VkDevice device = m_vulkanDevice.get_device();
+    VkRenderPass renderPass{};
     VkFormat colorFormat = m_swapchain.get_format();
 
     auto depthFormatResult = find_depth_format();
@@ -1710,16 +2777,22 @@ Result<> Vulkan::create_scene_render_pass()
         return make_error(depthFormatResult.error());
     VkFormat depthFormat = depthFormatResult.value();
 
-    if (m_msaaSamples != VK_SAMPLE_COUNT_1_BIT)
+    // Occlusion culling reads the depth after the pass; otherwise it never leaves tile memory.
+    const VkAttachmentStoreOp depthStoreOp =
+        m_occlusionCullingEnabled ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    const VkImageLayout depthFinalLayout = m_occlusionCullingEnabled ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+                                                                     : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    if (samples != VK_SAMPLE_COUNT_1_BIT)
     {
         // 0: MSAA color (samples=N, CLEAR, storeOp=DONT_CARE)
-        // 1: MSAA depth (samples=N, CLEAR, storeOp=DONT_CARE)
+        // 1: MSAA depth (samples=N, CLEAR, stored for the Hi-Z build with occlusion culling)
         // 2: Resolve color (samples=1, storeOp=STORE, finalLayout=TRANSFER_SRC)
         std::array<VkAttachmentDescription, 3> attachments{};
 
         // MSAA color
         attachments[0].format = colorFormat;
-        attachments[0].samples = m_msaaSamples;
+        attachments[0].samples = samples;
         attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
         attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
@@ -1729,13 +2802,13 @@ Result<> Vulkan::create_scene_render_pass()
 
         // MSAA depth
         attachments[1].format = depthFormat;
-        attachments[1].samples = m_msaaSamples;
+        attachments[1].samples = samples;
         attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[1].storeOp = depthStoreOp;
         attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        attachments[1].finalLayout = depthFinalLayout;
 
         // Resolve color (1x sample)
         attachments[2].format = colorFormat;
@@ -1775,7 +2848,7 @@ Result<> Vulkan::create_scene_render_pass()
         renderPassInfo.dependencyCount = 1;
         renderPassInfo.pDependencies = &dependency;
 
-        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_sceneRenderPass) != VK_SUCCESS)
+        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
         {
             return make_error("Failed to create scene render pass (MSAA)", ErrorCode::VulkanRenderPassCreationFailed);
         }
@@ -1784,7 +2857,7 @@ Result<> Vulkan::create_scene_render_pass()
     {
         // Non-MSAA render pass
         // 0: Color (samples=1, CLEAR, STORE, finalLayout=SHADER_READ_ONLY)
-        // 1: Depth (samples=1, CLEAR)
+        // 1: Depth (samples=1, CLEAR, stored for the Hi-Z build with occlusion culling)
         std::array<VkAttachmentDescription, 2> attachments{};
 
         // Color
@@ -1801,11 +2874,11 @@ Result<> Vulkan::create_scene_render_pass()
         attachments[1].format = depthFormat;
         attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
         attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        attachments[1].storeOp = depthStoreOp;
         attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         attachments[1].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        attachments[1].finalLayout = depthFinalLayout;
 
         VkAttachmentReference colorRef{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
         VkAttachmentReference depthRef{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
@@ -1833,13 +2906,63 @@ Result<> Vulkan::create_scene_render_pass()
         renderPassInfo.dependencyCount = 1;
         renderPassInfo.pDependencies = &dependency;
 
-        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_sceneRenderPass) != VK_SUCCESS)
+        if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS)
         {
             return make_error("Failed to create scene render pass", ErrorCode::VulkanRenderPassCreationFailed);
         }
     }
 
-    return {};
+    return renderPass;
+}
+
+void Vulkan::prewarm_pipeline_variants()
+{
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(m_vulkanDevice.get_physical_device(), &properties);
+    VkPhysicalDeviceFeatures features{};
+    vkGetPhysicalDeviceFeatures(m_vulkanDevice.get_physical_device(), &features);
+
+    const VkSampleCountFlags supportedCounts =
+        properties.limits.framebufferColorSampleCounts & properties.limits.framebufferDepthSampleCounts;
+
+    // Every combination Graphics Settings can select: 1x/2x/4x/8x, A2C on/off, sample shading on/off,
+    // for the current depth prepass mode.
+    std::vector<PipelineVariantRequest> requests{};
+    for (VkSampleCountFlagBits samples : {VK_SAMPLE_COUNT_1_BIT, VK_SAMPLE_COUNT_2_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_8_BIT})
+    {
+        if ((supportedCounts & samples) == 0)
+            continue;
+
+        for (bool sampleShading : {false, true})
+        {
+            if (sampleShading && !features.sampleRateShading)
+                continue;
+
+            for (bool alphaToCoverage : {false, true})
+            {
+                // One temporary pass per variant; the pipeline destroys each once its variant is built.
+                auto renderPassResult = create_compatible_scene_render_pass(samples);
+                if (!renderPassResult)
+                {
+                    fmt::print("Warning: failed to prewarm pipeline variants: {}\n", renderPassResult.error().message);
+                    m_pipeline.prewarm_variants(std::move(requests));
+                    return;
+                }
+                requests.push_back(PipelineVariantRequest{
+                    renderPassResult.value(),
+                    MultisampleConfig{samples, alphaToCoverage, sampleShading, m_minSampleShading,
+                                      m_depthPrepassEnabled},
+                });
+            }
+        }
+    }
+    m_pipeline.prewarm_variants(std::move(requests));
+}
+
+MultisampleConfig Vulkan::scene_pipeline_config() const noexcept
+{
+    return MultisampleConfig{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading,
+                             m_depthPrepassEnabled};
 }
 
 Result<> Vulkan::create_scene_render_target()
@@ -1858,8 +2981,8 @@ Result<> Vulkan::create_scene_render_target()
     // Resolve/final color image (1x sample), sampled by ImGui viewport.
     VkDeviceSize sceneColorAllocBytes = 0;
     if (auto res = m_vulkanDevice.create_image(
-        m_sceneRenderWidth,
-        m_sceneRenderHeight,
+        m_sceneTargetWidth,
+        m_sceneTargetHeight,
         colorFormat,
         VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
@@ -1877,18 +3000,33 @@ Result<> Vulkan::create_scene_render_target()
         return make_error(colorViewResult.error());
     m_sceneColorView = colorViewResult.value();
 
-    // Create depth image (at MSAA sample count)
+    // Create depth image (at MSAA sample count); sampled by the Hi-Z build with occlusion culling.
+    // Without it the depth is never stored (storeOp DONT_CARE) and can stay in tile memory.
     VkDeviceSize sceneDepthAllocBytes = 0;
-    if (auto res = m_vulkanDevice.create_image(
-        m_sceneRenderWidth,
-        m_sceneRenderHeight,
+    if (m_occlusionCullingEnabled)
+    {
+        if (auto res = m_vulkanDevice.create_image(
+            m_sceneTargetWidth,
+            m_sceneTargetHeight,
+            depthFormat,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            m_sceneDepthImage,
+            m_sceneDepthMemory,
+            m_msaaSamples,
+            &sceneDepthAllocBytes
+        ); !res)
+            return res;
+    }
+    else if (auto res = m_vulkanDevice.create_transient_attachment(
+        m_sceneTargetWidth,
+        m_sceneTargetHeight,
         depthFormat,
-        VK_IMAGE_TILING_OPTIMAL,
         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_msaaSamples,
         m_sceneDepthImage,
         m_sceneDepthMemory,
-        m_msaaSamples,
         &sceneDepthAllocBytes
     ); !res)
         return res;
@@ -1899,20 +3037,18 @@ Result<> Vulkan::create_scene_render_target()
         return make_error(depthViewResult.error());
     m_sceneDepthView = depthViewResult.value();
 
-    // If MSAA, create MSAA color image
+    // If MSAA, create MSAA color image; only its resolve is stored.
     if (m_msaaSamples != VK_SAMPLE_COUNT_1_BIT)
     {
         VkDeviceSize msaaColorAllocBytes{};
-        if (auto res = m_vulkanDevice.create_image(
-            m_sceneRenderWidth,
-            m_sceneRenderHeight,
+        if (auto res = m_vulkanDevice.create_transient_attachment(
+            m_sceneTargetWidth,
+            m_sceneTargetHeight,
             colorFormat,
-            VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+            m_msaaSamples,
             m_msaaColorImage,
             m_msaaColorMemory,
-            m_msaaSamples,
             &msaaColorAllocBytes
         ); !res)
             return res;
@@ -1941,8 +3077,8 @@ Result<> Vulkan::create_scene_render_target()
     fbInfo.renderPass = m_sceneRenderPass;
     fbInfo.attachmentCount = static_cast<uint32_t>(fbAttachments.size());
     fbInfo.pAttachments = fbAttachments.data();
-    fbInfo.width = m_sceneRenderWidth;
-    fbInfo.height = m_sceneRenderHeight;
+    fbInfo.width = m_sceneTargetWidth;
+    fbInfo.height = m_sceneTargetHeight;
     fbInfo.layers = 1;
 
     if (vkCreateFramebuffer(device, &fbInfo, nullptr, &m_sceneFramebuffer) != VK_SUCCESS)
@@ -2192,10 +3328,10 @@ Result<> Vulkan::create_nis_resources()
     if (vkCreateSampler(device, &samplerInfo, nullptr, &m_nisLinearSampler) != VK_SUCCESS)
         return make_error("Failed to create NIS linear sampler", ErrorCode::VulkanGraphicsPipelineCreationFailed);
 
-    // Config UBO (host-visible, persistently mapped)
+    // Config UBO (host-visible; rewritten in the command buffer when dynamic resolution moves the viewport)
     if (auto res = m_vulkanDevice.create_buffer(
         sizeof(NISConfig),
-        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
         m_nisConfigBuffer,
         m_nisConfigMemory
@@ -2359,7 +3495,7 @@ Result<> Vulkan::create_nis_resources()
 
     fmt::print(
         "NIS: compute pipeline created ({}x{}, sharpness={:.2f})\n",
-        m_sceneRenderWidth, m_sceneRenderHeight, m_nisSharpness
+        m_sceneTargetWidth, m_sceneTargetHeight, m_nisSharpness
     );
 
     return {};
@@ -2410,12 +3546,12 @@ void Vulkan::cleanup_nis_resources()
     { vkDestroySampler(device, m_nisLinearSampler, nullptr); m_nisLinearSampler = nullptr; }
 }
 
-void Vulkan::update_nis_config()
+void Vulkan::update_nis_config(VkCommandBuffer cmd)
 {
     NISConfig config{};
     VkExtent2D swapExtent = m_swapchain.get_extent();
     
-    // NIS upscaling mode: input is render resolution, output is swapchain (viewport) resolution
+    // NIS upscaling mode: input is the rendered viewport inside the scene target, output is swapchain resolution
     const bool configValid = NVScalerUpdateConfig(
         config,
         m_nisSharpness,
@@ -2423,8 +3559,8 @@ void Vulkan::update_nis_config()
         0,
         m_sceneRenderWidth,
         m_sceneRenderHeight,
-        m_sceneRenderWidth,
-        m_sceneRenderHeight,
+        m_sceneTargetWidth,
+        m_sceneTargetHeight,
         0,
         0,
         swapExtent.width,
@@ -2433,25 +3569,50 @@ void Vulkan::update_nis_config()
         swapExtent.height,
         NISHDRMode::None
     );
+    m_nisConfigWidth = m_sceneRenderWidth;
+    m_nisConfigHeight = m_sceneRenderHeight;
 
     if (!configValid)
     {
         fmt::print(
             "Warning: NIS config is invalid for render scale {:.2f}. "
             "NIS upscaling supports only 0.50..1.00 scale factors.\n",
-            m_renderScale
+            static_cast<float>(m_sceneRenderWidth) / static_cast<float>(std::max(1u, swapExtent.width))
         );
         return;
     }
 
-    // Upload to UBO
-    VkDevice device = m_vulkanDevice.get_device();
-    void* mapped{};
-    if (vkMapMemory(device, m_nisConfigMemory, 0, sizeof(NISConfig), 0, &mapped) == VK_SUCCESS)
+    if (cmd == nullptr)
     {
-        std::memcpy(mapped, &config, sizeof(NISConfig));
-        vkUnmapMemory(device, m_nisConfigMemory);
+        // Upload to UBO
+        VkDevice device = m_vulkanDevice.get_device();
+        void* mapped{};
+        if (vkMapMemory(device, m_nisConfigMemory, 0, sizeof(NISConfig), 0, &mapped) == VK_SUCCESS)
+        {
+            std::memcpy(mapped, &config, sizeof(NISConfig));
+            vkUnmapMemory(device, m_nisConfigMemory);
+        }
+        return;
     }
+
+    // Earlier frames may still be reading the UBO, so the update is ordered on the GPU instead of written from the host.
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = m_nisConfigBuffer;
+    barrier.size = VK_WHOLE_SIZE;
+    barrier.srcAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1,
+                         &barrier, 0, nullptr);
+
+    vkCmdUpdateBuffer(cmd, m_nisConfigBuffer, 0, sizeof(NISConfig), &config);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_UNIFORM_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1,
+                         &barrier, 0, nullptr);
 }
 
 void Vulkan::dispatch_nis_pass(VkCommandBuffer cmd)
@@ -2459,6 +3620,9 @@ void Vulkan::dispatch_nis_pass(VkCommandBuffer cmd)
     if (m_nisComputePipeline == nullptr || m_nisDescriptorSet == nullptr)
         return;
 
+    if (m_nisConfigWidth != m_sceneRenderWidth || m_nisConfigHeight != m_sceneRenderHeight)
+        update_nis_config(cmd);
+
     // Transition scene color from COLOR_ATTACHMENT_OUTPUT to SHADER_READ for compute input
     {
         VkImageMemoryBarrier barrier{};
@@ -2570,292 +3734,3094 @@ VkImageView Vulkan::get_active_scene_view() const noexcept
     return m_sceneColorView;
 }
 
-/// Runtime settings
+/// Hi-Z occlusion pyramid
 
-void Vulkan::set_vsync(KHR_Settings mode) noexcept
+Result<> Vulkan::create_hiz_resources()
 {
-    VkPresentModeKHR requestedMode = VK_PRESENT_MODE_FIFO_KHR;
-    switch (mode)
+    VkDevice device = m_vulkanDevice.get_device();
+
+    auto depthFormatResult = find_depth_format();
+    if (!depthFormatResult)
+        return make_error(depthFormatResult.error());
+    VkFormatProperties depthProperties{};
+    vkGetPhysicalDeviceFormatProperties(m_vulkanDevice.get_physical_device(), depthFormatResult.value(), &depthProperties);
+    if ((depthProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == 0)
+        return make_error("Depth format cannot be sampled for the Hi-Z build", ErrorCode::VulkanFeatureNotSupported);
+
+    const bool multisampled = m_msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+    if (m_hiZComputeSpirv.empty())
     {
-    case KHR_Settings::VSync:
-        requestedMode = VK_PRESENT_MODE_FIFO_KHR;
-        break;
-    case KHR_Settings::Triple_Buffering:
-        requestedMode = VK_PRESENT_MODE_MAILBOX_KHR;
-        break;
-    case KHR_Settings::Immediate:
-        requestedMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
-        break;
-    default:
-        requestedMode = VK_PRESENT_MODE_FIFO_KHR;
-        break;
+        auto compResult = ShaderCompiler::load_compute_with_includes(m_hiZShaderPath, {m_hiZShaderPath.parent_path()},
+                                                                     m_shaderLoadMode);
+        if (!compResult)
+            return make_error(compResult.error());
+        m_hiZComputeSpirv = std::move(compResult.value());
     }
-
-    const VkPresentModeKHR currentMode = m_swapchain.get_present_mode();
-    if (currentMode == requestedMode)
+    if (multisampled && m_hiZMultisampleComputeSpirv.empty())
     {
-        m_vsyncEnabled = (currentMode == VK_PRESENT_MODE_FIFO_KHR || currentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR);
-        return;
+        auto compResult = ShaderCompiler::load_compute_with_includes(
+            m_hiZMultisampleShaderPath, {m_hiZMultisampleShaderPath.parent_path()}, m_shaderLoadMode);
+        if (!compResult)
+            return make_error(compResult.error());
+        m_hiZMultisampleComputeSpirv = std::move(compResult.value());
     }
 
-    const bool previousVsync = m_vsyncEnabled;
-    m_swapchain.set_desired_present_mode(requestedMode);
+    // Level 0 is half the scene target, so every level is a 2x2 max of the one above it.
+    m_hiZWidth = std::max(1u, (m_sceneTargetWidth + 1) / 2);
+    m_hiZHeight = std::max(1u, (m_sceneTargetHeight + 1) / 2);
+    m_hiZMipCount = 1;
+    for (std::uint32_t size = std::max(m_hiZWidth, m_hiZHeight); size > 1; size = (size + 1) / 2)
+        ++m_hiZMipCount;
 
-    VkDevice device = m_vulkanDevice.get_device();
-    vkDeviceWaitIdle(device);
+    VkDeviceSize hiZAllocBytes{};
+    if (auto res = m_vulkanDevice.create_image(
+        m_hiZWidth,
+        m_hiZHeight,
+        VK_FORMAT_R32_SFLOAT,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_hiZImage,
+        m_hiZMemory,
+        VK_SAMPLE_COUNT_1_BIT,
+        &hiZAllocBytes,
+        m_hiZMipCount
+    ); !res)
+        return res;
+    m_hiZMemoryBytes = static_cast<std::uint64_t>(hiZAllocBytes);
 
-    if (auto result = recreate_swap_chain(); !result)
+    auto viewResult = m_vulkanDevice.create_image_view(m_hiZImage, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT,
+                                                       m_hiZMipCount);
+    if (!viewResult)
+        return make_error(viewResult.error());
+    m_hiZView = viewResult.value();
+
+    m_hiZMipViews.assign(m_hiZMipCount, nullptr);
+    for (std::uint32_t level = 0; level < m_hiZMipCount; ++level)
     {
-        fmt::print("Warning: failed to apply present mode change: {}\n", result.error().message);
-        m_vsyncEnabled = previousVsync;
-        // Fall back to deferred recreate retry on next frame.
-        m_framebufferResized = true;
-        return;
+        VkImageViewCreateInfo mipViewInfo{};
+        mipViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        mipViewInfo.image = m_hiZImage;
+        mipViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        mipViewInfo.format = VK_FORMAT_R32_SFLOAT;
+        mipViewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, 1};
+        if (vkCreateImageView(device, &mipViewInfo, nullptr, &m_hiZMipViews[level]) != VK_SUCCESS)
+            return make_error("Failed to create Hi-Z mip view", ErrorCode::VulkanImageViewCreationFailed);
     }
 
-    const VkPresentModeKHR appliedMode = m_swapchain.get_present_mode();
-    m_vsyncEnabled = (appliedMode == VK_PRESENT_MODE_FIFO_KHR || appliedMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR);
-}
-
-bool Vulkan::get_vsync() const noexcept
-{
-    const VkPresentModeKHR mode = m_swapchain.get_present_mode();
-    return (mode == VK_PRESENT_MODE_FIFO_KHR || mode == VK_PRESENT_MODE_FIFO_RELAXED_KHR);
-}
+    // Nearest clamp sampler; cull.comp and the build only use texelFetch, but a combined sampler needs one.
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_hiZSampler) != VK_SUCCESS)
+        return make_error("Failed to create Hi-Z sampler", ErrorCode::VulkanGraphicsPipelineCreationFailed);
 
-void Vulkan::set_msaa_samples(std::int32_t samples) noexcept
-{
-    VkSampleCountFlagBits desired = VK_SAMPLE_COUNT_1_BIT;
-    switch (samples)
-    {
-    case 2:
-        desired = VK_SAMPLE_COUNT_2_BIT;
-        break;
-    case 4:
-        desired = VK_SAMPLE_COUNT_4_BIT;
-        break;
-    case 8:
-        desired = VK_SAMPLE_COUNT_8_BIT;
-        break;
-    default:
-        desired = VK_SAMPLE_COUNT_1_BIT;
-        break;
-    }
+    // Bindings match hiz.comp / hiz_ms.comp:
+    // 0: source depth (scene depth or the previous level)    1: destination level
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0] = {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+    bindings[1] = {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
 
-    VkSampleCountFlagBits maxSamples = get_max_usable_sample_count();
-    if (desired > maxSamples)
-        desired = maxSamples;
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<std::uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_hiZDescriptorSetLayout) != VK_SUCCESS)
+        return make_error("Failed to create Hi-Z descriptor set layout", ErrorCode::VulkanGraphicsPipelineCreationFailed);
 
-    if (desired == m_msaaSamples)
-        return;
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0] = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, m_hiZMipCount};
+    poolSizes[1] = {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, m_hiZMipCount};
 
-    const VkSampleCountFlagBits previous = m_msaaSamples;
-    VkDevice device = m_vulkanDevice.get_device();
-    vkDeviceWaitIdle(device);
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = m_hiZMipCount;
+    poolInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_hiZDescriptorPool) != VK_SUCCESS)
+        return make_error("Failed to create Hi-Z descriptor pool", ErrorCode::VulkanGraphicsPipelineCreationFailed);
 
-    auto rebuild_for_msaa = [&](VkSampleCountFlagBits targetSamples) -> Result<> {
-        m_msaaSamples = targetSamples;
-        if (m_nisEnabled)
-            cleanup_nis_resources();
-        cleanup_scene_render_target();
-        cleanup_scene_render_pass();
-        m_pipeline.cleanup();
+    std::vector<VkDescriptorSetLayout> setLayouts(m_hiZMipCount, m_hiZDescriptorSetLayout);
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_hiZDescriptorPool;
+    allocInfo.descriptorSetCount = m_hiZMipCount;
+    allocInfo.pSetLayouts = setLayouts.data();
+    m_hiZDescriptorSets.assign(m_hiZMipCount, nullptr);
+    if (vkAllocateDescriptorSets(device, &allocInfo, m_hiZDescriptorSets.data()) != VK_SUCCESS)
+    {
+        m_hiZDescriptorSets.clear();
+        return make_error("Failed to allocate Hi-Z descriptor sets", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+    }
 
-        if (auto result = create_scene_render_pass(); !result)
-            return result;
-        compute_scene_render_size();
-        if (auto result = create_scene_render_target(); !result)
-            return result;
-        
-        if (m_nisEnabled)
-        {
-            if (auto nisResult = create_nis_resources(); !nisResult)
-                fmt::print("Warning: failed to recreate NIS resources after MSAA change: {}\n", nisResult.error().message);
-        }
+    std::vector<VkDescriptorImageInfo> sourceInfos(m_hiZMipCount);
+    std::vector<VkDescriptorImageInfo> destinationInfos(m_hiZMipCount);
+    std::vector<VkWriteDescriptorSet> writes(static_cast<std::size_t>(m_hiZMipCount) * 2);
+    for (std::uint32_t level = 0; level < m_hiZMipCount; ++level)
+    {
+        sourceInfos[level] = level == 0
+                                 ? VkDescriptorImageInfo{m_hiZSampler, m_sceneDepthView,
+                                                         VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL}
+                                 : VkDescriptorImageInfo{m_hiZSampler, m_hiZMipViews[level - 1], VK_IMAGE_LAYOUT_GENERAL};
+        destinationInfos[level] = {nullptr, m_hiZMipViews[level], VK_IMAGE_LAYOUT_GENERAL};
+
+        VkWriteDescriptorSet& sourceWrite = writes[static_cast<std::size_t>(level) * 2];
+        sourceWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        sourceWrite.dstSet = m_hiZDescriptorSets[level];
+        sourceWrite.dstBinding = 0;
+        sourceWrite.descriptorCount = 1;
+        sourceWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        sourceWrite.pImageInfo = &sourceInfos[level];
+
+        VkWriteDescriptorSet& destinationWrite = writes[static_cast<std::size_t>(level) * 2 + 1];
+        destinationWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        destinationWrite.dstSet = m_hiZDescriptorSets[level];
+        destinationWrite.dstBinding = 1;
+        destinationWrite.descriptorCount = 1;
+        destinationWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        destinationWrite.pImageInfo = &destinationInfos[level];
+    }
+    vkUpdateDescriptorSets(device, static_cast<std::uint32_t>(writes.size()), writes.data(), 0, nullptr);
 
-        MultisampleConfig msConfig{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
-        return m_pipeline.initialize(m_sceneRenderPass, msConfig, m_vertSpirv, m_fragSpirv);
+    // Both variants share the layout; only hiz_ms.comp reads the sample count.
+    VkPushConstantRange pushRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(HiZPushConstants)};
+    VkPipelineLayoutCreateInfo pipeLayoutInfo{};
+    pipeLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeLayoutInfo.setLayoutCount = 1;
+    pipeLayoutInfo.pSetLayouts = &m_hiZDescriptorSetLayout;
+    pipeLayoutInfo.pushConstantRangeCount = 1;
+    pipeLayoutInfo.pPushConstantRanges = &pushRange;
+    if (vkCreatePipelineLayout(device, &pipeLayoutInfo, nullptr, &m_hiZPipelineLayout) != VK_SUCCESS)
+        return make_error("Failed to create Hi-Z pipeline layout", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    auto createPipeline = [&](const std::vector<std::uint32_t>& spirv, VkPipeline& pipeline) -> Result<> {
+        VkShaderModuleCreateInfo moduleInfo{};
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = spirv.size() * sizeof(std::uint32_t);
+        moduleInfo.pCode = spirv.data();
+
+        VkShaderModule computeModule{};
+        if (vkCreateShaderModule(device, &moduleInfo, nullptr, &computeModule) != VK_SUCCESS)
+            return make_error("Failed to create Hi-Z compute shader module", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+        VkComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = computeModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = m_hiZPipelineLayout;
+
+        const VkResult result = vkCreateComputePipelines(device, nullptr, 1, &pipelineInfo, nullptr, &pipeline);
+        vkDestroyShaderModule(device, computeModule, nullptr);
+        if (result != VK_SUCCESS)
+            return make_error("Failed to create Hi-Z compute pipeline", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+        return {};
     };
 
-    if (auto result = rebuild_for_msaa(desired); !result)
+    if (auto res = createPipeline(m_hiZComputeSpirv, m_hiZPipeline); !res)
+        return res;
+    if (multisampled)
     {
-        fmt::print("Warning: failed to apply MSAA setting: {}\n", result.error().message);
-        if (auto rollback = rebuild_for_msaa(previous); !rollback)
-        {
-            fmt::print("Warning: failed to restore previous MSAA state: {}\n", rollback.error().message);
-            if (auto recreate = recreate_swap_chain(); !recreate)
-            {
-                fmt::print("Warning: failed to recover after MSAA setting failure: {}\n", recreate.error().message);
-                m_framebufferResized = true;
-            }
-        }
+        if (auto res = createPipeline(m_hiZMultisampleComputeSpirv, m_hiZMultisamplePipeline); !res)
+            return res;
     }
-    else
+
+    // The CPU culling path reads back the first level that fits in HiZReadbackMaxSize per side.
+    m_hiZReadbackLevel = 0;
+    while (m_hiZReadbackLevel + 1 < m_hiZMipCount &&
+           (hiz_level_size(m_hiZWidth, m_hiZReadbackLevel) > HiZReadbackMaxSize ||
+            hiz_level_size(m_hiZHeight, m_hiZReadbackLevel) > HiZReadbackMaxSize))
+        ++m_hiZReadbackLevel;
+
+    const VkDeviceSize readbackSize = sizeof(float) * hiz_level_size(m_hiZWidth, m_hiZReadbackLevel) *
+                                      hiz_level_size(m_hiZHeight, m_hiZReadbackLevel);
+    m_hiZReadbackMemoryBytes = 0;
+    for (HiZReadback& readback : m_hiZReadbacks)
     {
-        if (m_swapchainRecreatedCallback)
-            m_swapchainRecreatedCallback();
+        VkDeviceSize readbackAllocBytes{};
+        if (auto res = m_vulkanDevice.create_buffer(
+            readbackSize,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            readback.buffer,
+            readback.memory,
+            &readbackAllocBytes
+        ); !res)
+            return res;
+        m_hiZReadbackMemoryBytes += static_cast<std::uint64_t>(readbackAllocBytes);
+
+        if (vkMapMemory(device, readback.memory, 0, readbackSize, 0, &readback.mapped) != VK_SUCCESS)
+            return make_error("Failed to map Hi-Z readback buffer", ErrorCode::VulkanMemoryAllocationFailed);
+        readback.pending = false;
     }
-}
 
-std::int32_t Vulkan::get_msaa_samples() const noexcept
-{
-    return static_cast<std::int32_t>(m_msaaSamples);
+    m_hiZValid = false;
+    m_occlusionCuller.clear();
+
+    fmt::print("Hi-Z: pyramid created ({}x{}, {} levels, readback level {})\n", m_hiZWidth, m_hiZHeight, m_hiZMipCount,
+               m_hiZReadbackLevel);
+
+    return {};
 }
 
-void Vulkan::set_alpha_to_coverage(bool enabled) noexcept
+void Vulkan::cleanup_hiz_resources()
 {
-    if (enabled == m_alphaToCoverageEnabled)
-        return;
-    m_alphaToCoverageEnabled = enabled;
-
-    // Pipeline-only rebuild (no render pass / framebuffer change)
     VkDevice device = m_vulkanDevice.get_device();
-    vkDeviceWaitIdle(device);
-    m_pipeline.cleanup();
-    MultisampleConfig msConfig{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
-    if (auto result = m_pipeline.initialize(m_sceneRenderPass, msConfig, m_vertSpirv, m_fragSpirv); !result)
+    if (!device) return;
+
+    for (HiZReadback& readback : m_hiZReadbacks)
     {
-        fmt::print("Warning: failed to apply alpha-to-coverage setting: {}\n", result.error().message);
-        m_alphaToCoverageEnabled = !enabled;
-        m_pipeline.cleanup();
-        MultisampleConfig rollback{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
-        (void)m_pipeline.initialize(m_sceneRenderPass, rollback, m_vertSpirv, m_fragSpirv);
+        if (readback.mapped != nullptr)
+        { vkUnmapMemory(device, readback.memory); readback.mapped = nullptr; }
+        if (readback.buffer != nullptr)
+        { vkDestroyBuffer(device, readback.buffer, nullptr); readback.buffer = nullptr; }
+        if (readback.memory != nullptr)
+        { vkFreeMemory(device, readback.memory, nullptr); readback.memory = nullptr; }
+        readback.pending = false;
     }
+    m_hiZReadbackMemoryBytes = 0;
+
+    if (m_hiZPipeline != nullptr)
+    { vkDestroyPipeline(device, m_hiZPipeline, nullptr); m_hiZPipeline = nullptr; }
+    if (m_hiZMultisamplePipeline != nullptr)
+    { vkDestroyPipeline(device, m_hiZMultisamplePipeline, nullptr); m_hiZMultisamplePipeline = nullptr; }
+    if (m_hiZPipelineLayout != nullptr)
+    { vkDestroyPipelineLayout(device, m_hiZPipelineLayout, nullptr); m_hiZPipelineLayout = nullptr; }
+    if (m_hiZDescriptorPool != nullptr)
+    { vkDestroyDescriptorPool(device, m_hiZDescriptorPool, nullptr); m_hiZDescriptorPool = nullptr; }
+    m_hiZDescriptorSets.clear(); // freed with pool
+    if (m_hiZDescriptorSetLayout != nullptr)
+    { vkDestroyDescriptorSetLayout(device, m_hiZDescriptorSetLayout, nullptr); m_hiZDescriptorSetLayout = nullptr; }
+    if (m_hiZSampler != nullptr)
+    { vkDestroySampler(device, m_hiZSampler, nullptr); m_hiZSampler = nullptr; }
+
+    for (VkImageView mipView : m_hiZMipViews)
+    {
+        if (mipView != nullptr)
+            vkDestroyImageView(device, mipView, nullptr);
+    }
+    m_hiZMipViews.clear();
+    if (m_hiZView != nullptr)
+    { vkDestroyImageView(device, m_hiZView, nullptr); m_hiZView = nullptr; }
+    if (m_hiZImage != nullptr)
+    { vkDestroyImage(device, m_hiZImage, nullptr); m_hiZImage = nullptr; }
+    if (m_hiZMemory != nullptr)
+    { vkFreeMemory(device, m_hiZMemory, nullptr); m_hiZMemory = nullptr; }
+    m_hiZMemoryBytes = 0;
+    m_hiZMipCount = 0;
+
+    // Cull descriptor sets still point at the destroyed view; rebind on the next dispatch.
+    for (GpuCullFrame& frame : m_gpuCullFrames)
+        frame.boundHiZView = nullptr;
+    m_hiZValid = false;
+    m_occlusionCuller.clear();
 }
 
-bool Vulkan::get_alpha_to_coverage() const noexcept
-{
-    return m_alphaToCoverageEnabled;
-}
-
-void Vulkan::set_sample_shading(bool enabled) noexcept
+void Vulkan::dispatch_hiz_pass(VkCommandBuffer cmd, const XMFLOAT4X4& viewProj, bool readback)
 {
-    if (enabled == m_sampleShadingEnabled)
+    if (m_hiZPipeline == nullptr || m_hiZDescriptorSets.size() != m_hiZMipCount || m_hiZMipCount == 0)
+        return;
+    const bool multisampled = m_msaaSamples != VK_SAMPLE_COUNT_1_BIT;
+    if (multisampled && m_hiZMultisamplePipeline == nullptr)
         return;
-    m_sampleShadingEnabled = enabled;
 
-    VkDevice device = m_vulkanDevice.get_device();
-    vkDeviceWaitIdle(device);
-    m_pipeline.cleanup();
-    MultisampleConfig msConfig{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
-    if (auto result = m_pipeline.initialize(m_sceneRenderPass, msConfig, m_vertSpirv, m_fragSpirv); !result)
+    // Scene depth writes before sampling; the previous build's readers before the pyramid is discarded.
     {
-        fmt::print("Warning: failed to apply sample shading setting: {}\n", result.error().message);
-        m_sampleShadingEnabled = !enabled;
-        m_pipeline.cleanup();
-        MultisampleConfig rollback{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
-        (void)m_pipeline.initialize(m_sceneRenderPass, rollback, m_vertSpirv, m_fragSpirv);
-    }
-}
-
-bool Vulkan::get_sample_shading() const noexcept
-{
-    return m_sampleShadingEnabled;
-}
+        VkMemoryBarrier depthBarrier{};
+        depthBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        depthBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+        VkImageMemoryBarrier pyramidBarrier{};
+        pyramidBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        pyramidBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        pyramidBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        pyramidBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        pyramidBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        pyramidBarrier.image = m_hiZImage;
+        pyramidBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, m_hiZMipCount, 0, 1};
+        pyramidBarrier.srcAccessMask = 0;
+        pyramidBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            1,
+            &depthBarrier,
+            0,
+            nullptr,
+            1,
+            &pyramidBarrier
+        );
+    }
+
+    for (std::uint32_t level = 0; level < m_hiZMipCount; ++level)
+    {
+        if (level > 0)
+        {
+            VkImageMemoryBarrier levelBarrier{};
+            levelBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            levelBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+            levelBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            levelBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            levelBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            levelBarrier.image = m_hiZImage;
+            levelBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 1, 0, 1};
+            levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0,
+                                 nullptr, 0, nullptr, 1, &levelBarrier);
+        }
+
+        const bool fromMultisampledDepth = level == 0 && multisampled;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          fromMultisampledDepth ? m_hiZMultisamplePipeline : m_hiZPipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_hiZPipelineLayout, 0, 1,
+                                &m_hiZDescriptorSets[level], 0, nullptr);
+        HiZPushConstants pushConstants{};
+        pushConstants.sampleCount = static_cast<std::uint32_t>(m_msaaSamples);
+        // Only level 0 reads scene depth, which is valid inside the viewport the scene pass rendered.
+        constexpr auto Unclamped = static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::max());
+        pushConstants.sourceMaxX = level == 0 ? m_sceneRenderWidth - 1 : Unclamped;
+        pushConstants.sourceMaxY = level == 0 ? m_sceneRenderHeight - 1 : Unclamped;
+        vkCmdPushConstants(cmd, m_hiZPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(HiZPushConstants),
+                           &pushConstants);
+
+        const std::uint32_t width = hiz_level_size(m_hiZWidth, level);
+        const std::uint32_t height = hiz_level_size(m_hiZHeight, level);
+        vkCmdDispatch(cmd, (width + 7) / 8, (height + 7) / 8, 1);
+    }
+
+    // Later cull dispatches and the readback copy read the pyramid, and the next scene pass must not
+    // clear the depth before this build has read it.
+    {
+        VkMemoryBarrier pyramidBarrier{};
+        pyramidBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        pyramidBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        pyramidBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(
+            cmd,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT |
+                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            0,
+            1,
+            &pyramidBarrier,
+            0,
+            nullptr,
+            0,
+            nullptr
+        );
+    }
+
+    HiZReadback& frameReadback = m_hiZReadbacks[m_currentFrame];
+    if (readback && frameReadback.buffer != nullptr)
+    {
+        VkBufferImageCopy region{};
+        region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, m_hiZReadbackLevel, 0, 1};
+        region.imageExtent = {hiz_level_size(m_hiZWidth, m_hiZReadbackLevel),
+                              hiz_level_size(m_hiZHeight, m_hiZReadbackLevel), 1};
+        vkCmdCopyImageToBuffer(cmd, m_hiZImage, VK_IMAGE_LAYOUT_GENERAL, frameReadback.buffer, 1, &region);
+
+        VkBufferMemoryBarrier hostBarrier{};
+        hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        hostBarrier.buffer = frameReadback.buffer;
+        hostBarrier.size = VK_WHOLE_SIZE;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1,
+                             &hostBarrier, 0, nullptr);
+
+        frameReadback.viewProj = viewProj;
+        frameReadback.viewportWidth = m_sceneRenderWidth;
+        frameReadback.viewportHeight = m_sceneRenderHeight;
+        frameReadback.pending = true;
+    }
+    else
+    {
+        frameReadback.pending = false;
+    }
+
+    m_hiZViewProj = viewProj;
+    m_hiZViewportWidth = m_sceneRenderWidth;
+    m_hiZViewportHeight = m_sceneRenderHeight;
+    m_hiZValid = true;
+}
+
+/// GPU-driven culling
+
+Result<> Vulkan::create_gpu_cull_resources()
+{
+    VkDevice device = m_vulkanDevice.get_device();
+
+    if (!m_vulkanDevice.supports_indirect_first_instance())
+        return make_error("GPU culling requires the drawIndirectFirstInstance device feature",
+                          ErrorCode::VulkanFeatureNotSupported);
+
+    if (m_cullComputeSpirv.empty())
+    {
+        auto compResult = ShaderCompiler::load_compute_with_includes(m_cullShaderPath, {m_cullShaderPath.parent_path()},
+                                                                     m_shaderLoadMode);
+        if (!compResult)
+            return make_error(compResult.error());
+        m_cullComputeSpirv = std::move(compResult.value());
+    }
+
+    // Bindings match cull.comp:
+    // 0: cull inputs    1: instance slots    2: visible slots    3: indirect draw commands    4: counters
+    // 5: Hi-Z pyramid   6: occlusion params      7: material screen sizes
+    constexpr std::uint32_t storageBindingCount{6};
+    std::array<VkDescriptorSetLayoutBinding, 8> bindings{};
+    for (std::uint32_t i = 0; i < 5; ++i)
+        bindings[i] = {i, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+    bindings[5] = {5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+    bindings[6] = {6, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+    bindings[7] = {7, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr};
+
+    // The pyramid only exists while occlusion culling is on; cull.comp skips it when mipCount is 0.
+    std::array<VkDescriptorBindingFlagsEXT, 8> bindingFlags{};
+    bindingFlags[5] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlagsInfo.bindingCount = static_cast<std::uint32_t>(bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.bindingCount = static_cast<std::uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_cullDescriptorSetLayout) != VK_SUCCESS)
+        return make_error("Failed to create cull descriptor set layout", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    poolSizes[0] = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, storageBindingCount * MAX_FRAMES_IN_FLIGHT};
+    poolSizes[1] = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_FRAMES_IN_FLIGHT};
+    poolSizes[2] = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    poolInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_cullDescriptorPool) != VK_SUCCESS)
+        return make_error("Failed to create cull descriptor pool", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> setLayouts{};
+    setLayouts.fill(m_cullDescriptorSetLayout);
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> sets{};
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_cullDescriptorPool;
+    allocInfo.descriptorSetCount = static_cast<std::uint32_t>(setLayouts.size());
+    allocInfo.pSetLayouts = setLayouts.data();
+    if (vkAllocateDescriptorSets(device, &allocInfo, sets.data()) != VK_SUCCESS)
+        return make_error("Failed to allocate cull descriptor sets", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+        m_gpuCullFrames[i].descriptorSet = sets[i];
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = m_cullComputeSpirv.size() * sizeof(uint32_t);
+    moduleInfo.pCode = m_cullComputeSpirv.data();
+
+    VkShaderModule computeModule{};
+    if (vkCreateShaderModule(device, &moduleInfo, nullptr, &computeModule) != VK_SUCCESS)
+        return make_error("Failed to create cull compute shader module", ErrorCode::VulkanShaderModuleCreationFailed);
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = computeModule;
+    stageInfo.pName = "main";
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(GpuCullPushConstants);
+
+    VkPipelineLayoutCreateInfo pipeLayoutInfo{};
+    pipeLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeLayoutInfo.setLayoutCount = 1;
+    pipeLayoutInfo.pSetLayouts = &m_cullDescriptorSetLayout;
+    pipeLayoutInfo.pushConstantRangeCount = 1;
+    pipeLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipeLayoutInfo, nullptr, &m_cullPipelineLayout) != VK_SUCCESS)
+    {
+        vkDestroyShaderModule(device, computeModule, nullptr);
+        return make_error("Failed to create cull pipeline layout", ErrorCode::VulkanGraphicsPipelineLayoutCreationFailed);
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = stageInfo;
+    pipelineInfo.layout = m_cullPipelineLayout;
+
+    if (vkCreateComputePipelines(device, nullptr, 1, &pipelineInfo, nullptr, &m_cullComputePipeline) != VK_SUCCESS)
+    {
+        vkDestroyShaderModule(device, computeModule, nullptr);
+        return make_error("Failed to create cull compute pipeline", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+    }
+
+    vkDestroyShaderModule(device, computeModule, nullptr);
+
+    m_gpuCullInputsDirty = true;
+    fmt::print("GPU culling: compute pipeline created (indirect count: {})\n",
+               m_vulkanDevice.get_cmd_draw_indexed_indirect_count() != nullptr ? "yes" : "no");
+
+    return {};
+}
+
+void Vulkan::cleanup_gpu_cull_resources()
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    if (!device) return;
+
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        cleanup_gpu_cull_frame(i);
+        m_gpuCullFrames[i].descriptorSet = nullptr; // freed with pool
+    }
+
+    if (m_cullComputePipeline != nullptr)
+    { vkDestroyPipeline(device, m_cullComputePipeline, nullptr); m_cullComputePipeline = nullptr; }
+    if (m_cullPipelineLayout != nullptr)
+    { vkDestroyPipelineLayout(device, m_cullPipelineLayout, nullptr); m_cullPipelineLayout = nullptr; }
+    if (m_cullDescriptorPool != nullptr)
+    { vkDestroyDescriptorPool(device, m_cullDescriptorPool, nullptr); m_cullDescriptorPool = nullptr; }
+    if (m_cullDescriptorSetLayout != nullptr)
+    { vkDestroyDescriptorSetLayout(device, m_cullDescriptorSetLayout, nullptr); m_cullDescriptorSetLayout = nullptr; }
+
+    m_gpuCullInstances.clear();
+    m_gpuCullBatches.clear();
+    m_gpuCullDrawTemplate.clear();
+    m_gpuCullRuns.clear();
+    m_gpuCullBatchOrder.clear();
+    m_gpuCullInputsDirty = true;
+    m_gpuCullOrderDirty = true;
+}
+
+void Vulkan::cleanup_gpu_cull_frame(std::size_t frameIndex) noexcept
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    GpuCullFrame& frame = m_gpuCullFrames[frameIndex];
+    if (device)
+    {
+        auto destroy = [device](VkBuffer& buffer, VkDeviceMemory& memory, void** mapped) {
+            if (mapped != nullptr && *mapped != nullptr && memory != nullptr)
+            { vkUnmapMemory(device, memory); *mapped = nullptr; }
+            if (buffer != nullptr)
+            { vkDestroyBuffer(device, buffer, nullptr); buffer = nullptr; }
+            if (memory != nullptr)
+            { vkFreeMemory(device, memory, nullptr); memory = nullptr; }
+        };
+        destroy(frame.inputBuffer, frame.inputMemory, &frame.inputMapped);
+        destroy(frame.outputBuffer, frame.outputMemory, nullptr);
+        destroy(frame.drawBuffer, frame.drawMemory, &frame.drawMapped);
+        destroy(frame.countBuffer, frame.countMemory, &frame.countMapped);
+        destroy(frame.occlusionBuffer, frame.occlusionMemory, &frame.occlusionMapped);
+        destroy(frame.feedbackBuffer, frame.feedbackMemory, &frame.feedbackMapped);
+    }
+
+    m_gpuCullHostMemoryBytes -= std::min<std::uint64_t>(m_gpuCullHostMemoryBytes, frame.hostAllocatedBytes);
+    m_gpuCullDeviceMemoryBytes -= std::min<std::uint64_t>(m_gpuCullDeviceMemoryBytes, frame.deviceAllocatedBytes);
+    frame.hostAllocatedBytes = 0;
+    frame.deviceAllocatedBytes = 0;
+    frame.instanceCapacity = 0;
+    frame.batchCapacity = 0;
+    frame.uploadedInputVersion = 0;
+    frame.boundSlotBuffer = nullptr;
+    frame.boundHiZView = nullptr;
+    frame.statsPending = false;
+}
+
+Result<> Vulkan::ensure_gpu_cull_frame_capacity(std::size_t frameIndex, std::size_t instanceCount, std::size_t outputCount,
+                                                std::size_t batchCount)
+{
+    GpuCullFrame& frame = m_gpuCullFrames[frameIndex];
+    if (instanceCount <= frame.instanceCapacity && outputCount <= frame.outputCapacity &&
+        batchCount <= frame.batchCapacity && frame.inputBuffer != nullptr)
+        return {};
+
+    // Grow geometrically to avoid frequent reallocations.
+    std::size_t newInstanceCapacity = std::max<std::size_t>(instanceCount, 256);
+    std::size_t newOutputCapacity = std::max<std::size_t>(outputCount, 256);
+    std::size_t newBatchCapacity = std::max<std::size_t>(batchCount, 64);
+    if (frame.instanceCapacity > 0)
+    {
+        newInstanceCapacity = std::max(newInstanceCapacity, frame.instanceCapacity * 2);
+        newOutputCapacity = std::max(newOutputCapacity, frame.outputCapacity * 2);
+        newBatchCapacity = std::max(newBatchCapacity, frame.batchCapacity * 2);
+    }
+
+    const VkDescriptorSet descriptorSet = frame.descriptorSet;
+    cleanup_gpu_cull_frame(frameIndex);
+    frame.descriptorSet = descriptorSet;
+
+    VkDevice device = m_vulkanDevice.get_device();
+    constexpr VkMemoryPropertyFlags hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    auto createBuffer = [&](VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                            VkBuffer& buffer, VkDeviceMemory& memory, void** mapped) -> Result<> {
+        VkDeviceSize allocatedBytes{};
+        if (auto result = m_vulkanDevice.create_buffer(size, usage, properties, buffer, memory, &allocatedBytes); !result)
+            return result;
+
+        if (mapped != nullptr)
+        {
+            if (vkMapMemory(device, memory, 0, size, 0, mapped) != VK_SUCCESS)
+                return make_error("Failed to map GPU cull buffer memory", ErrorCode::VulkanMemoryAllocationFailed);
+            frame.hostAllocatedBytes += allocatedBytes;
+        }
+        else
+        {
+            frame.deviceAllocatedBytes += allocatedBytes;
+        }
+        return {};
+    };
+
+    const VkDeviceSize inputSize = sizeof(GpuCullInstance) * newInstanceCapacity;
+    const VkDeviceSize outputSize = sizeof(std::uint32_t) * newOutputCapacity;
+    const VkDeviceSize drawSize = sizeof(VkDrawIndexedIndirectCommand) * newBatchCapacity;
+    const VkDeviceSize countSize = sizeof(std::uint32_t) * (3 + newBatchCapacity);
+
+    Result<> createResult = createBuffer(inputSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostVisible, frame.inputBuffer,
+                                         frame.inputMemory, &frame.inputMapped);
+    if (createResult)
+        createResult = createBuffer(outputSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.outputBuffer, frame.outputMemory, nullptr);
+    if (createResult)
+        createResult = createBuffer(drawSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                    hostVisible, frame.drawBuffer, frame.drawMemory, &frame.drawMapped);
+    if (createResult)
+        createResult = createBuffer(countSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+                                    hostVisible, frame.countBuffer, frame.countMemory, &frame.countMapped);
+    if (createResult)
+        createResult = createBuffer(sizeof(GpuOcclusionParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, hostVisible,
+                                    frame.occlusionBuffer, frame.occlusionMemory, &frame.occlusionMapped);
+    if (createResult)
+        createResult = createBuffer(sizeof(std::uint32_t) * MaxMaterials, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostVisible,
+                                    frame.feedbackBuffer, frame.feedbackMemory, &frame.feedbackMapped);
+
+    m_gpuCullHostMemoryBytes += frame.hostAllocatedBytes;
+    m_gpuCullDeviceMemoryBytes += frame.deviceAllocatedBytes;
+
+    if (!createResult)
+    {
+        cleanup_gpu_cull_frame(frameIndex);
+        frame.descriptorSet = descriptorSet;
+        return createResult;
+    }
+
+    frame.instanceCapacity = newInstanceCapacity;
+    frame.outputCapacity = newOutputCapacity;
+    frame.batchCapacity = newBatchCapacity;
+
+    // Binding 1 (instance slots) is owned by the instance frame and binding 5 (Hi-Z) by the scene
+    // target; both are written in dispatch_gpu_cull_pass().
+    std::array<VkDescriptorBufferInfo, 6> bufferInfos{};
+    bufferInfos[0] = {frame.inputBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[1] = {frame.outputBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[2] = {frame.drawBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[3] = {frame.countBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[4] = {frame.occlusionBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[5] = {frame.feedbackBuffer, 0, VK_WHOLE_SIZE};
+    constexpr std::array<std::uint32_t, 6> dstBindings{0, 2, 3, 4, 6, 7};
+
+    std::array<VkWriteDescriptorSet, 6> writes{};
+    for (std::uint32_t i = 0; i < writes.size(); ++i)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = frame.descriptorSet;
+        writes[i].dstBinding = dstBindings[i];
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = dstBindings[i] == 6 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    return {};
+}
+
+void Vulkan::rebuild_gpu_cull_inputs()
+{
+    m_gpuCullInstances.clear();
+    m_gpuCullBatches.clear();
+    m_gpuCullDrawTemplate.clear();
+    m_gpuCullRuns.clear();
+    m_gpuCullInstances.reserve(m_drawItems.size());
+    m_gpuCullOutputCount = 0;
+
+    // m_drawItems is in draw-key order (mesh first), so each mesh is a contiguous run. Every LOD of the
+    // run gets its own batch and a visible-slot slice big enough for the whole run, since cull.comp
+    // may pick any level for any instance.
+    for (std::size_t runBegin = 0; runBegin < m_drawItems.size();)
+    {
+        const std::uint32_t meshIndex = m_drawItems[runBegin].meshIndex;
+        std::size_t runEnd = runBegin + 1;
+        while (runEnd < m_drawItems.size() && m_drawItems[runEnd].meshIndex == meshIndex)
+            ++runEnd;
+
+        const Mesh* mesh = meshIndex < m_meshes.size() ? &m_meshes[meshIndex] : nullptr;
+        if (mesh == nullptr || !mesh->geometry.is_valid())
+        {
+            runBegin = runEnd;
+            continue;
+        }
+
+        const auto runCount = static_cast<std::uint32_t>(runEnd - runBegin);
+        const auto firstBatch = static_cast<std::uint32_t>(m_gpuCullBatches.size());
+        m_gpuCullRuns.push_back(GpuCullRun{static_cast<std::uint32_t>(runBegin), runCount, firstBatch, mesh->lodCount});
+        for (std::uint32_t lod = 0; lod < mesh->lodCount; ++lod)
+        {
+            m_gpuCullBatches.push_back(
+                InstanceBatch{
+                    meshIndex,
+                    lod,
+                    static_cast<std::uint32_t>(m_gpuCullOutputCount),
+                    runCount
+                }
+            );
+            m_gpuCullOutputCount += runCount;
+        }
+
+        GpuCullInstance instance{};
+        instance.boundingSphere = {mesh->boundsCenter.x, mesh->boundsCenter.y, mesh->boundsCenter.z, mesh->boundsRadius};
+        instance.batchIndex = firstBatch;
+        instance.lodCount = mesh->lodCount;
+        instance.lodErrors = {mesh->lods[0].error, mesh->lods[1].error, mesh->lods[2].error, mesh->lods[3].error};
+        for (std::size_t drawIndex = runBegin; drawIndex < runEnd; ++drawIndex)
+        {
+            instance.slot = m_drawItems[drawIndex].slot;
+            m_gpuCullInstances.push_back(instance);
+        }
+        runBegin = runEnd;
+    }
+
+    m_gpuCullDrawTemplate.reserve(m_gpuCullBatches.size());
+    for (const auto& batch : m_gpuCullBatches)
+    {
+        const Mesh& mesh = m_meshes[batch.meshIndex];
+        const MeshLod& lod = mesh.lods[batch.lodLevel];
+        VkDrawIndexedIndirectCommand command{};
+        command.indexCount = lod.indexCount;
+        command.instanceCount = 0; // incremented by cull.comp
+        command.firstIndex = mesh.geometry.firstIndex + lod.firstIndex;
+        command.vertexOffset = static_cast<std::int32_t>(mesh.geometry.firstVertex);
+        command.firstInstance = batch.firstInstance;
+        m_gpuCullDrawTemplate.push_back(command);
+    }
+
+    ++m_gpuCullInputVersion;
+    m_gpuCullInputsDirty = false;
+    m_gpuCullOrderDirty = true;
+}
+
+void Vulkan::update_gpu_cull_batch_order(FXMVECTOR cameraPosition)
+{
+    const XMVECTOR lastPosition = XMLoadFloat3(&m_gpuCullOrderCameraPosition);
+    if (!m_gpuCullOrderDirty &&
+        XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(cameraPosition, lastPosition))) <
+            GpuCullReorderDistance * GpuCullReorderDistance)
+    {
+        return;
+    }
+    XMStoreFloat3(&m_gpuCullOrderCameraPosition, cameraPosition);
+    m_gpuCullOrderDirty = false;
+
+    // The per-frame LOD split is only known on the GPU, so every batch of a run is ordered by the
+    // run's nearest instance, as the CPU path orders its batches; ties keep draw-key order.
+    // m_cullSpheresScratch is parallel to m_drawItems and holds the live world-space spheres.
+    m_gpuCullBatchNearest.assign(m_gpuCullBatches.size(), 0.0f);
+    for (const GpuCullRun& run : m_gpuCullRuns)
+    {
+        float nearest = std::numeric_limits<float>::max();
+        for (std::uint32_t i = 0; i < run.drawItemCount; ++i)
+        {
+            const XMFLOAT4& sphere = m_cullSpheresScratch[run.firstDrawItem + i];
+            const float distance =
+                XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat4(&sphere), cameraPosition)));
+            nearest = std::min(nearest, distance - sphere.w);
+        }
+        std::fill_n(m_gpuCullBatchNearest.begin() + run.firstBatch, run.batchCount, nearest);
+    }
+
+    m_gpuCullBatchOrder.resize(m_gpuCullBatches.size());
+    std::iota(m_gpuCullBatchOrder.begin(), m_gpuCullBatchOrder.end(), 0u);
+    std::stable_sort(m_gpuCullBatchOrder.begin(), m_gpuCullBatchOrder.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return m_gpuCullBatchNearest[a] < m_gpuCullBatchNearest[b];
+    });
+}
+
+Result<> Vulkan::dispatch_gpu_cull_pass(VkCommandBuffer cmd, const XMFLOAT4X4& viewProj)
+{
+    GpuCullFrame& frame = m_gpuCullFrames[m_currentFrame];
+
+    // The in-flight fence for this frame has been waited on, so the counters written by
+    // its previous submission are complete. Stats therefore lag MAX_FRAMES_IN_FLIGHT frames.
+    if (frame.statsPending && frame.countMapped != nullptr)
+    {
+        const auto* counters = static_cast<const std::uint32_t*>(frame.countMapped);
+        m_lastVisibleRenderableCount = counters[0];
+        m_lastCulledRenderableCount = counters[1];
+        m_lastOccludedRenderableCount = counters[2];
+    }
+    // Texture streaming reads the on-screen sizes from the same submission, so they lag as well.
+    m_materialScreenPixels.assign(m_materials.size(), 0u);
+    if (frame.statsPending && frame.feedbackMapped != nullptr)
+    {
+        const auto* materialPixels = static_cast<const std::uint32_t*>(frame.feedbackMapped);
+        std::copy_n(materialPixels, std::min<std::size_t>(m_materialScreenPixels.size(), MaxMaterials),
+                    m_materialScreenPixels.begin());
+    }
+    frame.statsPending = false;
+
+    if (m_gpuCullInputsDirty)
+        rebuild_gpu_cull_inputs();
+
+    m_lastInstancedBatchCount = static_cast<std::uint32_t>(m_gpuCullBatches.size());
+    if (m_gpuCullInstances.empty())
+    {
+        m_lastVisibleRenderableCount = 0;
+        m_lastCulledRenderableCount = 0;
+        m_lastOccludedRenderableCount = 0;
+        return {};
+    }
+
+    if (auto result = ensure_gpu_cull_frame_capacity(m_currentFrame, m_gpuCullInstances.size(), m_gpuCullOutputCount,
+                                                     m_gpuCullBatches.size());
+        !result)
+        return result;
+
+    // Transforms are read from the persistent instance slots, which may have been reallocated.
+    const InstanceFrame& instanceFrame = m_instanceFrames[m_currentFrame];
+    if (frame.boundSlotBuffer != instanceFrame.slotBuffer)
+    {
+        VkDescriptorBufferInfo slotInfo{instanceFrame.slotBuffer, 0, VK_WHOLE_SIZE};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = frame.descriptorSet;
+        write.dstBinding = 1;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &slotInfo;
+        vkUpdateDescriptorSets(m_vulkanDevice.get_device(), 1, &write, 0, nullptr);
+        frame.boundSlotBuffer = instanceFrame.slotBuffer;
+    }
+
+    // The pyramid is recreated with the scene target; until the first build it is left unread.
+    const bool useOcclusion = m_occlusionCullingEnabled && m_hiZValid && m_hiZView != nullptr;
+    if (useOcclusion && frame.boundHiZView != m_hiZView)
+    {
+        VkDescriptorImageInfo hiZInfo{m_hiZSampler, m_hiZView, VK_IMAGE_LAYOUT_GENERAL};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = frame.descriptorSet;
+        write.dstBinding = 5;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &hiZInfo;
+        vkUpdateDescriptorSets(m_vulkanDevice.get_device(), 1, &write, 0, nullptr);
+        frame.boundHiZView = m_hiZView;
+    }
+
+    GpuOcclusionParams occlusionParams{};
+    if (useOcclusion)
+    {
+        occlusionParams.viewProj = m_hiZViewProj;
+        occlusionParams.viewportWidth = m_hiZViewportWidth;
+        occlusionParams.viewportHeight = m_hiZViewportHeight;
+        occlusionParams.mipCount = m_hiZMipCount;
+    }
+    std::memcpy(frame.occlusionMapped, &occlusionParams, sizeof(GpuOcclusionParams));
+
+    // Inputs are only re-uploaded when the draw order changed; moving entities only touch their slot.
+    if (frame.uploadedInputVersion != m_gpuCullInputVersion)
+    {
+        std::memcpy(frame.inputMapped, m_gpuCullInstances.data(), sizeof(GpuCullInstance) * m_gpuCullInstances.size());
+        frame.uploadedInputVersion = m_gpuCullInputVersion;
+    }
+
+    // Reset per-batch instance counts and counters.
+    std::memcpy(frame.drawMapped, m_gpuCullDrawTemplate.data(),
+                sizeof(VkDrawIndexedIndirectCommand) * m_gpuCullDrawTemplate.size());
+    std::memset(frame.countMapped, 0, sizeof(std::uint32_t) * (3 + m_gpuCullBatches.size()));
+    std::memset(frame.feedbackMapped, 0, sizeof(std::uint32_t) * std::min<std::size_t>(m_materials.size(), MaxMaterials));
+
+    GpuCullPushConstants pushConstants{};
+    pushConstants.viewProj = viewProj;
+    XMStoreFloat4(&pushConstants.cameraLodScale, XMMatrixInverse(nullptr, XMLoadFloat4x4(&m_viewMatrix)).r[3]);
+    pushConstants.cameraLodScale.w = lod_distance_scale();
+    pushConstants.instanceCount = static_cast<std::uint32_t>(m_gpuCullInstances.size());
+    pushConstants.pixelScale = screen_pixel_scale();
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullComputePipeline);
+    vkCmdBindDescriptorSets(
+        cmd,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        m_cullPipelineLayout,
+        0,
+        1,
+        &frame.descriptorSet,
+        0,
+        nullptr
+    );
+    vkCmdPushConstants(
+        cmd,
+        m_cullPipelineLayout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(GpuCullPushConstants),
+        &pushConstants
+    );
+
+    constexpr std::uint32_t kCullGroupSize = 64; // local_size_x in cull.comp
+    const std::uint32_t groupCount = (pushConstants.instanceCount + kCullGroupSize - 1) / kCullGroupSize;
+    vkCmdDispatch(cmd, groupCount, 1, 1);
+
+    // Compute writes -> indirect reads, instance vertex fetch and host readback of the counters.
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask =
+        VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        1,
+        &barrier,
+        0,
+        nullptr,
+        0,
+        nullptr
+    );
+
+    frame.statsPending = true;
+    return {};
+}
+
+/// Clustered lighting
+
+Result<> Vulkan::create_light_cluster_resources()
+{
+    VkDevice device = m_vulkanDevice.get_device();
+
+    if (m_clusterComputeSpirv.empty())
+    {
+        auto compResult = ShaderCompiler::load_compute_with_includes(
+            m_clusterShaderPath, {m_clusterShaderPath.parent_path()}, m_shaderLoadMode);
+        if (!compResult)
+            return make_error(compResult.error());
+        m_clusterComputeSpirv = std::move(compResult.value());
+    }
+
+    // Set 2 of the scene pipeline: 0 = lights, 1 = cluster light lists (storage), 2 = lighting params (uniform),
+    // 3 = shadow cascades (combined image sampler, written by dispatch_light_cluster_pass()).
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    poolSizes[0] = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * MAX_FRAMES_IN_FLIGHT};
+    poolSizes[1] = {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, MAX_FRAMES_IN_FLIGHT};
+    poolSizes[2] = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_FRAMES_IN_FLIGHT};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    poolInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_lightDescriptorPool) != VK_SUCCESS)
+        return make_error("Failed to create light descriptor pool", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    VkDescriptorSetLayout lightSetLayout = m_pipeline.get_light_descriptor_set_layout();
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> setLayouts{};
+    setLayouts.fill(lightSetLayout);
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> sets{};
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_lightDescriptorPool;
+    allocInfo.descriptorSetCount = static_cast<std::uint32_t>(setLayouts.size());
+    allocInfo.pSetLayouts = setLayouts.data();
+    if (vkAllocateDescriptorSets(device, &allocInfo, sets.data()) != VK_SUCCESS)
+        return make_error("Failed to allocate light descriptor sets", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    // The scene pass always reads set 2, so every frame gets its buffers up front.
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        m_lightFrames[i].descriptorSet = sets[i];
+        if (auto result = ensure_light_frame_capacity(i, m_lights.size()); !result)
+            return result;
+    }
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = m_clusterComputeSpirv.size() * sizeof(uint32_t);
+    moduleInfo.pCode = m_clusterComputeSpirv.data();
+
+    VkShaderModule computeModule{};
+    if (vkCreateShaderModule(device, &moduleInfo, nullptr, &computeModule) != VK_SUCCESS)
+        return make_error("Failed to create cluster compute shader module", ErrorCode::VulkanShaderModuleCreationFailed);
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = computeModule;
+    stageInfo.pName = "main";
+
+    // cluster.comp declares the same set 2 as shader.frag.
+    std::array<VkDescriptorSetLayout, 3> pipelineSetLayouts{m_pipeline.get_descriptor_set_layout(),
+                                                            m_pipeline.get_instance_descriptor_set_layout(),
+                                                            lightSetLayout};
+    VkPipelineLayoutCreateInfo pipeLayoutInfo{};
+    pipeLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeLayoutInfo.setLayoutCount = static_cast<std::uint32_t>(pipelineSetLayouts.size());
+    pipeLayoutInfo.pSetLayouts = pipelineSetLayouts.data();
+
+    if (vkCreatePipelineLayout(device, &pipeLayoutInfo, nullptr, &m_lightClusterPipelineLayout) != VK_SUCCESS)
+    {
+        vkDestroyShaderModule(device, computeModule, nullptr);
+        return make_error("Failed to create cluster pipeline layout", ErrorCode::VulkanGraphicsPipelineLayoutCreationFailed);
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = stageInfo;
+    pipelineInfo.layout = m_lightClusterPipelineLayout;
+
+    if (vkCreateComputePipelines(device, nullptr, 1, &pipelineInfo, nullptr, &m_lightClusterPipeline) != VK_SUCCESS)
+    {
+        vkDestroyShaderModule(device, computeModule, nullptr);
+        return make_error("Failed to create cluster compute pipeline", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+    }
+
+    vkDestroyShaderModule(device, computeModule, nullptr);
+    return {};
+}
+
+void Vulkan::cleanup_light_cluster_resources()
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    if (!device) return;
+
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        cleanup_light_frame(i);
+        m_lightFrames[i].descriptorSet = nullptr; // freed with pool
+        m_lightFrames[i].boundShadowView = nullptr;
+    }
+
+    if (m_lightClusterPipeline != nullptr)
+    { vkDestroyPipeline(device, m_lightClusterPipeline, nullptr); m_lightClusterPipeline = nullptr; }
+    if (m_lightClusterPipelineLayout != nullptr)
+    { vkDestroyPipelineLayout(device, m_lightClusterPipelineLayout, nullptr); m_lightClusterPipelineLayout = nullptr; }
+    if (m_lightDescriptorPool != nullptr)
+    { vkDestroyDescriptorPool(device, m_lightDescriptorPool, nullptr); m_lightDescriptorPool = nullptr; }
+
+    m_lights.clear();
+    m_lightDirtyFrames.clear();
+}
+
+void Vulkan::cleanup_light_frame(std::size_t frameIndex) noexcept
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    LightFrame& frame = m_lightFrames[frameIndex];
+    if (device)
+    {
+        auto destroy = [device](VkBuffer& buffer, VkDeviceMemory& memory, void** mapped) {
+            if (mapped != nullptr && *mapped != nullptr && memory != nullptr)
+            { vkUnmapMemory(device, memory); *mapped = nullptr; }
+            if (buffer != nullptr)
+            { vkDestroyBuffer(device, buffer, nullptr); buffer = nullptr; }
+            if (memory != nullptr)
+            { vkFreeMemory(device, memory, nullptr); memory = nullptr; }
+        };
+        destroy(frame.lightBuffer, frame.lightMemory, &frame.lightMapped);
+        destroy(frame.clusterBuffer, frame.clusterMemory, nullptr);
+        destroy(frame.paramsBuffer, frame.paramsMemory, &frame.paramsMapped);
+    }
+
+    m_lightHostMemoryBytes -= std::min<std::uint64_t>(m_lightHostMemoryBytes, frame.hostAllocatedBytes);
+    m_lightDeviceMemoryBytes -= std::min<std::uint64_t>(m_lightDeviceMemoryBytes, frame.deviceAllocatedBytes);
+    frame.hostAllocatedBytes = 0;
+    frame.deviceAllocatedBytes = 0;
+    frame.lightCapacity = 0;
+    frame.dirtyLights.clear();
+}
+
+Result<> Vulkan::ensure_light_frame_capacity(std::size_t frameIndex, std::size_t lightCount)
+{
+    LightFrame& frame = m_lightFrames[frameIndex];
+    if (lightCount <= frame.lightCapacity && frame.lightBuffer != nullptr)
+        return {};
+
+    // Grow geometrically; the cluster and params buffers have a fixed size but are rebuilt alongside.
+    std::size_t newLightCapacity = std::max<std::size_t>(lightCount, 64);
+    if (frame.lightCapacity > 0)
+        newLightCapacity = std::max(newLightCapacity, frame.lightCapacity * 2);
+
+    const VkDescriptorSet descriptorSet = frame.descriptorSet;
+    cleanup_light_frame(frameIndex);
+    frame.descriptorSet = descriptorSet;
+
+    VkDevice device = m_vulkanDevice.get_device();
+    constexpr VkMemoryPropertyFlags hostVisible =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    auto createBuffer = [&](VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                            VkBuffer& buffer, VkDeviceMemory& memory, void** mapped) -> Result<> {
+        VkDeviceSize allocatedBytes{};
+        if (auto result = m_vulkanDevice.create_buffer(size, usage, properties, buffer, memory, &allocatedBytes); !result)
+            return result;
+
+        if (mapped != nullptr)
+        {
+            if (vkMapMemory(device, memory, 0, size, 0, mapped) != VK_SUCCESS)
+                return make_error("Failed to map light buffer memory", ErrorCode::VulkanMemoryAllocationFailed);
+            frame.hostAllocatedBytes += allocatedBytes;
+        }
+        else
+        {
+            frame.deviceAllocatedBytes += allocatedBytes;
+        }
+        return {};
+    };
+
+    const VkDeviceSize lightSize = sizeof(GpuLight) * newLightCapacity;
+    const VkDeviceSize clusterSize = sizeof(std::uint32_t) * (ClusterCount + ClusterCount * MaxLightsPerCluster);
+
+    Result<> createResult = createBuffer(lightSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostVisible, frame.lightBuffer,
+                                         frame.lightMemory, &frame.lightMapped);
+    if (createResult)
+        createResult = createBuffer(clusterSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                    frame.clusterBuffer, frame.clusterMemory, nullptr);
+    if (createResult)
+        createResult = createBuffer(sizeof(GpuLightingParams), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, hostVisible,
+                                    frame.paramsBuffer, frame.paramsMemory, &frame.paramsMapped);
+
+    m_lightHostMemoryBytes += frame.hostAllocatedBytes;
+    m_lightDeviceMemoryBytes += frame.deviceAllocatedBytes;
+
+    if (!createResult)
+    {
+        cleanup_light_frame(frameIndex);
+        frame.descriptorSet = descriptorSet;
+        return createResult;
+    }
+
+    frame.lightCapacity = newLightCapacity;
+
+    // A fresh light buffer has no history: upload every light and drop this frame's dirty list.
+    if (!m_lights.empty())
+        std::memcpy(frame.lightMapped, m_lights.data(), sizeof(GpuLight) * m_lights.size());
+    const std::uint8_t frameBit = static_cast<std::uint8_t>(1u << frameIndex);
+    for (std::uint8_t& dirtyFrames : m_lightDirtyFrames)
+        dirtyFrames &= static_cast<std::uint8_t>(~frameBit);
+
+    std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+    bufferInfos[0] = {frame.lightBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[1] = {frame.clusterBuffer, 0, VK_WHOLE_SIZE};
+    bufferInfos[2] = {frame.paramsBuffer, 0, VK_WHOLE_SIZE};
+
+    std::array<VkWriteDescriptorSet, 3> writes{};
+    for (std::uint32_t i = 0; i < writes.size(); ++i)
+    {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = frame.descriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = i == 2 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    return {};
+}
+
+Result<> Vulkan::upload_dirty_lights(std::size_t frameIndex)
+{
+    LightFrame& frame = m_lightFrames[frameIndex];
+    if (auto result = ensure_light_frame_capacity(frameIndex, m_lights.size()); !result)
+        return result;
+    if (frame.dirtyLights.empty())
+        return {};
+
+    if (frame.lightMapped == nullptr)
+        return make_error("Light buffer is not mapped", ErrorCode::VulkanMemoryAllocationFailed);
+
+    // Same range coalescing as the instance slots; entries left over from a shrink are dropped.
+    std::sort(frame.dirtyLights.begin(), frame.dirtyLights.end());
+    frame.dirtyLights.erase(std::unique(frame.dirtyLights.begin(), frame.dirtyLights.end()), frame.dirtyLights.end());
+    auto* mapped = static_cast<GpuLight*>(frame.lightMapped);
+    const std::uint8_t frameBit = static_cast<std::uint8_t>(1u << frameIndex);
+    for (std::size_t begin = 0; begin < frame.dirtyLights.size() && frame.dirtyLights[begin] < m_lights.size();)
+    {
+        std::size_t end = begin + 1;
+        while (end < frame.dirtyLights.size() && frame.dirtyLights[end] == frame.dirtyLights[end - 1] + 1 &&
+               frame.dirtyLights[end] < m_lights.size())
+            ++end;
+
+        const std::uint32_t firstLight = frame.dirtyLights[begin];
+        std::memcpy(mapped + firstLight, m_lights.data() + firstLight, sizeof(GpuLight) * (end - begin));
+        begin = end;
+    }
+
+    for (std::uint32_t index : frame.dirtyLights)
+    {
+        if (index < m_lightDirtyFrames.size())
+            m_lightDirtyFrames[index] &= static_cast<std::uint8_t>(~frameBit);
+    }
+    frame.dirtyLights.clear();
+    return {};
+}
+
+Result<> Vulkan::dispatch_light_cluster_pass(VkCommandBuffer cmd)
+{
+    if (auto result = upload_dirty_lights(m_currentFrame); !result)
+        return result;
+
+    LightFrame& frame = m_lightFrames[m_currentFrame];
+
+    // The cascade array is recreated when its resolution or cascade count changes.
+    if (frame.boundShadowView != m_shadowArrayView)
+    {
+        VkDescriptorImageInfo shadowInfo{m_shadowSampler, m_shadowArrayView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        VkWriteDescriptorSet shadowWrite{};
+        shadowWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        shadowWrite.dstSet = frame.descriptorSet;
+        shadowWrite.dstBinding = 3;
+        shadowWrite.descriptorCount = 1;
+        shadowWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        shadowWrite.pImageInfo = &shadowInfo;
+        vkUpdateDescriptorSets(m_vulkanDevice.get_device(), 1, &shadowWrite, 0, nullptr);
+        frame.boundShadowView = m_shadowArrayView;
+    }
+
+    const auto [nearPlane, farPlane] = camera_clip_planes();
+
+    const XMMATRIX view = XMLoadFloat4x4(&m_viewMatrix);
+    GpuLightingParams params{};
+    params.view = m_viewMatrix;
+    XMStoreFloat4x4(&params.inverseProj, XMMatrixInverse(nullptr, XMLoadFloat4x4(&m_projMatrix)));
+    XMStoreFloat4(&params.cameraPosition, XMMatrixInverse(nullptr, view).r[3]);
+    XMStoreFloat4(&params.sunDirection, XMVector3Normalize(XMLoadFloat3(&m_sunDirection)));
+    params.sunColor = XMFLOAT4{m_sunColor.x, m_sunColor.y, m_sunColor.z, 0.0f};
+
+    // Slice k covers view depths near * (far / near)^(k / Z) to near * (far / near)^((k + 1) / Z).
+    const float sliceScale = static_cast<float>(ClusterGridZ) / std::log(farPlane / nearPlane);
+    params.clusterScale = XMFLOAT4{
+        static_cast<float>((m_sceneRenderWidth + ClusterGridX - 1) / ClusterGridX),
+        static_cast<float>((m_sceneRenderHeight + ClusterGridY - 1) / ClusterGridY),
+        sliceScale,
+        -std::log(nearPlane) * sliceScale
+    };
+    params.viewport = XMFLOAT4{static_cast<float>(m_sceneRenderWidth), static_cast<float>(m_sceneRenderHeight),
+                               nearPlane, farPlane};
+    params.lightCount = static_cast<std::uint32_t>(m_lights.size());
+
+    // Cascades as fitted by update_shadow_cascades() this frame, whether re-rendered or cached.
+    if (m_shadowsEnabled && m_shadowPipeline != nullptr)
+    {
+        params.shadowCascadeCount = m_shadowCascadeCount;
+        params.shadowMapTexelSize = 1.0f / static_cast<float>(m_shadowResolution);
+        for (std::uint32_t i = 0; i < m_shadowCascadeCount; ++i)
+        {
+            params.shadowSplits[i] = m_shadowCascades[i].splitFar;
+            params.shadowTexelWorldSizes[i] = m_shadowCascades[i].texelWorldSize;
+            params.shadowViewProj[i] = m_shadowCascades[i].viewProj;
+        }
+    }
+    std::memcpy(frame.paramsMapped, &params, sizeof(GpuLightingParams));
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_lightClusterPipeline);
+    vkCmdBindDescriptorSets(
+        cmd,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        m_lightClusterPipelineLayout,
+        2,
+        1,
+        &frame.descriptorSet,
+        0,
+        nullptr
+    );
+
+    constexpr std::uint32_t kClusterGroupSize = 128; // local_size_x in cluster.comp
+    vkCmdDispatch(cmd, (ClusterCount + kClusterGroupSize - 1) / kClusterGroupSize, 1, 1);
+
+    // Compute writes of the cluster light lists -> fragment shader reads in the scene pass.
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0,
+        1,
+        &barrier,
+        0,
+        nullptr,
+        0,
+        nullptr
+    );
+
+    return {};
+}
+
+std::pair<float, float> Vulkan::camera_clip_planes() const noexcept
+{
+    // The camera projection is a right-handed perspective (depth 0..1), so the planes come straight
+    // out of its depth terms; anything else falls back to the default camera range.
+    const float nearPlane = m_projMatrix._43 / m_projMatrix._33;
+    const float farPlane = m_projMatrix._43 / (m_projMatrix._33 + 1.0f);
+    if (!std::isfinite(nearPlane) || !std::isfinite(farPlane) || nearPlane <= 0.0f || farPlane <= nearPlane)
+        return {0.1f, 1000.0f};
+    return {nearPlane, farPlane};
+}
+
+/// Cascaded sun shadows
+
+Result<> Vulkan::create_shadow_resources()
+{
+    VkDevice device = m_vulkanDevice.get_device();
+
+    // The caster pass writes depth that the scene pass then samples with a compare sampler.
+    auto formatResult = find_supported_format(
+        {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D16_UNORM},
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT
+    );
+    if (!formatResult)
+        return make_error(formatResult.error());
+    m_shadowFormat = formatResult.value();
+
+    VkAttachmentDescription depthAttachment{};
+    depthAttachment.format = m_shadowFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // every pass redraws its whole layer
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentReference depthRef{0, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 0;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    // Earlier frames' shadow lookups -> depth writes, then depth writes -> this frame's lookups.
+    std::array<VkSubpassDependency, 2> dependencies{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    dependencies[0].dstStageMask =
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask =
+        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &depthAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = static_cast<std::uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies = dependencies.data();
+    if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &m_shadowRenderPass) != VK_SUCCESS)
+        return make_error("Failed to create shadow render pass", ErrorCode::VulkanRenderPassCreationFailed);
+
+    // Hardware PCF where the format can be filtered; shader.frag adds a 3x3 kernel on top.
+    VkFormatProperties formatProperties{};
+    vkGetPhysicalDeviceFormatProperties(m_vulkanDevice.get_physical_device(), m_shadowFormat, &formatProperties);
+    const bool linearFilter =
+        (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0;
+
+    // Lookups outside a cascade compare against the white border (depth 1.0) and come out lit.
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = linearFilter ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+    samplerInfo.minFilter = linearFilter ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+    samplerInfo.compareEnable = VK_TRUE;
+    samplerInfo.compareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+    samplerInfo.maxLod = 0.0f;
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_shadowSampler) != VK_SUCCESS)
+        return make_error("Failed to create shadow sampler", ErrorCode::VulkanSamplerCreationFailed);
+
+    // Casters go through the prepass's position-only vertex shader.
+    if (m_depthVertSpirv.empty())
+    {
+        auto vertResult = ShaderCompiler::load_or_compile(m_depthVertShaderPath, m_shaderLoadMode);
+        if (!vertResult)
+            return make_error(vertResult.error());
+        m_depthVertSpirv = std::move(vertResult.value());
+    }
+    auto pipelineResult = m_pipeline.create_shadow_pipeline(m_shadowRenderPass, m_depthVertSpirv);
+    if (!pipelineResult)
+        return make_error(pipelineResult.error());
+    m_shadowPipeline = pipelineResult.value();
+
+    return create_shadow_map();
+}
+
+void Vulkan::cleanup_shadow_resources()
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    if (!device) return;
+
+    cleanup_shadow_map();
+    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+        cleanup_shadow_frame(i);
+
+    if (m_shadowPipeline != nullptr)
+    { vkDestroyPipeline(device, m_shadowPipeline, nullptr); m_shadowPipeline = nullptr; }
+    if (m_shadowSampler != nullptr)
+    { vkDestroySampler(device, m_shadowSampler, nullptr); m_shadowSampler = nullptr; }
+    if (m_shadowRenderPass != nullptr)
+    { vkDestroyRenderPass(device, m_shadowRenderPass, nullptr); m_shadowRenderPass = nullptr; }
+
+    m_shadowStaticChanges.clear();
+}
+
+Result<> Vulkan::create_shadow_map()
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    const std::uint32_t layerCount = m_shadowCascadeCount;
+
+    VkDeviceSize allocatedBytes{};
+    if (auto res = m_vulkanDevice.create_image(
+        m_shadowResolution,
+        m_shadowResolution,
+        m_shadowFormat,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        m_shadowImage,
+        m_shadowMemory,
+        VK_SAMPLE_COUNT_1_BIT,
+        &allocatedBytes,
+        1,
+        layerCount
+    ); !res)
+        return res;
+    m_shadowMapMemoryBytes = static_cast<std::uint64_t>(allocatedBytes);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_shadowImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = m_shadowFormat;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, layerCount};
+    if (vkCreateImageView(device, &viewInfo, nullptr, &m_shadowArrayView) != VK_SUCCESS)
+        return make_error("Failed to create shadow map view", ErrorCode::VulkanImageViewCreationFailed);
+
+    for (std::uint32_t layer = 0; layer < layerCount; ++layer)
+    {
+        VkImageViewCreateInfo layerViewInfo = viewInfo;
+        layerViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        layerViewInfo.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, layer, 1};
+        if (vkCreateImageView(device, &layerViewInfo, nullptr, &m_shadowLayerViews[layer]) != VK_SUCCESS)
+            return make_error("Failed to create shadow cascade view", ErrorCode::VulkanImageViewCreationFailed);
+
+        VkFramebufferCreateInfo fbInfo{};
+        fbInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        fbInfo.renderPass = m_shadowRenderPass;
+        fbInfo.attachmentCount = 1;
+        fbInfo.pAttachments = &m_shadowLayerViews[layer];
+        fbInfo.width = m_shadowResolution;
+        fbInfo.height = m_shadowResolution;
+        fbInfo.layers = 1;
+        if (vkCreateFramebuffer(device, &fbInfo, nullptr, &m_shadowFramebuffers[layer]) != VK_SUCCESS)
+            return make_error("Failed to create shadow cascade framebuffer", ErrorCode::VulkanFramebufferCreationFailed);
+    }
+
+    // The scene pass samples every layer from the first frame on, rendered yet or not.
+    auto commandBufferResult = m_vulkanDevice.begin_single_time_commands();
+    if (!commandBufferResult)
+        return make_error(commandBufferResult.error());
+    VkCommandBuffer commandBuffer = commandBufferResult.value();
+
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_shadowImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, layerCount};
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &barrier);
+    if (auto result = m_vulkanDevice.end_single_time_commands(commandBuffer); !result)
+        return result;
+
+    invalidate_shadow_cascades();
+    return {};
+}
+
+void Vulkan::cleanup_shadow_map() noexcept
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    if (!device) return;
+
+    for (VkFramebuffer& framebuffer : m_shadowFramebuffers)
+    {
+        if (framebuffer != nullptr)
+        { vkDestroyFramebuffer(device, framebuffer, nullptr); framebuffer = nullptr; }
+    }
+    for (VkImageView& view : m_shadowLayerViews)
+    {
+        if (view != nullptr)
+        { vkDestroyImageView(device, view, nullptr); view = nullptr; }
+    }
+    if (m_shadowArrayView != nullptr)
+    { vkDestroyImageView(device, m_shadowArrayView, nullptr); m_shadowArrayView = nullptr; }
+    if (m_shadowImage != nullptr)
+    { vkDestroyImage(device, m_shadowImage, nullptr); m_shadowImage = nullptr; }
+    if (m_shadowMemory != nullptr)
+    { vkFreeMemory(device, m_shadowMemory, nullptr); m_shadowMemory = nullptr; }
+    m_shadowMapMemoryBytes = 0;
+}
+
+void Vulkan::cleanup_shadow_frame(std::size_t frameIndex) noexcept
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    ShadowFrame& frame = m_shadowFrames[frameIndex];
+    if (device)
+    {
+        if (frame.slotMapped != nullptr && frame.slotMemory != nullptr)
+        { vkUnmapMemory(device, frame.slotMemory); frame.slotMapped = nullptr; }
+        if (frame.slotBuffer != nullptr)
+        { vkDestroyBuffer(device, frame.slotBuffer, nullptr); frame.slotBuffer = nullptr; }
+        if (frame.slotMemory != nullptr)
+        { vkFreeMemory(device, frame.slotMemory, nullptr); frame.slotMemory = nullptr; }
+    }
+
+    m_shadowHostMemoryBytes -= std::min<std::uint64_t>(m_shadowHostMemoryBytes, frame.allocatedBytes);
+    frame.allocatedBytes = 0;
+    frame.slotCapacity = 0;
+}
+
+Result<> Vulkan::ensure_shadow_frame_capacity(std::size_t frameIndex, std::size_t slotCount)
+{
+    ShadowFrame& frame = m_shadowFrames[frameIndex];
+    if (slotCount <= frame.slotCapacity && frame.slotBuffer != nullptr)
+        return {};
+
+    std::size_t newCapacity = std::max<std::size_t>(slotCount, 1024);
+    if (frame.slotCapacity > 0)
+        newCapacity = std::max(newCapacity, frame.slotCapacity * 2);
+
+    cleanup_shadow_frame(frameIndex);
+
+    const VkDeviceSize size = sizeof(std::uint32_t) * newCapacity;
+    VkDeviceSize allocatedBytes{};
+    if (auto result = m_vulkanDevice.create_buffer(
+        size,
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        frame.slotBuffer,
+        frame.slotMemory,
+        &allocatedBytes
+    ); !result)
+        return result;
+    frame.allocatedBytes = allocatedBytes;
+    m_shadowHostMemoryBytes += allocatedBytes;
+
+    if (vkMapMemory(m_vulkanDevice.get_device(), frame.slotMemory, 0, size, 0, &frame.slotMapped) != VK_SUCCESS)
+    {
+        cleanup_shadow_frame(frameIndex);
+        return make_error("Failed to map shadow caster buffer memory", ErrorCode::VulkanMemoryAllocationFailed);
+    }
+    frame.slotCapacity = newCapacity;
+    return {};
+}
+
+void Vulkan::invalidate_shadow_cascades() noexcept
+{
+    for (ShadowCascade& cascade : m_shadowCascades)
+        cascade.valid = false;
+}
+
+void Vulkan::note_static_shadow_change(const XMFLOAT4& sphere)
+{
+    // Slots without a mesh have no sphere and cast nothing.
+    if (sphere.w > 0.0f)
+        m_shadowStaticChanges.push_back(sphere);
+}
+
+void Vulkan::update_shadow_cascades()
+{
+    NOC_PROFILE_ZONE("Vulkan::update_shadow_cascades");
+    const auto [nearPlane, farPlane] = camera_clip_planes();
+    const XMMATRIX inverseView = XMMatrixInverse(nullptr, XMLoadFloat4x4(&m_viewMatrix));
+    const XMVECTOR cameraPosition = inverseView.r[3];
+    const XMVECTOR cameraForward = XMVector3Normalize(XMVectorNegate(inverseView.r[2]));
+
+    // Squared slope of the frustum's corner rays: a point at view depth z on a corner ray is z * sqrt(k)
+    // off the view axis.
+    const float tanHalfX = 1.0f / std::max(std::fabs(m_projMatrix._11), 1e-4f);
+    const float tanHalfY = 1.0f / std::max(std::fabs(m_projMatrix._22), 1e-4f);
+    const float cornerSlopeSq = tanHalfX * tanHalfX + tanHalfY * tanHalfY;
+
+    // A different sun invalidates every cascade, cached or not.
+    XMFLOAT3 sunDirection{};
+    XMStoreFloat3(&sunDirection, XMVector3Normalize(XMLoadFloat3(&m_sunDirection)));
+    if (std::memcmp(&sunDirection, &m_shadowSunDirection, sizeof(XMFLOAT3)) != 0)
+    {
+        invalidate_shadow_cascades();
+        m_shadowSunDirection = sunDirection;
+    }
+
+    // One light view for all cascades; only its projection differs. World-anchored, so snapping the
+    // projection to whole texels keeps edges from crawling as the camera moves.
+    const XMVECTOR lightDirection = XMVectorNegate(XMLoadFloat3(&sunDirection));
+    const XMVECTOR lightUp = std::fabs(sunDirection.y) > 0.99f ? XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)
+                                                               : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+    const XMMATRIX lightView = XMMatrixLookToRH(XMVectorZero(), lightDirection, lightUp);
+
+    const float shadowDistance = std::max(std::min(farPlane, ShadowDistance), nearPlane * 2.0f);
+    const std::uint32_t cascadeCount = m_shadowCascadeCount;
+    const std::uint32_t firstCachedCascade = (cascadeCount + 1) / 2;
+    const float resolution = static_cast<float>(m_shadowResolution);
+
+    float sliceNear = nearPlane;
+    for (std::uint32_t i = 0; i < MaxShadowCascades; ++i)
+    {
+        ShadowCascade& cascade = m_shadowCascades[i];
+        cascade.dirty = false;
+        if (i >= cascadeCount)
+        {
+            cascade.valid = false;
+            continue;
+        }
+
+        // Practical split scheme: a blend of logarithmic and uniform splits.
+        const float fraction = static_cast<float>(i + 1) / static_cast<float>(cascadeCount);
+        const float logSplit = nearPlane * std::pow(shadowDistance / nearPlane, fraction);
+        const float uniformSplit = nearPlane + (shadowDistance - nearPlane) * fraction;
+        const float sliceFar = ShadowSplitLambda * logSplit + (1.0f - ShadowSplitLambda) * uniformSplit;
+        cascade.splitFar = sliceFar;
+
+        // Smallest sphere through the slice's near and far corners. It depends only on the slice, not on
+        // the camera's orientation, so the cascade's texel size never changes as the camera turns.
+        const float centerDepth = std::min((sliceNear + sliceFar) * (1.0f + cornerSlopeSq) * 0.5f, sliceFar);
+        const float nearOffset = sliceNear - centerDepth;
+        const float farOffset = sliceFar - centerDepth;
+        const float sliceRadius = std::sqrt(std::max(nearOffset * nearOffset + sliceNear * sliceNear * cornerSlopeSq,
+                                                      farOffset * farOffset + sliceFar * sliceFar * cornerSlopeSq));
+        const XMVECTOR sliceCenter = XMVectorMultiplyAdd(cameraForward, XMVectorReplicate(centerDepth), cameraPosition);
+        sliceNear = sliceFar;
+
+        const bool cached = i >= firstCachedCascade;
+        if (cached && cascade.valid)
+        {
+            // Still valid while the slice stays inside the cached sphere and the sphere is not needlessly coarse.
+            const float drift =
+                XMVectorGetX(XMVector3Length(XMVectorSubtract(sliceCenter, XMLoadFloat4(&cascade.bounds))));
+            if (drift + sliceRadius <= cascade.bounds.w &&
+                cascade.bounds.w <= sliceRadius * (1.0f + 2.0f * ShadowCacheMargin))
+            {
+                for (const XMFLOAT4& sphere : m_shadowStaticChanges)
+                {
+                    if (sphere_touches_frustum(cascade.frustum, sphere))
+                    {
+                        cascade.dirty = true;
+                        break;
+                    }
+                }
+                continue;
+            }
+        }
+
+        const float radius = cached ? sliceRadius * (1.0f + ShadowCacheMargin) : sliceRadius;
+        const float texelWorldSize = 2.0f * radius / resolution;
+        XMFLOAT3 lightCenter{};
+        XMStoreFloat3(&lightCenter, XMVector3TransformCoord(sliceCenter, lightView));
+        lightCenter.x = std::floor(lightCenter.x / texelWorldSize) * texelWorldSize;
+        lightCenter.y = std::floor(lightCenter.y / texelWorldSize) * texelWorldSize;
+
+        // The light looks down -Z; the near plane is pulled back towards the sun so casters outside the
+        // slice still land in the map.
+        const XMMATRIX projection = XMMatrixOrthographicOffCenterRH(
+            lightCenter.x - radius, lightCenter.x + radius, lightCenter.y - radius, lightCenter.y + radius,
+            -lightCenter.z - radius - ShadowCasterReach, -lightCenter.z + radius);
+        XMStoreFloat4x4(&cascade.viewProj, XMMatrixMultiply(lightView, projection));
+        cascade.frustum = FrustumPlanes::from_view_projection(cascade.viewProj);
+        XMStoreFloat4(&cascade.bounds, sliceCenter);
+        cascade.bounds.w = radius;
+        cascade.texelWorldSize = texelWorldSize;
+        cascade.valid = true;
+        cascade.dirty = true;
+    }
+    m_shadowStaticChanges.clear();
+
+    // Each dirty cascade culls and buckets its casters on its own task. Inputs are shared read-only;
+    // every task writes only its own cascade.
+    const float lodDistanceScale = lod_distance_scale();
+    auto cullCascade = [this, cameraPosition, lodDistanceScale](ShadowCascade& cascade, bool staticOnly) {
+        m_frustumCuller.cull(cascade.frustum, cascade.visible, nullptr);
+        cascade.slots.clear();
+        cascade.batches.clear();
+
+        // Same per-mesh-run LOD bucketing as the camera's CPU culling path.
+        for (std::size_t runBegin = 0; runBegin < m_drawItems.size();)
+        {
+            const std::uint32_t meshIndex = m_drawItems[runBegin].meshIndex;
+            std::size_t runEnd = runBegin + 1;
+            while (runEnd < m_drawItems.size() && m_drawItems[runEnd].meshIndex == meshIndex)
+                ++runEnd;
+
+            const Mesh* mesh = meshIndex < m_meshes.size() ? &m_meshes[meshIndex] : nullptr;
+            if (mesh == nullptr || !mesh->geometry.is_valid())
+            {
+                runBegin = runEnd;
+                continue;
+            }
+
+            for (auto& lodSlots : cascade.lodSlots)
+                lodSlots.clear();
+            for (std::size_t drawIndex = runBegin; drawIndex < runEnd; ++drawIndex)
+            {
+                if (cascade.visible[drawIndex] != 1 || (staticOnly && m_cullStaticFlagsScratch[drawIndex] == 0))
+                    continue;
+                const std::uint32_t lod =
+                    select_mesh_lod(*mesh, m_cullSpheresScratch[drawIndex], cameraPosition, lodDistanceScale);
+                cascade.lodSlots[lod].push_back(m_drawItems[drawIndex].slot);
+            }
+
+            for (std::uint32_t lod = 0; lod < mesh->lodCount; ++lod)
+            {
+                const auto& lodSlots = cascade.lodSlots[lod];
+                if (lodSlots.empty())
+                    continue;
+                cascade.batches.push_back(InstanceBatch{meshIndex, lod, static_cast<std::uint32_t>(cascade.slots.size()),
+                                                        static_cast<std::uint32_t>(lodSlots.size())});
+                cascade.slots.insert(cascade.slots.end(), lodSlots.begin(), lodSlots.end());
+            }
+            runBegin = runEnd;
+        }
+    };
+
+    std::uint32_t dirtyCount = 0;
+    for (std::uint32_t i = 0; i < cascadeCount; ++i)
+        dirtyCount += m_shadowCascades[i].dirty ? 1 : 0;
+
+    if (m_taskExecutor == nullptr || dirtyCount <= 1)
+    {
+        for (std::uint32_t i = 0; i < cascadeCount; ++i)
+        {
+            if (m_shadowCascades[i].dirty)
+                cullCascade(m_shadowCascades[i], i >= firstCachedCascade);
+        }
+        return;
+    }
+
+    tf::Taskflow taskflow{};
+    for (std::uint32_t i = 0; i < cascadeCount; ++i)
+    {
+        if (m_shadowCascades[i].dirty)
+            taskflow.emplace([&, i]() { cullCascade(m_shadowCascades[i], i >= firstCachedCascade); });
+    }
+    // draw_frame() may run inside a frame job graph, where waiting must help out instead of blocking.
+    if (m_taskExecutor->this_worker_id() >= 0)
+        m_taskExecutor->corun(taskflow);
+    else
+        m_taskExecutor->run(taskflow).wait();
+}
+
+Result<> Vulkan::record_shadow_pass(VkCommandBuffer cmd, VkDescriptorSet instanceSet)
+{
+    std::size_t slotCount = 0;
+    std::uint32_t dirtyCount = 0;
+    for (std::uint32_t i = 0; i < m_shadowCascadeCount; ++i)
+    {
+        ShadowCascade& cascade = m_shadowCascades[i];
+        if (!cascade.dirty)
+            continue;
+        cascade.firstSlot = static_cast<std::uint32_t>(slotCount);
+        slotCount += cascade.slots.size();
+        ++dirtyCount;
+    }
+    if (dirtyCount == 0)
+        return {};
+
+    if (auto result = ensure_shadow_frame_capacity(m_currentFrame, slotCount); !result)
+        return result;
+    const ShadowFrame& frame = m_shadowFrames[m_currentFrame];
+    for (std::uint32_t i = 0; i < m_shadowCascadeCount; ++i)
+    {
+        const ShadowCascade& cascade = m_shadowCascades[i];
+        if (cascade.dirty && !cascade.slots.empty())
+        {
+            std::memcpy(static_cast<std::uint32_t*>(frame.slotMapped) + cascade.firstSlot, cascade.slots.data(),
+                        sizeof(std::uint32_t) * cascade.slots.size());
+        }
+    }
+
+    // depth.vert only reads the instance slots (set 1); the cascade's view-projection is pushed per pass.
+    const VkPipelineLayout pipelineLayout = m_pipeline.get_pipeline_layout();
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadowPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &instanceSet, 0, nullptr);
+
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(m_shadowResolution);
+    viewport.height = static_cast<float>(m_shadowResolution);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    VkRect2D scissor{};
+    scissor.extent = {m_shadowResolution, m_shadowResolution};
+
+    VkClearValue clearValue{};
+    clearValue.depthStencil = {1.0f, 0};
+
+    for (std::uint32_t i = 0; i < m_shadowCascadeCount; ++i)
+    {
+        const ShadowCascade& cascade = m_shadowCascades[i];
+        if (!cascade.dirty)
+            continue;
+
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = m_shadowRenderPass;
+        renderPassInfo.framebuffer = m_shadowFramebuffers[i];
+        renderPassInfo.renderArea.extent = scissor.extent;
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearValue;
+        vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
+        vkCmdSetDepthBias(cmd, ShadowDepthBiasConstant, 0.0f, ShadowDepthBiasSlope);
+        vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(XMFLOAT4X4), &cascade.viewProj);
+
+        // Buffers are only rebound when a batch's mesh lives on another geometry arena page.
+        std::uint32_t boundPage = std::numeric_limits<std::uint32_t>::max();
+        for (const InstanceBatch& batch : cascade.batches)
+        {
+            const Mesh& mesh = m_meshes[batch.meshIndex];
+            if (mesh.geometry.page != boundPage)
+            {
+                boundPage = mesh.geometry.page;
+                std::array<VkBuffer, 2> vertexBuffers{m_geometryArena.get_position_buffer(boundPage), frame.slotBuffer};
+                std::array<VkDeviceSize, 2> offsets{0, 0};
+                vkCmdBindVertexBuffers(cmd, 0, static_cast<std::uint32_t>(vertexBuffers.size()), vertexBuffers.data(),
+                                       offsets.data());
+                vkCmdBindIndexBuffer(cmd, m_geometryArena.get_index_buffer(boundPage), 0, VK_INDEX_TYPE_UINT32);
+            }
+
+            const MeshLod& lod = mesh.lods[batch.lodLevel];
+            vkCmdDrawIndexed(cmd, lod.indexCount, batch.instanceCount, mesh.geometry.firstIndex + lod.firstIndex,
+                             static_cast<std::int32_t>(mesh.geometry.firstVertex), cascade.firstSlot + batch.firstInstance);
+            ++m_lastShadowDrawCallCount;
+        }
+
+        vkCmdEndRenderPass(cmd);
+        ++m_lastShadowCascadeRenderCount;
+    }
+    return {};
+}
+
+/// Runtime settings
+
+void Vulkan::set_vsync(KHR_Settings mode) noexcept
+{
+    VkPresentModeKHR requestedMode = VK_PRESENT_MODE_FIFO_KHR;
+    switch (mode)
+    {
+    case KHR_Settings::VSync:
+        requestedMode = VK_PRESENT_MODE_FIFO_KHR;
+        break;
+    case KHR_Settings::Triple_Buffering:
+        requestedMode = VK_PRESENT_MODE_MAILBOX_KHR;
+        break;
+    case KHR_Settings::Immediate:
+        requestedMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+        break;
+    default:
+        requestedMode = VK_PRESENT_MODE_FIFO_KHR;
+        break;
+    }
+
+    const VkPresentModeKHR currentMode = m_swapchain.get_present_mode();
+    if (currentMode == requestedMode)
+    {
+        m_vsyncEnabled = (currentMode == VK_PRESENT_MODE_FIFO_KHR || currentMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR);
+        return;
+    }
+
+    const bool previousVsync = m_vsyncEnabled;
+    m_swapchain.set_desired_present_mode(requestedMode);
+
+    VkDevice device = m_vulkanDevice.get_device();
+    vkDeviceWaitIdle(device);
+
+    if (auto result = recreate_swap_chain(); !result)
+    {
+        fmt::print("Warning: failed to apply present mode change: {}\n", result.error().message);
+        m_vsyncEnabled = previousVsync;
+        // Fall back to deferred recreate retry on next frame.
+        m_framebufferResized = true;
+        return;
+    }
+
+    const VkPresentModeKHR appliedMode = m_swapchain.get_present_mode();
+    m_vsyncEnabled = (appliedMode == VK_PRESENT_MODE_FIFO_KHR || appliedMode == VK_PRESENT_MODE_FIFO_RELAXED_KHR);
+}
+
+bool Vulkan::get_vsync() const noexcept
+{
+    const VkPresentModeKHR mode = m_swapchain.get_present_mode();
+    return (mode == VK_PRESENT_MODE_FIFO_KHR || mode == VK_PRESENT_MODE_FIFO_RELAXED_KHR);
+}
+
+void Vulkan::set_msaa_samples(std::int32_t samples) noexcept
+{
+    VkSampleCountFlagBits desired = VK_SAMPLE_COUNT_1_BIT;
+    switch (samples)
+    {
+    case 2:
+        desired = VK_SAMPLE_COUNT_2_BIT;
+        break;
+    case 4:
+        desired = VK_SAMPLE_COUNT_4_BIT;
+        break;
+    case 8:
+        desired = VK_SAMPLE_COUNT_8_BIT;
+        break;
+    default:
+        desired = VK_SAMPLE_COUNT_1_BIT;
+        break;
+    }
+
+    VkSampleCountFlagBits maxSamples = get_max_usable_sample_count();
+    if (desired > maxSamples)
+        desired = maxSamples;
+
+    if (desired == m_msaaSamples)
+        return;
+
+    const VkSampleCountFlagBits previous = m_msaaSamples;
+    VkDevice device = m_vulkanDevice.get_device();
+    vkDeviceWaitIdle(device);
+
+    auto rebuild_for_msaa = [&](VkSampleCountFlagBits targetSamples) -> Result<> {
+        m_msaaSamples = targetSamples;
+        if (m_nisEnabled)
+            cleanup_nis_resources();
+        cleanup_hiz_resources();
+        cleanup_scene_render_target();
+        cleanup_scene_render_pass();
+
+        if (auto result = create_scene_render_pass(); !result)
+            return result;
+        compute_scene_render_size();
+        if (auto result = create_scene_render_target(); !result)
+            return result;
+
+        if (m_occlusionCullingEnabled)
+        {
+            if (auto hiZResult = create_hiz_resources(); !hiZResult)
+                fmt::print("Warning: failed to recreate Hi-Z resources after MSAA change: {}\n", hiZResult.error().message);
+        }
+        
+        if (m_nisEnabled)
+        {
+            if (auto nisResult = create_nis_resources(); !nisResult)
+                fmt::print("Warning: failed to recreate NIS resources after MSAA change: {}\n", nisResult.error().message);
+        }
+
+        // The depth-only and debug line pipelines are compiled for one sample count.
+        cleanup_depth_prepass_pipeline();
+        if (m_depthPrepassEnabled)
+        {
+            if (auto result = create_depth_prepass_pipeline(); !result)
+                return result;
+        }
+        cleanup_debug_draw_resources(false);
+        m_debugDrawFailed = false;
+
+        // The new pass is compatible with the one the variant was prebuilt against.
+        const MultisampleConfig msConfig = scene_pipeline_config();
+        return m_pipeline.select_variant(m_sceneRenderPass, msConfig);
+    };
+
+    if (auto result = rebuild_for_msaa(desired); !result)
+    {
+        fmt::print("Warning: failed to apply MSAA setting: {}\n", result.error().message);
+        if (auto rollback = rebuild_for_msaa(previous); !rollback)
+        {
+            fmt::print("Warning: failed to restore previous MSAA state: {}\n", rollback.error().message);
+            if (auto recreate = recreate_swap_chain(); !recreate)
+            {
+                fmt::print("Warning: failed to recover after MSAA setting failure: {}\n", recreate.error().message);
+                m_framebufferResized = true;
+            }
+        }
+    }
+    else
+    {
+        if (m_swapchainRecreatedCallback)
+            m_swapchainRecreatedCallback();
+    }
+}
+
+std::int32_t Vulkan::get_msaa_samples() const noexcept
+{
+    return static_cast<std::int32_t>(m_msaaSamples);
+}
+
+void Vulkan::set_alpha_to_coverage(bool enabled) noexcept
+{
+    if (enabled == m_alphaToCoverageEnabled)
+        return;
+    m_alphaToCoverageEnabled = enabled;
+
+    // Pipeline swap only (no render pass / framebuffer change). Variants stay alive, so frames in
+    // flight keep their pipeline and no device idle is needed.
+    const MultisampleConfig msConfig = scene_pipeline_config();
+    if (auto result = m_pipeline.select_variant(m_sceneRenderPass, msConfig); !result)
+    {
+        fmt::print("Warning: failed to apply alpha-to-coverage setting: {}\n", result.error().message);
+        m_alphaToCoverageEnabled = !enabled;
+    }
+}
+
+bool Vulkan::get_alpha_to_coverage() const noexcept
+{
+    return m_alphaToCoverageEnabled;
+}
+
+void Vulkan::set_sample_shading(bool enabled) noexcept
+{
+    if (enabled == m_sampleShadingEnabled)
+        return;
+    m_sampleShadingEnabled = enabled;
+
+    const MultisampleConfig msConfig = scene_pipeline_config();
+    if (auto result = m_pipeline.select_variant(m_sceneRenderPass, msConfig); !result)
+    {
+        fmt::print("Warning: failed to apply sample shading setting: {}\n", result.error().message);
+        m_sampleShadingEnabled = !enabled;
+    }
+}
+
+bool Vulkan::get_sample_shading() const noexcept
+{
+    return m_sampleShadingEnabled;
+}
 
 void Vulkan::set_min_sample_shading(float fraction) noexcept
 {
-    fraction = std::clamp(fraction, 0.0f, 1.0f);
-    if (std::fabs(fraction - m_minSampleShading) < 0.0001f)
-        return;
-    m_minSampleShading = fraction;
+    fraction = std::clamp(fraction, 0.0f, 1.0f);
+    if (std::fabs(fraction - m_minSampleShading) < 0.0001f)
+        return;
+    const float previous = m_minSampleShading;
+    m_minSampleShading = fraction;
+
+    // The fraction is baked into sample-shading variants: swap to (or compile) the current one,
+    // then rebuild the other sample-shading variants for the new fraction in the background.
+    const MultisampleConfig msConfig = scene_pipeline_config();
+    if (auto result = m_pipeline.select_variant(m_sceneRenderPass, msConfig); !result)
+    {
+        fmt::print("Warning: failed to apply min sample shading setting: {}\n", result.error().message);
+        m_minSampleShading = previous;
+        return;
+    }
+    prewarm_pipeline_variants();
+}
+
+float Vulkan::get_min_sample_shading() const noexcept
+{
+    return m_minSampleShading;
+}
+
+void Vulkan::set_nis_enabled(bool enabled) noexcept
+{
+    if (enabled == m_nisEnabled)
+        return;
+    m_nisEnabled = enabled;
+
+    constexpr float kMinNisRenderScale = 0.5f;
+
+    if (m_nisEnabled && m_renderScale < kMinNisRenderScale)
+    {
+        m_renderScale = kMinNisRenderScale;
+        m_framebufferResized = true;
+        fmt::print("NIS enabled: render scale clamped to {:.2f} (NIS supports 0.50..1.00 upscaling range).\n", kMinNisRenderScale);
+        return;
+    }
+
+    VkDevice device = m_vulkanDevice.get_device();
+    vkDeviceWaitIdle(device);
+
+    if (m_nisEnabled)
+    {
+        if (auto result = create_nis_resources(); !result)
+        {
+            fmt::print("Warning: failed to create NIS resources: {}\n", result.error().message);
+            m_nisEnabled = false;
+        }
+    }
+    else
+    {
+        cleanup_nis_resources();
+    }
+}
+
+bool Vulkan::get_nis_enabled() const noexcept
+{
+    return m_nisEnabled;
+}
+
+void Vulkan::set_nis_sharpness(float sharpness) noexcept
+{
+    sharpness = std::clamp(sharpness, 0.0f, 1.0f);
+    if (std::fabs(sharpness - m_nisSharpness) < 0.001f)
+        return;
+    m_nisSharpness = sharpness;
+
+    if (m_nisEnabled && m_nisConfigBuffer != nullptr)
+    {
+        update_nis_config();
+    }
+}
+
+float Vulkan::get_nis_sharpness() const noexcept
+{
+    return m_nisSharpness;
+}
+
+void Vulkan::set_render_scale(float scale) noexcept
+{
+    constexpr float kMinRenderScale = 0.25f;
+    constexpr float kMinNisRenderScale = 0.5f;
+    scale = std::clamp(scale, kMinRenderScale, 2.0f);
+
+    if (m_nisEnabled && scale < kMinNisRenderScale)
+    {
+        scale = kMinNisRenderScale;
+        fmt::print("NIS requires render scale >= {:.2f}; clamping requested value.\n", kMinNisRenderScale);
+    }
+
+    if (std::fabs(scale - m_renderScale) < 0.0001f)
+        return;
+
+    m_renderScale = scale;
+    m_framebufferResized = true;
+}
+
+float Vulkan::get_render_scale() const noexcept
+{
+    return m_renderScale;
+}
+
+void Vulkan::set_gpu_culling_enabled(bool enabled) noexcept
+{
+    if (enabled == m_gpuCullingEnabled)
+        return;
+    m_gpuCullingEnabled = enabled;
+
+    VkDevice device = m_vulkanDevice.get_device();
+    vkDeviceWaitIdle(device);
+
+    if (m_gpuCullingEnabled)
+    {
+        if (auto result = create_gpu_cull_resources(); !result)
+        {
+            fmt::print("Warning: failed to create GPU culling resources, using CPU culling: {}\n",
+                       result.error().message);
+            cleanup_gpu_cull_resources();
+            m_gpuCullingEnabled = false;
+        }
+    }
+    else
+    {
+        cleanup_gpu_cull_resources();
+    }
+}
+
+bool Vulkan::get_gpu_culling_enabled() const noexcept
+{
+    return m_gpuCullingEnabled;
+}
+
+void Vulkan::set_occlusion_culling_enabled(bool enabled) noexcept
+{
+    if (enabled == m_occlusionCullingEnabled)
+        return;
+
+    VkDevice device = m_vulkanDevice.get_device();
+    vkDeviceWaitIdle(device);
+
+    // The scene pass stores depth and the depth image is sampled only while occlusion culling is on,
+    // so both are rebuilt along with the pyramid.
+    auto rebuild_for_occlusion = [&](bool occlusionEnabled) -> Result<> {
+        m_occlusionCullingEnabled = occlusionEnabled;
+        if (m_nisEnabled)
+            cleanup_nis_resources();
+        cleanup_hiz_resources();
+        cleanup_scene_render_target();
+        cleanup_scene_render_pass();
+
+        if (auto result = create_scene_render_pass(); !result)
+            return result;
+        if (auto result = create_scene_render_target(); !result)
+            return result;
+        if (m_occlusionCullingEnabled)
+        {
+            if (auto result = create_hiz_resources(); !result)
+                return result;
+        }
+
+        if (m_nisEnabled)
+        {
+            if (auto nisResult = create_nis_resources(); !nisResult)
+                fmt::print("Warning: failed to recreate NIS resources after occlusion change: {}\n",
+                           nisResult.error().message);
+        }
+
+        const MultisampleConfig msConfig = scene_pipeline_config();
+        return m_pipeline.select_variant(m_sceneRenderPass, msConfig);
+    };
+
+    if (auto result = rebuild_for_occlusion(enabled); !result)
+    {
+        fmt::print("Warning: failed to apply occlusion culling setting: {}\n", result.error().message);
+        if (auto rollback = rebuild_for_occlusion(!enabled); !rollback)
+        {
+            fmt::print("Warning: failed to restore previous occlusion culling state: {}\n", rollback.error().message);
+            if (auto recreate = recreate_swap_chain(); !recreate)
+            {
+                fmt::print("Warning: failed to recover after occlusion culling failure: {}\n",
+                           recreate.error().message);
+                m_framebufferResized = true;
+            }
+        }
+    }
+
+    m_lastOccludedRenderableCount = 0;
+    if (m_swapchainRecreatedCallback)
+        m_swapchainRecreatedCallback();
+}
+
+bool Vulkan::get_occlusion_culling_enabled() const noexcept
+{
+    return m_occlusionCullingEnabled;
+}
+
+void Vulkan::set_depth_prepass_enabled(bool enabled) noexcept
+{
+    if (enabled == m_depthPrepassEnabled)
+        return;
+
+    // The depth-only pipeline is only kept while the prepass runs; frames in flight may still use it.
+    VkDevice device = m_vulkanDevice.get_device();
+    vkDeviceWaitIdle(device);
+
+    m_depthPrepassEnabled = enabled;
+    cleanup_depth_prepass_pipeline();
+    Result<> result{};
+    if (m_depthPrepassEnabled)
+        result = create_depth_prepass_pipeline();
+    if (result)
+        result = m_pipeline.select_variant(m_sceneRenderPass, scene_pipeline_config());
+
+    if (!result)
+    {
+        fmt::print("Warning: failed to apply depth prepass setting: {}\n", result.error().message);
+        cleanup_depth_prepass_pipeline();
+        m_depthPrepassEnabled = false;
+        if (auto rollback = m_pipeline.select_variant(m_sceneRenderPass, scene_pipeline_config()); !rollback)
+            fmt::print("Warning: failed to restore the scene pipeline: {}\n", rollback.error().message);
+        return;
+    }
+    prewarm_pipeline_variants();
+}
+
+bool Vulkan::get_depth_prepass_enabled() const noexcept
+{
+    return m_depthPrepassEnabled;
+}
+
+Result<> Vulkan::create_depth_prepass_pipeline()
+{
+    if (m_depthVertSpirv.empty())
+    {
+        auto vertResult = ShaderCompiler::load_or_compile(m_depthVertShaderPath, m_shaderLoadMode);
+        if (!vertResult)
+            return make_error(vertResult.error());
+        m_depthVertSpirv = std::move(vertResult.value());
+    }
+
+    auto pipelineResult = m_pipeline.create_depth_prepass_pipeline(m_sceneRenderPass, m_msaaSamples, m_depthVertSpirv);
+    if (!pipelineResult)
+        return make_error(pipelineResult.error());
+    m_depthPrepassPipeline = pipelineResult.value();
+    return {};
+}
+
+void Vulkan::cleanup_depth_prepass_pipeline() noexcept
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    if (!device) return;
+
+    if (m_depthPrepassPipeline != nullptr)
+    { vkDestroyPipeline(device, m_depthPrepassPipeline, nullptr); m_depthPrepassPipeline = nullptr; }
+}
+
+void Vulkan::set_debug_draw(const DebugDrawList& list) noexcept
+{
+    // Callers hand over a list every frame; an unchanged one keeps the version, so frame buffers that
+    // already hold it are not copied again.
+    bool changed = false;
+    std::size_t offset = 0;
+    for (std::uint32_t shape = 0; shape < DebugShapeCount && !changed; ++shape)
+    {
+        for (bool depthTest : {true, false})
+        {
+            const auto instances = list.get_instances(static_cast<DebugShape>(shape), depthTest);
+            if (m_debugDrawBucketCounts[shape * 2 + (depthTest ? 0 : 1)] != instances.size() ||
+                (!instances.empty() && std::memcmp(m_debugDrawInstances.data() + offset, instances.data(),
+                                                   instances.size_bytes()) != 0))
+            {
+                changed = true;
+                break;
+            }
+            offset += instances.size();
+        }
+    }
+
+    if (changed)
+    {
+        m_debugDrawInstances.clear();
+        m_debugDrawInstances.reserve(list.size());
+        for (std::uint32_t shape = 0; shape < DebugShapeCount; ++shape)
+        {
+            for (bool depthTest : {true, false})
+            {
+                const auto instances = list.get_instances(static_cast<DebugShape>(shape), depthTest);
+                m_debugDrawBucketCounts[shape * 2 + (depthTest ? 0 : 1)] = static_cast<std::uint32_t>(instances.size());
+                m_debugDrawInstances.insert(m_debugDrawInstances.end(), instances.begin(), instances.end());
+            }
+        }
+        ++m_debugDrawVersion;
+    }
+
+    const bool pipelinesMissing = m_debugDepthTestedPipeline == nullptr || m_debugOverlayPipeline == nullptr;
+    if (!m_debugDrawInstances.empty() && pipelinesMissing && !m_debugDrawFailed)
+    {
+        if (auto result = create_debug_draw_resources(); !result)
+        {
+            fmt::print("Warning: debug drawing is disabled: {}\n", result.error().message);
+            cleanup_debug_draw_resources(false);
+            m_debugDrawFailed = true;
+        }
+    }
+}
+
+Result<> Vulkan::create_debug_draw_resources()
+{
+    if (m_debugVertSpirv.empty() || m_debugFragSpirv.empty())
+    {
+        auto vertResult = ShaderCompiler::load_or_compile(m_debugVertShaderPath, m_shaderLoadMode);
+        if (!vertResult)
+            return make_error(vertResult.error());
+        auto fragResult = ShaderCompiler::load_or_compile(m_debugFragShaderPath, m_shaderLoadMode);
+        if (!fragResult)
+            return make_error(fragResult.error());
+        m_debugVertSpirv = std::move(vertResult.value());
+        m_debugFragSpirv = std::move(fragResult.value());
+    }
+
+    if (m_debugShapeBuffer == nullptr)
+    {
+        m_debugShapeMesh = DebugShapeMesh::build();
+        const VkDeviceSize size = sizeof(DebugShapeVertex) * m_debugShapeMesh.vertices.size();
+        if (auto result = m_vulkanDevice.create_buffer(
+            size,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_debugShapeBuffer,
+            m_debugShapeMemory,
+            &m_debugShapeAllocatedBytes
+        ); !result)
+            return result;
+        m_debugDrawHostMemoryBytes += m_debugShapeAllocatedBytes;
+
+        void* mapped{};
+        if (vkMapMemory(m_vulkanDevice.get_device(), m_debugShapeMemory, 0, size, 0, &mapped) != VK_SUCCESS)
+            return make_error("Failed to map debug shape buffer memory", ErrorCode::VulkanMemoryAllocationFailed);
+        std::memcpy(mapped, m_debugShapeMesh.vertices.data(), static_cast<std::size_t>(size));
+        vkUnmapMemory(m_vulkanDevice.get_device(), m_debugShapeMemory);
+    }
+
+    for (bool depthTest : {true, false})
+    {
+        VkPipeline& pipeline = depthTest ? m_debugDepthTestedPipeline : m_debugOverlayPipeline;
+        if (pipeline != nullptr)
+            continue;
+        auto pipelineResult = m_pipeline.create_debug_line_pipeline(m_sceneRenderPass, m_msaaSamples, m_debugVertSpirv,
+                                                                    m_debugFragSpirv, depthTest);
+        if (!pipelineResult)
+            return make_error(pipelineResult.error());
+        pipeline = pipelineResult.value();
+    }
+    return {};
+}
+
+void Vulkan::cleanup_debug_draw_resources(bool all) noexcept
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    if (!device) return;
+
+    if (m_debugDepthTestedPipeline != nullptr)
+    { vkDestroyPipeline(device, m_debugDepthTestedPipeline, nullptr); m_debugDepthTestedPipeline = nullptr; }
+    if (m_debugOverlayPipeline != nullptr)
+    { vkDestroyPipeline(device, m_debugOverlayPipeline, nullptr); m_debugOverlayPipeline = nullptr; }
+    if (!all)
+        return;
+
+    for (std::size_t i = 0; i < m_debugDrawFrames.size(); ++i)
+        cleanup_debug_draw_frame(i);
+    if (m_debugShapeBuffer != nullptr)
+    { vkDestroyBuffer(device, m_debugShapeBuffer, nullptr); m_debugShapeBuffer = nullptr; }
+    if (m_debugShapeMemory != nullptr)
+    { vkFreeMemory(device, m_debugShapeMemory, nullptr); m_debugShapeMemory = nullptr; }
+    m_debugDrawHostMemoryBytes -= std::min<std::uint64_t>(m_debugDrawHostMemoryBytes, m_debugShapeAllocatedBytes);
+    m_debugShapeAllocatedBytes = 0;
+}
+
+void Vulkan::cleanup_debug_draw_frame(std::size_t frameIndex) noexcept
+{
+    VkDevice device = m_vulkanDevice.get_device();
+    DebugDrawFrame& frame = m_debugDrawFrames[frameIndex];
+    if (device)
+    {
+        if (frame.mapped != nullptr && frame.memory != nullptr)
+        { vkUnmapMemory(device, frame.memory); frame.mapped = nullptr; }
+        if (frame.buffer != nullptr)
+        { vkDestroyBuffer(device, frame.buffer, nullptr); frame.buffer = nullptr; }
+        if (frame.memory != nullptr)
+        { vkFreeMemory(device, frame.memory, nullptr); frame.memory = nullptr; }
+    }
+
+    m_debugDrawHostMemoryBytes -= std::min<std::uint64_t>(m_debugDrawHostMemoryBytes, frame.allocatedBytes);
+    frame.allocatedBytes = 0;
+    frame.instanceCapacity = 0;
+    frame.uploadedVersion = 0;
+}
+
+Result<> Vulkan::upload_debug_draw_frame(std::size_t frameIndex)
+{
+    DebugDrawFrame& frame = m_debugDrawFrames[frameIndex];
+    if (frame.uploadedVersion == m_debugDrawVersion || m_debugDrawInstances.empty())
+        return {};
 
-    VkDevice device = m_vulkanDevice.get_device();
-    vkDeviceWaitIdle(device);
-    m_pipeline.cleanup();
-    MultisampleConfig msConfig{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
-    if (auto result = m_pipeline.initialize(m_sceneRenderPass, msConfig, m_vertSpirv, m_fragSpirv); !result)
+    constexpr VkDeviceSize commandBytes = sizeof(VkDrawIndirectCommand) * DebugDrawIndirectCount;
+    if (m_debugDrawInstances.size() > frame.instanceCapacity || frame.buffer == nullptr)
     {
-        fmt::print("Warning: failed to apply min sample shading setting: {}\n", result.error().message);
-        m_pipeline.cleanup();
-        MultisampleConfig rollback{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
-        (void)m_pipeline.initialize(m_sceneRenderPass, rollback, m_vertSpirv, m_fragSpirv);
+        std::size_t newCapacity = std::max<std::size_t>(m_debugDrawInstances.size(), 1024);
+        if (frame.instanceCapacity > 0)
+            newCapacity = std::max(newCapacity, frame.instanceCapacity * 2);
+
+        cleanup_debug_draw_frame(frameIndex);
+
+        const VkDeviceSize size = commandBytes + sizeof(DebugDrawInstance) * newCapacity;
+        VkDeviceSize allocatedBytes{};
+        if (auto result = m_vulkanDevice.create_buffer(
+            size,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            frame.buffer,
+            frame.memory,
+            &allocatedBytes
+        ); !result)
+            return result;
+        frame.allocatedBytes = allocatedBytes;
+        m_debugDrawHostMemoryBytes += allocatedBytes;
+
+        if (vkMapMemory(m_vulkanDevice.get_device(), frame.memory, 0, size, 0, &frame.mapped) != VK_SUCCESS)
+        {
+            cleanup_debug_draw_frame(frameIndex);
+            return make_error("Failed to map debug draw buffer memory", ErrorCode::VulkanMemoryAllocationFailed);
+        }
+        frame.instanceCapacity = newCapacity;
+    }
+
+    // Empty buckets keep a command with no instances, so each depth mode stays one fixed run.
+    auto* commands = static_cast<VkDrawIndirectCommand*>(frame.mapped);
+    std::uint32_t firstInstance{};
+    for (std::uint32_t shape = 0; shape < DebugShapeCount; ++shape)
+    {
+        for (std::uint32_t mode = 0; mode < 2; ++mode)
+        {
+            const std::uint32_t count = m_debugDrawBucketCounts[shape * 2 + mode];
+            VkDrawIndirectCommand& command = commands[mode * DebugShapeCount + shape];
+            command.vertexCount = m_debugShapeMesh.vertexCount[shape];
+            command.instanceCount = count;
+            command.firstVertex = m_debugShapeMesh.firstVertex[shape];
+            command.firstInstance = firstInstance;
+            firstInstance += count;
+        }
     }
+    std::memcpy(static_cast<std::byte*>(frame.mapped) + commandBytes, m_debugDrawInstances.data(),
+                sizeof(DebugDrawInstance) * m_debugDrawInstances.size());
+    frame.uploadedVersion = m_debugDrawVersion;
+    return {};
 }
 
-float Vulkan::get_min_sample_shading() const noexcept
+std::uint32_t Vulkan::record_debug_draws(VkCommandBuffer cmd) const noexcept
 {
-    return m_minSampleShading;
+    const DebugDrawFrame& frame = m_debugDrawFrames[m_currentFrame];
+    if (m_debugDrawInstances.empty() || frame.uploadedVersion != m_debugDrawVersion ||
+        m_debugDepthTestedPipeline == nullptr || m_debugOverlayPipeline == nullptr)
+        return 0;
+
+    constexpr VkDeviceSize commandBytes = sizeof(VkDrawIndirectCommand) * DebugDrawIndirectCount;
+    std::array<VkBuffer, 2> vertexBuffers{m_debugShapeBuffer, frame.buffer};
+    std::array<VkDeviceSize, 2> offsets{0, commandBytes};
+    vkCmdBindVertexBuffers(cmd, 0, static_cast<std::uint32_t>(vertexBuffers.size()), vertexBuffers.data(),
+                           offsets.data());
+
+    // Line widths are in output pixels; the scene renders at the render scale, so they shrink with it.
+    const XMFLOAT4 viewport{static_cast<float>(m_sceneRenderWidth), static_cast<float>(m_sceneRenderHeight),
+                            get_dynamic_resolution_scale(), 0.0f};
+    vkCmdPushConstants(cmd, m_pipeline.get_pipeline_layout(), VK_SHADER_STAGE_VERTEX_BIT, sizeof(XMFLOAT4X4),
+                       sizeof(XMFLOAT4), &viewport);
+
+    // One multi-draw per depth mode; without multiDrawIndirect (or first-instance support) the
+    // non-empty buckets go out as plain instanced draws.
+    const bool multiDraw =
+        m_vulkanDevice.supports_multi_draw_indirect() && m_vulkanDevice.supports_indirect_first_instance();
+    const auto* commands = static_cast<const VkDrawIndirectCommand*>(frame.mapped);
+    std::uint32_t drawCalls = 0;
+    for (std::uint32_t mode = 0; mode < 2; ++mode)
+    {
+        std::uint32_t instanceCount{};
+        for (std::uint32_t shape = 0; shape < DebugShapeCount; ++shape)
+            instanceCount += m_debugDrawBucketCounts[shape * 2 + mode];
+        if (instanceCount == 0)
+            continue;
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          mode == 0 ? m_debugDepthTestedPipeline : m_debugOverlayPipeline);
+        if (multiDraw)
+        {
+            vkCmdDrawIndirect(cmd, frame.buffer, sizeof(VkDrawIndirectCommand) * mode * DebugShapeCount, DebugShapeCount,
+                              sizeof(VkDrawIndirectCommand));
+            ++drawCalls;
+            continue;
+        }
+        for (std::uint32_t shape = 0; shape < DebugShapeCount; ++shape)
+        {
+            const VkDrawIndirectCommand& command = commands[mode * DebugShapeCount + shape];
+            if (command.instanceCount == 0)
+                continue;
+            vkCmdDraw(cmd, command.vertexCount, command.instanceCount, command.firstVertex, command.firstInstance);
+            ++drawCalls;
+        }
+    }
+    return drawCalls;
 }
 
-void Vulkan::set_nis_enabled(bool enabled) noexcept
+float Vulkan::lod_distance_scale() const noexcept
 {
-    if (enabled == m_nisEnabled)
+    return screen_pixel_scale() / (LodErrorPixels * m_lodBias);
+}
+
+float Vulkan::screen_pixel_scale() const noexcept
+{
+    // A sphere of radius r at distance d spans r * |P22| / d of the half-height in NDC.
+    const float halfHeightPixels = 0.5f * static_cast<float>(std::max(1u, m_sceneRenderHeight));
+    return std::fabs(m_projMatrix._22) * halfHeightPixels;
+}
+
+void Vulkan::set_lod_bias(float bias) noexcept
+{
+    m_lodBias = std::clamp(bias, 0.25f, 4.0f);
+}
+
+float Vulkan::get_lod_bias() const noexcept
+{
+    return m_lodBias;
+}
+
+void Vulkan::set_shadows_enabled(bool enabled) noexcept
+{
+    if (enabled == m_shadowsEnabled)
         return;
-    m_nisEnabled = enabled;
+    m_shadowsEnabled = enabled;
+    // Static changes stop being tracked while shadows are off, so the cache cannot be trusted afterwards.
+    invalidate_shadow_cascades();
+}
 
-    constexpr float kMinNisRenderScale = 0.5f;
+bool Vulkan::get_shadows_enabled() const noexcept
+{
+    return m_shadowsEnabled;
+}
 
-    if (m_nisEnabled && m_renderScale < kMinNisRenderScale)
-    {
-        m_renderScale = kMinNisRenderScale;
-        m_framebufferResized = true;
-        fmt::print("NIS enabled: render scale clamped to {:.2f} (NIS supports 0.50..1.00 upscaling range).\n", kMinNisRenderScale);
+void Vulkan::set_shadow_map_resolution(std::uint32_t resolution) noexcept
+{
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(m_vulkanDevice.get_physical_device(), &properties);
+    const std::uint32_t maxDimension = std::max(512u, properties.limits.maxImageDimension2D);
+    const std::uint32_t desired = std::bit_floor(std::clamp(resolution, 512u, std::min(4096u, maxDimension)));
+    if (desired == m_shadowResolution)
         return;
+
+    const std::uint32_t previous = m_shadowResolution;
+    vkDeviceWaitIdle(m_vulkanDevice.get_device());
+    cleanup_shadow_map();
+    m_shadowResolution = desired;
+    if (auto result = create_shadow_map(); !result)
+    {
+        fmt::print("Warning: Failed to resize shadow map: {}\n", result.error().message);
+        cleanup_shadow_map();
+        m_shadowResolution = previous;
+        if (auto restore = create_shadow_map(); !restore)
+            fmt::print("Warning: Failed to restore shadow map: {}\n", restore.error().message);
     }
+}
 
-    VkDevice device = m_vulkanDevice.get_device();
-    vkDeviceWaitIdle(device);
+std::uint32_t Vulkan::get_shadow_map_resolution() const noexcept
+{
+    return m_shadowResolution;
+}
 
-    if (m_nisEnabled)
+void Vulkan::set_shadow_cascade_count(std::uint32_t count) noexcept
+{
+    const std::uint32_t desired = std::clamp(count, 1u, MaxShadowCascades);
+    if (desired == m_shadowCascadeCount)
+        return;
+
+    const std::uint32_t previous = m_shadowCascadeCount;
+    vkDeviceWaitIdle(m_vulkanDevice.get_device());
+    cleanup_shadow_map();
+    m_shadowCascadeCount = desired;
+    if (auto result = create_shadow_map(); !result)
     {
-        if (auto result = create_nis_resources(); !result)
-        {
-            fmt::print("Warning: failed to create NIS resources: {}\n", result.error().message);
-            m_nisEnabled = false;
-        }
+        fmt::print("Warning: Failed to change shadow cascade count: {}\n", result.error().message);
+        cleanup_shadow_map();
+        m_shadowCascadeCount = previous;
+        if (auto restore = create_shadow_map(); !restore)
+            fmt::print("Warning: Failed to restore shadow map: {}\n", restore.error().message);
     }
-    else
+}
+
+std::uint32_t Vulkan::get_shadow_cascade_count() const noexcept
+{
+    return m_shadowCascadeCount;
+}
+
+void Vulkan::set_parallel_recording_enabled(bool enabled) noexcept
+{
+    m_parallelRecordingEnabled = enabled;
+}
+
+bool Vulkan::get_parallel_recording_enabled() const noexcept
+{
+    return m_parallelRecordingEnabled;
+}
+
+void Vulkan::set_dynamic_resolution_enabled(bool enabled) noexcept
+{
+    if (enabled == m_dynamicResolutionEnabled)
+        return;
+    m_dynamicResolutionEnabled = enabled;
+
+    // Start from the fixed render scale; the target is reallocated once at the maximum scale.
+    const auto [minScale, maxScale] = dynamic_resolution_range();
+    m_dynamicResolutionScale = std::clamp(m_renderScale, minScale, maxScale);
+    m_dynamicResolutionSamplesSeen = m_gpuProfiler.get_frame_samples_collected();
+    m_dynamicResolutionStarvedFrames = 0;
+    m_framebufferResized = true;
+}
+
+bool Vulkan::get_dynamic_resolution_enabled() const noexcept
+{
+    return m_dynamicResolutionEnabled;
+}
+
+void Vulkan::set_dynamic_resolution_target_ms(float milliseconds) noexcept
+{
+    m_dynamicResolutionTargetMs = std::clamp(milliseconds, 1.0f, 1000.0f);
+}
+
+float Vulkan::get_dynamic_resolution_target_ms() const noexcept
+{
+    return m_dynamicResolutionTargetMs;
+}
+
+void Vulkan::set_dynamic_resolution_scale_range(float minScale, float maxScale) noexcept
+{
+    minScale = std::clamp(minScale, MinDynamicResolutionScale, MaxDynamicResolutionScale);
+    maxScale = std::clamp(maxScale, minScale, MaxDynamicResolutionScale);
+    const bool targetChanged = std::fabs(maxScale - m_dynamicResolutionMaxScale) >= 0.0001f;
+    m_dynamicResolutionMinScale = minScale;
+    m_dynamicResolutionMaxScale = maxScale;
+
+    if (!m_dynamicResolutionEnabled)
+        return;
+    if (targetChanged)
     {
-        cleanup_nis_resources();
+        m_framebufferResized = true;
+        return;
     }
+    const auto [rangeMin, rangeMax] = dynamic_resolution_range();
+    m_dynamicResolutionScale = std::clamp(m_dynamicResolutionScale, rangeMin, rangeMax);
+    apply_scene_render_scale(m_dynamicResolutionScale);
 }
 
-bool Vulkan::get_nis_enabled() const noexcept
+float Vulkan::get_dynamic_resolution_min_scale() const noexcept
 {
-    return m_nisEnabled;
+    return m_dynamicResolutionMinScale;
 }
 
-void Vulkan::set_nis_sharpness(float sharpness) noexcept
+float Vulkan::get_dynamic_resolution_max_scale() const noexcept
 {
-    sharpness = std::clamp(sharpness, 0.0f, 1.0f);
-    if (std::fabs(sharpness - m_nisSharpness) < 0.001f)
+    return m_dynamicResolutionMaxScale;
+}
+
+void Vulkan::set_dynamic_resolution_response(float response) noexcept
+{
+    m_dynamicResolutionResponse = std::clamp(response, 0.01f, 1.0f);
+}
+
+float Vulkan::get_dynamic_resolution_response() const noexcept
+{
+    return m_dynamicResolutionResponse;
+}
+
+float Vulkan::get_dynamic_resolution_scale() const noexcept
+{
+    return m_dynamicResolutionEnabled ? m_dynamicResolutionScale : m_renderScale;
+}
+
+std::pair<float, float> Vulkan::dynamic_resolution_range() const noexcept
+{
+    // NIS only upscales by up to 2x per axis.
+    const float minScale =
+        std::max(m_dynamicResolutionMinScale, m_nisEnabled ? MinNisDynamicResolutionScale : MinDynamicResolutionScale);
+    return {std::min(minScale, m_dynamicResolutionMaxScale), m_dynamicResolutionMaxScale};
+}
+
+void Vulkan::update_dynamic_resolution() noexcept
+{
+    if (!m_dynamicResolutionEnabled)
         return;
-    m_nisSharpness = sharpness;
 
-    if (m_nisEnabled && m_nisConfigBuffer != nullptr)
+    const auto [minScale, maxScale] = dynamic_resolution_range();
+    float scale = std::clamp(m_dynamicResolutionScale, minScale, maxScale);
+
+    // Only a timing collected since the last update moves the scale. Without one the controller
+    // holds, so say so once instead of silently never adapting (no timestamp support, or queries
+    // that never become available).
+    const std::uint64_t samplesCollected = m_gpuProfiler.get_frame_samples_collected();
+    const bool newSample = samplesCollected != m_dynamicResolutionSamplesSeen;
+    m_dynamicResolutionSamplesSeen = samplesCollected;
+    if (newSample)
+        m_dynamicResolutionStarvedFrames = 0;
+    else if (++m_dynamicResolutionStarvedFrames == DynamicResolutionStarvedFrameLimit)
+        fmt::print("Warning: dynamic resolution got no GPU frame timing in {} frames; holding the render scale at "
+                   "{:.0f}%\n",
+                   DynamicResolutionStarvedFrameLimit, scale * 100.0f);
+
+    // The timing is MAX_FRAMES_IN_FLIGHT frames old; moving only part of the way each frame keeps
+    // that delay from turning into oscillation.
+    const GpuTimingStats& timing = m_gpuProfiler.get_frame_timing();
+    if (newSample && timing.lastMs > 0.0f)
     {
-        update_nis_config();
+        const float ratio = m_dynamicResolutionTargetMs / timing.lastMs;
+        if (std::fabs(ratio - 1.0f) > DynamicResolutionDeadband)
+        {
+            // GPU cost follows the pixel count, which grows with the square of the scale.
+            const float ideal = std::clamp(scale * std::sqrt(ratio), minScale, maxScale);
+            scale += (ideal - scale) * m_dynamicResolutionResponse;
+        }
     }
+
+    m_dynamicResolutionScale = scale;
+    apply_scene_render_scale(scale);
 }
 
-float Vulkan::get_nis_sharpness() const noexcept
+/// Texture streaming
+
+void Vulkan::set_texture_streaming_enabled(bool enabled) noexcept
 {
-    return m_nisSharpness;
+    m_textureStreamingEnabled = enabled;
 }
 
-void Vulkan::set_render_scale(float scale) noexcept
+bool Vulkan::get_texture_streaming_enabled() const noexcept
 {
-    constexpr float kMinRenderScale = 0.25f;
-    constexpr float kMinNisRenderScale = 0.5f;
-    scale = std::clamp(scale, kMinRenderScale, 2.0f);
+    return m_textureStreamingEnabled;
+}
 
-    if (m_nisEnabled && scale < kMinNisRenderScale)
+void Vulkan::set_texture_streaming_budget_fraction(float fraction) noexcept
+{
+    m_textureStreamingBudgetFraction =
+        std::clamp(fraction, MinTextureStreamingBudgetFraction, MaxTextureStreamingBudgetFraction);
+}
+
+float Vulkan::get_texture_streaming_budget_fraction() const noexcept
+{
+    return m_textureStreamingBudgetFraction;
+}
+
+void Vulkan::update_texture_streaming() noexcept
+{
+    if (m_streamedTextures.empty())
+        return;
+    NOC_PROFILE_ZONE("Vulkan::update_texture_streaming");
+
+    // This frame's fence has signalled, so only its set is free to repoint. A finished upload goes live
+    // here first and reaches the other sets as their own fences signal; the image it replaced is
+    // destroyed once no set names it, by which point every frame that sampled it has retired.
+    const auto currentFrameBit = static_cast<std::uint8_t>(1u << m_currentFrame);
+    constexpr auto allFrameBits = static_cast<std::uint8_t>((1u << MAX_FRAMES_IN_FLIGHT) - 1);
+    for (StreamedTexture& streamed : m_streamedTextures)
     {
-        scale = kMinNisRenderScale;
-        fmt::print("NIS requires render scale >= {:.2f}; clamping requested value.\n", kMinNisRenderScale);
+        if ((streamed.descriptorDirtyFrames & currentFrameBit) != 0)
+        {
+            write_texture_descriptor(m_currentFrame, streamed.textureIndex);
+            streamed.descriptorDirtyFrames &= static_cast<std::uint8_t>(~currentFrameBit);
+            if (streamed.descriptorDirtyFrames == 0)
+                destroy_texture_image(streamed.outgoing);
+        }
+        if (streamed.incoming.image != nullptr && streamed.outgoing.image == nullptr &&
+            m_uploadQueue.is_complete(streamed.incomingTicket))
+        {
+            streamed.outgoing = std::exchange(m_textures[streamed.textureIndex], std::exchange(streamed.incoming, {}));
+            streamed.residentLevel = streamed.incomingLevel;
+            write_texture_descriptor(m_currentFrame, streamed.textureIndex);
+            streamed.descriptorDirtyFrames = allFrameBits & static_cast<std::uint8_t>(~currentFrameBit);
+            if (streamed.descriptorDirtyFrames == 0)
+                destroy_texture_image(streamed.outgoing);
+        }
     }
 
-    if (std::fabs(scale - m_renderScale) < 0.0001f)
-        return;
+    // A texture needs the coarsest level still at least as large as the biggest on-screen diameter of
+    // any material using it. The sizes are from the last culled frame.
+    m_textureScreenPixelsScratch.assign(m_textures.size(), 0u);
+    const std::size_t materialCount = std::min(m_materials.size(), m_materialScreenPixels.size());
+    for (std::size_t materialIndex = 0; materialIndex < materialCount; ++materialIndex)
+    {
+        const std::uint32_t pixels = m_materialScreenPixels[materialIndex];
+        if (pixels == 0)
+            continue;
+        const GpuMaterial& material = m_materials[materialIndex];
+        for (const std::uint32_t textureIndex : {material.albedoTexture, material.normalTexture,
+                                                 material.roughnessTexture, material.metallicTexture,
+                                                 material.aoTexture})
+        {
+            if (textureIndex < m_textureScreenPixelsScratch.size())
+                m_textureScreenPixelsScratch[textureIndex] =
+                    std::max(m_textureScreenPixelsScratch[textureIndex], pixels);
+        }
+    }
 
-    m_renderScale = scale;
-    m_framebufferResized = true;
+    std::uint32_t missingMips{};
+    for (StreamedTexture& streamed : m_streamedTextures)
+    {
+        const std::uint32_t pixels = m_textureScreenPixelsScratch[streamed.textureIndex];
+        if (!m_textureStreamingEnabled)
+        {
+            streamed.desiredLevel = 0;
+        }
+        else if (pixels == 0)
+        {
+            streamed.desiredLevel = streamed.baseLevel;
+        }
+        else
+        {
+            std::uint32_t level = streamed.baseLevel;
+            while (level > 0 &&
+                   std::max(streamed.levels[level].extent.width, streamed.levels[level].extent.height) < pixels)
+                --level;
+            streamed.desiredLevel = level;
+            streamed.lastVisibleFrame = m_frameNumber;
+        }
+        if (streamed.residentLevel > streamed.desiredLevel)
+            missingMips += streamed.residentLevel - streamed.desiredLevel;
+    }
+    m_textureStreamingMissingMips = missingMips;
+
+    // Images still uploading are not in the (periodically cached) usage yet; counting them anyway errs
+    // on the side of staying under the budget.
+    const DeviceLocalMemoryBudget budget = m_vulkanDevice.get_device_local_memory_budget();
+    const bool budgeted = budget.supported && budget.budgetBytes > 0 && m_textureStreamingEnabled;
+    const std::uint64_t limitBytes =
+        budgeted ? static_cast<std::uint64_t>(static_cast<double>(budget.budgetBytes) * m_textureStreamingBudgetFraction)
+                 : std::numeric_limits<std::uint64_t>::max();
+    m_textureStreamingLimitBytes = budgeted ? limitBytes : 0;
+    std::uint64_t usageBytes = budgeted ? budget.usageBytes : 0;
+    std::uint32_t inFlight{};
+    for (const StreamedTexture& streamed : m_streamedTextures)
+    {
+        usageBytes += streamed.incoming.allocationBytes;
+        inFlight += streamed.is_swapping() ? 1u : 0u;
+    }
+
+    std::vector<std::uint32_t>& order = m_textureStreamOrderScratch;
+    order.clear();
+    const auto startedTicket = std::numeric_limits<UploadTicket>::max(); // until the batch is flushed
+    std::uint32_t started{};
+    VkDeviceSize stagedBytes{};
+    const auto start = [&](StreamedTexture& streamed, std::uint32_t targetLevel) {
+        if (auto result = start_texture_stream(streamed, targetLevel); !result)
+        {
+            fmt::print("Warning: failed to stream texture '{}': {}\n", streamed.name, result.error().message);
+            return false;
+        }
+        streamed.incomingTicket = startedTicket;
+        usageBytes += streamed.incoming.allocationBytes;
+        stagedBytes += streamed.chain_bytes(targetLevel);
+        ++started;
+        ++inFlight;
+        return true;
+    };
+
+    if (usageBytes > limitBytes)
+    {
+        // Over budget: drop a level at a time, starting with textures finer than they need to be and then
+        // the ones longest off screen. The smaller replacement frees the old image once it is swapped in.
+        for (std::uint32_t index = 0; index < m_streamedTextures.size(); ++index)
+        {
+            const StreamedTexture& streamed = m_streamedTextures[index];
+            if (streamed.residentLevel < streamed.baseLevel && !streamed.is_swapping())
+                order.push_back(index);
+        }
+        std::sort(order.begin(), order.end(), [&](std::uint32_t lhs, std::uint32_t rhs) {
+            const StreamedTexture& a = m_streamedTextures[lhs];
+            const StreamedTexture& b = m_streamedTextures[rhs];
+            const bool aExcess = a.residentLevel < a.desiredLevel;
+            const bool bExcess = b.residentLevel < b.desiredLevel;
+            if (aExcess != bExcess)
+                return aExcess;
+            return a.lastVisibleFrame < b.lastVisibleFrame;
+        });
+
+        std::uint64_t overBytes = usageBytes - limitBytes;
+        for (const std::uint32_t index : order)
+        {
+            if (overBytes == 0 || inFlight >= MaxTextureStreamsInFlight)
+                break;
+            StreamedTexture& streamed = m_streamedTextures[index];
+            const std::uint32_t targetLevel = std::max(streamed.desiredLevel, streamed.residentLevel + 1);
+            const std::uint64_t freedBytes = m_textures[streamed.textureIndex].allocationBytes;
+            if (!start(streamed, targetLevel))
+                break;
+            overBytes -= std::min(overBytes, freedBytes);
+        }
+    }
+    else
+    {
+        // Under budget: bring in the textures furthest from their desired level first, then the largest on
+        // screen, each at the finest level that still fits.
+        for (std::uint32_t index = 0; index < m_streamedTextures.size(); ++index)
+        {
+            const StreamedTexture& streamed = m_streamedTextures[index];
+            if (streamed.residentLevel > streamed.desiredLevel && !streamed.is_swapping())
+                order.push_back(index);
+        }
+        std::sort(order.begin(), order.end(), [&](std::uint32_t lhs, std::uint32_t rhs) {
+            const StreamedTexture& a = m_streamedTextures[lhs];
+            const StreamedTexture& b = m_streamedTextures[rhs];
+            const std::uint32_t aGap = a.residentLevel - a.desiredLevel;
+            const std::uint32_t bGap = b.residentLevel - b.desiredLevel;
+            if (aGap != bGap)
+                return aGap > bGap;
+            return m_textureScreenPixelsScratch[a.textureIndex] > m_textureScreenPixelsScratch[b.textureIndex];
+        });
+
+        for (const std::uint32_t index : order)
+        {
+            if (inFlight >= MaxTextureStreamsInFlight || stagedBytes >= MaxTextureStreamBytesPerFrame)
+                break;
+            StreamedTexture& streamed = m_streamedTextures[index];
+            // The first stream of a frame may exceed the staging cap, so no chain is too large to ever load.
+            std::uint32_t targetLevel = streamed.desiredLevel;
+            while (targetLevel < streamed.residentLevel)
+            {
+                const std::uint64_t bytes = streamed.chain_bytes(targetLevel);
+                if (usageBytes + bytes <= limitBytes &&
+                    (stagedBytes == 0 || stagedBytes + bytes <= MaxTextureStreamBytesPerFrame))
+                    break;
+                ++targetLevel;
+            }
+            if (targetLevel == streamed.residentLevel)
+                continue;
+            if (!start(streamed, targetLevel))
+                break;
+        }
+    }
+
+    if (started > 0)
+    {
+        auto flushResult = m_uploadQueue.flush();
+        for (StreamedTexture& streamed : m_streamedTextures)
+        {
+            if (streamed.incoming.image == nullptr || streamed.incomingTicket != startedTicket)
+                continue;
+            if (flushResult)
+            {
+                streamed.incomingTicket = flushResult.value();
+            }
+            else
+            {
+                // The batch was never submitted, so nothing references the new images.
+                destroy_texture_image(streamed.incoming);
+                --inFlight;
+            }
+        }
+        if (!flushResult)
+            fmt::print("Warning: failed to submit texture streaming uploads: {}\n", flushResult.error().message);
+    }
+    m_textureStreamsInFlight = inFlight;
 }
 
-float Vulkan::get_render_scale() const noexcept
+Result<> Vulkan::start_texture_stream(StreamedTexture& streamed, std::uint32_t targetLevel)
 {
-    return m_renderScale;
+    auto textureResult = create_texture_image(streamed.name, streamed.format, streamed.components, streamed.levels,
+                                              targetLevel, streamed.pixels);
+    if (!textureResult)
+        return make_error(textureResult.error());
+    streamed.incoming = textureResult.value();
+    streamed.incomingLevel = targetLevel;
+    return {};
 }
 
 /// Shader management
@@ -2864,13 +6830,11 @@ void Vulkan::set_shader_paths(const std::filesystem::path& vertPath, const std::
 {
     m_vertShaderPath = vertPath;
     m_fragShaderPath = fragPath;
+    m_shaderReloader.set_sources(m_vertShaderPath, m_fragShaderPath);
 }
 
 Result<> Vulkan::recompile_shaders()
 {
-    VkDevice device = m_vulkanDevice.get_device();
-    vkDeviceWaitIdle(device);
-
     auto vertResult = ShaderCompiler::load_or_compile(m_vertShaderPath, m_shaderLoadMode);
     if (!vertResult)
         return make_error(vertResult.error());
@@ -2879,10 +6843,127 @@ Result<> Vulkan::recompile_shaders()
     if (!fragResult)
         return make_error(fragResult.error());
 
+    // Build next to the live pipeline; frames still in flight keep the old one until it retires.
+    const MultisampleConfig msConfig = scene_pipeline_config();
+    auto shaderSetResult = m_pipeline.build_shader_set(m_sceneRenderPass, msConfig, vertResult.value(), fragResult.value());
+    if (!shaderSetResult)
+        return make_error(shaderSetResult.error());
+
     m_vertSpirv = std::move(vertResult.value());
     m_fragSpirv = std::move(fragResult.value());
+    retire_shader_set(m_pipeline.swap_shader_set(std::move(shaderSetResult.value())));
+    prewarm_pipeline_variants();
+    return {};
+}
 
-    m_pipeline.cleanup();
-    MultisampleConfig msConfig{m_msaaSamples, m_alphaToCoverageEnabled, m_sampleShadingEnabled, m_minSampleShading};
-    return m_pipeline.initialize(m_sceneRenderPass, msConfig, m_vertSpirv, m_fragSpirv);
+bool Vulkan::is_shader_reload_pending() const noexcept
+{
+    if (m_shaderReloader.is_compiling())
+        return true;
+    if (!m_pendingShaderBuild)
+        return false;
+    std::lock_guard lock{m_pendingShaderBuild->mutex};
+    return !m_pendingShaderBuild->done;
+}
+
+void Vulkan::update_shader_reload() noexcept
+{
+    destroy_retired_shader_sets(false);
+
+    // 1. Swap in a finished build. The frame about to be recorded is the first to use it.
+    if (m_pendingShaderBuild)
+    {
+        std::optional<Result<PipelineShaderSet>> built{};
+        {
+            std::lock_guard lock{m_pendingShaderBuild->mutex};
+            if (m_pendingShaderBuild->done)
+                built = std::move(m_pendingShaderBuild->result);
+        }
+        if (built)
+        {
+            const std::shared_ptr<PendingShaderBuild> pending = std::move(m_pendingShaderBuild);
+            if (!built->has_value())
+            {
+                m_shaderReloadStatus = make_error(built->error());
+            }
+            else
+            {
+                m_vertSpirv = std::move(pending->vertSpirv);
+                m_fragSpirv = std::move(pending->fragSpirv);
+                const MultisampleConfig builtConfig = built->value().config;
+                retire_shader_set(m_pipeline.swap_shader_set(std::move(built->value())));
+
+                // Settings may have changed while building; the current variant compiles on the spot.
+                const MultisampleConfig msConfig = scene_pipeline_config();
+                Result<> selectResult{};
+                if (!builtConfig.same_pipeline_state(msConfig))
+                    selectResult = m_pipeline.select_variant(m_sceneRenderPass, msConfig);
+                prewarm_pipeline_variants();
+                m_shaderReloadStatus = std::move(selectResult);
+            }
+        }
+    }
+
+    // 2. Start a pipeline build for freshly compiled SPIR-V. One build at a time: a compile that
+    //    finishes meanwhile stays with the reloader until this one is swapped in.
+    if (m_pendingShaderBuild)
+        return;
+    auto compiled = m_shaderReloader.poll();
+    if (!compiled)
+        return;
+    if (!compiled->has_value())
+    {
+        m_shaderReloadStatus = make_error(compiled->error());
+        return;
+    }
+
+    auto renderPassResult = create_compatible_scene_render_pass(m_msaaSamples);
+    if (!renderPassResult)
+    {
+        m_shaderReloadStatus = make_error(renderPassResult.error());
+        return;
+    }
+
+    auto pending = std::make_shared<PendingShaderBuild>();
+    pending->vertSpirv = std::move(compiled->value().vertSpirv);
+    pending->fragSpirv = std::move(compiled->value().fragSpirv);
+    m_pendingShaderBuild = pending;
+
+    const MultisampleConfig msConfig = scene_pipeline_config();
+    JobSystem::get().submit(JobPriority::Background, [this, pending, msConfig, renderPass = renderPassResult.value()]() {
+        // Goes through the persistent pipeline cache, so an unchanged shader rebuilds almost for free.
+        Result<PipelineShaderSet> result =
+            m_pipeline.build_shader_set(renderPass, msConfig, pending->vertSpirv, pending->fragSpirv);
+        vkDestroyRenderPass(m_vulkanDevice.get_device(), renderPass, nullptr);
+
+        std::lock_guard lock{pending->mutex};
+        pending->result = std::move(result);
+        pending->done = true;
+        pending->finished.notify_all();
+    });
+}
+
+void Vulkan::retire_shader_set(PipelineShaderSet&& shaderSet)
+{
+    m_retiredShaderSets.push_back(RetiredShaderSet{std::move(shaderSet), m_frameNumber});
+}
+
+void Vulkan::destroy_retired_shader_sets(bool all) noexcept
+{
+    // A set replaced before frame N was last recorded into frame N-1; that frame's fence has been
+    // waited on once MAX_FRAMES_IN_FLIGHT more frames have started.
+    std::erase_if(m_retiredShaderSets, [this, all](RetiredShaderSet& retired) {
+        if (!all && m_frameNumber < retired.retiredOnFrame + static_cast<std::uint64_t>(MAX_FRAMES_IN_FLIGHT))
+            return false;
+        m_pipeline.destroy_shader_set(retired.shaderSet);
+        return true;
+    });
+}
+
+void Vulkan::wait_for_shader_build() noexcept
+{
+    if (!m_pendingShaderBuild)
+        return;
+    std::unique_lock lock{m_pendingShaderBuild->mutex};
+    m_pendingShaderBuild->finished.wait(lock, [this] { return m_pendingShaderBuild->done; });
 }
@@ -0,0 +1,352 @@
+#include "../Public/VulkanAllocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+
+#include <fmt/core.h>
+
+namespace
+{
+constexpr VkDeviceSize DefaultBlockSize{64ull * 1024 * 1024};
+constexpr VkDeviceSize MinBlockSize{4ull * 1024 * 1024};
+
+VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) noexcept
+{
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+} // namespace
+
+VulkanAllocator::~VulkanAllocator()
+{
+    cleanup();
+}
+
+void VulkanAllocator::initialize(VkPhysicalDevice physicalDevice, VkDevice device) noexcept
+{
+    std::lock_guard lock(m_mutex);
+    m_device = device;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memoryProperties);
+
+    // Small heaps (e.g. the 256 MiB BAR window) get proportionally smaller blocks.
+    for (std::uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i)
+    {
+        const VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[i].heapIndex].size;
+        m_blockSizes[i] = std::clamp(heapSize / 8, MinBlockSize, DefaultBlockSize);
+    }
+}
+
+void VulkanAllocator::cleanup() noexcept
+{
+    std::lock_guard lock(m_mutex);
+    if (m_device == nullptr)
+        return;
+
+    std::uint32_t leakedAllocations{};
+    for (auto& kindPools : m_pools)
+    {
+        for (auto& pool : kindPools)
+        {
+            for (auto& block : pool.blocks)
+            {
+                leakedAllocations += block.allocationCount;
+                destroy_block(block);
+            }
+            pool.blocks.clear();
+        }
+    }
+
+    std::uint32_t leakedDedicated{};
+    for (const auto& stats : m_stats)
+        leakedDedicated += stats.dedicatedCount;
+    if (leakedAllocations + leakedDedicated > 0)
+        fmt::print("Warning: VulkanAllocator cleaned up with {} live sub-allocations and {} dedicated allocations\n",
+                   leakedAllocations, leakedDedicated);
+
+    m_stats = {};
+    m_deviceMemoryCount = 0;
+    m_device = nullptr;
+}
+
+Result<VulkanAllocation> VulkanAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    std::uint32_t memoryTypeIndex,
+    VulkanResourceKind kind
+)
+{
+    if (memoryTypeIndex >= m_memoryProperties.memoryTypeCount)
+        return make_error("Invalid memory type index for sub-allocation", ErrorCode::VulkanMemoryTypeMissing);
+
+    std::lock_guard lock(m_mutex);
+    const VkDeviceSize blockSize = m_blockSizes[memoryTypeIndex];
+    if (requirements.size > blockSize / 2)
+        return allocate_dedicated(requirements, memoryTypeIndex, kind);
+
+    Pool& pool = get_pool(memoryTypeIndex, kind);
+    VkDeviceSize offset{};
+    std::uint32_t blockIndex = std::numeric_limits<std::uint32_t>::max();
+    for (std::uint32_t i = 0; i < pool.blocks.size(); ++i)
+    {
+        if (pool.blocks[i].memory != nullptr && try_allocate_from_block(pool.blocks[i], requirements, offset))
+        {
+            blockIndex = i;
+            break;
+        }
+    }
+
+    if (blockIndex == std::numeric_limits<std::uint32_t>::max())
+    {
+        auto blockResult = create_block(pool, memoryTypeIndex, kind, blockSize);
+        if (!blockResult)
+            return make_error(blockResult.error());
+        blockIndex = blockResult.value();
+        if (!try_allocate_from_block(pool.blocks[blockIndex], requirements, offset))
+            return make_error("Sub-allocation does not fit into a fresh memory block", ErrorCode::VulkanMemoryAllocationFailed);
+    }
+
+    Block& block = pool.blocks[blockIndex];
+    block.usedBytes += requirements.size;
+    ++block.allocationCount;
+
+    VulkanAllocatorStats& stats = m_stats[static_cast<std::size_t>(kind)];
+    stats.usedBytes += requirements.size;
+    ++stats.allocationCount;
+
+    VulkanAllocation allocation{};
+    allocation.memory = block.memory;
+    allocation.offset = offset;
+    allocation.size = requirements.size;
+    allocation.mapped = block.mapped != nullptr ? static_cast<std::byte*>(block.mapped) + offset : nullptr;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    allocation.blockIndex = blockIndex;
+    allocation.kind = kind;
+    allocation.dedicated = false;
+    return allocation;
+}
+
+void VulkanAllocator::free(VulkanAllocation& allocation) noexcept
+{
+    if (!allocation.is_valid())
+        return;
+
+    std::lock_guard lock(m_mutex);
+    VulkanAllocatorStats& stats = m_stats[static_cast<std::size_t>(allocation.kind)];
+    stats.usedBytes -= std::min<std::uint64_t>(stats.usedBytes, allocation.size);
+    stats.allocationCount -= std::min<std::uint32_t>(stats.allocationCount, 1);
+
+    if (allocation.dedicated)
+    {
+        if (allocation.mapped != nullptr)
+            vkUnmapMemory(m_device, allocation.memory);
+        vkFreeMemory(m_device, allocation.memory, nullptr);
+        stats.reservedBytes -= std::min<std::uint64_t>(stats.reservedBytes, allocation.size);
+        stats.dedicatedCount -= std::min<std::uint32_t>(stats.dedicatedCount, 1);
+        --m_deviceMemoryCount;
+        allocation = {};
+        return;
+    }
+
+    Pool& pool = get_pool(allocation.memoryTypeIndex, allocation.kind);
+    if (allocation.blockIndex >= pool.blocks.size() || pool.blocks[allocation.blockIndex].memory != allocation.memory)
+    {
+        fmt::print("Warning: VulkanAllocator::free called with an allocation from an unknown block\n");
+        allocation = {};
+        return;
+    }
+
+    Block& block = pool.blocks[allocation.blockIndex];
+    release_range(block, allocation.offset, allocation.size);
+    block.usedBytes -= std::min(block.usedBytes, allocation.size);
+    --block.allocationCount;
+
+    // Keep one empty block around per pool so level reloads don't churn vkAllocateMemory.
+    if (block.allocationCount == 0)
+    {
+        const bool hasOtherEmptyBlock = std::any_of(pool.blocks.begin(), pool.blocks.end(), [&](const Block& other) {
+            return &other != &block && other.memory != nullptr && other.allocationCount == 0;
+        });
+        if (hasOtherEmptyBlock)
+        {
+            stats.reservedBytes -= std::min<std::uint64_t>(stats.reservedBytes, block.size);
+            stats.blockCount -= std::min<std::uint32_t>(stats.blockCount, 1);
+            destroy_block(block);
+        }
+    }
+
+    allocation = {};
+}
+
+VulkanAllocatorStats VulkanAllocator::get_stats(VulkanResourceKind kind) const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_stats[static_cast<std::size_t>(kind)];
+}
+
+std::uint32_t VulkanAllocator::get_device_memory_count() const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_deviceMemoryCount;
+}
+
+Result<std::uint32_t> VulkanAllocator::create_block(
+    Pool& pool,
+    std::uint32_t memoryTypeIndex,
+    VulkanResourceKind kind,
+    VkDeviceSize size
+)
+{
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    Block block{};
+    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &block.memory) != VK_SUCCESS)
+        return make_error("Failed to allocate device memory block", ErrorCode::VulkanMemoryAllocationFailed);
+
+    if (is_host_visible(memoryTypeIndex) && vkMapMemory(m_device, block.memory, 0, size, 0, &block.mapped) != VK_SUCCESS)
+    {
+        vkFreeMemory(m_device, block.memory, nullptr);
+        return make_error("Failed to map device memory block", ErrorCode::VulkanMemoryAllocationFailed);
+    }
+
+    block.size = size;
+    block.freeRanges.emplace(0, size);
+    ++m_deviceMemoryCount;
+
+    VulkanAllocatorStats& stats = m_stats[static_cast<std::size_t>(kind)];
+    stats.reservedBytes += size;
+    ++stats.blockCount;
+
+    // Reuse the slot of a previously released block so live allocations keep their block index.
+    for (std::uint32_t i = 0; i < pool.blocks.size(); ++i)
+    {
+        if (pool.blocks[i].memory == nullptr)
+        {
+            pool.blocks[i] = std::move(block);
+            return i;
+        }
+    }
+    pool.blocks.push_back(std::move(block));
+    return static_cast<std::uint32_t>(pool.blocks.size() - 1);
+}
+
+Result<VulkanAllocation> VulkanAllocator::allocate_dedicated(
+    const VkMemoryRequirements& requirements,
+    std::uint32_t memoryTypeIndex,
+    VulkanResourceKind kind
+)
+{
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = requirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VulkanAllocation allocation{};
+    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &allocation.memory) != VK_SUCCESS)
+        return make_error("Failed to allocate dedicated device memory", ErrorCode::VulkanMemoryAllocationFailed);
+
+    if (is_host_visible(memoryTypeIndex) &&
+        vkMapMemory(m_device, allocation.memory, 0, requirements.size, 0, &allocation.mapped) != VK_SUCCESS)
+    {
+        vkFreeMemory(m_device, allocation.memory, nullptr);
+        return make_error("Failed to map dedicated device memory", ErrorCode::VulkanMemoryAllocationFailed);
+    }
+
+    allocation.offset = 0;
+    allocation.size = requirements.size;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    allocation.kind = kind;
+    allocation.dedicated = true;
+    ++m_deviceMemoryCount;
+
+    VulkanAllocatorStats& stats = m_stats[static_cast<std::size_t>(kind)];
+    stats.reservedBytes += requirements.size;
+    stats.usedBytes += requirements.size;
+    ++stats.dedicatedCount;
+    ++stats.allocationCount;
+    return allocation;
+}
+
+bool VulkanAllocator::try_allocate_from_block(Block& block, const VkMemoryRequirements& requirements,
+                                              VkDeviceSize& outOffset)
+{
+    // Best fit: the smallest free range that still holds the aligned request.
+    auto best = block.freeRanges.end();
+    VkDeviceSize bestSize = std::numeric_limits<VkDeviceSize>::max();
+    for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it)
+    {
+        const VkDeviceSize alignedOffset = align_up(it->first, requirements.alignment);
+        const VkDeviceSize rangeEnd = it->first + it->second;
+        if (alignedOffset + requirements.size > rangeEnd || it->second >= bestSize)
+            continue;
+
+        best = it;
+        bestSize = it->second;
+        if (alignedOffset == it->first && it->second == requirements.size)
+            break; // exact fit
+    }
+    if (best == block.freeRanges.end())
+        return false;
+
+    const VkDeviceSize rangeOffset = best->first;
+    const VkDeviceSize rangeEnd = best->first + best->second;
+    const VkDeviceSize alignedOffset = align_up(rangeOffset, requirements.alignment);
+    block.freeRanges.erase(best);
+
+    if (alignedOffset > rangeOffset)
+        block.freeRanges.emplace(rangeOffset, alignedOffset - rangeOffset);
+    const VkDeviceSize allocationEnd = alignedOffset + requirements.size;
+    if (allocationEnd < rangeEnd)
+        block.freeRanges.emplace(allocationEnd, rangeEnd - allocationEnd);
+
+    outOffset = alignedOffset;
+    return true;
+}
+
+void VulkanAllocator::release_range(Block& block, VkDeviceSize offset, VkDeviceSize size)
+{
+    auto [it, inserted] = block.freeRanges.emplace(offset, size);
+    if (!inserted)
+        return; // double free; keep the existing range
+
+    // Coalesce with the following range.
+    if (auto next = std::next(it); next != block.freeRanges.end() && it->first + it->second == next->first)
+    {
+        it->second += next->second;
+        block.freeRanges.erase(next);
+    }
+    // Coalesce with the preceding range.
+    if (it != block.freeRanges.begin())
+    {
+        auto prev = std::prev(it);
+        if (prev->first + prev->second == it->first)
+        {
+            prev->second += it->second;
+            block.freeRanges.erase(it);
+        }
+    }
+}
+
+void VulkanAllocator::destroy_block(Block& block) noexcept
+{
+    if (block.memory != nullptr)
+    {
+        if (block.mapped != nullptr)
+            vkUnmapMemory(m_device, block.memory);
+        vkFreeMemory(m_device, block.memory, nullptr);
+        --m_deviceMemoryCount;
+    }
+    block = {};
+}
+
+VulkanAllocator::Pool& VulkanAllocator::get_pool(std::uint32_t memoryTypeIndex, VulkanResourceKind kind) noexcept
+{
+    return m_pools[static_cast<std::size_t>(kind)][memoryTypeIndex];
+}
+
+bool VulkanAllocator::is_host_visible(std::uint32_t memoryTypeIndex) const noexcept
+{
+    return (m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
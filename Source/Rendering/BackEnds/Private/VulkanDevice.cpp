@@ -49,6 +49,8 @@ void VulkanDevice::cleanup() noexcept
         m_commandPool = nullptr;
     }
 
+    m_allocator.cleanup();
+
     if (m_device)
     {
         vkDestroyDevice(m_device, nullptr);
@@ -73,6 +75,9 @@ void VulkanDevice::cleanup() noexcept
         m_instance = nullptr;
     }
     m_hasMemoryBudgetExtension = false;
+    m_hasDrawIndirectCountExtension = false;
+    m_supportsIndirectFirstInstance = false;
+    m_cmdDrawIndexedIndirectCount = nullptr;
     m_getPhysicalDeviceMemoryProperties2 = nullptr;
     m_getPhysicalDeviceMemoryProperties2KHR = nullptr;
     m_cachedMemoryBudget = {};
@@ -194,6 +199,9 @@ std::vector<const char*> VulkanDevice::get_required_extensions()
 
     std::vector<const char*> extensions{glfwExtensions, glfwExtensions + glfwExtensionCount};
 
+    // Needed on a 1.0 instance to query descriptor indexing features.
+    extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+
     if (m_enableValidationLayers)
     {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -277,6 +285,9 @@ Result<> VulkanDevice::pick_physical_device()
     }
 
     m_hasMemoryBudgetExtension = false;
+    m_hasDrawIndirectCountExtension = false;
+    m_hasPresentIdExtension = false;
+    m_hasPresentWaitExtension = false;
     std::uint32_t extensionCount{};
     vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
     if (extensionCount > 0)
@@ -286,10 +297,13 @@ Result<> VulkanDevice::pick_physical_device()
         for (const auto& extension : availableExtensions)
         {
             if (std::strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0)
-            {
                 m_hasMemoryBudgetExtension = true;
-                break;
-            }
+            else if (std::strcmp(extension.extensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) == 0)
+                m_hasDrawIndirectCountExtension = true;
+            else if (std::strcmp(extension.extensionName, VK_KHR_PRESENT_ID_EXTENSION_NAME) == 0)
+                m_hasPresentIdExtension = true;
+            else if (std::strcmp(extension.extensionName, VK_KHR_PRESENT_WAIT_EXTENSION_NAME) == 0)
+                m_hasPresentWaitExtension = true;
         }
     }
 
@@ -325,6 +339,7 @@ bool VulkanDevice::is_device_suitable(VkPhysicalDevice device) noexcept
     bool suitable = indices.is_complete() &&
         extensionsSupported &&
         swapChainAdequate &&
+        check_descriptor_indexing_support(device) &&
         deviceProperties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
     if (suitable)
         fmt::print("Selected GPU: {}\n", deviceProperties.deviceName);
@@ -350,6 +365,27 @@ bool VulkanDevice::check_device_extension_support(VkPhysicalDevice device) noexc
     return requiredExtensions.empty();
 }
 
+bool VulkanDevice::check_descriptor_indexing_support(VkPhysicalDevice device) const noexcept
+{
+    const auto getFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+        vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceFeatures2KHR")
+        );
+    if (getFeatures2 == nullptr)
+        return false;
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2KHR features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features.pNext = &indexingFeatures;
+    getFeatures2(device, &features);
+
+    return indexingFeatures.runtimeDescriptorArray == VK_TRUE &&
+           indexingFeatures.shaderSampledImageArrayNonUniformIndexing == VK_TRUE &&
+           indexingFeatures.descriptorBindingPartiallyBound == VK_TRUE &&
+           indexingFeatures.descriptorBindingUpdateUnusedWhilePending == VK_TRUE;
+}
+
 DeviceLocalMemoryBudget VulkanDevice::get_device_local_memory_budget() const noexcept
 {
     DeviceLocalMemoryBudget result{};
@@ -404,6 +440,8 @@ Result<> VulkanDevice::create_logical_device()
         indices.graphicsFamily.value(),
         indices.presentFamily.value(),
     };
+    if (indices.transferFamily.has_value())
+        uniqueQueueFamilies.insert(indices.transferFamily.value());
 
     float queuePriority{1.0f};
     for (std::uint32_t queueFamily : uniqueQueueFamilies)
@@ -421,17 +459,81 @@ Result<> VulkanDevice::create_logical_device()
 
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.sampleRateShading = supportedFeatures.sampleRateShading; // for sample shading (partial SSAA)
+    deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance; // for GPU-driven culling
+    m_supportsIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+    deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect; // for merged indirect draws over arena pages
+    m_supportsMultiDrawIndirect = supportedFeatures.multiDrawIndirect == VK_TRUE;
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC; // for cooked BC4/BC5/BC7 textures
+    m_supportsTextureCompressionBC = supportedFeatures.textureCompressionBC == VK_TRUE;
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery; // for GPU profiler counters
+    m_supportsPipelineStatistics = supportedFeatures.pipelineStatisticsQuery == VK_TRUE;
+    deviceFeatures.inheritedQueries = supportedFeatures.inheritedQueries; // for statistics over secondary command buffers
+    m_supportsInheritedQueries = supportedFeatures.inheritedQueries == VK_TRUE;
+
+    std::vector<const char*> enabledExtensions{m_deviceExtensions.begin(), m_deviceExtensions.end()};
+    if (m_hasDrawIndirectCountExtension)
+        enabledExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+    // Bindless textures: one partially bound sampler array, new elements written while older frames are in flight.
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+    indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+    indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+    indexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+
+    VkPhysicalDeviceProperties deviceProperties{};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &deviceProperties);
+    const VkPhysicalDeviceLimits& limits = deviceProperties.limits;
+    constexpr std::uint32_t maxBindlessTextures{4096};
+    constexpr std::uint32_t reservedSamplers{8}; // left for NIS, ImGui and other fixed bindings
+    m_maxBindlessTextures = std::min({maxBindlessTextures, limits.maxPerStageDescriptorSamplers,
+                                      limits.maxPerStageDescriptorSampledImages, limits.maxDescriptorSetSamplers,
+                                      limits.maxDescriptorSetSampledImages});
+    m_maxBindlessTextures = m_maxBindlessTextures > reservedSamplers * 2 ? m_maxBindlessTextures - reservedSamplers
+                                                                         : m_maxBindlessTextures;
+
+    // Present pacing: both features or neither, since waiting needs the ids.
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    bool enablePresentWait = false;
+    if (m_hasPresentIdExtension && m_hasPresentWaitExtension)
+    {
+        const auto getFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2KHR>(
+            vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceFeatures2KHR")
+            );
+        if (getFeatures2 != nullptr)
+        {
+            presentIdFeatures.pNext = &presentWaitFeatures;
+            VkPhysicalDeviceFeatures2KHR features{};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+            features.pNext = &presentIdFeatures;
+            getFeatures2(m_physicalDevice, &features);
+            enablePresentWait = presentIdFeatures.presentId == VK_TRUE && presentWaitFeatures.presentWait == VK_TRUE;
+        }
+    }
+    if (enablePresentWait)
+    {
+        enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        presentIdFeatures.pNext = &presentWaitFeatures;
+        presentWaitFeatures.pNext = nullptr;
+        indexingFeatures.pNext = &presentIdFeatures;
+    }
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &indexingFeatures;
 
     createInfo.queueCreateInfoCount = static_cast<std::uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
     createInfo.pEnabledFeatures = &deviceFeatures;
 
-    createInfo.enabledExtensionCount = static_cast<std::uint32_t>(m_deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
+    createInfo.enabledExtensionCount = static_cast<std::uint32_t>(enabledExtensions.size());
+    createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
     if (m_enableValidationLayers)
     {
@@ -451,6 +553,23 @@ Result<> VulkanDevice::create_logical_device()
     vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
 
+    m_hasDedicatedTransferQueue = indices.transferFamily.has_value();
+    m_transferQueueFamilyIndex = indices.transferFamily.value_or(indices.graphicsFamily.value());
+    vkGetDeviceQueue(m_device, m_transferQueueFamilyIndex, 0, &m_transferQueue);
+    m_concurrentQueueFamilies = {indices.graphicsFamily.value(), m_transferQueueFamilyIndex};
+    m_allocator.initialize(m_physicalDevice, m_device);
+
+    m_cmdDrawIndexedIndirectCount = nullptr;
+    if (m_hasDrawIndirectCountExtension)
+    {
+        m_cmdDrawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            vkGetDeviceProcAddr(m_device, "vkCmdDrawIndexedIndirectCountKHR")
+            );
+    }
+    m_waitForPresent = nullptr;
+    if (enablePresentWait)
+        m_waitForPresent = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(m_device, "vkWaitForPresentKHR"));
+
     return {};
 }
 
@@ -505,6 +624,17 @@ QueueFamilyIndices VulkanDevice::find_queue_families(VkPhysicalDevice device) no
         i++;
     }
 
+    // Prefer a DMA-style family (transfer without graphics/compute) for asset uploads.
+    for (std::uint32_t familyIndex = 0; familyIndex < queueFamilyCount; ++familyIndex)
+    {
+        const VkQueueFlags flags = queueFamilies[familyIndex].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) != 0 && (flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == 0)
+        {
+            indices.transferFamily = familyIndex;
+            break;
+        }
+    }
+
     return indices;
 }
 
@@ -609,6 +739,70 @@ Result<> VulkanDevice::create_buffer(
     return {};
 }
 
+Result<> VulkanDevice::create_buffer(
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags properties,
+    VkBuffer& buffer,
+    VulkanAllocation& allocation
+)
+{
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (m_hasDedicatedTransferQueue)
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<std::uint32_t>(m_concurrentQueueFamilies.size());
+        bufferInfo.pQueueFamilyIndices = m_concurrentQueueFamilies.data();
+    }
+
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+    {
+        return make_error("Failed to create buffer", ErrorCode::VulkanBufferCreationFailed);
+    }
+
+    VkMemoryRequirements memRequirements{};
+    vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
+
+    auto memTypeResult = find_memory_type(memRequirements.memoryTypeBits, properties);
+    if (!memTypeResult)
+    {
+        vkDestroyBuffer(m_device, buffer, nullptr);
+        buffer = nullptr;
+        return make_error(memTypeResult.error());
+    }
+
+    auto allocationResult = m_allocator.allocate(memRequirements, memTypeResult.value(), VulkanResourceKind::Buffer);
+    if (!allocationResult)
+    {
+        vkDestroyBuffer(m_device, buffer, nullptr);
+        buffer = nullptr;
+        return make_error(allocationResult.error());
+    }
+    allocation = allocationResult.value();
+
+    if (vkBindBufferMemory(m_device, buffer, allocation.memory, allocation.offset) != VK_SUCCESS)
+    {
+        destroy_buffer(buffer, allocation);
+        return make_error("Failed to bind buffer memory", ErrorCode::VulkanBufferCreationFailed);
+    }
+
+    return {};
+}
+
+void VulkanDevice::destroy_buffer(VkBuffer& buffer, VulkanAllocation& allocation) noexcept
+{
+    if (buffer != nullptr)
+    {
+        vkDestroyBuffer(m_device, buffer, nullptr);
+        buffer = nullptr;
+    }
+    m_allocator.free(allocation);
+}
+
 Result<VkCommandBuffer> VulkanDevice::begin_single_time_commands()
 {
     VkCommandBufferAllocateInfo allocInfo{};
@@ -705,24 +899,13 @@ Result<> VulkanDevice::create_image(
     VkImage& image,
     VkDeviceMemory& imageMemory,
     VkSampleCountFlagBits samples,
-    VkDeviceSize* outAllocationBytes
+    VkDeviceSize* outAllocationBytes,
+    std::uint32_t mipLevels,
+    std::uint32_t arrayLayers
 )
 {
-    VkImageCreateInfo imageInfo{};
-    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = width;
-    imageInfo.extent.height = height;
-    imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
-    imageInfo.arrayLayers = 1;
-    imageInfo.format = format;
-    imageInfo.tiling = tiling;
-    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = usage;
-    imageInfo.samples = samples;
-    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
+    const VkImageCreateInfo imageInfo =
+        make_image_create_info(width, height, format, tiling, usage, samples, mipLevels, arrayLayers);
     if (vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS)
     {
         return make_error("Failed to create image", ErrorCode::VulkanImageCreationFailed);
@@ -766,16 +949,150 @@ Result<> VulkanDevice::create_image(
     return {};
 }
 
-Result<VkImageView> VulkanDevice::create_image_view(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags)
+Result<> VulkanDevice::create_image(
+    std::uint32_t width,
+    std::uint32_t height,
+    VkFormat format,
+    VkImageTiling tiling,
+    VkImageUsageFlags usage,
+    VkMemoryPropertyFlags properties,
+    VkImage& image,
+    VulkanAllocation& allocation,
+    VkSampleCountFlagBits samples,
+    std::uint32_t mipLevels
+)
+{
+    VkImageCreateInfo imageInfo = make_image_create_info(width, height, format, tiling, usage, samples, mipLevels);
+    if (m_hasDedicatedTransferQueue)
+    {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = static_cast<std::uint32_t>(m_concurrentQueueFamilies.size());
+        imageInfo.pQueueFamilyIndices = m_concurrentQueueFamilies.data();
+    }
+    if (vkCreateImage(m_device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+    {
+        return make_error("Failed to create image", ErrorCode::VulkanImageCreationFailed);
+    }
+
+    VkMemoryRequirements memRequirements{};
+    vkGetImageMemoryRequirements(m_device, image, &memRequirements);
+
+    auto memTypeResult = find_memory_type(memRequirements.memoryTypeBits, properties);
+    if (!memTypeResult)
+    {
+        vkDestroyImage(m_device, image, nullptr);
+        image = nullptr;
+        return make_error(memTypeResult.error());
+    }
+
+    // Linear-tiled images are placed with buffers to honour bufferImageGranularity.
+    const VulkanResourceKind kind =
+        tiling == VK_IMAGE_TILING_LINEAR ? VulkanResourceKind::Buffer : VulkanResourceKind::Image;
+    auto allocationResult = m_allocator.allocate(memRequirements, memTypeResult.value(), kind);
+    if (!allocationResult)
+    {
+        vkDestroyImage(m_device, image, nullptr);
+        image = nullptr;
+        return make_error(allocationResult.error());
+    }
+    allocation = allocationResult.value();
+
+    if (vkBindImageMemory(m_device, image, allocation.memory, allocation.offset) != VK_SUCCESS)
+    {
+        destroy_image(image, allocation);
+        return make_error("Failed to bind image memory", ErrorCode::VulkanImageCreationFailed);
+    }
+
+    return {};
+}
+
+void VulkanDevice::destroy_image(VkImage& image, VulkanAllocation& allocation) noexcept
+{
+    if (image != nullptr)
+    {
+        vkDestroyImage(m_device, image, nullptr);
+        image = nullptr;
+    }
+    m_allocator.free(allocation);
+}
+
+Result<> VulkanDevice::create_transient_attachment(
+    std::uint32_t width,
+    std::uint32_t height,
+    VkFormat format,
+    VkImageUsageFlags usage,
+    VkSampleCountFlagBits samples,
+    VkImage& image,
+    VkDeviceMemory& imageMemory,
+    VkDeviceSize* outCommittedBytes
+)
+{
+    usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    VkDeviceSize allocationBytes{};
+    auto result = create_image(width, height, format, VK_IMAGE_TILING_OPTIMAL, usage,
+                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, image,
+                               imageMemory, samples, &allocationBytes);
+    const bool lazilyAllocated = result.has_value();
+    if (!lazilyAllocated)
+    {
+        // Desktop GPUs rarely expose a lazily allocated memory type.
+        if (result.error().code != ErrorCode::VulkanMemoryTypeMissing)
+            return result;
+        result = create_image(width, height, format, VK_IMAGE_TILING_OPTIMAL, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                              image, imageMemory, samples, &allocationBytes);
+        if (!result)
+            return result;
+    }
+
+    if (outCommittedBytes != nullptr)
+    {
+        *outCommittedBytes = allocationBytes;
+        if (lazilyAllocated)
+            vkGetDeviceMemoryCommitment(m_device, imageMemory, outCommittedBytes);
+    }
+    return {};
+}
+
+VkImageCreateInfo VulkanDevice::make_image_create_info(
+    std::uint32_t width,
+    std::uint32_t height,
+    VkFormat format,
+    VkImageTiling tiling,
+    VkImageUsageFlags usage,
+    VkSampleCountFlagBits samples,
+    std::uint32_t mipLevels,
+    std::uint32_t arrayLayers
+) noexcept
+{
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = width;
+    imageInfo.extent.height = height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = mipLevels;
+    imageInfo.arrayLayers = arrayLayers;
+    imageInfo.format = format;
+    imageInfo.tiling = tiling;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage;
+    imageInfo.samples = samples;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    return imageInfo;
+}
+
+Result<VkImageView> VulkanDevice::create_image_view(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
+                                                    std::uint32_t mipLevels, VkComponentMapping components)
 {
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
     viewInfo.image = image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
     viewInfo.format = format;
+    viewInfo.components = components;
     viewInfo.subresourceRange.aspectMask = aspectFlags;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
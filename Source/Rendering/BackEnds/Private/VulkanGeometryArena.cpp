@@ -0,0 +1,213 @@
+#include "../Public/VulkanGeometryArena.hpp"
+#include "../../Public/Mesh.hpp"
+#include "../Public/VulkanDevice.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+VulkanGeometryArena::~VulkanGeometryArena()
+{
+    cleanup();
+}
+
+void VulkanGeometryArena::initialize(VulkanDevice& device, std::uint32_t pageVertices,
+                                     std::uint32_t pageIndices) noexcept
+{
+    m_device = &device;
+    m_pageVertices = std::max(pageVertices, 1u);
+    m_pageIndices = std::max(pageIndices, 1u);
+}
+
+void VulkanGeometryArena::cleanup() noexcept
+{
+    for (Page& page : m_pages)
+        destroy_page(page);
+    m_pages.clear();
+    m_usedBytes = 0;
+}
+
+std::uint64_t VulkanGeometryArena::bytes_per_vertex() noexcept
+{
+    return sizeof(PackedVertex) + sizeof(XMFLOAT3);
+}
+
+std::uint64_t VulkanGeometryArena::bytes_per_index() noexcept
+{
+    return sizeof(std::uint32_t);
+}
+
+Result<GeometryRange> VulkanGeometryArena::allocate(std::uint32_t vertexCount, std::uint32_t indexCount)
+{
+    if (m_device == nullptr)
+        return make_error("Geometry arena is not initialized", ErrorCode::VulkanBufferCreationFailed);
+    if (vertexCount == 0 || indexCount == 0)
+        return make_error("Geometry arena allocation is empty", ErrorCode::AssetInvalidData);
+    // vertexOffset is a signed 32-bit draw parameter.
+    if (vertexCount > static_cast<std::uint32_t>(std::numeric_limits<std::int32_t>::max()))
+        return make_error("Mesh has too many vertices for the geometry arena", ErrorCode::AssetInvalidData);
+
+    const auto try_page = [&](std::uint32_t pageIndex, GeometryRange& outRange) {
+        Page& page = m_pages[pageIndex];
+        std::uint32_t firstVertex{};
+        if (!page.freeVertices.allocate(vertexCount, firstVertex))
+            return false;
+        std::uint32_t firstIndex{};
+        if (!page.freeIndices.allocate(indexCount, firstIndex))
+        {
+            page.freeVertices.release(firstVertex, vertexCount);
+            return false;
+        }
+        outRange = GeometryRange{pageIndex, firstVertex, vertexCount, firstIndex, indexCount};
+        return true;
+    };
+
+    GeometryRange range{};
+    bool placed = false;
+    for (std::uint32_t pageIndex = 0; pageIndex < m_pages.size() && !placed; ++pageIndex)
+        placed = try_page(pageIndex, range);
+
+    if (!placed)
+    {
+        if (auto result = create_page(std::max(vertexCount, m_pageVertices), std::max(indexCount, m_pageIndices));
+            !result)
+            return make_error(result.error());
+        placed = try_page(static_cast<std::uint32_t>(m_pages.size() - 1), range);
+    }
+    if (!placed)
+        return make_error("Geometry arena page cannot hold the mesh", ErrorCode::VulkanBufferCreationFailed);
+
+    m_usedBytes += vertexCount * bytes_per_vertex() + indexCount * bytes_per_index();
+    return range;
+}
+
+void VulkanGeometryArena::free(const GeometryRange& range) noexcept
+{
+    if (!range.is_valid() || range.page >= m_pages.size())
+        return;
+
+    Page& page = m_pages[range.page];
+    page.freeVertices.release(range.firstVertex, range.vertexCount);
+    page.freeIndices.release(range.firstIndex, range.indexCount);
+    m_usedBytes -= std::min(m_usedBytes, range.vertexCount * bytes_per_vertex() + range.indexCount * bytes_per_index());
+}
+
+void VulkanGeometryArena::reset() noexcept
+{
+    while (m_pages.size() > 1)
+    {
+        destroy_page(m_pages.back());
+        m_pages.pop_back();
+    }
+    if (!m_pages.empty())
+        reset_free_lists(m_pages.front());
+    m_usedBytes = 0;
+}
+
+Result<> VulkanGeometryArena::create_page(std::uint32_t vertexCapacity, std::uint32_t indexCapacity)
+{
+    Page page{};
+    page.vertexCapacity = vertexCapacity;
+    page.indexCapacity = indexCapacity;
+
+    if (auto res = m_device->create_buffer(
+            static_cast<VkDeviceSize>(vertexCapacity) * sizeof(PackedVertex),
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            page.vertexBuffer,
+            page.vertexAllocation
+        ); !res)
+        return res;
+
+    if (auto res = m_device->create_buffer(
+            static_cast<VkDeviceSize>(vertexCapacity) * sizeof(XMFLOAT3),
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            page.positionBuffer,
+            page.positionAllocation
+        ); !res)
+    {
+        destroy_page(page);
+        return res;
+    }
+
+    if (auto res = m_device->create_buffer(
+            static_cast<VkDeviceSize>(indexCapacity) * sizeof(std::uint32_t),
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            page.indexBuffer,
+            page.indexAllocation
+        ); !res)
+    {
+        destroy_page(page);
+        return res;
+    }
+
+    reset_free_lists(page);
+    m_pages.push_back(std::move(page));
+    return {};
+}
+
+void VulkanGeometryArena::destroy_page(Page& page) noexcept
+{
+    if (m_device == nullptr)
+        return;
+    m_device->destroy_buffer(page.indexBuffer, page.indexAllocation);
+    m_device->destroy_buffer(page.positionBuffer, page.positionAllocation);
+    m_device->destroy_buffer(page.vertexBuffer, page.vertexAllocation);
+}
+
+void VulkanGeometryArena::reset_free_lists(Page& page)
+{
+    page.freeVertices.ranges.clear();
+    page.freeVertices.ranges.emplace(0u, page.vertexCapacity);
+    page.freeIndices.ranges.clear();
+    page.freeIndices.ranges.emplace(0u, page.indexCapacity);
+}
+
+bool VulkanGeometryArena::FreeList::allocate(std::uint32_t count, std::uint32_t& outOffset)
+{
+    auto best = ranges.end();
+    for (auto it = ranges.begin(); it != ranges.end(); ++it)
+    {
+        if (it->second >= count && (best == ranges.end() || it->second < best->second))
+        {
+            best = it;
+            if (best->second == count)
+                break;
+        }
+    }
+    if (best == ranges.end())
+        return false;
+
+    outOffset = best->first;
+    const std::uint32_t remaining = best->second - count;
+    ranges.erase(best);
+    if (remaining > 0)
+        ranges.emplace(outOffset + count, remaining);
+    return true;
+}
+
+void VulkanGeometryArena::FreeList::release(std::uint32_t offset, std::uint32_t count)
+{
+    if (count == 0)
+        return;
+
+    auto next = ranges.lower_bound(offset);
+    if (next != ranges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            count += previous->second;
+            ranges.erase(previous);
+        }
+    }
+    if (next != ranges.end() && offset + count == next->first)
+    {
+        count += next->second;
+        ranges.erase(next);
+    }
+    ranges.emplace(offset, count);
+}
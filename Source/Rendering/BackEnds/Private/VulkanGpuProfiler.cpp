@@ -0,0 +1,257 @@
+#include "../Public/VulkanGpuProfiler.hpp"
+#include "../Public/VulkanDevice.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+constexpr std::uint32_t TimestampQueryCount{static_cast<std::uint32_t>(GpuPassCount * 2)};
+
+// Results come back in bit order: vertex invocations, clipping primitives, fragment invocations.
+constexpr VkQueryPipelineStatisticFlags StatisticsFlags{VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+                                                        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+                                                        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT};
+} // namespace
+
+VulkanGpuProfiler::~VulkanGpuProfiler()
+{
+    cleanup();
+}
+
+Result<> VulkanGpuProfiler::initialize(VulkanDevice& device, std::uint32_t framesInFlight)
+{
+    m_device = &device;
+
+    std::uint32_t familyCount{};
+    vkGetPhysicalDeviceQueueFamilyProperties(device.get_physical_device(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device.get_physical_device(), &familyCount, families.data());
+
+    const std::uint32_t graphicsFamily = device.get_graphics_queue_family_index();
+    const std::uint32_t validBits = graphicsFamily < familyCount ? families[graphicsFamily].timestampValidBits : 0;
+    if (validBits == 0)
+        return {};
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(device.get_physical_device(), &properties);
+    m_timestampPeriodNs = static_cast<double>(properties.limits.timestampPeriod);
+    m_timestampMask = validBits >= 64 ? std::numeric_limits<std::uint64_t>::max() : (std::uint64_t{1} << validBits) - 1;
+    m_statisticsSupported = device.supports_pipeline_statistics();
+
+    m_frames.resize(framesInFlight);
+    for (FrameQueries& frame : m_frames)
+    {
+        VkQueryPoolCreateInfo timestampInfo{};
+        timestampInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        timestampInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        timestampInfo.queryCount = TimestampQueryCount;
+        if (vkCreateQueryPool(device.get_device(), &timestampInfo, nullptr, &frame.timestampPool) != VK_SUCCESS)
+        {
+            cleanup();
+            return make_error("Failed to create GPU timestamp query pool", ErrorCode::VulkanQueryPoolCreationFailed);
+        }
+
+        if (!m_statisticsSupported)
+            continue;
+
+        VkQueryPoolCreateInfo statisticsInfo{};
+        statisticsInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        statisticsInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statisticsInfo.queryCount = 1;
+        statisticsInfo.pipelineStatistics = StatisticsFlags;
+        if (vkCreateQueryPool(device.get_device(), &statisticsInfo, nullptr, &frame.statisticsPool) != VK_SUCCESS)
+        {
+            // Counters are optional; timing works without them.
+            m_statisticsSupported = false;
+            for (FrameQueries& created : m_frames)
+            {
+                if (created.statisticsPool != nullptr)
+                    vkDestroyQueryPool(device.get_device(), created.statisticsPool, nullptr);
+                created.statisticsPool = nullptr;
+            }
+        }
+    }
+    return {};
+}
+
+void VulkanGpuProfiler::cleanup() noexcept
+{
+    if (m_device != nullptr && m_device->get_device() != nullptr)
+    {
+        for (const FrameQueries& frame : m_frames)
+        {
+            if (frame.timestampPool != nullptr)
+                vkDestroyQueryPool(m_device->get_device(), frame.timestampPool, nullptr);
+            if (frame.statisticsPool != nullptr)
+                vkDestroyQueryPool(m_device->get_device(), frame.statisticsPool, nullptr);
+        }
+    }
+    m_frames.clear();
+    m_recording = nullptr;
+    m_statisticsSupported = false;
+    m_device = nullptr;
+}
+
+void VulkanGpuProfiler::begin_frame(VkCommandBuffer commandBuffer, std::uint32_t frameIndex) noexcept
+{
+    m_recording = nullptr;
+    if (frameIndex >= m_frames.size())
+        return;
+
+    FrameQueries& frame = m_frames[frameIndex];
+    collect(frame);
+
+    vkCmdResetQueryPool(commandBuffer, frame.timestampPool, 0, TimestampQueryCount);
+    if (frame.statisticsPool != nullptr)
+        vkCmdResetQueryPool(commandBuffer, frame.statisticsPool, 0, 1);
+    frame.writtenPasses = 0;
+    frame.statisticsWritten = false;
+    m_recording = &frame;
+}
+
+void VulkanGpuProfiler::begin_pass(VkCommandBuffer commandBuffer, GpuPass pass) noexcept
+{
+    if (m_recording == nullptr)
+        return;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_recording->timestampPool,
+                        static_cast<std::uint32_t>(pass) * 2);
+}
+
+void VulkanGpuProfiler::end_pass(VkCommandBuffer commandBuffer, GpuPass pass) noexcept
+{
+    if (m_recording == nullptr)
+        return;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_recording->timestampPool,
+                        static_cast<std::uint32_t>(pass) * 2 + 1);
+    m_recording->writtenPasses |= 1u << static_cast<std::uint32_t>(pass);
+}
+
+void VulkanGpuProfiler::begin_statistics(VkCommandBuffer commandBuffer) noexcept
+{
+    if (m_recording == nullptr || m_recording->statisticsPool == nullptr)
+        return;
+    vkCmdBeginQuery(commandBuffer, m_recording->statisticsPool, 0, 0);
+}
+
+void VulkanGpuProfiler::end_statistics(VkCommandBuffer commandBuffer) noexcept
+{
+    if (m_recording == nullptr || m_recording->statisticsPool == nullptr)
+        return;
+    vkCmdEndQuery(commandBuffer, m_recording->statisticsPool, 0);
+    m_recording->statisticsWritten = true;
+}
+
+VkQueryPipelineStatisticFlags VulkanGpuProfiler::get_statistics_flags() const noexcept
+{
+    return m_statisticsSupported ? StatisticsFlags : 0;
+}
+
+const char* VulkanGpuProfiler::get_pass_name(GpuPass pass) noexcept
+{
+    switch (pass)
+    {
+    case GpuPass::Cull:
+        return "GPU Cull";
+    case GpuPass::Shadow:
+        return "Shadow Cascades";
+    case GpuPass::LightCluster:
+        return "Light Clusters";
+    case GpuPass::Scene:
+        return "Scene";
+    case GpuPass::DepthPrepass:
+        return "Depth Prepass";
+    case GpuPass::HiZ:
+        return "Hi-Z";
+    case GpuPass::Nis:
+        return "NIS";
+    case GpuPass::Ui:
+        return "UI";
+    case GpuPass::Blit:
+        return "Blit";
+    default:
+        return "Unknown";
+    }
+}
+
+void VulkanGpuProfiler::collect(FrameQueries& frame) noexcept
+{
+    if (frame.writtenPasses == 0)
+        return;
+
+    // Passes that did not run this frame never write their queries, so the pool as a whole reads
+    // back VK_NOT_READY. Each query comes with its availability word instead; the slot's fence has
+    // signalled, so every query of a written pass is available and the rest are skipped.
+    std::array<std::uint64_t, TimestampQueryCount * 2> timestamps{};
+    const VkResult timestampResult = vkGetQueryPoolResults(
+        m_device->get_device(), frame.timestampPool, 0, TimestampQueryCount, sizeof(timestamps), timestamps.data(),
+        sizeof(std::uint64_t) * 2, VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (timestampResult == VK_SUCCESS || timestampResult == VK_NOT_READY)
+    {
+        std::uint64_t frameBegin{std::numeric_limits<std::uint64_t>::max()};
+        std::uint64_t frameEnd{};
+        for (std::size_t pass = 0; pass < GpuPassCount; ++pass)
+        {
+            const std::size_t beginQuery = pass * 2;
+            const std::size_t endQuery = pass * 2 + 1;
+            if ((frame.writtenPasses & (1u << pass)) == 0 || timestamps[beginQuery * 2 + 1] == 0 ||
+                timestamps[endQuery * 2 + 1] == 0)
+            {
+                m_passHistory[pass].clear();
+                continue;
+            }
+
+            const std::uint64_t begin = timestamps[beginQuery * 2] & m_timestampMask;
+            const std::uint64_t end = timestamps[endQuery * 2] & m_timestampMask;
+            const std::uint64_t ticks = end >= begin ? end - begin : 0;
+            m_passHistory[pass].push(static_cast<float>(static_cast<double>(ticks) * m_timestampPeriodNs * 1.0e-6));
+            frameBegin = std::min(frameBegin, begin);
+            frameEnd = std::max(frameEnd, end);
+        }
+        if (frameEnd >= frameBegin)
+        {
+            m_frameHistory.push(
+                static_cast<float>(static_cast<double>(frameEnd - frameBegin) * m_timestampPeriodNs * 1.0e-6));
+            ++m_frameSamplesCollected;
+        }
+    }
+
+    if (frame.statisticsWritten)
+    {
+        std::array<std::uint64_t, 3> counters{};
+        if (vkGetQueryPoolResults(m_device->get_device(), frame.statisticsPool, 0, 1, sizeof(counters), counters.data(),
+                                  sizeof(counters), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+        {
+            m_statistics = GpuPipelineStatistics{counters[0], counters[1], counters[2], true};
+        }
+    }
+}
+
+//    TimingHistory
+
+void VulkanGpuProfiler::TimingHistory::push(float milliseconds) noexcept
+{
+    samples[next] = milliseconds;
+    next = (next + 1) % HistoryLength;
+    count = std::min(count + 1, HistoryLength);
+
+    float total{};
+    stats.minMs = std::numeric_limits<float>::max();
+    stats.maxMs = 0.0f;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        total += samples[i];
+        stats.minMs = std::min(stats.minMs, samples[i]);
+        stats.maxMs = std::max(stats.maxMs, samples[i]);
+    }
+    stats.lastMs = milliseconds;
+    stats.averageMs = total / static_cast<float>(count);
+    stats.sampleCount = static_cast<std::uint32_t>(count);
+}
+
+void VulkanGpuProfiler::TimingHistory::clear() noexcept
+{
+    next = 0;
+    count = 0;
+    stats = GpuTimingStats{};
+}
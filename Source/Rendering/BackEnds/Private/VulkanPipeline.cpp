@@ -1,9 +1,18 @@
 #include "../Public/VulkanPipeline.hpp"
+#include "../../Public/DebugDraw.hpp"
 #include "../../Public/Mesh.hpp"
 
+#include "../../../Core/Public/JobSystem.hpp"
+
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include <fmt/core.h>
 
 VulkanPipeline::~VulkanPipeline()
 {
@@ -22,80 +31,333 @@ Result<> VulkanPipeline::initialize(
 
     if (m_pipelineCache == nullptr)
     {
-        VkPipelineCacheCreateInfo pipelineCacheInfo{};
-        pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-        if (vkCreatePipelineCache(device, &pipelineCacheInfo, nullptr, &m_pipelineCache) != VK_SUCCESS)
+        if (auto result = create_pipeline_cache(); !result)
+            return result;
+    }
+
+    // 1. Create shader modules from pre-compiled SPIR-V. Kept alive so variants can compile later.
+    auto vertShaderModuleResult = create_shader_module(vertSpirv);
+    if (!vertShaderModuleResult)
+        return make_error(vertShaderModuleResult.error());
+    m_vertShaderModule = vertShaderModuleResult.value();
+
+    auto fragShaderModuleResult = create_shader_module(fragSpirv);
+    if (!fragShaderModuleResult)
+    {
+        cleanup();
+        return make_error(fragShaderModuleResult.error());
+    }
+    m_fragShaderModule = fragShaderModuleResult.value();
+
+    // Bindless material set layout: binding 0 = global texture array, 1 = material records.
+    // Kept across pipeline rebuilds because the set allocated from it is updated whenever a texture uploads.
+    if (m_descriptorSetLayout == nullptr)
+    {
+        std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+        bindings[0].binding = 0;
+        bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[0].descriptorCount = m_device.get_max_bindless_textures();
+        bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        bindings[0].pImmutableSamplers = nullptr;
+        bindings[1].binding = 1;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        bindings[1].pImmutableSamplers = nullptr;
+
+        std::array<VkDescriptorBindingFlagsEXT, 2> bindingFlags{
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT,
+            0,
+        };
+        VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+        bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+        bindingFlagsInfo.bindingCount = static_cast<std::uint32_t>(bindingFlags.size());
+        bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.pNext = &bindingFlagsInfo;
+        layoutInfo.bindingCount = static_cast<std::uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
         {
-            return make_error("Failed to create pipeline cache", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+            cleanup();
+            return make_error(
+                "Failed to create descriptor set layout",
+                ErrorCode::VulkanGraphicsPipelineLayoutCreationFailed
+            );
         }
     }
 
-    // 1. Create shader modules from pre-compiled SPIR-V
+    // Instance descriptor set layout: binding 0 = persistent per-entity instance data (model, glow, material)
+    VkDescriptorSetLayoutBinding instanceBinding{};
+    instanceBinding.binding = 0;
+    instanceBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    instanceBinding.descriptorCount = 1;
+    instanceBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    instanceBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorSetLayoutCreateInfo instanceLayoutInfo{};
+    instanceLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    instanceLayoutInfo.bindingCount = 1;
+    instanceLayoutInfo.pBindings = &instanceBinding;
+
+    if (vkCreateDescriptorSetLayout(device, &instanceLayoutInfo, nullptr, &m_instanceDescriptorSetLayout) != VK_SUCCESS)
+    {
+        cleanup();
+        return make_error(
+            "Failed to create instance descriptor set layout",
+            ErrorCode::VulkanGraphicsPipelineLayoutCreationFailed
+        );
+    }
+
+    // Light descriptor set layout: binding 0 = lights, binding 1 = per-cluster light lists,
+    // binding 2 = lighting parameters, binding 3 = sun shadow cascades (depth array, compare sampler).
+    // Written by the cluster compute pass, read by the fragment shader.
+    std::array<VkDescriptorSetLayoutBinding, 4> lightBindings{};
+    for (std::uint32_t i = 0; i < 3; ++i)
+    {
+        lightBindings[i].binding = i;
+        lightBindings[i].descriptorType = i == 2 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        lightBindings[i].descriptorCount = 1;
+        lightBindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    lightBindings[3].binding = 3;
+    lightBindings[3].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    lightBindings[3].descriptorCount = 1;
+    lightBindings[3].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo lightLayoutInfo{};
+    lightLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    lightLayoutInfo.bindingCount = static_cast<std::uint32_t>(lightBindings.size());
+    lightLayoutInfo.pBindings = lightBindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &lightLayoutInfo, nullptr, &m_lightDescriptorSetLayout) != VK_SUCCESS)
+    {
+        cleanup();
+        return make_error(
+            "Failed to create light descriptor set layout",
+            ErrorCode::VulkanGraphicsPipelineLayoutCreationFailed
+        );
+    }
+
+    // Set 0 = bindless materials, set 1 = instances, set 2 = clustered lights;
+    // view-projection is pushed once per frame.
+    std::array<VkDescriptorSetLayout, 3> setLayouts{m_descriptorSetLayout, m_instanceDescriptorSetLayout,
+                                                    m_lightDescriptorSetLayout};
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(float) * 20; // mat4 viewProj, then the debug line viewport (debug.vert only)
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = static_cast<std::uint32_t>(setLayouts.size());
+    pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+    {
+        cleanup();
+        return make_error("Failed to create pipeline layout", ErrorCode::VulkanGraphicsPipelineLayoutCreationFailed);
+    }
+
+    auto pipelineResult = create_variant(renderPass, msConfig);
+    if (!pipelineResult)
+    {
+        cleanup();
+        return make_error(pipelineResult.error());
+    }
+    m_graphicsPipeline = store_variant(msConfig, pipelineResult.value());
+    return {};
+}
+
+Result<> VulkanPipeline::select_variant(VkRenderPass renderPass, const MultisampleConfig& msConfig)
+{
+    if (m_pipelineLayout == nullptr)
+        return make_error("Pipeline is not initialized", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    if (VkPipeline pipeline = find_variant(msConfig); pipeline != nullptr)
+    {
+        m_graphicsPipeline = pipeline;
+        return {};
+    }
+
+    auto pipelineResult = create_variant(renderPass, msConfig);
+    if (!pipelineResult)
+        return make_error(pipelineResult.error());
+    m_graphicsPipeline = store_variant(msConfig, pipelineResult.value());
+    return {};
+}
+
+void VulkanPipeline::prewarm_variants(std::vector<PipelineVariantRequest> requests)
+{
+    if (requests.empty())
+        return;
+
+    // A new batch supersedes the running one: cancel it so only its current compile is waited on.
+    wait_for_prewarm();
+    {
+        std::lock_guard lock{m_variantMutex};
+        m_prewarmRunning = true;
+    }
+    m_prewarmCancelled.store(false, std::memory_order_relaxed);
+
+    JobSystem::get().submit(JobPriority::Background, [this, requests = std::move(requests)]() {
+        VkDevice device = m_device.get_device();
+        for (const PipelineVariantRequest& request : requests)
+        {
+            if (!m_prewarmCancelled.load(std::memory_order_relaxed) && find_variant(request.config) == nullptr)
+            {
+                // vkCreateGraphicsPipelines is safe to call concurrently, the cache synchronizes internally.
+                if (auto pipelineResult = create_variant(request.renderPass, request.config); pipelineResult)
+                    (void)store_variant(request.config, pipelineResult.value());
+            }
+            vkDestroyRenderPass(device, request.renderPass, nullptr);
+        }
+
+        std::lock_guard lock{m_variantMutex};
+        m_prewarmRunning = false;
+        m_prewarmIdle.notify_all();
+    });
+}
+
+Result<PipelineShaderSet> VulkanPipeline::build_shader_set(
+    VkRenderPass renderPass,
+    const MultisampleConfig& msConfig,
+    const std::vector<std::uint32_t>& vertSpirv,
+    const std::vector<std::uint32_t>& fragSpirv
+) const noexcept
+{
+    if (m_pipelineLayout == nullptr)
+        return make_error("Pipeline is not initialized", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    PipelineShaderSet shaderSet{};
+    shaderSet.config = msConfig;
+
     auto vertShaderModuleResult = create_shader_module(vertSpirv);
     if (!vertShaderModuleResult)
         return make_error(vertShaderModuleResult.error());
-    VkShaderModule vertShaderModule = vertShaderModuleResult.value();
+    shaderSet.vertModule = vertShaderModuleResult.value();
 
     auto fragShaderModuleResult = create_shader_module(fragSpirv);
     if (!fragShaderModuleResult)
     {
-        vkDestroyShaderModule(device, vertShaderModule, nullptr);
+        destroy_shader_set(shaderSet);
         return make_error(fragShaderModuleResult.error());
     }
-    VkShaderModule fragShaderModule = fragShaderModuleResult.value();
+    shaderSet.fragModule = fragShaderModuleResult.value();
 
-    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
-    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertShaderStageInfo.module = vertShaderModule;
-    vertShaderStageInfo.pName = "main";
+    auto pipelineResult = create_variant(renderPass, msConfig, shaderSet.vertModule, shaderSet.fragModule);
+    if (!pipelineResult)
+    {
+        destroy_shader_set(shaderSet);
+        return make_error(pipelineResult.error());
+    }
+    shaderSet.pipelines.push_back(pipelineResult.value());
+    return shaderSet;
+}
 
-    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
-    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragShaderStageInfo.module = fragShaderModule;
-    fragShaderStageInfo.pName = "main";
+PipelineShaderSet VulkanPipeline::swap_shader_set(PipelineShaderSet&& shaderSet) noexcept
+{
+    // Prewarm compiles against the member modules; it must not outlive them.
+    wait_for_prewarm();
 
-    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{
-        vertShaderStageInfo,
-        fragShaderStageInfo,
-    };
+    PipelineShaderSet retired{};
+    retired.vertModule = std::exchange(m_vertShaderModule, shaderSet.vertModule);
+    retired.fragModule = std::exchange(m_fragShaderModule, shaderSet.fragModule);
 
-    // 2. Vertex Input State (vertex + per-instance transform data)
-    auto vertexBindingDescription = Vertex::getBindingDescription();
-    auto vertexAttributeDescriptions = Vertex::getAttributeDescriptions();
+    std::lock_guard lock{m_variantMutex};
+    retired.pipelines.reserve(m_variants.size());
+    for (const Variant& variant : m_variants)
+        retired.pipelines.push_back(variant.pipeline);
+    m_variants.clear();
 
-    std::array<VkVertexInputBindingDescription, 2> bindingDescriptions{};
-    bindingDescriptions[0] = vertexBindingDescription;
-    bindingDescriptions[1].binding = 1;
-    bindingDescriptions[1].stride = sizeof(float) * 36; // mat4 mvp + mat4 model + vec4 glow
-    bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+    m_graphicsPipeline = shaderSet.pipelines.empty() ? nullptr : shaderSet.pipelines.front();
+    if (m_graphicsPipeline != nullptr)
+        m_variants.push_back(Variant{shaderSet.config, m_graphicsPipeline});
+    shaderSet = PipelineShaderSet{};
+    return retired;
+}
 
-    std::array<VkVertexInputAttributeDescription, 13> attributeDescriptions{};
-    for (std::size_t i = 0; i < vertexAttributeDescriptions.size(); ++i)
-        attributeDescriptions[i] = vertexAttributeDescriptions[i];
+void VulkanPipeline::destroy_shader_set(PipelineShaderSet& shaderSet) const noexcept
+{
+    VkDevice device = m_device.get_device();
+    for (VkPipeline pipeline : shaderSet.pipelines)
+        vkDestroyPipeline(device, pipeline, nullptr);
+    shaderSet.pipelines.clear();
 
-    const std::uint32_t vec4Size = sizeof(float) * 4;
-    // mvp rows (locations 4..7)
-    for (std::uint32_t i = 0; i < 4; ++i)
+    if (shaderSet.fragModule != nullptr)
     {
-        attributeDescriptions[4 + i].binding = 1;
-        attributeDescriptions[4 + i].location = 4 + i;
-        attributeDescriptions[4 + i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-        attributeDescriptions[4 + i].offset = vec4Size * i;
+        vkDestroyShaderModule(device, shaderSet.fragModule, nullptr);
+        shaderSet.fragModule = nullptr;
     }
-    // model rows (locations 8..11)
-    for (std::uint32_t i = 0; i < 4; ++i)
+    if (shaderSet.vertModule != nullptr)
     {
-        attributeDescriptions[8 + i].binding = 1;
-        attributeDescriptions[8 + i].location = 8 + i;
-        attributeDescriptions[8 + i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-        attributeDescriptions[8 + i].offset = (vec4Size * 4) + (vec4Size * i);
+        vkDestroyShaderModule(device, shaderSet.vertModule, nullptr);
+        shaderSet.vertModule = nullptr;
     }
-    attributeDescriptions[12].binding = 1;
-    attributeDescriptions[12].location = 12;
-    attributeDescriptions[12].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-    attributeDescriptions[12].offset = vec4Size * 8;
+}
+
+Result<VkPipeline> VulkanPipeline::create_depth_prepass_pipeline(
+    VkRenderPass renderPass,
+    VkSampleCountFlagBits samples,
+    const std::vector<std::uint32_t>& vertSpirv
+) const noexcept
+{
+    return create_depth_only_pipeline(renderPass, samples, vertSpirv, false);
+}
+
+Result<VkPipeline> VulkanPipeline::create_shadow_pipeline(
+    VkRenderPass renderPass,
+    const std::vector<std::uint32_t>& vertSpirv
+) const noexcept
+{
+    return create_depth_only_pipeline(renderPass, VK_SAMPLE_COUNT_1_BIT, vertSpirv, true);
+}
+
+Result<VkPipeline> VulkanPipeline::create_depth_only_pipeline(
+    VkRenderPass renderPass,
+    VkSampleCountFlagBits samples,
+    const std::vector<std::uint32_t>& vertSpirv,
+    bool shadowCaster
+) const noexcept
+{
+    if (m_pipelineLayout == nullptr)
+        return make_error("Pipeline is not initialized", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+
+    auto vertShaderModuleResult = create_shader_module(vertSpirv);
+    if (!vertShaderModuleResult)
+        return make_error(vertShaderModuleResult.error());
+    VkShaderModule vertModule = vertShaderModuleResult.value();
+
+    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertShaderStageInfo.module = vertModule;
+    vertShaderStageInfo.pName = "main";
+
+    // Position stream (binding 0) + per-instance slot (binding 1), same locations as shader.vert.
+    std::array<VkVertexInputBindingDescription, 2> bindingDescriptions{};
+    bindingDescriptions[0].binding = 0;
+    bindingDescriptions[0].stride = sizeof(DirectX::XMFLOAT3);
+    bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    bindingDescriptions[1].binding = 1;
+    bindingDescriptions[1].stride = sizeof(std::uint32_t);
+    bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions{};
+    attributeDescriptions[0].binding = 0;
+    attributeDescriptions[0].location = 0;
+    attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributeDescriptions[0].offset = 0;
+    attributeDescriptions[1].binding = 1;
+    attributeDescriptions[1].location = 4;
+    attributeDescriptions[1].format = VK_FORMAT_R32_UINT;
+    attributeDescriptions[1].offset = 0;
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -114,97 +376,206 @@ Result<> VulkanPipeline::initialize(
     viewportState.viewportCount = 1;
     viewportState.scissorCount = 1;
 
+    // The prepass must rasterize exactly like the color pass for its EQUAL test to pass. Shadow casters
+    // keep both faces, so open meshes and single-sided planes still cast, and take a per-cascade
+    // slope-scaled bias against acne.
     VkPipelineRasterizationStateCreateInfo rasterizer{};
     rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
     rasterizer.depthClampEnable = false;
     rasterizer.rasterizerDiscardEnable = false;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.cullMode = shadowCaster ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT;
     rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-    rasterizer.depthBiasEnable = false;
+    rasterizer.depthBiasEnable = shadowCaster;
 
     VkPipelineMultisampleStateCreateInfo multisampling{};
     multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.rasterizationSamples = msConfig.samples;
-    multisampling.sampleShadingEnable = msConfig.sampleShading ? VK_TRUE : VK_FALSE;
-    multisampling.minSampleShading = msConfig.minSampleShading;
-    multisampling.alphaToCoverageEnable = msConfig.alphaToCoverage ? VK_TRUE : VK_FALSE;
-    multisampling.alphaToOneEnable = VK_FALSE;
+    multisampling.rasterizationSamples = samples;
 
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     depthStencil.depthTestEnable = VK_TRUE;
     depthStencil.depthWriteEnable = VK_TRUE;
     depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-    depthStencil.depthBoundsTestEnable = VK_FALSE;
-    depthStencil.stencilTestEnable = VK_FALSE;
 
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.colorWriteMask = 0;
     colorBlendAttachment.blendEnable = false;
 
+    // The shadow pass has no color attachment at all.
     VkPipelineColorBlendStateCreateInfo colorBlending{};
     colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = false;
-    colorBlending.logicOp = VK_LOGIC_OP_COPY;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
+    colorBlending.attachmentCount = shadowCaster ? 0 : 1;
+    colorBlending.pAttachments = shadowCaster ? nullptr : &colorBlendAttachment;
 
-    std::array<VkDynamicState, 2> dynamicStates{
+    std::array<VkDynamicState, 3> dynamicStates{
         VK_DYNAMIC_STATE_VIEWPORT,
         VK_DYNAMIC_STATE_SCISSOR,
+        VK_DYNAMIC_STATE_DEPTH_BIAS,
     };
 
     VkPipelineDynamicStateCreateInfo dynamicState{};
     dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = static_cast<std::uint32_t>(dynamicStates.size());
+    dynamicState.dynamicStateCount = shadowCaster ? 3 : 2;
     dynamicState.pDynamicStates = dynamicStates.data();
 
-    // Descriptor set layout: binding 0 = albedo, 1 = normal, 2 = roughness, 3 = metallic, 4 = AO
-    std::array<VkDescriptorSetLayoutBinding, 5> bindings{};
-    for (std::uint32_t i = 0; i < 5; ++i)
-    {
-        bindings[i].binding = i;
-        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        bindings[i].descriptorCount = 1;
-        bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-        bindings[i].pImmutableSamplers = nullptr;
-    }
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 1;
+    pipelineInfo.pStages = &vertShaderStageInfo;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_pipelineLayout;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+    pipelineInfo.basePipelineHandle = nullptr;
+    pipelineInfo.basePipelineIndex = -1;
+
+    VkPipeline pipeline{};
+    const VkResult result = vkCreateGraphicsPipelines(m_device.get_device(), m_pipelineCache, 1, &pipelineInfo, nullptr,
+                                                      &pipeline);
+    vkDestroyShaderModule(m_device.get_device(), vertModule, nullptr);
+    if (result != VK_SUCCESS)
+        return make_error(shadowCaster ? "Failed to create shadow pipeline" : "Failed to create depth prepass pipeline",
+                          ErrorCode::VulkanGraphicsPipelineCreationFailed);
+    return pipeline;
+}
+
+Result<VkPipeline> VulkanPipeline::create_debug_line_pipeline(
+    VkRenderPass renderPass,
+    VkSampleCountFlagBits samples,
+    const std::vector<std::uint32_t>& vertSpirv,
+    const std::vector<std::uint32_t>& fragSpirv,
+    bool depthTest
+) const noexcept
+{
+    if (m_pipelineLayout == nullptr)
+        return make_error("Pipeline is not initialized", ErrorCode::VulkanGraphicsPipelineCreationFailed);
 
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = static_cast<std::uint32_t>(bindings.size());
-    layoutInfo.pBindings = bindings.data();
+    auto vertShaderModuleResult = create_shader_module(vertSpirv);
+    if (!vertShaderModuleResult)
+        return make_error(vertShaderModuleResult.error());
+    VkShaderModule vertModule = vertShaderModuleResult.value();
 
-    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
+    auto fragShaderModuleResult = create_shader_module(fragSpirv);
+    if (!fragShaderModuleResult)
     {
-        vkDestroyShaderModule(device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(device, vertShaderModule, nullptr);
-        return make_error(
-            "Failed to create descriptor set layout",
-            ErrorCode::VulkanGraphicsPipelineLayoutCreationFailed
-        );
+        vkDestroyShaderModule(m_device.get_device(), vertModule, nullptr);
+        return make_error(fragShaderModuleResult.error());
     }
+    VkShaderModule fragModule = fragShaderModuleResult.value();
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{};
+    shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    shaderStages[0].module = vertModule;
+    shaderStages[0].pName = "main";
+    shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    shaderStages[1].module = fragModule;
+    shaderStages[1].pName = "main";
+
+    // Unit shape quad corners (binding 0) + one DebugDrawInstance per primitive (binding 1), as in debug.vert.
+    std::array<VkVertexInputBindingDescription, 2> bindingDescriptions{};
+    bindingDescriptions[0].binding = 0;
+    bindingDescriptions[0].stride = sizeof(DebugShapeVertex);
+    bindingDescriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    bindingDescriptions[1].binding = 1;
+    bindingDescriptions[1].stride = sizeof(DebugDrawInstance);
+    bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
 
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-    pipelineLayoutInfo.pPushConstantRanges = nullptr;
-
-    if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
+    std::array<VkVertexInputAttributeDescription, 9> attributeDescriptions{};
+    attributeDescriptions[0] = {0, 0, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                static_cast<std::uint32_t>(offsetof(DebugShapeVertex, position))};
+    attributeDescriptions[1] = {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                static_cast<std::uint32_t>(offsetof(DebugShapeVertex, other))};
+    attributeDescriptions[2] = {2, 0, VK_FORMAT_R32_SFLOAT, static_cast<std::uint32_t>(offsetof(DebugShapeVertex, side))};
+    for (std::uint32_t row = 0; row < 3; ++row)
     {
-        vkDestroyShaderModule(device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(device, vertShaderModule, nullptr);
-        return make_error("Failed to create pipeline layout", ErrorCode::VulkanGraphicsPipelineLayoutCreationFailed);
+        attributeDescriptions[3 + row] = {3 + row, 1, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                          static_cast<std::uint32_t>(offsetof(DebugDrawInstance, model) +
+                                                                     sizeof(DirectX::XMFLOAT4) * row)};
     }
+    attributeDescriptions[6] = {6, 1, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                static_cast<std::uint32_t>(offsetof(DebugDrawInstance, extent))};
+    attributeDescriptions[7] = {7, 1, VK_FORMAT_R32_UINT, static_cast<std::uint32_t>(offsetof(DebugDrawInstance, color))};
+    attributeDescriptions[8] = {8, 1, VK_FORMAT_R32_SFLOAT, static_cast<std::uint32_t>(offsetof(DebugDrawInstance, width))};
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<std::uint32_t>(bindingDescriptions.size());
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<std::uint32_t>(attributeDescriptions.size());
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = false;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    // Lines are quads widened by debug.vert rather than wide line primitives, an optional feature.
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = false;
+    rasterizer.rasterizerDiscardEnable = false;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_NONE;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = false;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = samples;
+
+    // LESS_OR_EQUAL so lines lying on a surface (a box around a box) stay visible.
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = VK_FALSE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = true;
+    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    std::array<VkDynamicState, 2> dynamicStates{
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
+
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<std::uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
 
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
+    pipelineInfo.stageCount = static_cast<std::uint32_t>(shaderStages.size());
     pipelineInfo.pStages = shaderStages.data();
     pipelineInfo.pVertexInputState = &vertexInputInfo;
     pipelineInfo.pInputAssemblyState = &inputAssembly;
@@ -220,36 +591,102 @@ Result<> VulkanPipeline::initialize(
     pipelineInfo.basePipelineHandle = nullptr;
     pipelineInfo.basePipelineIndex = -1;
 
-    if (vkCreateGraphicsPipelines(device, m_pipelineCache, 1, &pipelineInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS)
+    VkPipeline pipeline{};
+    const VkResult result = vkCreateGraphicsPipelines(m_device.get_device(), m_pipelineCache, 1, &pipelineInfo, nullptr,
+                                                      &pipeline);
+    vkDestroyShaderModule(m_device.get_device(), fragModule, nullptr);
+    vkDestroyShaderModule(m_device.get_device(), vertModule, nullptr);
+    if (result != VK_SUCCESS)
+        return make_error("Failed to create debug line pipeline", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+    return pipeline;
+}
+
+void VulkanPipeline::set_cache_directory(std::filesystem::path directory)
+{
+    m_cacheDirectory = std::move(directory);
+}
+
+Result<> VulkanPipeline::save_cache() const
+{
+    if (m_pipelineCache == nullptr || m_cacheDirectory.empty())
+        return {};
+
+    VkDevice device = m_device.get_device();
+    std::size_t dataSize{};
+    if (vkGetPipelineCacheData(device, m_pipelineCache, &dataSize, nullptr) != VK_SUCCESS)
+        return make_error("Failed to query pipeline cache size", ErrorCode::AssetCacheWriteFailed);
+
+    std::vector<std::byte> data(dataSize);
+    if (vkGetPipelineCacheData(device, m_pipelineCache, &dataSize, data.data()) != VK_SUCCESS)
+        return make_error("Failed to read pipeline cache data", ErrorCode::AssetCacheWriteFailed);
+    data.resize(dataSize);
+
+    const std::filesystem::path cachePath = cache_file_path();
+    std::error_code ec;
+    std::filesystem::create_directories(cachePath.parent_path(), ec);
+
+    // Write next to the target and rename, so a crash mid-write never leaves a torn cache behind.
+    std::filesystem::path tempPath = cachePath;
+    tempPath += ".tmp";
     {
-        vkDestroyShaderModule(device, fragShaderModule, nullptr);
-        vkDestroyShaderModule(device, vertShaderModule, nullptr);
-        return make_error("Failed to create graphics pipeline", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return make_error(
+                fmt::format("Failed to open pipeline cache for writing: {}", tempPath.string()),
+                ErrorCode::AssetCacheWriteFailed
+            );
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good())
+            return make_error(
+                fmt::format("Failed to write pipeline cache: {}", tempPath.string()),
+                ErrorCode::AssetCacheWriteFailed
+            );
     }
 
-    vkDestroyShaderModule(device, fragShaderModule, nullptr);
-    vkDestroyShaderModule(device, vertShaderModule, nullptr);
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec)
+        return make_error(
+            fmt::format("Failed to replace pipeline cache {}: {}", cachePath.string(), ec.message()),
+            ErrorCode::AssetCacheWriteFailed
+        );
     return {};
 }
 
 void VulkanPipeline::cleanup() noexcept
 {
+    wait_for_prewarm();
+
     VkDevice device = m_device.get_device();
 
-    if (m_graphicsPipeline != nullptr)
+    for (const Variant& variant : m_variants)
+        vkDestroyPipeline(device, variant.pipeline, nullptr);
+    m_variants.clear();
+    m_graphicsPipeline = nullptr;
+
+    if (m_fragShaderModule != nullptr)
     {
-        vkDestroyPipeline(device, m_graphicsPipeline, nullptr);
-        m_graphicsPipeline = nullptr;
+        vkDestroyShaderModule(device, m_fragShaderModule, nullptr);
+        m_fragShaderModule = nullptr;
+    }
+    if (m_vertShaderModule != nullptr)
+    {
+        vkDestroyShaderModule(device, m_vertShaderModule, nullptr);
+        m_vertShaderModule = nullptr;
     }
     if (m_pipelineLayout != nullptr)
     {
         vkDestroyPipelineLayout(device, m_pipelineLayout, nullptr);
         m_pipelineLayout = nullptr;
     }
-    if (m_descriptorSetLayout != nullptr)
+    if (m_instanceDescriptorSetLayout != nullptr)
     {
-        vkDestroyDescriptorSetLayout(device, m_descriptorSetLayout, nullptr);
-        m_descriptorSetLayout = nullptr;
+        vkDestroyDescriptorSetLayout(device, m_instanceDescriptorSetLayout, nullptr);
+        m_instanceDescriptorSetLayout = nullptr;
+    }
+    if (m_lightDescriptorSetLayout != nullptr)
+    {
+        vkDestroyDescriptorSetLayout(device, m_lightDescriptorSetLayout, nullptr);
+        m_lightDescriptorSetLayout = nullptr;
     }
 }
 
@@ -259,17 +696,26 @@ void VulkanPipeline::release_cache() noexcept
     if (device == nullptr)
     {
         m_pipelineCache = nullptr;
+        m_descriptorSetLayout = nullptr;
         return;
     }
 
+    if (m_descriptorSetLayout != nullptr)
+    {
+        vkDestroyDescriptorSetLayout(device, m_descriptorSetLayout, nullptr);
+        m_descriptorSetLayout = nullptr;
+    }
+
     if (m_pipelineCache != nullptr)
     {
+        if (auto result = save_cache(); !result)
+            fmt::print("Warning: failed to save pipeline cache: {}\n", result.error().message);
         vkDestroyPipelineCache(device, m_pipelineCache, nullptr);
         m_pipelineCache = nullptr;
     }
 }
 
-Result<VkShaderModule> VulkanPipeline::create_shader_module(const std::vector<std::uint32_t>& spirv) noexcept
+Result<VkShaderModule> VulkanPipeline::create_shader_module(const std::vector<std::uint32_t>& spirv) const noexcept
 {
     VkDevice device = m_device.get_device();
 
@@ -286,3 +732,232 @@ Result<VkShaderModule> VulkanPipeline::create_shader_module(const std::vector<st
 
     return shaderModule;
 }
+
+Result<VkPipeline> VulkanPipeline::create_variant(VkRenderPass renderPass, const MultisampleConfig& msConfig) const noexcept
+{
+    return create_variant(renderPass, msConfig, m_vertShaderModule, m_fragShaderModule);
+}
+
+Result<VkPipeline> VulkanPipeline::create_variant(VkRenderPass renderPass, const MultisampleConfig& msConfig,
+                                                  VkShaderModule vertModule, VkShaderModule fragModule) const noexcept
+{
+    VkDevice device = m_device.get_device();
+
+    VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
+    vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertShaderStageInfo.module = vertModule;
+    vertShaderStageInfo.pName = "main";
+
+    VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+    fragShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragShaderStageInfo.module = fragModule;
+    fragShaderStageInfo.pName = "main";
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages{
+        vertShaderStageInfo,
+        fragShaderStageInfo,
+    };
+
+    // Vertex Input State (packed vertex + per-instance slot)
+    auto vertexBindingDescription = PackedVertex::getBindingDescription();
+    auto vertexAttributeDescriptions = PackedVertex::getAttributeDescriptions();
+
+    std::array<VkVertexInputBindingDescription, 2> bindingDescriptions{};
+    bindingDescriptions[0] = vertexBindingDescription;
+    bindingDescriptions[1].binding = 1;
+    bindingDescriptions[1].stride = sizeof(std::uint32_t); // persistent instance slot index
+    bindingDescriptions[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+    std::array<VkVertexInputAttributeDescription, 5> attributeDescriptions{};
+    for (std::size_t i = 0; i < vertexAttributeDescriptions.size(); ++i)
+        attributeDescriptions[i] = vertexAttributeDescriptions[i];
+
+    // instance slot (location 4), resolved against the instance storage buffer in set 1
+    attributeDescriptions[4].binding = 1;
+    attributeDescriptions[4].location = 4;
+    attributeDescriptions[4].format = VK_FORMAT_R32_UINT;
+    attributeDescriptions[4].offset = 0;
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<std::uint32_t>(bindingDescriptions.size());
+    vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<std::uint32_t>(attributeDescriptions.size());
+    vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = false;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = false;
+    rasterizer.rasterizerDiscardEnable = false;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.depthBiasEnable = false;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = msConfig.samples;
+    multisampling.sampleShadingEnable = msConfig.sampleShading ? VK_TRUE : VK_FALSE;
+    multisampling.minSampleShading = msConfig.minSampleShading;
+    multisampling.alphaToCoverageEnable = msConfig.alphaToCoverage ? VK_TRUE : VK_FALSE;
+    multisampling.alphaToOneEnable = VK_FALSE;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = VK_TRUE;
+    // After a prepass only the nearest surface of each pixel passes, so the PBR shader runs once per sample.
+    depthStencil.depthWriteEnable = msConfig.depthPrepass ? VK_FALSE : VK_TRUE;
+    depthStencil.depthCompareOp = msConfig.depthPrepass ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS;
+    depthStencil.depthBoundsTestEnable = VK_FALSE;
+    depthStencil.stencilTestEnable = VK_FALSE;
+
+    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = false;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.logicOpEnable = false;
+    colorBlending.logicOp = VK_LOGIC_OP_COPY;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &colorBlendAttachment;
+
+    std::array<VkDynamicState, 2> dynamicStates{
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+    };
+
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<std::uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = shaderStages.data();
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = m_pipelineLayout;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+    pipelineInfo.basePipelineHandle = nullptr;
+    pipelineInfo.basePipelineIndex = -1;
+
+    VkPipeline pipeline{};
+    if (vkCreateGraphicsPipelines(device, m_pipelineCache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+        return make_error("Failed to create graphics pipeline", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+    return pipeline;
+}
+
+Result<> VulkanPipeline::create_pipeline_cache()
+{
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(m_device.get_physical_device(), &properties);
+
+    // The driver ignores blobs it cannot use, but some crash on foreign data; validate the header first.
+    std::vector<std::byte> initialData{};
+    if (!m_cacheDirectory.empty())
+    {
+        std::ifstream file(cache_file_path(), std::ios::binary | std::ios::ate);
+        if (file.is_open())
+        {
+            initialData.resize(static_cast<std::size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(initialData.data()), static_cast<std::streamsize>(initialData.size()));
+            if (!file.good())
+                initialData.clear();
+        }
+
+        VkPipelineCacheHeaderVersionOne header{};
+        if (initialData.size() >= sizeof(header))
+            std::memcpy(&header, initialData.data(), sizeof(header));
+        const bool headerMatches = initialData.size() >= sizeof(header) && header.headerSize >= sizeof(header) &&
+                                   header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                                   header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+                                   std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+        if (!headerMatches)
+            initialData.clear();
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheInfo{};
+    pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipelineCacheInfo.initialDataSize = initialData.size();
+    pipelineCacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    VkDevice device = m_device.get_device();
+    if (vkCreatePipelineCache(device, &pipelineCacheInfo, nullptr, &m_pipelineCache) == VK_SUCCESS)
+        return {};
+
+    // A rejected blob is not fatal: start from an empty cache.
+    pipelineCacheInfo.initialDataSize = 0;
+    pipelineCacheInfo.pInitialData = nullptr;
+    if (vkCreatePipelineCache(device, &pipelineCacheInfo, nullptr, &m_pipelineCache) != VK_SUCCESS)
+        return make_error("Failed to create pipeline cache", ErrorCode::VulkanGraphicsPipelineCreationFailed);
+    return {};
+}
+
+std::filesystem::path VulkanPipeline::cache_file_path() const
+{
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(m_device.get_physical_device(), &properties);
+
+    // Keyed by cache UUID and driver version: a driver update or a different GPU gets a fresh file.
+    std::string uuid{};
+    for (std::uint8_t byte : properties.pipelineCacheUUID)
+        uuid += fmt::format("{:02x}", byte);
+    return m_cacheDirectory / fmt::format("pipeline_{}_{:08x}.bin", uuid, properties.driverVersion);
+}
+
+VkPipeline VulkanPipeline::store_variant(const MultisampleConfig& config, VkPipeline pipeline) noexcept
+{
+    std::lock_guard lock{m_variantMutex};
+    for (const Variant& variant : m_variants)
+    {
+        if (variant.config.same_pipeline_state(config))
+        {
+            vkDestroyPipeline(m_device.get_device(), pipeline, nullptr);
+            return variant.pipeline;
+        }
+    }
+    m_variants.push_back(Variant{config, pipeline});
+    return pipeline;
+}
+
+VkPipeline VulkanPipeline::find_variant(const MultisampleConfig& config) const noexcept
+{
+    std::lock_guard lock{m_variantMutex};
+    for (const Variant& variant : m_variants)
+    {
+        if (variant.config.same_pipeline_state(config))
+            return variant.pipeline;
+    }
+    return nullptr;
+}
+
+void VulkanPipeline::wait_for_prewarm() noexcept
+{
+    m_prewarmCancelled.store(true, std::memory_order_relaxed);
+    std::unique_lock lock{m_variantMutex};
+    m_prewarmIdle.wait(lock, [this]() { return !m_prewarmRunning; });
+}
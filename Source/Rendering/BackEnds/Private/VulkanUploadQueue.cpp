@@ -0,0 +1,348 @@
+#include "../Public/VulkanUploadQueue.hpp"
+#include "../Public/VulkanDevice.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace
+{
+VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) noexcept
+{
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+} // namespace
+
+VulkanUploadQueue::~VulkanUploadQueue()
+{
+    cleanup();
+}
+
+Result<> VulkanUploadQueue::initialize(VulkanDevice& device, VkDeviceSize ringCapacity)
+{
+    m_device = &device;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = device.get_transfer_queue_family_index();
+    if (vkCreateCommandPool(device.get_device(), &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS)
+        return make_error("Failed to create upload command pool", ErrorCode::VulkanCommandPoolCreationFailed);
+
+    return create_ring(ringCapacity);
+}
+
+void VulkanUploadQueue::cleanup() noexcept
+{
+    if (m_device == nullptr)
+        return;
+
+    VkDevice device = m_device->get_device();
+    if (device != nullptr)
+    {
+        while (!m_inFlight.empty())
+        {
+            vkWaitForFences(device, 1, &m_inFlight.front().fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+            retire_oldest();
+        }
+
+        // An unsubmitted batch is simply dropped; its command buffer goes with the pool.
+        if (m_recording.fence != nullptr)
+            vkDestroyFence(device, m_recording.fence, nullptr);
+        for (const Batch& batch : m_freeBatches)
+            vkDestroyFence(device, batch.fence, nullptr);
+
+        if (m_commandPool != nullptr)
+            vkDestroyCommandPool(device, m_commandPool, nullptr);
+    }
+
+    m_recording = {};
+    m_freeBatches.clear();
+    m_commandPool = nullptr;
+    destroy_ring();
+    m_nextTicket = 1;
+    m_lastSubmittedTicket = 0;
+    m_completedTicket = 0;
+    m_device = nullptr;
+}
+
+Result<UploadStagingSpan> VulkanUploadQueue::reserve(VkDeviceSize size, VkDeviceSize alignment)
+{
+    if (m_device == nullptr || m_ringBuffer == nullptr)
+        return make_error("Upload queue is not initialized", ErrorCode::VulkanUploadSubmitFailed);
+
+    retire_completed();
+
+    if (size > m_ringCapacity)
+    {
+        // Grow only once everything referencing the old ring has retired.
+        if (auto result = wait_idle(); !result)
+            return make_error(result.error());
+        if (auto result = create_ring(std::max(size, m_ringCapacity * 2)); !result)
+            return make_error(result.error());
+    }
+
+    VkDeviceSize offset{};
+    VkDeviceSize previousHead = m_ringHead;
+    VkDeviceSize previousUsed = m_ringUsed;
+    while (!try_reserve_ring(size, alignment, offset))
+    {
+        // Ring full: make the recording batch's space reclaimable, then wait for the oldest batch.
+        if (m_recording.commandBuffer != nullptr)
+        {
+            if (auto result = flush(); !result)
+                return make_error(result.error());
+        }
+        if (auto result = wait_oldest(); !result)
+            return make_error(result.error());
+        previousHead = m_ringHead;
+        previousUsed = m_ringUsed;
+    }
+
+    if (m_recording.commandBuffer == nullptr)
+    {
+        if (auto result = begin_batch(); !result)
+        {
+            m_ringHead = previousHead;
+            m_ringUsed = previousUsed;
+            return make_error(result.error());
+        }
+        m_recording.ringStart = previousHead;
+    }
+    m_recording.ringBytes += m_ringUsed - previousUsed;
+
+    UploadStagingSpan span{};
+    span.commandBuffer = m_recording.commandBuffer;
+    span.buffer = m_ringBuffer;
+    span.offset = offset;
+    span.mapped = static_cast<std::byte*>(m_ringMapped) + offset;
+    return span;
+}
+
+Result<std::uint64_t> VulkanUploadQueue::flush()
+{
+    if (m_recording.commandBuffer == nullptr)
+        return m_lastSubmittedTicket;
+
+    Batch batch = m_recording;
+    m_recording = {};
+
+    if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS)
+    {
+        release_unsubmitted(batch);
+        return make_error("Failed to end upload command buffer", ErrorCode::VulkanCommandBufferRecordingFailed);
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.commandBuffer;
+    if (vkQueueSubmit(m_device->get_transfer_queue(), 1, &submitInfo, batch.fence) != VK_SUCCESS)
+    {
+        release_unsubmitted(batch);
+        return make_error("Failed to submit upload command buffer", ErrorCode::VulkanUploadSubmitFailed);
+    }
+
+    m_lastSubmittedTicket = batch.ticket;
+    m_inFlight.push_back(batch);
+    return batch.ticket;
+}
+
+void VulkanUploadQueue::release_unsubmitted(Batch& batch) noexcept
+{
+    // The newest batch owns the ring range ending at the head, so rewinding is exact.
+    m_ringHead = batch.ringStart;
+    m_ringUsed -= std::min(m_ringUsed, batch.ringBytes);
+    batch.ringBytes = 0;
+    m_freeBatches.push_back(batch);
+}
+
+Result<> VulkanUploadQueue::wait(std::uint64_t ticket)
+{
+    if (m_recording.commandBuffer != nullptr && ticket >= m_recording.ticket)
+    {
+        if (auto result = flush(); !result)
+            return make_error(result.error());
+    }
+
+    while (!m_inFlight.empty() && m_inFlight.front().ticket <= ticket)
+    {
+        if (auto result = wait_oldest(); !result)
+            return result;
+    }
+    return {};
+}
+
+Result<> VulkanUploadQueue::wait_idle()
+{
+    if (auto result = flush(); !result)
+        return make_error(result.error());
+    return wait(m_lastSubmittedTicket);
+}
+
+bool VulkanUploadQueue::is_complete(std::uint64_t ticket) noexcept
+{
+    retire_completed();
+    return ticket <= m_completedTicket;
+}
+
+Result<> VulkanUploadQueue::create_ring(VkDeviceSize capacity)
+{
+    destroy_ring();
+
+    VkDeviceSize allocationBytes{};
+    if (auto result = m_device->create_buffer(
+            capacity,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_ringBuffer,
+            m_ringMemory,
+            &allocationBytes
+        );
+        !result)
+    {
+        return result;
+    }
+
+    if (vkMapMemory(m_device->get_device(), m_ringMemory, 0, capacity, 0, &m_ringMapped) != VK_SUCCESS)
+    {
+        destroy_ring();
+        return make_error("Failed to map upload staging ring", ErrorCode::VulkanMemoryAllocationFailed);
+    }
+
+    m_ringCapacity = capacity;
+    m_ringHead = 0;
+    m_ringUsed = 0;
+    m_ringAllocationBytes = static_cast<std::uint64_t>(allocationBytes);
+    return {};
+}
+
+void VulkanUploadQueue::destroy_ring() noexcept
+{
+    VkDevice device = m_device != nullptr ? m_device->get_device() : nullptr;
+    if (device != nullptr)
+    {
+        if (m_ringMapped != nullptr)
+            vkUnmapMemory(device, m_ringMemory);
+        if (m_ringBuffer != nullptr)
+            vkDestroyBuffer(device, m_ringBuffer, nullptr);
+        if (m_ringMemory != nullptr)
+            vkFreeMemory(device, m_ringMemory, nullptr);
+    }
+
+    m_ringBuffer = nullptr;
+    m_ringMemory = nullptr;
+    m_ringMapped = nullptr;
+    m_ringCapacity = 0;
+    m_ringHead = 0;
+    m_ringUsed = 0;
+    m_ringAllocationBytes = 0;
+}
+
+Result<> VulkanUploadQueue::begin_batch()
+{
+    VkDevice device = m_device->get_device();
+
+    Batch batch{};
+    if (!m_freeBatches.empty())
+    {
+        batch = m_freeBatches.back();
+        m_freeBatches.pop_back();
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = m_commandPool;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(device, &allocInfo, &batch.commandBuffer) != VK_SUCCESS)
+            return make_error("Failed to allocate upload command buffer", ErrorCode::VulkanCommandBufferAllocationFailed);
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS)
+        {
+            vkFreeCommandBuffers(device, m_commandPool, 1, &batch.commandBuffer);
+            return make_error("Failed to create upload fence", ErrorCode::VulkanSyncObjectsCreationFailed);
+        }
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(batch.commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        m_freeBatches.push_back(batch);
+        return make_error("Failed to begin upload command buffer", ErrorCode::VulkanCommandBufferRecordingFailed);
+    }
+
+    batch.ticket = m_nextTicket++;
+    batch.ringBytes = 0;
+    m_recording = batch;
+    return {};
+}
+
+bool VulkanUploadQueue::try_reserve_ring(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset) noexcept
+{
+    VkDeviceSize offset = align_up(m_ringHead, alignment);
+    VkDeviceSize consumed = offset - m_ringHead + size;
+    if (offset + size > m_ringCapacity)
+    {
+        // Wrap to the start; the skipped tail is charged to this batch so it is reclaimed with it.
+        offset = 0;
+        consumed = m_ringCapacity - m_ringHead + size;
+    }
+    if (m_ringUsed + consumed > m_ringCapacity)
+        return false;
+
+    m_ringHead = offset + size;
+    m_ringUsed += consumed;
+    outOffset = offset;
+    return true;
+}
+
+Result<> VulkanUploadQueue::wait_oldest()
+{
+    if (m_inFlight.empty())
+    {
+        // Nothing left to reclaim; restart the ring so a request that fits is not blocked by wrap padding.
+        if (m_ringUsed == 0)
+        {
+            m_ringHead = 0;
+            return {};
+        }
+        return make_error("Upload staging ring is exhausted by the batch being recorded",
+                          ErrorCode::VulkanUploadSubmitFailed);
+    }
+
+    if (vkWaitForFences(m_device->get_device(), 1, &m_inFlight.front().fence, VK_TRUE,
+                        std::numeric_limits<std::uint64_t>::max()) != VK_SUCCESS)
+    {
+        return make_error("Failed to wait for upload fence", ErrorCode::VulkanUploadSubmitFailed);
+    }
+    retire_oldest();
+    return {};
+}
+
+void VulkanUploadQueue::retire_completed() noexcept
+{
+    VkDevice device = m_device != nullptr ? m_device->get_device() : nullptr;
+    while (device != nullptr && !m_inFlight.empty() && vkGetFenceStatus(device, m_inFlight.front().fence) == VK_SUCCESS)
+        retire_oldest();
+}
+
+void VulkanUploadQueue::retire_oldest() noexcept
+{
+    Batch batch = m_inFlight.front();
+    m_inFlight.pop_front();
+
+    vkResetFences(m_device->get_device(), 1, &batch.fence);
+    m_ringUsed -= std::min(m_ringUsed, batch.ringBytes);
+    if (m_ringUsed == 0 && m_recording.commandBuffer == nullptr)
+        m_ringHead = 0;
+    m_completedTicket = std::max(m_completedTicket, batch.ticket);
+
+    batch.ringBytes = 0;
+    m_freeBatches.push_back(batch);
+}
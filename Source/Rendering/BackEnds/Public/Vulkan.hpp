@@ -1,16 +1,29 @@
 #pragma once
+#include "../../../Core/Public/AssetId.hpp"
 #include "../../../Core/Public/Expected.hpp"
+#include "../../Public/DrawKeys.hpp"
+#include "../../Public/FrustumCuller.hpp"
 #include "../../Public/IRenderer.hpp"
 #include "../../Public/Mesh.hpp"
+#include "../../Public/OcclusionCuller.hpp"
 #include "../../Public/Renderable.hpp"
+#include "../../Public/ShaderHotReloader.hpp"
 #include "VulkanDevice.hpp"
+#include "VulkanGeometryArena.hpp"
+#include "VulkanGpuProfiler.hpp"
 #include "VulkanPipeline.hpp"
 #include "VulkanSwapchain.hpp"
+#include "VulkanUploadQueue.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <DirectXMath.h>
@@ -49,6 +62,12 @@ class NOC_EXPORT Vulkan : public IRenderer
 
     void wait_idle() noexcept override;
 
+    void wait_for_next_frame() noexcept override;
+    FrameLatencyStats get_frame_latency_stats() const noexcept override
+    {
+        return m_frameLatencyStats;
+    }
+
     void cleanup() noexcept;
 
     Result<uint32_t> upload_mesh(const MeshData& meshData) override;
@@ -65,6 +84,10 @@ class NOC_EXPORT Vulkan : public IRenderer
 
     Result<> clear_scene_content() noexcept override;
 
+    Result<UploadTicket> flush_uploads() override;
+    Result<> wait_for_uploads(UploadTicket ticket) override;
+    bool is_upload_complete(UploadTicket ticket) noexcept override;
+
     // --- Delegating getters for ImGuiLayer and other consumers ---
     inline VkInstance get_instance() const noexcept
     {
@@ -99,6 +122,15 @@ class NOC_EXPORT Vulkan : public IRenderer
     {
         return get_active_scene_view();
     }
+    /// Bottom-right texture coordinate of the rendered area in get_scene_color_image_view().
+    /// Below 1 while dynamic resolution renders into part of the scene target and NIS is not upscaling it.
+    inline DirectX::XMFLOAT2 get_scene_color_uv_extent() const noexcept
+    {
+        if ((m_nisEnabled && m_nisOutputView != nullptr) || m_sceneTargetWidth == 0 || m_sceneTargetHeight == 0)
+            return {1.0f, 1.0f};
+        return {static_cast<float>(m_sceneRenderWidth) / static_cast<float>(m_sceneTargetWidth),
+                static_cast<float>(m_sceneRenderHeight) / static_cast<float>(m_sceneTargetHeight)};
+    }
     inline VkExtent2D get_swapchain_extent() const noexcept
     {
         return m_swapchain.get_extent();
@@ -147,7 +179,7 @@ class NOC_EXPORT Vulkan : public IRenderer
     }
     inline std::uint32_t get_renderable_count() const noexcept
     {
-        return static_cast<std::uint32_t>(m_renderables.size());
+        return static_cast<std::uint32_t>(m_drawItems.size());
     }
     std::uint32_t get_total_triangle_count() const noexcept
     {
@@ -161,6 +193,11 @@ class NOC_EXPORT Vulkan : public IRenderer
     {
         return m_lastCulledRenderableCount;
     }
+    /// Renderables inside the frustum but hidden behind the previous Hi-Z depth; not part of the culled count.
+    inline std::uint32_t get_last_occluded_renderable_count() const noexcept
+    {
+        return m_lastOccludedRenderableCount;
+    }
     inline std::uint32_t get_last_draw_call_count() const noexcept
     {
         return m_lastDrawCallCount;
@@ -169,33 +206,125 @@ class NOC_EXPORT Vulkan : public IRenderer
     {
         return m_lastInstancedBatchCount;
     }
+    /// Secondary command buffers per scene sub-pass last frame; 1 = recorded inline on the render thread.
+    inline std::uint32_t get_last_scene_record_chunk_count() const noexcept
+    {
+        return m_lastSceneRecordChunkCount;
+    }
+    /// Geometry arena bytes holding live meshes; the pages themselves count as reserved buffer memory.
     inline std::uint64_t get_mesh_memory_bytes() const noexcept
     {
-        return m_meshMemoryBytes;
+        return m_geometryArena.get_used_bytes();
+    }
+    inline std::uint32_t get_geometry_page_count() const noexcept
+    {
+        return m_geometryArena.get_page_count();
     }
     inline std::uint64_t get_texture_memory_bytes() const noexcept
     {
         return m_textureMemoryBytes;
     }
+    /// Textures whose finer mip levels are streamed, and how many of them are swapping images right now.
+    inline std::uint32_t get_streamed_texture_count() const noexcept
+    {
+        return static_cast<std::uint32_t>(m_streamedTextures.size());
+    }
+    inline std::uint32_t get_texture_streams_in_flight() const noexcept
+    {
+        return m_textureStreamsInFlight;
+    }
+    /// Mip levels streamed textures are missing from what their on-screen size asks for, summed.
+    inline std::uint32_t get_texture_streaming_missing_mips() const noexcept
+    {
+        return m_textureStreamingMissingMips;
+    }
+    /// Device-local bytes streaming keeps usage under; 0 when the driver reports no budget.
+    inline std::uint64_t get_texture_streaming_limit_bytes() const noexcept
+    {
+        return m_textureStreamingLimitBytes;
+    }
+    /// Device memory reserved for mesh buffers, including free space inside sub-allocation blocks.
+    inline std::uint64_t get_mesh_reserved_memory_bytes() const noexcept
+    {
+        return m_vulkanDevice.get_allocator().get_stats(VulkanResourceKind::Buffer).reservedBytes;
+    }
+    /// Device memory reserved for textures, including free space inside sub-allocation blocks.
+    inline std::uint64_t get_texture_reserved_memory_bytes() const noexcept
+    {
+        return m_vulkanDevice.get_allocator().get_stats(VulkanResourceKind::Image).reservedBytes;
+    }
     inline std::uint64_t get_instance_memory_bytes() const noexcept
     {
         return m_instanceBufferMemoryBytes;
     }
+    /// Bytes written into the persistent instance buffers (dirty slots + visible slot list) last frame.
+    inline std::uint64_t get_last_instance_upload_bytes() const noexcept
+    {
+        return m_lastInstanceUploadBytes;
+    }
     inline std::uint64_t get_upload_staging_memory_bytes() const noexcept
     {
-        return m_uploadStagingMemoryBytes;
+        return m_uploadQueue.get_staging_memory_bytes();
+    }
+    inline std::uint32_t get_upload_batches_in_flight() const noexcept
+    {
+        return m_uploadQueue.get_in_flight_batch_count();
+    }
+    inline bool has_dedicated_transfer_queue() const noexcept
+    {
+        return m_vulkanDevice.has_dedicated_transfer_queue();
+    }
+    inline std::uint64_t get_gpu_cull_memory_bytes() const noexcept
+    {
+        return m_gpuCullHostMemoryBytes + m_gpuCullDeviceMemoryBytes;
+    }
+    inline std::uint32_t get_light_count() const noexcept
+    {
+        return static_cast<std::uint32_t>(m_lights.size());
+    }
+    inline std::uint64_t get_light_memory_bytes() const noexcept
+    {
+        return m_lightHostMemoryBytes + m_lightDeviceMemoryBytes;
+    }
+    /// Shadow cascades re-rendered last frame; cached cascades only count when they were invalidated.
+    inline std::uint32_t get_last_shadow_cascade_render_count() const noexcept
+    {
+        return m_lastShadowCascadeRenderCount;
+    }
+    inline std::uint32_t get_last_shadow_draw_call_count() const noexcept
+    {
+        return m_lastShadowDrawCallCount;
+    }
+    inline std::uint64_t get_shadow_memory_bytes() const noexcept
+    {
+        return m_shadowMapMemoryBytes + m_shadowHostMemoryBytes;
+    }
+    /// Debug primitives set by set_debug_draw() and the draw calls they took last frame.
+    inline std::uint32_t get_debug_draw_instance_count() const noexcept
+    {
+        return static_cast<std::uint32_t>(m_debugDrawInstances.size());
+    }
+    inline std::uint32_t get_last_debug_draw_call_count() const noexcept
+    {
+        return m_lastDebugDrawCallCount;
+    }
+    inline std::uint64_t get_debug_draw_memory_bytes() const noexcept
+    {
+        return m_debugDrawHostMemoryBytes;
     }
     inline std::uint64_t get_scene_target_memory_bytes() const noexcept
     {
-        return m_sceneColorMemoryBytes + m_sceneDepthMemoryBytes + m_msaaColorMemoryBytes;
+        return m_sceneColorMemoryBytes + m_sceneDepthMemoryBytes + m_msaaColorMemoryBytes + m_hiZMemoryBytes;
     }
     inline std::uint64_t get_tracked_device_local_memory_bytes() const noexcept
     {
-        return m_meshMemoryBytes + m_textureMemoryBytes + get_scene_target_memory_bytes();
+        return get_mesh_reserved_memory_bytes() + get_texture_reserved_memory_bytes() + get_scene_target_memory_bytes() +
+               m_gpuCullDeviceMemoryBytes + m_lightDeviceMemoryBytes + m_shadowMapMemoryBytes;
     }
     inline std::uint64_t get_tracked_host_visible_memory_bytes() const noexcept
     {
-        return m_instanceBufferMemoryBytes + m_uploadStagingMemoryBytes;
+        return m_instanceBufferMemoryBytes + get_upload_staging_memory_bytes() + m_gpuCullHostMemoryBytes +
+               m_hiZReadbackMemoryBytes + m_lightHostMemoryBytes + m_shadowHostMemoryBytes + m_debugDrawHostMemoryBytes;
     }
     inline std::uint64_t get_total_tracked_memory_bytes() const noexcept
     {
@@ -205,6 +334,32 @@ class NOC_EXPORT Vulkan : public IRenderer
     {
         return m_vulkanDevice.get_device_local_memory_budget();
     }
+    inline const VulkanAllocator& get_device_allocator() const noexcept
+    {
+        return m_vulkanDevice.get_allocator();
+    }
+    /// False when the graphics queue has no timestamp support; the GPU timings then stay empty.
+    inline bool is_gpu_timing_supported() const noexcept
+    {
+        return m_gpuProfiler.is_supported();
+    }
+    /// Rolling GPU time of one pass, MAX_FRAMES_IN_FLIGHT frames behind the CPU.
+    inline const GpuTimingStats& get_gpu_pass_timing(GpuPass pass) const noexcept
+    {
+        return m_gpuProfiler.get_pass_timing(pass);
+    }
+    inline const GpuTimingStats& get_gpu_frame_timing() const noexcept
+    {
+        return m_gpuProfiler.get_frame_timing();
+    }
+    inline bool has_gpu_pipeline_statistics() const noexcept
+    {
+        return m_gpuProfiler.has_pipeline_statistics();
+    }
+    inline const GpuPipelineStatistics& get_gpu_pipeline_statistics() const noexcept
+    {
+        return m_gpuProfiler.get_pipeline_statistics();
+    }
 
     using UIRenderCallback = std::function<void(VkCommandBuffer)>;
     inline void set_ui_render_callback(const UIRenderCallback& cb) noexcept
@@ -234,6 +389,9 @@ class NOC_EXPORT Vulkan : public IRenderer
     /// Sets the list of renderables to draw this frame.
     /// Each Renderable contains a world matrix and a mesh index.
     void set_renderables(const std::vector<Renderable>& renderables) noexcept override;
+    void set_lights(std::span<const Light> lights) noexcept override;
+    void update_renderables(const RenderableDelta& delta) noexcept override;
+    void set_debug_draw(const DebugDrawList& list) noexcept override;
     MeshBounds get_mesh_bounds(std::uint32_t meshIndex) const noexcept override;
 
     /// Notifies the renderer that the framebuffer was resized.
@@ -269,6 +427,54 @@ class NOC_EXPORT Vulkan : public IRenderer
     float get_nis_sharpness() const noexcept override;
     void set_render_scale(float scale) noexcept override;
     float get_render_scale() const noexcept override;
+    void set_gpu_culling_enabled(bool enabled) noexcept override;
+    bool get_gpu_culling_enabled() const noexcept override;
+    void set_occlusion_culling_enabled(bool enabled) noexcept override;
+    bool get_occlusion_culling_enabled() const noexcept override;
+    void set_depth_prepass_enabled(bool enabled) noexcept override;
+    bool get_depth_prepass_enabled() const noexcept override;
+    void set_lod_bias(float bias) noexcept override;
+    float get_lod_bias() const noexcept override;
+    void set_shadows_enabled(bool enabled) noexcept override;
+    bool get_shadows_enabled() const noexcept override;
+    void set_shadow_map_resolution(std::uint32_t resolution) noexcept override;
+    std::uint32_t get_shadow_map_resolution() const noexcept override;
+    void set_shadow_cascade_count(std::uint32_t count) noexcept override;
+    std::uint32_t get_shadow_cascade_count() const noexcept override;
+    void set_parallel_recording_enabled(bool enabled) noexcept override;
+    bool get_parallel_recording_enabled() const noexcept override;
+    void set_dynamic_resolution_enabled(bool enabled) noexcept override;
+    bool get_dynamic_resolution_enabled() const noexcept override;
+    void set_dynamic_resolution_target_ms(float milliseconds) noexcept override;
+    float get_dynamic_resolution_target_ms() const noexcept override;
+    void set_dynamic_resolution_scale_range(float minScale, float maxScale) noexcept override;
+    float get_dynamic_resolution_min_scale() const noexcept override;
+    float get_dynamic_resolution_max_scale() const noexcept override;
+    void set_dynamic_resolution_response(float response) noexcept override;
+    float get_dynamic_resolution_response() const noexcept override;
+    float get_dynamic_resolution_scale() const noexcept override;
+    void set_texture_streaming_enabled(bool enabled) noexcept override;
+    bool get_texture_streaming_enabled() const noexcept override;
+    void set_texture_streaming_budget_fraction(float fraction) noexcept override;
+    float get_texture_streaming_budget_fraction() const noexcept override;
+
+    /// Offscreen mode for headless benchmarks: with presentation off, frames render the scene
+    /// (cull, scene and NIS passes) and are submitted, but no swapchain image is acquired, no UI
+    /// or blit pass is recorded and nothing is presented.
+    void set_presentation_enabled(bool enabled) noexcept
+    {
+        m_presentationEnabled = enabled;
+    }
+    bool is_presentation_enabled() const noexcept
+    {
+        return m_presentationEnabled;
+    }
+
+    /// Executor used to spread CPU frustum culling across worker threads; null culls inline.
+    void set_task_executor(tf::Executor* executor) noexcept
+    {
+        m_taskExecutor = executor;
+    }
 
     // --- Shader management (IRenderer overrides) ---
     void set_shader_paths(const std::filesystem::path& vertPath, const std::filesystem::path& fragPath) override;
@@ -277,39 +483,252 @@ class NOC_EXPORT Vulkan : public IRenderer
         m_shaderLoadMode = mode;
     }
     Result<> recompile_shaders() override;
+    void set_shader_hot_reload(bool enabled) override
+    {
+        m_shaderReloader.set_watching(enabled);
+    }
+    bool get_shader_hot_reload() const noexcept override
+    {
+        return m_shaderReloader.is_watching();
+    }
+    void request_shader_reload() noexcept override
+    {
+        m_shaderReloader.request_compile();
+    }
+    bool is_shader_reload_pending() const noexcept override;
+    std::optional<Result<>> poll_shader_reload() override
+    {
+        return std::exchange(m_shaderReloadStatus, std::nullopt);
+    }
 
   private:
+    struct PendingShaderBuild;
+
+    /// One level of a texture's mip chain, as a byte range inside its pixel payload.
+    struct TextureLevel
+    {
+        VkExtent2D extent{};
+        std::uint64_t offset{};
+        std::uint64_t size{};
+    };
+
+    /// A texture uploaded from a cooked, file-mapped mip chain whose finer levels are loaded on demand.
+    /// Its live image is m_textures[textureIndex]; a replacement is uploaded beside it and swapped in.
+    struct StreamedTexture
+    {
+        std::uint32_t textureIndex{};
+        std::string name{};
+        VkFormat format{VK_FORMAT_UNDEFINED};
+        VkComponentMapping components{};
+        std::vector<TextureLevel> levels{};
+        std::span<const std::uint8_t> pixels{};
+        std::shared_ptr<const void> mappedSource{}; // keeps `pixels` mapped after the asset cache drops it
+        std::uint32_t baseLevel{};     // coarsest level streaming keeps: the first no larger than TextureStreamingBaseSize
+        std::uint32_t residentLevel{}; // finest level of the live image
+        std::uint32_t desiredLevel{};  // finest level last frame's on-screen size asks for
+        std::uint64_t lastVisibleFrame{};
+        GpuTexture incoming{}; // replacement being uploaded
+        std::uint32_t incomingLevel{};
+        UploadTicket incomingTicket{};
+        GpuTexture outgoing{};                // replaced image, destroyed once no frame's set names it
+        std::uint8_t descriptorDirtyFrames{}; // bit per frame in flight whose set still names `outgoing`
+
+        /// Bytes of `level` and every coarser level; the chain is stored largest first, back to back.
+        inline std::uint64_t chain_bytes(std::uint32_t level) const noexcept
+        {
+            return levels.back().offset + levels.back().size - levels[level].offset;
+        }
+        inline bool is_swapping() const noexcept
+        {
+            return incoming.image != nullptr || outgoing.image != nullptr;
+        }
+    };
+
+    /// A replaced shader set and the frame it was replaced on; destroyed once every frame that
+    /// could still reference it has retired.
+    struct RetiredShaderSet
+    {
+        PipelineShaderSet shaderSet{};
+        std::uint64_t retiredOnFrame{};
+    };
+
+    /// Render thread, after the frame fence: starts builds for freshly compiled shaders, swaps finished
+    /// builds in and destroys retired sets that no frame in flight can still use.
+    void update_shader_reload() noexcept;
+    void retire_shader_set(PipelineShaderSet&& shaderSet);
+    void destroy_retired_shader_sets(bool all) noexcept;
+    void wait_for_shader_build() noexcept;
+
     Result<> create_command_buffers();
     Result<> record_command_buffer(VkCommandBuffer commandBuffer, std::uint32_t imageIndex) noexcept;
+    /// Number of chunks the scene pass's batches are split into for parallel recording; 1 = inline.
+    std::uint32_t scene_record_chunk_count(std::size_t batchCount) const noexcept;
+    /// Grows the frame's chunk list to `chunkCount`, each chunk with its own pool and secondaries.
+    Result<> ensure_scene_record_chunks(std::size_t frameIndex, std::size_t chunkCount);
+    void cleanup_scene_record_chunks() noexcept;
     Result<> create_sync_objects();
     Result<> recreate_swap_chain();
-    Result<> ensure_instance_buffer_capacity(std::size_t requiredInstances);
-    Result<> ensure_upload_staging_capacity(VkDeviceSize requiredSize);
-    void cleanup_upload_staging_buffer() noexcept;
+    Result<> create_instance_descriptor_sets();
+    void cleanup_instance_frame(std::size_t frameIndex) noexcept;
+    /// Grows the frame's persistent slot buffer (re-uploading every slot) and visible slot buffer.
+    Result<> ensure_instance_frame_capacity(std::size_t frameIndex, std::size_t slotCount, std::size_t visibleCount);
+    /// Writes the slots dirtied since this frame's buffers were last used, coalesced into ranges.
+    Result<> upload_dirty_instance_slots(std::size_t frameIndex);
+    std::uint32_t acquire_instance_slot();
+    void mark_instance_slot_dirty(std::uint32_t slot) noexcept;
+    /// Writes one renderable into its entity's slot (acquiring one if needed) and refreshes the
+    /// slot's draw key, culling sphere and triangle contribution.
+    void write_renderable(const Renderable& renderable, const DirectX::XMMATRIX& view);
+    /// Takes a slot out of the draw list and returns it to the free list.
+    void retire_renderable_slot(std::uint32_t slot) noexcept;
+    /// Re-sorts the slot draw keys and rebuilds m_drawItems plus the CPU culling inputs.
+    void rebuild_draw_items();
+    void reset_instance_slots() noexcept;
     Result<> create_sampler();
     Result<> create_default_textures();
-    Result<> create_descriptor_pool();
+    /// Creates the bindless set 0 (global texture array + material record buffer) once per device.
+    Result<> create_material_descriptors();
     Result<> create_default_material();
+    /// Creates an image holding levels [firstLevel, levels.size()) of a mip chain stored back to back in
+    /// `pixels` and queues their copy; the image is shader-readable once the upload batch completes.
+    Result<GpuTexture> create_texture_image(const std::string& name, VkFormat format, const VkComponentMapping& components,
+                                            std::span<const TextureLevel> levels, std::uint32_t firstLevel,
+                                            std::span<const std::uint8_t> pixels);
+    void destroy_texture_image(GpuTexture& texture) noexcept;
+    /// Points element `textureIndex` of the frame's bindless set at the texture's current image.
+    void write_texture_descriptor(std::size_t frameIndex, std::uint32_t textureIndex) noexcept;
     void destroy_meshes() noexcept;
     void destroy_textures() noexcept;
-    void destroy_material_pool() noexcept;
+    void destroy_material_descriptors() noexcept;
 
     // --- Offscreen scene rendering ---
     Result<> create_scene_render_pass();
+    /// Builds a scene pass for `samples` without touching m_sceneRenderPass; pipelines compiled
+    /// against it are usable with the real pass of the same sample count.
+    Result<VkRenderPass> create_compatible_scene_render_pass(VkSampleCountFlagBits samples);
+    /// Queues background compiles of every multisample pipeline variant the device supports.
+    void prewarm_pipeline_variants();
+    /// Pipeline options of the scene pass as currently configured.
+    MultisampleConfig scene_pipeline_config() const noexcept;
     Result<> create_scene_render_target();
     void cleanup_scene_render_target();
     void cleanup_scene_render_pass();
     void compute_scene_render_size();
+    /// Sets the render size to `scale` times the swapchain extent, clamped to the scene target.
+    void apply_scene_render_scale(float scale) noexcept;
+    /// Steers the dynamic resolution scale toward the target frame time from the last GPU frame time.
+    void update_dynamic_resolution() noexcept;
+    /// Scale range dynamic resolution may use: the requested range within what the active upscaler supports.
+    std::pair<float, float> dynamic_resolution_range() const noexcept;
     VkSampleCountFlagBits get_max_usable_sample_count() const noexcept;
 
     // --- NIS (NVIDIA Image Scaling) ---
     Result<> create_nis_resources();
     void cleanup_nis_resources();
-    void update_nis_config();
+    /// Writes the config UBO for the current render size: from the host when `cmd` is null (no frame in
+    /// flight may read it), otherwise recorded into `cmd` ahead of the NIS dispatch.
+    void update_nis_config(VkCommandBuffer cmd = nullptr);
     void dispatch_nis_pass(VkCommandBuffer cmd);
     /// Returns the image view the editor should sample for the viewport.
     VkImageView get_active_scene_view() const noexcept;
 
+    // --- GPU-driven culling ---
+    Result<> create_gpu_cull_resources();
+    void cleanup_gpu_cull_resources();
+    void cleanup_gpu_cull_frame(std::size_t frameIndex) noexcept;
+    Result<> ensure_gpu_cull_frame_capacity(std::size_t frameIndex, std::size_t instanceCount, std::size_t outputCount,
+                                            std::size_t batchCount);
+    /// Rebuilds the CPU-side cull inputs and per-batch draw templates from m_drawItems.
+    void rebuild_gpu_cull_inputs();
+    /// Re-sorts m_gpuCullBatchOrder front to back by live view distance when the draw items changed
+    /// or the camera moved far enough since the last sort.
+    void update_gpu_cull_batch_order(DirectX::FXMVECTOR cameraPosition);
+    /// Reads back last use's stats, uploads inputs and records the cull dispatch for the current frame.
+    Result<> dispatch_gpu_cull_pass(VkCommandBuffer cmd, const DirectX::XMFLOAT4X4& viewProj);
+
+    // --- Hi-Z occlusion culling ---
+    /// Creates the max-depth pyramid over the scene depth target and its build pipelines.
+    /// Sized from the scene target, so it is rebuilt along with it.
+    Result<> create_hiz_resources();
+    void cleanup_hiz_resources();
+    /// Records the pyramid build from this frame's scene depth; with `readback`, also copies a
+    /// small level to this frame's host buffer for the CPU culling path.
+    void dispatch_hiz_pass(VkCommandBuffer cmd, const DirectX::XMFLOAT4X4& viewProj, bool readback);
+
+    // --- Clustered lighting ---
+    /// Creates set 2 of the scene pipeline for every frame in flight and the cluster.comp pipeline.
+    Result<> create_light_cluster_resources();
+    void cleanup_light_cluster_resources();
+    void cleanup_light_frame(std::size_t frameIndex) noexcept;
+    /// Grows the frame's light buffer to hold `lightCount` lights and rewrites its descriptor set.
+    Result<> ensure_light_frame_capacity(std::size_t frameIndex, std::size_t lightCount);
+    /// Copies this frame's changed lights into its light buffer as contiguous ranges.
+    Result<> upload_dirty_lights(std::size_t frameIndex);
+    void mark_light_dirty(std::uint32_t index) noexcept;
+    /// Writes the lighting parameters and records the cluster binning dispatch for the current frame.
+    Result<> dispatch_light_cluster_pass(VkCommandBuffer cmd);
+    /// Near and far planes of the camera projection, or the default camera range when it is not a
+    /// right-handed perspective.
+    std::pair<float, float> camera_clip_planes() const noexcept;
+
+    // --- Cascaded sun shadows ---
+    /// Creates the caster render pass, compare sampler, caster pipeline and the cascade depth array.
+    Result<> create_shadow_resources();
+    void cleanup_shadow_resources();
+    /// Creates the depth array (one layer per cascade at m_shadowResolution) with its views and framebuffers,
+    /// leaving every layer readable. Recreated when the resolution or cascade count changes.
+    Result<> create_shadow_map();
+    void cleanup_shadow_map() noexcept;
+    void cleanup_shadow_frame(std::size_t frameIndex) noexcept;
+    /// Grows the frame's caster slot buffer to hold `slotCount` entries.
+    Result<> ensure_shadow_frame_capacity(std::size_t frameIndex, std::size_t slotCount);
+    /// Forces every cascade to be refitted and re-rendered on the next frame.
+    void invalidate_shadow_cascades() noexcept;
+    /// Records a static caster that appeared, moved or went away, for the cached cascades to test against.
+    void note_static_shadow_change(const DirectX::XMFLOAT4& sphere);
+    /// Fits the cascades to the camera and sun, decides which ones must be re-rendered and culls their
+    /// casters, one task per cascade.
+    void update_shadow_cascades();
+    /// Uploads the casters of the cascades marked dirty and records their depth passes.
+    Result<> record_shadow_pass(VkCommandBuffer cmd, VkDescriptorSet instanceSet);
+
+    // --- Depth prepass ---
+    /// Builds the depth-only pipeline for the current sample count against m_sceneRenderPass.
+    Result<> create_depth_prepass_pipeline();
+    void cleanup_depth_prepass_pipeline() noexcept;
+
+    // --- Debug overlay ---
+    /// Builds the depth-tested and overlay line pipelines for the current sample count, and the unit
+    /// shape buffer on first use. Only called once something is drawn, so a game without debug
+    /// primitives never compiles them.
+    Result<> create_debug_draw_resources();
+    /// Destroys the pipelines; the shape buffer and frame buffers stay unless `all`.
+    void cleanup_debug_draw_resources(bool all) noexcept;
+    void cleanup_debug_draw_frame(std::size_t frameIndex) noexcept;
+    /// Copies the primitives into this frame's buffer unless it already holds the current list, and
+    /// writes one indirect draw per shape and depth mode ahead of them.
+    Result<> upload_debug_draw_frame(std::size_t frameIndex);
+    /// Draws this frame's primitives inside the scene pass. Returns the draw calls recorded. Only
+    /// reads renderer state, so a scene recording worker may call it.
+    std::uint32_t record_debug_draws(VkCommandBuffer cmd) const noexcept;
+
+    // --- Level of detail ---
+    /// Converts projected sphere radius into units of the allowed LOD error: a level with
+    /// MeshLod::error e is acceptable while e * radius * lod_distance_scale() / distance <= 1.
+    float lod_distance_scale() const noexcept;
+    /// Pixels spanned by one world unit at distance 1 along the view axis: a sphere of radius r at
+    /// distance d covers 2 * r * screen_pixel_scale() / d pixels of the render height.
+    float screen_pixel_scale() const noexcept;
+
+    // --- Texture streaming ---
+    /// Render thread, after the frame fence: swaps finished stream uploads into this frame's bindless set,
+    /// picks each streamed texture's level from last frame's on-screen sizes and starts the uploads that
+    /// fit the budget, evicting finer levels first when device-local usage is over it.
+    void update_texture_streaming() noexcept;
+    /// Queues an image holding `targetLevel` and coarser for a streamed texture; it replaces the live
+    /// image once its upload completes.
+    Result<> start_texture_stream(StreamedTexture& streamed, std::uint32_t targetLevel);
+
     Result<VkFormat> find_depth_format();
     Result<VkFormat> find_supported_format(
         const std::vector<VkFormat>& candidates, 
@@ -317,19 +736,240 @@ class NOC_EXPORT Vulkan : public IRenderer
         VkFormatFeatureFlags features
     );
 
+    /// One draw in key order: what to draw and which instance slot draws it.
+    struct DrawItem
+    {
+        std::uint32_t meshIndex{};
+        std::uint32_t slot{};
+    };
+
+    /// Instances drawn with one (mesh, LOD) pair.
     struct InstanceBatch
     {
         uint32_t meshIndex{};
-        uint32_t materialIndex{};
+        uint32_t lodLevel{};
         uint32_t firstInstance{};
         uint32_t instanceCount{};
     };
 
+    /// One mesh's run of m_drawItems and the per-LOD batches cull.comp compacts it into.
+    struct GpuCullRun
+    {
+        std::uint32_t firstDrawItem{};
+        std::uint32_t drawItemCount{};
+        std::uint32_t firstBatch{};
+        std::uint32_t batchCount{};
+    };
+
+    /// Persistent per-entity instance data (std430, read by shader.vert and cull.comp).
     struct InstanceData
     {
-        DirectX::XMFLOAT4X4 mvp{};
-        DirectX::XMFLOAT4X4 model{};
-        DirectX::XMFLOAT4 glow{};
+        DirectX::XMFLOAT3X4 model{};   // affine world matrix, transposed; the shaders rebuild a mat4x3
+        std::uint32_t glow{};          // RGB9E5 glow color * intensity
+        std::uint32_t materialIndex{}; // record in the bindless material buffer
+        std::uint32_t padding[2]{};
+    };
+    static_assert(sizeof(InstanceData) == 64, "InstanceData must match the std430 layout in shader.vert/cull.comp");
+
+    /// Per-frame-in-flight instance buffers of the scene pass.
+    struct InstanceFrame
+    {
+        VkBuffer slotBuffer{};    // InstanceData[] indexed by persistent slot, host-visible storage buffer
+        VkDeviceMemory slotMemory{};
+        void* slotMapped{};
+        VkBuffer visibleBuffer{}; // uint32 slot per visible instance, vertex binding 1 (CPU culling path)
+        VkDeviceMemory visibleMemory{};
+        void* visibleMapped{};
+        VkDescriptorSet descriptorSet{}; // set 1 of the scene pipeline, points at slotBuffer
+        std::size_t slotCapacity{};
+        std::size_t visibleCapacity{};
+        std::vector<std::uint32_t> dirtySlots{};
+        VkDeviceSize slotAllocatedBytes{};
+        VkDeviceSize visibleAllocatedBytes{};
+    };
+
+    /// Per-renderable input of cull.comp (std430 layout).
+    struct GpuCullInstance
+    {
+        DirectX::XMFLOAT4 boundingSphere{}; // local-space center (xyz) + radius (w)
+        std::uint32_t slot{};
+        std::uint32_t batchIndex{}; // LOD 0 batch of the mesh; LOD n draws from batchIndex + n
+        std::uint32_t lodCount{};
+        std::uint32_t padding{};
+        DirectX::XMFLOAT4 lodErrors{}; // MeshLod::error per level, unused levels ignored
+    };
+
+    /// Push constants of hiz.comp and hiz_ms.comp.
+    struct HiZPushConstants
+    {
+        std::uint32_t sampleCount{};
+        std::uint32_t padding{};
+        std::uint32_t sourceMaxX{}; // last source texel read; level 0 stops at the scene viewport
+        std::uint32_t sourceMaxY{};
+    };
+
+    struct GpuCullPushConstants
+    {
+        DirectX::XMFLOAT4X4 viewProj{};
+        DirectX::XMFLOAT4 cameraLodScale{}; // world camera position (xyz), lod_distance_scale() (w)
+        std::uint32_t instanceCount{};
+        float pixelScale{}; // screen_pixel_scale()
+    };
+
+    /// Occlusion test inputs of cull.comp (std140 uniform).
+    struct GpuOcclusionParams
+    {
+        DirectX::XMFLOAT4X4 viewProj{}; // view-projection the Hi-Z pyramid was rendered with
+        std::uint32_t viewportWidth{};
+        std::uint32_t viewportHeight{};
+        std::uint32_t mipCount{}; // 0 disables the test
+        std::uint32_t padding{};
+    };
+
+    /// Per-frame-in-flight buffers of the GPU culling path.
+    struct GpuCullFrame
+    {
+        VkBuffer inputBuffer{};   // GpuCullInstance[], host-visible
+        VkDeviceMemory inputMemory{};
+        void* inputMapped{};
+        VkBuffer outputBuffer{};  // uint32 visible slots, device-local, bound as vertex binding 1
+        VkDeviceMemory outputMemory{};
+        VkBuffer drawBuffer{};    // VkDrawIndexedIndirectCommand[] (one per batch), host-visible
+        VkDeviceMemory drawMemory{};
+        void* drawMapped{};
+        VkBuffer countBuffer{};   // {visible, culled, occluded, drawCount[batch]...}, host-visible
+        VkDeviceMemory countMemory{};
+        void* countMapped{};
+        VkBuffer occlusionBuffer{}; // GpuOcclusionParams, host-visible uniform
+        VkDeviceMemory occlusionMemory{};
+        void* occlusionMapped{};
+        VkBuffer feedbackBuffer{}; // uint32 per material: largest on-screen diameter in pixels, host-visible
+        VkDeviceMemory feedbackMemory{};
+        void* feedbackMapped{};
+        VkDescriptorSet descriptorSet{};
+        VkBuffer boundSlotBuffer{}; // instance slot buffer currently written into descriptorSet
+        VkImageView boundHiZView{}; // Hi-Z view currently written into descriptorSet
+        std::size_t instanceCapacity{};
+        std::size_t outputCapacity{};
+        std::size_t batchCapacity{};
+        std::uint64_t uploadedInputVersion{};
+        VkDeviceSize hostAllocatedBytes{};
+        VkDeviceSize deviceAllocatedBytes{};
+        bool statsPending{false};
+    };
+
+    /// One light as read by cluster.comp and shader.frag (std430).
+    struct GpuLight
+    {
+        DirectX::XMFLOAT4 positionRange{};      // world position (xyz), range (w)
+        DirectX::XMFLOAT4 colorSpotOuter{};     // linear color * intensity (rgb), cos of the outer cone (w)
+        DirectX::XMFLOAT4 directionSpotInner{}; // unit direction (xyz), cos of the inner cone (w); point lights use -2/-1
+    };
+    static_assert(sizeof(GpuLight) == 48, "GpuLight must match the std430 layout in cluster.comp/shader.frag");
+
+    /// Upper bound of sun shadow cascades; the split arrays below are a vec4 in shader.frag.
+    static constexpr std::uint32_t MaxShadowCascades{4};
+
+    /// Frame-wide lighting inputs of cluster.comp and shader.frag (std140 uniform).
+    struct GpuLightingParams
+    {
+        DirectX::XMFLOAT4X4 view{};
+        DirectX::XMFLOAT4X4 inverseProj{};
+        DirectX::XMFLOAT4 cameraPosition{}; // world space (xyz)
+        DirectX::XMFLOAT4 sunDirection{};   // unit vector towards the sun (xyz)
+        DirectX::XMFLOAT4 sunColor{};       // linear color * intensity (rgb)
+        DirectX::XMFLOAT4 clusterScale{};   // tile size in pixels (xy), log-depth slice scale (z) and bias (w)
+        DirectX::XMFLOAT4 viewport{};       // render width, height, near plane, far plane
+        std::uint32_t lightCount{};
+        std::uint32_t shadowCascadeCount{}; // 0 disables sun shadows
+        float shadowMapTexelSize{};         // 1 / shadow map resolution
+        std::uint32_t padding{};
+        float shadowSplits[MaxShadowCascades]{};          // view depth where each cascade ends
+        float shadowTexelWorldSizes[MaxShadowCascades]{}; // world units covered by one texel of each cascade
+        DirectX::XMFLOAT4X4 shadowViewProj[MaxShadowCascades]{};
+    };
+    static_assert(MaxShadowCascades == 4, "Cascade arrays are a vec4 in shader.frag");
+
+    /// Per-frame-in-flight buffers of set 2.
+    struct LightFrame
+    {
+        VkBuffer lightBuffer{};   // GpuLight[], host-visible
+        VkDeviceMemory lightMemory{};
+        void* lightMapped{};
+        VkBuffer clusterBuffer{}; // light count per cluster, then MaxLightsPerCluster indices per cluster; device-local
+        VkDeviceMemory clusterMemory{};
+        VkBuffer paramsBuffer{};  // GpuLightingParams, host-visible uniform
+        VkDeviceMemory paramsMemory{};
+        void* paramsMapped{};
+        VkDescriptorSet descriptorSet{};
+        VkImageView boundShadowView{}; // shadow cascade view currently written into descriptorSet
+        std::size_t lightCapacity{};
+        std::vector<std::uint32_t> dirtyLights{};
+        VkDeviceSize hostAllocatedBytes{};
+        VkDeviceSize deviceAllocatedBytes{};
+    };
+
+    /// One cascade of the sun shadow map: the volume it was fitted to and the casters drawn into it.
+    struct ShadowCascade
+    {
+        DirectX::XMFLOAT4X4 viewProj{}; // light view * orthographic projection
+        FrustumPlanes frustum{};        // caster volume, reaching back towards the sun
+        DirectX::XMFLOAT4 bounds{};     // world-space sphere the cascade covers (xyz center, w radius)
+        float splitFar{};               // view depth where the next cascade takes over
+        float texelWorldSize{};         // world units per shadow texel
+        bool valid{false};              // fitted and rendered; cached cascades keep their contents while valid
+        bool dirty{false};              // re-rendered this frame
+        std::vector<std::uint8_t> visible{};
+        std::vector<std::uint32_t> slots{};   // caster slots, grouped by batch
+        std::vector<InstanceBatch> batches{}; // firstInstance relative to slots
+        std::array<std::vector<std::uint32_t>, MaxMeshLods> lodSlots{};
+        std::uint32_t firstSlot{}; // where slots start in this frame's caster slot buffer
+    };
+
+    /// Per-frame-in-flight debug primitives: DebugDrawIndirectCount indirect draw commands, then the
+    /// instances of every bucket back to back (vertex binding 1 of the debug pipelines). Host-visible.
+    struct DebugDrawFrame
+    {
+        VkBuffer buffer{};
+        VkDeviceMemory memory{};
+        void* mapped{};
+        std::size_t instanceCapacity{};
+        std::uint64_t uploadedVersion{};
+        VkDeviceSize allocatedBytes{};
+    };
+
+    /// Per-frame-in-flight caster slots of the cascades re-rendered that frame, vertex binding 1 of the shadow pass.
+    struct ShadowFrame
+    {
+        VkBuffer slotBuffer{};
+        VkDeviceMemory slotMemory{};
+        void* slotMapped{};
+        std::size_t slotCapacity{};
+        VkDeviceSize allocatedBytes{};
+    };
+
+    /// One slice of the scene pass's batch list, recorded on a worker thread. The pool is only ever
+    /// touched by the task recording the chunk, so no two threads share a pool.
+    struct SceneRecordChunk
+    {
+        VkCommandPool commandPool{};
+        VkCommandBuffer prepassCommandBuffer{}; // depth prepass draws of the chunk's batches
+        VkCommandBuffer colorCommandBuffer{};   // color draws of the same batches
+        std::uint32_t drawCalls{};
+        bool failed{false};
+    };
+
+    /// Per-frame-in-flight host copy of one Hi-Z level, read by the CPU culling path once the
+    /// frame's fence has signalled.
+    struct HiZReadback
+    {
+        VkBuffer buffer{};
+        VkDeviceMemory memory{};
+        void* mapped{};
+        DirectX::XMFLOAT4X4 viewProj{};
+        std::uint32_t viewportWidth{}; // render size of the scene pass the copied level was built from
+        std::uint32_t viewportHeight{};
+        bool pending{false};
     };
 
     // --- Sub-components ---
@@ -339,6 +979,9 @@ class NOC_EXPORT Vulkan : public IRenderer
 
     // --- Owned by Vulkan (orchestration) ---
     std::vector<VkCommandBuffer> m_commandBuffers{};
+    std::array<std::vector<SceneRecordChunk>, MAX_FRAMES_IN_FLIGHT> m_sceneRecordChunks{};
+    bool m_parallelRecordingEnabled{true};
+    std::uint32_t m_lastSceneRecordChunkCount{1};
 
     std::vector<VkSemaphore> m_imageAvailableSemaphores{};
     std::vector<VkFence> m_inFlightFences{};
@@ -349,49 +992,95 @@ class NOC_EXPORT Vulkan : public IRenderer
     bool m_framebufferResized{false};
 
     uint32_t m_currentFrame{};
+    std::uint64_t m_frameNumber{}; // frames submitted so far; never wraps, unlike m_currentFrame
+
+    // Frame pacing (wait_for_next_frame). Present ids are only used with VK_KHR_present_wait and
+    // belong to the current swapchain; 0 = the slot's last frame was not presented with one.
+    static constexpr std::uint64_t PresentWaitTimeoutNs{100'000'000}; // minimized or occluded windows may never present
+    std::uint64_t m_lastPresentId{};
+    std::array<std::uint64_t, MAX_FRAMES_IN_FLIGHT> m_framePresentIds{};
+    std::array<std::chrono::steady_clock::time_point, MAX_FRAMES_IN_FLIGHT> m_frameInputTimes{};
+    std::chrono::steady_clock::time_point m_nextFrameInputTime{};
+    FrameLatencyStats m_frameLatencyStats{};
 
     UIRenderCallback m_uiRenderCallback{};
     SwapchainRecreatedCallback m_swapchainRecreatedCallback{};
 
     std::vector<Mesh> m_meshes{};
-    std::vector<Renderable> m_renderables{};
+    std::vector<DrawItem> m_drawItems{}; // draw-key order, rebuilt when renderables change
+    std::vector<DrawItem> m_drawItemsScratch{};
+    DrawKeySorter m_drawKeySorter{}; // sorts m_slotDrawKeys
+    FrustumCuller m_frustumCuller{};
+    std::vector<DirectX::XMFLOAT4> m_cullSpheresScratch{}; // world spheres in draw-item order
+    std::vector<std::uint8_t> m_cullStaticFlagsScratch{};
+    std::vector<std::uint8_t> m_cullVisibleScratch{};
+    tf::Executor* m_taskExecutor{};
     std::uint32_t m_totalTriangleCountCached{};
     std::uint32_t m_lastVisibleRenderableCount{};
     std::uint32_t m_lastCulledRenderableCount{};
+    std::uint32_t m_lastOccludedRenderableCount{};
     std::uint32_t m_lastDrawCallCount{};
     std::uint32_t m_lastInstancedBatchCount{};
-    std::uint64_t m_meshMemoryBytes{};
     std::uint64_t m_textureMemoryBytes{};
     std::uint64_t m_instanceBufferMemoryBytes{};
-    std::uint64_t m_uploadStagingMemoryBytes{};
-    std::unordered_map<std::string, std::uint32_t> m_meshLookup{};
+    std::unordered_map<AssetId, std::uint32_t> m_meshLookup{};
 
     std::vector<GpuTexture> m_textures{};
-    std::unordered_map<std::string, std::uint32_t> m_textureLookup{};
+    std::unordered_map<AssetId, std::uint32_t> m_textureLookup{};
     VkSampler m_sampler{nullptr};
     std::uint32_t m_defaultAlbedoTextureIndex{};
     std::uint32_t m_defaultNormalTextureIndex{};
-    std::uint32_t m_defaultRoughnessTextureIndex{};
-    std::uint32_t m_defaultMetallicTextureIndex{};
-    std::uint32_t m_defaultAOTextureIndex{};
+    std::uint32_t m_defaultOrmTextureIndex{}; // shared by the roughness, metallic and AO slots
 
+    // --- Bindless materials (set 0) ---
+    static constexpr std::uint32_t MaxMaterials{4096};
     std::vector<GpuMaterial> m_materials{};
     std::unordered_map<std::uint64_t, std::uint32_t> m_materialLookup{};
+    // One set per frame in flight so a texture's element can be repointed once that frame's fence has signalled.
     VkDescriptorPool m_descriptorPool{};
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> m_materialDescriptorSets{};
+    VkBuffer m_materialBuffer{}; // GpuMaterial[MaxMaterials], host-visible storage buffer
+    VkDeviceMemory m_materialMemory{};
+    void* m_materialMapped{};
     std::uint32_t m_defaultMaterialIndex{};
+    // Per material: largest on-screen diameter in pixels of a visible instance, from the last culling pass.
+    std::vector<std::uint32_t> m_materialScreenPixels{};
 
-    std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> m_instanceBuffers{};
-    std::array<VkDeviceMemory, MAX_FRAMES_IN_FLIGHT> m_instanceBufferMemories{};
-    std::array<void*, MAX_FRAMES_IN_FLIGHT> m_instanceBufferMappings{};
-    std::array<VkDeviceSize, MAX_FRAMES_IN_FLIGHT> m_instanceBufferAllocatedBytes{};
-    std::size_t m_instanceBufferCapacity{};
-    std::vector<InstanceData> m_instanceDataScratch{};
+    // --- Texture streaming ---
+    bool m_textureStreamingEnabled{true};
+    float m_textureStreamingBudgetFraction{0.8f};
+    std::vector<StreamedTexture> m_streamedTextures{};
+    std::vector<std::uint32_t> m_textureScreenPixelsScratch{}; // per texture, from m_materialScreenPixels
+    std::vector<std::uint32_t> m_textureStreamOrderScratch{};
+    std::uint32_t m_textureStreamsInFlight{};
+    std::uint32_t m_textureStreamingMissingMips{};
+    std::uint64_t m_textureStreamingLimitBytes{};
+
+    // --- Persistent instance slots (keyed by Renderable::entityId) ---
+    std::array<InstanceFrame, MAX_FRAMES_IN_FLIGHT> m_instanceFrames{};
+    VkDescriptorPool m_instanceDescriptorPool{};
+    std::vector<InstanceData> m_instanceSlots{};
+    std::vector<std::uint32_t> m_instanceSlotGenerations{};
+    std::vector<std::uint8_t> m_instanceSlotDirtyFrames{}; // bit per frame in flight still to upload
+    std::vector<std::uint32_t> m_freeInstanceSlots{};
+    std::unordered_map<std::uint32_t, std::uint32_t> m_entityInstanceSlots{};
+    // Per-slot draw state, parallel to m_instanceSlots; free slots carry DeadSlotDrawKey and sort last.
+    static constexpr std::uint64_t DeadSlotDrawKey{UINT64_MAX};
+    std::vector<std::uint64_t> m_slotDrawKeys{};
+    std::vector<std::uint32_t> m_slotMeshIndices{};
+    std::vector<DirectX::XMFLOAT4> m_slotSpheres{}; // world-space bounding sphere
+    std::vector<std::uint8_t> m_slotStaticFlags{};
+    std::uint32_t m_instanceSlotGeneration{};
+    std::uint64_t m_lastInstanceUploadBytes{};
+    std::vector<std::uint32_t> m_visibleSlotsScratch{};
     std::vector<InstanceBatch> m_instanceBatchesScratch{};
+    std::array<std::vector<std::uint32_t>, MaxMeshLods> m_lodSlotsScratch{}; // visible slots of one mesh run per LOD
+    std::vector<float> m_batchNearestScratch{};      // per batch: nearest view distance of its instances
+    std::vector<std::uint32_t> m_batchOrderScratch{}; // batch indices, front to back
 
-    VkBuffer m_uploadStagingBuffer{};
-    VkDeviceMemory m_uploadStagingBufferMemory{};
-    void* m_uploadStagingMapped{};
-    VkDeviceSize m_uploadStagingCapacity{};
+    VulkanUploadQueue m_uploadQueue{};
+    VulkanGeometryArena m_geometryArena{};
+    VulkanGpuProfiler m_gpuProfiler{};
 
     DirectX::XMFLOAT4X4 m_viewMatrix{};
     DirectX::XMFLOAT4X4 m_projMatrix{};
@@ -418,19 +1107,35 @@ class NOC_EXPORT Vulkan : public IRenderer
     VkImageView m_msaaColorView{};
     std::uint64_t m_msaaColorMemoryBytes{};
 
+    // The scene pass renders the top-left m_sceneRenderWidth x m_sceneRenderHeight of attachments allocated at
+    // m_sceneTargetWidth x m_sceneTargetHeight; the two only differ while dynamic resolution is on.
     std::uint32_t m_sceneRenderWidth{};
     std::uint32_t m_sceneRenderHeight{};
+    std::uint32_t m_sceneTargetWidth{};
+    std::uint32_t m_sceneTargetHeight{};
 
     // --- Settings ---
     float m_renderScale{1.0f};
+    float m_lodBias{1.0f};
     VkSampleCountFlagBits m_msaaSamples{VK_SAMPLE_COUNT_1_BIT};
     bool m_alphaToCoverageEnabled{false};
     bool m_sampleShadingEnabled{false};
     float m_minSampleShading{0.25f};
     bool m_vsyncEnabled{false}; // Default: auto (mailbox preferred)
 
+    // --- Dynamic resolution ---
+    bool m_dynamicResolutionEnabled{false};
+    float m_dynamicResolutionTargetMs{16.6f};
+    float m_dynamicResolutionMinScale{0.5f};
+    float m_dynamicResolutionMaxScale{1.0f};
+    float m_dynamicResolutionResponse{0.2f};
+    float m_dynamicResolutionScale{1.0f}; // scale the next frame renders at
+    std::uint64_t m_dynamicResolutionSamplesSeen{}; // profiler frame samples already acted on
+    std::uint32_t m_dynamicResolutionStarvedFrames{}; // updates since the last new frame timing
+
     // --- NIS (NVIDIA Image Scaling) ---
     bool m_nisEnabled{false};
+    bool m_presentationEnabled{true};
     float m_nisSharpness{0.5f};
     VkPipeline m_nisComputePipeline{};
     VkPipelineLayout m_nisPipelineLayout{};
@@ -448,16 +1153,153 @@ class NOC_EXPORT Vulkan : public IRenderer
     VkImageView m_nisCoefUsmView{};
     VkBuffer m_nisConfigBuffer{};
     VkDeviceMemory m_nisConfigMemory{};
+    std::uint32_t m_nisConfigWidth{}; // input viewport the config UBO was last written for
+    std::uint32_t m_nisConfigHeight{};
     VkSampler m_nisLinearSampler{};
     std::vector<std::uint32_t> m_nisComputeSpirv{};
     std::filesystem::path m_nisShaderPath{};
 
+    // --- GPU-driven culling ---
+    bool m_gpuCullingEnabled{false};
+    VkPipeline m_cullComputePipeline{};
+    VkPipelineLayout m_cullPipelineLayout{};
+    VkDescriptorSetLayout m_cullDescriptorSetLayout{};
+    VkDescriptorPool m_cullDescriptorPool{};
+    std::array<GpuCullFrame, MAX_FRAMES_IN_FLIGHT> m_gpuCullFrames{};
+    std::vector<GpuCullInstance> m_gpuCullInstances{};
+    std::vector<InstanceBatch> m_gpuCullBatches{}; // one per (mesh, LOD), each sized for the whole mesh run
+    std::size_t m_gpuCullOutputCount{};           // visible-slot entries reserved across all batches
+    std::vector<VkDrawIndexedIndirectCommand> m_gpuCullDrawTemplate{};
+    std::vector<GpuCullRun> m_gpuCullRuns{};
+    std::vector<std::uint32_t> m_gpuCullBatchOrder{}; // batch indices by nearest instance of their mesh run
+    std::vector<float> m_gpuCullBatchNearest{};       // sort keys of m_gpuCullBatchOrder, by batch
+    DirectX::XMFLOAT3 m_gpuCullOrderCameraPosition{}; // camera position of the last sort
+    bool m_gpuCullOrderDirty{true};
+    bool m_gpuCullInputsDirty{true};
+    std::uint64_t m_gpuCullInputVersion{};
+    std::uint64_t m_gpuCullHostMemoryBytes{};
+    std::uint64_t m_gpuCullDeviceMemoryBytes{};
+    std::vector<std::uint32_t> m_cullComputeSpirv{};
+    std::filesystem::path m_cullShaderPath{};
+
+    // --- Hi-Z occlusion culling ---
+    bool m_occlusionCullingEnabled{false};
+    VkImage m_hiZImage{}; // R32F max-depth pyramid, mip 0 at half the scene target, kept in GENERAL
+    VkDeviceMemory m_hiZMemory{};
+    VkImageView m_hiZView{}; // every level, sampled by cull.comp
+    std::vector<VkImageView> m_hiZMipViews{};
+    std::vector<VkDescriptorSet> m_hiZDescriptorSets{}; // set i reads level i - 1 (scene depth for 0), writes level i
+    std::uint32_t m_hiZWidth{};
+    std::uint32_t m_hiZHeight{};
+    std::uint32_t m_hiZMipCount{};
+    std::uint64_t m_hiZMemoryBytes{};
+    VkSampler m_hiZSampler{};
+    VkPipeline m_hiZPipeline{};            // hiz.comp
+    VkPipeline m_hiZMultisamplePipeline{}; // hiz_ms.comp, level 0 from MSAA depth
+    VkPipelineLayout m_hiZPipelineLayout{};
+    VkDescriptorSetLayout m_hiZDescriptorSetLayout{};
+    VkDescriptorPool m_hiZDescriptorPool{};
+    bool m_hiZValid{false};            // the pyramid holds a finished build
+    DirectX::XMFLOAT4X4 m_hiZViewProj{}; // view-projection of that build
+    std::uint32_t m_hiZViewportWidth{};  // render size of that build, at the pyramid's top-left
+    std::uint32_t m_hiZViewportHeight{};
+    std::array<HiZReadback, MAX_FRAMES_IN_FLIGHT> m_hiZReadbacks{};
+    std::uint32_t m_hiZReadbackLevel{};
+    std::uint64_t m_hiZReadbackMemoryBytes{};
+    OcclusionCuller m_occlusionCuller{};
+    std::vector<std::uint32_t> m_hiZComputeSpirv{};
+    std::vector<std::uint32_t> m_hiZMultisampleComputeSpirv{};
+    std::filesystem::path m_hiZShaderPath{};
+    std::filesystem::path m_hiZMultisampleShaderPath{};
+
+    // --- Clustered lighting ---
+    // Froxel grid: screen tiles in x/y, logarithmic depth slices in z. Must match cluster.comp/shader.frag.
+    static constexpr std::uint32_t ClusterGridX{16};
+    static constexpr std::uint32_t ClusterGridY{9};
+    static constexpr std::uint32_t ClusterGridZ{24};
+    static constexpr std::uint32_t ClusterCount{ClusterGridX * ClusterGridY * ClusterGridZ};
+    static constexpr std::uint32_t MaxLightsPerCluster{128};
+    std::vector<GpuLight> m_lights{};              // point and spot lights in upload order
+    std::vector<std::uint8_t> m_lightDirtyFrames{}; // bit per frame in flight still to upload
+    // Used while no directional light is set.
+    static constexpr DirectX::XMFLOAT3 DefaultSunDirection{0.5f, 0.7f, 1.0f};
+    static constexpr DirectX::XMFLOAT3 DefaultSunColor{3.0f, 3.0f, 3.0f};
+    DirectX::XMFLOAT3 m_sunDirection{DefaultSunDirection}; // towards the sun, normalized on upload
+    DirectX::XMFLOAT3 m_sunColor{DefaultSunColor};
+    std::array<LightFrame, MAX_FRAMES_IN_FLIGHT> m_lightFrames{};
+    VkPipeline m_lightClusterPipeline{};
+    VkPipelineLayout m_lightClusterPipelineLayout{};
+    VkDescriptorPool m_lightDescriptorPool{};
+    std::uint64_t m_lightHostMemoryBytes{};
+    std::uint64_t m_lightDeviceMemoryBytes{};
+    std::vector<std::uint32_t> m_clusterComputeSpirv{};
+    std::filesystem::path m_clusterShaderPath{};
+
+    // --- Cascaded sun shadows ---
+    // Near cascades are refitted and re-rendered every frame with every caster. Cached (far) cascades
+    // hold static casters only, are fitted with some slack and are only re-rendered when the camera
+    // leaves that slack or a static caster inside them changes.
+    bool m_shadowsEnabled{true};
+    std::uint32_t m_shadowResolution{2048};
+    std::uint32_t m_shadowCascadeCount{4};
+    std::array<ShadowCascade, MaxShadowCascades> m_shadowCascades{};
+    std::vector<DirectX::XMFLOAT4> m_shadowStaticChanges{}; // old and new spheres of changed static casters
+    DirectX::XMFLOAT3 m_shadowSunDirection{};               // sun direction the cascades were fitted for
+    VkFormat m_shadowFormat{VK_FORMAT_UNDEFINED};
+    VkImage m_shadowImage{}; // one depth layer per cascade; layers not being rendered stay SHADER_READ_ONLY
+    VkDeviceMemory m_shadowMemory{};
+    VkImageView m_shadowArrayView{}; // every layer, sampled by shader.frag
+    std::array<VkImageView, MaxShadowCascades> m_shadowLayerViews{};
+    std::array<VkFramebuffer, MaxShadowCascades> m_shadowFramebuffers{};
+    VkRenderPass m_shadowRenderPass{};
+    VkSampler m_shadowSampler{}; // depth compare, white border
+    VkPipeline m_shadowPipeline{}; // depth.vert, no fragment stage, dynamic depth bias
+    std::array<ShadowFrame, MAX_FRAMES_IN_FLIGHT> m_shadowFrames{};
+    std::uint64_t m_shadowMapMemoryBytes{};
+    std::uint64_t m_shadowHostMemoryBytes{};
+    std::uint32_t m_lastShadowCascadeRenderCount{};
+    std::uint32_t m_lastShadowDrawCallCount{};
+
+    // --- Depth prepass ---
+    bool m_depthPrepassEnabled{false};
+    VkPipeline m_depthPrepassPipeline{}; // depth.vert, no fragment stage, compiled for m_msaaSamples
+    std::vector<std::uint32_t> m_depthVertSpirv{};
+    std::filesystem::path m_depthVertShaderPath{};
+
+    // --- Debug overlay ---
+    // Instances are kept in DebugDrawList bucket order (per shape, depth-tested before overlay); the
+    // indirect commands are grouped by depth mode so each mode is one multi-draw.
+    static constexpr std::uint32_t DebugDrawIndirectCount{DebugShapeCount * 2};
+    std::vector<DebugDrawInstance> m_debugDrawInstances{};
+    std::array<std::uint32_t, DebugDrawIndirectCount> m_debugDrawBucketCounts{};
+    std::uint64_t m_debugDrawVersion{};
+    DebugShapeMesh m_debugShapeMesh{};
+    VkBuffer m_debugShapeBuffer{}; // unit shape quad corners (DebugShapeVertex), host-visible, vertex binding 0
+    VkDeviceMemory m_debugShapeMemory{};
+    VkDeviceSize m_debugShapeAllocatedBytes{};
+    std::array<DebugDrawFrame, MAX_FRAMES_IN_FLIGHT> m_debugDrawFrames{};
+    VkPipeline m_debugDepthTestedPipeline{}; // debug.vert/debug.frag, compiled for m_msaaSamples
+    VkPipeline m_debugOverlayPipeline{};
+    bool m_debugDrawFailed{false}; // pipeline creation failed; not retried until the sample count changes
+    std::vector<std::uint32_t> m_debugVertSpirv{};
+    std::vector<std::uint32_t> m_debugFragSpirv{};
+    std::filesystem::path m_debugVertShaderPath{};
+    std::filesystem::path m_debugFragShaderPath{};
+    std::uint64_t m_debugDrawHostMemoryBytes{};
+    std::uint32_t m_lastDebugDrawCallCount{};
+
     // --- Shader paths and cached SPIR-V ---
     ShaderLoadMode m_shaderLoadMode{ShaderLoadMode::RuntimeCompileWithCache};
     std::filesystem::path m_vertShaderPath{};
     std::filesystem::path m_fragShaderPath{};
     std::vector<std::uint32_t> m_vertSpirv{};
     std::vector<std::uint32_t> m_fragSpirv{};
+
+    // --- Background shader reload ---
+    ShaderHotReloader m_shaderReloader{};
+    std::shared_ptr<PendingShaderBuild> m_pendingShaderBuild{};
+    std::vector<RetiredShaderSet> m_retiredShaderSets{};
+    std::optional<Result<>> m_shaderReloadStatus{};
 };
 
 NOC_RESTORE_DLL_WARNINGS
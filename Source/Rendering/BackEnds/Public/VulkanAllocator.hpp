@@ -0,0 +1,119 @@
+#pragma once
+#include "../../../Core/Public/Expected.hpp"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+/// Resources are kept in separate blocks per kind so linear buffers and optimal-tiled
+/// images never share a page (no bufferImageGranularity padding needed).
+enum class VulkanResourceKind : std::uint8_t
+{
+    Buffer = 0,
+    Image = 1,
+};
+
+/// A range of device memory handed out by VulkanAllocator.
+struct VulkanAllocation
+{
+    VkDeviceMemory memory{};
+    VkDeviceSize offset{};
+    VkDeviceSize size{};               // bytes reserved for the resource (memory requirement size)
+    void* mapped{};                    // persistent mapping for host-visible memory types
+    std::uint32_t memoryTypeIndex{};
+    std::uint32_t blockIndex{};
+    VulkanResourceKind kind{VulkanResourceKind::Buffer};
+    bool dedicated{false};
+
+    inline bool is_valid() const noexcept
+    {
+        return memory != nullptr;
+    }
+};
+
+/// Usage of one resource kind across all memory types.
+struct VulkanAllocatorStats
+{
+    std::uint64_t reservedBytes{};   // VkDeviceMemory bytes held (blocks + dedicated allocations)
+    std::uint64_t usedBytes{};       // bytes handed out to live resources
+    std::uint32_t blockCount{};
+    std::uint32_t dedicatedCount{};
+    std::uint32_t allocationCount{};
+};
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Sub-allocates resources from large VkDeviceMemory blocks, one pool per (memory type, resource kind).
+/// Each block keeps an offset-ordered free list; allocation is best-fit and frees coalesce with
+/// their neighbours. Requests larger than half a block get a dedicated allocation.
+class NOC_EXPORT VulkanAllocator
+{
+  public:
+    VulkanAllocator() = default;
+    ~VulkanAllocator();
+
+    VulkanAllocator(const VulkanAllocator&) = delete;
+    VulkanAllocator& operator=(const VulkanAllocator&) = delete;
+
+    /// Captures memory properties and sizes blocks against the device's heaps.
+    void initialize(VkPhysicalDevice physicalDevice, VkDevice device) noexcept;
+
+    /// Frees every block. All allocations must have been released (or become invalid) by now.
+    void cleanup() noexcept;
+
+    Result<VulkanAllocation> allocate(
+        const VkMemoryRequirements& requirements,
+        std::uint32_t memoryTypeIndex,
+        VulkanResourceKind kind
+    );
+
+    /// Returns the range to its block and resets the handle. Safe to call on an invalid allocation.
+    void free(VulkanAllocation& allocation) noexcept;
+
+    VulkanAllocatorStats get_stats(VulkanResourceKind kind) const noexcept;
+
+    /// Number of live vkAllocateMemory objects owned by the allocator.
+    std::uint32_t get_device_memory_count() const noexcept;
+
+  private:
+    struct Block
+    {
+        VkDeviceMemory memory{};
+        VkDeviceSize size{};
+        VkDeviceSize usedBytes{};
+        void* mapped{};
+        std::uint32_t allocationCount{};
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges{}; // offset -> size
+    };
+
+    struct Pool
+    {
+        std::vector<Block> blocks{};
+    };
+
+    static constexpr std::size_t KindCount{2};
+
+    Result<std::uint32_t> create_block(Pool& pool, std::uint32_t memoryTypeIndex, VulkanResourceKind kind,
+                                       VkDeviceSize size);
+    Result<VulkanAllocation> allocate_dedicated(const VkMemoryRequirements& requirements, std::uint32_t memoryTypeIndex,
+                                                VulkanResourceKind kind);
+    static bool try_allocate_from_block(Block& block, const VkMemoryRequirements& requirements, VkDeviceSize& outOffset);
+    static void release_range(Block& block, VkDeviceSize offset, VkDeviceSize size);
+    void destroy_block(Block& block) noexcept;
+    Pool& get_pool(std::uint32_t memoryTypeIndex, VulkanResourceKind kind) noexcept;
+    bool is_host_visible(std::uint32_t memoryTypeIndex) const noexcept;
+
+    VkDevice m_device{};
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+    std::array<VkDeviceSize, VK_MAX_MEMORY_TYPES> m_blockSizes{};
+    std::array<std::array<Pool, VK_MAX_MEMORY_TYPES>, KindCount> m_pools{};
+    std::array<VulkanAllocatorStats, KindCount> m_stats{};
+    std::uint32_t m_deviceMemoryCount{};
+    mutable std::mutex m_mutex{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -1,5 +1,6 @@
 #pragma once
 #include "../../../Core/Public/Expected.hpp"
+#include "VulkanAllocator.hpp"
 
 #include <array>
 #include <chrono>
@@ -24,6 +25,7 @@ struct QueueFamilyIndices
 {
     std::optional<std::uint32_t> graphicsFamily{};
     std::optional<std::uint32_t> presentFamily{};
+    std::optional<std::uint32_t> transferFamily{}; // dedicated transfer-only family, when the device exposes one
 
     inline bool is_complete() const noexcept
     {
@@ -82,6 +84,19 @@ class NOC_EXPORT VulkanDevice
         VkDeviceSize* outAllocationBytes = nullptr
     );
 
+    /// Creates a buffer bound to a sub-allocated range of a shared memory block.
+    /// Release with destroy_buffer().
+    Result<> create_buffer(
+        VkDeviceSize size,
+        VkBufferUsageFlags usage,
+        VkMemoryPropertyFlags properties,
+        VkBuffer& buffer,
+        VulkanAllocation& allocation
+    );
+
+    /// Destroys a buffer created with the sub-allocating create_buffer() overload.
+    void destroy_buffer(VkBuffer& buffer, VulkanAllocation& allocation) noexcept;
+
     /// Allocates and begins a one-time command buffer from the main command pool.
     Result<VkCommandBuffer> begin_single_time_commands();
 
@@ -100,10 +115,47 @@ class NOC_EXPORT VulkanDevice
         VkImage& image,
         VkDeviceMemory& imageMemory, 
         VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
-        VkDeviceSize* outAllocationBytes = nullptr
+        VkDeviceSize* outAllocationBytes = nullptr,
+        std::uint32_t mipLevels = 1,
+        std::uint32_t arrayLayers = 1
+    );
+
+    /// Creates a render-pass-only attachment (TRANSIENT_ATTACHMENT usage added) whose contents never
+    /// leave the pass. Backed by lazily allocated memory where the device offers it, so tilers commit no
+    /// pages for it; otherwise by ordinary device-local memory. `outCommittedBytes` receives the bytes
+    /// actually committed at creation.
+    Result<> create_transient_attachment(
+        std::uint32_t width,
+        std::uint32_t height,
+        VkFormat format,
+        VkImageUsageFlags usage,
+        VkSampleCountFlagBits samples,
+        VkImage& image,
+        VkDeviceMemory& imageMemory,
+        VkDeviceSize* outCommittedBytes = nullptr
     );
 
-    Result<VkImageView> create_image_view(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags);
+    /// Creates a 2D image bound to a sub-allocated range of a shared memory block.
+    /// Release with destroy_image().
+    Result<> create_image(
+        std::uint32_t width,
+        std::uint32_t height,
+        VkFormat format,
+        VkImageTiling tiling,
+        VkImageUsageFlags usage,
+        VkMemoryPropertyFlags properties,
+        VkImage& image,
+        VulkanAllocation& allocation,
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+        std::uint32_t mipLevels = 1
+    );
+
+    /// Destroys an image created with the sub-allocating create_image() overload.
+    void destroy_image(VkImage& image, VulkanAllocation& allocation) noexcept;
+
+    /// Creates a 2D view over mips [0, mipLevels). `components` defaults to the identity swizzle.
+    Result<VkImageView> create_image_view(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags,
+                                          std::uint32_t mipLevels = 1, VkComponentMapping components = {});
 
     Result<> transition_image_layout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
 
@@ -130,6 +182,21 @@ class NOC_EXPORT VulkanDevice
     {
         return m_presentQueue;
     }
+    /// Queue used for asset uploads: a dedicated transfer queue when available, the graphics queue otherwise.
+    inline VkQueue get_transfer_queue() const noexcept
+    {
+        return m_transferQueue;
+    }
+    inline std::uint32_t get_transfer_queue_family_index() const noexcept
+    {
+        return m_transferQueueFamilyIndex;
+    }
+    /// True when uploads run on their own queue family. Sub-allocated buffers and images are then
+    /// created with concurrent sharing between the graphics and transfer families.
+    inline bool has_dedicated_transfer_queue() const noexcept
+    {
+        return m_hasDedicatedTransferQueue;
+    }
     inline VkSurfaceKHR get_surface() const noexcept
     {
         return m_surface;
@@ -154,8 +221,65 @@ class NOC_EXPORT VulkanDevice
         return properties.deviceName;
     }
     DeviceLocalMemoryBudget get_device_local_memory_budget() const noexcept;
+    inline const VulkanAllocator& get_allocator() const noexcept
+    {
+        return m_allocator;
+    }
+
+    /// True when indirect draws may use a non-zero firstInstance (required by GPU-driven culling).
+    inline bool supports_indirect_first_instance() const noexcept
+    {
+        return m_supportsIndirectFirstInstance;
+    }
+    /// True when one indirect call may issue several draw commands (multiDrawIndirect).
+    inline bool supports_multi_draw_indirect() const noexcept
+    {
+        return m_supportsMultiDrawIndirect;
+    }
+    /// True when BC1-BC7 block-compressed formats can be sampled (textureCompressionBC).
+    inline bool supports_texture_compression_bc() const noexcept
+    {
+        return m_supportsTextureCompressionBC;
+    }
+    /// True when pipeline statistics queries can be used (pipelineStatisticsQuery).
+    inline bool supports_pipeline_statistics() const noexcept
+    {
+        return m_supportsPipelineStatistics;
+    }
+    /// True when secondary command buffers may execute inside an active query (inheritedQueries).
+    inline bool supports_inherited_queries() const noexcept
+    {
+        return m_supportsInheritedQueries;
+    }
+    /// Number of elements in the bindless texture array, clamped to the per-stage sampler limits.
+    inline std::uint32_t get_max_bindless_textures() const noexcept
+    {
+        return m_maxBindlessTextures;
+    }
+    /// Returns vkCmdDrawIndexedIndirectCountKHR, or nullptr when VK_KHR_draw_indirect_count is unavailable.
+    inline PFN_vkCmdDrawIndexedIndirectCountKHR get_cmd_draw_indexed_indirect_count() const noexcept
+    {
+        return m_cmdDrawIndexedIndirectCount;
+    }
+    /// Returns vkWaitForPresentKHR, or nullptr unless VK_KHR_present_id and VK_KHR_present_wait are both enabled.
+    /// When set, presents may carry a VkPresentIdKHR.
+    inline PFN_vkWaitForPresentKHR get_wait_for_present() const noexcept
+    {
+        return m_waitForPresent;
+    }
 
   private:
+    static VkImageCreateInfo make_image_create_info(
+        std::uint32_t width,
+        std::uint32_t height,
+        VkFormat format,
+        VkImageTiling tiling,
+        VkImageUsageFlags usage,
+        VkSampleCountFlagBits samples,
+        std::uint32_t mipLevels = 1,
+        std::uint32_t arrayLayers = 1
+    ) noexcept;
+
     Result<> create_instance();
     Result<> setup_debug_messenger();
     Result<> create_surface(GLFWwindow* window) noexcept;
@@ -165,6 +289,8 @@ class NOC_EXPORT VulkanDevice
 
     bool is_device_suitable(VkPhysicalDevice device) noexcept;
     bool check_device_extension_support(VkPhysicalDevice device) noexcept;
+    /// True when the descriptor indexing features the bindless texture table relies on are present.
+    bool check_descriptor_indexing_support(VkPhysicalDevice device) const noexcept;
     bool check_validation_layer_support() const noexcept;
     std::vector<const char*> get_required_extensions();
 
@@ -194,8 +320,10 @@ class NOC_EXPORT VulkanDevice
     static constexpr std::array<const char*, 1> m_validationLayers{
         "VK_LAYER_KHRONOS_validation",
     };
-    static constexpr std::array<const char*, 1> m_deviceExtensions{
+    static constexpr std::array<const char*, 3> m_deviceExtensions{
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+        VK_KHR_MAINTENANCE3_EXTENSION_NAME,
+        VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, // bindless material textures
     };
 
 #ifdef NDEBUG
@@ -216,9 +344,25 @@ class NOC_EXPORT VulkanDevice
 
     VkQueue m_graphicsQueue{};
     VkQueue m_presentQueue{};
+    VkQueue m_transferQueue{};
+    std::uint32_t m_transferQueueFamilyIndex{};
+    std::array<std::uint32_t, 2> m_concurrentQueueFamilies{};
+    bool m_hasDedicatedTransferQueue{false};
 
     VkCommandPool m_commandPool{};
+    VulkanAllocator m_allocator{};
     bool m_hasMemoryBudgetExtension{false};
+    bool m_hasDrawIndirectCountExtension{false};
+    bool m_hasPresentIdExtension{false};
+    bool m_hasPresentWaitExtension{false};
+    bool m_supportsIndirectFirstInstance{false};
+    bool m_supportsMultiDrawIndirect{false};
+    bool m_supportsTextureCompressionBC{false};
+    bool m_supportsPipelineStatistics{false};
+    bool m_supportsInheritedQueries{false};
+    std::uint32_t m_maxBindlessTextures{};
+    PFN_vkCmdDrawIndexedIndirectCountKHR m_cmdDrawIndexedIndirectCount{};
+    PFN_vkWaitForPresentKHR m_waitForPresent{};
     PFN_vkGetPhysicalDeviceMemoryProperties2 m_getPhysicalDeviceMemoryProperties2{};
     PFN_vkGetPhysicalDeviceMemoryProperties2KHR m_getPhysicalDeviceMemoryProperties2KHR{};
     mutable DeviceLocalMemoryBudget m_cachedMemoryBudget{};
@@ -0,0 +1,126 @@
+#pragma once
+#include "../../../Core/Public/Expected.hpp"
+#include "VulkanAllocator.hpp"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+class VulkanDevice;
+
+/// Where one mesh's geometry lives inside a VulkanGeometryArena. Offsets are in elements of the
+/// page's streams, so they feed vkCmdDrawIndexed's vertexOffset and firstIndex directly.
+struct GeometryRange
+{
+    std::uint32_t page{};
+    std::uint32_t firstVertex{};
+    std::uint32_t vertexCount{};
+    std::uint32_t firstIndex{};
+    std::uint32_t indexCount{};
+
+    inline bool is_valid() const noexcept
+    {
+        return vertexCount != 0;
+    }
+};
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Shared device-local geometry for every mesh: pages of three streams (PackedVertex vertices, XMFLOAT3
+/// positions for depth-only passes, uint32 indices) that meshes sub-allocate from, so draws of different
+/// meshes on one page share the same vertex and index buffer bindings. Each stream keeps an
+/// offset-ordered free list; allocation is best-fit and frees coalesce with their neighbours.
+/// Pages are created on demand; a mesh larger than a page gets a page of its own. Main-thread only.
+class NOC_EXPORT VulkanGeometryArena
+{
+  public:
+    static constexpr std::uint32_t DefaultPageVertices{512u * 1024};
+    static constexpr std::uint32_t DefaultPageIndices{2u * 1024 * 1024};
+
+    VulkanGeometryArena() = default;
+    ~VulkanGeometryArena();
+
+    VulkanGeometryArena(const VulkanGeometryArena&) = delete;
+    VulkanGeometryArena& operator=(const VulkanGeometryArena&) = delete;
+
+    /// Records the page size. No memory is allocated until the first allocate().
+    void initialize(VulkanDevice& device, std::uint32_t pageVertices = DefaultPageVertices,
+                    std::uint32_t pageIndices = DefaultPageIndices) noexcept;
+
+    /// Destroys every page. The GPU must be done with all of them.
+    void cleanup() noexcept;
+
+    /// Reserves room for a mesh on the first page with space for both its vertices and indices.
+    Result<GeometryRange> allocate(std::uint32_t vertexCount, std::uint32_t indexCount);
+
+    /// Returns a range to its page. The GPU must be done reading it.
+    void free(const GeometryRange& range) noexcept;
+
+    /// Frees every range and destroys all pages but the first, which stays for the next scene.
+    /// The GPU must be done with all of them.
+    void reset() noexcept;
+
+    inline std::uint32_t get_page_count() const noexcept
+    {
+        return static_cast<std::uint32_t>(m_pages.size());
+    }
+    inline VkBuffer get_vertex_buffer(std::uint32_t page) const noexcept
+    {
+        return page < m_pages.size() ? m_pages[page].vertexBuffer : nullptr;
+    }
+    inline VkBuffer get_position_buffer(std::uint32_t page) const noexcept
+    {
+        return page < m_pages.size() ? m_pages[page].positionBuffer : nullptr;
+    }
+    inline VkBuffer get_index_buffer(std::uint32_t page) const noexcept
+    {
+        return page < m_pages.size() ? m_pages[page].indexBuffer : nullptr;
+    }
+    /// Bytes of the three streams covered by live ranges.
+    inline std::uint64_t get_used_bytes() const noexcept
+    {
+        return m_usedBytes;
+    }
+
+    /// Bytes one vertex takes across the vertex and position streams, and one index.
+    static std::uint64_t bytes_per_vertex() noexcept;
+    static std::uint64_t bytes_per_index() noexcept;
+
+  private:
+    /// Offset-ordered free ranges of one stream, in elements.
+    struct FreeList
+    {
+        std::map<std::uint32_t, std::uint32_t> ranges{}; // offset -> count
+
+        bool allocate(std::uint32_t count, std::uint32_t& outOffset);
+        void release(std::uint32_t offset, std::uint32_t count);
+    };
+
+    struct Page
+    {
+        VkBuffer vertexBuffer{};
+        VulkanAllocation vertexAllocation{};
+        VkBuffer positionBuffer{};
+        VulkanAllocation positionAllocation{};
+        VkBuffer indexBuffer{};
+        VulkanAllocation indexAllocation{};
+        std::uint32_t vertexCapacity{};
+        std::uint32_t indexCapacity{};
+        FreeList freeVertices{};
+        FreeList freeIndices{};
+    };
+
+    Result<> create_page(std::uint32_t vertexCapacity, std::uint32_t indexCapacity);
+    void destroy_page(Page& page) noexcept;
+    static void reset_free_lists(Page& page);
+
+    VulkanDevice* m_device{};
+    std::uint32_t m_pageVertices{DefaultPageVertices};
+    std::uint32_t m_pageIndices{DefaultPageIndices};
+    std::vector<Page> m_pages{};
+    std::uint64_t m_usedBytes{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
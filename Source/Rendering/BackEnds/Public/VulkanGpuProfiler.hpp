@@ -0,0 +1,152 @@
+#pragma once
+#include "../../../Core/Public/Expected.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+class VulkanDevice;
+
+/// Frame passes timed on the GPU, in recording order.
+enum class GpuPass : std::uint8_t
+{
+    Cull,         // GPU frustum-cull compute dispatch
+    Shadow,       // sun shadow cascades re-rendered this frame
+    LightCluster, // clustered light binning compute dispatch
+    Scene,        // offscreen scene render pass
+    DepthPrepass, // depth-only draws at the start of the scene render pass
+    HiZ,          // Hi-Z pyramid build compute dispatch
+    Nis,          // NIS upscale/sharpen compute dispatch
+    Ui,           // swapchain UI render pass (editor)
+    Blit,         // scene-to-swapchain blit (standalone game)
+    Count,
+};
+
+inline constexpr std::size_t GpuPassCount{static_cast<std::size_t>(GpuPass::Count)};
+
+/// Rolling GPU time of one pass (or the whole frame) over the profiler's history window.
+struct GpuTimingStats
+{
+    float lastMs{};
+    float averageMs{};
+    float minMs{};
+    float maxMs{};
+    std::uint32_t sampleCount{}; // samples in the window; 0 = pass has not run recently
+};
+
+/// Pipeline statistics of the last completed scene pass.
+struct GpuPipelineStatistics
+{
+    std::uint64_t vertexShaderInvocations{};
+    std::uint64_t clippingPrimitives{};
+    std::uint64_t fragmentShaderInvocations{};
+    bool valid{false};
+};
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Times frame passes with timestamp queries, one query pool per frame in flight, and optionally
+/// counts scene-pass shader invocations with a pipeline statistics query.
+/// Results are read back without stalling when a frame slot comes around again (after its fence),
+/// so timings lag the CPU by the number of frames in flight. Render-thread only, except that passes
+/// may be bracketed inside secondary command buffers recorded while the render thread waits on them.
+class NOC_EXPORT VulkanGpuProfiler
+{
+  public:
+    static constexpr std::size_t HistoryLength{120};
+
+    VulkanGpuProfiler() = default;
+    ~VulkanGpuProfiler();
+
+    VulkanGpuProfiler(const VulkanGpuProfiler&) = delete;
+    VulkanGpuProfiler& operator=(const VulkanGpuProfiler&) = delete;
+
+    /// Creates the query pools. Succeeds without timing (is_supported() false) when the graphics
+    /// queue cannot write timestamps.
+    Result<> initialize(VulkanDevice& device, std::uint32_t framesInFlight);
+    void cleanup() noexcept;
+
+    /// Collects what was last recorded for `frameIndex` and resets its queries. Call right after
+    /// vkBeginCommandBuffer, outside any render pass, once that slot's fence has signalled.
+    void begin_frame(VkCommandBuffer commandBuffer, std::uint32_t frameIndex) noexcept;
+
+    /// Brackets one pass. Begin/end must be recorded outside render passes or around a whole one.
+    void begin_pass(VkCommandBuffer commandBuffer, GpuPass pass) noexcept;
+    void end_pass(VkCommandBuffer commandBuffer, GpuPass pass) noexcept;
+
+    /// Brackets the scene render pass with the pipeline statistics query, when supported.
+    void begin_statistics(VkCommandBuffer commandBuffer) noexcept;
+    void end_statistics(VkCommandBuffer commandBuffer) noexcept;
+
+    /// Statistics counted by the scene-pass query (0 when unsupported). Secondary command buffers
+    /// executed while it is active must inherit them.
+    VkQueryPipelineStatisticFlags get_statistics_flags() const noexcept;
+
+    inline bool is_supported() const noexcept
+    {
+        return !m_frames.empty();
+    }
+    inline bool has_pipeline_statistics() const noexcept
+    {
+        return m_statisticsSupported;
+    }
+    inline const GpuTimingStats& get_pass_timing(GpuPass pass) const noexcept
+    {
+        return m_passHistory[static_cast<std::size_t>(pass)].stats;
+    }
+    /// First timestamp to last timestamp of the frame: includes gaps between passes.
+    inline const GpuTimingStats& get_frame_timing() const noexcept
+    {
+        return m_frameHistory.stats;
+    }
+    /// Frame timings collected since initialize(); changes whenever get_frame_timing() gets a new sample.
+    inline std::uint64_t get_frame_samples_collected() const noexcept
+    {
+        return m_frameSamplesCollected;
+    }
+    inline const GpuPipelineStatistics& get_pipeline_statistics() const noexcept
+    {
+        return m_statistics;
+    }
+
+    static const char* get_pass_name(GpuPass pass) noexcept;
+
+  private:
+    struct FrameQueries
+    {
+        VkQueryPool timestampPool{};
+        VkQueryPool statisticsPool{};
+        std::uint32_t writtenPasses{}; // bit per GpuPass with both timestamps recorded
+        bool statisticsWritten{false};
+    };
+
+    struct TimingHistory
+    {
+        std::array<float, HistoryLength> samples{};
+        std::size_t next{};
+        std::size_t count{};
+        GpuTimingStats stats{};
+
+        void push(float milliseconds) noexcept;
+        void clear() noexcept;
+    };
+
+    void collect(FrameQueries& frame) noexcept;
+
+    VulkanDevice* m_device{};
+    std::vector<FrameQueries> m_frames{};
+    FrameQueries* m_recording{};
+    double m_timestampPeriodNs{};
+    std::uint64_t m_timestampMask{};
+    bool m_statisticsSupported{false};
+
+    std::array<TimingHistory, GpuPassCount> m_passHistory{};
+    TimingHistory m_frameHistory{};
+    std::uint64_t m_frameSamplesCollected{};
+    GpuPipelineStatistics m_statistics{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
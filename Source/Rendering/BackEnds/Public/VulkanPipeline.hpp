@@ -2,23 +2,57 @@
 #include "../../../Core/Public/Expected.hpp"
 #include "VulkanDevice.hpp"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <filesystem>
+#include <mutex>
 #include <vector>
 
 #include <vulkan/vulkan.h>
 
 NOC_SUPPRESS_DLL_WARNINGS
 
-/// Bundles all multisampling pipeline options into one POD.
+/// Bundles all multisampling pipeline options, plus the depth mode of the scene pass, into one POD.
 struct MultisampleConfig
 {
     VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
     bool alphaToCoverage{false};
     bool sampleShading{false};
     float minSampleShading{0.25f};
+    bool depthPrepass{false}; // depth was laid down by a prepass: test EQUAL, no depth writes
+
+    /// True when both configs compile to the same pipeline; the minimum fraction only matters
+    /// while sample shading is on.
+    bool same_pipeline_state(const MultisampleConfig& other) const noexcept
+    {
+        return samples == other.samples && alphaToCoverage == other.alphaToCoverage &&
+               sampleShading == other.sampleShading && (!sampleShading || minSampleShading == other.minSampleShading) &&
+               depthPrepass == other.depthPrepass;
+    }
+};
+
+/// A pipeline variant to compile ahead of use. `renderPass` only has to be compatible with the
+/// pass the variant is later bound in (same attachment formats and sample counts).
+struct PipelineVariantRequest
+{
+    VkRenderPass renderPass{};
+    MultisampleConfig config{};
+};
+
+/// Shader modules with the pipelines built from them, outside the live pipeline object: either
+/// built ahead of a swap_shader_set() or retired by one and waiting for the GPU to finish with it.
+struct PipelineShaderSet
+{
+    VkShaderModule vertModule{};
+    VkShaderModule fragModule{};
+    MultisampleConfig config{};      // config of pipelines.front() when built by build_shader_set()
+    std::vector<VkPipeline> pipelines{};
 };
 
 /// Owns the Vulkan graphics pipeline and pipeline layout.
+/// One pipeline is kept per multisample variant so settings changes swap pipelines instead of
+/// compiling them. The pipeline cache is loaded from and saved to disk when a cache directory is set.
 class NOC_EXPORT VulkanPipeline
 {
   public:
@@ -41,10 +75,74 @@ class NOC_EXPORT VulkanPipeline
         const std::vector<std::uint32_t>& fragSpirv
     );
 
-    /// Destroys pipeline and pipeline layout.
+    /// Makes the variant for `msConfig` current. Prebuilt variants are a pointer swap; a missing
+    /// one is compiled on the spot against `renderPass`. Requires a successful initialize().
+    Result<> select_variant(VkRenderPass renderPass, const MultisampleConfig& msConfig);
+
+    /// Compiles the requested variants on a background job, cancelling any batch still running.
+    /// Takes ownership of every request's render pass and destroys it once compiled. Variants that
+    /// already exist are skipped.
+    void prewarm_variants(std::vector<PipelineVariantRequest> requests);
+
+    /// Compiles new shader modules and the pipeline for `msConfig` against the existing layout and
+    /// pipeline cache without touching the live pipeline. Safe to call from a worker thread while
+    /// the render thread keeps drawing. Requires a successful initialize().
+    Result<PipelineShaderSet> build_shader_set(
+        VkRenderPass renderPass,
+        const MultisampleConfig& msConfig,
+        const std::vector<std::uint32_t>& vertSpirv,
+        const std::vector<std::uint32_t>& fragSpirv
+    ) const noexcept;
+
+    /// Makes a built set live: its pipeline becomes the current and only variant. Returns the
+    /// previous modules and every previous variant; the caller destroys them with
+    /// destroy_shader_set() once no in-flight frame references them. Cancels running prewarm.
+    PipelineShaderSet swap_shader_set(PipelineShaderSet&& shaderSet) noexcept;
+
+    void destroy_shader_set(PipelineShaderSet& shaderSet) const noexcept;
+
+    /// Compiles the depth-only prepass pipeline: a position-only vertex shader, no fragment stage,
+    /// no color writes. Shares the live pipeline layout so bound descriptor sets and push constants
+    /// carry over to the color pass. The caller owns and destroys the returned pipeline.
+    /// Requires a successful initialize().
+    Result<VkPipeline> create_depth_prepass_pipeline(
+        VkRenderPass renderPass,
+        VkSampleCountFlagBits samples,
+        const std::vector<std::uint32_t>& vertSpirv
+    ) const noexcept;
+
+    /// Compiles the shadow caster pipeline from the same depth-only vertex shader: single-sampled,
+    /// no culling, no color attachment and a dynamic depth bias set per cascade. Shares the live
+    /// pipeline layout; the caller owns and destroys the returned pipeline.
+    Result<VkPipeline> create_shadow_pipeline(
+        VkRenderPass renderPass,
+        const std::vector<std::uint32_t>& vertSpirv
+    ) const noexcept;
+
+    /// Compiles a debug overlay pipeline: screen-space line quads with the unit shape corners
+    /// (DebugShapeVertex) at binding 0 and per-instance DebugDrawInstance attributes at binding 1,
+    /// alpha blended, no depth writes. With `depthTest` the lines are hidden behind scene geometry.
+    /// Shares the live pipeline layout for its view-projection and viewport push constants; the
+    /// caller owns and destroys the returned pipeline.
+    Result<VkPipeline> create_debug_line_pipeline(
+        VkRenderPass renderPass,
+        VkSampleCountFlagBits samples,
+        const std::vector<std::uint32_t>& vertSpirv,
+        const std::vector<std::uint32_t>& fragSpirv,
+        bool depthTest
+    ) const noexcept;
+
+    /// Directory the pipeline cache file lives in. Must be set before the first initialize();
+    /// an empty path keeps the cache in memory only.
+    void set_cache_directory(std::filesystem::path directory);
+
+    /// Writes the pipeline cache to the cache directory. Called by release_cache().
+    Result<> save_cache() const;
+
+    /// Stops background compiles and destroys every variant, the shader modules and the pipeline layout.
     void cleanup() noexcept;
 
-    /// Destroys the long-lived pipeline cache object.
+    /// Saves and destroys the long-lived pipeline cache and the bindless material set layout.
     void release_cache() noexcept;
 
     // --- Getters ---
@@ -56,21 +154,65 @@ class NOC_EXPORT VulkanPipeline
     {
         return m_pipelineLayout;
     }
+    /// Layout of set 0 (bindless texture array + material records). Survives cleanup().
     inline VkDescriptorSetLayout get_descriptor_set_layout() const noexcept
     {
         return m_descriptorSetLayout;
     }
+    /// Layout of set 1 (per-frame instance storage buffer read by the vertex shader).
+    inline VkDescriptorSetLayout get_instance_descriptor_set_layout() const noexcept
+    {
+        return m_instanceDescriptorSetLayout;
+    }
+    /// Layout of set 2 (lights, cluster light lists and lighting parameters for fragment + compute;
+    /// shadow cascades for fragment).
+    inline VkDescriptorSetLayout get_light_descriptor_set_layout() const noexcept
+    {
+        return m_lightDescriptorSetLayout;
+    }
 
   private:
-    Result<VkShaderModule> create_shader_module(const std::vector<std::uint32_t>& spirv) noexcept;
+    struct Variant
+    {
+        MultisampleConfig config{};
+        VkPipeline pipeline{};
+    };
+
+    Result<VkShaderModule> create_shader_module(const std::vector<std::uint32_t>& spirv) const noexcept;
+    Result<VkPipeline> create_variant(VkRenderPass renderPass, const MultisampleConfig& msConfig) const noexcept;
+    Result<VkPipeline> create_variant(VkRenderPass renderPass, const MultisampleConfig& msConfig,
+                                      VkShaderModule vertModule, VkShaderModule fragModule) const noexcept;
+    /// Shared body of the depth prepass and shadow caster pipelines.
+    Result<VkPipeline> create_depth_only_pipeline(VkRenderPass renderPass, VkSampleCountFlagBits samples,
+                                                  const std::vector<std::uint32_t>& vertSpirv,
+                                                  bool shadowCaster) const noexcept;
+    Result<> create_pipeline_cache();
+    std::filesystem::path cache_file_path() const;
+
+    /// Returns the stored pipeline for `config`, storing `pipeline` first if none exists yet.
+    /// A duplicate compiled concurrently is destroyed.
+    VkPipeline store_variant(const MultisampleConfig& config, VkPipeline pipeline) noexcept;
+    VkPipeline find_variant(const MultisampleConfig& config) const noexcept;
+    void wait_for_prewarm() noexcept;
 
     // --- Members ---
     VulkanDevice& m_device;
 
     VkPipeline m_graphicsPipeline{};
+    VkShaderModule m_vertShaderModule{};
+    VkShaderModule m_fragShaderModule{};
     VkPipelineLayout m_pipelineLayout{};
     VkDescriptorSetLayout m_descriptorSetLayout{};
+    VkDescriptorSetLayout m_instanceDescriptorSetLayout{};
+    VkDescriptorSetLayout m_lightDescriptorSetLayout{};
     VkPipelineCache m_pipelineCache{};
+    std::filesystem::path m_cacheDirectory{};
+
+    std::vector<Variant> m_variants{};
+    mutable std::mutex m_variantMutex;
+    std::condition_variable m_prewarmIdle;
+    bool m_prewarmRunning{false};
+    std::atomic<bool> m_prewarmCancelled{false};
 };
 
 NOC_RESTORE_DLL_WARNINGS
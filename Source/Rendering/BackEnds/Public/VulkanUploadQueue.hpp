@@ -0,0 +1,120 @@
+#pragma once
+#include "../../../Core/Public/Expected.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+class VulkanDevice;
+
+/// Staging range reserved for one upload. The caller writes source bytes through `mapped`
+/// and records its copy commands into `commandBuffer` before reserving again.
+struct UploadStagingSpan
+{
+    VkCommandBuffer commandBuffer{};
+    VkBuffer buffer{};
+    VkDeviceSize offset{};
+    void* mapped{};
+};
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Batches asset uploads into command buffers submitted to the device's transfer queue
+/// (a dedicated transfer family when one exists, the graphics queue otherwise).
+/// Source data goes through a persistently mapped staging ring; ring space is reclaimed as
+/// batch fences signal, so the CPU only blocks when the ring is full or a caller waits on a
+/// ticket. Tickets increase monotonically, one per submitted batch. Main-thread only.
+class NOC_EXPORT VulkanUploadQueue
+{
+  public:
+    static constexpr VkDeviceSize DefaultRingCapacity{32ull * 1024 * 1024};
+
+    VulkanUploadQueue() = default;
+    ~VulkanUploadQueue();
+
+    VulkanUploadQueue(const VulkanUploadQueue&) = delete;
+    VulkanUploadQueue& operator=(const VulkanUploadQueue&) = delete;
+
+    Result<> initialize(VulkanDevice& device, VkDeviceSize ringCapacity = DefaultRingCapacity);
+
+    /// Waits for every submitted batch, then destroys the ring, fences and command pool.
+    void cleanup() noexcept;
+
+    /// Reserves `size` bytes of staging memory in the batch being recorded, starting one if needed.
+    /// May submit that batch and wait on older ones when the ring is full; grows the ring when
+    /// a single request exceeds its capacity.
+    Result<UploadStagingSpan> reserve(VkDeviceSize size, VkDeviceSize alignment = 16);
+
+    /// Submits the batch being recorded. Returns its ticket, or the last submitted ticket when
+    /// nothing was recorded since the previous flush.
+    Result<std::uint64_t> flush();
+
+    /// Blocks until the batch with `ticket` (and every earlier one) has completed.
+    /// Flushes first when the ticket belongs to the batch still being recorded.
+    Result<> wait(std::uint64_t ticket);
+
+    /// Flushes and waits for everything queued so far.
+    Result<> wait_idle();
+
+    /// Non-blocking completion check; retires finished batches as a side effect.
+    bool is_complete(std::uint64_t ticket) noexcept;
+
+    /// True while an unsubmitted batch or any in-flight batch exists.
+    inline bool has_pending_work() const noexcept
+    {
+        return m_recording.commandBuffer != nullptr || !m_inFlight.empty();
+    }
+    inline std::uint64_t get_last_submitted_ticket() const noexcept
+    {
+        return m_lastSubmittedTicket;
+    }
+    inline std::uint64_t get_staging_memory_bytes() const noexcept
+    {
+        return m_ringAllocationBytes;
+    }
+    inline std::uint32_t get_in_flight_batch_count() const noexcept
+    {
+        return static_cast<std::uint32_t>(m_inFlight.size());
+    }
+
+  private:
+    struct Batch
+    {
+        VkCommandBuffer commandBuffer{};
+        VkFence fence{};
+        std::uint64_t ticket{};
+        VkDeviceSize ringStart{}; // ring head before the batch's first reservation
+        VkDeviceSize ringBytes{}; // ring bytes (including wrap padding) released when the batch retires
+    };
+
+    Result<> create_ring(VkDeviceSize capacity);
+    void destroy_ring() noexcept;
+    Result<> begin_batch();
+    bool try_reserve_ring(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& outOffset) noexcept;
+    Result<> wait_oldest();
+    void retire_completed() noexcept;
+    void retire_oldest() noexcept;
+    void release_unsubmitted(Batch& batch) noexcept;
+
+    VulkanDevice* m_device{};
+    VkCommandPool m_commandPool{};
+
+    VkBuffer m_ringBuffer{};
+    VkDeviceMemory m_ringMemory{};
+    void* m_ringMapped{};
+    VkDeviceSize m_ringCapacity{};
+    VkDeviceSize m_ringHead{};
+    VkDeviceSize m_ringUsed{};
+    std::uint64_t m_ringAllocationBytes{};
+
+    Batch m_recording{};
+    std::deque<Batch> m_inFlight{};
+    std::vector<Batch> m_freeBatches{};
+    std::uint64_t m_nextTicket{1};
+    std::uint64_t m_lastSubmittedTicket{};
+    std::uint64_t m_completedTicket{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
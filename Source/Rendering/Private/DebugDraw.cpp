@@ -0,0 +1,188 @@
+#include "../Public/DebugDraw.hpp"
+
+#include <cmath>
+#include <utility>
+
+using namespace DirectX;
+
+namespace
+{
+constexpr std::uint32_t CircleSegments{24};
+
+/// Appends a circle arc as line segments. `axis` is the circle's normal (0 = X, 1 = Y, 2 = Z); the arc
+/// runs from `startAngle` over `sweep` radians.
+void append_arc(std::vector<XMFLOAT4>& vertices, int axis, float offsetY, float capSide, float startAngle, float sweep,
+                std::uint32_t segments)
+{
+    const auto point = [&](std::uint32_t i) {
+        const float t = startAngle + sweep * static_cast<float>(i) / static_cast<float>(segments);
+        const float c = std::cos(t);
+        const float s = std::sin(t);
+        if (axis == 0)
+            return XMFLOAT4{0.0f, c + offsetY, s, capSide};
+        if (axis == 1)
+            return XMFLOAT4{c, offsetY, s, capSide};
+        return XMFLOAT4{c, s + offsetY, 0.0f, capSide};
+    };
+    for (std::uint32_t i = 0; i < segments; ++i)
+    {
+        vertices.push_back(point(i));
+        vertices.push_back(point(i + 1));
+    }
+}
+
+/// Expands line-list `segments` into the six quad corners per segment debug.vert widens. Corners on
+/// the second end see the direction reversed, so their side is flipped to stay on the same edge.
+void append_quads(std::vector<DebugShapeVertex>& vertices, const std::vector<XMFLOAT4>& segments)
+{
+    for (std::size_t i = 0; i + 1 < segments.size(); i += 2)
+    {
+        const XMFLOAT4& a = segments[i];
+        const XMFLOAT4& b = segments[i + 1];
+        const DebugShapeVertex aLeft{a, b, 1.0f};
+        const DebugShapeVertex aRight{a, b, -1.0f};
+        const DebugShapeVertex bLeft{b, a, -1.0f};
+        const DebugShapeVertex bRight{b, a, 1.0f};
+        vertices.insert(vertices.end(), {aLeft, aRight, bLeft, bLeft, aRight, bRight});
+    }
+}
+
+/// The four vertical lines on the unit circle around Y.
+void append_verticals(std::vector<XMFLOAT4>& vertices, float bottomY, float topY, float bottomSide, float topSide)
+{
+    constexpr std::array<XMFLOAT2, 4> points{XMFLOAT2{1.0f, 0.0f}, XMFLOAT2{-1.0f, 0.0f}, XMFLOAT2{0.0f, 1.0f},
+                                             XMFLOAT2{0.0f, -1.0f}};
+    for (const XMFLOAT2& p : points)
+    {
+        vertices.push_back(XMFLOAT4{p.x, bottomY, p.y, bottomSide});
+        vertices.push_back(XMFLOAT4{p.x, topY, p.y, topSide});
+    }
+}
+} // namespace
+
+DebugShapeMesh DebugShapeMesh::build()
+{
+    DebugShapeMesh mesh{};
+    // Each shape is written as a line list first, then expanded into quads.
+    std::vector<XMFLOAT4> vertices{};
+    const auto begin_shape = [&](DebugShape) { vertices.clear(); };
+    const auto end_shape = [&](DebugShape shape) {
+        const auto index = static_cast<std::size_t>(shape);
+        mesh.firstVertex[index] = static_cast<std::uint32_t>(mesh.vertices.size());
+        append_quads(mesh.vertices, vertices);
+        mesh.vertexCount[index] = static_cast<std::uint32_t>(mesh.vertices.size()) - mesh.firstVertex[index];
+    };
+
+    begin_shape(DebugShape::Line);
+    vertices.push_back(XMFLOAT4{0.0f, 0.0f, 0.0f, 0.0f});
+    vertices.push_back(XMFLOAT4{1.0f, 0.0f, 0.0f, 0.0f});
+    end_shape(DebugShape::Line);
+
+    begin_shape(DebugShape::Box);
+    constexpr std::array<XMFLOAT4, 8> corners{
+        XMFLOAT4{-1, -1, -1, 0}, XMFLOAT4{1, -1, -1, 0}, XMFLOAT4{1, 1, -1, 0}, XMFLOAT4{-1, 1, -1, 0},
+        XMFLOAT4{-1, -1, 1, 0},  XMFLOAT4{1, -1, 1, 0},  XMFLOAT4{1, 1, 1, 0},  XMFLOAT4{-1, 1, 1, 0},
+    };
+    constexpr std::array<std::pair<int, int>, 12> edges{
+        std::pair<int, int>{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6},
+        {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7},
+    };
+    for (const auto& [a, b] : edges)
+    {
+        vertices.push_back(corners[a]);
+        vertices.push_back(corners[b]);
+    }
+    end_shape(DebugShape::Box);
+
+    begin_shape(DebugShape::Sphere);
+    for (int axis = 0; axis < 3; ++axis)
+        append_arc(vertices, axis, 0.0f, 0.0f, 0.0f, XM_2PI, CircleSegments);
+    end_shape(DebugShape::Sphere);
+
+    // Rings and verticals at y = 0 on either cap side, so only the half height moves them apart;
+    // the hemispheres keep the radius whatever the cylinder's length.
+    begin_shape(DebugShape::Capsule);
+    append_arc(vertices, 1, 0.0f, 1.0f, 0.0f, XM_2PI, CircleSegments);
+    append_arc(vertices, 1, 0.0f, -1.0f, 0.0f, XM_2PI, CircleSegments);
+    append_verticals(vertices, 0.0f, 0.0f, -1.0f, 1.0f);
+    append_arc(vertices, 0, 0.0f, 1.0f, -XM_PIDIV2, XM_PI, CircleSegments / 2); // y >= 0 halves on top
+    append_arc(vertices, 2, 0.0f, 1.0f, 0.0f, XM_PI, CircleSegments / 2);
+    append_arc(vertices, 0, 0.0f, -1.0f, XM_PIDIV2, XM_PI, CircleSegments / 2); // y <= 0 halves below
+    append_arc(vertices, 2, 0.0f, -1.0f, XM_PI, XM_PI, CircleSegments / 2);
+    end_shape(DebugShape::Capsule);
+
+    begin_shape(DebugShape::Cylinder);
+    append_arc(vertices, 1, 1.0f, 0.0f, 0.0f, XM_2PI, CircleSegments);
+    append_arc(vertices, 1, -1.0f, 0.0f, 0.0f, XM_2PI, CircleSegments);
+    append_verticals(vertices, -1.0f, 1.0f, 0.0f, 0.0f);
+    end_shape(DebugShape::Cylinder);
+
+    return mesh;
+}
+
+//    DebugDrawList
+
+void DebugDrawList::add_line(const XMFLOAT3& from, const XMFLOAT3& to, std::uint32_t color, bool depthTest,
+                             float width)
+{
+    // The unit line runs along +X, so X maps onto the segment and the other axes collapse.
+    const XMMATRIX world{
+        XMVectorSet(to.x - from.x, to.y - from.y, to.z - from.z, 0.0f),
+        XMVectorZero(),
+        XMVectorZero(),
+        XMVectorSet(from.x, from.y, from.z, 1.0f),
+    };
+    add(DebugShape::Line, world, XMFLOAT4{1.0f, 1.0f, 1.0f, 0.0f}, color, depthTest, width);
+}
+
+void DebugDrawList::add_box(FXMMATRIX world, const XMFLOAT3& halfExtents, std::uint32_t color, bool depthTest,
+                            float width)
+{
+    add(DebugShape::Box, world, XMFLOAT4{halfExtents.x, halfExtents.y, halfExtents.z, 0.0f}, color, depthTest, width);
+}
+
+void DebugDrawList::add_sphere(FXMMATRIX world, float radius, std::uint32_t color, bool depthTest, float width)
+{
+    add(DebugShape::Sphere, world, XMFLOAT4{radius, radius, radius, 0.0f}, color, depthTest, width);
+}
+
+void DebugDrawList::add_capsule(FXMMATRIX world, float radius, float halfHeight, std::uint32_t color, bool depthTest,
+                                float width)
+{
+    add(DebugShape::Capsule, world, XMFLOAT4{radius, radius, radius, halfHeight}, color, depthTest, width);
+}
+
+void DebugDrawList::add_cylinder(FXMMATRIX world, float radius, float halfHeight, std::uint32_t color, bool depthTest,
+                                 float width)
+{
+    add(DebugShape::Cylinder, world, XMFLOAT4{radius, halfHeight, radius, 0.0f}, color, depthTest, width);
+}
+
+void DebugDrawList::clear() noexcept
+{
+    for (std::vector<DebugDrawInstance>& bucket : m_buckets)
+        bucket.clear();
+}
+
+bool DebugDrawList::empty() const noexcept
+{
+    return size() == 0;
+}
+
+std::size_t DebugDrawList::size() const noexcept
+{
+    std::size_t count{};
+    for (const std::vector<DebugDrawInstance>& bucket : m_buckets)
+        count += bucket.size();
+    return count;
+}
+
+void DebugDrawList::add(DebugShape shape, FXMMATRIX world, const XMFLOAT4& extent, std::uint32_t color, bool depthTest,
+                        float width)
+{
+    DebugDrawInstance& instance = m_buckets[bucket_index(shape, depthTest)].emplace_back();
+    XMStoreFloat3x4(&instance.model, world);
+    instance.extent = extent;
+    instance.color = color;
+    instance.width = width;
+}
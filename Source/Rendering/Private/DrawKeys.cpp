@@ -0,0 +1,129 @@
+#include "../Public/DrawKeys.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+std::uint32_t DrawKey::depth_bucket(float viewDistance) noexcept
+{
+    if (!(viewDistance > 0.0f))
+        return 0;
+    const float bucket = std::log2(1.0f + viewDistance) * 8.0f;
+    return static_cast<std::uint32_t>(std::min(bucket, static_cast<float>(field_mask(DepthBits))));
+}
+
+void DrawKeySorter::clear() noexcept
+{
+    m_keys.clear();
+    m_order.clear();
+    m_sorted.clear();
+    m_lastChangedCount = 0;
+    m_lastSortFull = true;
+}
+
+void DrawKeySorter::sort(std::span<const std::uint64_t> keys, bool incremental)
+{
+    const std::size_t count = keys.size();
+    const auto lessEntry = [](const Entry& lhs, const Entry& rhs) {
+        return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.index < rhs.index);
+    };
+
+    if (incremental && count == m_keys.size() && count == m_sorted.size())
+    {
+        m_changed.clear();
+        m_changedMask.assign(count, 0);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (keys[i] == m_keys[i])
+                continue;
+            m_changed.push_back(Entry{keys[i], static_cast<std::uint32_t>(i)});
+            m_changedMask[i] = 1;
+        }
+
+        if (m_changed.empty())
+        {
+            m_lastChangedCount = 0;
+            m_lastSortFull = false;
+            return;
+        }
+
+        if (m_changed.size() * IncrementalDivisor <= count)
+        {
+            // Unchanged entries keep their relative order; the few moved ones are merged back in.
+            std::sort(m_changed.begin(), m_changed.end(), lessEntry);
+            m_scratch.clear();
+            m_scratch.reserve(count - m_changed.size());
+            for (const Entry& entry : m_sorted)
+            {
+                if (m_changedMask[entry.index] == 0)
+                    m_scratch.push_back(entry);
+            }
+
+            m_sorted.resize(count);
+            std::merge(m_scratch.begin(), m_scratch.end(), m_changed.begin(), m_changed.end(), m_sorted.begin(),
+                       lessEntry);
+            for (const Entry& entry : m_changed)
+                m_keys[entry.index] = entry.key;
+
+            store_order(m_sorted);
+            m_lastChangedCount = static_cast<std::uint32_t>(m_changed.size());
+            m_lastSortFull = false;
+            return;
+        }
+    }
+
+    m_keys.assign(keys.begin(), keys.end());
+    m_sorted.resize(count);
+    for (std::size_t i = 0; i < count; ++i)
+        m_sorted[i] = Entry{keys[i], static_cast<std::uint32_t>(i)};
+
+    radix_sort(m_sorted);
+    store_order(m_sorted);
+    m_lastChangedCount = static_cast<std::uint32_t>(count);
+    m_lastSortFull = true;
+}
+
+void DrawKeySorter::radix_sort(std::vector<Entry>& entries)
+{
+    // One histogram per key byte, gathered in a single pass.
+    std::array<std::array<std::uint32_t, 256>, 8> histograms{};
+    for (const Entry& entry : entries)
+    {
+        for (std::uint32_t byte = 0; byte < 8; ++byte)
+            ++histograms[byte][(entry.key >> (byte * 8)) & 0xFF];
+    }
+
+    m_scratch.resize(entries.size());
+    std::vector<Entry>* source = &entries;
+    std::vector<Entry>* destination = &m_scratch;
+    for (std::uint32_t byte = 0; byte < 8; ++byte)
+    {
+        auto& histogram = histograms[byte];
+        // Every key shares this byte: the pass would be an identity permutation.
+        if (std::ranges::find(histogram, static_cast<std::uint32_t>(entries.size())) != histogram.end())
+            continue;
+
+        std::uint32_t offset = 0;
+        for (std::uint32_t& bucket : histogram)
+        {
+            const std::uint32_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+
+        const std::uint32_t shift = byte * 8;
+        for (const Entry& entry : *source)
+            (*destination)[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+        std::swap(source, destination);
+    }
+
+    if (source != &entries)
+        entries.swap(m_scratch);
+}
+
+void DrawKeySorter::store_order(const std::vector<Entry>& entries)
+{
+    m_order.resize(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i)
+        m_order[i] = entries[i].index;
+}
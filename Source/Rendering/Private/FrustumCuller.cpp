@@ -0,0 +1,326 @@
+#include "../Public/FrustumCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <taskflow/taskflow.hpp>
+
+using namespace DirectX;
+
+FrustumPlanes FrustumPlanes::from_view_projection(const XMFLOAT4X4& m) noexcept
+{
+    // Row-vector convention: clip = p * M, so the clip components are the columns of M.
+    const XMFLOAT4 col0{m._11, m._21, m._31, m._41};
+    const XMFLOAT4 col1{m._12, m._22, m._32, m._42};
+    const XMFLOAT4 col2{m._13, m._23, m._33, m._43};
+    const XMFLOAT4 col3{m._14, m._24, m._34, m._44};
+
+    const auto add = [](const XMFLOAT4& a, const XMFLOAT4& b) { return XMFLOAT4{a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; };
+    const auto sub = [](const XMFLOAT4& a, const XMFLOAT4& b) { return XMFLOAT4{a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; };
+
+    FrustumPlanes frustum{};
+    frustum.planes = {
+        add(col3, col0), // left
+        sub(col3, col0), // right
+        add(col3, col1), // bottom (top under a Vulkan Y flip; the set is symmetric)
+        sub(col3, col1), // top
+        col2,            // near (depth 0..1)
+        sub(col3, col2), // far
+    };
+    for (XMFLOAT4& plane : frustum.planes)
+    {
+        const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f)
+        {
+            plane.x /= length;
+            plane.y /= length;
+            plane.z /= length;
+            plane.w /= length;
+        }
+    }
+    return frustum;
+}
+
+void FrustumCuller::SphereLanes::clear() noexcept
+{
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+    item.clear();
+}
+
+void FrustumCuller::SphereLanes::push(const XMFLOAT4& sphere, std::uint32_t itemIndex)
+{
+    x.push_back(sphere.x);
+    y.push_back(sphere.y);
+    z.push_back(sphere.z);
+    radius.push_back(sphere.w);
+    item.push_back(itemIndex);
+}
+
+void FrustumCuller::SphereLanes::pad_to_lane()
+{
+    // A negative infinite radius fails every plane test.
+    while (item.size() % 4 != 0)
+        push(XMFLOAT4{0.0f, 0.0f, 0.0f, -std::numeric_limits<float>::infinity()}, InvalidItem);
+}
+
+void FrustumCuller::clear() noexcept
+{
+    m_dynamic.clear();
+    m_static.clear();
+    m_staticSource.clear();
+    m_nodes.clear();
+    m_itemCount = 0;
+    m_treeRebuilt = false;
+}
+
+void FrustumCuller::set_spheres(std::span<const XMFLOAT4> spheres, std::span<const std::uint8_t> staticFlags)
+{
+    m_itemCount = spheres.size();
+    m_dynamic.clear();
+    m_staticScratch.clear();
+    for (std::size_t i = 0; i < spheres.size(); ++i)
+    {
+        const std::uint32_t item = static_cast<std::uint32_t>(i);
+        if (i < staticFlags.size() && staticFlags[i] != 0)
+            m_staticScratch.push_back(StaticSphere{spheres[i], item});
+        else
+            m_dynamic.push(spheres[i], item);
+    }
+    m_dynamic.pad_to_lane();
+
+    // Static geometry rarely changes; keep the tree unless its inputs actually did.
+    m_treeRebuilt = m_staticScratch.size() != m_staticSource.size() ||
+                    (!m_staticScratch.empty() &&
+                     std::memcmp(m_staticScratch.data(), m_staticSource.data(),
+                                 sizeof(StaticSphere) * m_staticScratch.size()) != 0);
+    if (!m_treeRebuilt)
+        return;
+
+    std::swap(m_staticSource, m_staticScratch);
+    build_tree();
+}
+
+void FrustumCuller::build_tree()
+{
+    m_nodes.clear();
+    m_static.clear();
+    if (m_staticSource.empty())
+        return;
+
+    m_buildOrder.resize(m_staticSource.size());
+    for (std::uint32_t i = 0; i < m_buildOrder.size(); ++i)
+        m_buildOrder[i] = i;
+    m_nodes.reserve(2 * (m_staticSource.size() / LeafSize + 1));
+    build_node(0, static_cast<std::uint32_t>(m_buildOrder.size()));
+}
+
+std::uint32_t FrustumCuller::build_node(std::uint32_t first, std::uint32_t count)
+{
+    const std::uint32_t nodeIndex = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    XMFLOAT3 boundsMin{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    XMFLOAT3 boundsMax{-boundsMin.x, -boundsMin.y, -boundsMin.z};
+    XMFLOAT3 centerMin{boundsMin};
+    XMFLOAT3 centerMax{boundsMax};
+    for (std::uint32_t i = first; i < first + count; ++i)
+    {
+        const XMFLOAT4& s = m_staticSource[m_buildOrder[i]].sphere;
+        boundsMin = {std::min(boundsMin.x, s.x - s.w), std::min(boundsMin.y, s.y - s.w), std::min(boundsMin.z, s.z - s.w)};
+        boundsMax = {std::max(boundsMax.x, s.x + s.w), std::max(boundsMax.y, s.y + s.w), std::max(boundsMax.z, s.z + s.w)};
+        centerMin = {std::min(centerMin.x, s.x), std::min(centerMin.y, s.y), std::min(centerMin.z, s.z)};
+        centerMax = {std::max(centerMax.x, s.x), std::max(centerMax.y, s.y), std::max(centerMax.z, s.z)};
+    }
+
+    if (count <= LeafSize)
+    {
+        TreeNode& leaf = m_nodes[nodeIndex];
+        leaf.boundsMin = boundsMin;
+        leaf.boundsMax = boundsMax;
+        leaf.firstLane = static_cast<std::uint32_t>(m_static.size());
+        for (std::uint32_t i = first; i < first + count; ++i)
+        {
+            const StaticSphere& source = m_staticSource[m_buildOrder[i]];
+            m_static.push(source.sphere, source.item);
+        }
+        m_static.pad_to_lane();
+        leaf.laneCount = static_cast<std::uint32_t>(m_static.size()) - leaf.firstLane;
+        return nodeIndex;
+    }
+
+    // Median split of the centers along the widest axis.
+    const float extent[3] = {centerMax.x - centerMin.x, centerMax.y - centerMin.y, centerMax.z - centerMin.z};
+    const int axis = extent[0] >= extent[1] && extent[0] >= extent[2] ? 0 : (extent[1] >= extent[2] ? 1 : 2);
+    const std::uint32_t half = count / 2;
+    std::nth_element(m_buildOrder.begin() + first, m_buildOrder.begin() + first + half, m_buildOrder.begin() + first + count,
+                     [this, axis](std::uint32_t lhs, std::uint32_t rhs) {
+                         const XMFLOAT4& a = m_staticSource[lhs].sphere;
+                         const XMFLOAT4& b = m_staticSource[rhs].sphere;
+                         return (axis == 0 ? a.x : axis == 1 ? a.y : a.z) < (axis == 0 ? b.x : axis == 1 ? b.y : b.z);
+                     });
+
+    build_node(first, half);
+    const std::uint32_t rightChild = build_node(first + half, count - half);
+
+    TreeNode& node = m_nodes[nodeIndex];
+    node.boundsMin = boundsMin;
+    node.boundsMax = boundsMax;
+    node.rightChild = rightChild;
+    return nodeIndex;
+}
+
+std::uint32_t FrustumCuller::test_lanes(const SphereLanes& lanes, std::size_t begin, std::size_t end,
+                                        const FrustumPlanes& frustum, std::uint8_t* outVisible) noexcept
+{
+    XMVECTOR planeX[6];
+    XMVECTOR planeY[6];
+    XMVECTOR planeZ[6];
+    XMVECTOR planeW[6];
+    for (std::size_t p = 0; p < 6; ++p)
+    {
+        planeX[p] = XMVectorReplicate(frustum.planes[p].x);
+        planeY[p] = XMVectorReplicate(frustum.planes[p].y);
+        planeZ[p] = XMVectorReplicate(frustum.planes[p].z);
+        planeW[p] = XMVectorReplicate(frustum.planes[p].w);
+    }
+
+    std::uint32_t visibleCount = 0;
+    for (std::size_t i = begin; i < end; i += 4)
+    {
+        const XMVECTOR cx = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(lanes.x.data() + i));
+        const XMVECTOR cy = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(lanes.y.data() + i));
+        const XMVECTOR cz = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(lanes.z.data() + i));
+        const XMVECTOR negRadius = XMVectorNegate(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(lanes.radius.data() + i)));
+
+        XMVECTOR inside = XMVectorTrueInt();
+        for (std::size_t p = 0; p < 6; ++p)
+        {
+            XMVECTOR distance = XMVectorMultiplyAdd(planeZ[p], cz, planeW[p]);
+            distance = XMVectorMultiplyAdd(planeY[p], cy, distance);
+            distance = XMVectorMultiplyAdd(planeX[p], cx, distance);
+            inside = XMVectorAndInt(inside, XMVectorGreaterOrEqual(distance, negRadius));
+        }
+
+        XMUINT4 mask{};
+        XMStoreUInt4(&mask, inside);
+        const std::uint32_t laneMask[4] = {mask.x, mask.y, mask.z, mask.w};
+        for (std::size_t lane = 0; lane < 4; ++lane)
+        {
+            const std::uint32_t item = lanes.item[i + lane];
+            if (item == InvalidItem)
+                continue;
+            const std::uint8_t visible = laneMask[lane] != 0 ? 1 : 0;
+            outVisible[item] = visible;
+            visibleCount += visible;
+        }
+    }
+    return visibleCount;
+}
+
+std::uint32_t FrustumCuller::cull_tree(const FrustumPlanes& frustum, std::uint8_t* outVisible) const
+{
+    if (m_nodes.empty())
+        return 0;
+
+    std::uint32_t visibleCount = 0;
+    std::uint32_t stack[64];
+    std::uint32_t stackSize = 0;
+    stack[stackSize++] = 0;
+
+    // Hidden static items keep the 0 written by cull(); only visible ranges are touched.
+    while (stackSize > 0)
+    {
+        const TreeNode& node = m_nodes[stack[--stackSize]];
+
+        bool outside = false;
+        bool contained = true;
+        for (const XMFLOAT4& plane : frustum.planes)
+        {
+            // Box corners farthest along and against the plane normal.
+            const float farDistance = plane.x * (plane.x >= 0.0f ? node.boundsMax.x : node.boundsMin.x) +
+                                      plane.y * (plane.y >= 0.0f ? node.boundsMax.y : node.boundsMin.y) +
+                                      plane.z * (plane.z >= 0.0f ? node.boundsMax.z : node.boundsMin.z) + plane.w;
+            if (farDistance < 0.0f)
+            {
+                outside = true;
+                break;
+            }
+            const float nearDistance = plane.x * (plane.x >= 0.0f ? node.boundsMin.x : node.boundsMax.x) +
+                                       plane.y * (plane.y >= 0.0f ? node.boundsMin.y : node.boundsMax.y) +
+                                       plane.z * (plane.z >= 0.0f ? node.boundsMin.z : node.boundsMax.z) + plane.w;
+            contained = contained && nearDistance >= 0.0f;
+        }
+        if (outside)
+            continue;
+
+        if (contained)
+        {
+            // Every sphere of the subtree is inside: accept its leaves wholesale. Leaves are laid out
+            // depth first, so the subtree covers m_static from its leftmost to its rightmost leaf.
+            const TreeNode* firstLeaf = &node;
+            while (firstLeaf->rightChild != 0)
+                firstLeaf = firstLeaf + 1;
+            const TreeNode* lastLeaf = &node;
+            while (lastLeaf->rightChild != 0)
+                lastLeaf = &m_nodes[lastLeaf->rightChild];
+            const std::size_t begin = firstLeaf->firstLane;
+            const std::size_t end = lastLeaf->firstLane + lastLeaf->laneCount;
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const std::uint32_t item = m_static.item[i];
+                if (item == InvalidItem)
+                    continue;
+                outVisible[item] = 1;
+                ++visibleCount;
+            }
+            continue;
+        }
+
+        if (node.rightChild == 0)
+        {
+            visibleCount += test_lanes(m_static, node.firstLane, node.firstLane + node.laneCount, frustum, outVisible);
+            continue;
+        }
+
+        const std::uint32_t nodeIndex = static_cast<std::uint32_t>(&node - m_nodes.data());
+        stack[stackSize++] = node.rightChild;
+        stack[stackSize++] = nodeIndex + 1;
+    }
+    return visibleCount;
+}
+
+std::uint32_t FrustumCuller::cull(const FrustumPlanes& frustum, std::vector<std::uint8_t>& outVisible,
+                                  tf::Executor* executor) const
+{
+    outVisible.assign(m_itemCount, 0);
+    std::uint8_t* visible = outVisible.data();
+
+    const std::size_t dynamicCount = m_dynamic.size();
+    const std::size_t chunkCount = (dynamicCount + ParallelChunkSize - 1) / ParallelChunkSize;
+    if (executor == nullptr || chunkCount <= 1)
+        return test_lanes(m_dynamic, 0, dynamicCount, frustum, visible) + cull_tree(frustum, visible);
+
+    // Chunks write disjoint items, so only the per-chunk counts need gathering.
+    std::vector<std::uint32_t> chunkVisible(chunkCount + 1, 0);
+    tf::Taskflow taskflow{};
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        taskflow.emplace([&, chunk]() {
+            const std::size_t begin = chunk * ParallelChunkSize;
+            const std::size_t end = std::min(dynamicCount, begin + ParallelChunkSize);
+            chunkVisible[chunk] = test_lanes(m_dynamic, begin, end, frustum, visible);
+        });
+    }
+    taskflow.emplace([&]() { chunkVisible[chunkCount] = cull_tree(frustum, visible); });
+    executor->run(taskflow).wait();
+
+    std::uint32_t visibleCount = 0;
+    for (std::uint32_t count : chunkVisible)
+        visibleCount += count;
+    return visibleCount;
+}
@@ -0,0 +1,153 @@
+#include "../Public/Mesh.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace
+{
+/// Smallest non-zero snorm16 magnitude, so the bitangent sign survives a zero tangent coordinate.
+constexpr float MinSignedMagnitude{1.0f / 32767.0f};
+
+std::int16_t to_snorm16(float value) noexcept
+{
+    return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+float from_snorm16(std::int16_t value) noexcept
+{
+    return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+}
+
+float sign_not_zero(float value) noexcept
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+/// Unit vector -> [-1, 1]^2 octahedral coordinates.
+std::array<float, 2> oct_encode(const XMFLOAT3& v) noexcept
+{
+    const float sum = std::fabs(v.x) + std::fabs(v.y) + std::fabs(v.z);
+    if (!(sum > 0.0f))
+        return {0.0f, 0.0f}; // degenerate input decodes to +Z
+
+    float x = v.x / sum;
+    float y = v.y / sum;
+    if (v.z < 0.0f)
+    {
+        const float foldedX = (1.0f - std::fabs(y)) * sign_not_zero(x);
+        const float foldedY = (1.0f - std::fabs(x)) * sign_not_zero(y);
+        x = foldedX;
+        y = foldedY;
+    }
+    return {x, y};
+}
+
+XMFLOAT3 oct_decode(float x, float y) noexcept
+{
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    const float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+    const float length = std::sqrt(x * x + y * y + z * z);
+    return {x / length, y / length, z / length};
+}
+
+/// Round-to-nearest-even float -> binary16, with overflow to infinity.
+std::uint16_t to_half(float value) noexcept
+{
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+    const std::uint32_t sign = (bits >> 16) & 0x8000u;
+    const std::uint32_t exponent = (bits >> 23) & 0xFFu;
+    std::uint32_t mantissa = bits & 0x007FFFFFu;
+
+    if (exponent == 0xFFu)
+        return static_cast<std::uint16_t>(sign | 0x7C00u | (mantissa != 0 ? 0x0200u : 0u));
+
+    const std::int32_t halfExponent = static_cast<std::int32_t>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1F)
+        return static_cast<std::uint16_t>(sign | 0x7C00u);
+
+    if (halfExponent <= 0)
+    {
+        if (halfExponent < -10)
+            return static_cast<std::uint16_t>(sign);
+        // Subnormal: shift the implicit-one mantissa into place with rounding.
+        mantissa |= 0x00800000u;
+        const std::uint32_t shift = static_cast<std::uint32_t>(14 - halfExponent);
+        std::uint32_t half = mantissa >> shift;
+        const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const std::uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half & 1u) != 0))
+            ++half;
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    std::uint32_t half = (static_cast<std::uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    const std::uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0))
+        ++half; // may carry into the exponent, which is still the correctly rounded value
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+float from_half(std::uint16_t value) noexcept
+{
+    const std::uint32_t sign = static_cast<std::uint32_t>(value & 0x8000u) << 16;
+    const std::uint32_t exponent = (value >> 10) & 0x1Fu;
+    std::uint32_t mantissa = value & 0x03FFu;
+
+    if (exponent == 0)
+    {
+        if (mantissa == 0)
+            return std::bit_cast<float>(sign);
+        // Subnormal half: renormalize.
+        std::int32_t shift = 0;
+        while ((mantissa & 0x0400u) == 0)
+        {
+            mantissa <<= 1;
+            ++shift;
+        }
+        mantissa &= 0x03FFu;
+        const std::uint32_t floatExponent = static_cast<std::uint32_t>(127 - 15 + 1 - shift);
+        return std::bit_cast<float>(sign | (floatExponent << 23) | (mantissa << 13));
+    }
+    if (exponent == 0x1Fu)
+        return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+
+    return std::bit_cast<float>(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+}
+} // namespace
+
+PackedVertex PackedVertex::pack(const Vertex& vertex) noexcept
+{
+    PackedVertex packed{};
+    packed.pos = vertex.pos;
+
+    const auto normal = oct_encode(vertex.normal);
+    packed.normal[0] = to_snorm16(normal[0]);
+    packed.normal[1] = to_snorm16(normal[1]);
+
+    // The second tangent coordinate moves to [MinSignedMagnitude, 1] and takes the bitangent sign.
+    const auto tangent = oct_encode({vertex.tangent.x, vertex.tangent.y, vertex.tangent.z});
+    const float tangentY = std::max(tangent[1] * 0.5f + 0.5f, MinSignedMagnitude);
+    packed.tangent[0] = to_snorm16(tangent[0]);
+    packed.tangent[1] = to_snorm16(vertex.tangent.w < 0.0f ? -tangentY : tangentY);
+
+    packed.texCoord[0] = to_half(vertex.texCoord.x);
+    packed.texCoord[1] = to_half(vertex.texCoord.y);
+    return packed;
+}
+
+Vertex PackedVertex::unpack() const noexcept
+{
+    Vertex vertex{};
+    vertex.pos = pos;
+    vertex.normal = oct_decode(from_snorm16(normal[0]), from_snorm16(normal[1]));
+
+    const float tangentY = from_snorm16(tangent[1]);
+    const XMFLOAT3 t = oct_decode(from_snorm16(tangent[0]), std::fabs(tangentY) * 2.0f - 1.0f);
+    vertex.tangent = {t.x, t.y, t.z, tangentY < 0.0f ? -1.0f : 1.0f};
+
+    vertex.texCoord = {from_half(texCoord[0]), from_half(texCoord[1])};
+    return vertex;
+}
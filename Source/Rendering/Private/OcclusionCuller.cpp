@@ -0,0 +1,173 @@
+#include "../Public/OcclusionCuller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <taskflow/taskflow.hpp>
+
+using namespace DirectX;
+
+void OcclusionCuller::set_depth(std::span<const float> depth, std::uint32_t width, std::uint32_t height,
+                                std::uint32_t texelShift, std::uint32_t viewportWidth, std::uint32_t viewportHeight,
+                                const XMFLOAT4X4& viewProj)
+{
+    if (width == 0 || height == 0 || depth.size() < static_cast<std::size_t>(width) * height)
+    {
+        clear();
+        return;
+    }
+
+    m_viewProj = viewProj;
+    m_viewportWidth = std::max(1u, viewportWidth);
+    m_viewportHeight = std::max(1u, viewportHeight);
+
+    m_texelShift = std::min(texelShift, 31u);
+
+    std::uint32_t levelCount = 1;
+    for (std::uint32_t size = std::max(width, height); size > 1; size = (size + 1) / 2)
+        ++levelCount;
+    m_levels.resize(levelCount);
+
+    m_levels[0].width = width;
+    m_levels[0].height = height;
+    m_levels[0].depth.assign(depth.begin(), depth.begin() + static_cast<std::ptrdiff_t>(width) * height);
+
+    // Same reduction as hiz.comp: a texel keeps the farthest of the 2x2 it covers, odd edges clamped.
+    for (std::uint32_t level = 1; level < levelCount; ++level)
+    {
+        const Level& source = m_levels[level - 1];
+        Level& target = m_levels[level];
+        target.width = (source.width + 1) / 2;
+        target.height = (source.height + 1) / 2;
+        target.depth.resize(static_cast<std::size_t>(target.width) * target.height);
+        for (std::uint32_t y = 0; y < target.height; ++y)
+        {
+            const std::uint32_t y0 = y * 2;
+            const std::uint32_t y1 = std::min(y0 + 1, source.height - 1);
+            for (std::uint32_t x = 0; x < target.width; ++x)
+            {
+                const std::uint32_t x0 = x * 2;
+                const std::uint32_t x1 = std::min(x0 + 1, source.width - 1);
+                target.depth[static_cast<std::size_t>(y) * target.width + x] =
+                    std::max(std::max(source.depth[static_cast<std::size_t>(y0) * source.width + x0],
+                                      source.depth[static_cast<std::size_t>(y0) * source.width + x1]),
+                             std::max(source.depth[static_cast<std::size_t>(y1) * source.width + x0],
+                                      source.depth[static_cast<std::size_t>(y1) * source.width + x1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::is_occluded(const XMFLOAT4& sphere) const noexcept
+{
+    if (m_levels.empty())
+        return false;
+
+    const XMMATRIX viewProj = XMLoadFloat4x4(&m_viewProj);
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+    float nearestDepth = 1.0f;
+    for (std::uint32_t corner = 0; corner < 8; ++corner)
+    {
+        const XMVECTOR point = XMVectorSet(sphere.x + ((corner & 1u) != 0 ? sphere.w : -sphere.w),
+                                           sphere.y + ((corner & 2u) != 0 ? sphere.w : -sphere.w),
+                                           sphere.z + ((corner & 4u) != 0 ? sphere.w : -sphere.w), 1.0f);
+        XMFLOAT4 clip{};
+        XMStoreFloat4(&clip, XMVector4Transform(point, viewProj));
+        if (clip.w <= 1e-5f)
+            return false;
+
+        const float invW = 1.0f / clip.w;
+        minX = std::min(minX, clip.x * invW);
+        maxX = std::max(maxX, clip.x * invW);
+        minY = std::min(minY, clip.y * invW);
+        maxY = std::max(maxY, clip.y * invW);
+        nearestDepth = std::min(nearestDepth, clip.z * invW);
+    }
+
+    // Only footprints wholly inside the old viewport are known to be covered by its depth.
+    if (nearestDepth <= 0.0f || minX < -1.0f || maxX > 1.0f || minY < -1.0f || maxY > 1.0f)
+        return false;
+
+    const auto to_pixel = [](float ndc, std::uint32_t size) {
+        const auto pixel = static_cast<std::uint32_t>((ndc * 0.5f + 0.5f) * static_cast<float>(size));
+        return std::min(pixel, size - 1);
+    };
+    const std::uint32_t pixelMinX = to_pixel(minX, m_viewportWidth);
+    const std::uint32_t pixelMaxX = to_pixel(maxX, m_viewportWidth);
+    const std::uint32_t pixelMinY = to_pixel(minY, m_viewportHeight);
+    const std::uint32_t pixelMaxY = to_pixel(maxY, m_viewportHeight);
+
+    // A span of at most 2^shift pixels touches at most two texels per axis at that level.
+    const std::uint32_t extent = std::max(pixelMaxX - pixelMinX, pixelMaxY - pixelMinY) + 1;
+    std::uint32_t level = 0;
+    while (level + 1 < m_levels.size() && (1u << (m_texelShift + level)) < extent)
+        ++level;
+
+    const Level& hiZ = m_levels[level];
+    const std::uint32_t shift = m_texelShift + level;
+    const std::uint32_t texelMinX = std::min(pixelMinX >> shift, hiZ.width - 1);
+    const std::uint32_t texelMaxX = std::min(pixelMaxX >> shift, hiZ.width - 1);
+    const std::uint32_t texelMinY = std::min(pixelMinY >> shift, hiZ.height - 1);
+    const std::uint32_t texelMaxY = std::min(pixelMaxY >> shift, hiZ.height - 1);
+
+    float farthestDepth = 0.0f;
+    for (std::uint32_t y = texelMinY; y <= texelMaxY; ++y)
+    {
+        for (std::uint32_t x = texelMinX; x <= texelMaxX; ++x)
+            farthestDepth = std::max(farthestDepth, hiZ.depth[static_cast<std::size_t>(y) * hiZ.width + x]);
+    }
+    return nearestDepth > farthestDepth;
+}
+
+std::uint32_t OcclusionCuller::cull_range(std::span<const XMFLOAT4> spheres, std::uint8_t* visible, std::size_t begin,
+                                          std::size_t end) const noexcept
+{
+    std::uint32_t occludedCount = 0;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        if (visible[i] != 1 || !is_occluded(spheres[i]))
+            continue;
+        visible[i] = Occluded;
+        ++occludedCount;
+    }
+    return occludedCount;
+}
+
+std::uint32_t OcclusionCuller::cull(std::span<const XMFLOAT4> spheres, std::vector<std::uint8_t>& visible,
+                                    tf::Executor* executor) const
+{
+    if (m_levels.empty())
+        return 0;
+
+    const std::size_t itemCount = std::min(spheres.size(), visible.size());
+    const std::size_t chunkCount = (itemCount + ParallelChunkSize - 1) / ParallelChunkSize;
+    if (executor == nullptr || chunkCount <= 1)
+        return cull_range(spheres, visible.data(), 0, itemCount);
+
+    std::vector<std::uint32_t> chunkOccluded(chunkCount, 0);
+    tf::Taskflow taskflow{};
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        taskflow.emplace([&, chunk]() {
+            const std::size_t begin = chunk * ParallelChunkSize;
+            const std::size_t end = std::min(itemCount, begin + ParallelChunkSize);
+            chunkOccluded[chunk] = cull_range(spheres, visible.data(), begin, end);
+        });
+    }
+    executor->run(taskflow).wait();
+
+    std::uint32_t occludedCount = 0;
+    for (std::uint32_t count : chunkOccluded)
+        occludedCount += count;
+    return occludedCount;
+}
+
+void OcclusionCuller::clear() noexcept
+{
+    m_levels.clear();
+    m_texelShift = 0;
+}
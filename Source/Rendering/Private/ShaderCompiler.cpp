@@ -1,46 +1,123 @@
 #include "../Public/ShaderCompiler.hpp"
+#include "../../Core/Public/VirtualFileSystem.hpp"
 
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <regex>
+#include <iterator>
+#include <memory>
+#include <string>
 
 #include <fmt/core.h>
 #include <shaderc/shaderc.hpp>
 
-//    Public API                                                        
-
-Result<std::vector<std::uint32_t>> ShaderCompiler::compile(
-    std::string_view glslSource,
-    ShaderStage stage,
-    std::string_view filename
-)
+namespace
+{
+shaderc::CompileOptions make_compile_options()
 {
-    shaderc::Compiler compiler{};
     shaderc::CompileOptions options{};
 
     // Target Vulkan 1.0 / SPIR-V 1.0 for maximum compatibility
     options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_0);
     options.SetOptimizationLevel(shaderc_optimization_level_performance);
+    return options;
+}
 
-    shaderc_shader_kind kind{};
+shaderc_shader_kind to_shader_kind(ShaderStage stage) noexcept
+{
     switch (stage)
     {
     case ShaderStage::Vertex:
-        kind = shaderc_glsl_vertex_shader;
-        break;
+        return shaderc_glsl_vertex_shader;
     case ShaderStage::Fragment:
-        kind = shaderc_glsl_fragment_shader;
-        break;
+        return shaderc_glsl_fragment_shader;
     case ShaderStage::Compute:
-        kind = shaderc_glsl_compute_shader;
-        break;
+    default:
+        return shaderc_glsl_compute_shader;
     }
+}
+
+/// Resolves `#include "file"` relative to the including file, then through the include directories.
+/// Records every file it reads.
+class IncludeResolver final : public shaderc::CompileOptions::IncluderInterface
+{
+  public:
+    IncludeResolver(std::vector<std::filesystem::path> includeDirs, std::vector<std::filesystem::path>* dependencies)
+        : m_includeDirs(std::move(includeDirs)), m_dependencies(dependencies)
+    {
+    }
+
+    shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type type,
+                                       const char* requestingSource, std::size_t /*includeDepth*/) override
+    {
+        auto* include = new Include{};
+
+        std::vector<std::filesystem::path> candidates{};
+        if (type == shaderc_include_type_relative)
+            candidates.push_back(std::filesystem::path(requestingSource).parent_path() / requestedSource);
+        for (const std::filesystem::path& directory : m_includeDirs)
+            candidates.push_back(directory / requestedSource);
+
+        for (const std::filesystem::path& candidate : candidates)
+        {
+            std::ifstream file(candidate, std::ios::binary);
+            if (!file.is_open())
+                continue;
+
+            include->name = candidate.generic_string();
+            include->content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            if (m_dependencies)
+                m_dependencies->push_back(candidate);
+            break;
+        }
+
+        // shaderc reports a failed include as an empty source name with the error as content.
+        if (include->name.empty())
+            include->content = fmt::format("Could not resolve #include \"{}\"", requestedSource);
+
+        include->result.source_name = include->name.c_str();
+        include->result.source_name_length = include->name.size();
+        include->result.content = include->content.c_str();
+        include->result.content_length = include->content.size();
+        include->result.user_data = include;
+        return &include->result;
+    }
+
+    void ReleaseInclude(shaderc_include_result* data) override
+    {
+        delete static_cast<Include*>(data->user_data);
+    }
+
+  private:
+    struct Include
+    {
+        std::string name{};
+        std::string content{};
+        shaderc_include_result result{};
+    };
+
+    std::vector<std::filesystem::path> m_includeDirs{};
+    std::vector<std::filesystem::path>* m_dependencies{};
+};
+} // namespace
+
+//    Public API                                                        
+
+Result<std::vector<std::uint32_t>> ShaderCompiler::compile(
+    std::string_view glslSource,
+    ShaderStage stage,
+    std::string_view filename
+)
+{
+    shaderc::Compiler compiler{};
+    const shaderc::CompileOptions options = make_compile_options();
+    const std::string sourceName{filename};
 
     shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(
         glslSource.data(),
         glslSource.size(),
-        kind,
-        filename.data(),
+        to_shader_kind(stage),
+        sourceName.c_str(),
         options
     );
 
@@ -89,6 +166,54 @@ Result<std::vector<std::uint32_t>> ShaderCompiler::compile_file(const std::files
     return compile(source, stageResult.value(), glslPath.filename().string());
 }
 
+Result<std::vector<std::uint32_t>> ShaderCompiler::compile_file_with_includes(
+    const std::filesystem::path& glslPath,
+    const std::vector<std::filesystem::path>& includeDirs,
+    std::vector<std::filesystem::path>* dependencies
+)
+{
+    auto stageResult = detect_stage(glslPath);
+    if (!stageResult)
+        return make_error(stageResult.error());
+
+    std::ifstream file(glslPath, std::ios::binary);
+    if (!file.is_open())
+        return make_error(
+            fmt::format("Failed to open shader source: {}", glslPath.string()),
+            ErrorCode::AssetFileNotFound
+        );
+    const std::string source{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    if (dependencies)
+        dependencies->push_back(glslPath);
+
+    shaderc::Compiler compiler{};
+    shaderc::CompileOptions options = make_compile_options();
+    options.SetIncluder(std::make_unique<IncludeResolver>(includeDirs, dependencies));
+
+    const std::string sourceName = glslPath.generic_string();
+    shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(
+        source.data(),
+        source.size(),
+        to_shader_kind(stageResult.value()),
+        sourceName.c_str(),
+        options
+    );
+
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+    {
+        return make_error(
+            fmt::format(
+                "Shader compilation failed ({}): {}",
+                glslPath.filename().string(),
+                result.GetErrorMessage()
+            ),
+            ErrorCode::ShaderCompilationFailed
+        );
+    }
+
+    return std::vector<std::uint32_t>(result.cbegin(), result.cend());
+}
+
 Result<std::vector<std::uint32_t>> ShaderCompiler::compile_or_cache(const std::filesystem::path& glslPath, const std::filesystem::path& spvPath)
 {
     // Check if cached .spv exists and is newer than the source
@@ -127,7 +252,7 @@ Result<std::vector<std::uint32_t>> ShaderCompiler::load_or_compile(const std::fi
     case ShaderLoadMode::PrecompiledOnly:
         return read_spv(spvPath);
     case ShaderLoadMode::PreferPrecompiled:
-        if (std::filesystem::exists(spvPath))
+        if (VirtualFileSystem::get().exists(spvPath))
             return read_spv(spvPath);
         return compile_file(glslPath);
     case ShaderLoadMode::RuntimeCompileWithCache:
@@ -173,23 +298,22 @@ Result<ShaderStage> ShaderCompiler::detect_stage(const std::filesystem::path& gl
 
 Result<std::vector<std::uint32_t>> ShaderCompiler::read_spv(const std::filesystem::path& spvPath)
 {
-    std::ifstream file(spvPath, std::ios::binary | std::ios::ate);
-    if (!file.is_open())
+    auto file = VirtualFileSystem::get().open(spvPath);
+    if (!file)
         return make_error(
             fmt::format("Failed to open cached shader: {}", spvPath.string()),
             ErrorCode::FileReadFailed
         );
 
-    auto fileSize = static_cast<std::size_t>(file.tellg());
+    const std::size_t fileSize = file->size();
     if (fileSize == 0 || fileSize % sizeof(std::uint32_t) != 0)
         return make_error(
             fmt::format("Invalid SPIR-V file (size {}): {}", fileSize, spvPath.string()),
             ErrorCode::ShaderCompilationFailed
         );
 
-    file.seekg(0);
     std::vector<std::uint32_t> spirv(fileSize / sizeof(std::uint32_t));
-    file.read(reinterpret_cast<char*>(spirv.data()), static_cast<std::streamsize>(fileSize));
+    std::memcpy(spirv.data(), file->data(), fileSize);
 
     return spirv;
 }
@@ -226,70 +350,7 @@ Result<std::vector<std::uint32_t>> ShaderCompiler::compile_compute_with_includes
             ErrorCode::AssetFileNotFound
         );
 
-    // Read the main shader source
-    std::ifstream mainFile(glslPath, std::ios::binary | std::ios::ate);
-    if (!mainFile.is_open())
-        return make_error(
-            fmt::format("Failed to open compute shader: {}", glslPath.string()),
-            ErrorCode::FileReadFailed
-        );
-
-    auto mainSize = mainFile.tellg();
-    mainFile.seekg(0);
-    std::string source(static_cast<std::size_t>(mainSize), '\0');
-    mainFile.read(source.data(), mainSize);
-    mainFile.close();
-
-    // Resolve #include directives by inlining file contents.
-    // Matches: #include "filename.h"
-    std::regex includeRegex("^\\s*#include\\s+\"([^\"]+)\"", std::regex::multiline);
-    std::string resolved{};
-    std::sregex_iterator it(source.begin(), source.end(), includeRegex);
-    std::sregex_iterator end{};
-    std::size_t lastPos{};
-
-    for (; it != end; ++it)
-    {
-        const auto& match = *it;
-        resolved.append(source, lastPos, static_cast<std::size_t>(match.position()) - lastPos);
-
-        std::string includeName = match[1].str();
-        bool found{false};
-
-        for (const auto& dir : includeDirs)
-        {
-            auto includePath = dir / includeName;
-            if (std::filesystem::exists(includePath))
-            {
-                std::ifstream incFile(includePath, std::ios::binary | std::ios::ate);
-                if (incFile.is_open())
-                {
-                    auto incSize = incFile.tellg();
-                    incFile.seekg(0);
-                    std::string incContent(static_cast<std::size_t>(incSize), '\0');
-                    incFile.read(incContent.data(), incSize);
-                    resolved += incContent;
-                    resolved += '\n';
-                    found = true;
-                    break;
-                }
-            }
-        }
-
-        if (!found)
-        {
-            return make_error(
-                fmt::format("Could not resolve #include \"{}\" from {}", includeName, glslPath.string()),
-                ErrorCode::ShaderCompilationFailed
-            );
-        }
-
-        lastPos = static_cast<std::size_t>(match.position()) + match.length();
-    }
-
-    resolved.append(source, lastPos, source.size() - lastPos);
-
-    return compile(resolved, ShaderStage::Compute, glslPath.filename().string());
+    return compile_file_with_includes(glslPath, includeDirs);
 }
 
 Result<std::vector<std::uint32_t>> ShaderCompiler::load_compute_with_includes(
@@ -303,7 +364,7 @@ Result<std::vector<std::uint32_t>> ShaderCompiler::load_compute_with_includes(
     case ShaderLoadMode::PrecompiledOnly:
         return read_spv(spvPath);
     case ShaderLoadMode::PreferPrecompiled:
-        if (std::filesystem::exists(spvPath))
+        if (VirtualFileSystem::get().exists(spvPath))
             return read_spv(spvPath);
         return compile_compute_with_includes(glslPath, includeDirs);
     case ShaderLoadMode::RuntimeCompileWithCache:
@@ -0,0 +1,166 @@
+#include "../Public/ShaderHotReloader.hpp"
+#include "../../Core/Public/JobSystem.hpp"
+#include "../Public/ShaderCompiler.hpp"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+struct ShaderHotReloader::PendingCompile
+{
+    /// One per shader stage (vertex, fragment); each is compiled by its own job.
+    struct Stage
+    {
+        std::filesystem::path path;
+        Result<std::vector<std::uint32_t>> spirv{};
+        std::vector<std::filesystem::path> dependencies{};
+    };
+    std::array<Stage, 2> stages{};
+    std::atomic<std::uint32_t> stagesLeft{2};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool done{false};
+    Result<CompiledShaders> result{};
+    std::vector<WatchedFile> watched{};
+};
+
+ShaderHotReloader::~ShaderHotReloader()
+{
+    wait();
+}
+
+void ShaderHotReloader::set_sources(const std::filesystem::path& vertPath, const std::filesystem::path& fragPath)
+{
+    m_vertPath = vertPath;
+    m_fragPath = fragPath;
+    m_watched = stamp({m_vertPath, m_fragPath});
+}
+
+void ShaderHotReloader::set_watching(bool enabled)
+{
+    if (enabled && !m_watching && m_watched.empty())
+        m_watched = stamp({m_vertPath, m_fragPath});
+    m_watching = enabled;
+}
+
+bool ShaderHotReloader::is_compiling() const noexcept
+{
+    if (!m_pending)
+        return false;
+    std::lock_guard lock{m_pending->mutex};
+    return !m_pending->done;
+}
+
+std::optional<Result<ShaderHotReloader::CompiledShaders>> ShaderHotReloader::poll()
+{
+    if (m_watching && std::chrono::steady_clock::now() >= m_nextCheck)
+    {
+        m_nextCheck = std::chrono::steady_clock::now() + PollInterval;
+        if (watched_files_changed())
+        {
+            m_requested = true;
+            // Re-stamp so one edit queues one compile even while another is still running.
+            for (WatchedFile& file : m_watched)
+            {
+                std::error_code ec;
+                file.second = std::filesystem::last_write_time(file.first, ec);
+            }
+        }
+    }
+
+    std::optional<Result<CompiledShaders>> finished{};
+    if (m_pending)
+    {
+        std::lock_guard lock{m_pending->mutex};
+        if (!m_pending->done)
+            return std::nullopt;
+        finished = std::move(m_pending->result);
+        // A failed compile still reports what it included, so fixing an include retriggers it.
+        if (!m_pending->watched.empty())
+            m_watched = std::move(m_pending->watched);
+    }
+    if (finished)
+        m_pending.reset();
+
+    if (m_requested)
+        start_compile();
+    return finished;
+}
+
+void ShaderHotReloader::wait()
+{
+    if (!m_pending)
+        return;
+    std::unique_lock lock{m_pending->mutex};
+    m_pending->finished.wait(lock, [this] { return m_pending->done; });
+}
+
+void ShaderHotReloader::start_compile()
+{
+    m_requested = false;
+
+    auto pending = std::make_shared<PendingCompile>();
+    pending->stages[0].path = m_vertPath;
+    pending->stages[1].path = m_fragPath;
+    m_pending = pending;
+
+    // The stages compile in parallel; whichever job finishes last joins them and publishes the result.
+    for (std::size_t stageIndex = 0; stageIndex < pending->stages.size(); ++stageIndex)
+    {
+        JobSystem::get().submit(JobPriority::Background, [pending, stageIndex]() {
+            PendingCompile::Stage& stage = pending->stages[stageIndex];
+            stage.spirv = ShaderCompiler::compile_file_with_includes(stage.path, {stage.path.parent_path()},
+                                                                     &stage.dependencies);
+            if (pending->stagesLeft.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+
+            PendingCompile::Stage& vert = pending->stages[0];
+            PendingCompile::Stage& frag = pending->stages[1];
+            Result<CompiledShaders> result{};
+            if (!vert.spirv)
+                result = make_error(vert.spirv.error());
+            else if (!frag.spirv)
+                result = make_error(frag.spirv.error());
+            else
+                result = CompiledShaders{std::move(vert.spirv.value()), std::move(frag.spirv.value())};
+
+            std::vector<std::filesystem::path> dependencies = std::move(vert.dependencies);
+            dependencies.insert(dependencies.end(), frag.dependencies.begin(), frag.dependencies.end());
+            std::vector<WatchedFile> watched = stamp(dependencies);
+
+            std::lock_guard lock{pending->mutex};
+            pending->result = std::move(result);
+            pending->watched = std::move(watched);
+            pending->done = true;
+            pending->finished.notify_all();
+        });
+    }
+}
+
+bool ShaderHotReloader::watched_files_changed() const
+{
+    for (const auto& [path, writeTime] : m_watched)
+    {
+        std::error_code ec;
+        const auto current = std::filesystem::last_write_time(path, ec);
+        // Editors that save by replacing the file leave it briefly missing; wait for it to return.
+        if (!ec && current != writeTime)
+            return true;
+    }
+    return false;
+}
+
+std::vector<ShaderHotReloader::WatchedFile> ShaderHotReloader::stamp(const std::vector<std::filesystem::path>& files)
+{
+    std::vector<WatchedFile> stamped{};
+    stamped.reserve(files.size());
+    for (const std::filesystem::path& file : files)
+    {
+        std::error_code ec;
+        const auto writeTime = std::filesystem::last_write_time(file, ec);
+        stamped.emplace_back(file, ec ? std::filesystem::file_time_type{} : writeTime);
+    }
+    return stamped;
+}
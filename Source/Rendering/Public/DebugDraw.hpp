@@ -0,0 +1,111 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <DirectXMath.h>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Wireframe primitives of the debug overlay. Each is one unit wireframe mesh the renderer instances.
+enum class DebugShape : std::uint32_t
+{
+    Line = 0,     // from the origin to +X
+    Box = 1,      // corners at +-1
+    Sphere = 2,   // three great circles of radius 1
+    Capsule = 3,  // unit hemispheres pushed apart along Y by the instance's half height
+    Cylinder = 4, // radius 1, Y from -1 to 1
+};
+
+inline constexpr std::uint32_t DebugShapeCount{5};
+
+/// One debug primitive as read by debug.vert (per-instance vertex attributes).
+struct DebugDrawInstance
+{
+    DirectX::XMFLOAT3X4 model{}; // affine world matrix, transposed like InstanceData::model
+    DirectX::XMFLOAT4 extent{};  // scale of the unit shape (xyz), capsule half height (w)
+    std::uint32_t color{};       // RGBA8, red in the lowest byte
+    float width{1.0f};           // line width in output pixels
+    std::uint32_t padding[2]{};
+};
+static_assert(sizeof(DebugDrawInstance) == 80, "DebugDrawInstance must match the vertex layout of debug.vert");
+
+/// One corner of a line segment's screen-space quad. Unit positions: xyz is the position; w is -1 or
+/// 1 on the capsule's bottom and top halves (0 elsewhere) and scales the instance's half height along Y.
+struct DebugShapeVertex
+{
+    DirectX::XMFLOAT4 position{}; // the segment end this corner sits on
+    DirectX::XMFLOAT4 other{};    // the segment's other end, for its screen-space direction
+    float side{};                 // -1 or 1: which side of the segment debug.vert pushes the corner to
+};
+static_assert(sizeof(DebugShapeVertex) == 36, "DebugShapeVertex must match the vertex layout of debug.vert");
+
+/// Triangle-list vertices of every unit shape, back to back: six per line segment, which debug.vert
+/// widens to the instance's line width. Wide lines need no optional device feature this way, and the
+/// width can differ per instance within one draw.
+struct NOC_EXPORT DebugShapeMesh
+{
+    std::vector<DebugShapeVertex> vertices{};
+    std::array<std::uint32_t, DebugShapeCount> firstVertex{};
+    std::array<std::uint32_t, DebugShapeCount> vertexCount{};
+
+    static DebugShapeMesh build();
+};
+
+/// Debug primitives for one frame, bucketed by shape and depth mode so the renderer uploads them
+/// as they are and draws each depth mode with one indirect call. Depth-tested primitives are hidden
+/// behind scene geometry; the others draw on top of it. Neither writes depth. Line widths are in
+/// output pixels, like ImGui's, whatever resolution the scene renders at.
+///
+/// Fill it on the main thread and hand it to IRenderer::set_debug_draw(); keep the list between
+/// frames and clear() it to reuse its capacity.
+class NOC_EXPORT DebugDrawList
+{
+  public:
+    /// Packs a color into the RGBA8 layout of DebugDrawInstance::color (same as ImGui's IM_COL32).
+    static constexpr std::uint32_t pack_color(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a = 255) noexcept
+    {
+        return static_cast<std::uint32_t>(r) | (static_cast<std::uint32_t>(g) << 8) |
+               (static_cast<std::uint32_t>(b) << 16) | (static_cast<std::uint32_t>(a) << 24);
+    }
+
+    void add_line(const DirectX::XMFLOAT3& from, const DirectX::XMFLOAT3& to, std::uint32_t color, bool depthTest = true,
+                  float width = 1.0f);
+
+    /// Box of the given half extents centered on `world`'s origin.
+    void add_box(DirectX::FXMMATRIX world, const DirectX::XMFLOAT3& halfExtents, std::uint32_t color,
+                 bool depthTest = true, float width = 1.0f);
+    void add_sphere(DirectX::FXMMATRIX world, float radius, std::uint32_t color, bool depthTest = true,
+                    float width = 1.0f);
+    /// Capsule along `world`'s Y axis; `halfHeight` is the half length of the cylindrical part.
+    void add_capsule(DirectX::FXMMATRIX world, float radius, float halfHeight, std::uint32_t color,
+                     bool depthTest = true, float width = 1.0f);
+    /// Cylinder along `world`'s Y axis.
+    void add_cylinder(DirectX::FXMMATRIX world, float radius, float halfHeight, std::uint32_t color,
+                      bool depthTest = true, float width = 1.0f);
+
+    void clear() noexcept;
+    bool empty() const noexcept;
+    /// Primitives over every shape and depth mode.
+    std::size_t size() const noexcept;
+
+    std::span<const DebugDrawInstance> get_instances(DebugShape shape, bool depthTest) const noexcept
+    {
+        return m_buckets[bucket_index(shape, depthTest)];
+    }
+
+  private:
+    static constexpr std::size_t bucket_index(DebugShape shape, bool depthTest) noexcept
+    {
+        return static_cast<std::size_t>(shape) * 2 + (depthTest ? 0 : 1);
+    }
+    void add(DebugShape shape, DirectX::FXMMATRIX world, const DirectX::XMFLOAT4& extent, std::uint32_t color,
+             bool depthTest, float width);
+
+    std::array<std::vector<DebugDrawInstance>, DebugShapeCount * 2> m_buckets{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
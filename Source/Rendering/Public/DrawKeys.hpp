@@ -0,0 +1,108 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Render pass a draw belongs to; the most significant field of a draw key.
+enum class DrawPass : std::uint8_t
+{
+    Opaque = 0,
+};
+
+/// 64-bit sort key of one draw, most significant field first:
+///   pass (4) | mesh (24) | material (20) | depth bucket (16)
+/// Sorting by key groups draws into mesh runs (one instanced batch each), then by material,
+/// then roughly front to back.
+struct DrawKey
+{
+    static constexpr std::uint32_t DepthBits{16};
+    static constexpr std::uint32_t MaterialBits{20};
+    static constexpr std::uint32_t MeshBits{24};
+    static constexpr std::uint32_t PassBits{4};
+
+    static constexpr std::uint32_t DepthShift{0};
+    static constexpr std::uint32_t MaterialShift{DepthShift + DepthBits};
+    static constexpr std::uint32_t MeshShift{MaterialShift + MaterialBits};
+    static constexpr std::uint32_t PassShift{MeshShift + MeshBits};
+
+    static constexpr std::uint64_t field_mask(std::uint32_t bits) noexcept
+    {
+        return (std::uint64_t{1} << bits) - 1;
+    }
+
+    static constexpr std::uint64_t make(DrawPass pass, std::uint32_t meshIndex, std::uint32_t materialIndex,
+                                        std::uint32_t depthBucket) noexcept
+    {
+        return (static_cast<std::uint64_t>(pass) & field_mask(PassBits)) << PassShift |
+               (meshIndex & field_mask(MeshBits)) << MeshShift |
+               (materialIndex & field_mask(MaterialBits)) << MaterialShift |
+               (depthBucket & field_mask(DepthBits)) << DepthShift;
+    }
+
+    static constexpr std::uint32_t mesh_of(std::uint64_t key) noexcept
+    {
+        return static_cast<std::uint32_t>((key >> MeshShift) & field_mask(MeshBits));
+    }
+
+    /// Coarse logarithmic bucket (8 per octave) of a view-space distance. Coarse on purpose:
+    /// small camera moves should not change keys, so the incremental path stays cheap.
+    static std::uint32_t depth_bucket(float viewDistance) noexcept;
+};
+
+/// Keeps draws ordered by DrawKey and refers back to the caller's renderables by index.
+/// A full sort is an LSD radix sort over (key, index) pairs that skips byte passes in which every
+/// key agrees. When `incremental` is requested and the draw count is unchanged, only the entries
+/// whose keys changed are re-sorted and merged into the previous order. Both paths yield
+/// the same (key, index) order.
+class NOC_EXPORT DrawKeySorter
+{
+  public:
+    /// Re-sorts for `keys[i]` = key of renderable i.
+    void sort(std::span<const std::uint64_t> keys, bool incremental = true);
+
+    /// Drops the previous order so the next sort is a full one.
+    void clear() noexcept;
+
+    /// Renderable indices in draw order.
+    inline std::span<const std::uint32_t> get_order() const noexcept
+    {
+        return m_order;
+    }
+    /// Entries re-bucketed by the last sort (every entry after a full sort).
+    inline std::uint32_t get_last_changed_count() const noexcept
+    {
+        return m_lastChangedCount;
+    }
+    inline bool was_last_sort_full() const noexcept
+    {
+        return m_lastSortFull;
+    }
+
+    /// Above this fraction of changed keys a full radix sort beats merging.
+    static constexpr std::uint32_t IncrementalDivisor{8};
+
+  private:
+    struct Entry
+    {
+        std::uint64_t key{};
+        std::uint32_t index{};
+    };
+
+    void radix_sort(std::vector<Entry>& entries);
+    void store_order(const std::vector<Entry>& entries);
+
+    std::vector<std::uint64_t> m_keys{}; // key of each renderable as of the last sort
+    std::vector<std::uint32_t> m_order{};
+    std::vector<Entry> m_sorted{};
+    std::vector<Entry> m_scratch{};
+    std::vector<Entry> m_changed{};
+    std::vector<std::uint8_t> m_changedMask{};
+    std::uint32_t m_lastChangedCount{};
+    bool m_lastSortFull{true};
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,125 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace tf
+{
+class Executor;
+}
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Normalized world-space frustum planes; a point is inside when dot(xyz, p) + w >= 0 for all six.
+struct NOC_EXPORT FrustumPlanes
+{
+    std::array<DirectX::XMFLOAT4, 6> planes{};
+
+    /// Gribb-Hartmann extraction from a row-vector view-projection matrix with depth range 0..1.
+    static FrustumPlanes from_view_projection(const DirectX::XMFLOAT4X4& viewProj) noexcept;
+};
+
+/// CPU sphere-vs-frustum culling over world-space bounding spheres.
+/// Dynamic spheres live in SoA arrays and are tested four lanes at a time with DirectXMath
+/// (SSE on x86, NEON on ARM), chunked across a Taskflow executor when one is given.
+/// Static spheres sit under an AABB tree: subtrees wholly inside the frustum are accepted and
+/// subtrees wholly outside rejected without testing their spheres; only straddling leaves
+/// fall back to the lane test.
+class NOC_EXPORT FrustumCuller
+{
+  public:
+    /// Dynamic spheres per parallel task; smaller inputs are culled on the calling thread.
+    static constexpr std::size_t ParallelChunkSize{4096};
+    /// Upper bound of spheres per tree leaf (padded to whole lanes).
+    static constexpr std::uint32_t LeafSize{16};
+
+    /// Replaces the inputs: spheres[i] = world-space center (xyz) and radius (w) of item i.
+    /// Items with staticFlags[i] != 0 go through the tree, which is only rebuilt when the
+    /// static spheres differ from the previous call.
+    void set_spheres(std::span<const DirectX::XMFLOAT4> spheres, std::span<const std::uint8_t> staticFlags);
+
+    /// Sets outVisible[i] to 1 for every item whose sphere touches the frustum and 0 otherwise.
+    /// Returns the number of visible items.
+    std::uint32_t cull(const FrustumPlanes& frustum, std::vector<std::uint8_t>& outVisible,
+                       tf::Executor* executor = nullptr) const;
+
+    void clear() noexcept;
+
+    inline std::size_t get_item_count() const noexcept
+    {
+        return m_itemCount;
+    }
+    inline std::size_t get_static_item_count() const noexcept
+    {
+        return m_staticSource.size();
+    }
+    inline std::size_t get_tree_node_count() const noexcept
+    {
+        return m_nodes.size();
+    }
+    /// True when the last set_spheres() call had to rebuild the static tree.
+    inline bool was_tree_rebuilt() const noexcept
+    {
+        return m_treeRebuilt;
+    }
+
+  private:
+    static constexpr std::uint32_t InvalidItem{0xFFFFFFFFu};
+
+    /// Structure-of-arrays sphere storage, always a whole number of 4-wide lanes.
+    struct SphereLanes
+    {
+        std::vector<float> x{};
+        std::vector<float> y{};
+        std::vector<float> z{};
+        std::vector<float> radius{};
+        std::vector<std::uint32_t> item{};
+
+        void clear() noexcept;
+        void push(const DirectX::XMFLOAT4& sphere, std::uint32_t itemIndex);
+        /// Pads with never-visible entries up to the next multiple of four.
+        void pad_to_lane();
+        inline std::size_t size() const noexcept
+        {
+            return item.size();
+        }
+    };
+
+    /// Depth-first tree node; the left child directly follows its parent.
+    struct TreeNode
+    {
+        DirectX::XMFLOAT3 boundsMin{};
+        std::uint32_t rightChild{}; // 0 for leaves
+        DirectX::XMFLOAT3 boundsMax{};
+        std::uint32_t firstLane{};  // leaves: first entry in m_static
+        std::uint32_t laneCount{};  // leaves: padded entry count
+    };
+
+    struct StaticSphere
+    {
+        DirectX::XMFLOAT4 sphere{};
+        std::uint32_t item{};
+    };
+
+    void build_tree();
+    std::uint32_t build_node(std::uint32_t first, std::uint32_t count);
+    std::uint32_t cull_tree(const FrustumPlanes& frustum, std::uint8_t* outVisible) const;
+    static std::uint32_t test_lanes(const SphereLanes& lanes, std::size_t begin, std::size_t end,
+                                    const FrustumPlanes& frustum, std::uint8_t* outVisible) noexcept;
+
+    SphereLanes m_dynamic{};
+    SphereLanes m_static{}; // tree leaf order
+    std::vector<StaticSphere> m_staticSource{};
+    std::vector<StaticSphere> m_staticScratch{};
+    std::vector<std::uint32_t> m_buildOrder{};
+    std::vector<TreeNode> m_nodes{};
+    std::size_t m_itemCount{};
+    bool m_treeRebuilt{false};
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -1,10 +1,14 @@
 #pragma once
 #include "../../Core/Public/Expected.hpp"
+#include "DebugDraw.hpp"
+#include "Light.hpp"
 #include "Renderable.hpp"
 #include "ShaderCompiler.hpp"
 
 #include <cstdint>
 #include <filesystem>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include <DirectXMath.h>
@@ -21,6 +25,18 @@ struct MeshBounds
     bool valid{false};
 };
 
+/// Identifies a batch of queued GPU uploads. Tickets increase monotonically; waiting on one
+/// also covers every earlier ticket. 0 means "nothing submitted yet" and is always complete.
+using UploadTicket = std::uint64_t;
+
+/// Frame pacing timings measured by IRenderer::wait_for_next_frame().
+struct FrameLatencyStats
+{
+    float waitMs{0.0f};           // time the last wait blocked
+    float inputToPresentMs{0.0f}; // smoothed upper bound from the end of a wait to that frame being presented
+    bool presentWait{false};      // measured to present completion rather than to the frame's fence
+};
+
 enum class KHR_Settings;
 NOC_SUPPRESS_DLL_WARNINGS
 
@@ -40,14 +56,33 @@ class NOC_EXPORT IRenderer
     /// Block until all GPU work is finished. Call before shutdown.
     virtual void wait_idle() noexcept = 0;
 
+    /// Block until the next draw_frame() can start without waiting on the GPU: its frame slot is free and,
+    /// where presents can be waited on, no more than one earlier frame is still queued for display.
+    /// Call at the top of the frame, before input is sampled; the input-to-present estimate starts here.
+    virtual void wait_for_next_frame() noexcept = 0;
+
+    virtual FrameLatencyStats get_frame_latency_stats() const noexcept = 0;
+
     /// Upload CPU-side mesh data to GPU buffers. Returns an opaque mesh index.
     /// The MeshData must have been loaded via AssetManager beforehand.
+    /// The copy is queued, not waited on; the index is usable right away and the
+    /// renderer makes sure the data has landed before a frame samples it.
     virtual Result<std::uint32_t> upload_mesh(const MeshData& meshData) = 0;
 
     /// Upload CPU-side texture data to GPU image. Returns an opaque texture index.
     /// The TextureData must have been loaded via AssetManager beforehand.
+    /// Queued like upload_mesh().
     virtual Result<std::uint32_t> upload_texture(const TextureData& textureData) = 0;
 
+    /// Submit every upload queued since the last flush. Returns a ticket for the submitted work.
+    virtual Result<UploadTicket> flush_uploads() = 0;
+
+    /// Block until the uploads covered by `ticket` have completed on the GPU.
+    virtual Result<> wait_for_uploads(UploadTicket ticket) = 0;
+
+    /// Non-blocking check whether the uploads covered by `ticket` have completed.
+    virtual bool is_upload_complete(UploadTicket ticket) noexcept = 0;
+
     /// Create a GPU material from texture indices. Returns an opaque material index.
     /// Texture indices must be valid indices from upload_texture().
     virtual Result<std::uint32_t> upload_material(
@@ -64,6 +99,23 @@ class NOC_EXPORT IRenderer
     /// Set the list of renderables to draw this frame.
     virtual void set_renderables(const std::vector<Renderable>& renderables) noexcept = 0;
 
+    /// Apply an incremental change to the renderables set by earlier calls.
+    /// Cost scales with the size of the delta rather than with the scene.
+    virtual void update_renderables(const RenderableDelta& delta) noexcept = 0;
+
+    // --- Lighting ---
+
+    /// Set the lights for this frame. The first directional light replaces the default sun; point and
+    /// spot lights are binned into view-space clusters on the GPU. Only changed lights are re-uploaded.
+    virtual void set_lights(std::span<const Light> lights) noexcept = 0;
+
+    // --- Debug overlay ---
+
+    /// Set the wireframe debug primitives drawn into the scene from now on, replacing the previous
+    /// list; an empty list draws nothing. They are drawn at the end of the scene pass with one
+    /// instanced call per depth mode, however many there are.
+    virtual void set_debug_draw(const DebugDrawList& list) noexcept = 0;
+
     /// Returns local-space mesh bounds for debug/editor overlays.
     virtual MeshBounds get_mesh_bounds(std::uint32_t meshIndex) const noexcept = 0;
 
@@ -118,6 +170,90 @@ class NOC_EXPORT IRenderer
     /// Get current render resolution scale.
     virtual float get_render_scale() const noexcept = 0;
 
+    // --- GPU-driven culling ---
+
+    /// Enable/disable compute-shader frustum culling with indirect draws.
+    /// Stays on the CPU culling path when the device lacks the required features.
+    virtual void set_gpu_culling_enabled(bool enabled) noexcept = 0;
+    virtual bool get_gpu_culling_enabled() const noexcept = 0;
+
+    /// Enable/disable occlusion culling against a hierarchical-Z pyramid of the previous frame's depth.
+    /// Works with both culling paths; objects revealed by fast camera motion may appear a frame late.
+    virtual void set_occlusion_culling_enabled(bool enabled) noexcept = 0;
+    virtual bool get_occlusion_culling_enabled() const noexcept = 0;
+
+    // --- Depth prepass ---
+
+    /// Enable/disable a depth-only prepass over the opaque scene. The color pass then depth-tests EQUAL,
+    /// so the material shader runs once per covered sample instead of once per overlapping surface.
+    virtual void set_depth_prepass_enabled(bool enabled) noexcept = 0;
+    virtual bool get_depth_prepass_enabled() const noexcept = 0;
+
+    // --- Level of detail ---
+
+    /// Scale (0.25 to 4.0) of the on-screen error a mesh LOD may show. 1.0 allows about one pixel;
+    /// larger values switch to coarser levels sooner.
+    virtual void set_lod_bias(float bias) noexcept = 0;
+    virtual float get_lod_bias() const noexcept = 0;
+
+    // --- Sun shadows ---
+
+    /// Enable/disable cascaded shadow maps for the sun. Distant cascades are cached and only re-rendered
+    /// when the camera moves far enough or static geometry inside them changes; they hold static casters only.
+    virtual void set_shadows_enabled(bool enabled) noexcept = 0;
+    virtual bool get_shadows_enabled() const noexcept = 0;
+
+    /// Size in texels of each cascade (512 to 4096, rounded down to a power of two).
+    virtual void set_shadow_map_resolution(std::uint32_t resolution) noexcept = 0;
+    virtual std::uint32_t get_shadow_map_resolution() const noexcept = 0;
+
+    /// Number of cascades the shadow distance is split into (1 to 4).
+    virtual void set_shadow_cascade_count(std::uint32_t count) noexcept = 0;
+    virtual std::uint32_t get_shadow_cascade_count() const noexcept = 0;
+
+    // --- Command recording ---
+
+    /// Enable/disable recording the scene pass's draws into secondary command buffers on worker threads.
+    /// Only frames with enough batches to split are recorded in parallel; small scenes stay inline.
+    virtual void set_parallel_recording_enabled(bool enabled) noexcept = 0;
+    virtual bool get_parallel_recording_enabled() const noexcept = 0;
+
+    // --- Dynamic resolution ---
+
+    /// Enable/disable scaling the render resolution each frame to hold a GPU frame time target.
+    /// Attachments are allocated once at the maximum scale and only the viewport inside them moves;
+    /// the render scale setting is ignored while this is on.
+    virtual void set_dynamic_resolution_enabled(bool enabled) noexcept = 0;
+    virtual bool get_dynamic_resolution_enabled() const noexcept = 0;
+
+    /// GPU frame time in milliseconds the scale is steered toward.
+    virtual void set_dynamic_resolution_target_ms(float milliseconds) noexcept = 0;
+    virtual float get_dynamic_resolution_target_ms() const noexcept = 0;
+
+    /// Bounds of the scale (0.25 to 1.0; 0.5 to 1.0 while NIS upscales). Changing the maximum reallocates.
+    virtual void set_dynamic_resolution_scale_range(float minScale, float maxScale) noexcept = 0;
+    virtual float get_dynamic_resolution_min_scale() const noexcept = 0;
+    virtual float get_dynamic_resolution_max_scale() const noexcept = 0;
+
+    /// Fraction (0.01 to 1.0) of the distance to the ideal scale covered per frame. Lower is steadier.
+    virtual void set_dynamic_resolution_response(float response) noexcept = 0;
+    virtual float get_dynamic_resolution_response() const noexcept = 0;
+
+    /// Scale the current frame renders at (the render scale while dynamic resolution is off).
+    virtual float get_dynamic_resolution_scale() const noexcept = 0;
+
+    // --- Texture streaming ---
+
+    /// Enable/disable streaming cooked textures' mip chains. While on, textures start with their coarse
+    /// levels and finer ones are loaded for what is on screen; while off, every level is loaded.
+    virtual void set_texture_streaming_enabled(bool enabled) noexcept = 0;
+    virtual bool get_texture_streaming_enabled() const noexcept = 0;
+
+    /// Fraction (0.25 to 0.95) of the driver-reported device-local budget streaming keeps usage under;
+    /// above it, levels finer than what is on screen are evicted first. Ignored without VK_EXT_memory_budget.
+    virtual void set_texture_streaming_budget_fraction(float fraction) noexcept = 0;
+    virtual float get_texture_streaming_budget_fraction() const noexcept = 0;
+
     // --- Shader management ---
 
     /// Set the paths to the GLSL vertex and fragment shader source files.
@@ -130,6 +266,20 @@ class NOC_EXPORT IRenderer
     /// Recompile shaders from the current shader source paths.
     /// Rebuilds the graphics pipeline with the newly compiled SPIR-V.
     virtual Result<> recompile_shaders() = 0;
+
+    /// Watches the shader sources (and the files they include) and reloads them when they change.
+    virtual void set_shader_hot_reload(bool enabled) = 0;
+    virtual bool get_shader_hot_reload() const noexcept = 0;
+
+    /// Compiles the shader sources and builds the new pipeline in the background. The old pipeline
+    /// keeps drawing until the new one replaces it at a frame boundary; no device idle is needed.
+    virtual void request_shader_reload() noexcept = 0;
+
+    /// True while a background reload is compiling or building.
+    virtual bool is_shader_reload_pending() const noexcept = 0;
+
+    /// Outcome of the last background reload (requested or hot), returned once.
+    virtual std::optional<Result<>> poll_shader_reload() = 0;
 };
 
 NOC_RESTORE_DLL_WARNINGS
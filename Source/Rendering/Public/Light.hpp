@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+#include <DirectXMath.h>
+
+/// Kind of light source. Directional lights reach every pixel; point and spot lights have a range
+/// and are binned into view-space clusters so a pixel only evaluates the ones that can reach it.
+enum class LightType : std::uint8_t
+{
+    Directional = 0,
+    Point = 1,
+    Spot = 2,
+};
+
+/// A light in world space: the output of World::collect_lights() and the input to the renderer.
+struct Light
+{
+    DirectX::XMFLOAT3 position{};
+    float range{10.0f};                             // point/spot: distance at which the light has faded out
+    DirectX::XMFLOAT3 direction{0.0f, 0.0f, -1.0f}; // unit vector the light travels along (spot, directional)
+    LightType type{LightType::Point};
+    DirectX::XMFLOAT3 color{1.0f, 1.0f, 1.0f};      // linear color * intensity
+    float innerConeCos{1.0f};                       // spot: full intensity inside this cone
+    float outerConeCos{0.0f};                       // spot: no light outside this cone
+};
@@ -1,11 +1,18 @@
 
 #pragma once
+#include "../../Core/Public/Core.hpp"
+
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <vector>
 
 #include <vulkan/vulkan.h>
 
+#include "../BackEnds/Public/VulkanAllocator.hpp"
+#include "../BackEnds/Public/VulkanGeometryArena.hpp"
+
 #include <DirectXMath.h>
 
 using namespace DirectX;
@@ -62,34 +69,103 @@ struct Vertex
     }
 };
 
-struct Mesh
+/// GPU vertex layout (24 bytes, half of Vertex). Positions stay float; normal and tangent are
+/// octahedral-encoded in 2 x snorm16 each, with the bitangent sign folded into the sign of the
+/// tangent's second component; UVs are half floats. Decoded in shader.vert.
+struct NOC_EXPORT PackedVertex
 {
-    VkBuffer vertexBuffer{};
-    VkDeviceMemory vertexBufferMemory{};
-    VkBuffer indexBuffer{};
-    VkDeviceMemory indexBufferMemory{};
+    XMFLOAT3 pos{};
+    std::int16_t normal[2]{};
+    std::int16_t tangent[2]{};
+    std::uint16_t texCoord[2]{}; // IEEE 754 binary16
+
+    static PackedVertex pack(const Vertex& vertex) noexcept;
+    Vertex unpack() const noexcept;
+
+    static VkVertexInputBindingDescription getBindingDescription()
+    {
+        VkVertexInputBindingDescription bindingDescription{};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(PackedVertex);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        return bindingDescription;
+    }
+
+    /// Same locations as Vertex::getAttributeDescriptions(), compact formats.
+    static std::array<VkVertexInputAttributeDescription, 4> getAttributeDescriptions()
+    {
+        std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions{};
+
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(PackedVertex, pos);
+
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R16G16_SNORM;
+        attributeDescriptions[1].offset = offsetof(PackedVertex, normal);
+
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R16G16_SFLOAT;
+        attributeDescriptions[2].offset = offsetof(PackedVertex, texCoord);
+
+        attributeDescriptions[3].binding = 0;
+        attributeDescriptions[3].location = 3;
+        attributeDescriptions[3].format = VK_FORMAT_R16G16_SNORM;
+        attributeDescriptions[3].offset = offsetof(PackedVertex, tangent);
+
+        return attributeDescriptions;
+    }
+};
+static_assert(sizeof(PackedVertex) == 24);
+
+/// Maximum number of detail levels per mesh, LOD 0 included.
+inline constexpr std::uint32_t MaxMeshLods{4};
+
+/// One level of detail: a range of the mesh's indices and how far it strays from LOD 0.
+struct MeshLod
+{
+    std::uint32_t firstIndex{};
     std::uint32_t indexCount{};
+    float error{}; // object-space deviation from LOD 0 relative to the bounding-sphere radius
+};
+
+/// A mesh's geometry lives in the renderer's VulkanGeometryArena. LOD index ranges are relative to the
+/// mesh, so a draw uses geometry.firstIndex + lod.firstIndex and geometry.firstVertex as vertexOffset.
+struct Mesh
+{
+    GeometryRange geometry{};
+    std::uint32_t indexCount{}; // LOD 0
+    std::array<MeshLod, MaxMeshLods> lods{};
+    std::uint32_t lodCount{1};
     XMFLOAT3 boundsMin{};
     XMFLOAT3 boundsMax{};
     XMFLOAT3 boundsCenter{};
     float boundsRadius{};
-    VkDeviceSize vertexBufferBytes{};
-    VkDeviceSize indexBufferBytes{};
-    VkDeviceSize vertexBufferAllocationBytes{};
-    VkDeviceSize indexBufferAllocationBytes{};
 };
 
 struct GpuTexture
 {
     VkImage image{};
-    VkDeviceMemory memory{};
+    VulkanAllocation allocation{};
     VkImageView imageView{};
     std::uint32_t width{};
     std::uint32_t height{};
     VkDeviceSize allocationBytes{};
 };
 
+/// Material record in the bindless material buffer (std430, read by shader.frag).
+/// Texture fields index the global texture array; packedOrm is set when roughness,
+/// metallic and AO share one ORM texture (R = AO, G = roughness, B = metallic).
 struct GpuMaterial
 {
-    VkDescriptorSet descriptorSet{};
+    std::uint32_t albedoTexture{};
+    std::uint32_t normalTexture{};
+    std::uint32_t roughnessTexture{};
+    std::uint32_t metallicTexture{};
+    std::uint32_t aoTexture{};
+    std::uint32_t packedOrm{};
+    std::uint32_t padding[2]{};
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace tf
+{
+class Executor;
+}
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// CPU occlusion culling against a hierarchical-Z (max-depth) pyramid of an earlier frame.
+/// A sphere is projected as its world-space bounding box with the view-projection the depth was
+/// rendered with; the pyramid level where that footprint spans at most 2x2 texels is read, and the
+/// sphere is occluded when its nearest depth lies behind the farthest stored depth.
+/// Footprints that leave the viewport or cross the near plane are always kept.
+class NOC_EXPORT OcclusionCuller
+{
+  public:
+    /// Visibility flag cull() writes for occluded items, distinct from a frustum-culled 0.
+    static constexpr std::uint8_t Occluded{2};
+    /// Spheres per parallel task; smaller inputs are tested on the calling thread.
+    static constexpr std::size_t ParallelChunkSize{4096};
+
+    /// Replaces the pyramid with `depth`, a width x height max-depth image (depth 0..1, near to far)
+    /// whose texels each cover a 2^texelShift square of pixels, and builds its coarser levels down to 1x1.
+    /// The viewport the depth was rendered with is viewportWidth x viewportHeight pixels at the image's
+    /// top-left; it may be smaller than the area the image covers.
+    void set_depth(std::span<const float> depth, std::uint32_t width, std::uint32_t height, std::uint32_t texelShift,
+                   std::uint32_t viewportWidth, std::uint32_t viewportHeight, const DirectX::XMFLOAT4X4& viewProj);
+
+    /// True when a world-space sphere (center xyz, radius w) is hidden behind the stored depth.
+    bool is_occluded(const DirectX::XMFLOAT4& sphere) const noexcept;
+
+    /// Sets visible[i] to Occluded for every item with visible[i] == 1 whose sphere is occluded.
+    /// Returns the number of items marked.
+    std::uint32_t cull(std::span<const DirectX::XMFLOAT4> spheres, std::vector<std::uint8_t>& visible,
+                       tf::Executor* executor = nullptr) const;
+
+    void clear() noexcept;
+
+    inline bool has_depth() const noexcept
+    {
+        return !m_levels.empty();
+    }
+
+  private:
+    struct Level
+    {
+        std::uint32_t width{};
+        std::uint32_t height{};
+        std::vector<float> depth{};
+    };
+
+    std::uint32_t cull_range(std::span<const DirectX::XMFLOAT4> spheres, std::uint8_t* visible, std::size_t begin,
+                             std::size_t end) const noexcept;
+
+    std::vector<Level> m_levels{};
+    DirectX::XMFLOAT4X4 m_viewProj{};
+    std::uint32_t m_viewportWidth{};
+    std::uint32_t m_viewportHeight{};
+    std::uint32_t m_texelShift{}; // log2 of the viewport pixels per level-0 texel
+};
+
+NOC_RESTORE_DLL_WARNINGS
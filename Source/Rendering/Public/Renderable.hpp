@@ -1,16 +1,59 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <span>
 
 #include <DirectXMath.h>
 
+/// Packs a non-negative HDR color into the shared-exponent RGB9E5 layout
+/// (9-bit mantissas, 5-bit exponent with bias 15; same bits as VK_FORMAT_E5B9G9R9_UFLOAT_PACK32).
+inline std::uint32_t pack_rgb9e5(const DirectX::XMFLOAT3& color) noexcept
+{
+    constexpr int MantissaBits{9};
+    constexpr int ExponentBias{15};
+    constexpr float MaxValue{65408.0f}; // 511/512 * 2^16
+
+    const float r = std::clamp(color.x, 0.0f, MaxValue);
+    const float g = std::clamp(color.y, 0.0f, MaxValue);
+    const float b = std::clamp(color.z, 0.0f, MaxValue);
+    const float maxComponent = std::max(r, std::max(g, b));
+    if (!(maxComponent > 0.0f))
+        return 0;
+
+    int exponent = std::max(-ExponentBias - 1, static_cast<int>(std::floor(std::log2(maxComponent)))) + 1 + ExponentBias;
+    float scale = std::exp2(static_cast<float>(exponent - ExponentBias - MantissaBits));
+    if (static_cast<std::uint32_t>(std::floor(maxComponent / scale + 0.5f)) == (1u << MantissaBits))
+    {
+        ++exponent;
+        scale *= 2.0f;
+    }
+
+    const auto mantissa = [scale](float value) { return static_cast<std::uint32_t>(std::floor(value / scale + 0.5f)); };
+    return mantissa(r) | mantissa(g) << 9 | mantissa(b) << 18 | static_cast<std::uint32_t>(exponent) << 27;
+}
+
 /// A renderable instance: a world transform paired with mesh and material indices.
-/// This is the output of Scene::collect_renderables() and the input to the renderer.
+/// This is the output of World::collect_renderables() and the input to the renderer.
 struct Renderable
 {
-    DirectX::XMFLOAT4X4 worldMatrix{};
+    DirectX::XMFLOAT3X4 worldMatrix{}; // affine world matrix, transposed (XMStoreFloat3x4); translation in _14/_24/_34
     uint32_t meshIndex{};
     uint32_t materialIndex{};
     uint32_t entityId{};
-    DirectX::XMFLOAT3 glowColor{1.0f, 0.7f, 0.25f};
-    float glowIntensity{0.0f};
+    uint32_t glow{};      // glow color * intensity as RGB9E5 (pack_rgb9e5), 0 = no glow
+    bool isStatic{false}; // hint: transform is not expected to change (no script or moving body)
+};
+
+/// Incremental renderable update: `changed` holds added or modified renderables (matched by
+/// entityId), `removedEntityIds` the entities that no longer render. Removals apply first.
+struct RenderableDelta
+{
+    std::span<const Renderable> changed{};
+    std::span<const std::uint32_t> removedEntityIds{};
+
+    bool empty() const noexcept
+    {
+        return changed.empty() && removedEntityIds.empty();
+    }
 };
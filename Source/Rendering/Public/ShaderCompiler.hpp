@@ -43,6 +43,16 @@ class NOC_EXPORT ShaderCompiler
     /// @param glslPath    Path to the .vert / .frag file.
     static Result<std::vector<std::uint32_t>> compile_file(const std::filesystem::path& glslPath);
 
+    /// Reads a GLSL file and compiles it with shaderc resolving its #include directives: relative
+    /// to the including file first, then through `includeDirs`. When `dependencies` is given, the
+    /// source and every file it included are appended to it (for change watching).
+    /// Safe to call from any thread.
+    static Result<std::vector<std::uint32_t>> compile_file_with_includes(
+        const std::filesystem::path& glslPath,
+        const std::vector<std::filesystem::path>& includeDirs,
+        std::vector<std::filesystem::path>* dependencies = nullptr
+    );
+
     /// Compiles a GLSL file to SPIR-V, writing the result to spvPath.
     /// If spvPath already exists and is newer than glslPath, reads the cached .spv instead.
     /// @param glslPath    Path to the GLSL source file.
@@ -69,7 +79,7 @@ class NOC_EXPORT ShaderCompiler
     );
 
     /// Compiles a GLSL compute shader that uses #include directives.
-    /// Resolves includes by searching the given directories.
+    /// Resolves includes like compile_file_with_includes().
     /// @param glslPath      Path to the .glsl / .comp file.
     /// @param includeDirs   Directories to search for included files.
     static Result<std::vector<std::uint32_t>> compile_compute_with_includes(
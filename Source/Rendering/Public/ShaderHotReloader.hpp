@@ -0,0 +1,74 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "../../Core/Public/Expected.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Recompiles the scene vertex/fragment shader pair with one background job per stage.
+/// While watching, poll() checks the write times of both sources and of every file they
+/// included in the last compile (at most once per PollInterval) and starts a compile when one
+/// changed. Render-thread only; the compiles themselves run on JobSystem workers.
+class NOC_EXPORT ShaderHotReloader
+{
+  public:
+    struct CompiledShaders
+    {
+        std::vector<std::uint32_t> vertSpirv{};
+        std::vector<std::uint32_t> fragSpirv{};
+    };
+
+    static constexpr std::chrono::milliseconds PollInterval{500};
+
+    ShaderHotReloader() = default;
+    ~ShaderHotReloader();
+
+    ShaderHotReloader(const ShaderHotReloader&) = delete;
+    ShaderHotReloader& operator=(const ShaderHotReloader&) = delete;
+
+    /// Sets the pair to compile. Forgets the watched dependency list until the next compile.
+    void set_sources(const std::filesystem::path& vertPath, const std::filesystem::path& fragPath);
+
+    void set_watching(bool enabled);
+    bool is_watching() const noexcept { return m_watching; }
+
+    /// Compiles the current sources on the next poll(), watching or not.
+    void request_compile() noexcept { m_requested = true; }
+
+    /// True while a compile is running.
+    bool is_compiling() const noexcept;
+
+    /// Starts a compile when one was requested or a watched file changed, and hands out the
+    /// result of a finished compile exactly once. A change seen while a compile runs starts
+    /// another one after it completes.
+    std::optional<Result<CompiledShaders>> poll();
+
+    /// Blocks until a running compile has finished. Its result is still returned by poll().
+    void wait();
+
+  private:
+    struct PendingCompile;
+
+    using WatchedFile = std::pair<std::filesystem::path, std::filesystem::file_time_type>;
+
+    void start_compile();
+    bool watched_files_changed() const;
+    static std::vector<WatchedFile> stamp(const std::vector<std::filesystem::path>& files);
+
+    std::filesystem::path m_vertPath{};
+    std::filesystem::path m_fragPath{};
+    std::vector<WatchedFile> m_watched{};
+    std::chrono::steady_clock::time_point m_nextCheck{};
+    bool m_watching{false};
+    bool m_requested{false};
+    std::shared_ptr<PendingCompile> m_pending{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,288 @@
+#include "../Public/Benchmark.hpp"
+#include "../../ECS/Public/Components.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace DirectX;
+
+namespace
+{
+float catmull_rom(float p0, float p1, float p2, float p3, float u) noexcept
+{
+    const float u2 = u * u;
+    const float u3 = u2 * u;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * u + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u2 +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * u3);
+}
+
+/// Nearest-rank percentiles over an unsorted copy of the values.
+BenchmarkPercentiles make_percentiles(std::vector<double> values)
+{
+    BenchmarkPercentiles result{};
+    if (values.empty())
+        return result;
+
+    std::sort(values.begin(), values.end());
+    const auto rank = [&](double fraction) {
+        const auto index = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(values.size())));
+        return values[std::clamp<std::size_t>(index, 1, values.size()) - 1];
+    };
+
+    double sum{};
+    for (double value : values)
+        sum += value;
+
+    result.minimum = values.front();
+    result.mean = sum / static_cast<double>(values.size());
+    result.p50 = rank(0.50);
+    result.p90 = rank(0.90);
+    result.p95 = rank(0.95);
+    result.p99 = rank(0.99);
+    result.maximum = values.back();
+    return result;
+}
+
+std::string format_percentiles(const BenchmarkPercentiles& percentiles)
+{
+    return fmt::format("{{\"min\":{:.4f},\"mean\":{:.4f},\"p50\":{:.4f},\"p90\":{:.4f},\"p95\":{:.4f},\"p99\":{:.4f},"
+                       "\"max\":{:.4f}}}",
+                       percentiles.minimum, percentiles.mean, percentiles.p50, percentiles.p90, percentiles.p95,
+                       percentiles.p99, percentiles.maximum);
+}
+
+std::string escape_json(std::string_view text)
+{
+    std::string escaped{};
+    escaped.reserve(text.size());
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            escaped += c;
+    }
+    return escaped;
+}
+} // namespace
+
+Result<BenchmarkScenario> BenchmarkScenario::load(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+        return make_error(fmt::format("Failed to open benchmark scenario: {}", path.string()), ErrorCode::FileReadFailed);
+
+    BenchmarkScenario scenario{};
+    scenario.name = path.stem().string();
+
+    std::string line{};
+    for (std::uint32_t lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        if (const auto comment = line.find('#'); comment != std::string::npos)
+            line.erase(comment);
+
+        std::istringstream stream{line};
+        std::string keyword{};
+        if (!(stream >> keyword))
+            continue;
+
+        bool valid{true};
+        if (keyword == "name")
+        {
+            valid = static_cast<bool>(stream >> scenario.name);
+        }
+        else if (keyword == "level")
+        {
+            std::string level{};
+            valid = static_cast<bool>(stream >> level);
+            scenario.levelFile = level;
+        }
+        else if (keyword == "warmup")
+        {
+            valid = static_cast<bool>(stream >> scenario.warmupFrames);
+        }
+        else if (keyword == "frames")
+        {
+            valid = static_cast<bool>(stream >> scenario.frameCount) && scenario.frameCount > 0;
+        }
+        else if (keyword == "timestep")
+        {
+            valid = static_cast<bool>(stream >> scenario.timestep) && scenario.timestep > 0.0f;
+        }
+        else if (keyword == "key")
+        {
+            CameraKeyframe key{};
+            float yawDegrees{};
+            float pitchDegrees{};
+            valid = static_cast<bool>(stream >> key.time >> key.target.x >> key.target.y >> key.target.z >> key.distance >>
+                                      yawDegrees >> pitchDegrees) &&
+                    key.distance > 0.0f &&
+                    (scenario.cameraPath.empty() || key.time > scenario.cameraPath.back().time);
+            key.yaw = XMConvertToRadians(yawDegrees);
+            key.pitch = XMConvertToRadians(pitchDegrees);
+            scenario.cameraPath.push_back(key);
+        }
+        else
+        {
+            return make_error(fmt::format("{}:{}: unknown benchmark keyword '{}'", path.string(), lineNumber, keyword),
+                              ErrorCode::AssetInvalidData);
+        }
+
+        if (!valid)
+            return make_error(fmt::format("{}:{}: invalid '{}' entry", path.string(), lineNumber, keyword),
+                              ErrorCode::AssetInvalidData);
+    }
+
+    return scenario;
+}
+
+void BenchmarkScenario::sample_camera(float time, CameraComponent& camera) const noexcept
+{
+    if (cameraPath.empty())
+        return;
+
+    const auto apply = [&](const CameraKeyframe& key) {
+        camera.target = key.target;
+        camera.distance = key.distance;
+        camera.yaw = key.yaw;
+        camera.pitch = key.pitch;
+    };
+    if (time <= cameraPath.front().time)
+        return apply(cameraPath.front());
+    if (time >= cameraPath.back().time)
+        return apply(cameraPath.back());
+
+    // Segment [i, i + 1] containing `time`; the outer control points repeat at the ends.
+    const auto next = std::upper_bound(cameraPath.begin(), cameraPath.end(), time,
+                                       [](float t, const CameraKeyframe& key) { return t < key.time; });
+    const std::size_t i = static_cast<std::size_t>(next - cameraPath.begin()) - 1;
+    const CameraKeyframe& k0 = cameraPath[i > 0 ? i - 1 : 0];
+    const CameraKeyframe& k1 = cameraPath[i];
+    const CameraKeyframe& k2 = cameraPath[i + 1];
+    const CameraKeyframe& k3 = cameraPath[std::min(i + 2, cameraPath.size() - 1)];
+    const float u = (time - k1.time) / (k2.time - k1.time);
+
+    camera.target.x = catmull_rom(k0.target.x, k1.target.x, k2.target.x, k3.target.x, u);
+    camera.target.y = catmull_rom(k0.target.y, k1.target.y, k2.target.y, k3.target.y, u);
+    camera.target.z = catmull_rom(k0.target.z, k1.target.z, k2.target.z, k3.target.z, u);
+    camera.distance = std::max(catmull_rom(k0.distance, k1.distance, k2.distance, k3.distance, u), 0.01f);
+    camera.yaw = catmull_rom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, u);
+    camera.pitch = catmull_rom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, u);
+}
+
+//    BenchmarkRecorder
+
+void BenchmarkRecorder::reserve(std::uint32_t frameCount)
+{
+    m_samples.reserve(frameCount);
+}
+
+void BenchmarkRecorder::add(const BenchmarkFrameSample& sample)
+{
+    m_samples.push_back(sample);
+}
+
+BenchmarkPercentiles BenchmarkRecorder::get_cpu_frame_percentiles() const
+{
+    std::vector<double> values{};
+    values.reserve(m_samples.size());
+    for (const BenchmarkFrameSample& sample : m_samples)
+        values.push_back(sample.cpuFrameMs);
+    return make_percentiles(std::move(values));
+}
+
+BenchmarkPercentiles BenchmarkRecorder::get_gpu_frame_percentiles() const
+{
+    std::vector<double> values{};
+    values.reserve(m_samples.size());
+    for (const BenchmarkFrameSample& sample : m_samples)
+    {
+        if (sample.gpuFrameMs > 0.0f)
+            values.push_back(sample.gpuFrameMs);
+    }
+    return make_percentiles(std::move(values));
+}
+
+BenchmarkPercentiles BenchmarkRecorder::get_input_to_present_percentiles() const
+{
+    std::vector<double> values{};
+    values.reserve(m_samples.size());
+    for (const BenchmarkFrameSample& sample : m_samples)
+    {
+        if (sample.inputToPresentMs > 0.0f)
+            values.push_back(sample.inputToPresentMs);
+    }
+    return make_percentiles(std::move(values));
+}
+
+Result<> BenchmarkRecorder::write_csv(const std::filesystem::path& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open())
+        return make_error(fmt::format("Failed to open benchmark output for writing: {}", path.string()),
+                          ErrorCode::FileWriteFailed);
+
+    file << "frame,cpu_ms,gpu_ms,draw_calls,instanced_batches,visible,culled,occluded,tracked_memory_bytes,device_local_usage_bytes,heap_allocations,input_to_present_ms\n";
+    for (const BenchmarkFrameSample& sample : m_samples)
+    {
+        file << fmt::format("{},{:.4f},{:.4f},{},{},{},{},{},{},{},{},{:.4f}\n", sample.frame, sample.cpuFrameMs,
+                            sample.gpuFrameMs, sample.drawCalls, sample.instancedBatches, sample.visibleRenderables,
+                            sample.culledRenderables, sample.occludedRenderables, sample.trackedMemoryBytes,
+                            sample.deviceLocalUsageBytes, sample.heapAllocations, sample.inputToPresentMs);
+    }
+
+    if (!file.good())
+        return make_error(fmt::format("Failed to write benchmark output: {}", path.string()), ErrorCode::FileWriteFailed);
+    return {};
+}
+
+Result<> BenchmarkRecorder::write_summary_json(const std::filesystem::path& path, const BenchmarkScenario& scenario,
+                                               std::string_view gpuName) const
+{
+    std::uint64_t peakTrackedMemory{};
+    std::uint64_t peakDeviceLocalUsage{};
+    std::uint64_t peakHeapAllocations{};
+    double drawCallSum{};
+    double culledSum{};
+    double occludedSum{};
+    for (const BenchmarkFrameSample& sample : m_samples)
+    {
+        peakTrackedMemory = std::max(peakTrackedMemory, sample.trackedMemoryBytes);
+        peakDeviceLocalUsage = std::max(peakDeviceLocalUsage, sample.deviceLocalUsageBytes);
+        peakHeapAllocations = std::max(peakHeapAllocations, sample.heapAllocations);
+        drawCallSum += sample.drawCalls;
+        culledSum += sample.culledRenderables;
+        occludedSum += sample.occludedRenderables;
+    }
+    const double frameCount = m_samples.empty() ? 1.0 : static_cast<double>(m_samples.size());
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open())
+        return make_error(fmt::format("Failed to open benchmark summary for writing: {}", path.string()),
+                          ErrorCode::FileWriteFailed);
+
+    file << "{\n";
+    file << fmt::format("  \"scenario\": \"{}\",\n", escape_json(scenario.name));
+    file << fmt::format("  \"gpu\": \"{}\",\n", escape_json(gpuName));
+    file << fmt::format("  \"frames\": {},\n", m_samples.size());
+    file << fmt::format("  \"warmup_frames\": {},\n", scenario.warmupFrames);
+    file << fmt::format("  \"timestep\": {:.6f},\n", scenario.timestep);
+    file << fmt::format("  \"cpu_ms\": {},\n", format_percentiles(get_cpu_frame_percentiles()));
+    file << fmt::format("  \"gpu_ms\": {},\n", format_percentiles(get_gpu_frame_percentiles()));
+    file << fmt::format("  \"input_to_present_ms\": {},\n", format_percentiles(get_input_to_present_percentiles()));
+    file << fmt::format("  \"mean_draw_calls\": {:.2f},\n", drawCallSum / frameCount);
+    file << fmt::format("  \"mean_culled\": {:.2f},\n", culledSum / frameCount);
+    file << fmt::format("  \"mean_occluded\": {:.2f},\n", occludedSum / frameCount);
+    file << fmt::format("  \"peak_tracked_memory_bytes\": {},\n", peakTrackedMemory);
+    file << fmt::format("  \"peak_device_local_usage_bytes\": {},\n", peakDeviceLocalUsage);
+    file << fmt::format("  \"peak_heap_allocations\": {}\n", peakHeapAllocations);
+    file << "}\n";
+
+    if (!file.good())
+        return make_error(fmt::format("Failed to write benchmark summary: {}", path.string()), ErrorCode::FileWriteFailed);
+    return {};
+}
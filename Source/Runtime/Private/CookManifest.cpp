@@ -0,0 +1,189 @@
+#include "CookManifest.hpp"
+
+#include "../../Core/Public/ContentHash.hpp"
+#include "../../Core/Public/MappedFile.hpp"
+
+#include <CookManifestAsset_generated.h>
+#include <flatbuffers/flatbuffers.h>
+#include <fmt/core.h>
+
+#include <fstream>
+
+namespace
+{
+namespace fb = NatureOfCraft::Assets;
+
+std::vector<std::string> read_strings(const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>* strings)
+{
+    std::vector<std::string> values{};
+    if (!strings)
+        return values;
+    values.reserve(strings->size());
+    for (const auto* value : *strings)
+        values.push_back(value ? value->str() : std::string{});
+    return values;
+}
+} // namespace
+
+std::filesystem::path CookManifest::get_path(const std::filesystem::path& outputRoot)
+{
+    return outputRoot / "cook_manifest.noc_manifest";
+}
+
+Result<CookManifest> CookManifest::read(const std::filesystem::path& path)
+{
+    auto mappedResult = MappedFile::open(path);
+    if (!mappedResult)
+        return make_error(mappedResult.error());
+
+    const MappedFile& mapped = mappedResult.value();
+    flatbuffers::Verifier verifier(mapped.data(), mapped.size());
+    if (!fb::VerifyCookManifestAssetBuffer(verifier))
+        return make_error(fmt::format("Invalid cook manifest: {}", path.string()), ErrorCode::AssetCacheReadFailed);
+
+    const auto* asset = fb::GetCookManifestAsset(mapped.data());
+    if (asset->version() != Version)
+        return make_error(fmt::format("Cook manifest '{}' has version {}, expected {}", path.string(), asset->version(), Version),
+                          ErrorCode::AssetCacheReadFailed);
+
+    CookManifest manifest{};
+    manifest.optionsHash = asset->options_hash();
+    if (!asset->steps())
+        return manifest;
+
+    manifest.steps.reserve(asset->steps()->size());
+    for (const auto* stepAsset : *asset->steps())
+    {
+        if (!stepAsset->key())
+            continue;
+
+        CookManifestStep step{};
+        if (stepAsset->inputs())
+        {
+            step.inputs.reserve(stepAsset->inputs()->size());
+            for (const auto* input : *stepAsset->inputs())
+            {
+                step.inputs.push_back(CookManifestInput{
+                    input->path() ? input->path()->str() : std::string{},
+                    input->size(),
+                    input->write_time(),
+                    input->hash(),
+                });
+            }
+        }
+        step.outputs = read_strings(stepAsset->outputs());
+        step.textures = read_strings(stepAsset->textures());
+        step.value = stepAsset->value() ? stepAsset->value()->str() : std::string{};
+        step.textureSlot = stepAsset->texture_slot();
+        manifest.steps.insert_or_assign(stepAsset->key()->str(), std::move(step));
+    }
+    return manifest;
+}
+
+Result<> CookManifest::write(const std::filesystem::path& path) const
+{
+    flatbuffers::FlatBufferBuilder builder(64 * 1024);
+    std::vector<flatbuffers::Offset<fb::CookManifestStep>> stepOffsets{};
+    stepOffsets.reserve(steps.size());
+
+    for (const auto& [key, step] : steps)
+    {
+        std::vector<flatbuffers::Offset<fb::CookManifestInput>> inputOffsets{};
+        inputOffsets.reserve(step.inputs.size());
+        for (const CookManifestInput& input : step.inputs)
+            inputOffsets.push_back(
+                fb::CreateCookManifestInputDirect(builder, input.path.c_str(), input.size, input.writeTime, input.hash));
+
+        std::vector<flatbuffers::Offset<flatbuffers::String>> outputOffsets{};
+        outputOffsets.reserve(step.outputs.size());
+        for (const std::string& output : step.outputs)
+            outputOffsets.push_back(builder.CreateString(output));
+
+        std::vector<flatbuffers::Offset<flatbuffers::String>> textureOffsets{};
+        textureOffsets.reserve(step.textures.size());
+        for (const std::string& texture : step.textures)
+            textureOffsets.push_back(builder.CreateString(texture));
+
+        stepOffsets.push_back(fb::CreateCookManifestStepDirect(builder, key.c_str(), &inputOffsets, &outputOffsets,
+                                                               &textureOffsets, step.value.c_str(), step.textureSlot));
+    }
+
+    fb::FinishCookManifestAssetBuffer(builder, fb::CreateCookManifestAssetDirect(builder, Version, optionsHash, &stepOffsets));
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return make_error(fmt::format("Failed to open cook manifest for writing: {}", path.string()),
+                          ErrorCode::AssetCacheWriteFailed);
+
+    file.write(reinterpret_cast<const char*>(builder.GetBufferPointer()), builder.GetSize());
+    if (!file.good())
+        return make_error(fmt::format("Failed to write cook manifest: {}", path.string()), ErrorCode::AssetCacheWriteFailed);
+    return {};
+}
+
+const CookManifestStep* CookManifest::find(std::string_view key) const
+{
+    const auto it = steps.find(std::string(key));
+    return it != steps.end() ? &it->second : nullptr;
+}
+
+//    CookInputHasher
+
+CookInputHasher::CookInputHasher(const CookManifest& previous)
+{
+    for (const auto& [key, step] : previous.steps)
+    {
+        for (const CookManifestInput& input : step.inputs)
+            m_previous.try_emplace(input.path, input);
+    }
+}
+
+Result<CookManifestInput> CookInputHasher::snapshot(const std::filesystem::path& path)
+{
+    const std::string key = path.generic_string();
+    {
+        std::lock_guard lock{m_mutex};
+        if (const auto it = m_current.find(key); it != m_current.end())
+            return it->second;
+    }
+
+    std::error_code ec;
+    CookManifestInput input{};
+    input.path = key;
+    input.size = std::filesystem::file_size(path, ec);
+    if (ec)
+        return make_error(fmt::format("Missing cook input '{}': {}", path.string(), ec.message()), ErrorCode::AssetFileNotFound);
+    input.writeTime = static_cast<std::int64_t>(std::filesystem::last_write_time(path, ec).time_since_epoch().count());
+    if (ec)
+        return make_error(fmt::format("Failed to stat cook input '{}': {}", path.string(), ec.message()),
+                          ErrorCode::AssetFileNotFound);
+
+    const auto previousIt = m_previous.find(key);
+    if (previousIt != m_previous.end() && previousIt->second.size == input.size && previousIt->second.writeTime == input.writeTime)
+    {
+        input.hash = previousIt->second.hash;
+    }
+    else
+    {
+        auto hashResult = ContentHasher::hash_file(path);
+        if (!hashResult)
+            return make_error(hashResult.error());
+        input.hash = hashResult.value();
+    }
+
+    // Two tasks may hash the same file concurrently; both arrive at the same record.
+    std::lock_guard lock{m_mutex};
+    m_current.insert_or_assign(key, input);
+    return input;
+}
+
+bool CookInputHasher::inputs_unchanged(const CookManifestStep& step)
+{
+    for (const CookManifestInput& recorded : step.inputs)
+    {
+        auto currentResult = snapshot(std::filesystem::path(recorded.path));
+        if (!currentResult || currentResult->hash != recorded.hash)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "../../Core/Public/Expected.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+struct CookManifestInput
+{
+    std::string path{}; // absolute, generic separators
+    std::uint64_t size{};
+    std::int64_t writeTime{};
+    std::uint64_t hash{};
+};
+
+struct CookManifestStep
+{
+    std::vector<CookManifestInput> inputs{};
+    std::vector<std::string> outputs{};  // relative to the cook output root
+    std::vector<std::string> textures{}; // keys of texture steps pulled in by this step
+    std::string value{};                 // what the cook needs when the step is skipped
+    std::uint8_t textureSlot{};
+};
+
+/// Record of one cook: the content hash of every input of every step and the files each step wrote.
+/// The next cook into the same output root skips steps whose inputs hash the same.
+class NOC_EXPORT CookManifest
+{
+  public:
+    /// Bump when a cook step or a cooked file format changes, so old outputs are rebuilt.
+    static constexpr std::uint32_t Version{2};
+
+    std::uint64_t optionsHash{};
+    std::unordered_map<std::string, CookManifestStep> steps{};
+
+    static std::filesystem::path get_path(const std::filesystem::path& outputRoot);
+
+    /// Fails on a missing, unreadable or out-of-date (Version) manifest.
+    static Result<CookManifest> read(const std::filesystem::path& path);
+    Result<> write(const std::filesystem::path& path) const;
+
+    const CookManifestStep* find(std::string_view key) const;
+};
+
+/// Hashes cook inputs at most once per cook. Files whose size and write time match the previous
+/// cook's record keep its hash without being read. Safe to call from several cook tasks at once.
+class NOC_EXPORT CookInputHasher
+{
+  public:
+    explicit CookInputHasher(const CookManifest& previous);
+
+    Result<CookManifestInput> snapshot(const std::filesystem::path& path);
+
+    /// True when every recorded input still has the recorded contents.
+    bool inputs_unchanged(const CookManifestStep& step);
+
+  private:
+    std::unordered_map<std::string, CookManifestInput> m_previous{};
+    std::unordered_map<std::string, CookManifestInput> m_current{};
+    std::mutex m_mutex{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
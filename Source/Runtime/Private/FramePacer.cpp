@@ -0,0 +1,117 @@
+#include "../Public/FramePacer.hpp"
+#include "../../Core/Public/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ratio>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace
+{
+using TimerTicks = std::chrono::duration<long long, std::ratio<1, 10'000'000>>; // waitable timer unit, 100 ns
+
+constexpr TimerTicks SliceDuration = std::chrono::milliseconds{1};
+constexpr float MaxFpsCap = 1000.0f;
+} // namespace
+
+FramePacer::FramePacer(IRenderer& renderer) noexcept : m_renderer{renderer}
+{
+#ifdef _WIN32
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+#endif
+}
+
+FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+    if (m_timer)
+        CloseHandle(m_timer);
+#endif
+}
+
+void FramePacer::set_fps_cap(float fps) noexcept
+{
+    m_fpsCap = std::clamp(fps, 0.0f, MaxFpsCap);
+    m_deadline = {};
+}
+
+float FramePacer::get_fps_cap() const noexcept
+{
+    return m_fpsCap;
+}
+
+void FramePacer::begin_frame() noexcept
+{
+    NOC_PROFILE_ZONE("FramePacer::begin_frame");
+    const Clock::time_point frameBegin = Clock::now();
+    m_stats.sleepMs = 0.0f;
+    if (m_fpsCap > 0.0f)
+    {
+        const auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_fpsCap));
+        // A frame that ran over restarts the schedule instead of rushing the next ones to catch up.
+        if (m_deadline == Clock::time_point{} || frameBegin > m_deadline + interval)
+            m_deadline = frameBegin;
+        sleep_until(m_deadline);
+        m_stats.sleepMs = std::chrono::duration<float, std::milli>(Clock::now() - frameBegin).count();
+        m_deadline += interval;
+    }
+
+    m_renderer.wait_for_next_frame();
+
+    if (m_lastFrameBegin != Clock::time_point{})
+        m_stats.frameMs = std::chrono::duration<float, std::milli>(frameBegin - m_lastFrameBegin).count();
+    m_lastFrameBegin = frameBegin;
+    m_stats.latency = m_renderer.get_frame_latency_stats();
+}
+
+FramePacer::Stats FramePacer::get_stats() const noexcept
+{
+    return m_stats;
+}
+
+void FramePacer::sleep_until(Clock::time_point deadline) noexcept
+{
+    while (true)
+    {
+        const double remainingMs = std::chrono::duration<double, std::milli>(deadline - Clock::now()).count();
+        const double sliceStddevMs = std::sqrt(m_sliceM2 / static_cast<double>(m_sliceCount));
+        if (remainingMs <= m_sliceMeanMs + sliceStddevMs)
+            break;
+
+        const Clock::time_point sliceBegin = Clock::now();
+        sleep_slice();
+        const double sliceMs = std::chrono::duration<double, std::milli>(Clock::now() - sliceBegin).count();
+
+        ++m_sliceCount;
+        const double delta = sliceMs - m_sliceMeanMs;
+        m_sliceMeanMs += delta / static_cast<double>(m_sliceCount);
+        m_sliceM2 += delta * (sliceMs - m_sliceMeanMs);
+    }
+
+    while (Clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+void FramePacer::sleep_slice() noexcept
+{
+#ifdef _WIN32
+    if (m_timer)
+    {
+        LARGE_INTEGER due{};
+        due.QuadPart = -SliceDuration.count(); // negative = relative
+        if (SetWaitableTimerEx(m_timer, &due, 0, nullptr, nullptr, nullptr, 0))
+        {
+            WaitForSingleObject(m_timer, INFINITE);
+            return;
+        }
+    }
+#endif
+    std::this_thread::sleep_for(SliceDuration);
+}
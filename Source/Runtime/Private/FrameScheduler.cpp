@@ -0,0 +1,115 @@
+#include "../Public/FrameScheduler.hpp"
+#include "../../Camera/Public/Camera.hpp"
+#include "../../ECS/Public/World.hpp"
+#include "../../Physics/Public/PhysicsWorld.hpp"
+#include "../../Rendering/Public/IRenderer.hpp"
+#include "../../Scripting/Public/ScriptEngine.hpp"
+
+using namespace DirectX;
+
+FrameScheduler::FrameScheduler(tf::Executor& executor, World& world, ScriptEngine& scriptEngine,
+                               PhysicsWorld& physicsWorld, OrbitCameraController& camera, IRenderer& renderer) noexcept
+    : m_executor{executor}, m_world{&world}, m_scriptEngine{scriptEngine}, m_physicsWorld{physicsWorld}, m_camera{camera},
+      m_renderer{renderer}
+{
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    wait();
+}
+
+void FrameScheduler::build_simulation(FrameSnapshot& snapshot, float deltaTime)
+{
+    m_taskflow.clear();
+
+    tf::Task scripts = m_taskflow.emplace([this, deltaTime]() { m_scriptEngine.update(*m_world, deltaTime); }).name("scripts");
+    tf::Task physics = m_taskflow.emplace([this, deltaTime]() { m_physicsWorld.step(*m_world, deltaTime); }).name("physics");
+    tf::Task transforms = m_taskflow.emplace([this]() { m_world->update_world_matrices(&m_executor); }).name("transforms");
+    tf::Task renderables = m_taskflow
+                               .emplace([this, &snapshot]() {
+                                   snapshot.changedRenderables.clear();
+                                   snapshot.removedEntityIds.clear();
+                                   if (!m_world->has_renderables_updates_pending())
+                                       return;
+                                   const RenderableDelta delta = m_world->collect_renderable_changes();
+                                   snapshot.changedRenderables.assign(delta.changed.begin(), delta.changed.end());
+                                   snapshot.removedEntityIds.assign(delta.removedEntityIds.begin(),
+                                                                    delta.removedEntityIds.end());
+                               })
+                               .name("renderables");
+    tf::Task lights = m_taskflow
+                          .emplace([this, &snapshot]() {
+                              const std::vector<Light>& worldLights = m_world->collect_lights();
+                              snapshot.lights.assign(worldLights.begin(), worldLights.end());
+                          })
+                          .name("lights");
+    tf::Task camera = m_taskflow
+                          .emplace([this, &snapshot]() {
+                              if (entt::entity active = m_world->get_active_camera(); active != entt::null)
+                                  m_camera.attach(m_world->registry(), active);
+                              snapshot.hasCamera = m_camera.is_attached();
+                              if (snapshot.hasCamera)
+                                  snapshot.camera = m_camera.get_component();
+                              XMStoreFloat4x4(&snapshot.view, m_camera.get_view_matrix());
+                          })
+                          .name("camera");
+
+    scripts.precede(physics, camera);
+    physics.precede(transforms);
+    transforms.precede(renderables);
+    renderables.precede(lights);
+}
+
+Result<> FrameScheduler::render(const FrameSnapshot& snapshot)
+{
+    m_renderer.update_renderables(RenderableDelta{snapshot.changedRenderables, snapshot.removedEntityIds});
+    m_renderer.set_lights(snapshot.lights);
+
+    const std::uint32_t renderWidth = m_renderer.get_render_width();
+    const std::uint32_t renderHeight = m_renderer.get_render_height();
+    const float aspectRatio = renderHeight > 0 ? static_cast<float>(renderWidth) / static_cast<float>(renderHeight) : 1.0f;
+    const XMMATRIX projection =
+        snapshot.hasCamera ? OrbitCameraController::make_projection_matrix(snapshot.camera, aspectRatio) : XMMatrixIdentity();
+    m_renderer.set_view_projection(XMLoadFloat4x4(&snapshot.view), projection);
+
+    return m_renderer.draw_frame();
+}
+
+Result<> FrameScheduler::run_frame(float deltaTime)
+{
+    if (m_simulationPending)
+    {
+        wait();
+    }
+    else
+    {
+        build_simulation(m_snapshots[m_writeIndex], deltaTime);
+        m_executor.run(m_taskflow).wait();
+    }
+
+    // The finished snapshot goes to the renderer; the next frame simulates into the other one.
+    const std::uint32_t readIndex = m_writeIndex;
+    m_writeIndex ^= 1u;
+    build_simulation(m_snapshots[m_writeIndex], deltaTime);
+    m_pending = m_executor.run(m_taskflow);
+    m_simulationPending = true;
+
+    return render(m_snapshots[readIndex]);
+}
+
+void FrameScheduler::set_world(World& world)
+{
+    wait();
+    m_world = &world;
+    m_snapshots = {};
+    m_writeIndex = 0;
+}
+
+void FrameScheduler::wait()
+{
+    if (!m_simulationPending)
+        return;
+    m_pending.wait();
+    m_simulationPending = false;
+}
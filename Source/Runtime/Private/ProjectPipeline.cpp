@@ -1,12 +1,20 @@
 #include "../Public/ProjectPipeline.hpp"
 
+#include "../../Assets/Private/MeshOptimizer.hpp"
+#include "../../Assets/Private/MeshSimplifier.hpp"
 #include "../../Assets/Private/ModelLoader.hpp"
 #include "../../Assets/Private/TextureLoader.hpp"
+#include "../../Assets/Private/TextureProcessor.hpp"
 #include "../../Assets/Public/AssetManager.hpp"
 #include "../../Assets/Public/MaterialData.hpp"
 #include "../../Assets/Public/ModelData.hpp"
 #include "../../Assets/Public/TextureData.hpp"
+#include "../../Core/Public/ContentHash.hpp"
+#include "../../Core/Public/JobSystem.hpp"
+#include "../../Core/Public/PackArchive.hpp"
+#include "../../Core/Public/Profiler.hpp"
 #include "../../Core/Public/RuntimePaths.hpp"
+#include "../../Core/Public/VirtualFileSystem.hpp"
 #include "../../ECS/Public/Components.hpp"
 #include "../../ECS/Public/World.hpp"
 #include "../../Level/Public/Level.hpp"
@@ -15,6 +23,7 @@
 #include "../../Rendering/Public/IRenderer.hpp"
 #include "../../Rendering/Public/ShaderCompiler.hpp"
 #include "../../Scripting/Public/ScriptEngine.hpp"
+#include "CookManifest.hpp"
 
 #include <MaterialAsset_generated.h>
 #include <flatbuffers/flatbuffers.h>
@@ -23,11 +32,22 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <fstream>
+#include <future>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <semaphore>
 #include <set>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace
 {
@@ -50,12 +70,8 @@ std::string to_lower_copy(std::string s)
 
 bool file_contains(const std::filesystem::path& path, std::string_view needle)
 {
-    std::ifstream file(path, std::ios::binary);
-    if (!file)
-        return false;
-
-    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-    return content.find(needle) != std::string::npos;
+    auto file = VirtualFileSystem::get().open(path);
+    return file && file->text().find(needle) != std::string_view::npos;
 }
 
 std::filesystem::path resolve_asset_path(const std::filesystem::path& path, const Project* project)
@@ -176,14 +192,14 @@ std::unordered_map<std::filesystem::path, entt::resource<TextureData>> prepare_t
             });
         }
 
-        assetManager.get_executor().run(taskflow).wait();
+        JobSystem::get().run_and_wait(taskflow);
 
         for (std::size_t pathIndex : decodeIndices)
         {
             if (!decoded[pathIndex])
                 continue;
 
-            auto handle = assetManager.load_texture(uniquePaths[pathIndex].string(), *decoded[pathIndex]);
+            auto handle = assetManager.load_texture(uniquePaths[pathIndex].string(), std::move(decoded[pathIndex]));
             if (handle)
                 textureHandles.emplace(uniquePaths[pathIndex], handle);
         }
@@ -261,157 +277,184 @@ Result<> seed_project_defaults(const Project& project)
     return {};
 }
 
-Result<RuntimeLoadReport> reload_level_assets(
-    AssetManager& assetManager,
-    IRenderer& renderer,
-    World& world,
-    Project* project,
-    bool requireCookedModels
-)
+struct LoadedModelEntry
 {
-    auto& reg = world.registry();
+    AssetId asset;
+    entt::resource<ModelData> modelHandle;
+};
+
+/// Level asset uploads split per model, so they can run in one go (reload_level_assets) or
+/// spread over frames (LevelStreamer).
+struct LevelAssetUpload
+{
+    std::vector<LoadedModelEntry> models{};
+    std::size_t nextModel{0};
+    std::unordered_map<std::filesystem::path, entt::resource<TextureData>> preparedTextureHandles{};
+    std::unordered_map<std::filesystem::path, std::uint32_t> uploadedTextureIndices{};
+    std::unordered_map<AssetId, MeshGpuInfo> meshGpuInfos{}; // keyed by asset.child(mesh name)
+    std::uint32_t uploadedTextureCount{};
     RuntimeLoadReport report{};
 
-    std::set<std::string> uniquePaths{};
-    auto meshView = reg.view<MeshComponent>();
+    bool done() const noexcept
+    {
+        return nextModel >= models.size();
+    }
+};
+
+/// The distinct models the level's meshes reference, in id order.
+std::vector<AssetId> collect_level_model_assets(World& world)
+{
+    std::vector<AssetId> assets{};
+    auto meshView = world.registry().view<MeshComponent>();
     for (auto entity : meshView)
     {
         const auto& meshComponent = meshView.get<MeshComponent>(entity);
-        if (!meshComponent.assetPath.empty())
-            uniquePaths.insert(meshComponent.assetPath);
+        if (meshComponent.asset.is_valid())
+            assets.push_back(meshComponent.asset);
     }
+    std::sort(assets.begin(), assets.end());
+    assets.erase(std::unique(assets.begin(), assets.end()), assets.end());
+    return assets;
+}
 
-    if (uniquePaths.empty())
-        return report;
-
-    std::unordered_map<std::string, std::unordered_map<std::string, MeshGpuInfo>> assetMeshMap;
-    struct LoadedModelEntry
+Result<> check_cooked_model_path(const std::filesystem::path& resolvedPath, std::string_view assetPath, bool requireCookedModels)
+{
+    if (requireCookedModels && resolvedPath.extension() != ".noc_model")
     {
-        std::string assetPath;
-        entt::resource<ModelData> modelHandle;
-    };
+        return make_error(
+            fmt::format("Shipping runtime requires cooked '.noc_model' assets, got '{}'", assetPath),
+            ErrorCode::AssetInvalidData
+        );
+    }
+    return {};
+}
 
-    std::vector<LoadedModelEntry> loadedModels{};
-    loadedModels.reserve(uniquePaths.size());
+/// Loads the level's models and decodes their textures. Models and textures already in the
+/// asset manager (e.g. staged by a LevelStreamer) are reused as they are.
+Result<LevelAssetUpload> begin_level_asset_upload(
+    AssetManager& assetManager,
+    World& world,
+    Project* project,
+    bool requireCookedModels
+)
+{
+    LevelAssetUpload upload{};
+    const std::vector<AssetId> assets = collect_level_model_assets(world);
+    if (assets.empty())
+        return upload;
 
+    upload.models.reserve(assets.size());
     std::set<std::filesystem::path> uniqueTextureLoadPaths{};
-    for (const auto& assetPath : uniquePaths)
+    for (const AssetId asset : assets)
     {
+        const std::string_view assetPath = AssetRegistry::get().path_of(asset);
         const std::filesystem::path resolvedPath = resolve_asset_path(assetPath, project);
-        if (requireCookedModels && resolvedPath.extension() != ".noc_model")
-        {
-            return make_error(
-                fmt::format("Shipping runtime requires cooked '.noc_model' assets, got '{}'", assetPath),
-                ErrorCode::AssetInvalidData
-            );
-        }
+        if (auto cookedResult = check_cooked_model_path(resolvedPath, assetPath, requireCookedModels); !cookedResult)
+            return make_error(cookedResult.error());
 
         if (resolvedPath.extension() != ".noc_model")
-            report.usedRawSourceAssets = true;
+            upload.report.usedRawSourceAssets = true;
 
         entt::resource<ModelData> modelHandle = assetManager.load_model(resolvedPath.string());
         if (!modelHandle)
         {
-            report.warnings.push_back(fmt::format("Failed to reload model '{}'", resolvedPath.string()));
+            upload.report.warnings.push_back(fmt::format("Failed to reload model '{}'", resolvedPath.string()));
             continue;
         }
 
         for (const auto& texturePath : collect_model_texture_load_paths(*modelHandle, project))
             uniqueTextureLoadPaths.insert(texturePath);
 
-        loadedModels.push_back({assetPath, modelHandle});
+        upload.models.push_back({asset, modelHandle});
     }
 
     const std::vector<std::filesystem::path> allTextureLoadPaths(uniqueTextureLoadPaths.begin(), uniqueTextureLoadPaths.end());
-    const auto preparedTextureHandles = prepare_texture_handles_for_paths(assetManager, allTextureLoadPaths);
-    std::unordered_map<std::filesystem::path, std::uint32_t> uploadedTextureIndices;
-    uploadedTextureIndices.reserve(preparedTextureHandles.size());
+    upload.preparedTextureHandles = prepare_texture_handles_for_paths(assetManager, allTextureLoadPaths);
+    upload.uploadedTextureIndices.reserve(upload.preparedTextureHandles.size());
+    return upload;
+}
 
-    for (const auto& loadedModel : loadedModels)
-    {
-        const ModelData& model = *loadedModel.modelHandle;
-        std::vector<std::uint32_t> gpuMaterialIndices{};
-        gpuMaterialIndices.reserve(model.materials.size());
+/// Queues the next model's textures, materials and meshes. Returns the CPU payload bytes queued.
+std::size_t upload_next_level_model(LevelAssetUpload& upload, AssetManager& assetManager, IRenderer& renderer,
+                                    const Project* project)
+{
+    if (upload.done())
+        return 0;
 
-        for (const auto& material : model.materials)
+    const LoadedModelEntry& loadedModel = upload.models[upload.nextModel++];
+    const ModelData& model = *loadedModel.modelHandle;
+    std::size_t queuedBytes = 0;
+
+    auto upload_texture_slot = [&](const std::filesystem::path& texturePath) {
+        const std::size_t texturesBefore = upload.uploadedTextureIndices.size();
+        const std::uint32_t textureIndex = upload_material_texture(
+            texturePath, project, assetManager, renderer, upload.preparedTextureHandles, upload.uploadedTextureIndices);
+        if (upload.uploadedTextureIndices.size() != texturesBefore)
         {
-            const std::uint32_t albedoIndex = upload_material_texture(
-                material.albedoTexturePath,
-                project,
-                assetManager,
-                renderer, 
-                preparedTextureHandles,
-                uploadedTextureIndices
-            );
-            const std::uint32_t normalIndex = upload_material_texture(
-                material.normalTexturePath,
-                project, 
-                assetManager,
-                renderer,
-                preparedTextureHandles,
-                uploadedTextureIndices
-            );
-            const std::uint32_t roughnessIndex = upload_material_texture(
-                material.roughnessTexturePath,
-                project,
-                assetManager,
-                renderer,
-                preparedTextureHandles,
-                uploadedTextureIndices
-            );
-            const std::uint32_t metallicIndex = upload_material_texture(
-                material.metallicTexturePath,
-                project, 
-                assetManager, 
-                renderer, 
-                preparedTextureHandles,
-                uploadedTextureIndices
-            );
-            const std::uint32_t aoIndex = upload_material_texture(
-                material.aoTexturePath,
-                project, 
-                assetManager, 
-                renderer, 
-                preparedTextureHandles,
-                uploadedTextureIndices
-            );
-
-            auto materialResult = renderer.upload_material(albedoIndex, normalIndex, roughnessIndex, metallicIndex, aoIndex);
-            gpuMaterialIndices.push_back(materialResult ? materialResult.value() : 0);
+            ++upload.uploadedTextureCount;
+            const std::filesystem::path resolvedPath = resolve_asset_path(texturePath, project);
+            if (const auto it = upload.preparedTextureHandles.find(resolvedPath); it != upload.preparedTextureHandles.end())
+                queuedBytes += it->second->pixel_bytes().size();
         }
+        return textureIndex;
+    };
+
+    std::vector<std::uint32_t> gpuMaterialIndices{};
+    gpuMaterialIndices.reserve(model.materials.size());
+    for (const auto& material : model.materials)
+    {
+        const std::uint32_t albedoIndex = upload_texture_slot(material.albedoTexturePath);
+        const std::uint32_t normalIndex = upload_texture_slot(material.normalTexturePath);
+        const std::uint32_t roughnessIndex = upload_texture_slot(material.roughnessTexturePath);
+        const std::uint32_t metallicIndex = upload_texture_slot(material.metallicTexturePath);
+        const std::uint32_t aoIndex = upload_texture_slot(material.aoTexturePath);
+
+        auto materialResult = renderer.upload_material(albedoIndex, normalIndex, roughnessIndex, metallicIndex, aoIndex);
+        gpuMaterialIndices.push_back(materialResult ? materialResult.value() : 0);
+    }
 
-        report.totalMaterials += static_cast<std::uint32_t>(gpuMaterialIndices.size());
-        auto& nameMap = assetMeshMap[loadedModel.assetPath];
-        for (std::size_t meshIndex = 0; meshIndex < model.meshes.size(); ++meshIndex)
+    upload.report.totalMaterials += static_cast<std::uint32_t>(gpuMaterialIndices.size());
+    for (std::size_t meshIndex = 0; meshIndex < model.meshes.size(); ++meshIndex)
+    {
+        auto uploadResult = renderer.upload_mesh(model.meshes[meshIndex]);
+        if (!uploadResult)
         {
-            auto uploadResult = renderer.upload_mesh(model.meshes[meshIndex]);
-            if (!uploadResult)
-            {
-                report.warnings.push_back(
-                    fmt::format("Failed to upload mesh '{}': {}", model.meshes[meshIndex].name, uploadResult.error().message));
-                continue;
-            }
+            upload.report.warnings.push_back(
+                fmt::format("Failed to upload mesh '{}': {}", model.meshes[meshIndex].name, uploadResult.error().message));
+            continue;
+        }
+        queuedBytes += model.meshes[meshIndex].geometry_bytes();
 
-            MeshGpuInfo info{};
-            info.gpuMeshIndex = static_cast<std::int32_t>(uploadResult.value());
-            const std::int32_t materialMapIndex = model.meshMaterialIndices[meshIndex];
-            if (materialMapIndex >= 0 && static_cast<std::size_t>(materialMapIndex) < gpuMaterialIndices.size())
-                info.gpuMaterialIndex = static_cast<std::int32_t>(gpuMaterialIndices[materialMapIndex]);
+        MeshGpuInfo info{};
+        info.gpuMeshIndex = static_cast<std::int32_t>(uploadResult.value());
+        const std::int32_t materialMapIndex = model.meshMaterialIndices[meshIndex];
+        if (materialMapIndex >= 0 && static_cast<std::size_t>(materialMapIndex) < gpuMaterialIndices.size())
+            info.gpuMaterialIndex = static_cast<std::int32_t>(gpuMaterialIndices[materialMapIndex]);
 
-            std::string meshName = model.meshes[meshIndex].name.empty() ? fmt::format("SubMesh_{}", meshIndex) : model.meshes[meshIndex].name;
-            nameMap[meshName] = info;
-            ++report.totalMeshes;
-        }
+        std::string meshName = model.meshes[meshIndex].name.empty() ? fmt::format("SubMesh_{}", meshIndex) : model.meshes[meshIndex].name;
+        upload.meshGpuInfos[loadedModel.asset.child(meshName)] = info;
+        ++upload.report.totalMeshes;
     }
 
+    return queuedBytes;
+}
+
+/// Points every MeshComponent at the GPU mesh and material uploaded for it.
+void bind_level_meshes(LevelAssetUpload& upload, World& world)
+{
+    std::unordered_set<AssetId> loadedAssets{};
+    for (const LoadedModelEntry& loadedModel : upload.models)
+        loadedAssets.insert(loadedModel.asset);
+
+    auto& reg = world.registry();
+    auto meshView = reg.view<MeshComponent>();
     for (auto entity : meshView)
     {
         auto& meshComponent = meshView.get<MeshComponent>(entity);
-        if (meshComponent.assetPath.empty())
+        if (!meshComponent.asset.is_valid())
             continue;
 
-        const auto assetIt = assetMeshMap.find(meshComponent.assetPath);
-        if (assetIt == assetMeshMap.end())
+        if (!loadedAssets.contains(meshComponent.asset))
         {
             meshComponent.meshIndex = -1;
             continue;
@@ -424,13 +467,13 @@ Result<RuntimeLoadReport> reload_level_assets(
             continue;
         }
 
-        const auto meshIt = assetIt->second.find(nameComponent->name);
-        if (meshIt == assetIt->second.end())
+        const auto meshIt = upload.meshGpuInfos.find(meshComponent.asset.child(nameComponent->name));
+        if (meshIt == upload.meshGpuInfos.end())
         {
             meshComponent.meshIndex = -1;
-            report.warnings.push_back(
-                fmt::format("Entity '{}' has assetPath '{}' but no matching mesh name", nameComponent->name,
-                            meshComponent.assetPath));
+            upload.report.warnings.push_back(
+                fmt::format("Entity '{}' has asset '{}' but no matching mesh name", nameComponent->name,
+                            AssetRegistry::get().path_of(meshComponent.asset)));
             continue;
         }
 
@@ -439,7 +482,25 @@ Result<RuntimeLoadReport> reload_level_assets(
     }
 
     world.mark_renderables_dirty();
-    return report;
+}
+
+Result<RuntimeLoadReport> reload_level_assets(
+    AssetManager& assetManager,
+    IRenderer& renderer,
+    World& world,
+    Project* project,
+    bool requireCookedModels
+)
+{
+    auto uploadResult = begin_level_asset_upload(assetManager, world, project, requireCookedModels);
+    if (!uploadResult)
+        return make_error(uploadResult.error());
+
+    LevelAssetUpload& upload = uploadResult.value();
+    while (!upload.done())
+        upload_next_level_model(upload, assetManager, renderer, project);
+    bind_level_meshes(upload, world);
+    return std::move(upload.report);
 }
 
 RuntimeLoadReport load_project_material_overrides(AssetManager& assetManager,
@@ -455,6 +516,7 @@ RuntimeLoadReport load_project_material_overrides(AssetManager& assetManager,
     struct LoadedMaterial
     {
         std::string name;
+        AssetId id;
         MaterialData data;
         std::int32_t gpuIndex{-1};
     };
@@ -468,66 +530,146 @@ RuntimeLoadReport load_project_material_overrides(AssetManager& assetManager,
             report.warnings.push_back(fmt::format("Failed to load material '{}'", materialFile.string()));
             continue;
         }
+        entry.id = AssetId::from_path(entry.name);
         materials.push_back(std::move(entry));
     }
 
+    // One pass over the mesh view: the entities using each material.
+    std::unordered_map<AssetId, std::vector<entt::entity>> entitiesByMaterial;
     auto meshView = world.registry().view<MeshComponent>();
-    for (auto& material : materials)
+    for (auto entity : meshView)
     {
-        bool isReferenced = false;
-        for (auto entity : meshView)
-        {
-            const auto& meshComponent = meshView.get<MeshComponent>(entity);
-            if (meshComponent.materialName == material.name)
-            {
-                isReferenced = true;
-                break;
-            }
-        }
+        const auto& meshComponent = meshView.get<MeshComponent>(entity);
+        if (meshComponent.material.is_valid())
+            entitiesByMaterial[meshComponent.material].push_back(entity);
+    }
 
-        if (!isReferenced)
+    // Textures of every referenced material, deduplicated and decoded in parallel like model textures.
+    std::vector<std::filesystem::path> texturePaths;
+    for (const auto& material : materials)
+    {
+        if (!entitiesByMaterial.contains(material.id))
             continue;
 
-        auto uploadTexture = [&](const std::filesystem::path& texturePath) -> std::uint32_t {
-            const std::filesystem::path absolutePath = resolve_asset_path(texturePath, project);
-            if (absolutePath.empty() || !std::filesystem::exists(absolutePath))
-                return 0;
+        for (const std::filesystem::path* texturePath :
+             {&material.data.albedoTexturePath, &material.data.normalTexturePath, &material.data.roughnessTexturePath,
+              &material.data.metallicTexturePath, &material.data.aoTexturePath})
+        {
+            const std::filesystem::path absolutePath = resolve_asset_path(*texturePath, project);
+            if (!absolutePath.empty() && TextureLoader::exists(absolutePath))
+                texturePaths.push_back(absolutePath);
+        }
+    }
 
-            auto textureHandle = assetManager.load_texture(absolutePath);
-            if (!textureHandle)
-                return 0;
+    const auto preparedTextureHandles = prepare_texture_handles_for_paths(assetManager, texturePaths);
+    std::unordered_map<std::filesystem::path, std::uint32_t> uploadedTextureIndices;
+    auto uploadTexture = [&](const std::filesystem::path& texturePath) -> std::uint32_t {
+        const std::filesystem::path absolutePath = resolve_asset_path(texturePath, project);
+        if (!preparedTextureHandles.contains(absolutePath))
+            return 0;
+        return upload_material_texture(texturePath, project, assetManager, renderer, preparedTextureHandles,
+                                       uploadedTextureIndices);
+    };
 
-            auto textureResult = renderer.upload_texture(*textureHandle);
-            return textureResult ? textureResult.value() : 0;
-        };
+    // Of several materials with the same name, the first one that uploads wins.
+    for (auto& material : materials)
+    {
+        const auto entitiesIt = entitiesByMaterial.find(material.id);
+        if (entitiesIt == entitiesByMaterial.end())
+            continue;
 
         auto materialResult = renderer.upload_material(uploadTexture(material.data.albedoTexturePath),
                                                        uploadTexture(material.data.normalTexturePath),
                                                        uploadTexture(material.data.roughnessTexturePath),
                                                        uploadTexture(material.data.metallicTexturePath),
                                                        uploadTexture(material.data.aoTexturePath));
-        if (materialResult)
-            material.gpuIndex = static_cast<std::int32_t>(materialResult.value());
+        if (!materialResult)
+            continue;
+
+        material.gpuIndex = static_cast<std::int32_t>(materialResult.value());
+        for (entt::entity entity : entitiesIt->second)
+            meshView.get<MeshComponent>(entity).materialIndex = material.gpuIndex;
+        entitiesByMaterial.erase(entitiesIt);
     }
 
-    for (auto entity : meshView)
+    world.mark_renderables_dirty();
+    return report;
+}
+
+/// Script and asset roots plus shader selection for a level that is about to load.
+void configure_level_runtime(IRenderer& renderer,
+                             ScriptEngine& scriptEngine,
+                             PhysicsWorld& physicsWorld,
+                             Project* project,
+                             const RuntimeLoadOptions& options,
+                             RuntimeLoadReport& report)
+{
+    const RuntimePaths* runtimePaths = RuntimePaths::try_current();
+
+    if (project && options.seedProjectDefaults)
     {
-        auto& meshComponent = meshView.get<MeshComponent>(entity);
-        if (meshComponent.materialName.empty())
-            continue;
+        if (auto defaultsResult = seed_project_defaults(*project); !defaultsResult)
+            report.warnings.push_back(defaultsResult.error().message);
+    }
+
+    if (project)
+    {
+        scriptEngine.set_script_root(project->root_path());
+        physicsWorld.set_asset_root(project->root_path());
+    }
+    else if (runtimePaths)
+    {
+        scriptEngine.set_script_root(runtimePaths->executable_dir());
+        physicsWorld.set_asset_root(std::string{});
+    }
+
+    if (runtimePaths)
+    {
+        const std::filesystem::path defaultVert = runtimePaths->resolve_engine_resource("shader.vert");
+        const std::filesystem::path defaultFrag = runtimePaths->resolve_engine_resource("shader.frag");
+        renderer.set_shader_paths(defaultVert, defaultFrag);
+    }
+    else
+    {
+        renderer.set_shader_paths("Resources/shader.vert", "Resources/shader.frag");
+    }
 
-        for (const auto& material : materials)
+    if (project)
+    {
+        const std::filesystem::path projectVert = project->get_absolute_path(std::filesystem::path("Assets") / "Shaders" / "shader.vert");
+        const std::filesystem::path projectFrag = project->get_absolute_path(std::filesystem::path("Assets") / "Shaders" / "shader.frag");
+        if (VirtualFileSystem::get().exists(projectVert) && VirtualFileSystem::get().exists(projectFrag))
         {
-            if (material.name == meshComponent.materialName && material.gpuIndex >= 0)
+            // The vertex shader must read transforms from the persistent instance slots (set 1).
+            const bool projectMatchesInstanceLayout = file_contains(projectVert, "inInstanceSlot");
+            const bool projectSupportsGlow = !options.requireGlowShaders ||
+                                             (file_contains(projectVert, "fragGlow") && file_contains(projectFrag, "fragGlow"));
+            if (!projectMatchesInstanceLayout)
             {
-                meshComponent.materialIndex = material.gpuIndex;
-                break;
+                report.warnings.push_back(
+                    "Project vertex shader uses the old per-instance matrix inputs. Using the engine default shaders "
+                    "for this session.");
+            }
+            else if (projectSupportsGlow)
+            {
+                renderer.set_shader_paths(projectVert, projectFrag);
+                report.usedProjectShaders = true;
+            }
+            else
+            {
+                report.warnings.push_back(
+                    "Project shaders are missing glow support. Using the engine default shaders for this session.");
             }
         }
     }
+}
 
-    world.mark_renderables_dirty();
-    return report;
+void merge_asset_report(RuntimeLoadReport& report, const RuntimeLoadReport& assetReport)
+{
+    report.totalMeshes += assetReport.totalMeshes;
+    report.totalMaterials += assetReport.totalMaterials;
+    report.usedRawSourceAssets = assetReport.usedRawSourceAssets;
+    report.warnings.insert(report.warnings.end(), assetReport.warnings.begin(), assetReport.warnings.end());
 }
 
 Result<> copy_tree_if_exists(const std::filesystem::path& sourceRoot, const std::filesystem::path& destinationRoot)
@@ -579,320 +721,1555 @@ Result<> copy_tree_if_exists(const std::filesystem::path& sourceRoot, const std:
     return {};
 }
 
-std::filesystem::path make_unique_cooked_model_path(const std::filesystem::path& outputRoot,
-                                                    std::string_view baseName,
-                                                    std::size_t uniqueIndex)
+/// How a material texture slot is sampled, and which channel the shader reads for masks.
+struct CookTextureSlot
 {
-    std::string stem(baseName);
-    if (stem.empty())
-        stem = "Model";
-
-    std::filesystem::path relativePath = std::filesystem::path("Assets") / "Models" / (stem + ".noc_model");
-    std::filesystem::path absolutePath = outputRoot / relativePath;
-    if (!std::filesystem::exists(absolutePath))
-        return relativePath;
+    TextureUsage usage{TextureUsage::Color};
+    std::uint32_t sourceChannel{};
+};
 
-    return std::filesystem::path("Assets") / "Models" / fmt::format("{}_{}.noc_model", stem, uniqueIndex);
-}
+/// Slots in material order: albedo, normal, roughness (G), metallic (B), AO (R).
+constexpr std::array<CookTextureSlot, 5> MaterialTextureSlots{{
+    {TextureUsage::Color, 0},
+    {TextureUsage::Normal, 0},
+    {TextureUsage::Mask, 1},
+    {TextureUsage::Mask, 2},
+    {TextureUsage::Mask, 0},
+}};
 
-Result<std::filesystem::path> copy_texture_for_cook(const std::filesystem::path& sourcePath,
-                                                    const std::filesystem::path& outputRoot,
-                                                    CookProjectResult& result)
-{
-    if (sourcePath.empty())
-        return std::filesystem::path{};
+//    Incremental cook
 
-    const std::filesystem::path relativePath = std::filesystem::path("Assets") / "Textures" / sourcePath.filename();
-    const std::filesystem::path destinationPath = outputRoot / relativePath;
-    const bool destinationExists = std::filesystem::exists(destinationPath);
-    if (auto copyResult = copy_file_if_needed(sourcePath, destinationPath, false); !copyResult)
-        return make_error(copyResult.error());
+using CookClock = std::chrono::steady_clock;
 
-    if (!destinationExists)
-        ++result.copiedTextureCount;
-    return relativePath;
-}
+/// State shared by the steps of one cook_project run. Output paths in the manifest are relative
+/// to `outputRoot`; a step runs only when the previous cook has no up-to-date record of it.
+/// Steps run as parallel tasks; `previous` and `options` are read-only while they do, the rest is
+/// guarded by `mutex` (the hasher locks itself).
+struct CookSession
+{
+    CookSession(const CookProjectOptions& cookOptions, CookProjectResult& cookResult, CookManifest previousManifest)
+        : options(cookOptions), result(cookResult), previous(std::move(previousManifest)), hasher(previous),
+          writeSlots(std::max<std::ptrdiff_t>(cookOptions.maxConcurrentWrites, 1))
+    {}
+
+    const CookProjectOptions& options;
+    CookProjectResult& result;
+    CookManifest previous{};
+    CookInputHasher hasher;
+
+    std::mutex mutex{};
+    CookManifest current{};
+    std::unordered_map<std::string, std::shared_future<Result<>>> sharedOutputs{}; // by output key
+    std::unordered_set<std::string> claimedModelPaths{};
+    std::size_t uniqueModelIndex{};
+    std::vector<Error> errors{};
+
+    std::counting_semaphore<> writeSlots;
+};
 
-Result<std::filesystem::path> copy_project_relative_file_for_cook(const std::filesystem::path& sourcePath,
-                                                                  const std::filesystem::path& projectRoot,
-                                                                  const std::filesystem::path& outputRoot,
-                                                                  std::uint32_t& copiedCount)
+/// Holds one of the session's write slots, so only `maxConcurrentWrites` tasks hit the disk at once.
+struct CookWriteSlot
 {
-    std::error_code ec;
-    const std::filesystem::path relativePath = std::filesystem::relative(sourcePath, projectRoot, ec);
-    if (ec || relativePath.empty() || relativePath.string().starts_with(".."))
+    explicit CookWriteSlot(CookSession& session) : slots(session.writeSlots)
     {
-        return make_error(fmt::format("Failed to map '{}' under project root '{}'", sourcePath.string(), projectRoot.string()),
-                          ErrorCode::AssetInvalidData);
+        slots.acquire();
     }
+    ~CookWriteSlot()
+    {
+        slots.release();
+    }
+    CookWriteSlot(const CookWriteSlot&) = delete;
+    CookWriteSlot& operator=(const CookWriteSlot&) = delete;
 
-    const std::filesystem::path destinationPath = outputRoot / relativePath;
-    const bool destinationExists = std::filesystem::exists(destinationPath);
-    if (auto copyResult = copy_file_if_needed(sourcePath, destinationPath, false); !copyResult)
-        return make_error(copyResult.error());
+    std::counting_semaphore<>& slots;
+};
 
-    if (!destinationExists)
-        ++copiedCount;
-    return relativePath;
+std::uint64_t hash_cook_options(const CookProjectOptions& options)
+{
+    ContentHasher hasher{};
+    hasher.update_value(CookManifest::Version);
+    for (bool flag : {options.compileShaders, options.compressTextures, options.generateLods, options.compactVertices,
+                      options.cookCollisionShapes, options.compileScripts, options.strict})
+        hasher.update_value(flag);
+    return hasher.digest();
 }
 
-std::set<std::string> collect_referenced_script_paths(const World& world)
+std::string cook_output_key(const CookSession& session, const std::filesystem::path& outputPath)
 {
-    std::set<std::string> scriptPaths;
-    auto view = world.registry().view<ScriptComponent>();
-    for (auto entity : view)
-    {
-        const auto& scriptComponent = view.get<ScriptComponent>(entity);
-        if (!scriptComponent.scriptPath.empty())
-            scriptPaths.insert(scriptComponent.scriptPath);
-    }
-    return scriptPaths;
+    std::error_code ec;
+    return std::filesystem::relative(outputPath, session.options.outputRoot, ec).generic_string();
 }
 
-std::set<std::string> collect_referenced_material_names(const World& world)
+/// Adds a task's counters, timings and warnings to the cook result.
+void merge_cook_result(CookProjectResult& into, CookProjectResult& from)
 {
-    std::set<std::string> materialNames;
-    auto view = world.registry().view<MeshComponent>();
-    for (auto entity : view)
-    {
-        const auto& meshComponent = view.get<MeshComponent>(entity);
-        if (!meshComponent.materialName.empty())
-            materialNames.insert(meshComponent.materialName);
-    }
-    return materialNames;
+    into.rebuiltAssetCount += from.rebuiltAssetCount;
+    into.skippedAssetCount += from.skippedAssetCount;
+    into.cookedLevelCount += from.cookedLevelCount;
+    into.cookedModelCount += from.cookedModelCount;
+    into.copiedTextureCount += from.copiedTextureCount;
+    into.compressedTextureCount += from.compressedTextureCount;
+    into.packedOrmTextureCount += from.packedOrmTextureCount;
+    into.lodMeshCount += from.lodMeshCount;
+    into.generatedLodCount += from.generatedLodCount;
+    into.cookedCollisionShapeCount += from.cookedCollisionShapeCount;
+    into.copiedMaterialCount += from.copiedMaterialCount;
+    into.copiedScriptCount += from.copiedScriptCount;
+    into.compiledScriptCount += from.compiledScriptCount;
+    into.copiedEngineFileCount += from.copiedEngineFileCount;
+    std::ranges::move(from.assetTimings, std::back_inserter(into.assetTimings));
+    std::ranges::move(from.warnings, std::back_inserter(into.warnings));
 }
 
-struct ProjectMaterialAsset
+/// Adds `step` to the cook graph. It fills a result of its own, merged into the cook result when it
+/// finishes; a failure is collected and reported once the whole graph has run.
+template <typename Step>
+tf::Task emplace_cook_task(tf::Taskflow& taskflow, CookSession& session, std::string name, Step step)
 {
-    std::filesystem::path filePath;
-    MaterialData data;
-};
+    return taskflow
+        .emplace([&session, step = std::move(step)]() {
+            CookProjectResult taskResult{};
+            Result<> stepResult = step(taskResult);
+
+            std::lock_guard lock{session.mutex};
+            merge_cook_result(session.result, taskResult);
+            if (!stepResult)
+                session.errors.push_back(std::move(stepResult.error()));
+        })
+        .name(std::move(name));
+}
 
-std::unordered_map<std::string, ProjectMaterialAsset> build_project_material_lookup(const Project& project,
-                                                                                    CookProjectResult& result)
+/// Failures of a non-strict cook become warnings; a strict cook fails the task.
+Result<> demote_cook_error(const CookSession& session, CookProjectResult& result, Result<> stepResult)
 {
-    std::unordered_map<std::string, ProjectMaterialAsset> materialLookup;
-    for (const auto& materialFile : scan_material_files(&project))
-    {
-        std::string materialName;
-        MaterialData materialData;
-        if (!load_material_from_file(materialFile, materialName, materialData, &project, false))
-        {
-            result.warnings.push_back(fmt::format("Failed to load material '{}'", materialFile.string()));
-            continue;
-        }
-
-        materialLookup.try_emplace(materialName, ProjectMaterialAsset{materialFile, std::move(materialData)});
-    }
-
-    return materialLookup;
+    if (stepResult || session.options.strict)
+        return stepResult;
+    result.warnings.push_back(std::move(stepResult.error().message));
+    return {};
 }
 
-Result<> copy_engine_runtime_resources(const RuntimePaths& runtimePaths,
-                                       const std::filesystem::path& engineOutputRoot,
-                                       bool compileShaders,
-                                       CookProjectResult& result)
+/// Returns this cook's record of `key` when the step already ran in this cook, or when the previous
+/// cook recorded it with unchanged inputs and all of its outputs still exist. nullptr: run the step.
+const CookManifestStep* reuse_cook_step(CookSession& session, CookProjectResult& result, const std::string& key)
 {
-    const std::filesystem::path engineSourceRoot =
-        std::filesystem::exists(runtimePaths.engine_resources_dir()) ? runtimePaths.engine_resources_dir()
-                                                                     : runtimePaths.legacy_resources_dir();
+    {
+        std::lock_guard lock{session.mutex};
+        if (const CookManifestStep* current = session.current.find(key))
+            return current;
+    }
 
-    const std::array<std::filesystem::path, 5> requiredEngineFiles{
-        std::filesystem::path("shader.vert"),
-        std::filesystem::path("shader.frag"),
-        std::filesystem::path("NIS") / "NIS_Main.glsl",
-        std::filesystem::path("NIS") / "NIS_Scaler.h",
-        std::filesystem::path("NIS") / "NIS_Config.h",
-    };
+    const CookManifestStep* previous = session.previous.find(key);
+    if (!previous)
+        return nullptr;
 
-    for (const auto& relativePath : requiredEngineFiles)
+    std::error_code ec;
+    for (const std::string& output : previous->outputs)
     {
-        const std::filesystem::path sourcePath = engineSourceRoot / relativePath;
-        const std::filesystem::path destinationPath = engineOutputRoot / relativePath;
-        const bool destinationExists = std::filesystem::exists(destinationPath);
-        if (auto copyResult = copy_file_if_needed(sourcePath, destinationPath, true); !copyResult)
-            return make_error(copyResult.error());
-
-        if (!destinationExists)
-            ++result.copiedEngineFileCount;
+        if (!std::filesystem::exists(session.options.outputRoot / output, ec))
+            return nullptr;
     }
+    if (!session.hasher.inputs_unchanged(*previous))
+        return nullptr;
 
-    if (!compileShaders)
-        return {};
+    ++result.skippedAssetCount;
+    std::lock_guard lock{session.mutex};
+    return &session.current.steps.insert_or_assign(key, *previous).first->second;
+}
 
-    for (const auto& shaderName : {"shader.vert", "shader.frag"})
+/// Records a step that just ran, hashing `inputs` (source files) into it.
+Result<const CookManifestStep*> record_cook_step(CookSession& session, CookProjectResult& result, const std::string& key,
+                                                 const std::vector<std::filesystem::path>& inputs, CookManifestStep step,
+                                                 CookClock::time_point start)
+{
+    step.inputs.clear();
+    step.inputs.reserve(inputs.size());
+    for (const std::filesystem::path& input : inputs)
     {
-        const std::filesystem::path shaderPath = engineOutputRoot / shaderName;
-        auto compileResult = ShaderCompiler::compile_to_file(shaderPath, ShaderCompiler::get_spv_path(shaderPath));
-        if (!compileResult)
-            return make_error(compileResult.error());
+        auto inputResult = session.hasher.snapshot(input);
+        if (!inputResult)
+            return make_error(inputResult.error());
+        step.inputs.push_back(std::move(inputResult.value()));
     }
 
-    const std::filesystem::path nisSource = engineOutputRoot / "NIS" / "NIS_Main.glsl";
-    auto computeResult =
-        ShaderCompiler::compile_compute_to_file(nisSource, ShaderCompiler::get_spv_path(nisSource), {nisSource.parent_path()});
-    if (!computeResult)
-        return make_error(computeResult.error());
+    const double milliseconds = std::chrono::duration<double, std::milli>(CookClock::now() - start).count();
+    result.assetTimings.push_back(CookAssetTiming{key, milliseconds});
+    ++result.rebuiltAssetCount;
 
-    return {};
+    std::lock_guard lock{session.mutex};
+    if (session.options.printAssetTimings)
+        fmt::print("[Cook] {:>9.1f} ms  {}\n", milliseconds, key);
+    return &session.current.steps.insert_or_assign(key, std::move(step)).first->second;
 }
 
-Result<> copy_referenced_material_asset(const std::string& materialName,
+/// Runs `produce` for the first step of this cook that claims the output `outputPath`; later claimants
+/// wait for it and share its outcome. Textures and packed ORM maps are shared by many models and
+/// materials, which now cook concurrently.
+template <typename Produce>
+Result<> produce_shared_output(CookSession& session, const std::filesystem::path& outputPath, Produce&& produce)
+{
+    std::promise<Result<>> promise{};
+    std::shared_future<Result<>> claimed{};
+    {
+        std::lock_guard lock{session.mutex};
+        auto [it, inserted] = session.sharedOutputs.try_emplace(cook_output_key(session, outputPath));
+        if (inserted)
+            it->second = promise.get_future().share();
+        else
+            claimed = it->second;
+    }
+    if (claimed.valid())
+        return claimed.get();
+
+    Result<> outcome = produce();
+    promise.set_value(outcome);
+    return outcome;
+}
+
+/// Picks the output path of a newly cooked model: Assets/Models/<name>.noc_model, or a numbered
+/// variant when that name is already on disk or taken by another model of this cook.
+std::filesystem::path reserve_cooked_model_path(CookSession& session,
+                                                const std::filesystem::path& outputRoot,
+                                                std::string_view baseName)
+{
+    std::string stem(baseName);
+    if (stem.empty())
+        stem = "Model";
+
+    const std::filesystem::path modelsDir = std::filesystem::path("Assets") / "Models";
+    std::filesystem::path relativePath = modelsDir / (stem + ".noc_model");
+
+    std::lock_guard lock{session.mutex};
+    std::error_code ec;
+    while (session.claimedModelPaths.contains(relativePath.generic_string()) ||
+           std::filesystem::exists(outputRoot / relativePath, ec))
+        relativePath = modelsDir / fmt::format("{}_{}.noc_model", stem, session.uniqueModelIndex++);
+
+    session.claimedModelPaths.insert(relativePath.generic_string());
+    return relativePath;
+}
+
+/// Copies `sourcePath` to `outputPath` as a step of its own, unless it is unchanged since the previous cook.
+/// Returns true when the file was copied.
+Result<bool> cook_copy_step(CookSession& session, CookProjectResult& result, const std::string& key,
+                            const std::filesystem::path& sourcePath, const std::filesystem::path& outputPath)
+{
+    if (reuse_cook_step(session, result, key))
+        return false;
+
+    const CookClock::time_point start = CookClock::now();
+    {
+        CookWriteSlot writeSlot{session};
+        if (auto copyResult = copy_file_if_needed(sourcePath, outputPath, true); !copyResult)
+            return make_error(copyResult.error());
+    }
+
+    CookManifestStep step{};
+    step.outputs.push_back(cook_output_key(session, outputPath));
+    if (auto recordResult = record_cook_step(session, result, key, {sourcePath}, std::move(step), start); !recordResult)
+        return make_error(recordResult.error());
+    return true;
+}
+
+/// Deletes outputs of the previous cook that no step of this cook produced, then writes the manifest.
+/// A failed cook keeps the previous records of the steps that did not finish. Those steps only ran
+/// because their inputs or outputs changed, so they rerun next time and their old outputs stay tracked.
+Result<> finish_cook_session(CookSession& session, bool cookFailed)
+{
+    if (cookFailed)
+    {
+        for (const auto& [key, step] : session.previous.steps)
+            session.current.steps.try_emplace(key, step);
+    }
+
+    std::unordered_set<std::string> liveOutputs{};
+    for (const auto& [key, step] : session.current.steps)
+        liveOutputs.insert(step.outputs.begin(), step.outputs.end());
+
+    std::error_code ec;
+    for (const auto& [key, step] : session.previous.steps)
+    {
+        for (const std::string& output : step.outputs)
+        {
+            if (!liveOutputs.contains(output))
+                std::filesystem::remove(session.options.outputRoot / output, ec);
+        }
+    }
+
+    session.current.optionsHash = hash_cook_options(session.options);
+    return session.current.write(CookManifest::get_path(session.options.outputRoot));
+}
+
+/// Material libraries an OBJ pulls in (`mtllib` lines), which the parsed model depends on too.
+std::vector<std::filesystem::path> collect_obj_material_libraries(const std::filesystem::path& objPath)
+{
+    std::vector<std::filesystem::path> libraries{};
+    if (to_lower_copy(objPath.extension().string()) != ".obj")
+        return libraries;
+
+    std::ifstream file(objPath);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.starts_with("mtllib"))
+            continue;
+
+        std::string name = line.substr(6);
+        while (!name.empty() && std::isspace(static_cast<unsigned char>(name.front())))
+            name.erase(name.begin());
+        while (!name.empty() && std::isspace(static_cast<unsigned char>(name.back())))
+            name.pop_back();
+
+        const std::filesystem::path libraryPath = objPath.parent_path() / name;
+        std::error_code ec;
+        if (!name.empty() && std::filesystem::exists(libraryPath, ec))
+            libraries.push_back(libraryPath);
+    }
+    return libraries;
+}
+
+/// Writes the upload-ready mip chain for a cooked texture next to it (.noc_texture), so the runtime
+/// never decodes the image. Block-compressed when `compress` is set, RGBA8 otherwise.
+Result<> write_texture_sidecar(CookSession& session, const std::filesystem::path& texturePath,
+                               const CookTextureSlot& slot, bool compress)
+{
+    const std::filesystem::path sidecarPath = TextureLoader::get_cache_path(texturePath);
+
+    auto decodeResult = TextureLoader::decode_image(texturePath, slot.usage);
+    if (!decodeResult)
+        return make_error(decodeResult.error());
+
+    TextureData& texture = *decodeResult.value();
+    if (compress)
+    {
+        if (auto compressResult =
+                TextureProcessor::compress(texture, TextureProcessor::compressed_format_for(slot.usage), slot.sourceChannel);
+            !compressResult)
+        {
+            return make_error(compressResult.error());
+        }
+    }
+
+    CookWriteSlot writeSlot{session};
+    if (auto writeResult = TextureLoader::write_cache(texture, sidecarPath); !writeResult)
+        return make_error(writeResult.error());
+    return {};
+}
+
+std::string texture_step_key(const std::filesystem::path& sourcePath)
+{
+    return "texture:" + sourcePath.generic_string();
+}
+
+/// Copies a material texture into `outputRoot`/Assets/Textures (plus its compressed sidecar) as a
+/// cook step of its own, so a texture shared by many models is processed once per change. Of several
+/// sources with the same file name, the first to be cooked wins.
+Result<std::filesystem::path> copy_texture_for_cook(CookSession& session,
+                                                    CookProjectResult& result,
+                                                    const std::filesystem::path& sourcePath,
+                                                    const std::filesystem::path& outputRoot,
+                                                    std::size_t slotIndex)
+{
+    if (sourcePath.empty())
+        return std::filesystem::path{};
+
+    const std::filesystem::path relativePath = std::filesystem::path("Assets") / "Textures" / sourcePath.filename();
+    const std::filesystem::path destinationPath = outputRoot / relativePath;
+    auto textureResult = produce_shared_output(session, destinationPath, [&]() -> Result<> {
+        const std::string key = texture_step_key(sourcePath);
+        if (reuse_cook_step(session, result, key))
+            return {};
+
+        const CookClock::time_point start = CookClock::now();
+        {
+            CookWriteSlot writeSlot{session};
+            if (auto copyResult = copy_file_if_needed(sourcePath, destinationPath, true); !copyResult)
+                return copyResult;
+        }
+        ++result.copiedTextureCount;
+
+        CookManifestStep step{};
+        step.textureSlot = static_cast<std::uint8_t>(slotIndex);
+        step.outputs.push_back(cook_output_key(session, destinationPath));
+        // The raw copy stays as the fallback; a failed sidecar only costs a decode at load, not correctness.
+        const bool compress = session.options.compressTextures;
+        auto sidecarResult = write_texture_sidecar(session, destinationPath, MaterialTextureSlots[slotIndex], compress);
+        if (!sidecarResult)
+        {
+            result.warnings.push_back(
+                fmt::format("Texture '{}' was not pre-decoded: {}", sourcePath.string(), sidecarResult.error().message));
+        }
+        else
+        {
+            if (compress)
+                ++result.compressedTextureCount;
+            step.outputs.push_back(cook_output_key(session, TextureLoader::get_cache_path(destinationPath)));
+        }
+
+        if (auto recordResult = record_cook_step(session, result, key, {sourcePath}, std::move(step), start); !recordResult)
+            return make_error(recordResult.error());
+        return {};
+    });
+    if (!textureResult)
+        return make_error(textureResult.error());
+    return relativePath;
+}
+
+/// Carries the texture steps a reused step pulled in into this cook, re-running those whose source changed.
+Result<> revisit_cook_textures(CookSession& session,
+                               CookProjectResult& result,
+                               const CookManifestStep& step,
+                               const std::filesystem::path& outputRoot)
+{
+    for (const std::string& textureKey : step.textures)
+    {
+        const CookManifestStep* textureStep = session.previous.find(textureKey);
+        if (!textureStep || textureStep->inputs.empty() || textureStep->textureSlot >= MaterialTextureSlots.size())
+            continue;
+
+        auto textureResult = copy_texture_for_cook(session, result, std::filesystem::path(textureStep->inputs.front().path),
+                                                   outputRoot, textureStep->textureSlot);
+        if (!textureResult)
+        {
+            if (session.options.strict)
+                return make_error(textureResult.error());
+            result.warnings.push_back(textureResult.error().message);
+        }
+    }
+    return {};
+}
+
+/// Builds LOD chains for every sub-mesh of a cooked model that does not carry one yet.
+/// Returns true when any mesh gained levels.
+bool generate_model_lods_for_cook(ModelData& model, CookProjectResult& result)
+{
+    bool changed = false;
+    for (MeshData& mesh : model.meshes)
+    {
+        const std::uint32_t addedLevels = MeshSimplifier::generate_lods(mesh);
+        if (addedLevels == 0)
+            continue;
+        // The simplified levels are appended unordered; reorder every range for the vertex cache.
+        MeshOptimizer::optimize(mesh);
+        ++result.lodMeshCount;
+        result.generatedLodCount += addedLevels;
+        changed = true;
+    }
+    return changed;
+}
+
+/// Packs a cooked material's AO / roughness / metallic maps into one ORM texture
+/// (R = AO, G = roughness, B = metallic) and points all three slots at it, so the renderer
+/// samples them with a single fetch. Texture paths are relative to `outputRoot`.
+Result<> pack_material_orm_for_cook(CookSession& session,
+                                    CookProjectResult& result,
+                                    MaterialData& material,
+                                    std::string_view modelName,
+                                    const std::filesystem::path& outputRoot)
+{
+    const std::array<std::filesystem::path*, 3> ormPaths{
+        &material.aoTexturePath,
+        &material.roughnessTexturePath,
+        &material.metallicTexturePath,
+    };
+    if (std::ranges::all_of(ormPaths, [](const std::filesystem::path* path) { return path->empty(); }))
+        return {};
+    // A single map in every slot already is an ORM texture.
+    if (*ormPaths[0] == *ormPaths[1] && *ormPaths[1] == *ormPaths[2])
+        return {};
+
+    std::string stem = fmt::format("{}_{}_orm", modelName, material.name.empty() ? "Material" : material.name);
+    std::ranges::replace_if(stem, [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-'; }, '_');
+    const std::filesystem::path relativePath = std::filesystem::path("Assets") / "Textures" / (stem + ".noc_texture");
+    const std::filesystem::path destinationPath = outputRoot / relativePath;
+
+    auto packResult = produce_shared_output(session, destinationPath, [&]() -> Result<> {
+        std::error_code ec;
+        bool upToDate = std::filesystem::exists(destinationPath, ec);
+        for (const std::filesystem::path* path : ormPaths)
+        {
+            if (upToDate && !path->empty())
+                upToDate = std::filesystem::last_write_time(destinationPath, ec) >=
+                           std::filesystem::last_write_time(outputRoot / *path, ec);
+        }
+
+        if (!upToDate)
+        {
+            std::array<std::shared_ptr<TextureData>, 3> sources{};
+            for (std::size_t i = 0; i < ormPaths.size(); ++i)
+            {
+                if (ormPaths[i]->empty())
+                    continue;
+                auto decodeResult = TextureLoader::decode_image(outputRoot / *ormPaths[i], TextureUsage::Mask);
+                if (!decodeResult)
+                    return make_error(decodeResult.error());
+                sources[i] = std::move(decodeResult.value());
+            }
+
+            auto ormResult = TextureProcessor::pack_orm(sources[0].get(), sources[1].get(), sources[2].get());
+            if (!ormResult)
+                return make_error(ormResult.error());
+
+            TextureData& orm = ormResult.value();
+            orm.name = stem;
+            if (auto mipResult = TextureProcessor::generate_mips(orm, TextureUsage::Mask); !mipResult)
+                return mipResult;
+            if (session.options.compressTextures)
+            {
+                if (auto compressResult = TextureProcessor::compress(orm, TexturePixelFormat::BC7); !compressResult)
+                    return compressResult;
+            }
+            CookWriteSlot writeSlot{session};
+            if (auto directoryResult = ensure_parent_directory(destinationPath); !directoryResult)
+                return directoryResult;
+            if (auto writeResult = TextureLoader::write_cache(orm, destinationPath); !writeResult)
+                return writeResult;
+            ++result.packedOrmTextureCount;
+        }
+        return {};
+    });
+    if (!packResult)
+        return packResult;
+
+    for (std::filesystem::path* path : ormPaths)
+        *path = relativePath;
+    return {};
+}
+
+Result<std::filesystem::path> copy_project_relative_file_for_cook(const std::filesystem::path& sourcePath,
+                                                                  const std::filesystem::path& projectRoot,
+                                                                  const std::filesystem::path& outputRoot,
+                                                                  std::uint32_t& copiedCount)
+{
+    std::error_code ec;
+    const std::filesystem::path relativePath = std::filesystem::relative(sourcePath, projectRoot, ec);
+    if (ec || relativePath.empty() || relativePath.string().starts_with(".."))
+    {
+        return make_error(fmt::format("Failed to map '{}' under project root '{}'", sourcePath.string(), projectRoot.string()),
+                          ErrorCode::AssetInvalidData);
+    }
+
+    if (auto copyResult = copy_file_if_needed(sourcePath, outputRoot / relativePath, true); !copyResult)
+        return make_error(copyResult.error());
+
+    ++copiedCount;
+    return relativePath;
+}
+
+/// Writes the LuaJIT bytecode of a project script to the same relative path under `outputRoot`.
+Result<std::filesystem::path> compile_project_script_for_cook(const std::filesystem::path& sourcePath,
+                                                              const std::filesystem::path& projectRoot,
+                                                              const std::filesystem::path& outputRoot,
+                                                              std::uint32_t& compiledCount)
+{
+    std::error_code ec;
+    const std::filesystem::path relativePath = std::filesystem::relative(sourcePath, projectRoot, ec);
+    if (ec || relativePath.empty() || relativePath.string().starts_with(".."))
+    {
+        return make_error(fmt::format("Failed to map '{}' under project root '{}'", sourcePath.string(), projectRoot.string()),
+                          ErrorCode::AssetInvalidData);
+    }
+
+    if (auto compileResult = ScriptEngine::compile_to_bytecode(sourcePath, outputRoot / relativePath); !compileResult)
+        return make_error(compileResult.error());
+
+    ++compiledCount;
+    return relativePath;
+}
+
+std::set<std::string> collect_referenced_script_paths(const World& world)
+{
+    std::set<std::string> scriptPaths;
+    auto view = world.registry().view<ScriptComponent>();
+    for (auto entity : view)
+    {
+        const auto& scriptComponent = view.get<ScriptComponent>(entity);
+        if (!scriptComponent.scriptPath.empty())
+            scriptPaths.insert(scriptComponent.scriptPath);
+    }
+    return scriptPaths;
+}
+
+std::set<std::string> collect_referenced_material_names(const World& world)
+{
+    std::set<std::string> materialNames;
+    auto view = world.registry().view<MeshComponent>();
+    for (auto entity : view)
+    {
+        const auto& meshComponent = view.get<MeshComponent>(entity);
+        if (const std::string_view materialName = AssetRegistry::get().path_of(meshComponent.material); !materialName.empty())
+            materialNames.emplace(materialName);
+    }
+    return materialNames;
+}
+
+struct ProjectMaterialAsset
+{
+    std::filesystem::path filePath;
+    MaterialData data;
+};
+
+std::unordered_map<std::string, ProjectMaterialAsset> build_project_material_lookup(const Project& project,
+                                                                                    CookProjectResult& result)
+{
+    std::unordered_map<std::string, ProjectMaterialAsset> materialLookup;
+    for (const auto& materialFile : scan_material_files(&project))
+    {
+        std::string materialName;
+        MaterialData materialData;
+        if (!load_material_from_file(materialFile, materialName, materialData, &project, false))
+        {
+            result.warnings.push_back(fmt::format("Failed to load material '{}'", materialFile.string()));
+            continue;
+        }
+
+        materialLookup.try_emplace(materialName, ProjectMaterialAsset{materialFile, std::move(materialData)});
+    }
+
+    return materialLookup;
+}
+
+/// Adds the engine resource copies and shader compiles to the cook graph. A shader compiles once
+/// every file it reads has been copied into the output.
+void emplace_engine_cook_tasks(tf::Taskflow& taskflow,
+                               CookSession& session,
+                               const RuntimePaths& runtimePaths,
+                               const std::filesystem::path& engineOutputRoot)
+{
+    const std::filesystem::path engineSourceRoot =
+        std::filesystem::exists(runtimePaths.engine_resources_dir()) ? runtimePaths.engine_resources_dir()
+                                                                     : runtimePaths.legacy_resources_dir();
+
+    const std::array<std::filesystem::path, 12> requiredEngineFiles{
+        std::filesystem::path("shader.vert"),
+        std::filesystem::path("shader.frag"),
+        std::filesystem::path("depth.vert"),
+        std::filesystem::path("debug.vert"),
+        std::filesystem::path("debug.frag"),
+        std::filesystem::path("cull.comp"),
+        std::filesystem::path("hiz.comp"),
+        std::filesystem::path("hiz_ms.comp"),
+        std::filesystem::path("cluster.comp"),
+        std::filesystem::path("NIS") / "NIS_Main.glsl",
+        std::filesystem::path("NIS") / "NIS_Scaler.h",
+        std::filesystem::path("NIS") / "NIS_Config.h",
+    };
+
+    std::unordered_map<std::string, tf::Task> copyTasks{};
+    for (const auto& relativePath : requiredEngineFiles)
+    {
+        const std::string key = "engine:" + relativePath.generic_string();
+        copyTasks.emplace(relativePath.generic_string(),
+                          emplace_cook_task(taskflow, session, key,
+                                            [&session, key, sourcePath = engineSourceRoot / relativePath,
+                                             outputPath = engineOutputRoot / relativePath](CookProjectResult& result) -> Result<> {
+                                                auto copyResult = cook_copy_step(session, result, key, sourcePath, outputPath);
+                                                if (!copyResult)
+                                                    return make_error(copyResult.error());
+                                                if (copyResult.value())
+                                                    ++result.copiedEngineFileCount;
+                                                return {};
+                                            }));
+    }
+
+    if (!session.options.compileShaders)
+        return;
+
+    // Each shader compiles from the engine sources it reads; the NIS kernel includes its headers.
+    struct EngineShader
+    {
+        std::filesystem::path source;
+        std::vector<std::filesystem::path> includes;
+        bool compute;
+    };
+    const std::array<EngineShader, 10> engineShaders{{
+        {"shader.vert", {}, false},
+        {"shader.frag", {}, false},
+        {"depth.vert", {}, false},
+        {"debug.vert", {}, false},
+        {"debug.frag", {}, false},
+        {std::filesystem::path("NIS") / "NIS_Main.glsl",
+         {std::filesystem::path("NIS") / "NIS_Scaler.h", std::filesystem::path("NIS") / "NIS_Config.h"},
+         true},
+        {"cull.comp", {}, true},
+        {"hiz.comp", {}, true},
+        {"hiz_ms.comp", {}, true},
+        {"cluster.comp", {}, true},
+    }};
+
+    for (const EngineShader& shader : engineShaders)
+    {
+        const std::string key = "engine-shader:" + shader.source.generic_string();
+        tf::Task compileTask = emplace_cook_task(
+            taskflow, session, key,
+            [&session, key, shader, engineSourceRoot, engineOutputRoot](CookProjectResult& result) -> Result<> {
+                if (reuse_cook_step(session, result, key))
+                    return {};
+
+                const CookClock::time_point start = CookClock::now();
+                const std::filesystem::path shaderPath = engineOutputRoot / shader.source;
+                const std::filesystem::path spvPath = ShaderCompiler::get_spv_path(shaderPath);
+                auto compileResult = shader.compute
+                                         ? ShaderCompiler::compile_compute_to_file(shaderPath, spvPath, {shaderPath.parent_path()})
+                                         : ShaderCompiler::compile_to_file(shaderPath, spvPath);
+                if (!compileResult)
+                    return make_error(compileResult.error());
+
+                std::vector<std::filesystem::path> inputs{engineSourceRoot / shader.source};
+                for (const std::filesystem::path& include : shader.includes)
+                    inputs.push_back(engineSourceRoot / include);
+
+                CookManifestStep step{};
+                step.outputs.push_back(cook_output_key(session, spvPath));
+                if (auto recordResult = record_cook_step(session, result, key, inputs, std::move(step), start); !recordResult)
+                    return make_error(recordResult.error());
+                return {};
+            });
+
+        compileTask.succeed(copyTasks.at(shader.source.generic_string()));
+        for (const std::filesystem::path& include : shader.includes)
+            compileTask.succeed(copyTasks.at(include.generic_string()));
+    }
+}
+
+Result<> copy_referenced_material_asset(CookSession& session,
+                                        CookProjectResult& result,
+                                        const std::string& materialName,
                                         const Project& project,
                                         const std::unordered_map<std::string, ProjectMaterialAsset>& materialLookup,
-                                        const std::filesystem::path& gameOutputRoot,
-                                        CookProjectResult& result)
+                                        const std::filesystem::path& gameOutputRoot)
 {
     const auto it = materialLookup.find(materialName);
     if (it == materialLookup.end())
         return make_error(fmt::format("Referenced material '{}' was not found in the project", materialName),
                           ErrorCode::AssetFileNotFound);
 
+    const std::string key = "material:" + materialName;
+    if (const CookManifestStep* reused = reuse_cook_step(session, result, key))
+        return revisit_cook_textures(session, result, *reused, gameOutputRoot);
+
+    const CookClock::time_point start = CookClock::now();
     const ProjectMaterialAsset& materialAsset = it->second;
-    auto materialCopyResult =
-        copy_project_relative_file_for_cook(materialAsset.filePath, project.root_path(), gameOutputRoot, result.copiedMaterialCount);
+    Result<std::filesystem::path> materialCopyResult{};
+    {
+        CookWriteSlot writeSlot{session};
+        materialCopyResult = copy_project_relative_file_for_cook(materialAsset.filePath, project.root_path(), gameOutputRoot,
+                                                                 result.copiedMaterialCount);
+    }
     if (!materialCopyResult)
         return make_error(materialCopyResult.error());
 
-    for (const auto* texturePath : {&materialAsset.data.albedoTexturePath, &materialAsset.data.normalTexturePath,
-                                    &materialAsset.data.roughnessTexturePath, &materialAsset.data.metallicTexturePath,
-                                    &materialAsset.data.aoTexturePath})
+    CookManifestStep step{};
+    step.outputs.push_back(cook_output_key(session, gameOutputRoot / materialCopyResult.value()));
+
+    const std::array<const std::filesystem::path*, 5> texturePaths{
+        &materialAsset.data.albedoTexturePath,    &materialAsset.data.normalTexturePath,
+        &materialAsset.data.roughnessTexturePath, &materialAsset.data.metallicTexturePath,
+        &materialAsset.data.aoTexturePath,
+    };
+    for (std::size_t slotIndex = 0; slotIndex < texturePaths.size(); ++slotIndex)
     {
-        const std::filesystem::path resolvedTexturePath = resolve_asset_path(*texturePath, &project);
+        const std::filesystem::path resolvedTexturePath = resolve_asset_path(*texturePaths[slotIndex], &project);
         if (resolvedTexturePath.empty())
             continue;
 
-        auto textureCopyResult = copy_texture_for_cook(resolvedTexturePath, gameOutputRoot, result);
-        if (!textureCopyResult)
-            return make_error(textureCopyResult.error());
+        auto textureCopyResult = copy_texture_for_cook(session, result, resolvedTexturePath, gameOutputRoot, slotIndex);
+        if (!textureCopyResult)
+            return make_error(textureCopyResult.error());
+        step.textures.push_back(texture_step_key(resolvedTexturePath));
+    }
+
+    if (auto recordResult = record_cook_step(session, result, key, {materialAsset.filePath}, std::move(step), start);
+        !recordResult)
+        return make_error(recordResult.error());
+    return {};
+}
+
+Result<> cook_referenced_script(CookSession& session,
+                                CookProjectResult& result,
+                                const Project& project,
+                                const std::string& scriptPath,
+                                const std::filesystem::path& gameOutputRoot)
+{
+    const std::string scriptKey = "script:" + scriptPath;
+    if (reuse_cook_step(session, result, scriptKey))
+        return {};
+
+    const CookClock::time_point start = CookClock::now();
+    const std::filesystem::path sourceScriptPath = resolve_asset_path(scriptPath, &project);
+    Result<std::filesystem::path> scriptCookResult{};
+    {
+        CookWriteSlot writeSlot{session};
+        scriptCookResult = session.options.compileScripts
+                               ? compile_project_script_for_cook(sourceScriptPath, project.root_path(), gameOutputRoot,
+                                                                 result.compiledScriptCount)
+                               : copy_project_relative_file_for_cook(sourceScriptPath, project.root_path(), gameOutputRoot,
+                                                                     result.copiedScriptCount);
+    }
+    if (!scriptCookResult)
+        return make_error(scriptCookResult.error());
+
+    CookManifestStep scriptStep{};
+    scriptStep.outputs.push_back(cook_output_key(session, gameOutputRoot / scriptCookResult.value()));
+    if (auto recordResult = record_cook_step(session, result, scriptKey, {sourceScriptPath}, std::move(scriptStep), start);
+        !recordResult)
+        return make_error(recordResult.error());
+    return {};
+}
+
+/// A model referenced by one or more levels, cooked once by its own task.
+struct CookModelJob
+{
+    std::string assetPath{};  // path of MeshComponent::asset as authored
+    std::string cookedPath{}; // relative to the game output; stays empty when the model failed to cook
+};
+
+Result<> cook_model(CookSession& session,
+                    CookProjectResult& result,
+                    const Project& project,
+                    CookModelJob& job,
+                    const std::filesystem::path& gameOutputRoot)
+{
+    const CookProjectOptions& options = session.options;
+    const std::string modelKey = "model:" + job.assetPath;
+    if (const CookManifestStep* reused = reuse_cook_step(session, result, modelKey))
+    {
+        if (auto textureResult = revisit_cook_textures(session, result, *reused, gameOutputRoot); !textureResult)
+            return textureResult;
+        job.cookedPath = reused->value;
+        return {};
+    }
+
+    // A model re-cooked after a change keeps the output path the previous cook gave it.
+    const CookManifestStep* previousModelStep = session.previous.find(modelKey);
+    const CookClock::time_point start = CookClock::now();
+    CookManifestStep modelStep{};
+
+    const std::filesystem::path sourceAssetPath = resolve_asset_path(job.assetPath, &project);
+    if (sourceAssetPath.extension() == ".noc_model")
+    {
+        std::filesystem::path cookedRelativePath = job.assetPath;
+        if (cookedRelativePath.is_absolute())
+            cookedRelativePath = previousModelStep
+                                     ? std::filesystem::path(previousModelStep->value)
+                                     : reserve_cooked_model_path(session, gameOutputRoot, sourceAssetPath.stem().string());
+        auto cachedModelResult = ModelLoader::read_cache(sourceAssetPath);
+        // Caches are re-cooked when they gain LOD levels or get compacted; the rest are copied as-is.
+        const bool addedLods =
+            cachedModelResult && options.generateLods && generate_model_lods_for_cook(*cachedModelResult.value(), result);
+        {
+            CookWriteSlot writeSlot{session};
+            if (cachedModelResult && (addedLods || options.compactVertices))
+            {
+                if (auto directoryResult = ensure_parent_directory(gameOutputRoot / cookedRelativePath); !directoryResult)
+                    return directoryResult;
+                if (auto writeResult = ModelLoader::write_cache(*cachedModelResult.value(), gameOutputRoot / cookedRelativePath,
+                                                                options.compactVertices);
+                    !writeResult)
+                    return make_error(writeResult.error());
+            }
+            else if (auto copyModelResult = copy_file_if_needed(sourceAssetPath, gameOutputRoot / cookedRelativePath, true);
+                     !copyModelResult)
+            {
+                return copyModelResult;
+            }
+        }
+
+        if (cachedModelResult)
+        {
+            for (const auto& material : cachedModelResult.value()->materials)
+            {
+                const std::array<const std::filesystem::path*, 5> texturePaths{
+                    &material.albedoTexturePath,    &material.normalTexturePath, &material.roughnessTexturePath,
+                    &material.metallicTexturePath, &material.aoTexturePath,
+                };
+                for (std::size_t slotIndex = 0; slotIndex < texturePaths.size(); ++slotIndex)
+                {
+                    const std::filesystem::path texturePath = resolve_asset_path(*texturePaths[slotIndex], &project);
+                    if (texturePath.empty())
+                        continue;
+
+                    auto textureCopyResult = copy_texture_for_cook(session, result, texturePath, gameOutputRoot, slotIndex);
+                    if (!textureCopyResult && options.strict)
+                        return make_error(textureCopyResult.error());
+                    if (textureCopyResult)
+                        modelStep.textures.push_back(texture_step_key(texturePath));
+                }
+            }
+        }
+
+        modelStep.value = cookedRelativePath.generic_string();
+        modelStep.outputs.push_back(cook_output_key(session, gameOutputRoot / cookedRelativePath));
+        if (auto recordResult = record_cook_step(session, result, modelKey, {sourceAssetPath}, std::move(modelStep), start);
+            !recordResult)
+            return make_error(recordResult.error());
+
+        job.cookedPath = cookedRelativePath.generic_string();
+        return {};
+    }
+
+    auto parsedModelResult = ModelLoader::parse_model(sourceAssetPath);
+    if (!parsedModelResult)
+        return make_error(parsedModelResult.error());
+
+    // Packed ORM maps are built from the textures, so their sources are inputs of the model too.
+    std::vector<std::filesystem::path> modelInputs{sourceAssetPath};
+    for (const std::filesystem::path& library : collect_obj_material_libraries(sourceAssetPath))
+        modelInputs.push_back(library);
+
+    ModelData cookedModel = *parsedModelResult.value();
+    for (auto& material : cookedModel.materials)
+    {
+        const std::array<std::filesystem::path*, 5> texturePaths{
+            &material.albedoTexturePath,    &material.normalTexturePath, &material.roughnessTexturePath,
+            &material.metallicTexturePath, &material.aoTexturePath,
+        };
+        for (std::size_t slotIndex = 0; slotIndex < texturePaths.size(); ++slotIndex)
+        {
+            std::filesystem::path* texturePath = texturePaths[slotIndex];
+            if (texturePath->empty())
+                continue;
+
+            auto textureCopyResult = copy_texture_for_cook(session, result, *texturePath, gameOutputRoot, slotIndex);
+            if (!textureCopyResult)
+            {
+                if (options.strict)
+                    return make_error(textureCopyResult.error());
+
+                result.warnings.push_back(textureCopyResult.error().message);
+                texturePath->clear();
+                continue;
+            }
+
+            modelInputs.push_back(*texturePath);
+            modelStep.textures.push_back(texture_step_key(*texturePath));
+            *texturePath = textureCopyResult.value();
+        }
+
+        // The separate copies stay in the output; only the cooked model switches to the packed map.
+        const std::string modelName = cookedModel.name.empty() ? sourceAssetPath.stem().string() : cookedModel.name;
+        const std::filesystem::path unpackedAoPath = material.aoTexturePath;
+        if (auto packResult = pack_material_orm_for_cook(session, result, material, modelName, gameOutputRoot); !packResult)
+        {
+            if (options.strict)
+                return packResult;
+            result.warnings.push_back(
+                fmt::format("Material '{}' keeps separate ORM maps: {}", material.name, packResult.error().message));
+        }
+        else if (material.aoTexturePath != unpackedAoPath)
+        {
+            modelStep.outputs.push_back(cook_output_key(session, gameOutputRoot / material.aoTexturePath));
+        }
+    }
+
+    if (options.generateLods)
+        generate_model_lods_for_cook(cookedModel, result);
+
+    const std::string preferredName = cookedModel.name.empty() ? sourceAssetPath.stem().string() : cookedModel.name;
+    const std::filesystem::path cookedRelativePath = previousModelStep
+                                                         ? std::filesystem::path(previousModelStep->value)
+                                                         : reserve_cooked_model_path(session, gameOutputRoot, preferredName);
+    {
+        CookWriteSlot writeSlot{session};
+        if (auto writeResult = ModelLoader::write_cache(cookedModel, gameOutputRoot / cookedRelativePath, options.compactVertices);
+            !writeResult)
+            return make_error(writeResult.error());
+    }
+    ++result.cookedModelCount;
+
+    modelStep.value = cookedRelativePath.generic_string();
+    modelStep.outputs.push_back(cook_output_key(session, gameOutputRoot / cookedRelativePath));
+    if (auto recordResult = record_cook_step(session, result, modelKey, modelInputs, std::move(modelStep), start); !recordResult)
+        return make_error(recordResult.error());
+
+    job.cookedPath = cookedRelativePath.generic_string();
+    return {};
+}
+
+/// A project level, loaded before the cook graph is built so models shared between levels cook once.
+struct CookLevelJob
+{
+    const LevelEntry* entry{};
+    std::filesystem::path sourcePath{};
+    Level level;
+    std::vector<AssetId> modelAssets{}; // keys into the cook's model jobs
+};
+
+/// Points the level's meshes at their cooked models, cooks its collision shapes and saves it.
+/// The cooked level and its shapes only change with the level file or its cooked models.
+Result<> cook_level(CookSession& session,
+                    CookProjectResult& result,
+                    CookLevelJob& job,
+                    const std::map<AssetId, CookModelJob>& modelJobs,
+                    PhysicsWorld& shapeCooker,
+                    bool& shapeCookerReady,
+                    const std::filesystem::path& gameOutputRoot)
+{
+    const CookProjectOptions& options = session.options;
+
+    std::set<std::string> levelModelPaths;
+    auto& registry = job.level.world().registry();
+    auto view = registry.view<MeshComponent>();
+    for (auto entity : view)
+    {
+        auto& meshComponent = view.get<MeshComponent>(entity);
+        if (!meshComponent.asset.is_valid())
+            continue;
+
+        // A model that failed has reported why; the level is not saved against a missing model.
+        const auto modelIt = modelJobs.find(meshComponent.asset);
+        if (modelIt == modelJobs.end() || modelIt->second.cookedPath.empty())
+            return {};
+
+        meshComponent.asset = AssetRegistry::get().intern(modelIt->second.cookedPath);
+        levelModelPaths.insert(modelIt->second.cookedPath);
+    }
+
+    const std::string levelKey = "level:" + job.entry->filePath;
+    if (reuse_cook_step(session, result, levelKey))
+        return {};
+
+    const CookClock::time_point levelStart = CookClock::now();
+    CookManifestStep levelStep{};
+    std::vector<std::filesystem::path> levelInputs{job.sourcePath};
+    for (const std::string& modelPath : levelModelPaths)
+        levelInputs.push_back(gameOutputRoot / modelPath);
+
+    if (options.cookCollisionShapes)
+    {
+        if (!shapeCookerReady)
+        {
+            if (auto initResult = shapeCooker.initialize(); !initResult)
+                return make_error(initResult.error());
+            shapeCooker.set_asset_root(gameOutputRoot.string());
+            shapeCookerReady = true;
+        }
+
+        auto shapeResult = shapeCooker.cook_collision_shapes(job.level.world());
+        if (shapeResult)
+            result.cookedCollisionShapeCount += shapeResult.value();
+        else if (options.strict)
+            return make_error(shapeResult.error());
+        else
+            result.warnings.push_back(fmt::format("Level '{}' ships without cooked collision shapes: {}", job.entry->filePath,
+                                                  shapeResult.error().message));
+
+        // Shapes sit next to the cooked models (CollisionShapeCache::get_cooked_path).
+        std::error_code ec;
+        for (const std::string& modelPath : levelModelPaths)
+        {
+            const std::filesystem::path shapePath = (gameOutputRoot / modelPath).replace_extension(".noc_shapes");
+            if (std::filesystem::exists(shapePath, ec))
+                levelStep.outputs.push_back(cook_output_key(session, shapePath));
+        }
+    }
+
+    const std::filesystem::path cookedLevelPath = gameOutputRoot / job.entry->filePath;
+    {
+        CookWriteSlot writeSlot{session};
+        if (auto saveResult = job.level.save_as(cookedLevelPath.string()); !saveResult)
+            return make_error(saveResult.error());
+    }
+
+    ++result.cookedLevelCount;
+    levelStep.outputs.push_back(cook_output_key(session, cookedLevelPath));
+    if (auto recordResult = record_cook_step(session, result, levelKey, levelInputs, std::move(levelStep), levelStart);
+        !recordResult)
+        return make_error(recordResult.error());
+    return {};
+}
+
+/// Replaces `contentRoot` with the archive of everything cooked into `cookRoot`. The project file
+/// stays loose so the game can discover it; the cook manifest stays behind with the cook.
+/// True for a cooked raw image whose .noc_texture sidecar was decoded from it. The runtime loads
+/// the sidecar and never reads the image, so the archive leaves it out.
+bool superseded_by_texture_sidecar(const std::filesystem::path& path)
+{
+    const std::filesystem::path sidecarPath = TextureLoader::get_cache_path(path);
+    std::error_code ec;
+    if (path.extension() == sidecarPath.extension() || !std::filesystem::exists(sidecarPath, ec))
+        return false;
+
+    // Same-named images from different folders share one sidecar; it only replaces its own source.
+    auto sidecarResult = TextureLoader::read_cache(sidecarPath);
+    return sidecarResult && std::filesystem::equivalent(sidecarResult.value()->sourcePath, path, ec);
+}
+
+Result<PackArchiveStats> pack_cooked_content(const std::filesystem::path& cookRoot,
+                                             const std::filesystem::path& contentRoot,
+                                             const std::filesystem::path& cookedProjectFile)
+{
+    const std::filesystem::path manifestPath = CookManifest::get_path(cookRoot);
+    std::vector<std::filesystem::path> files{};
+    std::error_code ec;
+    for (const auto& entry :
+         std::filesystem::recursive_directory_iterator(cookRoot, std::filesystem::directory_options::skip_permission_denied, ec))
+    {
+        if (entry.is_regular_file() && entry.path() != manifestPath && entry.path() != cookedProjectFile &&
+            !superseded_by_texture_sidecar(entry.path()))
+            files.push_back(entry.path());
+    }
+    if (ec)
+        return make_error(fmt::format("Failed to list cooked content '{}': {}", cookRoot.string(), ec.message()),
+                          ErrorCode::AssetFileNotFound);
+    // Index order is by hash anyway; sorting keeps the entry layout stable between bundles.
+    std::ranges::sort(files);
+
+    std::filesystem::remove_all(contentRoot, ec);
+    const std::filesystem::path projectRelativePath = std::filesystem::relative(cookedProjectFile, cookRoot, ec);
+    if (auto copyResult = copy_file_if_needed(cookedProjectFile, contentRoot / projectRelativePath, true); !copyResult)
+        return make_error(copyResult.error());
+
+    return PackArchive::build(cookRoot, files, contentRoot / PackArchive::ContentArchiveName);
+}
+
+Result<std::filesystem::path> detect_runtime_binary_root()
+{
+    const RuntimePaths* runtimePaths = RuntimePaths::try_current();
+    if (!runtimePaths)
+        return make_error("RuntimePaths is not initialized", ErrorCode::AssetFileNotFound);
+
+    const std::array<std::filesystem::path, 2> candidates{
+        runtimePaths->executable_dir().parent_path() / "Game",
+        runtimePaths->executable_dir(),
+    };
+
+    for (const auto& candidate : candidates)
+    {
+        if (std::filesystem::exists(candidate / "Game.exe"))
+            return candidate;
+    }
+
+    return make_error("Failed to locate the Game runtime binaries. Pass --runtime-dir explicitly.",
+                      ErrorCode::AssetFileNotFound);
+}
+ 
+} // namespace
+
+Result<> clear_runtime_scene(IRenderer& renderer,
+                             AssetManager& assetManager,
+                             ScriptEngine& scriptEngine,
+                             PhysicsWorld& physicsWorld,
+                             Level* loadedLevel)
+{
+    renderer.wait_idle();
+    renderer.set_renderables({});
+    physicsWorld.clear();
+
+    if (loadedLevel)
+        scriptEngine.on_world_destroyed(loadedLevel->world());
+
+    if (auto clearResult = renderer.clear_scene_content(); !clearResult)
+        return make_error(clearResult.error());
+
+    assetManager.clear_materials();
+    assetManager.clear_textures();
+    assetManager.clear_models();
+    assetManager.clear_meshes();
+    return {};
+}
+
+Result<RuntimeLoadReport> prepare_loaded_level(AssetManager& assetManager,
+                                               IRenderer& renderer,
+                                               ScriptEngine& scriptEngine,
+                                               PhysicsWorld& physicsWorld,
+                                               Level& level,
+                                               Project* project,
+                                               const RuntimeLoadOptions& options)
+{
+    NOC_PROFILE_ZONE("prepare_loaded_level");
+    RuntimeLoadReport report;
+    configure_level_runtime(renderer, scriptEngine, physicsWorld, project, options, report);
+
+    renderer.wait_idle();
+    auto assetReportResult = reload_level_assets(assetManager, renderer, level.world(), project, options.requireCookedModels);
+    if (!assetReportResult)
+        return make_error(assetReportResult.error());
+
+    merge_asset_report(report, assetReportResult.value());
+
+    RuntimeLoadReport materialReport =
+        load_project_material_overrides(assetManager, renderer, level.world(), project,
+                                        options.allowEmbeddedMaterialTextureExtraction);
+    report.warnings.insert(report.warnings.end(), materialReport.warnings.begin(), materialReport.warnings.end());
+
+    // Every mesh/texture upload above was only queued; submit them as one batch set and wait once.
+    auto uploadTicketResult = renderer.flush_uploads();
+    if (!uploadTicketResult)
+        return make_error(uploadTicketResult.error());
+    if (auto waitResult = renderer.wait_for_uploads(uploadTicketResult.value()); !waitResult)
+        return make_error(waitResult.error());
+
+    // Everything loaded so far now has a GPU copy; payloads over the CPU budget can go.
+    report.releasedCpuAssetBytes = assetManager.mark_gpu_resident();
+    if (options.releaseCpuGeometryAfterUpload)
+        report.releasedCpuAssetBytes += assetManager.release_cpu_geometry();
+
+    return report;
+}
+
+//    Level streaming
+
+float LevelStreamProgress::fraction() const noexcept
+{
+    if (state == LevelStreamState::Ready)
+        return 1.0f;
+    if (state == LevelStreamState::Idle || state == LevelStreamState::Failed)
+        return 0.0f;
+
+    // Reading and decoding fill the first half, uploads the second.
+    const std::uint32_t readTotal = modelCount + textureCount;
+    const float readFraction =
+        readTotal > 0 ? static_cast<float>(modelsRead + texturesDecoded) / static_cast<float>(readTotal) : 0.0f;
+    if (state == LevelStreamState::Reading)
+        return 0.5f * readFraction;
+
+    const float uploadFraction =
+        modelCount > 0 ? static_cast<float>(modelsUploaded) / static_cast<float>(modelCount) : 1.0f;
+    return 0.5f + 0.5f * std::min(uploadFraction, 1.0f);
+}
+
+struct LevelStreamer::Impl
+{
+    /// Written by background jobs; shared so jobs never outlive their target.
+    struct Staging
+    {
+        std::mutex mutex{};
+        std::unique_ptr<Level> level{};
+        std::vector<std::pair<std::filesystem::path, std::shared_ptr<ModelData>>> models{};
+        std::vector<std::pair<std::filesystem::path, std::shared_ptr<TextureData>>> textures{};
+        std::set<std::filesystem::path> claimedTextures{};
+        std::vector<std::string> warnings{};
+        std::optional<Error> error{};
+
+        std::atomic<std::uint32_t> pendingJobs{0};
+        std::atomic<bool> cancelled{false};
+        std::atomic<std::uint32_t> modelCount{0};
+        std::atomic<std::uint32_t> modelsRead{0};
+        std::atomic<std::uint32_t> textureCount{0};
+        std::atomic<std::uint32_t> texturesDecoded{0};
+
+        void fail(Error failure)
+        {
+            std::lock_guard lock{mutex};
+            if (!error)
+                error = std::move(failure);
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    AssetManager& assetManager;
+    IRenderer& renderer;
+    ScriptEngine& scriptEngine;
+    PhysicsWorld& physicsWorld;
+    std::size_t uploadBudgetBytes{DefaultUploadBudgetBytes};
+
+    LevelStreamState state{LevelStreamState::Idle};
+    Project* project{nullptr};
+    RuntimeLoadOptions options{};
+    std::shared_ptr<Staging> staging{};
+    std::unique_ptr<Level> level{};
+    std::optional<LevelAssetUpload> upload{};
+    UploadTicket lastTicket{0};
+    RuntimeLoadReport report{};
+
+    Impl(AssetManager& assets, IRenderer& gpu, ScriptEngine& scripts, PhysicsWorld& physics)
+        : assetManager{assets}, renderer{gpu}, scriptEngine{scripts}, physicsWorld{physics}
+    {
+    }
+
+    void wait_for_reader() const
+    {
+        while (staging && staging->pendingJobs.load(std::memory_order_acquire) > 0)
+            std::this_thread::yield();
+    }
+
+    static void finish_job(Staging& stage)
+    {
+        stage.pendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    static void decode_texture(const std::shared_ptr<Staging>& stage, std::filesystem::path texturePath)
+    {
+        if (!stage->cancelled.load(std::memory_order_relaxed))
+        {
+            auto decoded = TextureLoader::load_image(texturePath.string());
+            std::lock_guard lock{stage->mutex};
+            if (decoded)
+                stage->textures.emplace_back(std::move(texturePath), std::move(decoded.value()));
+            else
+                stage->warnings.push_back(
+                    fmt::format("Failed to decode texture '{}': {}", texturePath.string(), decoded.error().message));
+        }
+        stage->texturesDecoded.fetch_add(1, std::memory_order_relaxed);
+        finish_job(*stage);
+    }
+
+    static void read_model(const std::shared_ptr<Staging>& stage, std::filesystem::path modelPath, const Project* project)
+    {
+        if (!stage->cancelled.load(std::memory_order_relaxed))
+        {
+            std::shared_ptr<ModelData> model = ModelLoader{}(modelPath);
+            if (model)
+            {
+                // Each texture is decoded once even when several models share it.
+                for (auto& texturePath : collect_model_texture_load_paths(*model, project))
+                {
+                    {
+                        std::lock_guard lock{stage->mutex};
+                        if (!stage->claimedTextures.insert(texturePath).second)
+                            continue;
+                    }
+                    stage->textureCount.fetch_add(1, std::memory_order_relaxed);
+                    stage->pendingJobs.fetch_add(1, std::memory_order_acq_rel);
+                    JobSystem::get().submit(JobPriority::Background,
+                                            [stage, texturePath = std::move(texturePath)]() mutable {
+                                                decode_texture(stage, std::move(texturePath));
+                                            });
+                }
+
+                std::lock_guard lock{stage->mutex};
+                stage->models.emplace_back(std::move(modelPath), std::move(model));
+            }
+            else
+            {
+                std::lock_guard lock{stage->mutex};
+                stage->warnings.push_back(fmt::format("Failed to reload model '{}'", modelPath.string()));
+            }
+        }
+        stage->modelsRead.fetch_add(1, std::memory_order_relaxed);
+        finish_job(*stage);
+    }
+
+    static void read_level(const std::shared_ptr<Staging>& stage, const std::filesystem::path& levelPath,
+                           const Project* project, bool requireCookedModels)
+    {
+        auto levelResult = Level::load(levelPath.string());
+        if (!levelResult)
+        {
+            stage->fail(levelResult.error());
+            finish_job(*stage);
+            return;
+        }
+
+        auto loadedLevel = std::make_unique<Level>(std::move(levelResult.value()));
+        const std::vector<AssetId> modelAssets = collect_level_model_assets(loadedLevel->world());
+        {
+            std::lock_guard lock{stage->mutex};
+            stage->level = std::move(loadedLevel);
+        }
+
+        for (const AssetId asset : modelAssets)
+        {
+            const std::string_view assetPath = AssetRegistry::get().path_of(asset);
+            std::filesystem::path resolvedPath = resolve_asset_path(assetPath, project);
+            if (auto cookedResult = check_cooked_model_path(resolvedPath, assetPath, requireCookedModels); !cookedResult)
+            {
+                stage->fail(cookedResult.error());
+                break;
+            }
+
+            stage->modelCount.fetch_add(1, std::memory_order_relaxed);
+            stage->pendingJobs.fetch_add(1, std::memory_order_acq_rel);
+            JobSystem::get().submit(JobPriority::Background,
+                                    [stage, resolvedPath = std::move(resolvedPath), project]() mutable {
+                                        read_model(stage, std::move(resolvedPath), project);
+                                    });
+        }
+        finish_job(*stage);
     }
 
-    return {};
-}
+    Result<> upload_slice()
+    {
+        std::size_t queuedBytes = 0;
+        do
+        {
+            queuedBytes += upload_next_level_model(*upload, assetManager, renderer, project);
+        } while (!upload->done() && queuedBytes < uploadBudgetBytes);
 
-Result<std::filesystem::path> detect_runtime_binary_root()
-{
-    const RuntimePaths* runtimePaths = RuntimePaths::try_current();
-    if (!runtimePaths)
-        return make_error("RuntimePaths is not initialized", ErrorCode::AssetFileNotFound);
+        if (upload->done())
+        {
+            bind_level_meshes(*upload, level->world());
+            merge_asset_report(report, upload->report);
 
-    const std::array<std::filesystem::path, 2> candidates{
-        runtimePaths->executable_dir().parent_path() / "Game",
-        runtimePaths->executable_dir(),
-    };
+            RuntimeLoadReport materialReport = load_project_material_overrides(
+                assetManager, renderer, level->world(), project, options.allowEmbeddedMaterialTextureExtraction);
+            report.warnings.insert(report.warnings.end(), materialReport.warnings.begin(), materialReport.warnings.end());
+            state = LevelStreamState::Finalizing;
+        }
 
-    for (const auto& candidate : candidates)
+        auto ticketResult = renderer.flush_uploads();
+        if (!ticketResult)
+            return make_error(ticketResult.error());
+        lastTicket = ticketResult.value();
+        return {};
+    }
+
+    void finalize()
     {
-        if (std::filesystem::exists(candidate / "Game.exe"))
-            return candidate;
+        report.releasedCpuAssetBytes = assetManager.mark_gpu_resident();
+        if (options.releaseCpuGeometryAfterUpload)
+            report.releasedCpuAssetBytes += assetManager.release_cpu_geometry();
+        upload.reset();
+        state = LevelStreamState::Ready;
     }
+};
 
-    return make_error("Failed to locate the Game runtime binaries. Pass --runtime-dir explicitly.",
-                      ErrorCode::AssetFileNotFound);
+LevelStreamer::LevelStreamer(AssetManager& assetManager, IRenderer& renderer, ScriptEngine& scriptEngine,
+                             PhysicsWorld& physicsWorld)
+    : m_impl{std::make_unique<Impl>(assetManager, renderer, scriptEngine, physicsWorld)}
+{
 }
- 
-} // namespace
 
-Result<> clear_runtime_scene(IRenderer& renderer,
-                             AssetManager& assetManager,
-                             ScriptEngine& scriptEngine,
-                             PhysicsWorld& physicsWorld,
-                             Level* loadedLevel)
+LevelStreamer::~LevelStreamer()
 {
-    renderer.wait_idle();
-    renderer.set_renderables({});
-    physicsWorld.clear();
-
-    if (loadedLevel)
-        scriptEngine.on_world_destroyed(loadedLevel->world());
-
-    if (auto clearResult = renderer.clear_scene_content(); !clearResult)
-        return make_error(clearResult.error());
+    if (m_impl->staging)
+        m_impl->staging->cancelled.store(true, std::memory_order_relaxed);
+    m_impl->wait_for_reader();
+}
 
-    assetManager.clear_materials();
-    assetManager.clear_textures();
-    assetManager.clear_models();
-    assetManager.clear_meshes();
+Result<> LevelStreamer::begin(const std::filesystem::path& levelPath, Project* project, const RuntimeLoadOptions& options)
+{
+    if (is_busy())
+        return make_error("A level is already streaming", ErrorCode::AssetInvalidData);
+
+    m_impl->wait_for_reader(); // a failed load may still have jobs winding down
+    m_impl->project = project;
+    m_impl->options = options;
+    m_impl->report = {};
+    m_impl->level.reset();
+    m_impl->upload.reset();
+    m_impl->staging = std::make_shared<Impl::Staging>();
+    m_impl->staging->pendingJobs.store(1, std::memory_order_relaxed);
+    m_impl->state = LevelStreamState::Reading;
+
+    JobSystem::get().submit(JobPriority::Background,
+                            [stage = m_impl->staging, levelPath, project, requireCooked = options.requireCookedModels]() {
+                                Impl::read_level(stage, levelPath, project, requireCooked);
+                            });
     return {};
 }
 
-Result<RuntimeLoadReport> prepare_loaded_level(AssetManager& assetManager,
-                                               IRenderer& renderer,
-                                               ScriptEngine& scriptEngine,
-                                               PhysicsWorld& physicsWorld,
-                                               Level& level,
-                                               Project* project,
-                                               const RuntimeLoadOptions& options)
+Result<LevelStreamState> LevelStreamer::pump()
 {
-    RuntimeLoadReport report;
-    const RuntimePaths* runtimePaths = RuntimePaths::try_current();
-
-    if (project && options.seedProjectDefaults)
+    Impl& impl = *m_impl;
+    switch (impl.state)
     {
-        if (auto defaultsResult = seed_project_defaults(*project); !defaultsResult)
-            report.warnings.push_back(defaultsResult.error().message);
-    }
-
-    if (project)
+    case LevelStreamState::Reading:
     {
-        scriptEngine.set_script_root(project->root_path());
-        physicsWorld.set_asset_root(project->root_path());
+        if (impl.staging->pendingJobs.load(std::memory_order_acquire) > 0)
+            break;
+
+        Impl::Staging& stage = *impl.staging;
+        impl.report.warnings.insert(impl.report.warnings.end(), stage.warnings.begin(), stage.warnings.end());
+        if (stage.error)
+        {
+            impl.state = LevelStreamState::Failed;
+            return make_error(*stage.error);
+        }
+        impl.state = LevelStreamState::Staged;
+        break;
     }
-    else if (runtimePaths)
-    {
-        scriptEngine.set_script_root(runtimePaths->executable_dir());
-        physicsWorld.set_asset_root(std::string{});
+    case LevelStreamState::Uploading:
+        if (auto sliceResult = impl.upload_slice(); !sliceResult)
+        {
+            impl.state = LevelStreamState::Failed;
+            return make_error(sliceResult.error());
+        }
+        break;
+    case LevelStreamState::Finalizing:
+        if (impl.renderer.is_upload_complete(impl.lastTicket))
+            impl.finalize();
+        break;
+    default:
+        break;
     }
+    return impl.state;
+}
 
-    if (runtimePaths)
+Result<> LevelStreamer::swap_in(Level* liveLevel)
+{
+    Impl& impl = *m_impl;
+    if (impl.state != LevelStreamState::Staged)
+        return make_error("swap_in() needs a staged level", ErrorCode::AssetInvalidData);
+
+    if (auto clearResult = clear_runtime_scene(impl.renderer, impl.assetManager, impl.scriptEngine, impl.physicsWorld,
+                                               liveLevel);
+        !clearResult)
     {
-        const std::filesystem::path defaultVert = runtimePaths->resolve_engine_resource("shader.vert");
-        const std::filesystem::path defaultFrag = runtimePaths->resolve_engine_resource("shader.frag");
-        renderer.set_shader_paths(defaultVert, defaultFrag);
+        impl.state = LevelStreamState::Failed;
+        return make_error(clearResult.error());
     }
-    else
+
+    configure_level_runtime(impl.renderer, impl.scriptEngine, impl.physicsWorld, impl.project, impl.options,
+                            impl.report);
+
+    // Hand the decoded payloads to the asset manager, so the upload below finds them cached.
+    Impl::Staging& stage = *impl.staging;
+    for (auto& [path, model] : stage.models)
+        impl.assetManager.load_model(path.string(), std::move(model));
+    for (auto& [path, texture] : stage.textures)
+        impl.assetManager.load_texture(path.string(), std::move(texture));
+    impl.level = std::move(stage.level);
+    impl.staging.reset();
+
+    auto uploadResult = begin_level_asset_upload(impl.assetManager, impl.level->world(), impl.project,
+                                                 impl.options.requireCookedModels);
+    if (!uploadResult)
     {
-        renderer.set_shader_paths("Resources/shader.vert", "Resources/shader.frag");
+        impl.state = LevelStreamState::Failed;
+        return make_error(uploadResult.error());
     }
+    impl.upload = std::move(uploadResult.value());
+    impl.state = LevelStreamState::Uploading;
+    return {};
+}
 
-    if (project)
+std::unique_ptr<Level> LevelStreamer::take_level()
+{
+    if (m_impl->state != LevelStreamState::Ready)
+        return nullptr;
+    m_impl->state = LevelStreamState::Idle;
+    return std::move(m_impl->level);
+}
+
+const RuntimeLoadReport& LevelStreamer::get_report() const noexcept
+{
+    return m_impl->report;
+}
+
+LevelStreamProgress LevelStreamer::get_progress() const noexcept
+{
+    const Impl& impl = *m_impl;
+    LevelStreamProgress progress{};
+    progress.state = impl.state;
+    if (impl.staging)
     {
-        const std::filesystem::path projectVert = project->get_absolute_path(std::filesystem::path("Assets") / "Shaders" / "shader.vert");
-        const std::filesystem::path projectFrag = project->get_absolute_path(std::filesystem::path("Assets") / "Shaders" / "shader.frag");
-        if (std::filesystem::exists(projectVert) && std::filesystem::exists(projectFrag))
-        {
-            const bool projectSupportsGlow = !options.requireGlowShaders ||
-                                             (file_contains(projectVert, "inGlow") && file_contains(projectFrag, "fragGlow"));
-            if (projectSupportsGlow)
-            {
-                renderer.set_shader_paths(projectVert, projectFrag);
-                report.usedProjectShaders = true;
-            }
-            else
-            {
-                report.warnings.push_back(
-                    "Project shaders are missing glow support. Using the engine default shaders for this session.");
-            }
-        }
+        progress.modelCount = impl.staging->modelCount.load(std::memory_order_relaxed);
+        progress.modelsRead = impl.staging->modelsRead.load(std::memory_order_relaxed);
+        progress.textureCount = impl.staging->textureCount.load(std::memory_order_relaxed);
+        progress.texturesDecoded = impl.staging->texturesDecoded.load(std::memory_order_relaxed);
     }
+    else if (impl.upload)
+    {
+        progress.modelCount = progress.modelsRead = static_cast<std::uint32_t>(impl.upload->models.size());
+        progress.modelsUploaded = static_cast<std::uint32_t>(impl.upload->nextModel);
+    }
+    return progress;
+}
 
-    renderer.wait_idle();
-    auto assetReportResult = reload_level_assets(assetManager, renderer, level.world(), project, options.requireCookedModels);
-    if (!assetReportResult)
-        return make_error(assetReportResult.error());
-
-    const RuntimeLoadReport& assetReport = assetReportResult.value();
-    report.totalMeshes += assetReport.totalMeshes;
-    report.totalMaterials += assetReport.totalMaterials;
-    report.usedRawSourceAssets = assetReport.usedRawSourceAssets;
-    report.warnings.insert(report.warnings.end(), assetReport.warnings.begin(), assetReport.warnings.end());
+LevelStreamState LevelStreamer::get_state() const noexcept
+{
+    return m_impl->state;
+}
 
-    RuntimeLoadReport materialReport =
-        load_project_material_overrides(assetManager, renderer, level.world(), project,
-                                        options.allowEmbeddedMaterialTextureExtraction);
-    report.warnings.insert(report.warnings.end(), materialReport.warnings.begin(), materialReport.warnings.end());
+bool LevelStreamer::is_busy() const noexcept
+{
+    return m_impl->state != LevelStreamState::Idle && m_impl->state != LevelStreamState::Failed;
+}
 
-    return report;
+void LevelStreamer::set_upload_budget(std::size_t bytesPerPump) noexcept
+{
+    m_impl->uploadBudgetBytes = bytesPerPump;
 }
 
 std::vector<std::string> scan_available_scripts(const Project* project)
@@ -924,22 +2301,15 @@ bool load_material_from_file(const std::filesystem::path& filePath,
 {
     namespace fb = NatureOfCraft::Assets;
 
-    std::ifstream ifs(filePath, std::ios::binary | std::ios::ate);
-    if (!ifs)
-        return false;
-
-    const auto size = ifs.tellg();
-    ifs.seekg(0);
-    std::vector<std::uint8_t> buffer(static_cast<std::size_t>(size));
-    ifs.read(reinterpret_cast<char*>(buffer.data()), size);
-    if (!ifs)
+    auto file = VirtualFileSystem::get().open(filePath);
+    if (!file)
         return false;
 
-    flatbuffers::Verifier verifier(buffer.data(), buffer.size());
+    flatbuffers::Verifier verifier(file->data(), file->size());
     if (!fb::VerifyMaterialAssetBuffer(verifier))
         return false;
 
-    const auto* asset = fb::GetMaterialAsset(buffer.data());
+    const auto* asset = fb::GetMaterialAsset(file->data());
     if (!asset)
         return false;
 
@@ -986,21 +2356,10 @@ bool load_material_from_file(const std::filesystem::path& filePath,
 
 std::vector<std::filesystem::path> scan_material_files(const Project* project)
 {
-    std::vector<std::filesystem::path> result;
     if (!project)
-        return result;
-
-    const std::filesystem::path root(project->root_path());
-    if (!std::filesystem::exists(root))
-        return result;
-
-    for (const auto& entry : std::filesystem::recursive_directory_iterator(root))
-    {
-        if (entry.is_regular_file() && entry.path().extension() == ".noc_material")
-            result.push_back(entry.path());
-    }
+        return {};
 
-    return result;
+    return VirtualFileSystem::get().list_files(project->root_path(), ".noc_material");
 }
 
 Result<CookProjectResult> cook_project(const std::filesystem::path& projectFilePath, const CookProjectOptions& options)
@@ -1015,8 +2374,19 @@ Result<CookProjectResult> cook_project(const std::filesystem::path& projectFileP
     Project project = std::move(projectResult.value());
     CookProjectResult result;
 
+    // An incremental cook keeps the previous output when its manifest was written with the same options.
+    CookManifest previousManifest{};
+    if (options.incremental)
+    {
+        auto manifestResult = CookManifest::read(CookManifest::get_path(options.outputRoot));
+        if (manifestResult && manifestResult->optionsHash == hash_cook_options(options))
+            previousManifest = std::move(manifestResult.value());
+    }
+    const bool reuseOutput = !previousManifest.steps.empty();
+    CookSession session{options, result, std::move(previousManifest)};
+
     std::error_code ec;
-    if (options.overwriteOutput)
+    if (options.overwriteOutput && !reuseOutput)
         std::filesystem::remove_all(options.outputRoot, ec);
 
     std::filesystem::create_directories(options.outputRoot, ec);
@@ -1033,61 +2403,95 @@ Result<CookProjectResult> cook_project(const std::filesystem::path& projectFileP
         return make_error(fmt::format("Failed to create cooked game output '{}': {}", gameOutputRoot.string(), ec.message()),
                           ErrorCode::AssetCacheWriteFailed);
 
-    const RuntimePaths* runtimePaths = RuntimePaths::try_current();
-    if (runtimePaths)
+    // Every level is loaded up front, so scripts, materials and models shared between levels cook once.
+    std::vector<CookLevelJob> levelJobs{};
+    levelJobs.reserve(project.levels().size());
+    std::set<std::string> scriptPaths;
+    std::set<std::string> materialNames;
+    std::map<AssetId, CookModelJob> modelJobs;
+    for (const auto& levelEntry : project.levels())
     {
-        if (auto copyEngineResult = copy_engine_runtime_resources(*runtimePaths, engineOutputRoot, options.compileShaders, result);
-            !copyEngineResult)
-        {
-            return make_error(copyEngineResult.error());
-        }
+        const std::filesystem::path sourceLevelPath = project.get_absolute_path(levelEntry.filePath);
+        auto levelResult = Level::load(sourceLevelPath.string());
+        if (!levelResult)
+            return make_error(levelResult.error());
+
+        CookLevelJob& levelJob = levelJobs.emplace_back(&levelEntry, sourceLevelPath, std::move(levelResult.value()));
+        scriptPaths.merge(collect_referenced_script_paths(levelJob.level.world()));
+        materialNames.merge(collect_referenced_material_names(levelJob.level.world()));
+        levelJob.modelAssets = collect_level_model_assets(levelJob.level.world());
+        for (const AssetId asset : levelJob.modelAssets)
+            modelJobs.try_emplace(asset, CookModelJob{std::string{AssetRegistry::get().path_of(asset)}});
     }
 
-    if (auto copyProjectResult =
-            copy_file_if_needed(projectFilePath, gameOutputRoot / projectFilePath.filename(), true);
-        !copyProjectResult)
+    // Output paths the previous cook gave its models stay theirs; new models are named around them.
+    for (const auto& [asset, modelJob] : modelJobs)
     {
-        return make_error(copyProjectResult.error());
+        if (const CookManifestStep* previousStep = session.previous.find("model:" + modelJob.assetPath))
+            session.claimedModelPaths.insert(previousStep->value);
     }
+
+    const auto materialLookup = build_project_material_lookup(project, result);
+
+    // Shapes are built from the cooked models, so the cooker's physics world looks them up in the output.
+    // Only created once a level actually needs its shapes cooked.
+    PhysicsWorld shapeCooker;
+    bool shapeCookerReady = false;
+
+    tf::Taskflow taskflow{"CookProject"};
+
+    const RuntimePaths* runtimePaths = RuntimePaths::try_current();
+    if (runtimePaths)
+        emplace_engine_cook_tasks(taskflow, session, *runtimePaths, engineOutputRoot);
+
     result.cookedProjectFile = gameOutputRoot / projectFilePath.filename();
+    emplace_cook_task(taskflow, session, "project", [&](CookProjectResult& taskResult) -> Result<> {
+        if (auto copyResult = cook_copy_step(session, taskResult, "project", projectFilePath, result.cookedProjectFile);
+            !copyResult)
+            return make_error(copyResult.error());
+        return {};
+    });
 
     const std::filesystem::path sourceShadersDir = std::filesystem::path(project.root_path()) / "Assets" / "Shaders";
-    const std::filesystem::path sourceProjectVert = sourceShadersDir / "shader.vert";
-    const std::filesystem::path sourceProjectFrag = sourceShadersDir / "shader.frag";
-    if (std::filesystem::exists(sourceProjectVert) && std::filesystem::exists(sourceProjectFrag))
+    const bool hasProjectVert = std::filesystem::exists(sourceShadersDir / "shader.vert");
+    const bool hasProjectFrag = std::filesystem::exists(sourceShadersDir / "shader.frag");
+    if (hasProjectVert && hasProjectFrag)
     {
         const std::filesystem::path outputShaderDir = gameOutputRoot / "Assets" / "Shaders";
-        std::filesystem::create_directories(outputShaderDir, ec);
-        if (ec)
+        for (const std::string_view shaderName : {"shader.vert", "shader.frag"})
         {
-            return make_error(fmt::format("Failed to create shader output '{}': {}", outputShaderDir.string(), ec.message()),
-                              ErrorCode::AssetCacheWriteFailed);
-        }
+            const std::string shaderKey = fmt::format("project-shader:{}", shaderName);
+            emplace_cook_task(taskflow, session, shaderKey, [&, shaderKey, shaderName](CookProjectResult& taskResult) -> Result<> {
+                if (reuse_cook_step(session, taskResult, shaderKey))
+                    return {};
+
+                const CookClock::time_point start = CookClock::now();
+                const std::filesystem::path sourcePath = sourceShadersDir / shaderName;
+                const std::filesystem::path cookedPath = outputShaderDir / shaderName;
+                {
+                    CookWriteSlot writeSlot{session};
+                    if (auto copyShaderResult = copy_file_if_needed(sourcePath, cookedPath, true); !copyShaderResult)
+                        return copyShaderResult;
+                }
 
-        for (const auto& shaderName : {"shader.vert", "shader.frag"})
-        {
-            const std::filesystem::path sourcePath = sourceShadersDir / shaderName;
-            if (auto copyShaderResult = copy_file_if_needed(sourcePath, outputShaderDir / shaderName, true); !copyShaderResult)
-                return make_error(copyShaderResult.error());
-        }
+                CookManifestStep shaderStep{};
+                shaderStep.outputs.push_back(cook_output_key(session, cookedPath));
+                if (options.compileShaders)
+                {
+                    const std::filesystem::path spvPath = ShaderCompiler::get_spv_path(cookedPath);
+                    if (auto compileResult = ShaderCompiler::compile_to_file(cookedPath, spvPath); !compileResult)
+                        return make_error(compileResult.error());
+                    shaderStep.outputs.push_back(cook_output_key(session, spvPath));
+                }
 
-        if (options.compileShaders)
-        {
-            const std::filesystem::path cookedVert = outputShaderDir / "shader.vert";
-            const std::filesystem::path cookedFrag = outputShaderDir / "shader.frag";
-            if (auto vertCompile = ShaderCompiler::compile_to_file(cookedVert, ShaderCompiler::get_spv_path(cookedVert));
-                !vertCompile)
-            {
-                return make_error(vertCompile.error());
-            }
-            if (auto fragCompile = ShaderCompiler::compile_to_file(cookedFrag, ShaderCompiler::get_spv_path(cookedFrag));
-                !fragCompile)
-            {
-                return make_error(fragCompile.error());
-            }
+                if (auto recordResult = record_cook_step(session, taskResult, shaderKey, {sourcePath}, std::move(shaderStep), start);
+                    !recordResult)
+                    return make_error(recordResult.error());
+                return {};
+            });
         }
     }
-    else if (std::filesystem::exists(sourceProjectVert) != std::filesystem::exists(sourceProjectFrag))
+    else if (hasProjectVert != hasProjectFrag)
     {
         const std::string warning =
             "Project shader override is incomplete. Shipping bundle will use the engine default shaders instead.";
@@ -1097,140 +2501,66 @@ Result<CookProjectResult> cook_project(const std::filesystem::path& projectFileP
         result.warnings.push_back(warning);
     }
 
-    const auto materialLookup = build_project_material_lookup(project, result);
-    std::set<std::string> copiedScripts;
-    std::set<std::string> copiedMaterials;
-    std::unordered_map<std::string, std::string> cookedAssetMap;
-    std::size_t uniqueModelIndex = 0;
-
-    for (const auto& levelEntry : project.levels())
+    for (const std::string& scriptPath : scriptPaths)
     {
-        auto levelResult = Level::load(project.get_absolute_path(levelEntry.filePath));
-        if (!levelResult)
-            return make_error(levelResult.error());
-
-        Level level = std::move(levelResult.value());
-
-        for (const auto& scriptPath : collect_referenced_script_paths(level.world()))
-        {
-            if (!copiedScripts.insert(scriptPath).second)
-                continue;
-
-            auto scriptCopyResult = copy_project_relative_file_for_cook(resolve_asset_path(scriptPath, &project), project.root_path(),
-                                                                        gameOutputRoot, result.copiedScriptCount);
-            if (!scriptCopyResult)
-            {
-                if (options.strict)
-                    return make_error(scriptCopyResult.error());
-
-                result.warnings.push_back(scriptCopyResult.error().message);
-            }
-        }
-
-        for (const auto& materialName : collect_referenced_material_names(level.world()))
-        {
-            if (!copiedMaterials.insert(materialName).second)
-                continue;
-
-            auto materialCopyResult =
-                copy_referenced_material_asset(materialName, project, materialLookup, gameOutputRoot, result);
-            if (!materialCopyResult)
-            {
-                if (options.strict)
-                    return make_error(materialCopyResult.error());
-
-                result.warnings.push_back(materialCopyResult.error().message);
-            }
-        }
-
-        auto& registry = level.world().registry();
-        auto view = registry.view<MeshComponent>();
-        for (auto entity : view)
-        {
-            auto& meshComponent = view.get<MeshComponent>(entity);
-            if (meshComponent.assetPath.empty())
-                continue;
-
-            const std::string originalAssetKey = meshComponent.assetPath;
-            if (const auto cookedIt = cookedAssetMap.find(originalAssetKey); cookedIt != cookedAssetMap.end())
-            {
-                meshComponent.assetPath = cookedIt->second;
-                continue;
-            }
-
-            const std::filesystem::path sourceAssetPath = resolve_asset_path(meshComponent.assetPath, &project);
-            if (sourceAssetPath.extension() == ".noc_model")
-            {
-                std::filesystem::path cookedRelativePath = meshComponent.assetPath;
-                if (cookedRelativePath.is_absolute())
-                    cookedRelativePath = make_unique_cooked_model_path(gameOutputRoot, sourceAssetPath.stem().string(), uniqueModelIndex++);
-                if (auto copyModelResult = copy_file_if_needed(sourceAssetPath, gameOutputRoot / cookedRelativePath, true);
-                    !copyModelResult)
-                {
-                    return make_error(copyModelResult.error());
-                }
-
-                auto cachedModelResult = ModelLoader::read_cache(sourceAssetPath);
-                if (cachedModelResult)
-                {
-                    for (const auto& texturePath : collect_model_texture_load_paths(*cachedModelResult.value(), &project))
-                    {
-                        auto textureCopyResult = copy_texture_for_cook(texturePath, gameOutputRoot, result);
-                        if (!textureCopyResult && options.strict)
-                            return make_error(textureCopyResult.error());
-                    }
-                }
-
-                meshComponent.assetPath = cookedRelativePath.generic_string();
-                cookedAssetMap.emplace(originalAssetKey, meshComponent.assetPath);
-                continue;
-            }
-
-            auto parsedModelResult = ModelLoader::parse_model(sourceAssetPath);
-            if (!parsedModelResult)
-                return make_error(parsedModelResult.error());
-
-            ModelData cookedModel = *parsedModelResult.value();
-            for (auto& material : cookedModel.materials)
-            {
-                for (auto* texturePath :
-                     {&material.albedoTexturePath, &material.normalTexturePath, &material.roughnessTexturePath,
-                      &material.metallicTexturePath, &material.aoTexturePath})
-                {
-                    if (texturePath->empty())
-                        continue;
-
-                    auto textureCopyResult = copy_texture_for_cook(*texturePath, gameOutputRoot, result);
-                    if (!textureCopyResult)
-                    {
-                        if (options.strict)
-                            return make_error(textureCopyResult.error());
+        emplace_cook_task(taskflow, session, "script:" + scriptPath, [&, scriptPath](CookProjectResult& taskResult) {
+            return demote_cook_error(session, taskResult,
+                                     cook_referenced_script(session, taskResult, project, scriptPath, gameOutputRoot));
+        });
+    }
 
-                        result.warnings.push_back(textureCopyResult.error().message);
-                        texturePath->clear();
-                        continue;
-                    }
+    for (const std::string& materialName : materialNames)
+    {
+        emplace_cook_task(taskflow, session, "material:" + materialName, [&, materialName](CookProjectResult& taskResult) {
+            return demote_cook_error(
+                session, taskResult,
+                copy_referenced_material_asset(session, taskResult, materialName, project, materialLookup, gameOutputRoot));
+        });
+    }
 
-                    *texturePath = textureCopyResult.value();
-                }
-            }
+    std::unordered_map<AssetId, tf::Task> modelTasks{};
+    for (auto& [asset, modelJob] : modelJobs)
+    {
+        modelTasks.emplace(asset,
+                           emplace_cook_task(taskflow, session, "model:" + modelJob.assetPath,
+                                             [&, job = &modelJob](CookProjectResult& taskResult) {
+                                                 return cook_model(session, taskResult, project, *job, gameOutputRoot);
+                                             }));
+    }
 
-            const std::string preferredName = cookedModel.name.empty() ? sourceAssetPath.stem().string() : cookedModel.name;
-            const std::filesystem::path cookedRelativePath =
-                make_unique_cooked_model_path(gameOutputRoot, preferredName, uniqueModelIndex++);
-            if (auto writeResult = ModelLoader::write_cache(cookedModel, gameOutputRoot / cookedRelativePath); !writeResult)
-                return make_error(writeResult.error());
+    // A level waits for its models. Levels cook one after another, since they share the shape cooker.
+    tf::Task previousLevelTask{};
+    for (CookLevelJob& levelJob : levelJobs)
+    {
+        tf::Task levelTask = emplace_cook_task(taskflow, session, "level:" + levelJob.entry->filePath,
+                                               [&, job = &levelJob](CookProjectResult& taskResult) {
+                                                   return cook_level(session, taskResult, *job, modelJobs, shapeCooker,
+                                                                     shapeCookerReady, gameOutputRoot);
+                                               });
+        for (const AssetId asset : levelJob.modelAssets)
+            levelTask.succeed(modelTasks.at(asset));
+        if (!previousLevelTask.empty())
+            levelTask.succeed(previousLevelTask);
+        previousLevelTask = levelTask;
+    }
 
-            meshComponent.assetPath = cookedRelativePath.generic_string();
-            cookedAssetMap.emplace(originalAssetKey, meshComponent.assetPath);
-            ++result.cookedModelCount;
-        }
+    JobSystem::get().run_and_wait(taskflow);
 
-        const std::filesystem::path cookedLevelPath = gameOutputRoot / levelEntry.filePath;
-        if (auto saveResult = level.save_as(cookedLevelPath.string()); !saveResult)
-            return make_error(saveResult.error());
+    // Every step has run; report all failures at once instead of stopping at the first.
+    const bool cookFailed = !session.errors.empty();
+    if (auto finishResult = finish_cook_session(session, cookFailed); !finishResult)
+        return make_error(finishResult.error());
 
-        ++result.cookedLevelCount;
+    if (cookFailed)
+    {
+        if (session.errors.size() == 1)
+            return make_error(session.errors.front());
+
+        std::ranges::sort(session.errors, {}, &Error::message);
+        std::string message = fmt::format("{} cook steps failed:", session.errors.size());
+        for (const Error& error : session.errors)
+            message += "\n  " + error.message;
+        return make_error(message, session.errors.front().code);
     }
 
     return result;
@@ -1279,7 +2609,8 @@ Result<BundleProjectResult> bundle_project(const std::filesystem::path& projectF
     result.bundleRoot = bundleRoot;
     result.contentRoot = bundleRoot / "Content";
 
-    if (options.overwriteOutput)
+    // Incremental bundles keep the previous content so the cook can reuse it.
+    if (options.overwriteOutput && !options.incremental)
         std::filesystem::remove_all(bundleRoot, ec);
 
     ec.clear();
@@ -1290,10 +2621,25 @@ Result<BundleProjectResult> bundle_project(const std::filesystem::path& projectF
                           ErrorCode::AssetCacheWriteFailed);
     }
 
+    // A packed bundle cooks beside the bundle and ships only the archive.
+    std::filesystem::path cookRoot = result.contentRoot;
+    if (options.packContent)
+    {
+        cookRoot = bundleRoot;
+        cookRoot += ".cook";
+    }
+
     CookProjectOptions cookOptions;
-    cookOptions.outputRoot = result.contentRoot;
+    cookOptions.outputRoot = cookRoot;
     cookOptions.overwriteOutput = true;
+    cookOptions.incremental = options.incremental;
+    cookOptions.printAssetTimings = options.printAssetTimings;
     cookOptions.compileShaders = options.compileShaders;
+    cookOptions.compressTextures = options.compressTextures;
+    cookOptions.generateLods = options.generateLods;
+    cookOptions.compactVertices = options.compactVertices;
+    cookOptions.cookCollisionShapes = options.cookCollisionShapes;
+    cookOptions.compileScripts = options.compileScripts;
     cookOptions.strict = options.strict;
     auto cookResult = cook_project(projectFilePath, cookOptions);
     if (!cookResult)
@@ -1301,6 +2647,19 @@ Result<BundleProjectResult> bundle_project(const std::filesystem::path& projectF
 
     result.cookResult = std::move(cookResult.value());
 
+    if (options.packContent)
+    {
+        auto packResult = pack_cooked_content(cookRoot, result.contentRoot, result.cookResult.cookedProjectFile);
+        if (!packResult)
+            return make_error(packResult.error());
+
+        result.contentArchive = result.contentRoot / PackArchive::ContentArchiveName;
+        result.packedFileCount = packResult->fileCount;
+        result.packedByteCount = packResult->byteCount;
+        result.cookResult.cookedProjectFile =
+            result.contentRoot / std::filesystem::relative(result.cookResult.cookedProjectFile, cookRoot, ec);
+    }
+
     for (const auto& entry : std::filesystem::directory_iterator(resolvedRuntimeRoot))
     {
         if (!entry.is_regular_file())
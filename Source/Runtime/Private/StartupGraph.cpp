@@ -0,0 +1,72 @@
+#include "../Public/StartupGraph.hpp"
+#include "../../Core/Public/JobSystem.hpp"
+#include "../../Core/Public/Profiler.hpp"
+
+#include <fmt/core.h>
+
+#include <utility>
+
+tf::Task StartupGraph::add(std::string name, Step step)
+{
+    const std::size_t index = m_timings.size();
+    m_timings.push_back(Timing{name});
+    return m_taskflow.emplace([this, index, step = std::move(step)]() { run_step(index, step); }).name(std::move(name));
+}
+
+Result<> StartupGraph::run(std::string mainThreadName, const Step& mainThreadStep)
+{
+    NOC_PROFILE_ZONE("StartupGraph::run");
+    m_error.reset();
+    const std::size_t mainIndex = m_timings.size();
+    m_timings.push_back(Timing{std::move(mainThreadName)});
+    m_timings[mainIndex].mainThread = true;
+
+    m_start = Clock::now();
+    tf::Future<void> workers = JobSystem::get().executor().run(m_taskflow);
+    run_step(mainIndex, mainThreadStep);
+    workers.wait();
+    m_totalMs = std::chrono::duration<double, std::milli>(Clock::now() - m_start).count();
+
+    if (m_error)
+        return make_error(*m_error);
+    return {};
+}
+
+void StartupGraph::run_step(std::size_t index, const Step& step)
+{
+    {
+        std::lock_guard lock{m_errorMutex};
+        if (m_error)
+            return;
+    }
+
+    Timing& timing = m_timings[index];
+    const Clock::time_point begin = Clock::now();
+    Result<> result = step();
+    const Clock::time_point end = Clock::now();
+    timing.startMs = std::chrono::duration<double, std::milli>(begin - m_start).count();
+    timing.durationMs = std::chrono::duration<double, std::milli>(end - begin).count();
+    timing.ran = true;
+
+    if (!result)
+    {
+        std::lock_guard lock{m_errorMutex};
+        if (!m_error)
+            m_error = std::move(result.error());
+    }
+}
+
+void StartupGraph::print_timings(std::string_view prefix) const
+{
+    for (const Timing& timing : m_timings)
+    {
+        if (!timing.ran)
+        {
+            fmt::print("{}.{} skipped\n", prefix, timing.name);
+            continue;
+        }
+        fmt::print("{}.{} start_ms={:.2f} ms={:.2f}{}\n", prefix, timing.name, timing.startMs, timing.durationMs,
+                   timing.mainThread ? " main_thread" : "");
+    }
+    fmt::print("{}.total_ms={:.2f}\n", prefix, m_totalMs);
+}
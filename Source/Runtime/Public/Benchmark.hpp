@@ -0,0 +1,109 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "../../Core/Public/Expected.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <DirectXMath.h>
+
+struct CameraComponent;
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Orbit camera state at one point of a benchmark camera path.
+struct CameraKeyframe
+{
+    float time{}; // seconds since the first recorded frame
+    DirectX::XMFLOAT3 target{0.0f, 1.0f, 0.0f};
+    float distance{10.0f};
+    float yaw{};   // radians
+    float pitch{}; // radians
+};
+
+/// A deterministic benchmark run, read from a text scenario file:
+///
+///     # comment
+///     name     village_flyover
+///     level    Levels/Village.noc_level   (relative to the project root, optional)
+///     warmup   60                        (frames simulated and rendered before recording)
+///     frames   600                       (recorded frames)
+///     timestep 0.0166667                 (seconds of simulation per frame)
+///     key <time> <targetX> <targetY> <targetZ> <distance> <yawDeg> <pitchDeg>
+///
+/// Keys must be in ascending time. Without keys the level's active camera is left alone.
+struct NOC_EXPORT BenchmarkScenario
+{
+    std::string name{};
+    std::filesystem::path levelFile{};
+    std::uint32_t warmupFrames{60};
+    std::uint32_t frameCount{600};
+    float timestep{1.0f / 60.0f};
+    std::vector<CameraKeyframe> cameraPath{};
+
+    static Result<BenchmarkScenario> load(const std::filesystem::path& path);
+
+    /// Writes the orbit state at `time` into `camera`: a Catmull-Rom spline through the keys,
+    /// held at the first and last key outside their range. No-op without keys.
+    void sample_camera(float time, CameraComponent& camera) const noexcept;
+};
+
+/// Per-frame measurements of a benchmark run.
+struct BenchmarkFrameSample
+{
+    std::uint32_t frame{};
+    double cpuFrameMs{};  // wall time of the whole frame on the main thread
+    float gpuFrameMs{};   // latest resolved GPU frame time (lags by the frames in flight), 0 if unsupported
+    std::uint32_t drawCalls{};
+    std::uint32_t instancedBatches{};
+    std::uint32_t visibleRenderables{};
+    std::uint32_t culledRenderables{};
+    std::uint32_t occludedRenderables{};
+    std::uint64_t trackedMemoryBytes{};     // Vulkan::get_total_tracked_memory_bytes()
+    std::uint64_t deviceLocalUsageBytes{};  // VK_EXT_memory_budget usage, 0 when unsupported
+    std::uint64_t heapAllocations{};        // AllocationCounter count for the frame, 0 unless counting is built in
+    float inputToPresentMs{};               // smoothed FrameLatencyStats estimate, 0 before the first one
+};
+
+struct BenchmarkPercentiles
+{
+    double minimum{};
+    double mean{};
+    double p50{};
+    double p90{};
+    double p95{};
+    double p99{};
+    double maximum{};
+};
+
+/// Collects BenchmarkFrameSample rows and writes them as CSV (one row per frame) and a JSON
+/// summary with percentiles.
+class NOC_EXPORT BenchmarkRecorder
+{
+  public:
+    void reserve(std::uint32_t frameCount);
+    void add(const BenchmarkFrameSample& sample);
+
+    inline const std::vector<BenchmarkFrameSample>& get_samples() const noexcept
+    {
+        return m_samples;
+    }
+
+    BenchmarkPercentiles get_cpu_frame_percentiles() const;
+    /// Frames without a resolved GPU time are left out.
+    BenchmarkPercentiles get_gpu_frame_percentiles() const;
+    /// Frames without a latency estimate are left out.
+    BenchmarkPercentiles get_input_to_present_percentiles() const;
+
+    Result<> write_csv(const std::filesystem::path& path) const;
+    Result<> write_summary_json(const std::filesystem::path& path, const BenchmarkScenario& scenario,
+                                std::string_view gpuName) const;
+
+  private:
+    std::vector<BenchmarkFrameSample> m_samples{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
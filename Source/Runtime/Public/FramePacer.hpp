@@ -0,0 +1,62 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "../../Rendering/Public/IRenderer.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Paces the main loop for latency. begin_frame() sleeps off the frame rate cap, then waits for the
+/// renderer's next frame slot (IRenderer::wait_for_next_frame()), so the input sampled right after it is
+/// as fresh as the GPU allows. Call it first thing every frame, before events are polled; Window runs it
+/// from its frame begin callback.
+class NOC_EXPORT FramePacer
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Stats
+    {
+        float frameMs{0.0f}; // begin_frame() to begin_frame()
+        float sleepMs{0.0f}; // limiter sleep of the last frame
+        FrameLatencyStats latency{};
+    };
+
+    explicit FramePacer(IRenderer& renderer) noexcept;
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /// Frames per second the loop is held to; 0 disables the limiter. Unlike vsync this also holds
+    /// offscreen, minimized and mailbox/immediate frames, which would otherwise run flat out.
+    void set_fps_cap(float fps) noexcept;
+    float get_fps_cap() const noexcept;
+
+    void begin_frame() noexcept;
+
+    Stats get_stats() const noexcept;
+
+  private:
+    /// Sleeps in short slices while the slice's expected wake-up error still fits, then spins the rest.
+    void sleep_until(Clock::time_point deadline) noexcept;
+    void sleep_slice() noexcept;
+
+    IRenderer& m_renderer;
+    float m_fpsCap{0.0f};
+    Clock::time_point m_deadline{};
+    Clock::time_point m_lastFrameBegin{};
+    Stats m_stats{};
+
+    // Running mean and variance (Welford) of how long a one-millisecond slice really takes.
+    double m_sliceMeanMs{1.0};
+    double m_sliceM2{0.0};
+    std::uint64_t m_sliceCount{1};
+
+#ifdef _WIN32
+    void* m_timer{}; // high-resolution waitable timer; Sleep() is only good to the scheduler tick
+#endif
+};
+
+NOC_RESTORE_DLL_WARNINGS
@@ -0,0 +1,83 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "../../Core/Public/Expected.hpp"
+#include "../../ECS/Public/Components.hpp"
+#include "../../Rendering/Public/Light.hpp"
+#include "../../Rendering/Public/Renderable.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <taskflow/taskflow.hpp>
+
+class IRenderer;
+class OrbitCameraController;
+class PhysicsWorld;
+class ScriptEngine;
+class World;
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Everything the render side needs from one simulated frame, copied out of the ECS.
+struct NOC_EXPORT FrameSnapshot
+{
+    // Renderable delta against the previous snapshot (World::collect_renderable_changes()).
+    std::vector<Renderable> changedRenderables{};
+    std::vector<std::uint32_t> removedEntityIds{};
+    std::vector<Light> lights{}; // every light in world space (World::collect_lights())
+    DirectX::XMFLOAT4X4 view{};
+    CameraComponent camera{};
+    bool hasCamera{false};
+};
+
+/// Pipelines the game frame: while the calling thread records and submits frame N from its
+/// snapshot, a per-frame Taskflow on the executor simulates frame N+1 into the other snapshot.
+///
+/// Simulation graph:  scripts -> physics -> transforms -> renderables -> lights
+///                           \-> camera
+/// Scripts and physics both write TransformComponent, so they stay ordered; the camera only
+/// reads CameraComponent and runs beside physics. The render side never touches the registry.
+/// The calling thread keeps all window and swapchain work, so it must be the main thread.
+class NOC_EXPORT FrameScheduler
+{
+  public:
+    FrameScheduler(tf::Executor& executor, World& world, ScriptEngine& scriptEngine, PhysicsWorld& physicsWorld,
+                   OrbitCameraController& camera, IRenderer& renderer) noexcept;
+    ~FrameScheduler();
+
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    /// Renders the latest simulated frame and starts simulating the next one with `deltaTime`.
+    /// The first call simulates synchronously so there is something to show.
+    Result<> run_frame(float deltaTime);
+
+    /// Blocks until the in-flight simulation (if any) has finished. Call before touching the
+    /// world from the calling thread, and before shutdown.
+    void wait();
+
+    /// Retargets the scheduler at another world (a level switch). Waits for the in-flight frame
+    /// and drops both snapshots, so the next run_frame() starts over synchronously.
+    void set_world(World& world);
+
+  private:
+    void build_simulation(FrameSnapshot& snapshot, float deltaTime);
+    Result<> render(const FrameSnapshot& snapshot);
+
+    tf::Executor& m_executor;
+    World* m_world;
+    ScriptEngine& m_scriptEngine;
+    PhysicsWorld& m_physicsWorld;
+    OrbitCameraController& m_camera;
+    IRenderer& m_renderer;
+
+    tf::Taskflow m_taskflow{};
+    tf::Future<void> m_pending{};
+    bool m_simulationPending{false};
+    std::array<FrameSnapshot, 2> m_snapshots{};
+    std::uint32_t m_writeIndex{0};
+};
+
+NOC_RESTORE_DLL_WARNINGS
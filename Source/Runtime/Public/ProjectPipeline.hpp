@@ -2,8 +2,10 @@
 #include "../../Core/Public/Core.hpp"
 #include "../../Core/Public/Expected.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -23,6 +25,8 @@ struct NOC_EXPORT RuntimeLoadOptions
     bool allowEmbeddedMaterialTextureExtraction{true};
     bool requireCookedModels{false};
     bool requireGlowShaders{true};
+    /// Drop CPU vertex/index arrays once the level's meshes are on the GPU (AssetManager::release_cpu_geometry).
+    bool releaseCpuGeometryAfterUpload{false};
 };
 
 struct NOC_EXPORT RuntimeLoadReport
@@ -31,25 +35,61 @@ struct NOC_EXPORT RuntimeLoadReport
     std::uint32_t totalMaterials{};
     bool usedProjectShaders{false};
     bool usedRawSourceAssets{false};
+    std::uint64_t releasedCpuAssetBytes{}; // mesh, model and texture payloads freed after upload
     std::vector<std::string> warnings{};
 };
 
 struct NOC_EXPORT CookProjectOptions
 {
     std::filesystem::path outputRoot{};
+    /// Wipe the output root first. Skipped when an incremental cook can reuse the previous output.
     bool overwriteOutput{true};
+    /// Reuse outputs of the previous cook into `outputRoot` whose inputs hash the same, as recorded
+    /// in its cook manifest. A missing manifest, or one written with different options, cooks everything.
+    bool incremental{true};
+    /// Print the time of every cook step that ran (CookProjectResult::assetTimings is filled regardless).
+    bool printAssetTimings{false};
+    /// Cook steps run in parallel on the JobSystem workers; at most this many write output files at once.
+    std::uint32_t maxConcurrentWrites{4};
     bool compileShaders{true};
+    /// Every cooked texture gets its mip chain pre-decoded into a .noc_texture next to it; when set
+    /// the chain is BC4/BC5/BC7, otherwise RGBA8. Packed ORM maps follow the same rule (BC7 or RGBA8).
+    bool compressTextures{true};
+    /// Add quadric-simplified LOD chains to cooked models that lack them.
+    bool generateLods{true};
+    /// Store cooked model vertices in the 24-byte PackedVertex encoding (oct normals/tangents,
+    /// half-float UVs) instead of 48-byte full-float vertices.
+    bool compactVertices{true};
+    /// Prebuild model collision shapes (mesh BVHs, hulls, compounds) into .noc_shapes files.
+    bool cookCollisionShapes{true};
+    /// Ship referenced scripts as precompiled LuaJIT bytecode (same file names) instead of source.
+    bool compileScripts{true};
     bool strict{true};
 };
 
+struct NOC_EXPORT CookAssetTiming
+{
+    std::string key{}; // cook step, e.g. "model:Assets/Models/Tree.obj"
+    double milliseconds{};
+};
+
 struct NOC_EXPORT CookProjectResult
 {
     std::filesystem::path cookedProjectFile{};
+    std::uint32_t rebuiltAssetCount{}; // cook steps that ran
+    std::uint32_t skippedAssetCount{}; // cook steps reused from the previous cook
+    std::vector<CookAssetTiming> assetTimings{};
     std::uint32_t cookedLevelCount{};
     std::uint32_t cookedModelCount{};
     std::uint32_t copiedTextureCount{};
+    std::uint32_t compressedTextureCount{};
+    std::uint32_t packedOrmTextureCount{};
+    std::uint32_t lodMeshCount{};      // meshes that gained LOD levels
+    std::uint32_t generatedLodCount{}; // levels added beyond LOD 0, over all meshes
+    std::uint32_t cookedCollisionShapeCount{};
     std::uint32_t copiedMaterialCount{};
     std::uint32_t copiedScriptCount{};
+    std::uint32_t compiledScriptCount{};
     std::uint32_t copiedEngineFileCount{};
     std::vector<std::string> warnings{};
 };
@@ -59,14 +99,35 @@ struct NOC_EXPORT BundleProjectOptions
     std::filesystem::path outputRoot{};
     std::filesystem::path runtimeBinaryRoot{};
     bool overwriteOutput{true};
+    /// Forwarded to CookProjectOptions::incremental. The bundle root is then kept instead of wiped.
+    bool incremental{true};
+    /// Forwarded to CookProjectOptions::printAssetTimings.
+    bool printAssetTimings{false};
     bool compileShaders{true};
+    /// Forwarded to CookProjectOptions::compressTextures.
+    bool compressTextures{true};
+    /// Forwarded to CookProjectOptions::generateLods.
+    bool generateLods{true};
+    /// Forwarded to CookProjectOptions::compactVertices.
+    bool compactVertices{true};
+    /// Forwarded to CookProjectOptions::cookCollisionShapes.
+    bool cookCollisionShapes{true};
+    /// Forwarded to CookProjectOptions::compileScripts.
+    bool compileScripts{true};
     bool strict{true};
+    /// Ship the cooked content as one archive (Content/Content.noc_pak, see PackArchive) next to the
+    /// loose project file, instead of a loose tree. The cook then runs in `<outputRoot>.cook` beside
+    /// the bundle, so incremental bundles still find their previous outputs.
+    bool packContent{true};
 };
 
 struct NOC_EXPORT BundleProjectResult
 {
     std::filesystem::path bundleRoot{};
     std::filesystem::path contentRoot{};
+    std::filesystem::path contentArchive{}; // empty for loose bundles
+    std::uint32_t packedFileCount{};
+    std::uint64_t packedByteCount{};
     CookProjectResult cookResult{};
     std::uint32_t copiedRuntimeFileCount{};
     std::vector<std::string> warnings{};
@@ -90,6 +151,82 @@ NOC_EXPORT Result<RuntimeLoadReport> prepare_loaded_level(
     const RuntimeLoadOptions& options = {}
 );
 
+enum class LevelStreamState : std::uint8_t
+{
+    Idle = 0,
+    Reading,    // level file, models and textures read and decoded on background workers
+    Staged,     // everything decoded; waiting for swap_in()
+    Uploading,  // GPU uploads, one budgeted slice per pump()
+    Finalizing, // the last uploads are still in flight on the GPU
+    Ready,      // take_level() hands the level over
+    Failed,
+};
+
+struct NOC_EXPORT LevelStreamProgress
+{
+    LevelStreamState state{LevelStreamState::Idle};
+    std::uint32_t modelCount{};
+    std::uint32_t modelsRead{};
+    std::uint32_t textureCount{};
+    std::uint32_t texturesDecoded{};
+    std::uint32_t modelsUploaded{};
+
+    /// 0..1 over reading, decoding and uploading; 1 once Ready.
+    float fraction() const noexcept;
+};
+
+/// Loads a level without stalling the frame loop, for loading screens and level switches.
+///
+///   begin()     reads the level file, parses its models and decodes their textures as
+///               background jobs. The live level keeps running meanwhile.
+///   pump()      call once per frame on the render thread. It polls the reader, then queues
+///               at most the upload budget of meshes and textures per call, never waiting on the GPU.
+///   swap_in()   once Staged: tears down the live level's runtime content (the caller keeps it
+///               from simulating) and makes the new level the one being uploaded.
+///   take_level() once Ready: hands over the level with every mesh bound to its GPU copy.
+///
+/// The result matches prepare_loaded_level() with the same options.
+class NOC_EXPORT LevelStreamer
+{
+  public:
+    static constexpr std::size_t DefaultUploadBudgetBytes{32ull * 1024ull * 1024ull};
+
+    LevelStreamer(AssetManager& assetManager, IRenderer& renderer, ScriptEngine& scriptEngine,
+                  PhysicsWorld& physicsWorld);
+    /// Waits for outstanding background reads.
+    ~LevelStreamer();
+
+    LevelStreamer(const LevelStreamer&) = delete;
+    LevelStreamer& operator=(const LevelStreamer&) = delete;
+
+    /// Starts streaming `levelPath`. `project` must outlive the load. Fails while another load runs.
+    Result<> begin(const std::filesystem::path& levelPath, Project* project, const RuntimeLoadOptions& options = {});
+
+    /// Advances the load by one frame's worth of work. Returns the state after this step.
+    Result<LevelStreamState> pump();
+
+    /// Moves a Staged load to Uploading, clearing `liveLevel`'s runtime scene (may be null).
+    Result<> swap_in(Level* liveLevel);
+
+    /// The loaded level once Ready (nullptr otherwise). The streamer returns to Idle.
+    std::unique_ptr<Level> take_level();
+
+    /// Report of the last load; complete once Ready.
+    const RuntimeLoadReport& get_report() const noexcept;
+    LevelStreamProgress get_progress() const noexcept;
+    LevelStreamState get_state() const noexcept;
+
+    /// Loading between begin() and take_level().
+    bool is_busy() const noexcept;
+
+    /// CPU payload bytes (mesh geometry and texture pixels) queued per pump(). At least one model per call.
+    void set_upload_budget(std::size_t bytesPerPump) noexcept;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
+
 NOC_EXPORT std::vector<std::string> scan_available_scripts(const Project* project);
 
 NOC_EXPORT bool load_material_from_file(
@@ -0,0 +1,76 @@
+#pragma once
+#include "../../Core/Public/Core.hpp"
+#include "../../Core/Public/Expected.hpp"
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <taskflow/taskflow.hpp>
+
+NOC_SUPPRESS_DLL_WARNINGS
+
+/// Engine startup as a dependency graph on the job system. Independent steps (Vulkan, Jolt, LuaJIT,
+/// project and level reading) overlap instead of running back to back; order dependent steps with
+/// `before.precede(after)` on the returned tasks.
+///
+/// run() starts the worker steps and runs the one step that must stay on the calling thread (window
+/// and swapchain work) meanwhile. Once a step fails, the steps that have not started yet are skipped
+/// and run() returns the first error. Every step that ran is timed for get_timings().
+class NOC_EXPORT StartupGraph
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Step = std::function<Result<>()>;
+
+    struct Timing
+    {
+        std::string name{};
+        double startMs{0.0};    // since run() was called
+        double durationMs{0.0}; // 0 for skipped steps
+        bool ran{false};
+        bool mainThread{false};
+    };
+
+    StartupGraph() = default;
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    /// Adds a step for a worker.
+    tf::Task add(std::string name, Step step);
+
+    /// Runs the graph once, with `mainThreadStep` on the calling thread, and waits for all of it.
+    Result<> run(std::string mainThreadName, const Step& mainThreadStep);
+
+    std::span<const Timing> get_timings() const noexcept
+    {
+        return m_timings;
+    }
+
+    /// Wall time of the last run().
+    double get_total_ms() const noexcept
+    {
+        return m_totalMs;
+    }
+
+    /// Prints `<prefix>.<name> start_ms=… ms=…` per step and `<prefix>.total_ms=…`.
+    void print_timings(std::string_view prefix) const;
+
+  private:
+    void run_step(std::size_t index, const Step& step);
+
+    tf::Taskflow m_taskflow{};
+    std::vector<Timing> m_timings{};
+    Clock::time_point m_start{};
+    double m_totalMs{0.0};
+
+    std::mutex m_errorMutex;
+    std::optional<Error> m_error{};
+};
+
+NOC_RESTORE_DLL_WARNINGS
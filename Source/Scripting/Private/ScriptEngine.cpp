@@ -1,8 +1,14 @@
 #include "../Public/ScriptEngine.hpp"
 #include "../Public/LuaBindings.hpp"
+#include "../../Core/Public/FrameArena.hpp"
+#include "../../Core/Public/Profiler.hpp"
+#include <Core/Public/JobSystem.hpp>
+#include <Core/Public/VirtualFileSystem.hpp>
 
 #include <ECS/Public/Components.hpp>
+#include <ECS/Public/EntityPool.hpp>
 #include <ECS/Public/World.hpp>
+#include <Physics/Public/PhysicsWorld.hpp>
 
 #define SOL_ALL_SAFETIES_ON 1
 #include <sol/sol.hpp>
@@ -10,14 +16,197 @@
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
-#include <sstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+//    Entity-local scripts                                               
+// Scripts starting with a `--!entity_local` line promise to write only their own entity. With shards
+// enabled they run in parallel, each shard on its own Lua state. While one of them runs, its thread has
+// a ParallelScriptScope: dirty marks are queued instead of touching World's shared lists, and writes to
+// any other entity are deferred. update() applies every shard's commands once all shards are done.
+//
+// Reads are limited too: another shard may be writing any other entity's Transform or Mesh at the same
+// moment, so while a scope is active those components read as nil (Entity:transform(), Entity:mesh(),
+// Transforms.get) and only the script's own entity is visible.
+
+struct ScriptCommandBuffer
+{
+    std::vector<entt::entity> dirtyTransforms;
+    std::vector<entt::entity> dirtyRenderables;
+    std::vector<std::function<void()>> deferred; // writes to other entities, in call order
+
+    void apply(World& world)
+    {
+        auto& reg = world.registry();
+        for (entt::entity entity : dirtyTransforms)
+        {
+            if (reg.valid(entity))
+                world.mark_transform_dirty(entity);
+        }
+        for (entt::entity entity : dirtyRenderables)
+        {
+            if (reg.valid(entity))
+                world.mark_renderable_dirty(entity);
+        }
+        for (const auto& command : deferred)
+            command();
+        dirtyTransforms.clear();
+        dirtyRenderables.clear();
+        deferred.clear();
+    }
+};
+
+struct ParallelScriptScope
+{
+    ScriptCommandBuffer* commands{nullptr};
+    const SpatialIndex* spatialIndex{nullptr}; // fetched before the shards start; World::spatial_index() mutates
+    entt::entity self{entt::null};              // entity of the running instance
+};
+
+static thread_local ParallelScriptScope* parallelScope = nullptr;
+
+static void mark_script_transform_dirty(World* world, entt::entity entity)
+{
+    if (parallelScope)
+        parallelScope->commands->dirtyTransforms.push_back(entity);
+    else
+        world->mark_transform_dirty(entity);
+}
+
+static void mark_script_renderable_dirty(World* world, entt::entity entity)
+{
+    if (parallelScope)
+        parallelScope->commands->dirtyRenderables.push_back(entity);
+    else
+        world->mark_renderable_dirty(entity);
+}
+
+/// Applies `edit` to the entity's component and marks it dirty. From an entity-local script, edits
+/// of any entity but its own are deferred until the parallel phase is over.
+template <typename Component, typename Fn> static void edit_script_component(World* world, entt::entity entity, Fn edit)
+{
+    if (parallelScope && entity != parallelScope->self)
+    {
+        parallelScope->commands->deferred.emplace_back(
+            [world, entity, edit = std::move(edit)]() { edit_script_component<Component>(world, entity, edit); });
+        return;
+    }
+    if (!world || !world->registry().valid(entity))
+        return;
+    if (auto* component = world->registry().try_get<Component>(entity))
+    {
+        edit(*component);
+        if constexpr (std::is_same_v<Component, TransformComponent>)
+            mark_script_transform_dirty(world, entity);
+        else
+            mark_script_renderable_dirty(world, entity);
+    }
+}
+
+/// False for Transform/Mesh reads an entity-local script may not make: any entity but its own.
+static bool script_can_read_components(entt::entity entity)
+{
+    return !parallelScope || entity == parallelScope->self;
+}
+
+static const SpatialIndex& script_spatial_index(World& world)
+{
+    return parallelScope ? *parallelScope->spatialIndex : world.spatial_index();
+}
+
+//    Component wrappers for Lua                                         
+// Transform and Mesh are reached through the owning entity so every write marks just that entity
+// dirty, instead of the world invalidating everything after any script ran.
+
+struct LuaTransform
+{
+    entt::entity handle{entt::null};
+    World* world{nullptr};
+
+    TransformComponent* get() const
+    {
+        if (!world || !script_can_read_components(handle) || !world->registry().valid(handle))
+            return nullptr;
+        return world->registry().try_get<TransformComponent>(handle);
+    }
+
+    template <typename Fn> void edit(Fn fn) const
+    {
+        edit_script_component<TransformComponent>(world, handle, std::move(fn));
+    }
+
+    LuaVec3 get_position() const
+    {
+        const auto* transform = get();
+        return transform ? LuaVec3(transform->position) : LuaVec3{};
+    }
+
+    void set_position(const LuaVec3& value) const
+    {
+        edit([position = value.to_dx()](TransformComponent& t) { t.position = position; });
+    }
+
+    LuaVec3 get_scale() const
+    {
+        const auto* transform = get();
+        return transform ? LuaVec3(transform->scale) : LuaVec3{1.0f, 1.0f, 1.0f};
+    }
+
+    void set_scale(const LuaVec3& value) const
+    {
+        edit([scale = value.to_dx()](TransformComponent& t) { t.scale = scale; });
+    }
+
+    LuaVec3 get_rotation_euler() const
+    {
+        const auto* transform = get();
+        return transform ? LuaVec3(transform->get_rotation_euler()) : LuaVec3{};
+    }
+
+    void set_rotation_euler(float pitch, float yaw, float roll) const
+    {
+        edit([pitch, yaw, roll](TransformComponent& t) { t.set_rotation_euler(pitch, yaw, roll); });
+    }
+};
+
+struct LuaMesh
+{
+    entt::entity handle{entt::null};
+    World* world{nullptr};
+
+    MeshComponent* get() const
+    {
+        if (!world || !script_can_read_components(handle) || !world->registry().valid(handle))
+            return nullptr;
+        return world->registry().try_get<MeshComponent>(handle);
+    }
+
+    template <typename T> T read(T MeshComponent::* field, T fallback) const
+    {
+        const auto* mesh = get();
+        return mesh ? mesh->*field : fallback;
+    }
+
+    template <typename T> void write(T MeshComponent::* field, T value) const
+    {
+        edit_script_component<MeshComponent>(world, handle, [field, value](MeshComponent& mesh) { mesh.*field = value; });
+    }
+};
+
 //    Entity wrapper for Lua                                             
 // Provides a safe, limited view of an entity to Lua scripts.
 
@@ -32,7 +221,8 @@ struct LuaEntity
             return;
 
         auto& reg = world->registry();
-        std::vector<entt::entity> stack{handle};
+        std::pmr::vector<entt::entity> stack{FrameArena::current()};
+        stack.push_back(handle);
         while (!stack.empty())
         {
             const entt::entity current = stack.back();
@@ -59,19 +249,19 @@ struct LuaEntity
         return world && handle != entt::null && world->registry().valid(handle);
     }
 
-    std::string name() const
+    std::string_view name() const
     {
         if (!valid())
-            return "";
+            return {};
         const auto* nc = world->registry().try_get<NameComponent>(handle);
-        return nc ? nc->name : "";
+        return nc ? std::string_view{nc->name} : std::string_view{};
     }
 
-    TransformComponent* transform() const
+    std::optional<LuaTransform> transform() const
     {
-        if (!valid())
-            return nullptr;
-        return world->registry().try_get<TransformComponent>(handle);
+        if (!valid() || !script_can_read_components(handle) || !world->registry().all_of<TransformComponent>(handle))
+            return std::nullopt;
+        return LuaTransform{handle, world};
     }
 
     bool has_mesh() const
@@ -91,22 +281,23 @@ struct LuaEntity
         return found;
     }
 
-    MeshComponent* mesh() const
+    std::optional<LuaMesh> mesh() const
     {
         if (!valid())
-            return nullptr;
+            return std::nullopt;
 
         auto& reg = world->registry();
-        if (auto* selfMesh = reg.try_get<MeshComponent>(handle))
-            return selfMesh;
+        if (reg.all_of<MeshComponent>(handle))
+            return script_can_read_components(handle) ? std::optional<LuaMesh>{LuaMesh{handle, world}} : std::nullopt;
 
-        MeshComponent* firstMesh = nullptr;
+        entt::entity firstMesh = entt::null;
         for_each_in_subtree([&](entt::entity e) {
-            if (firstMesh != nullptr)
-                return;
-            firstMesh = reg.try_get<MeshComponent>(e);
+            if (firstMesh == entt::null && reg.all_of<MeshComponent>(e))
+                firstMesh = e;
         });
-        return firstMesh;
+        if (firstMesh == entt::null || !script_can_read_components(firstMesh))
+            return std::nullopt;
+        return LuaMesh{firstMesh, world};
     }
 
     void set_glow(bool enabled, const LuaVec3& color, float intensity) const
@@ -119,11 +310,13 @@ struct LuaEntity
         const float glowIntensity = std::max(0.0f, intensity);
 
         for_each_in_subtree([&](entt::entity e) {
-            if (auto* meshComp = reg.try_get<MeshComponent>(e))
+            if (reg.all_of<MeshComponent>(e))
             {
-                meshComp->glowEnabled = enabled;
-                meshComp->glowColor = glowColor;
-                meshComp->glowIntensity = glowIntensity;
+                edit_script_component<MeshComponent>(world, e, [=](MeshComponent& meshComp) {
+                    meshComp.glowEnabled = enabled;
+                    meshComp.glowColor = glowColor;
+                    meshComp.glowIntensity = glowIntensity;
+                });
             }
         });
     }
@@ -138,12 +331,14 @@ struct LuaEntity
         const float outlineThickness = std::max(0.5f, thickness);
 
         for_each_in_subtree([&](entt::entity e) {
-            if (auto* meshComp = reg.try_get<MeshComponent>(e))
+            if (reg.all_of<MeshComponent>(e))
             {
-                meshComp->outlineEnabled = enabled;
-                meshComp->outlineColor = outlineColor;
-                meshComp->outlineThickness = outlineThickness;
-                meshComp->outlineThroughWalls = throughWalls;
+                edit_script_component<MeshComponent>(world, e, [=](MeshComponent& meshComp) {
+                    meshComp.outlineEnabled = enabled;
+                    meshComp.outlineColor = outlineColor;
+                    meshComp.outlineThickness = outlineThickness;
+                    meshComp.outlineThroughWalls = throughWalls;
+                });
             }
         });
     }
@@ -155,11 +350,13 @@ struct LuaEntity
 
         auto& reg = world->registry();
         for_each_in_subtree([&](entt::entity e) {
-            if (auto* meshComp = reg.try_get<MeshComponent>(e))
+            if (reg.all_of<MeshComponent>(e))
             {
-                meshComp->glowEnabled = false;
-                meshComp->glowIntensity = 0.0f;
-                meshComp->outlineEnabled = false;
+                edit_script_component<MeshComponent>(world, e, [](MeshComponent& meshComp) {
+                    meshComp.glowEnabled = false;
+                    meshComp.glowIntensity = 0.0f;
+                    meshComp.outlineEnabled = false;
+                });
             }
         });
     }
@@ -168,20 +365,312 @@ struct LuaEntity
     {
         return static_cast<std::uint32_t>(handle);
     }
+
+    LuaVec3 world_position() const
+    {
+        if (!valid())
+            return {};
+        const auto* cache = world->registry().try_get<WorldMatrixCache>(handle);
+        if (!cache)
+            return {};
+        return {cache->worldMatrix._41, cache->worldMatrix._42, cache->worldMatrix._43};
+    }
+
+    /// Other mesh entities whose world bounds touch a sphere around this entity.
+    sol::table neighbors(float radius, sol::this_state state) const
+    {
+        sol::state_view lua(state);
+        sol::table result = lua.create_table();
+        if (!valid())
+            return result;
+
+        std::vector<entt::entity> hits{};
+        script_spatial_index(*world).query_sphere(world_position().to_dx(), radius, hits);
+        int luaIndex = 1;
+        for (entt::entity e : hits)
+        {
+            if (e != handle)
+                result[luaIndex++] = LuaEntity{e, world};
+        }
+        return result;
+    }
+
+    /// Nearest other mesh entity hit by a ray from this entity's position, or nil.
+    sol::optional<LuaEntity> raycast(const LuaVec3& direction, float maxDistance) const
+    {
+        if (!valid())
+            return sol::nullopt;
+        const auto hit =
+            script_spatial_index(*world).raycast(world_position().to_dx(), direction.to_dx(), maxDistance, handle);
+        if (!hit)
+            return sol::nullopt;
+        return LuaEntity{hit->entity, world};
+    }
 };
 
+//    Physics query helpers for Lua                                      
+
+static entt::entity lua_ignored_entity(const sol::optional<LuaEntity>& ignore) noexcept
+{
+    return ignore ? ignore->handle : entt::null;
+}
+
+/// { entity = Entity or nil, distance, position = Vec3, normal = Vec3 }, or nil without a hit.
+static sol::object make_lua_hit(sol::state_view lua, const std::optional<PhysicsHit>& hit, World* world)
+{
+    if (!hit)
+        return sol::make_object(lua, sol::lua_nil);
+
+    sol::table result = lua.create_table();
+    if (world && hit->entity != entt::null && world->registry().valid(hit->entity))
+        result["entity"] = LuaEntity{hit->entity, world};
+    result["distance"] = hit->distance;
+    result["position"] = LuaVec3(hit->position);
+    result["normal"] = LuaVec3(hit->normal);
+    return result;
+}
+
+static sol::table make_lua_entity_list(sol::state_view lua, std::span<const entt::entity> entities, World* world)
+{
+    sol::table result = lua.create_table();
+    if (!world)
+        return result;
+
+    int luaIndex = 1;
+    for (entt::entity e : entities)
+    {
+        if (world->registry().valid(e))
+            result[luaIndex++] = LuaEntity{e, world};
+    }
+    return result;
+}
+
+//    Entity pools for Lua                                               
+// EntityPool.from(entity) snapshots the entity's subtree as a prefab; spawn() re-arms instances
+// released by despawn() before creating new ones, so projectile-style churn stops creating and
+// destroying entities every frame.
+
+struct LuaPoolState
+{
+    World* world{nullptr}; // cleared by ScriptEngine::on_world_destroyed()
+    EntityPool pool;
+    std::vector<TransformComponent> transforms{}; // reused by spawn_many()
+    std::vector<entt::entity> roots{};
+};
+
+struct LuaEntityPool
+{
+    std::shared_ptr<LuaPoolState> state;
+
+    TransformComponent transform_at(const LuaVec3& position) const
+    {
+        TransformComponent transform = state->pool.get_prefab().nodes[0].transform;
+        transform.position = position.to_dx();
+        return transform;
+    }
+
+    sol::optional<LuaEntity> spawn(const LuaVec3& position) const
+    {
+        if (!state->world || state->pool.get_prefab().nodes.empty())
+            return sol::nullopt;
+        const TransformComponent transform = transform_at(position);
+        entt::entity root = entt::null;
+        state->pool.acquire(*state->world, {&transform, 1}, {&root, 1});
+        if (root == entt::null)
+            return sol::nullopt;
+        return LuaEntity{root, state->world};
+    }
+
+    /// positions: array of Vec3. Returns the spawned entities in the same order.
+    sol::table spawn_many(sol::table positions, sol::this_state luaState) const
+    {
+        sol::state_view lua(luaState);
+        if (!state->world || state->pool.get_prefab().nodes.empty())
+            return lua.create_table();
+
+        const std::size_t count = positions.size();
+        state->transforms.clear();
+        for (std::size_t i = 0; i < count; ++i)
+            state->transforms.push_back(transform_at(positions.get_or(i + 1, LuaVec3{})));
+        state->roots.resize(count);
+        state->pool.acquire(*state->world, state->transforms, state->roots);
+        return make_lua_entity_list(lua, state->roots, state->world);
+    }
+
+    bool despawn(const LuaEntity& entity) const
+    {
+        return state->world && entity.world == state->world && state->pool.release(*state->world, entity.handle);
+    }
+
+    bool owns(const LuaEntity& entity) const
+    {
+        return state->world && entity.world == state->world && state->pool.owns(entity.handle);
+    }
+
+    std::size_t live_count() const noexcept
+    {
+        return state->pool.get_live_count();
+    }
+
+    std::size_t free_count() const noexcept
+    {
+        return state->pool.get_free_count();
+    }
+};
+
+//    Script chunks                                                      
+// A script compiles once into a factory: `return function(...) <source> end`. Calling the factory
+// yields a fresh closure of the shared prototype, which each entity's environment is set on, so
+// instances share bytecode but not globals. Cooked builds store the factory as LuaJIT bytecode.
+
+namespace
+{
+constexpr std::string_view ChunkFactoryPrefix{"return function(...) "};
+constexpr std::string_view ChunkFactorySuffix{"\nend"};
+constexpr std::string_view LuaJitBytecodeSignature{"\x1bLJ"};
+constexpr std::string_view ScriptDirectivePrefix{"--!"};
+constexpr std::string_view EntityLocalDirective{"entity_local"};
+
+/// The leading `--!` directive lines of a script. Lua reads them as comments; compile_to_bytecode()
+/// copies them in front of the bytecode so cooked scripts keep them.
+struct ScriptHeader
+{
+    std::size_t size{0}; // bytes of directive lines, including their line breaks
+    bool entityLocal{false};
+};
+
+ScriptHeader parse_script_header(std::string_view contents)
+{
+    ScriptHeader header{};
+    while (contents.substr(header.size).starts_with(ScriptDirectivePrefix))
+    {
+        const std::size_t lineEnd = contents.find('\n', header.size);
+        const std::size_t next = lineEnd == std::string_view::npos ? contents.size() : lineEnd + 1;
+        std::string_view directive = contents.substr(header.size + ScriptDirectivePrefix.size(),
+                                                     next - header.size - ScriptDirectivePrefix.size());
+        while (!directive.empty() && (directive.back() == '\n' || directive.back() == '\r' || directive.back() == ' '))
+            directive.remove_suffix(1);
+        if (directive == EntityLocalDirective)
+            header.entityLocal = true;
+        header.size = next;
+    }
+    return header;
+}
+
+Result<std::string> read_script_file(const std::filesystem::path& path)
+{
+    auto file = VirtualFileSystem::get().open(path);
+    if (!file)
+        return make_error(fmt::format("Failed to open script: {}", path.string()), ErrorCode::FileReadFailed);
+    return std::string(file->text());
+}
+
+/// Compiles script source (or loads cooked bytecode) into its chunk factory.
+Result<sol::protected_function> load_chunk_factory(sol::state& lua, std::string_view contents,
+                                                   const std::string& chunkName)
+{
+    // Cooked scripts are their directive lines followed by the bytecode.
+    const std::string_view bytecode = contents.substr(parse_script_header(contents).size);
+    const bool isBytecode = bytecode.starts_with(LuaJitBytecodeSignature);
+    std::string wrapped{};
+    if (!isBytecode)
+    {
+        wrapped.reserve(ChunkFactoryPrefix.size() + contents.size() + ChunkFactorySuffix.size());
+        wrapped.append(ChunkFactoryPrefix).append(contents).append(ChunkFactorySuffix);
+    }
+
+    sol::load_result loaded = lua.load(isBytecode ? bytecode : std::string_view(wrapped), chunkName,
+                                       isBytecode ? sol::load_mode::binary : sol::load_mode::text);
+    if (!loaded.valid())
+    {
+        sol::error err = loaded;
+        return make_error(fmt::format("Lua load error in '{}': {}", chunkName, err.what()), ErrorCode::AssetParsingFailed);
+    }
+    return loaded.get<sol::protected_function>();
+}
+} // namespace
+
 //    Pimpl implementation                                               
 
 struct ScriptEngine::Impl
 {
+    static constexpr std::uint32_t InvalidSlot{UINT32_MAX};
+    static constexpr std::uint32_t ShardPerWorker{UINT32_MAX};
+
+    struct ScriptChunk
+    {
+        sol::protected_function factory;
+        std::filesystem::file_time_type writeTime{};
+        bool entityLocal{false};
+    };
+    using ChunkCache = std::unordered_map<std::string, ScriptChunk>; // by resolved generic path
+
+    /// Lua state for entity-local scripts, run by one job per update(). Only that job touches the
+    /// state while shards run; the rest of the time (loads, on_destroy) it is used from update()'s thread.
+    struct ScriptShard
+    {
+        sol::state lua;
+        ChunkCache chunks;
+        std::vector<std::pair<entt::entity, bool>> calls; // this update's instances, and whether to start them
+        ScriptCommandBuffer commands;
+        std::vector<ScriptProfileEntry> profile; // slots as in Impl::profile, folded in after every update()
+        std::size_t instanceCount{0};
+        double lastGcMs{0.0};
+    };
+
     sol::state lua;
+    // Before the environments, which hold references into the shard states and must go first.
+    std::vector<std::unique_ptr<ScriptShard>> shards;
+    std::uint32_t shardCount{ShardPerWorker};
+    tf::Taskflow shardFlow;     // one task per shard
+    const SpatialIndex* shardSpatialIndex{nullptr};
+    float shardDeltaTime{0.0f}; // dt of the running update(), for the shard tasks
+
     struct ScriptEnvironment
     {
         sol::environment environment;
+        // Lifecycle functions resolved once per load (on_start/on_update again after on_start);
+        // invalid when the script does not define them.
+        sol::protected_function onStart;
+        sol::protected_function onUpdate;
+        sol::protected_function onDestroy;
         World* world{nullptr};
+        entt::entity entity{entt::null};
+        std::uint32_t batch{InvalidSlot}; // index into batches when the script defines on_update_batch
+        std::uint32_t profile{InvalidSlot};
+        std::uint32_t shard{InvalidSlot}; // set for entity-local scripts running on a shard state
     };
-    std::unordered_map<entt::entity, ScriptEnvironment> environments;
+
+    /// All instances of one script that defines on_update_batch(entities, dt): one Lua call per frame
+    /// drives them, through the function of the most recently loaded instance.
+    struct ScriptBatch
+    {
+        std::string scriptPath;
+        sol::protected_function onUpdateBatch;
+        sol::table entities; // reused array of Entity, refilled every update()
+        std::size_t count{0};
+        std::size_t previousCount{0};
+        std::uint32_t profile{InvalidSlot};
+    };
+
+    std::vector<ScriptEnvironment> environments; // dense; order changes on removal
+    std::vector<std::uint32_t> slotByEntity;     // by entt::to_entity(), InvalidSlot when absent
+    std::vector<ScriptBatch> batches;
+    std::unordered_map<std::string, std::uint32_t> batchByScript;
+
+    ChunkCache chunks;
+
+    using Clock = std::chrono::steady_clock;
+    static constexpr int GcStepKilobytes{16};
+
+    std::vector<ScriptProfileEntry> profile;
+    std::unordered_map<std::string, std::uint32_t> profileByScript;
+    float gcStepBudgetMs{1.0f};
+    double lastGcMs{0.0};
     std::filesystem::path scriptRoot; // base directory for resolving relative script paths
+    PhysicsWorld* physicsWorld{nullptr};
+    World* activeWorld{nullptr}; // world of the running update(); physics hits name its entities
+    std::vector<std::weak_ptr<LuaPoolState>> pools; // detached from their world when it is destroyed
 
     std::filesystem::path resolve_script_path(std::string_view scriptPath) const
     {
@@ -192,14 +681,235 @@ struct ScriptEngine::Impl
         if (!scriptRoot.empty())
         {
             std::filesystem::path resolved = scriptRoot / p;
-            if (std::filesystem::exists(resolved))
+            if (VirtualFileSystem::get().exists(resolved))
                 return resolved;
         }
         // Fall back to relative path (resolved against CWD)
         return p;
     }
+
+    ScriptEnvironment* find_environment(entt::entity entity) noexcept
+    {
+        const auto index = static_cast<std::size_t>(entt::to_entity(entity));
+        if (index >= slotByEntity.size() || slotByEntity[index] == InvalidSlot)
+            return nullptr;
+        ScriptEnvironment& record = environments[slotByEntity[index]];
+        return record.entity == entity ? &record : nullptr;
+    }
+
+    /// Inserts or replaces the record of `record.entity`.
+    ScriptEnvironment& store_environment(ScriptEnvironment record)
+    {
+        const auto index = static_cast<std::size_t>(entt::to_entity(record.entity));
+        if (index >= slotByEntity.size())
+            slotByEntity.resize(index + 1, InvalidSlot);
+        if (record.shard != InvalidSlot)
+            ++shards[record.shard]->instanceCount;
+        if (slotByEntity[index] != InvalidSlot)
+        {
+            ScriptEnvironment& existing = environments[slotByEntity[index]];
+            if (existing.shard != InvalidSlot)
+                --shards[existing.shard]->instanceCount;
+            return existing = std::move(record);
+        }
+
+        slotByEntity[index] = static_cast<std::uint32_t>(environments.size());
+        return environments.emplace_back(std::move(record));
+    }
+
+    void erase_environment(entt::entity entity)
+    {
+        const ScriptEnvironment* record = find_environment(entity);
+        if (!record)
+            return;
+
+        if (record->shard != InvalidSlot)
+            --shards[record->shard]->instanceCount;
+
+        const auto index = static_cast<std::size_t>(entt::to_entity(entity));
+        const std::uint32_t slot = slotByEntity[index];
+        if (slot + 1 != environments.size())
+        {
+            environments[slot] = std::move(environments.back());
+            slotByEntity[static_cast<std::size_t>(entt::to_entity(environments[slot].entity))] = slot;
+        }
+        environments.pop_back();
+        slotByEntity[index] = InvalidSlot;
+    }
+
+    /// Shared chunk of the script at `scriptPath` in `state`, recompiled when the file changed on disk.
+    static Result<ScriptChunk> get_chunk(sol::state& state, ChunkCache& cache, const std::filesystem::path& scriptPath,
+                                         const std::string& chunkName)
+    {
+        std::error_code ec;
+        const auto writeTime = std::filesystem::last_write_time(scriptPath, ec);
+        const std::string key = scriptPath.generic_string();
+        // An archived script has no write time and never changes.
+        if (const auto it = cache.find(key); it != cache.end() && (ec || it->second.writeTime == writeTime))
+            return it->second;
+
+        auto contents = read_script_file(scriptPath);
+        if (!contents)
+            return make_error(contents.error());
+
+        auto factory = load_chunk_factory(state, *contents, chunkName);
+        if (!factory)
+            return make_error(factory.error());
+
+        ScriptChunk chunk{*factory, writeTime, parse_script_header(*contents).entityLocal};
+        cache.insert_or_assign(key, chunk);
+        return chunk;
+    }
+
+    Result<> register_bindings(sol::state& state);
+
+    /// Shard for a new entity-local instance: the least loaded one, created on first use.
+    /// InvalidSlot when shards are disabled or a shard state could not be set up.
+    std::uint32_t pick_shard()
+    {
+        if (shardCount == ShardPerWorker)
+            shardCount = JobSystem::get().worker_count();
+        if (shardCount == 0)
+            return InvalidSlot;
+
+        std::uint32_t best = 0;
+        for (std::uint32_t i = 0; i < shardCount; ++i)
+        {
+            if (i >= shards.size())
+            {
+                best = i;
+                break;
+            }
+            if (shards[i]->instanceCount < shards[best]->instanceCount)
+                best = i;
+        }
+        if (best < shards.size())
+            return best;
+
+        auto shard = std::make_unique<ScriptShard>();
+        if (auto result = register_bindings(shard->lua); !result)
+        {
+            fmt::print("Warning: failed to create script shard, running on the main state: {}\n", result.error().message);
+            shardCount = static_cast<std::uint32_t>(shards.size());
+            return shards.empty() ? InvalidSlot : 0;
+        }
+        shards.push_back(std::move(shard));
+        const auto index = static_cast<std::uint32_t>(shards.size() - 1);
+        shardFlow.emplace([this, index]() { run_shard(*shards[index]); });
+        return index;
+    }
+
+    void run_shard(ScriptShard& shard);
+    void run_shards(World& world);
+
+    std::uint32_t resolve_profile(const std::string& scriptPath)
+    {
+        auto [it, inserted] = profileByScript.try_emplace(scriptPath, static_cast<std::uint32_t>(profile.size()));
+        if (inserted)
+            profile.push_back({scriptPath});
+        return it->second;
+    }
+
+    static void record_call(std::vector<ScriptProfileEntry>& entries, std::uint32_t slot, Clock::time_point start)
+    {
+        if (slot == InvalidSlot || slot >= entries.size())
+            return;
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        ScriptProfileEntry& entry = entries[slot];
+        ++entry.callCount;
+        entry.totalMilliseconds += ms;
+        entry.maxMilliseconds = std::max(entry.maxMilliseconds, ms);
+    }
+
+    void record_call(std::uint32_t slot, Clock::time_point start)
+    {
+        record_call(profile, slot, start);
+    }
+
+    /// Runs incremental GC steps until the budget is spent or a cycle completes, so garbage from
+    /// this frame's getters is collected a little every frame instead of in one automatic pass.
+    /// Returns the time spent.
+    double step_gc(sol::state& target) const
+    {
+        if (gcStepBudgetMs <= 0.0f)
+            return 0.0;
+
+        lua_State* state = target.lua_state();
+        const Clock::time_point start = Clock::now();
+        const auto budget = std::chrono::duration<double, std::milli>(gcStepBudgetMs);
+        while (Clock::now() - start < budget)
+        {
+            if (lua_gc(state, LUA_GCSTEP, GcStepKilobytes) != 0)
+                break; // finished a cycle
+        }
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void clear_environments() noexcept
+    {
+        environments.clear();
+        slotByEntity.clear();
+        batches.clear();
+        batchByScript.clear();
+    }
+
+    /// Registers the instance with its script's batch when the script defines on_update_batch.
+    std::uint32_t resolve_batch(const std::string& scriptPath, const sol::environment& env, std::uint32_t profileSlot)
+    {
+        sol::protected_function onUpdateBatch = env["on_update_batch"];
+        if (!onUpdateBatch.valid())
+            return InvalidSlot;
+
+        auto [it, inserted] = batchByScript.try_emplace(scriptPath, static_cast<std::uint32_t>(batches.size()));
+        if (inserted)
+            batches.push_back({scriptPath, onUpdateBatch, lua.create_table(), 0, 0, profileSlot});
+        else
+            batches[it->second].onUpdateBatch = std::move(onUpdateBatch); // reloads take effect
+        return it->second;
+    }
 };
 
+//    FFI transform access                                               
+// Scripts reach TransformComponent storage through LuaJIT FFI pointers instead of usertype
+// properties. The Lua side mirrors the layout as NocTransform; these checks pin it down.
+
+static_assert(std::is_standard_layout_v<TransformComponent>);
+static_assert(sizeof(TransformComponent) == 10 * sizeof(float));
+static_assert(offsetof(TransformComponent, position) == 0);
+static_assert(offsetof(TransformComponent, rotation) == 3 * sizeof(float));
+static_assert(offsetof(TransformComponent, scale) == 7 * sizeof(float));
+
+extern "C"
+{
+    // `context` points at ScriptEngine::Impl::activeWorld, the world being updated.
+
+    /// Transform of an entity in the active world, or null. Entity-local scripts only read their own.
+    static const TransformComponent* noc_ffi_transform_read(void* context, std::uint32_t entityId)
+    {
+        World* world = *static_cast<World**>(context);
+        const auto entity = static_cast<entt::entity>(entityId);
+        if (!world || !script_can_read_components(entity) || !world->registry().valid(entity))
+            return nullptr;
+        return world->registry().try_get<TransformComponent>(entity);
+    }
+
+    /// Like noc_ffi_transform_read, and marks just that entity's transform dirty. Entity-local
+    /// scripts only get their own entity's transform; pointer writes cannot be deferred.
+    static TransformComponent* noc_ffi_transform_write(void* context, std::uint32_t entityId)
+    {
+        World* world = *static_cast<World**>(context);
+        const auto entity = static_cast<entt::entity>(entityId);
+        if (!world || !world->registry().valid(entity))
+            return nullptr;
+        if (parallelScope && entity != parallelScope->self)
+            return nullptr;
+        auto* transform = world->registry().try_get<TransformComponent>(entity);
+        if (transform)
+            mark_script_transform_dirty(world, entity);
+        return transform;
+    }
+}
+
 //    Constructor / destructor / move                                    
 
 ScriptEngine::ScriptEngine() : m_impl(std::make_unique<Impl>())
@@ -216,47 +926,33 @@ ScriptEngine& ScriptEngine::operator=(ScriptEngine&&) noexcept = default;
 
 //    initialize                                                         
 
-Result<> ScriptEngine::initialize()
+/// Everything scripts see except EntityPool, for the main state and every shard state.
+Result<> ScriptEngine::Impl::register_bindings(sol::state& lua)
 {
-    auto& lua = m_impl->lua;
-
     // Open standard Lua libraries + LuaJIT's jit and ffi modules
     lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::string, sol::lib::table, sol::lib::os, sol::lib::jit,
                        sol::lib::ffi);
 
-    // Verify that we're running LuaJIT
-    sol::object jitTable = lua["jit"];
-    if (jitTable.valid())
-    {
-        sol::table jit = jitTable;
-        std::string ver = jit["version"];
-        fmt::print("[ScriptEngine] Running: {}\n", ver);
-    }
-    else
-    {
-        fmt::print("[ScriptEngine] Warning: LuaJIT not detected, running in standard Lua mode (no JIT compilation)\n");
-    }
-
     // Override print() to go through fmt
     lua.set_function("print", [](sol::variadic_args va) {
-        std::string msg;
+        std::pmr::string msg{FrameArena::current()};
         for (size_t i = 0; i < va.size(); ++i)
         {
             if (i > 0)
                 msg += "\t";
             sol::object obj = va[i];
-            if (obj.is<std::string>())
-                msg += obj.as<std::string>();
+            if (obj.is<std::string_view>())
+                msg += obj.as<std::string_view>();
             else if (obj.is<double>())
-                msg += fmt::format("{}", obj.as<double>());
+                fmt::format_to(std::back_inserter(msg), "{}", obj.as<double>());
             else if (obj.is<bool>())
                 msg += obj.as<bool>() ? "true" : "false";
             else if (obj.is<sol::nil_t>())
                 msg += "nil";
             else
-                msg += fmt::format("[{}]", sol::type_name(va.lua_state(), obj.get_type()));
+                fmt::format_to(std::back_inserter(msg), "[{}]", sol::type_name(va.lua_state(), obj.get_type()));
         }
-        fmt::print("[Lua] {}\n", msg);
+        fmt::print("[Lua] {}\n", std::string_view{msg});
     });
 
     //    Register Vec3                                                  
@@ -279,43 +975,39 @@ Result<> ScriptEngine::initialize()
     )");
 
     //    Register Transform                                             
-    // Lua gets a pointer to the actual TransformComponent on the entity,
-    // so mutations in Lua directly affect the C++ side.
+    // Lua gets a handle to the entity's TransformComponent; writes go straight to the C++ side
+    // and mark only that entity dirty.
 
-    lua.new_usertype<TransformComponent>(
+    lua.new_usertype<LuaTransform>(
         "Transform", sol::no_constructor, "position",
-        sol::property([](const TransformComponent& t) { return LuaVec3(t.position); },
-                      [](TransformComponent& t, const LuaVec3& v) { t.position = v.to_dx(); }),
-        "scale",
-        sol::property([](const TransformComponent& t) { return LuaVec3(t.scale); },
-                      [](TransformComponent& t, const LuaVec3& v) { t.scale = v.to_dx(); }),
-        "get_rotation_euler",
-        [](const TransformComponent& t) -> LuaVec3 {
-            auto e = t.get_rotation_euler();
-            return LuaVec3(e);
-        },
-        "set_rotation_euler",
-        [](TransformComponent& t, float pitch, float yaw, float roll) { t.set_rotation_euler(pitch, yaw, roll); });
-
-    lua.new_usertype<MeshComponent>(
+        sol::property(&LuaTransform::get_position, &LuaTransform::set_position), "scale",
+        sol::property(&LuaTransform::get_scale, &LuaTransform::set_scale), "get_rotation_euler",
+        &LuaTransform::get_rotation_euler, "set_rotation_euler", &LuaTransform::set_rotation_euler);
+
+    lua.new_usertype<LuaMesh>(
         "Mesh",
         sol::no_constructor,
         "glow_enabled",
-        &MeshComponent::glowEnabled,
+        sol::property([](const LuaMesh& m) { return m.read(&MeshComponent::glowEnabled, false); },
+                      [](const LuaMesh& m, bool v) { m.write(&MeshComponent::glowEnabled, v); }),
         "glow_intensity",
-        &MeshComponent::glowIntensity,
+        sol::property([](const LuaMesh& m) { return m.read(&MeshComponent::glowIntensity, 0.0f); },
+                      [](const LuaMesh& m, float v) { m.write(&MeshComponent::glowIntensity, v); }),
         "glow_color",
-        sol::property([](const MeshComponent& m) { return LuaVec3(m.glowColor); },
-                      [](MeshComponent& m, const LuaVec3& v) { m.glowColor = v.to_dx(); }),
+        sol::property([](const LuaMesh& m) { return LuaVec3(m.read(&MeshComponent::glowColor, {})); },
+                      [](const LuaMesh& m, const LuaVec3& v) { m.write(&MeshComponent::glowColor, v.to_dx()); }),
         "outline_enabled",
-        &MeshComponent::outlineEnabled,
+        sol::property([](const LuaMesh& m) { return m.read(&MeshComponent::outlineEnabled, false); },
+                      [](const LuaMesh& m, bool v) { m.write(&MeshComponent::outlineEnabled, v); }),
         "outline_through_walls",
-        &MeshComponent::outlineThroughWalls,
+        sol::property([](const LuaMesh& m) { return m.read(&MeshComponent::outlineThroughWalls, false); },
+                      [](const LuaMesh& m, bool v) { m.write(&MeshComponent::outlineThroughWalls, v); }),
         "outline_thickness",
-        &MeshComponent::outlineThickness,
+        sol::property([](const LuaMesh& m) { return m.read(&MeshComponent::outlineThickness, 0.0f); },
+                      [](const LuaMesh& m, float v) { m.write(&MeshComponent::outlineThickness, v); }),
         "outline_color",
-        sol::property([](const MeshComponent& m) { return LuaVec3(m.outlineColor); },
-                      [](MeshComponent& m, const LuaVec3& v) { m.outlineColor = v.to_dx(); }));
+        sol::property([](const LuaMesh& m) { return LuaVec3(m.read(&MeshComponent::outlineColor, {})); },
+                      [](const LuaMesh& m, const LuaVec3& v) { m.write(&MeshComponent::outlineColor, v.to_dx()); }));
 
     //    Register Entity                                                
 
@@ -323,7 +1015,253 @@ Result<> ScriptEngine::initialize()
                                 &LuaEntity::transform, "mesh", &LuaEntity::mesh, "has_mesh", &LuaEntity::has_mesh,
                                 "set_glow", &LuaEntity::set_glow, "set_outline", &LuaEntity::set_outline,
                                 "clear_visual_effects", &LuaEntity::clear_visual_effects, "id", &LuaEntity::id,
-                                "valid", &LuaEntity::valid);
+                                "valid", &LuaEntity::valid, "world_position", &LuaEntity::world_position,
+                                "neighbors", &LuaEntity::neighbors, "raycast", &LuaEntity::raycast);
+
+    //    Register FFI transforms                                        
+    // Transforms.get(entity or id) -> const NocTransform*, Transforms.edit(entity or id) -> NocTransform*
+    // (marks the entity dirty), nil when missing. Fields px..pz, rx..rw (quaternion), sx..sz alias the
+    // component directly; pointers are valid until the script callback returns.
+
+    if (sol::object ffiModule = lua["ffi"]; ffiModule.valid())
+    {
+        sol::protected_function installTransforms = lua.safe_script(R"(
+            ffi.cdef[[
+                typedef struct NocTransform { float px, py, pz; float rx, ry, rz, rw; float sx, sy, sz; } NocTransform;
+            ]]
+            return function(context, readAddress, writeAddress)
+                local read = ffi.cast("const NocTransform* (*)(void*, uint32_t)", readAddress)
+                local write = ffi.cast("NocTransform* (*)(void*, uint32_t)", writeAddress)
+                local function id_of(entity)
+                    if type(entity) == "number" then
+                        return entity
+                    end
+                    return entity:id()
+                end
+                Transforms = {
+                    get = function(entity)
+                        local t = read(context, id_of(entity))
+                        if t ~= nil then return t end
+                    end,
+                    edit = function(entity)
+                        local t = write(context, id_of(entity))
+                        if t ~= nil then return t end
+                    end,
+                }
+            end
+        )");
+        if (auto installResult = installTransforms(static_cast<void*>(&activeWorld),
+                                                   reinterpret_cast<void*>(&noc_ffi_transform_read),
+                                                   reinterpret_cast<void*>(&noc_ffi_transform_write));
+            !installResult.valid())
+        {
+            sol::error err = installResult;
+            return make_error(fmt::format("Failed to register FFI transforms: {}", err.what()), ErrorCode::AssetParsingFailed);
+        }
+    }
+
+    //    Register Physics queries                                       
+    // Exact queries against collision bodies, unlike Entity:raycast/neighbors which test mesh boxes.
+
+    Impl* impl = this;
+    sol::table physics = lua.create_named_table("Physics");
+    physics.set_function("raycast", [impl](sol::this_state state, const LuaVec3& origin, const LuaVec3& direction,
+                                           float maxDistance, sol::optional<LuaEntity> ignore) -> sol::object {
+        std::optional<PhysicsHit> hit{};
+        if (impl->physicsWorld)
+            hit = impl->physicsWorld->raycast({origin.to_dx(), direction.to_dx(), maxDistance}, lua_ignored_entity(ignore));
+        return make_lua_hit(state, hit, impl->activeWorld);
+    });
+    // rays: array of { origin = Vec3, direction = Vec3, max_distance = number? }. Misses come back as false.
+    physics.set_function("raycast_batch", [impl](sol::this_state state, sol::table rays, sol::optional<float> maxDistance,
+                                                 sol::optional<LuaEntity> ignore) -> sol::table {
+        sol::state_view lua(state);
+        std::pmr::vector<PhysicsRay> queries(rays.size(), FrameArena::current());
+        for (std::size_t i = 0; i < queries.size(); ++i)
+        {
+            sol::table ray = rays[i + 1];
+            queries[i].origin = ray.get_or("origin", LuaVec3{}).to_dx();
+            queries[i].direction = ray.get_or("direction", LuaVec3{0.0f, 0.0f, 1.0f}).to_dx();
+            queries[i].maxDistance = ray.get_or("max_distance", maxDistance.value_or(1000.0f));
+        }
+
+        std::pmr::vector<std::optional<PhysicsHit>> hits(queries.size(), FrameArena::current());
+        if (impl->physicsWorld)
+            impl->physicsWorld->raycast_batch(queries, hits, lua_ignored_entity(ignore));
+
+        sol::table result = lua.create_table(static_cast<int>(hits.size()), 0);
+        for (std::size_t i = 0; i < hits.size(); ++i)
+        {
+            if (hits[i])
+                result[i + 1] = make_lua_hit(lua, hits[i], impl->activeWorld);
+            else
+                result[i + 1] = false;
+        }
+        return result;
+    });
+    physics.set_function("sphere_cast", [impl](sol::this_state state, const LuaVec3& origin, float radius,
+                                               const LuaVec3& direction, float maxDistance,
+                                               sol::optional<LuaEntity> ignore) -> sol::object {
+        std::optional<PhysicsHit> hit{};
+        if (impl->physicsWorld)
+            hit = impl->physicsWorld->sphere_cast({origin.to_dx(), direction.to_dx(), maxDistance}, radius,
+                                                  lua_ignored_entity(ignore));
+        return make_lua_hit(state, hit, impl->activeWorld);
+    });
+    physics.set_function("box_cast", [impl](sol::this_state state, const LuaVec3& origin, const LuaVec3& halfExtents,
+                                            const LuaVec3& direction, float maxDistance,
+                                            sol::optional<LuaEntity> ignore) -> sol::object {
+        std::optional<PhysicsHit> hit{};
+        if (impl->physicsWorld)
+            hit = impl->physicsWorld->box_cast({origin.to_dx(), direction.to_dx(), maxDistance}, halfExtents.to_dx(),
+                                               {0.0f, 0.0f, 0.0f, 1.0f}, lua_ignored_entity(ignore));
+        return make_lua_hit(state, hit, impl->activeWorld);
+    });
+    physics.set_function("overlap_sphere", [impl](sol::this_state state, const LuaVec3& center, float radius) {
+        std::vector<entt::entity> entities{};
+        if (impl->physicsWorld)
+            impl->physicsWorld->overlap_sphere(center.to_dx(), radius, entities);
+        return make_lua_entity_list(state, entities, impl->activeWorld);
+    });
+    physics.set_function("overlap_box", [impl](sol::this_state state, const LuaVec3& center, const LuaVec3& halfExtents) {
+        std::vector<entt::entity> entities{};
+        if (impl->physicsWorld)
+            impl->physicsWorld->overlap_box(center.to_dx(), halfExtents.to_dx(), {0.0f, 0.0f, 0.0f, 1.0f}, entities);
+        return make_lua_entity_list(state, entities, impl->activeWorld);
+    });
+
+    return {};
+}
+
+/// Runs every queued entity-local instance of `shard`, on whichever worker picked up its task.
+void ScriptEngine::Impl::run_shard(ScriptShard& shard)
+{
+    if (shard.calls.empty())
+    {
+        shard.lastGcMs = 0.0;
+        return;
+    }
+    NOC_PROFILE_ZONE("ScriptEngine::run_shard");
+
+    ParallelScriptScope scope{&shard.commands, shardSpatialIndex, entt::null};
+    parallelScope = &scope;
+    for (const auto& [entity, start] : shard.calls)
+    {
+        ScriptEnvironment* record = find_environment(entity);
+        if (!record)
+            continue;
+        scope.self = entity;
+        const LuaEntity luaEntity{entity, activeWorld};
+        const std::string& scriptPath = profile[record->profile].scriptPath;
+
+        if (start)
+        {
+            if (record->onStart.valid())
+            {
+                const auto callStart = Clock::now();
+                auto result = record->onStart(luaEntity);
+                record_call(shard.profile, record->profile, callStart);
+                if (!result.valid())
+                {
+                    sol::error err = result;
+                    fmt::print("[Lua Error] on_start in '{}': {}\n", scriptPath, err.what());
+                }
+            }
+            // on_start may define or replace on_update.
+            record->onUpdate = record->environment["on_update"];
+        }
+
+        if (record->onUpdate.valid())
+        {
+            const auto callStart = Clock::now();
+            auto result = record->onUpdate(luaEntity, shardDeltaTime);
+            record_call(shard.profile, record->profile, callStart);
+            if (!result.valid())
+            {
+                sol::error err = result;
+                fmt::print("[Lua Error] on_update in '{}': {}\n", scriptPath, err.what());
+            }
+        }
+    }
+    parallelScope = nullptr;
+    shard.calls.clear();
+    shard.lastGcMs = step_gc(shard.lua);
+}
+
+/// Runs the shards in parallel on the job system, then applies their deferred writes in shard order.
+void ScriptEngine::Impl::run_shards(World& world)
+{
+    const bool anyQueued =
+        std::ranges::any_of(shards, [](const std::unique_ptr<ScriptShard>& shard) { return !shard->calls.empty(); });
+    if (!anyQueued)
+    {
+        for (const auto& shard : shards)
+            shard->lastGcMs = 0.0;
+        return;
+    }
+    NOC_PROFILE_ZONE("ScriptEngine::run_shards");
+
+    shardSpatialIndex = &world.spatial_index();
+    for (const auto& shard : shards)
+        shard->profile.resize(profile.size());
+    JobSystem::get().run_and_wait(shardFlow);
+
+    for (const auto& shard : shards)
+    {
+        shard->commands.apply(world);
+        for (std::size_t slot = 0; slot < shard->profile.size(); ++slot)
+        {
+            ScriptProfileEntry& sample = shard->profile[slot];
+            if (sample.callCount == 0)
+                continue;
+            ScriptProfileEntry& entry = profile[slot];
+            entry.callCount += sample.callCount;
+            entry.totalMilliseconds += sample.totalMilliseconds;
+            entry.maxMilliseconds = std::max(entry.maxMilliseconds, sample.maxMilliseconds);
+            sample = {};
+        }
+    }
+}
+
+Result<> ScriptEngine::initialize()
+{
+    auto& lua = m_impl->lua;
+    if (auto result = m_impl->register_bindings(lua); !result)
+        return result;
+
+    // Verify that we're running LuaJIT
+    sol::object jitTable = lua["jit"];
+    if (jitTable.valid())
+    {
+        sol::table jit = jitTable;
+        std::string ver = jit["version"];
+        fmt::print("[ScriptEngine] Running: {}\n", ver);
+    }
+    else
+    {
+        fmt::print("[ScriptEngine] Warning: LuaJIT not detected, running in standard Lua mode (no JIT compilation)\n");
+    }
+
+    //    Register entity pools                                          
+    // Main state only: spawning and despawning change the world, which shards never do directly.
+
+    Impl* impl = m_impl.get();
+    lua.new_usertype<LuaEntityPool>("EntityPool", sol::no_constructor, "spawn", &LuaEntityPool::spawn, "spawn_many",
+                                    &LuaEntityPool::spawn_many, "despawn", &LuaEntityPool::despawn, "owns",
+                                    &LuaEntityPool::owns, "live_count", &LuaEntityPool::live_count, "free_count",
+                                    &LuaEntityPool::free_count);
+    lua["EntityPool"]["from"] = [impl](const LuaEntity& source) -> sol::optional<LuaEntityPool> {
+        if (!source.valid())
+            return sol::nullopt;
+        Prefab prefab = Prefab::from_subtree(*source.world, source.handle);
+        if (!prefab.is_valid())
+            return sol::nullopt;
+
+        auto state = std::make_shared<LuaPoolState>(LuaPoolState{source.world, EntityPool{std::move(prefab)}});
+        std::erase_if(impl->pools, [](const std::weak_ptr<LuaPoolState>& pool) { return pool.expired(); });
+        impl->pools.push_back(state);
+        return LuaEntityPool{std::move(state)};
+    };
 
     fmt::print("[ScriptEngine] Initialized LuaJIT VM\n");
     return {};
@@ -336,6 +1274,11 @@ void ScriptEngine::set_script_root(const std::filesystem::path& root)
     m_impl->scriptRoot = root;
 }
 
+void ScriptEngine::set_physics_world(PhysicsWorld* physicsWorld) noexcept
+{
+    m_impl->physicsWorld = physicsWorld;
+}
+
 //    load_script                                                        
 
 Result<> ScriptEngine::load_script(World& world, entt::entity entity)
@@ -347,34 +1290,69 @@ Result<> ScriptEngine::load_script(World& world, entt::entity entity)
 
     std::filesystem::path scriptPath = m_impl->resolve_script_path(sc->scriptPath);
 
-    if (!std::filesystem::exists(scriptPath))
+    if (!VirtualFileSystem::get().exists(scriptPath))
         return make_error(fmt::format("Script file not found: {}", scriptPath.string()), ErrorCode::AssetFileNotFound);
 
-    // Read script source
-    std::ifstream file(scriptPath);
-    if (!file)
-        return make_error(fmt::format("Failed to open script: {}", scriptPath.string()), ErrorCode::FileReadFailed);
-
-    std::ostringstream ss;
-    ss << file.rdbuf();
-    std::string source = ss.str();
+    auto chunk = Impl::get_chunk(m_impl->lua, m_impl->chunks, scriptPath, scriptPath.string());
+    if (!chunk)
+    {
+        m_impl->erase_environment(entity);
+        return make_error(chunk.error());
+    }
 
-    auto& lua = m_impl->lua;
+    // Entity-local scripts get an instance on a shard state instead, compiled there separately.
+    const std::uint32_t shardIndex = chunk->entityLocal ? m_impl->pick_shard() : Impl::InvalidSlot;
+    if (shardIndex != Impl::InvalidSlot)
+    {
+        Impl::ScriptShard& shard = *m_impl->shards[shardIndex];
+        chunk = Impl::get_chunk(shard.lua, shard.chunks, scriptPath, scriptPath.string());
+        if (!chunk)
+        {
+            m_impl->erase_environment(entity);
+            return make_error(chunk.error());
+        }
+    }
+    sol::state& lua = shardIndex != Impl::InvalidSlot ? m_impl->shards[shardIndex]->lua : m_impl->lua;
+    sol::protected_function& factory = chunk->factory;
 
     // Create a sandboxed environment for this entity
     sol::environment env(lua, sol::create, lua.globals());
-    m_impl->environments[entity] = {env, &world};
 
-    // Execute the script within the environment
-    auto loadResult = lua.safe_script(source, env, sol::script_pass_on_error, scriptPath.string());
+    // Instantiate the shared chunk and run its body within the environment
+    sol::protected_function body{};
+    if (auto instance = factory(); instance.valid())
+        body = instance;
+    if (!body.valid())
+    {
+        m_impl->erase_environment(entity);
+        return make_error(fmt::format("Lua load error in '{}': chunk did not produce a function", sc->scriptPath),
+                          ErrorCode::AssetParsingFailed);
+    }
+    env.set_on(body);
+
+    auto loadResult = body();
     if (!loadResult.valid())
     {
         sol::error err = loadResult;
-        m_impl->environments.erase(entity);
+        m_impl->erase_environment(entity);
         return make_error(fmt::format("Lua load error in '{}': {}", sc->scriptPath, err.what()),
                           ErrorCode::AssetParsingFailed);
     }
 
+    Impl::ScriptEnvironment record{};
+    record.environment = env;
+    record.onStart = env["on_start"];
+    record.onUpdate = env["on_update"];
+    record.onDestroy = env["on_destroy"];
+    record.world = &world;
+    record.entity = entity;
+    record.profile = m_impl->resolve_profile(sc->scriptPath);
+    record.shard = shardIndex;
+    // on_update_batch is a main-state feature; entity-local instances always get on_update calls.
+    if (shardIndex == Impl::InvalidSlot)
+        record.batch = m_impl->resolve_batch(scriptPath.generic_string(), env, record.profile);
+    m_impl->store_environment(std::move(record));
+
     sc->initialized = false;
     return {};
 }
@@ -383,60 +1361,52 @@ Result<> ScriptEngine::load_script(World& world, entt::entity entity)
 
 void ScriptEngine::update(World& world, float dt)
 {
+    NOC_PROFILE_ZONE("ScriptEngine::update");
     auto& reg = world.registry();
     auto view = reg.view<ScriptComponent>();
-    bool scriptsMayMutateTransforms = false;
-    bool scriptsMayMutateRenderables = false;
+    m_impl->activeWorld = &world;
+    for (auto& batch : m_impl->batches)
+        batch.count = 0;
 
     for (auto entity : view)
     {
         auto& sc = view.get<ScriptComponent>(entity);
         if (sc.scriptPath.empty())
             continue;
-        scriptsMayMutateTransforms = true;
-        scriptsMayMutateRenderables = true;
 
-        // Lazy-load: if no environment exists yet, load the script
-        auto envIt = m_impl->environments.find(entity);
-        if (envIt == m_impl->environments.end())
+        // Lazy-load: if no environment exists yet, load the script.
+        // Entity IDs can be reused across worlds; stale environments must be discarded.
+        Impl::ScriptEnvironment* record = m_impl->find_environment(entity);
+        if (!record || record->world != &world)
         {
             auto result = load_script(world, entity);
             if (!result)
             {
                 fmt::print("Warning: {}\n", result.error().message);
-                // Prevent retrying every frame — clear the path
                 continue;
             }
-            envIt = m_impl->environments.find(entity);
-            if (envIt == m_impl->environments.end())
+            record = m_impl->find_environment(entity);
+            if (!record)
                 continue;
         }
-
-        auto& envRecord = envIt->second;
-        if (envRecord.world != &world)
+        // Entity-local instances run on their shard after this loop.
+        if (record->shard != Impl::InvalidSlot)
         {
-            // Entity IDs can be reused across worlds; stale environments must be discarded.
-            m_impl->environments.erase(envIt);
-            auto result = load_script(world, entity);
-            if (!result)
-            {
-                fmt::print("Warning: {}\n", result.error().message);
-                continue;
-            }
-            envIt = m_impl->environments.find(entity);
-            if (envIt == m_impl->environments.end())
-                continue;
+            m_impl->shards[record->shard]->calls.emplace_back(entity, !sc.initialized);
+            sc.initialized = true;
+            continue;
         }
-        auto& env = envIt->second.environment;
+
         LuaEntity luaEntity{entity, &world};
 
         // Call on_start() once
         if (!sc.initialized)
         {
-            sol::protected_function onStart = env["on_start"];
-            if (onStart.valid())
+            if (record->onStart.valid())
             {
-                auto result = onStart(luaEntity);
+                const auto start = Impl::Clock::now();
+                auto result = record->onStart(luaEntity);
+                m_impl->record_call(record->profile, start);
                 if (!result.valid())
                 {
                     sol::error err = result;
@@ -444,13 +1414,27 @@ void ScriptEngine::update(World& world, float dt)
                 }
             }
             sc.initialized = true;
+
+            // on_start may define or replace the update functions.
+            record->onUpdate = record->environment["on_update"];
+            record->batch = m_impl->resolve_batch(m_impl->resolve_script_path(sc.scriptPath).generic_string(),
+                                                  record->environment, record->profile);
+        }
+
+        // Batched scripts get one on_update_batch call after the loop instead of per-entity calls.
+        if (record->batch != Impl::InvalidSlot)
+        {
+            Impl::ScriptBatch& batch = m_impl->batches[record->batch];
+            batch.entities[++batch.count] = luaEntity;
+            continue;
         }
 
         // Call on_update() every frame
-        sol::protected_function onUpdate = env["on_update"];
-        if (onUpdate.valid())
+        if (record->onUpdate.valid())
         {
-            auto result = onUpdate(luaEntity, dt);
+            const auto start = Impl::Clock::now();
+            auto result = record->onUpdate(luaEntity, dt);
+            m_impl->record_call(record->profile, start);
             if (!result.valid())
             {
                 sol::error err = result;
@@ -459,31 +1443,53 @@ void ScriptEngine::update(World& world, float dt)
         }
     }
 
-    if (scriptsMayMutateTransforms)
-        world.mark_transforms_dirty();
-    if (scriptsMayMutateRenderables)
-        world.mark_renderables_dirty();
+    for (auto& batch : m_impl->batches)
+    {
+        // Trim entities left over from a larger previous frame.
+        for (std::size_t i = batch.count + 1; i <= batch.previousCount; ++i)
+            batch.entities[i] = sol::lua_nil;
+        batch.previousCount = batch.count;
+        if (batch.count == 0)
+            continue;
+
+        const auto start = Impl::Clock::now();
+        auto result = batch.onUpdateBatch(batch.entities, dt);
+        m_impl->record_call(batch.profile, start);
+        if (!result.valid())
+        {
+            sol::error err = result;
+            fmt::print("[Lua Error] on_update_batch in '{}': {}\n", batch.scriptPath, err.what());
+        }
+    }
+
+    m_impl->shardDeltaTime = dt;
+    m_impl->run_shards(world);
+
+    m_impl->activeWorld = nullptr;
+    m_impl->lastGcMs = m_impl->step_gc(m_impl->lua);
+    for (const auto& shard : m_impl->shards)
+        m_impl->lastGcMs += shard->lastGcMs;
 }
 
 //    on_entity_destroyed                                                
 
 void ScriptEngine::on_entity_destroyed(World& world, entt::entity entity)
 {
-    auto envIt = m_impl->environments.find(entity);
-    if (envIt == m_impl->environments.end())
+    Impl::ScriptEnvironment* record = m_impl->find_environment(entity);
+    if (!record || record->world != &world)
         return;
 
-    if (envIt->second.world != &world)
-        return;
-
-    auto& env = envIt->second.environment;
     LuaEntity luaEntity{entity, &world};
 
-    // Call on_destroy() if defined
-    sol::protected_function onDestroy = env["on_destroy"];
+    // Call on_destroy() if defined. Copied: the record must not be the one running the call
+    // when it is erased afterwards.
+    sol::protected_function onDestroy = record->onDestroy;
+    const std::uint32_t profileSlot = record->profile;
     if (onDestroy.valid())
     {
+        const auto start = Impl::Clock::now();
         auto result = onDestroy(luaEntity);
+        m_impl->record_call(profileSlot, start);
         if (!result.valid())
         {
             sol::error err = result;
@@ -493,7 +1499,7 @@ void ScriptEngine::on_entity_destroyed(World& world, entt::entity entity)
         }
     }
 
-    m_impl->environments.erase(envIt);
+    m_impl->erase_environment(entity);
 }
 
 void ScriptEngine::on_entity_tree_destroyed(World& world, entt::entity entity)
@@ -530,25 +1536,23 @@ void ScriptEngine::on_world_destroyed(World& world)
     if (!m_impl)
         return;
 
-    // Collect keys first to avoid iterator invalidation while erasing.
+    // Collect entities first; erasing reorders the dense records.
     std::vector<entt::entity> entities;
     entities.reserve(m_impl->environments.size());
-    for (const auto& [entity, envRecord] : m_impl->environments)
+    for (const auto& envRecord : m_impl->environments)
     {
         if (envRecord.world == &world)
-            entities.push_back(entity);
+            entities.push_back(envRecord.entity);
     }
 
+    // Ends with every record of the world erased, whether or not on_destroy could run.
     for (entt::entity entity : entities)
         on_entity_destroyed(world, entity);
-
-    // In case some entities were already invalid and did not invoke on_destroy.
-    for (auto it = m_impl->environments.begin(); it != m_impl->environments.end();)
+    // Pools still held by Lua outlive the world; they turn inert instead of touching freed entities.
+    for (const auto& weakPool : m_impl->pools)
     {
-        if (it->second.world == &world)
-            it = m_impl->environments.erase(it);
-        else
-            ++it;
+        if (auto pool = weakPool.lock(); pool && pool->world == &world)
+            pool->world = nullptr;
     }
 }
 
@@ -557,9 +1561,8 @@ void ScriptEngine::on_world_destroyed(World& world)
 Result<> ScriptEngine::reload_script(World& world, entt::entity entity)
 {
     // Clean up existing environment
-    auto envIt = m_impl->environments.find(entity);
-    if (envIt != m_impl->environments.end() && envIt->second.world == &world)
-        m_impl->environments.erase(envIt);
+    if (const auto* record = m_impl->find_environment(entity); record && record->world == &world)
+        m_impl->erase_environment(entity);
 
     // Reset initialized flag
     auto* sc = world.registry().try_get<ScriptComponent>(entity);
@@ -577,16 +1580,125 @@ void ScriptEngine::shutdown()
     if (!m_impl)
         return;
 
-    // Clear all environments before closing the Lua state
-    m_impl->environments.clear();
+    // Clear all environments and compiled chunks before closing the Lua state
+    m_impl->clear_environments();
+    m_impl->chunks.clear();
+    m_impl->shardFlow.clear();
+    m_impl->shards.clear();
 
     // sol::state destructor handles lua_close
     fmt::print("[ScriptEngine] Shutdown\n");
 }
 
+//    compile_to_bytecode                                                
+
+Result<> ScriptEngine::compile_to_bytecode(const std::filesystem::path& sourcePath,
+                                           const std::filesystem::path& outputPath)
+{
+    auto source = read_script_file(sourcePath);
+    if (!source)
+        return make_error(source.error());
+    const ScriptHeader header = parse_script_header(*source);
+    if (std::string_view(*source).substr(header.size).starts_with(LuaJitBytecodeSignature))
+        return make_error(fmt::format("Script is already bytecode: {}", sourcePath.string()), ErrorCode::AssetInvalidData);
+
+    sol::state lua;
+    lua.open_libraries(sol::lib::base, sol::lib::string);
+
+    // The file name is stored as the chunk name that runtime errors report.
+    auto factory = load_chunk_factory(lua, *source, sourcePath.filename().string());
+    if (!factory)
+        return make_error(factory.error());
+
+    // Debug info is kept so runtime errors still carry line numbers.
+    sol::protected_function dump = lua["string"]["dump"];
+    auto dumped = dump(*factory);
+    if (!dumped.valid())
+    {
+        sol::error err = dumped;
+        return make_error(fmt::format("Failed to dump bytecode for '{}': {}", sourcePath.string(), err.what()),
+                          ErrorCode::AssetParsingFailed);
+    }
+    const std::string bytecode = dumped;
+
+    std::error_code ec;
+    std::filesystem::create_directories(outputPath.parent_path(), ec);
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return make_error(fmt::format("Failed to open script bytecode for writing: {}", outputPath.string()),
+                          ErrorCode::AssetCacheWriteFailed);
+
+    // Directives stay readable in front of the bytecode; load_chunk_factory() skips them.
+    std::string_view directives = std::string_view(*source).substr(0, header.size);
+    file.write(directives.data(), static_cast<std::streamsize>(directives.size()));
+    if (!directives.empty() && !directives.ends_with('\n'))
+        file.put('\n');
+    file.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+    if (!file.good())
+        return make_error(fmt::format("Failed to write script bytecode: {}", outputPath.string()),
+                          ErrorCode::AssetCacheWriteFailed);
+    return {};
+}
+
 std::size_t ScriptEngine::get_environment_count() const noexcept
 {
     if (!m_impl)
         return 0;
     return m_impl->environments.size();
 }
+
+void ScriptEngine::set_gc_step_budget(float milliseconds) noexcept
+{
+    m_impl->gcStepBudgetMs = std::max(0.0f, milliseconds);
+}
+
+float ScriptEngine::get_gc_step_budget() const noexcept
+{
+    return m_impl->gcStepBudgetMs;
+}
+
+double ScriptEngine::get_last_gc_milliseconds() const noexcept
+{
+    return m_impl->lastGcMs;
+}
+
+std::size_t ScriptEngine::get_lua_memory_bytes() const noexcept
+{
+    const auto state_bytes = [](sol::state& lua) {
+        lua_State* state = lua.lua_state();
+        return static_cast<std::size_t>(lua_gc(state, LUA_GCCOUNT, 0)) * 1024 +
+               static_cast<std::size_t>(lua_gc(state, LUA_GCCOUNTB, 0));
+    };
+    std::size_t bytes = state_bytes(m_impl->lua);
+    for (const auto& shard : m_impl->shards)
+        bytes += state_bytes(shard->lua);
+    return bytes;
+}
+
+void ScriptEngine::set_script_shard_count(std::uint32_t count) noexcept
+{
+    m_impl->shardCount = count;
+}
+
+std::uint32_t ScriptEngine::get_script_shard_count() const noexcept
+{
+    if (m_impl->shardCount == Impl::ShardPerWorker)
+        return JobSystem::get().worker_count();
+    return m_impl->shardCount;
+}
+
+std::span<const ScriptProfileEntry> ScriptEngine::get_script_profile() const noexcept
+{
+    return m_impl->profile;
+}
+
+void ScriptEngine::reset_script_profile() noexcept
+{
+    // Entries stay in place (records hold their slots); only the counters restart.
+    for (ScriptProfileEntry& entry : m_impl->profile)
+    {
+        entry.callCount = 0;
+        entry.totalMilliseconds = 0.0;
+        entry.maxMilliseconds = 0.0;
+    }
+}
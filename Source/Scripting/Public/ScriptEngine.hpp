@@ -6,18 +6,41 @@
 #include <entt/entity/entity.hpp>
 
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <span>
+#include <string>
 #include <string_view>
 
+class PhysicsWorld;
 class World;
 
 NOC_SUPPRESS_DLL_WARNINGS
 
+/// Lua callback time accumulated by one script path (on_start, on_update, on_update_batch, on_destroy).
+struct NOC_EXPORT ScriptProfileEntry
+{
+    std::string scriptPath{};
+    std::uint64_t callCount{};
+    double totalMilliseconds{};
+    double maxMilliseconds{};
+};
+
 /// Manages the LuaJIT VM and per-entity script lifecycle.
 ///
 /// Each entity with a ScriptComponent gets a sandboxed sol::environment.
 /// Scripts define optional lifecycle functions: on_start(entity), on_update(entity, dt), on_destroy(entity).
+/// A script that defines on_update_batch(entities, dt) replaces the per-entity on_update calls with one
+/// call per frame receiving every entity running that script.
+/// Transforms.get/edit(entity) return LuaJIT FFI pointers into TransformComponent storage; edit marks
+/// only that entity dirty. The pointers must not outlive the callback that obtained them.
+/// EntityPool.from(entity) turns an entity subtree into a pool whose spawn/despawn recycle hidden
+/// instances instead of creating and destroying entities.
+/// A script whose first line is `--!entity_local` promises to touch only its own entity. Its instances
+/// run on shard Lua states in parallel on the job system: writes to other entities are deferred until
+/// all shards finish, Transforms.edit returns nil for any other entity, and EntityPool is unavailable.
+/// Another entity's transform and mesh read as nil as well, since its own shard may be writing them.
 class NOC_EXPORT ScriptEngine
 {
   public:
@@ -36,7 +59,13 @@ class NOC_EXPORT ScriptEngine
     /// Typically the project root or the executable directory.
     void set_script_root(const std::filesystem::path& root);
 
+    /// Physics world behind the Lua `Physics` query table (raycast, shape casts, overlaps).
+    /// Without one the queries find nothing.
+    void set_physics_world(PhysicsWorld* physicsWorld) noexcept;
+
     /// Load & attach a script to an entity. Creates a sandboxed environment.
+    /// Each script file is compiled once (recompiled when its mtime changes) and shared by every
+    /// entity running it; files holding LuaJIT bytecode from compile_to_bytecode() load unparsed.
     Result<> load_script(World& world, entt::entity entity);
 
     /// Called every frame. Runs on_start (once) and on_update for all ScriptComponent entities.
@@ -51,7 +80,8 @@ class NOC_EXPORT ScriptEngine
     void on_entity_tree_destroyed(World& world, entt::entity entity);
 
     /// Called before a World is destroyed or replaced (level/project switch).
-    /// Invokes on_destroy for all script entities belonging to that world and clears them.
+    /// Invokes on_destroy for all script entities belonging to that world and clears them, and
+    /// detaches Lua entity pools from it.
     void on_world_destroyed(World& world);
 
     /// Reload a specific entity's script from disk (hot-reload).
@@ -63,6 +93,31 @@ class NOC_EXPORT ScriptEngine
     /// Number of currently active script environments (for diagnostics UI).
     std::size_t get_environment_count() const noexcept;
 
+    /// Time slice for incremental GC steps run at the end of every update(). LuaJIT's automatic
+    /// collector stays enabled as a backstop; 0 disables the per-frame stepping.
+    void set_gc_step_budget(float milliseconds) noexcept;
+    float get_gc_step_budget() const noexcept;
+
+    /// Time spent in the GC steps of the last update().
+    double get_last_gc_milliseconds() const noexcept;
+
+    /// Bytes currently allocated by the Lua VM.
+    std::size_t get_lua_memory_bytes() const noexcept;
+
+    /// Shard states that entity-local scripts are spread over; defaults to one per job worker.
+    /// 0 runs them on the main state. Applies to instances loaded afterwards.
+    void set_script_shard_count(std::uint32_t count) noexcept;
+    std::uint32_t get_script_shard_count() const noexcept;
+
+    /// Per-script callback timings since the last reset, one entry per script path.
+    /// The span stays valid until the next load_script() or update().
+    std::span<const ScriptProfileEntry> get_script_profile() const noexcept;
+    void reset_script_profile() noexcept;
+
+    /// Compiles a Lua script to LuaJIT bytecode that load_script() accepts in place of the source.
+    /// Used by the cooker; `outputPath` may equal the path the runtime resolves the script to.
+    static Result<> compile_to_bytecode(const std::filesystem::path& sourcePath, const std::filesystem::path& outputPath);
+
   private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
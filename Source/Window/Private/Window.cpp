@@ -8,6 +8,7 @@ Result<> Window::init()
     }
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    glfwWindowHint(GLFW_VISIBLE, m_visible ? GLFW_TRUE : GLFW_FALSE);
 
     this->m_window = glfwCreateWindow(this->m_width, this->m_height, this->m_windowTitle.data(), nullptr, nullptr);
     if (!this->m_window)
@@ -30,6 +31,8 @@ Result<> Window::loop(std::function<Result<>()> draw_frame)
 {
     while (!glfwWindowShouldClose(this->m_window))
     {
+        if (m_frameBeginCallback)
+            m_frameBeginCallback();
         glfwPollEvents();
 
         if (glfwGetKey(this->m_window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
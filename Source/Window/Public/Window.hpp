@@ -17,6 +17,7 @@ class NOC_EXPORT Window
     using CursorPosCallback = std::function<void(double xpos, double ypos)>;
     using MouseButtonCallback = std::function<void(std::int32_t button, std::int32_t action, std::int32_t mods)>;
     using ScrollCallback = std::function<void(double xoffset, double yoffset)>;
+    using FrameBeginCallback = std::function<void()>;
 
     inline Window(std::uint32_t width, std::uint32_t height, std::string_view windowTitle)
         : m_width(width), m_height(height), m_windowTitle(windowTitle)
@@ -34,6 +35,12 @@ class NOC_EXPORT Window
     void cleanup() noexcept;
 
   public:
+    /// Call before init(). Hidden windows still get a surface and swapchain (headless benchmarks).
+    void set_visible(bool visible) noexcept
+    {
+        m_visible = visible;
+    }
+
     inline GLFWwindow* get_glfw_window() const noexcept
     {
         return m_window;
@@ -55,6 +62,11 @@ class NOC_EXPORT Window
     {
         m_scrollCallback = std::move(cb);
     }
+    /// Runs at the top of every loop() iteration, before events are polled (frame pacing).
+    void set_frame_begin_callback(FrameBeginCallback cb) noexcept
+    {
+        m_frameBeginCallback = std::move(cb);
+    }
 
   private:
     static void glfw_framebuffer_size_callback(GLFWwindow* window, std::int32_t width, std::int32_t height);
@@ -67,6 +79,7 @@ class NOC_EXPORT Window
     std::uint32_t m_width{};
     std::uint32_t m_height{};
     std::string_view m_windowTitle{};
+    bool m_visible{true};
 
     GLFWwindow* m_window{};
 
@@ -74,6 +87,7 @@ class NOC_EXPORT Window
     CursorPosCallback m_cursorPosCallback{};
     MouseButtonCallback m_mouseButtonCallback{};
     ScrollCallback m_scrollCallback{};
+    FrameBeginCallback m_frameBeginCallback{};
 };
 
 NOC_RESTORE_DLL_WARNINGS
@@ -1,9 +1,12 @@
 #define NOMINMAX
+#include <Core/Public/JobSystem.hpp>
 #include <Core/Public/RuntimePaths.hpp>
 #include <Runtime/Public/ProjectPipeline.hpp>
 
 #include <fmt/core.h>
 
+#include <charconv>
+#include <cstdint>
 #include <utility>
 #include <filesystem>
 #include <string_view>
@@ -19,14 +22,25 @@ struct CookOptions
     std::filesystem::path contentRoot;
     std::filesystem::path userDataRoot;
     bool compileShaders{true};
+    bool compressTextures{true};
+    bool generateLods{true};
+    bool compactVertices{true};
+    bool cookCollisionShapes{true};
+    bool compileScripts{true};
     bool strict{true};
+    bool incremental{true};
+    bool printAssetTimings{false};
+    bool packContent{true};
+    std::uint32_t jobs{}; // 0: one worker per hardware thread
 };
 
 void print_usage()
 {
     fmt::print("Usage: NatureOfCraftCooker --project <path> (--output <dir> | --bundle-output <dir>) "
                "[--runtime-dir <path>] [--content-root <path>] [--user-data-root <path>] "
-               "[--no-compile-shaders] [--no-strict]\n");
+               "[--no-compile-shaders] [--no-compress-textures] [--no-lods] [--no-compact-vertices] "
+               "[--no-collision-shapes] [--no-script-bytecode] [--no-strict] [--no-incremental] [--asset-timings] [--no-pack] "
+               "[--jobs <N>]\n");
 }
 
 Result<CookOptions> parse_options(int argc, char** argv)
@@ -76,10 +90,51 @@ Result<CookOptions> parse_options(int argc, char** argv)
         {
             options.compileShaders = false;
         }
+        else if (arg == "--no-compress-textures")
+        {
+            options.compressTextures = false;
+        }
+        else if (arg == "--no-lods")
+        {
+            options.generateLods = false;
+        }
+        else if (arg == "--no-compact-vertices")
+        {
+            options.compactVertices = false;
+        }
+        else if (arg == "--no-collision-shapes")
+        {
+            options.cookCollisionShapes = false;
+        }
+        else if (arg == "--no-script-bytecode")
+        {
+            options.compileScripts = false;
+        }
         else if (arg == "--no-strict")
         {
             options.strict = false;
         }
+        else if (arg == "--no-pack")
+        {
+            options.packContent = false;
+        }
+        else if (arg == "--no-incremental")
+        {
+            options.incremental = false;
+        }
+        else if (arg == "--asset-timings")
+        {
+            options.printAssetTimings = true;
+        }
+        else if (arg == "--jobs")
+        {
+            if (i + 1 >= argc)
+                return make_error(fmt::format("Missing value for '{}'", arg), ErrorCode::AssetFileNotFound);
+            const std::string_view value = argv[++i];
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), options.jobs);
+            if (ec != std::errc{} || end != value.data() + value.size())
+                return make_error(fmt::format("Invalid value '{}' for '{}'", value, arg), ErrorCode::AssetInvalidData);
+        }
         else if (arg == "--help" || arg == "-h")
         {
             print_usage();
@@ -120,6 +175,9 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    // Cook steps run on the engine job system; size it before anything creates it.
+    JobSystem::configure(options.jobs);
+
     if (!options.bundleOutputRoot.empty())
     {
         BundleProjectOptions bundleOptions;
@@ -127,7 +185,15 @@ int main(int argc, char** argv)
         bundleOptions.runtimeBinaryRoot = options.runtimeBinaryRoot;
         bundleOptions.overwriteOutput = true;
         bundleOptions.compileShaders = options.compileShaders;
+        bundleOptions.compressTextures = options.compressTextures;
+        bundleOptions.generateLods = options.generateLods;
+        bundleOptions.compactVertices = options.compactVertices;
+        bundleOptions.cookCollisionShapes = options.cookCollisionShapes;
+        bundleOptions.compileScripts = options.compileScripts;
         bundleOptions.strict = options.strict;
+        bundleOptions.incremental = options.incremental;
+        bundleOptions.printAssetTimings = options.printAssetTimings;
+        bundleOptions.packContent = options.packContent;
         auto bundleResult = bundle_project(options.projectFile, bundleOptions);
         if (!bundleResult)
         {
@@ -137,12 +203,23 @@ int main(int argc, char** argv)
 
         fmt::print("Bundle root: {}\n", bundleResult->bundleRoot.string());
         fmt::print("Bundle content root: {}\n", bundleResult->contentRoot.string());
+        if (!bundleResult->contentArchive.empty())
+            fmt::print("Content archive: {} ({} files, {:.1f} MiB)\n", bundleResult->contentArchive.string(),
+                       bundleResult->packedFileCount, static_cast<double>(bundleResult->packedByteCount) / (1024.0 * 1024.0));
         fmt::print("Cooked project: {}\n", bundleResult->cookResult.cookedProjectFile.string());
+        fmt::print("Cook steps: {} rebuilt, {} skipped\n", bundleResult->cookResult.rebuiltAssetCount,
+                   bundleResult->cookResult.skippedAssetCount);
         fmt::print("Cooked levels: {}\n", bundleResult->cookResult.cookedLevelCount);
         fmt::print("Cooked raw models: {}\n", bundleResult->cookResult.cookedModelCount);
         fmt::print("Copied textures: {}\n", bundleResult->cookResult.copiedTextureCount);
+        fmt::print("Compressed textures: {}\n", bundleResult->cookResult.compressedTextureCount);
+        fmt::print("Packed ORM textures: {}\n", bundleResult->cookResult.packedOrmTextureCount);
+        fmt::print("LOD meshes: {} ({} levels)\n", bundleResult->cookResult.lodMeshCount,
+                   bundleResult->cookResult.generatedLodCount);
+        fmt::print("Cooked collision shapes: {}\n", bundleResult->cookResult.cookedCollisionShapeCount);
         fmt::print("Copied materials: {}\n", bundleResult->cookResult.copiedMaterialCount);
         fmt::print("Copied scripts: {}\n", bundleResult->cookResult.copiedScriptCount);
+        fmt::print("Compiled scripts: {}\n", bundleResult->cookResult.compiledScriptCount);
         fmt::print("Copied engine files: {}\n", bundleResult->cookResult.copiedEngineFileCount);
         fmt::print("Copied runtime files: {}\n", bundleResult->copiedRuntimeFileCount);
         for (const auto& warning : bundleResult->warnings)
@@ -154,7 +231,14 @@ int main(int argc, char** argv)
     cookOptions.outputRoot = options.outputRoot;
     cookOptions.overwriteOutput = true;
     cookOptions.compileShaders = options.compileShaders;
+    cookOptions.compressTextures = options.compressTextures;
+    cookOptions.generateLods = options.generateLods;
+    cookOptions.compactVertices = options.compactVertices;
+    cookOptions.cookCollisionShapes = options.cookCollisionShapes;
+    cookOptions.compileScripts = options.compileScripts;
     cookOptions.strict = options.strict;
+    cookOptions.incremental = options.incremental;
+    cookOptions.printAssetTimings = options.printAssetTimings;
     auto cookResult = cook_project(options.projectFile, cookOptions);
     if (!cookResult)
     {
@@ -163,11 +247,17 @@ int main(int argc, char** argv)
     }
 
     fmt::print("Cooked project: {}\n", cookResult->cookedProjectFile.string());
+    fmt::print("Cook steps: {} rebuilt, {} skipped\n", cookResult->rebuiltAssetCount, cookResult->skippedAssetCount);
     fmt::print("Cooked levels: {}\n", cookResult->cookedLevelCount);
     fmt::print("Cooked raw models: {}\n", cookResult->cookedModelCount);
     fmt::print("Copied textures: {}\n", cookResult->copiedTextureCount);
+    fmt::print("Compressed textures: {}\n", cookResult->compressedTextureCount);
+    fmt::print("Packed ORM textures: {}\n", cookResult->packedOrmTextureCount);
+    fmt::print("LOD meshes: {} ({} levels)\n", cookResult->lodMeshCount, cookResult->generatedLodCount);
+    fmt::print("Cooked collision shapes: {}\n", cookResult->cookedCollisionShapeCount);
     fmt::print("Copied materials: {}\n", cookResult->copiedMaterialCount);
     fmt::print("Copied scripts: {}\n", cookResult->copiedScriptCount);
+    fmt::print("Compiled scripts: {}\n", cookResult->compiledScriptCount);
     fmt::print("Copied engine files: {}\n", cookResult->copiedEngineFileCount);
     for (const auto& warning : cookResult->warnings)
         fmt::print("Warning: {}\n", warning);